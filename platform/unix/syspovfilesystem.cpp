@@ -45,6 +45,7 @@
 
 // POSIX standard header files
 #include <fcntl.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 // POV-Ray header files (base module)
@@ -73,6 +74,42 @@ bool DeleteFile(const UCS2String& fileName)
 
 //******************************************************************************
 
+#if !POV_USE_DEFAULT_SYNCFILE
+
+bool SyncFile(const UCS2String& fileName)
+{
+    int handle = open(UCS2toSysString(fileName).c_str(), O_WRONLY);
+    if (handle == -1)
+        return false;
+    bool ok = (fsync(handle) == 0);
+    close(handle);
+    return ok;
+}
+
+#endif // POV_USE_DEFAULT_SYNCFILE
+
+//******************************************************************************
+
+#if !POV_USE_DEFAULT_GETFILESTATUS
+
+bool GetFileStatus(const UCS2String& fileName, FileStatus& status)
+{
+    struct stat info;
+    if (stat(UCS2toSysString(fileName).c_str(), &info) != 0)
+        return false;
+    status.size = info.st_size;
+#if defined(__APPLE__)
+    status.modificationTime = std::int_least64_t(info.st_mtimespec.tv_sec) * 1000000000 + info.st_mtimespec.tv_nsec;
+#else
+    status.modificationTime = std::int_least64_t(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+#endif
+    return true;
+}
+
+#endif // POV_USE_DEFAULT_GETFILESTATUS
+
+//******************************************************************************
+
 #if !POV_USE_DEFAULT_LARGEFILE
 
 #ifndef POVUNIX_LSEEK64
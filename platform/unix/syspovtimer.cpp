@@ -340,6 +340,22 @@ bool Timer::HasValidThreadCPUTime () const
     return !mThreadTimeUseFallback;
 }
 
+POV_LONG ThreadCPUTimeMicroseconds()
+{
+#if defined(HAVE_CLOCK_GETTIME) && defined(HAVE_DECL_CLOCK_THREAD_CPUTIME_ID) && HAVE_DECL_CLOCK_THREAD_CPUTIME_ID
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+        return static_cast<POV_LONG>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+#endif
+#if defined(HAVE_GETRUSAGE) && defined(HAVE_DECL_RUSAGE_THREAD) && HAVE_DECL_RUSAGE_THREAD
+    struct rusage ru;
+    if (getrusage(RUSAGE_THREAD, &ru) == 0)
+        return (static_cast<POV_LONG>(ru.ru_utime.tv_sec) + ru.ru_stime.tv_sec) * 1000000
+               + ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+#endif
+    return -1;
+}
+
 #endif // !POV_USE_DEFAULT_TIMER
 
 //******************************************************************************
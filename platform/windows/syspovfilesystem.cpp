@@ -84,6 +84,55 @@ bool DeleteFile(const UCS2String& fileName)
 
 //******************************************************************************
 
+#if !POV_USE_DEFAULT_RENAMEFILE
+
+bool RenameFile(const UCS2String& oldName, const UCS2String& newName)
+{
+    // TODO - use `MoveFileExW()` instead.
+    return (MoveFileExA(UCS2toSysString(oldName).c_str(), UCS2toSysString(newName).c_str(),
+                        MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0);
+}
+
+#endif // POV_USE_DEFAULT_RENAMEFILE
+
+//******************************************************************************
+
+#if !POV_USE_DEFAULT_SYNCFILE
+
+bool SyncFile(const UCS2String& fileName)
+{
+    // TODO - use `CreateFileW()` instead.
+    HANDLE handle = CreateFileA(UCS2toSysString(fileName).c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+        return false;
+    bool ok = (FlushFileBuffers(handle) != 0);
+    CloseHandle(handle);
+    return ok;
+}
+
+#endif // POV_USE_DEFAULT_SYNCFILE
+
+//******************************************************************************
+
+#if !POV_USE_DEFAULT_GETFILESTATUS
+
+bool GetFileStatus(const UCS2String& fileName, FileStatus& status)
+{
+    // TODO - use `GetFileAttributesExW()` instead.
+    WIN32_FILE_ATTRIBUTE_DATA info;
+    if (!GetFileAttributesExA(UCS2toSysString(fileName).c_str(), GetFileExInfoStandard, &info))
+        return false;
+    status.size = (std::uint_least64_t(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+    status.modificationTime = std::int_least64_t((std::uint_least64_t(info.ftLastWriteTime.dwHighDateTime) << 32) |
+                                                 info.ftLastWriteTime.dwLowDateTime);
+    return true;
+}
+
+#endif // POV_USE_DEFAULT_GETFILESTATUS
+
+//******************************************************************************
+
 #if !POV_USE_DEFAULT_LARGEFILE
 
 using Offset = decltype(_lseeki64(0,0,0));
@@ -184,6 +184,21 @@ bool Timer::HasValidProcessCPUTime () const
     return mCPUTimeSupported;
 }
 
+POV_LONG ThreadCPUTimeMicroseconds()
+{
+    FILETIME    ct;
+    FILETIME    et;
+    __int64     kt;
+    __int64     ut;
+
+    if (!GetThreadTimes (GetCurrentThread (), &ct, &et,
+                         reinterpret_cast<FILETIME *>(&kt),
+                         reinterpret_cast<FILETIME *>(&ut)))
+        return -1;
+
+    return ((kt + ut) / 10);
+}
+
 #endif // POV_USE_DEFAULT_TIMER
 
 //******************************************************************************
@@ -0,0 +1,709 @@
+//******************************************************************************
+///
+/// @file backend/control/rendernode.cpp
+///
+/// Implementations related to distributing a render across render nodes.
+///
+/// @copyright
+/// @parblock
+///
+/// Persistence of Vision Ray Tracer ('POV-Ray') version 3.8.
+/// Copyright 1991-2019 Persistence of Vision Raytracer Pty. Ltd.
+///
+/// POV-Ray is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU Affero General Public License as
+/// published by the Free Software Foundation, either version 3 of the
+/// License, or (at your option) any later version.
+///
+/// POV-Ray is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU Affero General Public License for more details.
+///
+/// You should have received a copy of the GNU Affero General Public License
+/// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+///
+/// ----------------------------------------------------------------------------
+///
+/// POV-Ray is based on the popular DKB raytracer version 2.12.
+/// DKBTrace was originally written by David K. Buck.
+/// DKBTrace Ver 2.0-2.12 were written by David K. Buck & Aaron A. Collins.
+///
+/// @endparblock
+///
+//******************************************************************************
+
+// Unit header file must be the first file included within POV-Ray *.cpp files (pulls in config)
+#include "backend/control/rendernode.h"
+
+// C++ variants of C standard header files
+#include <cstring>
+
+// C++ standard header files
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Boost header files
+#include <boost/asio.hpp>
+
+// POV-Ray header files (base module)
+#include "base/fileinputoutput.h"
+#include "base/filesystem.h"
+#include "base/path.h"
+#include "base/pov_err.h"
+#include "base/stringutilities.h"
+
+// POV-Ray header files (POVMS module)
+#include "povms/povmsid.h"
+
+// this must be the last file included
+#include "base/povdebug.h"
+
+namespace pov
+{
+
+using namespace pov_base;
+
+using boost::asio::ip::tcp;
+
+/// Size of the chunks in which file content is received.
+static const size_t kRenderNodeChunkSize = 65536;
+
+/// Interval at which to check back with the caller while waiting for a connection.
+static const std::chrono::milliseconds kRenderNodePollInterval(100);
+
+/// Time in milliseconds a node waits for each chunk of a job before dropping the coordinator,
+/// and a coordinator waits for the node to reply to its handshake.
+static const unsigned int kRenderNodeJobTimeout = 60000;
+
+/// Characters opening the handshake of a coordinator.
+static const char kRenderNodeHandshakeMagic[8] = { 'P', 'O', 'V', 'R', 'N', 'O', 'D', 'E' };
+
+//******************************************************************************
+
+struct RenderNodeConnection::Impl final
+{
+    boost::asio::io_context context;
+    tcp::socket             socket;
+    POV_ULONG               received;       ///< Bytes received so far.
+    POV_ULONG               receiveLimit;   ///< Limit for the bytes received, or 0 if unlimited.
+
+    Impl() : socket(context), received(0), receiveLimit(0) {}
+
+    /// Read data, waiting no longer than the given time (or as long as necessary if 0).
+    boost::system::error_code Read(void *data, size_t size, unsigned int milliseconds)
+    {
+        boost::system::error_code ec;
+        if ((receiveLimit != 0) && (size > receiveLimit - received))
+            return boost::asio::error::message_size;
+        received += size;
+        if (milliseconds == 0)
+        {
+            boost::asio::read(socket, boost::asio::buffer(data, size), ec);
+            return ec;
+        }
+
+        bool done = false;
+        boost::asio::async_read(socket, boost::asio::buffer(data, size),
+                                [&](const boost::system::error_code& e, size_t) { ec = e; done = true; });
+        context.restart();
+        context.run_for(std::chrono::milliseconds(milliseconds));
+        if (!done)
+        {
+            // make sure the handler has run before its variables go out of scope
+            boost::system::error_code dummy;
+            socket.cancel(dummy);
+            context.restart();
+            context.run();
+            ec = boost::asio::error::timed_out;
+        }
+        return ec;
+    }
+
+    /// Adapter to read and write POVMS objects in stream form.
+    struct Stream final
+    {
+        Impl& impl;
+        unsigned int timeout;
+        boost::system::error_code error;
+        Stream(Impl& i, unsigned int t = 0) : impl(i), timeout(t) {}
+        bool read(void *data, size_t size)
+        {
+            error = impl.Read(data, size, timeout);
+            return !error;
+        }
+        bool write(void *data, size_t size)
+        {
+            boost::asio::write(impl.socket, boost::asio::buffer(data, size), error);
+            return !error;
+        }
+    };
+
+    void SetupSocket()
+    {
+        boost::system::error_code ec;
+        socket.set_option(tcp::no_delay(true), ec);
+        socket.set_option(boost::asio::socket_base::keep_alive(true), ec);
+    }
+};
+
+RenderNodeConnection::RenderNodeConnection() :
+    mpImpl(new Impl()),
+    mReceiveTimeout(0)
+{}
+
+RenderNodeConnection::~RenderNodeConnection()
+{
+    boost::system::error_code ec;
+    mpImpl->socket.close(ec);
+}
+
+void RenderNodeConnection::Connect(const std::string& address, const std::string& token, const boost::function<void()>& cooperate)
+{
+    if (token.length() > kMaxRenderNodeTokenLength)
+        throw POV_EXCEPTION(kParamErr, "Render node token is longer than " + std::to_string(kMaxRenderNodeTokenLength) + " characters");
+
+    std::string host(address);
+    std::string port(std::to_string(kDefaultRenderNodePort));
+
+    // accept `host`, `host:port`, `[ipv6-address]` and `[ipv6-address]:port`; a bare IPv6 address can't take a port
+    if (!address.empty() && (address[0] == '['))
+    {
+        size_t end = address.find(']');
+        if (end == std::string::npos)
+            throw POV_EXCEPTION(kParamErr, "Invalid render node address '" + address + "'");
+        host = address.substr(1, end - 1);
+        if ((end + 1 < address.length()) && (address[end + 1] == ':'))
+            port = address.substr(end + 2);
+    }
+    else if (std::count(address.begin(), address.end(), ':') == 1)
+    {
+        size_t colon = address.find(':');
+        host = address.substr(0, colon);
+        port = address.substr(colon + 1);
+    }
+
+    mPeerName = address;
+
+    boost::system::error_code ec;
+    tcp::resolver resolver(mpImpl->context);
+    tcp::resolver::results_type endpoints = resolver.resolve(host, port, ec);
+    if (ec)
+        throw POV_EXCEPTION(kNetworkConnectionErr, "Cannot resolve '" + address + "': " + ec.message());
+
+    bool done = false;
+    boost::asio::async_connect(mpImpl->socket, endpoints,
+                               [&](const boost::system::error_code& e, const tcp::endpoint&) { ec = e; done = true; });
+    try
+    {
+        while (!done)
+        {
+            mpImpl->context.restart();
+            mpImpl->context.run_for(kRenderNodePollInterval);
+            if (!done)
+                cooperate();
+        }
+    }
+    catch (...)
+    {
+        // abort the attempt, making sure the handler has run before its variables go out of scope
+        boost::system::error_code dummy;
+        mpImpl->socket.close(dummy);
+        mpImpl->context.restart();
+        mpImpl->context.run();
+        throw;
+    }
+    if (ec)
+        throw POV_EXCEPTION(kNetworkConnectionErr, "Cannot connect to '" + address + "': " + ec.message());
+
+    mpImpl->SetupSocket();
+
+    std::string handshake(kRenderNodeHandshakeMagic, sizeof(kRenderNodeHandshakeMagic));
+    for (int shift = 24; shift >= 0; shift -= 8)
+        handshake.push_back(char((token.length() >> shift) & 0xFF));
+    handshake += token;
+    SendData(handshake.data(), handshake.size());
+
+    std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+    while (!WaitForData(kRenderNodePollInterval.count()))
+    {
+        if (std::chrono::steady_clock::now() - start > std::chrono::milliseconds(kRenderNodeJobTimeout))
+            throw POV_EXCEPTION(kNetworkConnectionErr, "Connection to '" + address + "' timed out");
+        cooperate();
+    }
+    unsigned char reply = 0;
+    ReceiveData(&reply, 1);
+    if (reply != 1)
+        throw POV_EXCEPTION(kAuthorisationErr, "Render node '" + address + "' rejected the token");
+}
+
+bool RenderNodeConnection::AcceptHandshake(const std::string& token)
+{
+    char header[sizeof(kRenderNodeHandshakeMagic) + 4];
+    ReceiveData(header, sizeof(header));
+    if (std::memcmp(header, kRenderNodeHandshakeMagic, sizeof(kRenderNodeHandshakeMagic)) != 0)
+        throw POV_EXCEPTION(kNetworkDataErr, "Unexpected data from '" + mPeerName + "'");
+
+    size_t length = 0;
+    for (size_t i = sizeof(kRenderNodeHandshakeMagic); i < sizeof(header); i++)
+        length = (length << 8) | (unsigned char)(header[i]);
+
+    bool accepted = false;
+    if (length == token.length())
+    {
+        std::vector<char> received(length);
+        if (length > 0)
+            ReceiveData(received.data(), length);
+        // compare in constant time, so as not to give away how much of the token is right
+        unsigned char difference = 0;
+        for (size_t i = 0; i < length; i++)
+            difference |= (unsigned char)(received[i] ^ token[i]);
+        accepted = (difference == 0);
+    }
+
+    unsigned char reply = (accepted ? 1 : 0);
+    SendData(&reply, 1);
+    return accepted;
+}
+
+void RenderNodeConnection::Send(POVMS_Object& msg)
+{
+    std::lock_guard<std::mutex> lock(mSendMutex);
+    Impl::Stream stream(*mpImpl);
+    try
+    {
+        msg.Write(stream);
+    }
+    catch (pov_base::Exception&)
+    {
+        throw POV_EXCEPTION(kNetworkConnectionErr, "Connection to '" + mPeerName + "' lost");
+    }
+}
+
+void RenderNodeConnection::SendData(const void *data, size_t size)
+{
+    std::lock_guard<std::mutex> lock(mSendMutex);
+    boost::system::error_code ec;
+    boost::asio::write(mpImpl->socket, boost::asio::buffer(data, size), ec);
+    if (ec)
+        throw POV_EXCEPTION(kNetworkConnectionErr, "Connection to '" + mPeerName + "' lost");
+}
+
+/// Throw an exception describing a failure to receive data from a peer.
+static void ThrowReceiveError(const boost::system::error_code& ec, const std::string& peerName)
+{
+    if (ec == boost::asio::error::timed_out)
+        throw POV_EXCEPTION(kNetworkConnectionErr, "Connection to '" + peerName + "' timed out");
+    if (ec == boost::asio::error::message_size)
+        throw POV_EXCEPTION(kInternalLimitErr, "Data from '" + peerName + "' exceeds the size limit");
+    throw POV_EXCEPTION(kNetworkConnectionErr, "Connection to '" + peerName + "' lost");
+}
+
+void RenderNodeConnection::Receive(POVMS_Object& msg)
+{
+    Impl::Stream stream(*mpImpl, mReceiveTimeout);
+    try
+    {
+        msg.Read(stream);
+    }
+    catch (pov_base::Exception&)
+    {
+        ThrowReceiveError(stream.error, mPeerName);
+    }
+}
+
+void RenderNodeConnection::ReceiveData(void *data, size_t size)
+{
+    boost::system::error_code ec(mpImpl->Read(data, size, mReceiveTimeout));
+    if (ec)
+        ThrowReceiveError(ec, mPeerName);
+}
+
+void RenderNodeConnection::SetReceiveLimit(POV_ULONG bytes)
+{
+    mpImpl->received = 0;
+    mpImpl->receiveLimit = bytes;
+}
+
+bool RenderNodeConnection::WaitForData(unsigned int milliseconds)
+{
+    boost::system::error_code ec;
+    if ((mpImpl->socket.available(ec) > 0) || ec)
+        return true;
+
+    bool ready = false;
+    mpImpl->socket.async_wait(tcp::socket::wait_read,
+                              [&ready](const boost::system::error_code& e) { ready = (e != boost::asio::error::operation_aborted); });
+    mpImpl->context.restart();
+    mpImpl->context.run_for(std::chrono::milliseconds(milliseconds));
+    if (!ready)
+    {
+        mpImpl->socket.cancel(ec);
+        mpImpl->context.restart();
+        mpImpl->context.run();
+    }
+    return ready;
+}
+
+void RenderNodeConnection::Shutdown()
+{
+    boost::system::error_code ec;
+    mpImpl->socket.shutdown(tcp::socket::shutdown_both, ec);
+}
+
+//******************************************************************************
+
+static std::mutex gRenderNodeJobMutex;
+static std::map<int, std::weak_ptr<RenderNodeJob>> gRenderNodeJobs;
+static int gNextRenderNodeJobId = 1;
+
+RenderNodeJob::RenderNodeJob(int id) :
+    mId(id),
+    mReady(false),
+    mFinished(false)
+{}
+
+RenderNodeJob::~RenderNodeJob()
+{
+    Close();
+
+    std::lock_guard<std::mutex> lock(gRenderNodeJobMutex);
+    gRenderNodeJobs.erase(mId);
+}
+
+std::shared_ptr<RenderNodeJob> RenderNodeJob::Find(int id)
+{
+    std::lock_guard<std::mutex> lock(gRenderNodeJobMutex);
+    auto i = gRenderNodeJobs.find(id);
+    if (i == gRenderNodeJobs.end())
+        return nullptr;
+    return i->second.lock();
+}
+
+UCS2String RenderNodeJob::FindFile(const UCS2String& sceneName) const
+{
+    FileMap::const_iterator i = mFiles.find(sceneName);
+    if (i == mFiles.end())
+        return UCS2String();
+    return i->second->GetFileName();
+}
+
+void RenderNodeJob::ReceiveJob(POV_ULONG maxSize)
+{
+    // the limit covers everything the coordinator sends before the render starts
+    mConnection.SetReceiveLimit(maxSize);
+
+    POVMS_Message msg;
+    mConnection.Receive(msg);
+    if (msg.GetIdentifier() != kPOVMsgIdent_RenderJob)
+        throw POV_EXCEPTION(kNetworkDataErr, "Unexpected message from '" + mConnection.GetPeerName() + "'");
+
+    POVMS_List files;
+    msg.Get(kPOVAttrib_RenderNodeOptions, mOptions);
+    msg.Get(kPOVAttrib_RenderNodeFiles, files);
+
+    // check the announced sizes up front, so as not to write any files for a job that is too large
+    POV_ULONG total = 0;
+    for (int i = 1; i <= files.GetListSize(); i++)
+    {
+        POVMS_Object file;
+        files.GetNth(i, file);
+        POVMSLong size = file.GetLong(kPOVAttrib_RenderNodeFileSize);
+        if (size < 0)
+            throw POV_EXCEPTION(kNetworkDataErr, "Invalid file size from '" + mConnection.GetPeerName() + "'");
+        total += (POV_ULONG)size;
+        if (total > maxSize)
+            throw POV_EXCEPTION(kInternalLimitErr, "Job from '" + mConnection.GetPeerName() + "' exceeds the size limit of " +
+                                                   std::to_string(maxSize / (1024 * 1024)) + " MB");
+    }
+
+    // The platform may hand out only one temporary file name per process,
+    // so derive a distinct name for each file of each job from it.
+    const UCS2String tempBase(Filesystem::TemporaryFile().GetFileName() +
+                              ASCIItoUCS2String("-" + std::to_string(mId) + "-"));
+
+    std::vector<char> buffer(kRenderNodeChunkSize);
+    for (int i = 1; i <= files.GetListSize(); i++)
+    {
+        POVMS_Object file;
+        files.GetNth(i, file);
+        UCS2String name(file.GetUCS2String(kPOVAttrib_ReadFile));
+        POVMSLong remaining = file.GetLong(kPOVAttrib_RenderNodeFileSize);
+
+        Filesystem::TemporaryFilePtr copy(new Filesystem::TemporaryFile(tempBase + ASCIItoUCS2String(std::to_string(i))));
+        std::unique_ptr<OStream> out(NewOStream(Path(copy->GetFileName()), POV_File_Unknown, false));
+        if (out == nullptr)
+            throw POV_EXCEPTION(kCannotOpenFileErr, "Cannot create local copy of '" + UCS2toSysString(name) + "'");
+        while (remaining > 0)
+        {
+            size_t chunk = size_t(std::min<POVMSLong>(remaining, kRenderNodeChunkSize));
+            mConnection.ReceiveData(buffer.data(), chunk);
+            if (!out->write(buffer.data(), chunk))
+                throw POV_EXCEPTION(kFileDataErr, "Cannot write local copy of '" + UCS2toSysString(name) + "'");
+            remaining -= chunk;
+        }
+        mFiles[name] = copy;
+    }
+
+    // The node renders the frame as a single still image on behalf of the coordinator,
+    // so strip everything that concerns output, animation or the coordinator's machine.
+    static const POVMSType kCoordinatorOnlyOptions[] = {
+        kPOVAttrib_RenderNodes,
+        kPOVAttrib_RenderNodeToken,
+        kPOVAttrib_CreateIni,
+        kPOVAttrib_IncludeCachePath,
+        kPOVAttrib_InitialFrame,
+        kPOVAttrib_FinalFrame,
+        kPOVAttrib_SubsetStartFrame,
+        kPOVAttrib_SubsetEndFrame,
+        kPOVAttrib_PreSceneCommand,
+        kPOVAttrib_PreFrameCommand,
+        kPOVAttrib_PostSceneCommand,
+        kPOVAttrib_PostFrameCommand,
+        kPOVAttrib_UserAbortCommand,
+        kPOVAttrib_FatalErrorCommand,
+        kPOVAttrib_ContinueTrace,
+        kPOVAttrib_PixelSkipList,
+        kPOVAttrib_RadiosityFromFile,
+        kPOVAttrib_RadiosityToFile,
+        kPOVAttrib_ReuseScene,
+        kPOVAttrib_SharedFramebufferFile,
+    };
+    for (POVMSType key : kCoordinatorOnlyOptions)
+    {
+        if (mOptions.Exist(key))
+            mOptions.Remove(key);
+    }
+    mOptions.SetBool(kPOVAttrib_OutputToFile, false);
+    mOptions.SetBool(kPOVAttrib_Display, false);
+    mOptions.SetBool(kPOVAttrib_PauseWhenDone, false);
+    mOptions.SetInt(kPOVAttrib_RenderNodeJob, mId);
+}
+
+void RenderNodeJob::Ready(unsigned int threads)
+{
+    POVMS_Message msg(kPOVObjectClass_ResultData, kPOVMsgClass_RenderNode, kPOVMsgIdent_Done);
+    msg.SetInt(kPOVAttrib_MaxRenderThreads, threads);
+    mReady = true;
+    try
+    {
+        mConnection.Send(msg);
+    }
+    catch (pov_base::Exception&)
+    {
+        // the coordinator is gone; there won't be any blocks to render
+        std::lock_guard<std::mutex> lock(mBlockMutex);
+        mFinished = true;
+        mBlockAvailable.notify_all();
+        return;
+    }
+
+    mReceiverThread = std::thread(&RenderNodeJob::ReceiveBlocks, this);
+}
+
+void RenderNodeJob::Fail(const std::string& message)
+{
+    if (mReady)
+        return;
+
+    try
+    {
+        POVMS_Message msg(kPOVObjectClass_ResultData, kPOVMsgClass_RenderNode, kPOVMsgIdent_Failed);
+        msg.SetString(kPOVAttrib_EnglishText, message.c_str());
+        mConnection.Send(msg);
+    }
+    catch (pov_base::Exception&)
+    {
+        // the coordinator will notice the connection closing instead
+    }
+}
+
+void RenderNodeJob::ReceiveBlocks()
+{
+    try
+    {
+        for (;;)
+        {
+            POVMS_Message msg;
+            mConnection.Receive(msg);
+            if (msg.GetIdentifier() == kPOVMsgIdent_RenderBlock)
+            {
+                Block block;
+                block.serial = msg.GetInt(kPOVAttrib_PixelId);
+                block.rect = POVRect(msg.GetInt(kPOVAttrib_Left), msg.GetInt(kPOVAttrib_Top),
+                                     msg.GetInt(kPOVAttrib_Right), msg.GetInt(kPOVAttrib_Bottom));
+                std::lock_guard<std::mutex> lock(mBlockMutex);
+                mBlocks.push_back(block);
+                mBlockAvailable.notify_one();
+            }
+            else if (msg.GetIdentifier() == kPOVMsgIdent_Done)
+                break;
+        }
+    }
+    catch (pov_base::Exception&)
+    {
+        // connection lost; the coordinator renders any outstanding blocks elsewhere
+    }
+
+    std::lock_guard<std::mutex> lock(mBlockMutex);
+    mFinished = true;
+    mBlockAvailable.notify_all();
+}
+
+bool RenderNodeJob::GetNextBlock(POVRect& rect, unsigned int& serial)
+{
+    std::unique_lock<std::mutex> lock(mBlockMutex);
+    while (mBlocks.empty() && !mFinished)
+        mBlockAvailable.wait(lock);
+    if (mBlocks.empty())
+        return false;
+    rect = mBlocks.front().rect;
+    serial = mBlocks.front().serial;
+    mBlocks.pop_front();
+    return true;
+}
+
+void RenderNodeJob::SendPixels(POVMS_Object& msg, unsigned int serial)
+{
+    try
+    {
+        msg.SetInt(kPOVAttrib_RenderNodeBlock, serial);
+        mConnection.Send(msg);
+    }
+    catch (pov_base::Exception&)
+    {
+        // the coordinator is gone; shutting down the connection makes the node run out of blocks
+        mConnection.Shutdown();
+    }
+}
+
+void RenderNodeJob::Close()
+{
+    mConnection.Shutdown();
+    {
+        std::lock_guard<std::mutex> lock(mBlockMutex);
+        mFinished = true;
+        mBlockAvailable.notify_all();
+    }
+    if (mReceiverThread.joinable())
+        mReceiverThread.join();
+}
+
+//******************************************************************************
+
+struct RenderNodeServer::Impl final
+{
+    boost::asio::io_context context;
+    tcp::acceptor           acceptor;
+    std::string             token;
+    POV_ULONG               maxJobSize;
+
+    Impl(const boost::asio::ip::address& address, unsigned short port, const std::string& t, POV_ULONG m) :
+        acceptor(context),
+        token(t),
+        maxJobSize(m)
+    {
+        tcp::endpoint endpoint(address, port);
+        boost::system::error_code ec;
+        acceptor.open(endpoint.protocol(), ec);
+        if (!ec && address.is_v6() && address.is_unspecified())
+        {
+            // make the IPv6 any-address a dual-stack socket, which takes IPv4 connections as well
+            acceptor.set_option(boost::asio::ip::v6_only(false), ec);
+        }
+        else if (ec && address.is_v6() && address.is_unspecified())
+        {
+            // the system has no IPv6 support; fall back to the IPv4 any-address
+            endpoint = tcp::endpoint(tcp::v4(), port);
+            acceptor.open(endpoint.protocol());
+        }
+        else if (ec)
+            throw boost::system::system_error(ec);
+        acceptor.set_option(tcp::acceptor::reuse_address(true));
+        acceptor.bind(endpoint);
+        acceptor.listen();
+    }
+};
+
+/// Name of a peer, for display purposes.
+static std::string GetPeerName(const tcp::endpoint& peer)
+{
+    boost::asio::ip::address address(peer.address());
+    if (address.is_v6() && address.to_v6().is_v4_mapped())
+        address = boost::asio::ip::make_address_v4(boost::asio::ip::v4_mapped, address.to_v6());
+    if (address.is_v6())
+        return "[" + address.to_string() + "]:" + std::to_string(peer.port());
+    return address.to_string() + ":" + std::to_string(peer.port());
+}
+
+RenderNodeServer::RenderNodeServer(const std::string& address, unsigned short port, const std::string& token, POV_ULONG maxJobSize)
+{
+    if (token.length() > kMaxRenderNodeTokenLength)
+        throw POV_EXCEPTION(kParamErr, "Render node token is longer than " + std::to_string(kMaxRenderNodeTokenLength) + " characters");
+
+    boost::system::error_code ec;
+    boost::asio::ip::address bindAddress(boost::asio::ip::make_address(address, ec));
+    if (ec)
+        throw POV_EXCEPTION(kParamErr, "Invalid render node address '" + address + "'");
+
+    try
+    {
+        mpImpl.reset(new Impl(bindAddress, port, token, maxJobSize));
+    }
+    catch (boost::system::system_error& e)
+    {
+        throw POV_EXCEPTION(kNetworkConnectionErr, "Cannot listen on " + address + " port " + std::to_string(port) + ": " + e.code().message());
+    }
+}
+
+RenderNodeServer::~RenderNodeServer()
+{}
+
+std::shared_ptr<RenderNodeJob> RenderNodeServer::Accept(const boost::function<bool()>& keepWaiting)
+{
+    std::shared_ptr<RenderNodeJob> job;
+    {
+        std::lock_guard<std::mutex> lock(gRenderNodeJobMutex);
+        job.reset(new RenderNodeJob(gNextRenderNodeJobId++));
+    }
+
+    tcp::socket& socket = job->mConnection.mpImpl->socket;
+    boost::system::error_code ec;
+    bool done = false;
+    mpImpl->acceptor.async_accept(socket, [&](const boost::system::error_code& e) { ec = e; done = true; });
+    while (!done)
+    {
+        mpImpl->context.restart();
+        mpImpl->context.run_for(kRenderNodePollInterval);
+        if (!done && !keepWaiting())
+        {
+            mpImpl->acceptor.cancel(ec);
+            mpImpl->context.restart();
+            mpImpl->context.run();
+            return nullptr;
+        }
+    }
+    if (ec)
+        throw POV_EXCEPTION(kNetworkConnectionErr, "Cannot accept connection: " + ec.message());
+
+    job->mConnection.mpImpl->SetupSocket();
+    tcp::endpoint peer = socket.remote_endpoint(ec);
+    job->mConnection.mPeerName = (ec ? std::string("unknown") : GetPeerName(peer));
+
+    // don't let a stalled coordinator block the node indefinitely
+    job->mConnection.SetReceiveTimeout(kRenderNodeJobTimeout);
+    if (!job->mConnection.AcceptHandshake(mpImpl->token))
+        throw POV_EXCEPTION(kAuthorisationErr, "Coordinator '" + job->mConnection.mPeerName + "' presented the wrong token");
+    job->ReceiveJob(mpImpl->maxJobSize);
+    job->mConnection.SetReceiveTimeout(0);
+    job->mConnection.SetReceiveLimit(0);
+
+    std::lock_guard<std::mutex> lock(gRenderNodeJobMutex);
+    gRenderNodeJobs[job->mId] = job;
+    return job;
+}
+
+}
+// end of namespace pov
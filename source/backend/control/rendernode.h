@@ -0,0 +1,340 @@
+//******************************************************************************
+///
+/// @file backend/control/rendernode.h
+///
+/// Declarations related to distributing a render across several processes.
+///
+/// @copyright
+/// @parblock
+///
+/// Persistence of Vision Ray Tracer ('POV-Ray') version 3.8.
+/// Copyright 1991-2019 Persistence of Vision Raytracer Pty. Ltd.
+///
+/// POV-Ray is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU Affero General Public License as
+/// published by the Free Software Foundation, either version 3 of the
+/// License, or (at your option) any later version.
+///
+/// POV-Ray is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU Affero General Public License for more details.
+///
+/// You should have received a copy of the GNU Affero General Public License
+/// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+///
+/// ----------------------------------------------------------------------------
+///
+/// POV-Ray is based on the popular DKB raytracer version 2.12.
+/// DKBTrace was originally written by David K. Buck.
+/// DKBTrace Ver 2.0-2.12 were written by David K. Buck & Aaron A. Collins.
+///
+/// @endparblock
+///
+//******************************************************************************
+
+#ifndef POVRAY_BACKEND_RENDERNODE_H
+#define POVRAY_BACKEND_RENDERNODE_H
+
+// Module config header file must be the first file included within POV-Ray unit header files
+#include "backend/configbackend.h"
+#include "backend/control/rendernode_fwd.h"
+
+// C++ variants of C standard header files
+//  (none at the moment)
+
+// C++ standard header files
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Boost header files
+#include <boost/function.hpp>
+
+// POV-Ray header files (base module)
+#include "base/filesystem_fwd.h"
+#include "base/stringtypes.h"
+#include "base/types.h"
+
+// POV-Ray header files (POVMS module)
+#include "povms/povmscpp.h"
+
+namespace pov
+{
+
+//******************************************************************************
+///
+/// @name Render Nodes
+///
+/// A render may be distributed across several processes, possibly running on
+/// different machines: The _coordinator_ is a regular render, given a list of
+/// _render nodes_ via the `Render_Nodes` option; each render node is a process
+/// waiting for jobs on a TCP port.
+///
+/// The coordinator parses the scene as usual, and once the render starts it
+/// connects to each node, identifies itself (see below) and sends it a job, comprising the render options and
+/// the content of every file the coordinator read while parsing. The node
+/// parses the scene from that data, and then renders whichever blocks the
+/// coordinator asks for, sending back the resulting pixels. Blocks are handed
+/// out by the coordinator's @ref ViewData just like they are to its own render
+/// threads, so faster nodes automatically get more work, and blocks held by a
+/// node that drops out are rendered elsewhere.
+///
+/// Right after connecting, the coordinator sends a handshake: the 8 characters
+/// `POVRNODE`, the length of its token as a 4-byte big-endian integer, and the
+/// token itself. The node replies with a single byte, 1 if the token matches
+/// its own and 0 otherwise, in which case it closes the connection. A node
+/// without a token only accepts coordinators without one.
+///
+/// All further messages are POVMS objects in stream form, as produced by
+/// @ref POVMS_Object::Write(). They are exchanged as follows:
+///
+///   - Coordinator to node: @ref kPOVMsgIdent_RenderJob, carrying the render
+///     options (@ref kPOVAttrib_RenderNodeOptions) and a list of files
+///     (@ref kPOVAttrib_RenderNodeFiles), each given by its name as used in the
+///     scene and its size; the raw content of the files follows the message.
+///   - Node to coordinator: @ref kPOVMsgIdent_Done once the scene has been
+///     parsed, giving the number of render threads, or @ref kPOVMsgIdent_Failed
+///     with a description of the problem.
+///   - Coordinator to node: @ref kPOVMsgIdent_RenderBlock for each block to
+///     render, giving its serial number and rectangle.
+///   - Node to coordinator: @ref kPOVMsgIdent_PixelBlockSet for each completed
+///     block, in the same form as sent to the frontend, plus the block's serial
+///     number (@ref kPOVAttrib_RenderNodeBlock).
+///   - Coordinator to node: @ref kPOVMsgIdent_Done once there are no more
+///     blocks to render, after which the connection is closed.
+///
+/// A node that fails to deliver a block within `Render_Node_Timeout` seconds
+/// is dropped, and the blocks it holds are rendered elsewhere. Likewise, a node
+/// drops a coordinator that stalls while sending the job, or whose files add up
+/// to more than the node's job size limit.
+///
+/// @note
+///     The stochastic seed is shared with the nodes, but each node computes its
+///     own radiosity and photon data; with either of these in use, blocks
+///     rendered by nodes may differ slightly from those rendered locally.
+///
+/// @note
+///     A node runs whatever scene an accepted coordinator sends, subject only
+///     to its own file I/O restrictions. By default it only listens on the
+///     loopback interface; when listening on a network, a token should be set.
+///     The token is sent in the clear, so it keeps out other hosts, but not
+///     eavesdroppers; untrusted networks call for a tunnel (e.g. via SSH).
+///
+/// @{
+
+/// Default TCP port of render nodes.
+const unsigned short kDefaultRenderNodePort = 7341;
+
+/// Default time in seconds to wait for a render node to deliver a block.
+const unsigned int kDefaultRenderNodeTimeout = 300;
+
+/// Default address for render nodes to listen on, admitting local coordinators only.
+const char *const kDefaultRenderNodeBindAddress = "127.0.0.1";
+
+/// Default limit in megabytes for the total size of the files of a render node job.
+const unsigned int kDefaultRenderNodeMaxJobSize = 1024;
+
+/// Maximum length of a render node token.
+const size_t kMaxRenderNodeTokenLength = 1024;
+
+//******************************************************************************
+
+/// TCP connection between a coordinator and a render node.
+///
+/// Sending is thread-safe; receiving must be done by a single thread at a time.
+///
+class RenderNodeConnection final
+{
+public:
+
+    RenderNodeConnection();
+    ~RenderNodeConnection();
+
+    RenderNodeConnection(const RenderNodeConnection&) = delete;
+    RenderNodeConnection& operator=(const RenderNodeConnection&) = delete;
+
+    /// Connect to a render node, and identify to it.
+    /// @param  address     Address of the node, in the form `host[:port]`.
+    /// @param  token       Token to present to the node.
+    /// @param  cooperate   Function to be called periodically while waiting;
+    ///                     may throw to abort the attempt.
+    /// @throw  pov_base::Exception if the node can't be reached, or rejects the token.
+    void Connect(const std::string& address, const std::string& token, const boost::function<void()>& cooperate);
+
+    /// Send a message.
+    void Send(POVMS_Object& msg);
+
+    /// Send raw data.
+    void SendData(const void *data, size_t size);
+
+    /// Receive a message, waiting no longer than the receive timeout.
+    void Receive(POVMS_Object& msg);
+
+    /// Receive raw data, waiting no longer than the receive timeout.
+    void ReceiveData(void *data, size_t size);
+
+    /// Set the time to wait for each chunk of incoming data.
+    /// @param  milliseconds    Receive timeout, or 0 to wait as long as necessary (the default).
+    void SetReceiveTimeout(unsigned int milliseconds) { mReceiveTimeout = milliseconds; }
+
+    /// Limit the amount of data to receive from now on.
+    /// @param  bytes   Number of bytes after which to fail any further receive, or 0 for no limit (the default).
+    void SetReceiveLimit(POV_ULONG bytes);
+
+    /// Wait for incoming data.
+    /// @return `true` if data (or the end of the stream) is pending.
+    bool WaitForData(unsigned int milliseconds);
+
+    /// Shut down the connection, unblocking any thread currently waiting to receive.
+    void Shutdown();
+
+    /// Name of the peer, for display purposes.
+    const std::string& GetPeerName() const { return mPeerName; }
+
+private:
+
+    struct Impl;
+    friend class RenderNodeServer;
+
+    /// Check the handshake of a coordinator that has just connected, and reply to it.
+    /// @return `true` if the coordinator presented the given token.
+    bool AcceptHandshake(const std::string& token);
+
+    std::unique_ptr<Impl>   mpImpl;
+    std::mutex              mSendMutex;
+    std::string             mPeerName;
+    unsigned int            mReceiveTimeout;
+};
+
+//******************************************************************************
+
+/// Render job as received by a render node.
+///
+/// While a job is in progress, it can be looked up via its ID, which the node
+/// passes to its own backend as @ref kPOVAttrib_RenderNodeJob, so that the
+/// backend can read the scene's files from the job, and take its blocks from
+/// (and send the results to) the coordinator.
+///
+class RenderNodeJob final
+{
+public:
+
+    ~RenderNodeJob();
+
+    RenderNodeJob(const RenderNodeJob&) = delete;
+    RenderNodeJob& operator=(const RenderNodeJob&) = delete;
+
+    /// Look up a job in progress.
+    /// @return The job, or `nullptr` if there is no such job.
+    static std::shared_ptr<RenderNodeJob> Find(int id);
+
+    int GetId() const { return mId; }
+
+    /// Name of the coordinator, for display purposes.
+    const std::string& GetCoordinatorName() const { return mConnection.GetPeerName(); }
+
+    /// Render options to use for the job.
+    /// The options are those of the coordinator, adjusted for use on the node.
+    POVMS_Object& GetRenderOptions() { return mOptions; }
+
+    /// Get the local copy of a file shipped with the job.
+    /// @param  sceneName   Name of the file as used in the scene.
+    /// @return Name of the local copy, or an empty string if the file was not shipped.
+    pov_base::UCS2String FindFile(const pov_base::UCS2String& sceneName) const;
+
+    /// Tell the coordinator that the scene is ready to render.
+    void Ready(unsigned int threads);
+
+    /// Tell the coordinator that the job has failed, unless rendering has already begun.
+    void Fail(const std::string& message);
+
+    /// Get the next block to render.
+    /// This method waits until the coordinator has either sent a block, or
+    /// indicated that there are no more blocks.
+    /// @return `false` if there are no more blocks.
+    bool GetNextBlock(pov_base::POVRect& rect, unsigned int& serial);
+
+    /// Send the pixels of a completed block to the coordinator.
+    void SendPixels(POVMS_Object& msg, unsigned int serial);
+
+    /// Close the connection to the coordinator.
+    void Close();
+
+private:
+
+    struct Block final
+    {
+        pov_base::POVRect   rect;
+        unsigned int        serial;
+    };
+
+    typedef std::map<pov_base::UCS2String, pov_base::Filesystem::TemporaryFilePtr> FileMap;
+
+    int                     mId;
+    RenderNodeConnection    mConnection;
+    POVMS_Object            mOptions;
+    FileMap                 mFiles;
+    std::deque<Block>       mBlocks;
+    bool                    mReady;
+    bool                    mFinished;
+    std::mutex              mBlockMutex;
+    std::condition_variable mBlockAvailable;
+    std::thread             mReceiverThread;
+
+    RenderNodeJob(int id);
+
+    void ReceiveJob(POV_ULONG maxSize);
+    void ReceiveBlocks();
+
+    friend class RenderNodeServer;
+};
+
+//******************************************************************************
+
+/// Listening socket of a render node.
+class RenderNodeServer final
+{
+public:
+
+    /// Start listening for coordinators.
+    /// @param  address     Local address to listen on; the IPv6 any-address `::`
+    ///                     listens via both IPv6 and IPv4 where available.
+    /// @param  port        TCP port to listen on.
+    /// @param  token       Token coordinators have to present, or an empty string
+    ///                     to accept only coordinators without a token.
+    /// @param  maxJobSize  Limit for the total size of the files of a job, in bytes.
+    RenderNodeServer(const std::string& address, unsigned short port, const std::string& token, POV_ULONG maxJobSize);
+    ~RenderNodeServer();
+
+    RenderNodeServer(const RenderNodeServer&) = delete;
+    RenderNodeServer& operator=(const RenderNodeServer&) = delete;
+
+    /// Wait for a coordinator to connect, and receive its job.
+    /// @param  keepWaiting     Function to be called periodically while waiting;
+    ///                         waiting is abandoned as soon as it returns `false`.
+    /// @return The job, or `nullptr` if waiting was abandoned.
+    /// @throw  pov_base::Exception if the job could not be received, e.g. because
+    ///         the coordinator presented the wrong token, stalled while sending the
+    ///         job, or exceeded the job size limit.
+    std::shared_ptr<RenderNodeJob> Accept(const boost::function<bool()>& keepWaiting);
+
+private:
+
+    struct Impl;
+
+    std::unique_ptr<Impl>   mpImpl;
+};
+
+/// @}
+///
+//******************************************************************************
+
+}
+// end of namespace pov
+
+#endif // POVRAY_BACKEND_RENDERNODE_H
@@ -51,6 +51,7 @@
 
 // POV-Ray header files (core module)
 #include "core/scene/tracethreaddata.h"
+#include "core/support/scenearena.h"
 
 // POV-Ray header files (POVMS module)
 #include "povms/povmscpp.h"
@@ -62,8 +63,10 @@
 // POV-Ray header files (backend module)
 #include "backend/bounding/boundingtask.h"
 #include "backend/control/parsertask.h"
+#include "backend/control/rendernode.h"
 #include "backend/scene/backendscenedata.h"
 #include "backend/scene/view.h"
+#include "backend/support/timeline.h"
 
 // this must be the last file included
 #include "base/povdebug.h"
@@ -120,6 +123,10 @@ void Scene::StartParser(POVMS_Object& parseOptions)
     sceneData->inputFile = parseOptions.TryGetUCS2String(kPOVAttrib_InputFile, "object.pov");
     sceneData->headerFile = parseOptions.TryGetUCS2String(kPOVAttrib_IncludeHeader, "");
 
+    // when running as a render node, the scene's files come with the job
+    if (parseOptions.Exist(kPOVAttrib_RenderNodeJob))
+        sceneData->renderNodeJob = RenderNodeJob::Find(parseOptions.GetInt(kPOVAttrib_RenderNodeJob));
+
     DBL outputWidth  = parseOptions.TryGetFloat(kPOVAttrib_Width, 160);
     DBL outputHeight = parseOptions.TryGetFloat(kPOVAttrib_Height, 120);
     sceneData->aspectRatio = outputWidth / outputHeight;
@@ -148,6 +155,9 @@ void Scene::StartParser(POVMS_Object& parseOptions)
 
     sceneData->realTimeRaytracing = parseOptions.TryGetBool(kPOVAttrib_RealTimeRaytracing, false);
 
+    if (parseOptions.Exist(kPOVAttrib_TimelineFile))
+        sceneData->timeline = std::make_shared<Timeline>();
+
     if(parseOptions.Exist(kPOVAttrib_Declare) == true)
     {
         POVMS_List ds;
@@ -182,7 +192,10 @@ void Scene::StartParser(POVMS_Object& parseOptions)
 
     // do parsing
     sceneThreadData.push_back(dynamic_cast<TraceThreadData *>(parserTasks.AppendTask(new ParserTask(
-        sceneData, pov_parser::ParserOptions(bool(parseOptions.Exist(kPOVAttrib_Clock)), parseOptions.TryGetFloat(kPOVAttrib_Clock, 0.0), seed)
+        sceneData, pov_parser::ParserOptions(bool(parseOptions.Exist(kPOVAttrib_Clock)), parseOptions.TryGetFloat(kPOVAttrib_Clock, 0.0), seed,
+                                             parseOptions.TryGetUCS2String(kPOVAttrib_IncludeCachePath, ""),
+                                             parseOptions.TryGetBool(kPOVAttrib_ProfileObjects, false),
+                                             parseOptions.TryGetInt(kPOVAttrib_MaxRenderThreads, 0))
         ))));
 
     // wait for parsing
@@ -308,6 +321,34 @@ void Scene::GetStatistics(POVMS_Object& parserStats)
     parserStats.SetInt(kPOVAttrib_LightSources, POVMSInt(sceneData->lightSources.size()));
     parserStats.SetInt(kPOVAttrib_Cameras, POVMSInt(sceneData->cameras.size()));
 
+    if ((sceneData->includeCacheHits > 0) || (sceneData->includeCacheMisses > 0))
+    {
+        parserStats.SetInt(kPOVAttrib_IncludeCacheHits, sceneData->includeCacheHits);
+        parserStats.SetInt(kPOVAttrib_IncludeCacheMisses, sceneData->includeCacheMisses);
+    }
+
+    if (sceneData->symbolLookups > 0)
+    {
+        parserStats.SetLong(kPOVAttrib_SymbolLookups, sceneData->symbolLookups);
+        parserStats.SetLong(kPOVAttrib_SymbolProbes, sceneData->symbolProbes);
+        parserStats.SetInt(kPOVAttrib_GlobalSymbols, sceneData->globalSymbols);
+        parserStats.SetInt(kPOVAttrib_GlobalSymbolSlots, sceneData->globalSymbolSlots);
+    }
+
+    if (sceneData->arena->GetReservedBytes() > 0)
+    {
+        std::vector<POVMSLong> blocks, bytes;
+        for (int i = 0; i < int(SceneArenaCategory::kCount); ++i)
+        {
+            SceneArena::Usage usage = sceneData->arena->GetUsage(SceneArenaCategory(i));
+            blocks.push_back(usage.blocks);
+            bytes.push_back(usage.bytes);
+        }
+        parserStats.SetLongVector(kPOVAttrib_SceneMemoryBlocks, blocks);
+        parserStats.SetLongVector(kPOVAttrib_SceneMemoryBytes, bytes);
+        parserStats.SetLong(kPOVAttrib_SceneMemoryReserved, sceneData->arena->GetReservedBytes());
+    }
+
     if(sceneData->boundingMethod == 2)
     {
         parserStats.SetInt(kPOVAttrib_BSPNodes, sceneData->nodes);
@@ -353,6 +394,21 @@ void Scene::SendDoneMessage(TaskQueue&)
         doneMessage.SetInt(kPOVAttrib_WorkingGammaType, sceneData->workingGamma->GetTypeId());
         doneMessage.SetFloat(kPOVAttrib_WorkingGamma, sceneData->workingGamma->GetParam());
     }
+    if (sceneData->readFileStatusComplete && !sceneData->readFileStatus.empty())
+    {
+        POVMS_List files;
+        std::vector<POVMSLong> sizes, times;
+        for (const auto& file : sceneData->readFileStatus)
+        {
+            POVMS_Attribute name(file.first.c_str());
+            files.Append(name);
+            sizes.push_back(POVMSLong(file.second.size));
+            times.push_back(POVMSLong(file.second.modificationTime));
+        }
+        doneMessage.Set(kPOVAttrib_ReadFiles, files);
+        doneMessage.SetLongVector(kPOVAttrib_ReadFileSizes, sizes);
+        doneMessage.SetLongVector(kPOVAttrib_ReadFileTimes, times);
+    }
     POVMS_SendMessage(doneMessage);
 }
 
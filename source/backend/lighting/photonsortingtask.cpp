@@ -37,11 +37,21 @@
 #include "backend/lighting/photonsortingtask.h"
 
 // C++ variants of C standard header files
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+
 // C++ standard header files
-//  (none at the moment)
+#include <limits>
+#include <memory>
+
+// Boost header files
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 
 // POV-Ray header files (base module)
-//  (none at the moment)
+#include "base/filesystem.h"
+#include "base/stringutilities.h"
 
 // POV-Ray header files (core module)
 #include "core/bounding/boundingbox.h"
@@ -70,6 +80,139 @@
 namespace pov
 {
 
+namespace bip = boost::interprocess;
+
+namespace
+{
+
+// Binary photon map file layout.
+//
+// The file consists of a header, followed by the surface and media photon maps. Each map starts
+// with its own header carrying the gather settings computed when it was built, followed by the
+// photons in their balanced kd-tree order, so that no sorting or gather setup is needed on load.
+// Legacy files (a plain photon count followed by the photons) are still accepted for loading.
+//
+// Files are loaded by mapping them into memory read-only, and pointing the photon maps straight
+// at the mapped photons; processes loading the same file thus share a single copy of the photons.
+// Files are replaced atomically when saved, so that a mapped file never changes underneath a reader.
+
+const char kPhotonFileMagic[8] = { 'P', 'O', 'V', 'P', 'H', 'M', '\x1a', '\0' };
+constexpr POV_UINT32 kPhotonFileVersion   = 1;
+constexpr POV_UINT32 kPhotonFileByteOrder = 0x01020304;
+
+struct PhotonFileHeader final
+{
+    char        magic[8];
+    POV_UINT32  version;
+    POV_UINT32  byteOrder;
+    POV_UINT32  photonSize;     // size of a photon record, for sanity checking
+    POV_UINT32  mapCount;
+};
+
+struct PhotonFileMapHeader final
+{
+    POV_UINT32  photonCount;
+    POV_INT32   gatherNumSteps;
+    double      minGatherRad;
+    double      minGatherRadMult;
+    double      gatherRadStep;
+};
+
+bool WritePhotonMap(FILE *f, const PhotonMap& map)
+{
+    PhotonFileMapHeader mapHeader;
+    mapHeader.photonCount      = map.numPhotons;
+    mapHeader.gatherNumSteps   = map.gatherNumSteps;
+    mapHeader.minGatherRad     = map.minGatherRad;
+    mapHeader.minGatherRadMult = map.minGatherRadMult;
+    mapHeader.gatherRadStep    = map.gatherRadStep;
+
+    if (fwrite(&mapHeader, sizeof(mapHeader), 1, f) != 1)
+        return false;
+
+    for (unsigned int i = 0; i < mapHeader.photonCount; )
+    {
+        unsigned int count = mapHeader.photonCount - i;
+        const Photon *ph = map.GetPhotons(i, count);
+        if (fwrite(ph, sizeof(Photon), count, f) != count)
+            return false;
+        i += count;
+    }
+
+    return true;
+}
+
+/// Cursor over a memory-mapped photon map file.
+struct PhotonFileData final
+{
+    const char* pos;
+    const char* end;
+    std::shared_ptr<const void> storage;    ///< Keeps the mapping alive.
+
+    bool Read(void* data, size_t size)
+    {
+        if (size_t(end - pos) < size)
+            return false;
+        memcpy(data, pos, size);
+        pos += size;
+        return true;
+    }
+
+    const Photon* GetPhotons(size_t count)
+    {
+        if ((size_t(end - pos) / sizeof(Photon) < count) ||
+            (reinterpret_cast<std::uintptr_t>(pos) % alignof(Photon) != 0))
+            return nullptr;
+        const Photon* photons = reinterpret_cast<const Photon*>(pos);
+        pos += count * sizeof(Photon);
+        return photons;
+    }
+};
+
+/// Photon map as found in a photon map file, validated but not yet applied.
+struct PhotonFileMap final
+{
+    PhotonFileMapHeader header;
+    const Photon*       photons;
+};
+
+bool ReadPhotonMap(PhotonFileData& file, PhotonFileMap& map)
+{
+    if (!file.Read(&map.header, sizeof(map.header)) ||
+        (map.header.photonCount > POV_UINT32(std::numeric_limits<int>::max())))
+        return false;
+
+    map.photons = file.GetPhotons(map.header.photonCount);
+    return (map.photons != nullptr);
+}
+
+bool ReadLegacyPhotonMap(PhotonFileData& file, PhotonFileMap& map)
+{
+    int numph;
+    if (!file.Read(&numph, sizeof(numph)) || (numph < 0))
+        return false;
+
+    map.header.photonCount = numph;
+    map.photons = file.GetPhotons(map.header.photonCount);
+    return (map.photons != nullptr);
+}
+
+void AttachPhotonMap(PhotonMap& map, const PhotonFileMap& fileMap, const PhotonFileData& file, bool withGatherOptions)
+{
+    map.AttachPhotons(fileMap.photons, fileMap.header.photonCount, file.storage);
+
+    if (withGatherOptions)
+    {
+        map.gatherNumSteps   = fileMap.header.gatherNumSteps;
+        map.minGatherRad     = fileMap.header.minGatherRad;
+        map.minGatherRadMult = fileMap.header.minGatherRadMult;
+        map.gatherRadStep    = fileMap.header.gatherRadStep;
+    }
+}
+
+}
+// end of anonymous namespace
+
 /*
     If you pass a nullptr for the "strategy" parameter, then this will
     load the photon map from a file.
@@ -86,7 +229,8 @@ PhotonSortingTask::PhotonSortingTask(ViewData *vd, const std::vector<PhotonMap*>
     surfaceMaps(surfaceMaps),
     mediaMaps(mediaMaps),
     strategy(strategy),
-    cooperate(*this)
+    cooperate(*this),
+    gatherOptionsLoaded(false)
 {
 }
 
@@ -127,11 +271,14 @@ void PhotonSortingTask::Run()
         if (!this->load())
             mpMessageFactory->Error(POV_EXCEPTION_STRING("Failed to load photon map from disk"), "Could not load photon map (%s)",GetSceneData()->photonSettings.fileName.c_str());
 
-        // set photon options automatically
-        if (GetSceneData()->surfacePhotonMap.numPhotons>0)
-            GetSceneData()->surfacePhotonMap.setGatherOptions(GetSceneData()->photonSettings,false);
-        if (GetSceneData()->mediaPhotonMap.numPhotons>0)
-            GetSceneData()->mediaPhotonMap.setGatherOptions(GetSceneData()->photonSettings,true);
+        // set photon options automatically, unless they were stored along with the photons
+        if (!gatherOptionsLoaded)
+        {
+            if (GetSceneData()->surfacePhotonMap.numPhotons>0)
+                GetSceneData()->surfacePhotonMap.setGatherOptions(GetSceneData()->photonSettings,false);
+            if (GetSceneData()->mediaPhotonMap.numPhotons>0)
+                GetSceneData()->mediaPhotonMap.setGatherOptions(GetSceneData()->photonSettings,true);
+        }
     }
 
     // good idea to make sure all warnings and errors arrive frontend now [trf]
@@ -235,89 +382,49 @@ void PhotonSortingTask::sortPhotonMap()
 */
 bool PhotonSortingTask::save()
 {
-    Photon *ph;
     FILE *f;
-    int i;
-    size_t err;
-    int numph;
-
-    f = fopen(GetSceneData()->photonSettings.fileName.c_str(), "wb");
-    if (!f)
-        return false;
 
-    /* caustic photons */
-    numph = GetSceneData()->surfacePhotonMap.numPhotons;
-    fwrite(&numph, sizeof(numph),1,f);
-    if ((numph > 0) && !GetSceneData()->surfacePhotonMap.mBlockList.empty())
-    {
-        for(i=0; i<numph; i++)
-        {
-            ph = &GetSceneData()->surfacePhotonMap.GetPhoton(i);
-            err = fwrite(ph, sizeof(Photon), 1, f);
-
-            if (err<=0)
-            {
-                /* fwrite returned an error! */
-                fclose(f);
-                return false;
-            }
-        }
-    }
-    else
-    {
+    if (GetSceneData()->surfacePhotonMap.numPhotons == 0)
         mpMessageFactory->PossibleError("Photon map for surface is empty.");
-    }
+    if (GetSceneData()->mediaPhotonMap.numPhotons == 0)
+        mpMessageFactory->PossibleError("Photon map for media is empty.");
 
-#ifdef GLOBAL_PHOTONS
-    /* global photons */
-    numph = globalPhotonMap.numPhotons;
-    fwrite(&numph, sizeof(numph),1,f);
-    if ((numph > 0) && !globalPhotonMap.mBlockList.empty())
-    {
-        for(i=0; i<numph; i++)
-        {
-            ph = &globalPhotonMap.GetPhoton(i);
-            err = fwrite(ph, sizeof(Photon), 1, f);
-
-            if (err<=0)
-            {
-                /* fwrite returned an error! */
-                fclose(f);
-                return false;
-            }
-        }
-    }
-    else
-    {
-        mpMessageFactory->PossibleError("Global photon map is empty.");
-    }
-#endif
+    PhotonFileHeader header;
+    memcpy(header.magic, kPhotonFileMagic, sizeof(header.magic));
+    header.version    = kPhotonFileVersion;
+    header.byteOrder  = kPhotonFileByteOrder;
+    header.photonSize = sizeof(Photon);
+    header.mapCount   = 2;
 
-    /* media photons */
-    numph = GetSceneData()->mediaPhotonMap.numPhotons;
-    fwrite(&numph, sizeof(numph),1,f);
-    if ((numph > 0) && !GetSceneData()->mediaPhotonMap.mBlockList.empty())
+    // write to a temporary file first, and replace the photon file only once complete,
+    // so that neither the previous file nor any process that has it mapped is disturbed
+    try
     {
-        for(i=0; i<numph; i++)
-        {
-            ph = &GetSceneData()->mediaPhotonMap.GetPhoton(i);
-            err = fwrite(ph, sizeof(Photon), 1, f);
-
-            if (err<=0)
-            {
-                /* fwrite returned an error! */
-                fclose(f);
-                return false;
-            }
-        }
+        UCS2String fileName = SysToUCS2String(GetSceneData()->photonSettings.fileName);
+        Filesystem::TemporaryFile tempFile(Filesystem::TemporaryFile::SuggestNameFor(fileName));
+
+        f = fopen(UCS2toSysString(tempFile.GetFileName()).c_str(), "wb");
+        if (!f)
+            return false;
+
+        bool ok = (fwrite(&header, sizeof(header), 1, f) == 1) &&
+                  WritePhotonMap(f, GetSceneData()->surfacePhotonMap) &&
+                  WritePhotonMap(f, GetSceneData()->mediaPhotonMap);
+
+        if (fclose(f) != 0)
+            ok = false;
+
+        if (!ok || !Filesystem::SyncFile(tempFile.GetFileName()) ||
+            !Filesystem::RenameFile(tempFile.GetFileName(), fileName))
+            return false;
+
+        tempFile.Keep();
+        return true;
     }
-    else
+    catch (pov_base::Exception&)
     {
-        mpMessageFactory->PossibleError("Photon map for media is empty.");
+        return false;
     }
-
-    fclose(f);
-    return true;
 }
 
 /* loadPhotonMap()
@@ -332,77 +439,78 @@ bool PhotonSortingTask::save()
   Postconditions:
     Returns true if success, false if failure.
     If success, the photon map has been loaded from the file.
-    If failure then the render should stop with an error
+    If failure then the photon maps are empty, and the render should stop with an error
 */
 bool PhotonSortingTask::load()
 {
-    int i;
-    size_t err;
-    Photon *ph;
-    FILE *f;
-    int numph;
-
     if (!GetSceneData()->photonSettings.photonsEnabled) return false;
 
     mpMessageFactory->Warning(kWarningGeneral,"Starting the load of photon file %s\n",GetSceneData()->photonSettings.fileName.c_str());
 
-    f = fopen(GetSceneData()->photonSettings.fileName.c_str(), "rb");
-    if (!f)
-        return false;
-
-    fread(&numph, sizeof(numph),1,f);
+    // discard anything left over from a previous render of the same scene
+    GetSceneData()->surfacePhotonMap.Clear();
+#ifdef GLOBAL_PHOTONS
+    GetSceneData()->globalPhotonMap.Clear();
+#endif
+    GetSceneData()->mediaPhotonMap.Clear();
 
-    for(i=0; i<numph; i++)
+    PhotonFileData file;
+    try
     {
-        ph = GetSceneData()->surfacePhotonMap.AllocatePhoton();
-        err = fread(ph, sizeof(Photon), 1, f);
-
-        if (err<=0)
-        {
-            /* fread returned an error! */
-            fclose(f);
-            return false;
-        }
+        bip::file_mapping mapping(GetSceneData()->photonSettings.fileName.c_str(), bip::read_only);
+        std::shared_ptr<bip::mapped_region> region = std::make_shared<bip::mapped_region>(mapping, bip::read_only);
+        file.pos     = reinterpret_cast<const char*>(region->get_address());
+        file.end     = file.pos + region->get_size();
+        file.storage = region;
     }
-
-    if (!feof(f)) /* for backwards file format compatibility */
+    catch (bip::interprocess_exception&)
     {
+        return false;
+    }
+    const char* begin = file.pos;
 
+    // validate the whole file before touching the photon maps
+    PhotonFileMap surfaceMap = { };
+    PhotonFileMap mediaMap = { };
 #ifdef GLOBAL_PHOTONS
-        /* global photons */
-        fread(&numph, sizeof(numph),1,f);
-        for(i=0; i<numph; i++)
-        {
-            ph = GetSceneData()->globalPhotonMap.AllocatePhoton();
-            err = fread(ph, sizeof(Photon), 1, f);
-
-            if (err<=0)
-            {
-                /* fread returned an error! */
-                fclose(f);
-                return false;
-            }
-        }
+    PhotonFileMap globalMap = { };
 #endif
+    bool ok;
 
-        /* media photons */
-        fread(&numph, sizeof(numph),1,f);
-        for(i=0; i<numph; i++)
-        {
-            ph = GetSceneData()->mediaPhotonMap.AllocatePhoton();
-            err = fread(ph, sizeof(Photon), 1, f);
-
-            if (err<=0)
-            {
-                /* fread returned an error! */
-                fclose(f);
-                return false;
-            }
-        }
-
+    PhotonFileHeader header;
+    if (file.Read(&header, sizeof(header)) && (memcmp(header.magic, kPhotonFileMagic, sizeof(header.magic)) == 0))
+    {
+        ok = (header.version == kPhotonFileVersion) &&
+             (header.byteOrder == kPhotonFileByteOrder) &&
+             (header.photonSize == sizeof(Photon)) &&
+             (header.mapCount == 2) &&
+             ReadPhotonMap(file, surfaceMap) &&
+             ReadPhotonMap(file, mediaMap) &&
+             (file.pos == file.end);
+        gatherOptionsLoaded = ok;
+    }
+    else
+    {
+        // legacy file format; older files may lack the media photons
+        file.pos = begin;
+        ok = ReadLegacyPhotonMap(file, surfaceMap);
+#ifdef GLOBAL_PHOTONS
+        if (ok && (file.pos != file.end))
+            ok = ReadLegacyPhotonMap(file, globalMap);
+#endif
+        if (ok && (file.pos != file.end))
+            ok = ReadLegacyPhotonMap(file, mediaMap);
+        ok = ok && (file.pos == file.end);
     }
 
-    fclose(f);
+    if (!ok)
+        return false;
+
+    AttachPhotonMap(GetSceneData()->surfacePhotonMap, surfaceMap, file, gatherOptionsLoaded);
+#ifdef GLOBAL_PHOTONS
+    AttachPhotonMap(GetSceneData()->globalPhotonMap, globalMap, file, gatherOptionsLoaded);
+#endif
+    AttachPhotonMap(GetSceneData()->mediaPhotonMap, mediaMap, file, gatherOptionsLoaded);
     return true;
 }
 
@@ -91,6 +91,7 @@ class PhotonSortingTask final : public RenderTask
         };
 
         CooperateFunction cooperate;
+        bool gatherOptionsLoaded;
 };
 
 }
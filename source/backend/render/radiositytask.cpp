@@ -57,6 +57,7 @@
 #include "backend/scene/backendscenedata.h"
 #include "backend/scene/view.h"
 #include "backend/scene/viewthreaddata.h"
+#include "backend/support/timeline.h"
 
 // this must be the last file included
 #include "base/povdebug.h"
@@ -113,6 +114,9 @@ void RadiosityTask::Run()
 
     while(GetViewData()->GetNextRectangle(rect, serial, pInfo, nominalThreads) == true)
     {
+        Timeline::Scope timelineScope(GetTimeline().get(), "block", "Block", int(serial));
+        SampleCPUTime();
+
         RadiosityBlockInfo* pBlockInfo = dynamic_cast<RadiosityBlockInfo*>(pInfo);
         if (!pBlockInfo)
         {
@@ -256,7 +260,7 @@ void RadiosityTask::Run()
 
         GetViewDataPtr()->AfterTile();
         if(pixelpositions.size() > 0)
-            GetViewData()->CompletedRectangle(rect, serial, pixelpositions, pixelcolors, int(ceil(pretraceSize)), false, false, progressWeight, pBlockInfo);
+            GetViewData()->CompletedRectangle(rect, serial, pixelpositions, pixelcolors, std::vector<POVMSFloat>(), int(ceil(pretraceSize)), false, false, progressWeight, pBlockInfo);
         else
             GetViewData()->CompletedRectangle(rect, serial, progressWeight, pBlockInfo);
     }
@@ -0,0 +1,302 @@
+//******************************************************************************
+///
+/// @file backend/render/rendernodetask.cpp
+///
+/// Implementations related to the task driving a render node.
+///
+/// @copyright
+/// @parblock
+///
+/// Persistence of Vision Ray Tracer ('POV-Ray') version 3.8.
+/// Copyright 1991-2019 Persistence of Vision Raytracer Pty. Ltd.
+///
+/// POV-Ray is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU Affero General Public License as
+/// published by the Free Software Foundation, either version 3 of the
+/// License, or (at your option) any later version.
+///
+/// POV-Ray is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU Affero General Public License for more details.
+///
+/// You should have received a copy of the GNU Affero General Public License
+/// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+///
+/// ----------------------------------------------------------------------------
+///
+/// POV-Ray is based on the popular DKB raytracer version 2.12.
+/// DKBTrace was originally written by David K. Buck.
+/// DKBTrace Ver 2.0-2.12 were written by David K. Buck & Aaron A. Collins.
+///
+/// @endparblock
+///
+//******************************************************************************
+
+// Unit header file must be the first file included within POV-Ray *.cpp files (pulls in config)
+#include "backend/render/rendernodetask.h"
+
+// C++ variants of C standard header files
+//  (none at the moment)
+
+// C++ standard header files
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+// Boost header files
+#include <boost/bind.hpp>
+
+// POV-Ray header files (base module)
+#include "base/fileinputoutput.h"
+#include "base/path.h"
+#include "base/stringutilities.h"
+#include "base/timer.h"
+
+// POV-Ray header files (POVMS module)
+#include "povms/povmsid.h"
+
+// POV-Ray header files (backend module)
+#include "backend/control/messagefactory.h"
+#include "backend/scene/backendscenedata.h"
+#include "backend/scene/view.h"
+#include "backend/scene/viewthreaddata.h"
+
+// this must be the last file included
+#include "base/povdebug.h"
+
+namespace pov
+{
+
+using std::vector;
+
+/// Size of the chunks in which file content is sent.
+static const size_t kFileChunkSize = 65536;
+
+/// Interval at which to check back with the task queue while waiting for the node.
+static const unsigned int kPollInterval = 100;
+
+/// Number of blocks to queue on the node for each of its render threads.
+static const unsigned int kBlocksPerThread = 2;
+
+RenderNodeTask::RenderNodeTask(ViewData *vd, const std::string& address, POVMS_Object& options, size_t seed) :
+    RenderTask(vd, seed, "RenderNode"),
+    nodeAddress(address),
+    nodeToken(options.TryGetString(kPOVAttrib_RenderNodeToken, "")),
+    nodeOptions(new POVMS_Object(options)),
+    nodeTimeout(std::max(options.TryGetInt(kPOVAttrib_RenderNodeTimeout, int(kDefaultRenderNodeTimeout)), 1))
+{
+    // message routing is local to the coordinator
+    if (nodeOptions->Exist(kPOVMSSourceAddressID))
+        nodeOptions->Remove(kPOVMSSourceAddressID);
+    if (nodeOptions->Exist(kPOVMSDestinationAddressID))
+        nodeOptions->Remove(kPOVMSDestinationAddressID);
+    // the token is only for the handshake
+    if (nodeOptions->Exist(kPOVAttrib_RenderNodeToken))
+        nodeOptions->Remove(kPOVAttrib_RenderNodeToken);
+
+    // make sure the node's pixels match those rendered locally (except for radiosity and photons, which each node computes itself)
+    nodeOptions->SetInt(kPOVAttrib_StochasticSeed, POVMSInt(seed));
+}
+
+RenderNodeTask::~RenderNodeTask()
+{
+}
+
+void RenderNodeTask::Run()
+{
+    BlockMap blocks;
+
+    try
+    {
+        connection.Connect(nodeAddress, nodeToken, boost::bind(&RenderNodeTask::Cooperate, this));
+        SendJob();
+
+        unsigned int threads = WaitForNode();
+
+        while (threads > 0)
+        {
+            // keep the node busy, with a few blocks queued in addition to those being rendered
+            while (blocks.size() < threads * kBlocksPerThread)
+            {
+                POVRect rect;
+                unsigned int serial;
+                if (!GetViewData()->GetNextRemoteRectangle(rect, serial))
+                    break;
+                blocks[serial] = rect;
+                SendBlock(rect, serial);
+            }
+
+            if (blocks.empty())
+                break;
+
+            // give up on a node that takes too long, so that its blocks can be rendered elsewhere
+            Timer waitTimer;
+            while (!connection.WaitForData(kPollInterval))
+            {
+                Cooperate();
+                if (waitTimer.ElapsedRealTime() > POV_LONG(nodeTimeout) * 1000)
+                    throw POV_EXCEPTION(kNetworkConnectionErr, "No block received for " + std::to_string(nodeTimeout) + " seconds");
+            }
+
+            ReceivePixels(blocks);
+        }
+
+        SendDone();
+    }
+    catch (pov_base::Exception& e)
+    {
+        mpMessageFactory->Warning(kWarningGeneral, "Render node '%s' failed: %s", nodeAddress.c_str(), e.what());
+        AbandonBlocks(blocks);
+    }
+    catch (...)
+    {
+        AbandonBlocks(blocks);
+        connection.Shutdown();
+        throw;
+    }
+
+    connection.Shutdown();
+}
+
+void RenderNodeTask::Stopped()
+{
+    // nothing to do
+}
+
+void RenderNodeTask::Finish()
+{
+    GetViewDataPtr()->timeType = TraceThreadData::kRenderTime;
+    GetViewDataPtr()->realTime = ConsumedRealTime();
+    GetViewDataPtr()->cpuTime = ConsumedCPUTime();
+}
+
+void RenderNodeTask::SendJob()
+{
+    typedef std::shared_ptr<IStream> IStreamPtr;
+
+    const BackendSceneData::FilenameToFilenameMap& readFiles = GetSceneData()->readFiles;
+    vector<IStreamPtr> streams;
+    vector<POV_OFF_T> sizes;
+    POVMS_List files;
+
+    for (BackendSceneData::FilenameToFilenameMap::const_iterator i(readFiles.begin()); i != readFiles.end(); i++)
+    {
+        IStreamPtr stream(NewIStream(Path(i->second), POV_File_Unknown));
+        if ((stream == nullptr) || !stream->seekg(0, IStream::seek_end))
+            throw POV_EXCEPTION(kCannotOpenFileErr, "Cannot read '" + UCS2toSysString(i->second) + "'");
+        POV_OFF_T size = stream->tellg();
+        stream->seekg(0);
+
+        POVMS_Object file(kPOVObjectClass_FileData);
+        file.SetUCS2String(kPOVAttrib_ReadFile, i->first.c_str());
+        file.SetLong(kPOVAttrib_RenderNodeFileSize, size);
+        files.Append(file);
+
+        streams.push_back(stream);
+        sizes.push_back(size);
+    }
+
+    POVMS_Message job(kPOVObjectClass_ControlData, kPOVMsgClass_RenderNode, kPOVMsgIdent_RenderJob);
+    job.Set(kPOVAttrib_RenderNodeOptions, *nodeOptions);
+    job.Set(kPOVAttrib_RenderNodeFiles, files);
+    connection.Send(job);
+
+    vector<char> buffer(kFileChunkSize);
+    for (size_t i = 0; i < streams.size(); i++)
+    {
+        for (POV_OFF_T remaining = sizes[i]; remaining > 0; )
+        {
+            size_t chunk = size_t(std::min<POV_OFF_T>(remaining, kFileChunkSize));
+            if (!streams[i]->read(buffer.data(), chunk))
+                throw POV_EXCEPTION(kFileDataErr, "Cannot read '" + UCS2toSysString(streams[i]->Name()) + "'");
+            connection.SendData(buffer.data(), chunk);
+            remaining -= chunk;
+            Cooperate();
+        }
+    }
+}
+
+unsigned int RenderNodeTask::WaitForNode()
+{
+    // the node has to parse the scene first, by which time there may be nothing left to do
+    while (!connection.WaitForData(kPollInterval))
+    {
+        Cooperate();
+        if (!GetViewData()->HasRemainingRectangles())
+            return 0;
+    }
+
+    POVMS_Message msg;
+    connection.Receive(msg);
+    if (msg.GetIdentifier() == kPOVMsgIdent_Failed)
+        throw POV_EXCEPTION(kNetworkDataErr, msg.TryGetString(kPOVAttrib_EnglishText, "unknown error"));
+    if (msg.GetIdentifier() != kPOVMsgIdent_Done)
+        throw POV_EXCEPTION(kNetworkDataErr, "Unexpected message");
+
+    return std::max(msg.TryGetInt(kPOVAttrib_MaxRenderThreads, 1), 1);
+}
+
+void RenderNodeTask::SendBlock(const POVRect& rect, unsigned int serial)
+{
+    POVMS_Message msg(kPOVObjectClass_ControlData, kPOVMsgClass_RenderNode, kPOVMsgIdent_RenderBlock);
+    msg.SetInt(kPOVAttrib_PixelId, serial);
+    msg.SetInt(kPOVAttrib_Left, rect.left);
+    msg.SetInt(kPOVAttrib_Top, rect.top);
+    msg.SetInt(kPOVAttrib_Right, rect.right);
+    msg.SetInt(kPOVAttrib_Bottom, rect.bottom);
+    connection.Send(msg);
+}
+
+void RenderNodeTask::ReceivePixels(BlockMap& blocks)
+{
+    POVMS_Message msg;
+    connection.Receive(msg);
+    if (msg.GetIdentifier() != kPOVMsgIdent_PixelBlockSet)
+        throw POV_EXCEPTION(kNetworkDataErr, "Unexpected message");
+
+    POVRect rect(msg.GetInt(kPOVAttrib_Left), msg.GetInt(kPOVAttrib_Top), msg.GetInt(kPOVAttrib_Right), msg.GetInt(kPOVAttrib_Bottom));
+    BlockMap::iterator block(blocks.find(msg.GetInt(kPOVAttrib_RenderNodeBlock)));
+    if (block == blocks.end())
+        throw POV_EXCEPTION(kNetworkDataErr, "Received pixels of a block not assigned to the node");
+    if ((block->second.left != rect.left) || (block->second.top != rect.top) ||
+        (block->second.right != rect.right) || (block->second.bottom != rect.bottom))
+        throw POV_EXCEPTION(kNetworkDataErr, "Received pixels do not match the block assigned to the node");
+
+    vector<POVMSFloat> pixelvector(msg.GetFloatVector(kPOVAttrib_PixelBlock));
+    if (pixelvector.size() != rect.GetArea() * 5)
+        throw POV_EXCEPTION(kNetworkDataErr, "Received pixel block of wrong size");
+
+    vector<RGBTColour> pixels;
+    pixels.reserve(rect.GetArea());
+    for (vector<POVMSFloat>::const_iterator i(pixelvector.begin()); i != pixelvector.end(); i += 5)
+        pixels.push_back(RGBTColour(i[0], i[1], i[2], i[4]));
+
+    vector<POVMSFloat> auxiliary;
+    if (msg.Exist(kPOVAttrib_PixelAuxiliary))
+        auxiliary = msg.GetFloatVector(kPOVAttrib_PixelAuxiliary);
+
+    vector<POVMSFloat> cost;
+    if (msg.Exist(kPOVAttrib_PixelCost))
+        cost = msg.GetFloatVector(kPOVAttrib_PixelCost);
+
+    GetViewData()->CompletedRemoteRectangle(rect, block->first, pixels, auxiliary, cost, msg.TryGetInt(kPOVAttrib_PixelSize, 1),
+                                            msg.Exist(kPOVAttrib_PixelFinal), msg.Exist(kPOVAttrib_PixelId));
+    blocks.erase(block);
+}
+
+void RenderNodeTask::SendDone()
+{
+    POVMS_Message msg(kPOVObjectClass_ControlData, kPOVMsgClass_RenderNode, kPOVMsgIdent_Done);
+    connection.Send(msg);
+}
+
+void RenderNodeTask::AbandonBlocks(BlockMap& blocks)
+{
+    for (BlockMap::const_iterator i(blocks.begin()); i != blocks.end(); i++)
+        GetViewData()->AbandonRemoteRectangle(i->second, i->first);
+    blocks.clear();
+}
+
+}
+// end of namespace pov
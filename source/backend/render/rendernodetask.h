@@ -0,0 +1,108 @@
+//******************************************************************************
+///
+/// @file backend/render/rendernodetask.h
+///
+/// Declarations related to the task driving a render node.
+///
+/// @copyright
+/// @parblock
+///
+/// Persistence of Vision Ray Tracer ('POV-Ray') version 3.8.
+/// Copyright 1991-2019 Persistence of Vision Raytracer Pty. Ltd.
+///
+/// POV-Ray is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU Affero General Public License as
+/// published by the Free Software Foundation, either version 3 of the
+/// License, or (at your option) any later version.
+///
+/// POV-Ray is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU Affero General Public License for more details.
+///
+/// You should have received a copy of the GNU Affero General Public License
+/// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+///
+/// ----------------------------------------------------------------------------
+///
+/// POV-Ray is based on the popular DKB raytracer version 2.12.
+/// DKBTrace was originally written by David K. Buck.
+/// DKBTrace Ver 2.0-2.12 were written by David K. Buck & Aaron A. Collins.
+///
+/// @endparblock
+///
+//******************************************************************************
+
+#ifndef POVRAY_BACKEND_RENDERNODETASK_H
+#define POVRAY_BACKEND_RENDERNODETASK_H
+
+// Module config header file must be the first file included within POV-Ray unit header files
+#include "backend/configbackend.h"
+
+// C++ variants of C standard header files
+//  (none at the moment)
+
+// C++ standard header files
+#include <map>
+#include <memory>
+#include <string>
+
+// POV-Ray header files (base module)
+#include "base/types.h"
+
+// POV-Ray header files (POVMS module)
+#include "povms/povmscpp.h"
+
+// POV-Ray header files (backend module)
+#include "backend/control/rendernode.h"
+#include "backend/render/rendertask.h"
+
+namespace pov
+{
+
+/// Task rendering blocks of the final pass on a render node.
+///
+/// The task hands the node its job, then keeps it supplied with blocks taken
+/// from the @ref ViewData, passing the pixels received in return on to the
+/// frontend. Should the node fail, or fail to deliver a block in time, the
+/// blocks it holds are handed back to the @ref ViewData to be rendered elsewhere.
+///
+class RenderNodeTask final : public RenderTask
+{
+    public:
+        /// @param  vd          View data of the render.
+        /// @param  address     Address of the node, in the form `host[:port]`.
+        /// @param  options     Render options of the coordinator.
+        /// @param  seed        Stochastic seed used by the coordinator.
+        RenderNodeTask(ViewData *vd, const std::string& address, POVMS_Object& options, size_t seed);
+        virtual ~RenderNodeTask() override;
+
+        virtual void Run() override;
+        virtual void Stopped() override;
+        virtual void Finish() override;
+    private:
+        typedef std::map<unsigned int, POVRect> BlockMap;
+
+        /// address of the node
+        std::string nodeAddress;
+        /// token to present to the node
+        std::string nodeToken;
+        /// options to send to the node
+        std::unique_ptr<POVMS_Object> nodeOptions;
+        /// connection to the node
+        RenderNodeConnection connection;
+        /// time in seconds to wait for the node to deliver a block
+        unsigned int nodeTimeout;
+
+        void SendJob();
+        unsigned int WaitForNode();
+        void SendBlock(const POVRect& rect, unsigned int serial);
+        void ReceivePixels(BlockMap& blocks);
+        void SendDone();
+        void AbandonBlocks(BlockMap& blocks);
+};
+
+}
+// end of namespace pov
+
+#endif // POVRAY_BACKEND_RENDERNODETASK_H
@@ -86,6 +86,12 @@ ViewData *RenderTask::GetViewData()
     return viewData;
 }
 
+void RenderTask::SampleCPUTime()
+{
+    if (viewData->GetCPUTimeSampling())
+        GetViewDataPtr()->cpuTimeSample.store(ThreadCPUTimeMicroseconds(), std::memory_order_relaxed);
+}
+
 void RenderTask::SendFatalError(Exception& e)
 {
     // if the front-end has been told about this exception already, we don't tell it again
@@ -69,6 +69,9 @@ class RenderTask : public SceneTask
         ViewData *GetViewData();
 
         inline ViewThreadData *GetViewDataPtr() { return reinterpret_cast<ViewThreadData *>(GetDataPtr()); }
+
+        /// Sample the CPU time consumed by the thread so far, if required for the live render metrics.
+        void SampleCPUTime();
     private:
         /// view data
         ViewData *viewData;
@@ -41,6 +41,7 @@
 
 // C++ standard header files
 #include <algorithm>
+#include <chrono>
 #include <limits>
 
 // POV-Ray header files (base module)
@@ -64,6 +65,7 @@
 #include "backend/scene/backendscenedata.h"
 #include "backend/scene/view.h"
 #include "backend/scene/viewthreaddata.h"
+#include "backend/support/timeline.h"
 
 // this must be the last file included
 #include "base/povdebug.h"
@@ -233,7 +235,7 @@ void TraceTask::SubdivisionBuffer::Clear()
 }
 
 TraceTask::TraceTask(ViewData *vd, unsigned int tm, DBL js,
-                     DBL aat, DBL aac, unsigned int aad, pov_base::GammaCurvePtr& aag,
+                     DBL aat, DBL aac, unsigned int aad, pov_base::GammaCurvePtr& aag, POV_LONG aatb, bool prog,
                      unsigned int ps, bool psc, bool contributesToImage, bool hr, size_t seed) :
     RenderTask(vd, seed, "Trace"),
     trace(vd->GetSceneData(), &vd->GetCamera(), GetViewDataPtr(), vd->GetSceneData()->parsedMaxTraceLevel, vd->GetSceneData()->parsedAdcBailout,
@@ -244,12 +246,15 @@ TraceTask::TraceTask(ViewData *vd, unsigned int tm, DBL js,
     aaThreshold(aat),
     aaConfidence(aac),
     aaDepth(aad),
+    aaTimeBudget(aatb),
+    progressive(prog),
     aaGamma(aag),
     previewSize(ps),
     previewSkipCorner(psc),
     passContributesToImage(contributesToImage),
     passCompletesImage((ps == 0) || ((ps == 1) && contributesToImage)),
     highReproducibility(hr),
+    pixelCost(vd->GetPixelCost() && contributesToImage),
     media(GetViewDataPtr(), &trace, &photonGatherer),
     radiosity(vd->GetSceneData(), GetViewDataPtr(),
               vd->GetSceneData()->radiositySettings, vd->GetRadiosityCache(), cooperate, true, vd->GetCamera().Location),
@@ -308,6 +313,9 @@ void TraceTask::Run()
             case 3:
                 StochasticSupersamplingM3();
                 break;
+            case 4:
+                AdaptiveVarianceSamplingM4();
+                break;
         }
 
 #ifdef RTR_HACK
@@ -408,7 +416,11 @@ void TraceTask::SimpleSamplingM0()
 
     while(GetViewData()->GetNextRectangle(rect, serial) == true)
     {
+        Timeline::Scope timelineScope(GetTimeline().get(), "block", "Block", int(serial));
+        SampleCPUTime();
+
         radiosity.BeforeTile(highReproducibility? serial : 0);
+        BeginPixelCost(rect);
 
         pixels.clear();
         pixels.reserve(rect.GetArea());
@@ -435,7 +447,7 @@ void TraceTask::SimpleSamplingM0()
 #endif
                 RGBTColour col;
 
-                trace(x+0.5, y+0.5, GetViewData()->GetWidth(), GetViewData()->GetHeight(), col);
+                TraceSample(x+0.5, y+0.5, col);
                 GetViewDataPtr()->Stats()[Number_Of_Pixels]++;
 
                 pixels.push_back(col);
@@ -447,7 +459,7 @@ void TraceTask::SimpleSamplingM0()
         radiosity.AfterTile();
 
         GetViewDataPtr()->AfterTile();
-        GetViewData()->CompletedRectangle(rect, serial, pixels, 1, passContributesToImage, passCompletesImage);
+        GetViewData()->CompletedRectangle(rect, serial, pixels, vector<POVMSFloat>(), TraceAuxiliaryData(rect), cost, 1, passContributesToImage, passCompletesImage);
 
         Cooperate();
     }
@@ -463,6 +475,9 @@ void TraceTask::SimpleSamplingM0P()
 
     while(GetViewData()->GetNextRectangle(rect, serial) == true)
     {
+        Timeline::Scope timelineScope(GetTimeline().get(), "block", "Block", int(serial));
+        SampleCPUTime();
+
         radiosity.BeforeTile(highReproducibility? serial : 0);
 
         unsigned int px = (rect.GetWidth() + previewSize - 1) / previewSize;
@@ -498,7 +513,7 @@ void TraceTask::SimpleSamplingM0P()
 #endif
                 RGBTColour col;
 
-                trace(x+0.5, y+0.5, GetViewData()->GetWidth(), GetViewData()->GetHeight(), col);
+                TraceSample(x+0.5, y+0.5, col);
                 GetViewDataPtr()->Stats()[Number_Of_Pixels]++;
 
                 pixelpositions.push_back(Vector2d(x, y));
@@ -511,8 +526,10 @@ void TraceTask::SimpleSamplingM0P()
         radiosity.AfterTile();
 
         GetViewDataPtr()->AfterTile();
+        // the last mosaic preview pass may be the final pass, which then needs to provide the auxiliary data
         if(pixelpositions.size() > 0)
-            GetViewData()->CompletedRectangle(rect, serial, pixelpositions, pixelcolors, previewSize, passContributesToImage, passCompletesImage);
+            GetViewData()->CompletedRectangle(rect, serial, pixelpositions, pixelcolors, (passCompletesImage ? TraceAuxiliaryData(rect) : vector<POVMSFloat>()),
+                                              previewSize, passContributesToImage, passCompletesImage);
 
         Cooperate();
     }
@@ -527,14 +544,18 @@ void TraceTask::NonAdaptiveSupersamplingM1()
 
     while(GetViewData()->GetNextRectangle(rect, serial) == true)
     {
+        Timeline::Scope timelineScope(GetTimeline().get(), "block", "Block", int(serial));
+        SampleCPUTime();
+
         radiosity.BeforeTile(highReproducibility? serial : 0);
+        BeginPixelCost(rect);
 
         SmartBlock pixels(rect.left, rect.top, rect.GetWidth(), rect.GetHeight());
 
         // sample line above current block
         for(int x = rect.left; x <= rect.right; x++)
         {
-            trace(x+0.5, rect.top-0.5, GetViewData()->GetWidth(), GetViewData()->GetHeight(), pixels(x, rect.top - 1));
+            TraceSample(x+0.5, rect.top-0.5, pixels(x, rect.top - 1));
             GetViewDataPtr()->Stats()[Number_Of_Pixels]++;
 
             // Cannot supersample this pixel, so just claim it was already supersampled! [trf]
@@ -546,7 +567,7 @@ void TraceTask::NonAdaptiveSupersamplingM1()
 
         for(int y = rect.top; y <= rect.bottom; y++)
         {
-            trace(rect.left-0.5, y+0.5, GetViewData()->GetWidth(), GetViewData()->GetHeight(), pixels(rect.left - 1, y)); // sample pixel left of current line in block
+            TraceSample(rect.left-0.5, y+0.5, pixels(rect.left - 1, y)); // sample pixel left of current line in block
             GetViewDataPtr()->Stats()[Number_Of_Pixels]++;
 
             // Cannot supersample this pixel, so just claim it was already supersampled! [trf]
@@ -570,7 +591,7 @@ void TraceTask::NonAdaptiveSupersamplingM1()
             for(int x = rect.left; x <= rect.right; x++)
             {
                 // trace current pixel
-                trace(x+0.5, y+0.5, GetViewData()->GetWidth(), GetViewData()->GetHeight(), pixels(x, y));
+                TraceSample(x+0.5, y+0.5, pixels(x, y));
                 GetViewDataPtr()->Stats()[Number_Of_Pixels]++;
 
                 Cooperate();
@@ -595,7 +616,7 @@ void TraceTask::NonAdaptiveSupersamplingM1()
         radiosity.AfterTile();
 
         GetViewDataPtr()->AfterTile();
-        GetViewData()->CompletedRectangle(rect, serial, pixels.GetPixels(), 1, passContributesToImage, passCompletesImage);
+        GetViewData()->CompletedRectangle(rect, serial, pixels.GetPixels(), vector<POVMSFloat>(), TraceAuxiliaryData(rect), cost, 1, passContributesToImage, passCompletesImage);
 
         Cooperate();
     }
@@ -612,7 +633,11 @@ void TraceTask::AdaptiveSupersamplingM2()
 
     while(GetViewData()->GetNextRectangle(rect, serial) == true)
     {
+        Timeline::Scope timelineScope(GetTimeline().get(), "block", "Block", int(serial));
+        SampleCPUTime();
+
         radiosity.BeforeTile(highReproducibility? serial : 0);
+        BeginPixelCost(rect);
 
         SmartBlock pixels(rect.left, rect.top, rect.GetWidth(), rect.GetHeight());
 
@@ -621,7 +646,7 @@ void TraceTask::AdaptiveSupersamplingM2()
             for(int x = rect.left; x <= rect.right + 1; x++)
             {
                 // trace upper-left corners of all pixels
-                trace(x, y, GetViewData()->GetWidth(), GetViewData()->GetHeight(), pixels(x, y));
+                TraceSample(x, y, pixels(x, y));
                 GetViewDataPtr()->Stats()[Number_Of_Pixels]++;
 
                 Cooperate();
@@ -650,7 +675,7 @@ void TraceTask::AdaptiveSupersamplingM2()
         radiosity.AfterTile();
 
         GetViewDataPtr()->AfterTile();
-        GetViewData()->CompletedRectangle(rect, serial, pixels.GetPixels(), 1, passContributesToImage, passCompletesImage);
+        GetViewData()->CompletedRectangle(rect, serial, pixels.GetPixels(), vector<POVMSFloat>(), TraceAuxiliaryData(rect), cost, 1, passContributesToImage, passCompletesImage);
 
         Cooperate();
     }
@@ -684,9 +709,13 @@ void TraceTask::StochasticSupersamplingM3()
 
     while(GetViewData()->GetNextRectangle(rect, serial) == true)
     {
+        Timeline::Scope timelineScope(GetTimeline().get(), "block", "Block", int(serial));
+        SampleCPUTime();
+
         GetViewDataPtr()->stochasticRandomGenerator->Seed(GetViewDataPtr()->stochasticRandomSeedBase + serial);
 
         radiosity.BeforeTile(highReproducibility? serial : 0);
+        BeginPixelCost(rect);
 
         pixels.clear();
         pixelsSum.clear();
@@ -771,7 +800,7 @@ void TraceTask::StochasticSupersamplingM3()
                         PreciseRGBTColour col, colSqr;
 
                         Vector2d jitter = Uniform2dOnSquare(GetViewDataPtr()->stochasticRandomGenerator) - 0.5;
-                        trace(x+0.5 + jitter.x(), y+0.5 + jitter.y(), GetViewData()->GetWidth(), GetViewData()->GetHeight(), colTemp);
+                        TraceSample(x+0.5 + jitter.x(), y+0.5 + jitter.y(), colTemp);
 
                         col = PreciseRGBTColour(GammaCurve::Encode(aaGamma, colTemp));
                         colSqr = Sqr(col);
@@ -829,7 +858,150 @@ void TraceTask::StochasticSupersamplingM3()
         radiosity.AfterTile();
 
         GetViewDataPtr()->AfterTile();
-        GetViewData()->CompletedRectangle(rect, serial, pixels, 1, passContributesToImage, passCompletesImage);
+        GetViewData()->CompletedRectangle(rect, serial, pixels, vector<POVMSFloat>(), TraceAuxiliaryData(rect), cost, 1, passContributesToImage, passCompletesImage);
+
+        Cooperate();
+    }
+}
+
+void TraceTask::AdaptiveVarianceSamplingM4()
+{
+    POVRect rect;
+    vector<RGBTColour> pixels;
+    vector<POVMSFloat> convergence;
+    unsigned int serial;
+    ViewData::BlockInfo* pInfo;
+
+    // We need at least a few samples per pixel to get a meaningful variance estimate;
+    // in progressive mode however we want a complete frame as quickly as possible.
+    unsigned int maxSamples = 1u << (aaDepth*2);
+    unsigned int minSamples = (progressive ? 1u : min(4u, maxSamples));
+
+    // Create list of thresholds for confidence test (see StochasticSupersamplingM3()).
+    vector<double> confidenceFactor;
+    confidenceFactor.reserve(maxSamples);
+    for(unsigned int n = 1; n <= maxSamples; n++)
+        confidenceFactor.push_back(ndtri((1+aaConfidence)/2) / sqrt((double)n));
+
+    while(GetViewData()->GetNextRectangle(rect, serial, pInfo, 0) == true)
+    {
+        Timeline::Scope timelineScope(GetTimeline().get(), "block", "Block", int(serial));
+        SampleCPUTime();
+
+        AdaptiveSamplingBlockInfo* pBlockInfo = dynamic_cast<AdaptiveSamplingBlockInfo*>(pInfo);
+        if (!pBlockInfo)
+        {
+            if (pInfo)
+            {
+                delete pInfo;
+                pInfo = nullptr;
+            }
+            pBlockInfo = new AdaptiveSamplingBlockInfo(rect.GetArea());
+        }
+
+        // make sure our jitter is different (but reproducible) for each pass and tile
+        GetViewDataPtr()->stochasticRandomGenerator->Seed((GetViewDataPtr()->stochasticRandomSeedBase + serial) * 31 + pBlockInfo->pass);
+
+        radiosity.BeforeTile(highReproducibility? serial : 0);
+        BeginPixelCost(rect);
+
+        unsigned int index = 0;
+        if (pBlockInfo->pass == 0)
+        {
+            // First pass: Give every pixel the minimum number of samples.
+            for(unsigned int y = rect.top; y <= rect.bottom; y++)
+            {
+                for(unsigned int x = rect.left; x <= rect.right; x++)
+                {
+                    AdaptiveSampleOnePixel(x, y, index, minSamples, *pBlockInfo);
+                    GetViewDataPtr()->Stats()[Number_Of_Pixels]++;
+                    GetViewDataPtr()->Stats()[Number_Of_Samples] += minSamples - 1;
+                    index ++;
+                }
+            }
+        }
+        else if ((aaTimeBudget == 0) || (GetViewData()->ElapsedFrameTime() < aaTimeBudget))
+        {
+            // Refinement pass: Allocate additional samples to any pixel not yet converged, in proportion to
+            // its noise relative to the noisiest block of the whole frame. In progressive mode, the number
+            // of samples of the noisiest pixels doubles with each pass.
+            DBL frameNoise = max(DBL(GetViewData()->GetMaxBlockNoise()), aaThreshold);
+            for(unsigned int y = rect.top; y <= rect.bottom; y++)
+            {
+                for(unsigned int x = rect.left; x <= rect.right; x++)
+                {
+                    unsigned int samples = pBlockInfo->samples[index];
+                    DBL noise = AdaptivePixelNoise(index, *pBlockInfo, confidenceFactor);
+                    if ((samples < maxSamples) && (noise > aaThreshold))
+                    {
+                        unsigned int count;
+                        if (samples < 2)
+                            // no noise estimate yet, so just get one
+                            count = 1;
+                        else
+                            count = clip((unsigned int)ceil((progressive ? samples : minSamples) * min(noise / frameNoise, 1.0)), 1u, maxSamples - samples);
+                        AdaptiveSampleOnePixel(x, y, index, count, *pBlockInfo);
+                        if (samples == minSamples)
+                            GetViewDataPtr()->Stats()[Number_Of_Pixels_Supersampled]++;
+                        GetViewDataPtr()->Stats()[Number_Of_Samples] += count;
+                    }
+                    index ++;
+                }
+            }
+        }
+
+        // Compute the current estimate for each pixel, and find out whether we're done with this block.
+        pixels.clear();
+        pixels.reserve(rect.GetArea());
+        convergence.clear();
+        convergence.reserve(rect.GetArea() * 3);
+        DBL blockNoise = 0.0;
+        bool done = true;
+        bool firstPass = (pBlockInfo->pass == 0);
+        for(index = 0; index < rect.GetArea(); index ++)
+        {
+            unsigned int samples = pBlockInfo->samples[index];
+            DBL noise = AdaptivePixelNoise(index, *pBlockInfo, confidenceFactor);
+            bool converged = (noise <= aaThreshold) || (samples >= maxSamples);
+            if (!converged)
+            {
+                done = false;
+                if (samples >= 2)
+                    blockNoise = max(blockNoise, noise);
+            }
+
+            pixels.push_back(pBlockInfo->pixels[index] / samples);
+            convergence.push_back(POVMSFloat(samples));
+            convergence.push_back(POVMSFloat(noise));
+            convergence.push_back(converged ? 1.0f : 0.0f);
+        }
+
+        if ((aaTimeBudget > 0) && (GetViewData()->ElapsedFrameTime() >= aaTimeBudget))
+            done = true;
+        GetViewData()->SetBlockNoise(serial, done ? 0.0f : float(blockNoise));
+
+        float progressWeight;
+        if (done)
+        {
+            // no more passes please
+            progressWeight = 1.0f - pBlockInfo->completion;
+            delete pBlockInfo;
+            pBlockInfo = nullptr;
+        }
+        else
+        {
+            // we can't tell how many passes will be needed, so just report some progress
+            progressWeight = (1.0f - pBlockInfo->completion) * 0.5f;
+            pBlockInfo->completion += progressWeight;
+            pBlockInfo->pass ++;
+        }
+
+        radiosity.AfterTile();
+
+        GetViewDataPtr()->AfterTile();
+        // auxiliary data doesn't change between passes, so it only needs to be sent once
+        GetViewData()->CompletedRectangle(rect, serial, pixels, convergence, (firstPass ? TraceAuxiliaryData(rect) : vector<POVMSFloat>()),
+                                          cost, 1, passContributesToImage, done && passCompletesImage, progressWeight, pBlockInfo);
 
         Cooperate();
     }
@@ -874,10 +1046,10 @@ void TraceTask::SupersampleOnePixel(DBL x, DBL y, RGBTColour& col)
             if (jitterScale > 0.0)
             {
                 Jitter2d(x + xx, y + yy, rx, ry);
-                trace(x+0.5 + xx + (rx * jitterScale), y+0.5 + yy + (ry * jitterScale), GetViewData()->GetWidth(), GetViewData()->GetHeight(), tempcol);
+                TraceSample(x+0.5 + xx + (rx * jitterScale), y+0.5 + yy + (ry * jitterScale), tempcol);
             }
             else
-                trace(x+0.5 + xx, y+0.5 + yy, GetViewData()->GetWidth(), GetViewData()->GetHeight(), tempcol);
+                TraceSample(x+0.5 + xx, y+0.5 + yy, tempcol);
 
             col += tempcol;
             GetViewDataPtr()->Stats()[Number_Of_Samples]++;
@@ -938,10 +1110,10 @@ void TraceTask::SubdivideOnePixel(DBL x, DBL y, DBL d, size_t bx, size_t by, siz
             if (jitterScale > 0.0)
             {
                 Jitter2d(x - d, y, rxcx0y1, rycx0y1);
-                trace(x+0.5 - d + (rxcx0y1 * jitterScale), y+0.5 + (rycx0y1 * jitterScale), GetViewData()->GetWidth(), GetViewData()->GetHeight(), col);
+                TraceSample(x+0.5 - d + (rxcx0y1 * jitterScale), y+0.5 + (rycx0y1 * jitterScale), col);
             }
             else
-                trace(x+0.5 - d, y+0.5, GetViewData()->GetWidth(), GetViewData()->GetHeight(), col);
+                TraceSample(x+0.5 - d, y+0.5, col);
 
             buffer.SetSample(bx, by + bstephalf, col);
 
@@ -958,10 +1130,10 @@ void TraceTask::SubdivideOnePixel(DBL x, DBL y, DBL d, size_t bx, size_t by, siz
             if (jitterScale > 0.0)
             {
                 Jitter2d(x, y - d, rxcx1y0, rycx1y0);
-                trace(x+0.5 + (rxcx1y0 * jitterScale), y+0.5 - d + (rycx1y0 * jitterScale), GetViewData()->GetWidth(), GetViewData()->GetHeight(), col);
+                TraceSample(x+0.5 + (rxcx1y0 * jitterScale), y+0.5 - d + (rycx1y0 * jitterScale), col);
             }
             else
-                trace(x+0.5, y+0.5 - d, GetViewData()->GetWidth(), GetViewData()->GetHeight(), col);
+                TraceSample(x+0.5, y+0.5 - d, col);
 
             buffer.SetSample(bx + bstephalf, by, col);
 
@@ -978,10 +1150,10 @@ void TraceTask::SubdivideOnePixel(DBL x, DBL y, DBL d, size_t bx, size_t by, siz
             if (jitterScale > 0.0)
             {
                 Jitter2d(x + d, y, rxcx2y1, rycx2y1);
-                trace(x+0.5 + d + (rxcx2y1 * jitterScale), y+0.5 + (rycx2y1 * jitterScale), GetViewData()->GetWidth(), GetViewData()->GetHeight(), col);
+                TraceSample(x+0.5 + d + (rxcx2y1 * jitterScale), y+0.5 + (rycx2y1 * jitterScale), col);
             }
             else
-                trace(x+0.5 + d, y+0.5, GetViewData()->GetWidth(), GetViewData()->GetHeight(), col);
+                TraceSample(x+0.5 + d, y+0.5, col);
 
             buffer.SetSample(bx + bstep, by + bstephalf, col);
 
@@ -998,10 +1170,10 @@ void TraceTask::SubdivideOnePixel(DBL x, DBL y, DBL d, size_t bx, size_t by, siz
             if (jitterScale > 0.0)
             {
                 Jitter2d(x, y + d, rxcx1y2, rycx1y2);
-                trace(x+0.5 + (rxcx1y2 * jitterScale), y+0.5 + d + (rycx1y2 * jitterScale), GetViewData()->GetWidth(), GetViewData()->GetHeight(), col);
+                TraceSample(x+0.5 + (rxcx1y2 * jitterScale), y+0.5 + d + (rycx1y2 * jitterScale), col);
             }
             else
-                trace(x+0.5, y+0.5 + d, GetViewData()->GetWidth(), GetViewData()->GetHeight(), col);
+                TraceSample(x+0.5, y+0.5 + d, col);
 
             buffer.SetSample(bx + bstephalf, by + bstep, col);
 
@@ -1018,10 +1190,10 @@ void TraceTask::SubdivideOnePixel(DBL x, DBL y, DBL d, size_t bx, size_t by, siz
             if (jitterScale > 0.0)
             {
                 Jitter2d(x, y, rxcx1y1, rycx1y1);
-                trace(x+0.5 + (rxcx1y1 * jitterScale), y+0.5 + (rycx1y1 * jitterScale), GetViewData()->GetWidth(), GetViewData()->GetHeight(), col);
+                TraceSample(x+0.5 + (rxcx1y1 * jitterScale), y+0.5 + (rycx1y1 * jitterScale), col);
             }
             else
-                trace(x+0.5, y+0.5, GetViewData()->GetWidth(), GetViewData()->GetHeight(), col);
+                TraceSample(x+0.5, y+0.5, col);
 
             buffer.SetSample(bx + bstephalf, by + bstephalf, col);
 
@@ -1073,5 +1245,104 @@ void TraceTask::SubdivideOnePixel(DBL x, DBL y, DBL d, size_t bx, size_t by, siz
     }
 }
 
+void TraceTask::TraceSample(DBL x, DBL y, RGBTColour& col)
+{
+    if (cost.empty())
+    {
+        trace(x, y, GetViewData()->GetWidth(), GetViewData()->GetHeight(), col);
+        return;
+    }
+
+    POV_ULONG rays = GetViewDataPtr()->Stats()[Number_Of_Rays];
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    trace(x, y, GetViewData()->GetWidth(), GetViewData()->GetHeight(), col);
+
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+    // samples taken outside the rectangle (e.g. to antialias along its edges)
+    // are accounted to the nearest pixel inside
+    int px = clip(int(floor(x)), int(costRect.left), int(costRect.right)) - int(costRect.left);
+    int py = clip(int(floor(y)), int(costRect.top), int(costRect.bottom)) - int(costRect.top);
+    size_t index = (size_t(py) * costRect.GetWidth() + size_t(px)) * 3;
+
+    cost[index]     += POVMSFloat(elapsed.count());
+    cost[index + 1] += POVMSFloat(GetViewDataPtr()->Stats()[Number_Of_Rays] - rays);
+    cost[index + 2] += 1.0f;
+}
+
+void TraceTask::BeginPixelCost(const POVRect& rect)
+{
+    costRect = rect;
+    cost.assign(pixelCost ? rect.GetArea() * 3 : 0, 0.0f);
+}
+
+vector<POVMSFloat> TraceTask::TraceAuxiliaryData(const POVRect& rect)
+{
+    vector<POVMSFloat> auxiliary;
+
+    if (!GetViewData()->GetAuxiliaryData() || !passContributesToImage)
+        return auxiliary;
+
+    auxiliary.reserve(rect.GetArea() * 7);
+    for(unsigned int y = rect.top; y <= rect.bottom; y++)
+    {
+        for(unsigned int x = rect.left; x <= rect.right; x++)
+        {
+            RGBColour albedo;
+            Vector3d normal;
+            DBL depth;
+
+            trace.TraceAuxiliary(x+0.5, y+0.5, GetViewData()->GetWidth(), GetViewData()->GetHeight(), albedo, normal, depth);
+
+            auxiliary.push_back(albedo.red());
+            auxiliary.push_back(albedo.green());
+            auxiliary.push_back(albedo.blue());
+            auxiliary.push_back(normal.x());
+            auxiliary.push_back(normal.y());
+            auxiliary.push_back(normal.z());
+            auxiliary.push_back(depth);
+
+            Cooperate();
+        }
+    }
+
+    return auxiliary;
+}
+
+void TraceTask::AdaptiveSampleOnePixel(unsigned int x, unsigned int y, size_t index, unsigned int count, AdaptiveSamplingBlockInfo& info)
+{
+    for(unsigned int i = 0; i < count; i++)
+    {
+        RGBTColour colTemp;
+        PreciseRGBTColour col;
+
+        Vector2d jitter = Uniform2dOnSquare(GetViewDataPtr()->stochasticRandomGenerator) - 0.5;
+        TraceSample(x+0.5 + jitter.x(), y+0.5 + jitter.y(), colTemp);
+
+        col = PreciseRGBTColour(GammaCurve::Encode(aaGamma, colTemp));
+
+        info.pixels[index] += colTemp;
+        info.sum[index] += col;
+        info.sumSqr[index] += Sqr(col);
+        info.samples[index] ++;
+
+        Cooperate();
+    }
+}
+
+DBL TraceTask::AdaptivePixelNoise(size_t index, const AdaptiveSamplingBlockInfo& info, const vector<double>& confidenceFactor) const
+{
+    unsigned int samples = info.samples[index];
+    if (samples < 2)
+        return std::numeric_limits<DBL>::max();
+
+    PreciseRGBTColour variance = (info.sumSqr[index] - Sqr(info.sum[index])/samples) / (samples-1);
+    // guard against rounding errors driving the variance negative
+    variance = variance.Clipped(0.0, std::numeric_limits<PreciseColourChannel>::max());
+    PreciseRGBTColour confidenceDelta = Sqrt(variance) * confidenceFactor[samples-1];
+    return confidenceDelta.red() + confidenceDelta.green() + confidenceDelta.blue() + confidenceDelta.transm();
+}
+
 }
 // end of namespace pov
@@ -55,6 +55,7 @@
 
 // POV-Ray header files (backend module)
 #include "backend/render/rendertask.h"
+#include "backend/scene/view.h"
 
 namespace pov
 {
@@ -71,7 +72,7 @@ class TraceTask final : public RenderTask
 {
     public:
         TraceTask(ViewData *vd, unsigned int tm, DBL js,
-                  DBL aat, DBL aac, unsigned int aad, pov_base::GammaCurvePtr& aag,
+                  DBL aat, DBL aac, unsigned int aad, pov_base::GammaCurvePtr& aag, POV_LONG aatb, bool prog,
                   unsigned int ps, bool psc, bool contributesToImage, bool hr, size_t seed);
         virtual ~TraceTask() override;
 
@@ -105,18 +106,39 @@ class TraceTask final : public RenderTask
                 size_t size;
         };
 
+        /// Per-block state retained between the passes of @ref AdaptiveVarianceSamplingM4().
+        class AdaptiveSamplingBlockInfo final : public ViewData::BlockInfo
+        {
+            public:
+                AdaptiveSamplingBlockInfo(size_t n) : pixels(n), sum(n), sumSqr(n), samples(n, 0), pass(0), completion(0.0f) {}
+                virtual ~AdaptiveSamplingBlockInfo() override {}
+
+                std::vector<RGBTColour> pixels;             ///< Sum of linear colour samples per pixel.
+                std::vector<PreciseRGBTColour> sum;         ///< Sum of gamma-encoded colour samples per pixel.
+                std::vector<PreciseRGBTColour> sumSqr;      ///< Sum of squared gamma-encoded colour samples per pixel.
+                std::vector<unsigned int> samples;          ///< Number of samples per pixel.
+                unsigned int pass;
+                float completion;
+        };
+
         unsigned int tracingMethod;
         DBL jitterScale;
         DBL aaThreshold;
         DBL aaConfidence;
         unsigned int aaDepth;
+        POV_LONG aaTimeBudget;          ///< Wall-clock time budget for adaptive refinement in milliseconds from the start of the frame, or 0 for none.
+        bool progressive;               ///< Start adaptive refinement from a single sample per pixel.
         unsigned int previewSize;
         bool previewSkipCorner;
         bool passContributesToImage;    ///< Pass computes pixels for the final image.
         bool passCompletesImage;        ///< Pass is the last one computing pixels for the final image.
         bool highReproducibility;
+        bool pixelCost;                 ///< Measure the render cost of each pixel.
         pov_base::GammaCurvePtr aaGamma;
 
+        POVRect costRect;               ///< Rectangle currently being measured.
+        std::vector<POVMSFloat> cost;   ///< Render time, rays and samples per pixel of @ref costRect, or empty if not measured.
+
         /// tracing core
         TracePixel trace;
 
@@ -130,10 +152,21 @@ class TraceTask final : public RenderTask
         void NonAdaptiveSupersamplingM1();
         void AdaptiveSupersamplingM2();
         void StochasticSupersamplingM3();
+        void AdaptiveVarianceSamplingM4();
 
         void NonAdaptiveSupersamplingForOnePixel(DBL x, DBL y, RGBTColour& leftcol, RGBTColour& topcol, RGBTColour& curcol, bool& sampleleft, bool& sampletop, bool& samplecurrent);
         void SupersampleOnePixel(DBL x, DBL y, RGBTColour& col);
         void SubdivideOnePixel(DBL x, DBL y, DBL d, size_t bx, size_t by, size_t bstep, SubdivisionBuffer& buffer, RGBTColour& result, int level);
+
+        /// Trace a single sample, accounting its cost to the pixel it falls into.
+        void TraceSample(DBL x, DBL y, RGBTColour& col);
+        /// Start measuring the cost of the pixels in a rectangle.
+        void BeginPixelCost(const POVRect& rect);
+
+        std::vector<POVMSFloat> TraceAuxiliaryData(const POVRect& rect);
+
+        void AdaptiveSampleOnePixel(unsigned int x, unsigned int y, size_t index, unsigned int count, AdaptiveSamplingBlockInfo& info);
+        DBL AdaptivePixelNoise(size_t index, const AdaptiveSamplingBlockInfo& info, const std::vector<double>& confidenceFactor) const;
 };
 
 }
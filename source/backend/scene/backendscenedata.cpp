@@ -56,7 +56,7 @@
 #include "povms/povmsid.h"
 
 // POV-Ray header files (backend module)
-//  (none at the moment)
+#include "backend/control/rendernode.h"
 
 // this must be the last file included
 #include "base/povdebug.h"
@@ -65,7 +65,8 @@ namespace pov
 {
 
 BackendSceneData::BackendSceneData() :
-    SceneData()
+    SceneData(),
+    readFileStatusComplete(true)
 {}
 
 UCS2String BackendSceneData::FindFile(POVMSContext ctx, const UCS2String& filename, unsigned int stype)
@@ -110,6 +111,17 @@ UCS2String BackendSceneData::FindFile(POVMSContext ctx, const UCS2String& filena
     if (!tryExactFirst)
         filenames.push_back(filename);
 
+    // when rendering on behalf of a coordinator, the scene may only use the files shipped with the job
+    if (renderNodeJob != nullptr)
+    {
+        for (std::vector<UCS2String>::const_iterator i(filenames.begin()); i != filenames.end(); i++)
+        {
+            if (!renderNodeJob->FindFile(*i).empty())
+                return *i;
+        }
+        return UCS2String();
+    }
+
 #ifdef USE_SCENE_FILE_MAPPING
     // see if the file is available locally
     for(std::vector<UCS2String>::const_iterator i(filenames.begin()); i != filenames.end(); i++)
@@ -142,7 +154,23 @@ IStream *BackendSceneData::ReadFile(POVMSContext ctx, const UCS2String& origname
     UCS2String localfile;
     UCS2String fileurl;
 
+    // when rendering on behalf of a coordinator, read the copy shipped with the job
+    if (renderNodeJob != nullptr)
+    {
+        // the copies are temporary, so there is no point in tracking their status
+        readFileStatusComplete = false;
+        localfile = renderNodeJob->FindFile(scenefile);
+        if (localfile.empty())
+            localfile = renderNodeJob->FindFile(origname);
+        if (localfile.empty())
+            return nullptr;
+        return NewIStream(localfile.c_str(), stype);
+    }
+
 #ifdef USE_SCENE_FILE_MAPPING
+    // the status of files read via the frontend is not tracked
+    readFileStatusComplete = false;
+
     // see if the file is available locally
     FilenameToFilenameMap::iterator ilocalfile(scene2LocalFiles.find(scenefile));
 
@@ -210,7 +238,19 @@ IStream *BackendSceneData::ReadFile(POVMSContext ctx, const UCS2String& origname
     // file not found
     return nullptr;
 #else
-    return NewIStream(filename.c_str(), stype);
+    IStream *file = NewIStream(filename.c_str(), stype);
+    if (file != nullptr)
+    {
+        // remember the file, in case the render is distributed to render nodes
+        readFiles[origname] = filename;
+        // remember its status, so that the frontend can tell whether the scene needs parsing again
+        Filesystem::FileStatus status;
+        if (Filesystem::GetFileStatus(filename, status))
+            readFileStatus[filename] = status;
+        else
+            readFileStatusComplete = false;
+    }
+    return file;
 #endif
 }
 
@@ -45,8 +45,10 @@
 
 // C++ standard header files
 #include <map>
+#include <memory>
 
 // POV-Ray header files (base module)
+#include "base/filesystem.h"
 #include "base/stringtypes.h"
 
 // POV-Ray header files (core module)
@@ -54,6 +56,8 @@
 
 // POV-Ray header files (backend module)
 #include "backend/control/renderbackend.h"
+#include "backend/control/rendernode_fwd.h"
+#include "backend/support/timeline_fwd.h"
 
 namespace pov
 {
@@ -73,10 +77,21 @@ class BackendSceneData final : public SceneData
         POVMSAddress backendAddress;
         /// frontend address
         POVMSAddress frontendAddress;
+        /// render node job the scene is rendered for, or `nullptr` if not running as a render node
+        std::shared_ptr<RenderNodeJob> renderNodeJob;
+        /// maps scene file names to the local files read while parsing, as shipped to render nodes
+        FilenameToFilenameMap readFiles;
+        /// status of the local files read while parsing, as of when they were opened
+        std::map<UCS2String, Filesystem::FileStatus> readFileStatus;
+        /// whether the status of all local files read while parsing is known
+        bool readFileStatusComplete;
+        /// timeline to record the activity of parsing and rendering to, or `nullptr` if not recording
+        std::shared_ptr<Timeline> timeline;
 
         /**
          *  Find a file for reading.
          *  If the file is not available locally, the frontend will be queried.
+         *  When running as a render node, only files shipped with the job are found.
          *  Variants of the filename with extensions matching file type will
          *  be tried. Only the first file found is returned.
          *  @param  ctx             POVMS message context for the current thread.
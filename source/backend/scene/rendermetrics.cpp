@@ -0,0 +1,283 @@
+//******************************************************************************
+///
+/// @file backend/scene/rendermetrics.cpp
+///
+/// Implementations related to live render metrics.
+///
+/// @copyright
+/// @parblock
+///
+/// Persistence of Vision Ray Tracer ('POV-Ray') version 3.8.
+/// Copyright 1991-2019 Persistence of Vision Raytracer Pty. Ltd.
+///
+/// POV-Ray is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU Affero General Public License as
+/// published by the Free Software Foundation, either version 3 of the
+/// License, or (at your option) any later version.
+///
+/// POV-Ray is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU Affero General Public License for more details.
+///
+/// You should have received a copy of the GNU Affero General Public License
+/// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+///
+/// ----------------------------------------------------------------------------
+///
+/// POV-Ray is based on the popular DKB raytracer version 2.12.
+/// DKBTrace was originally written by David K. Buck.
+/// DKBTrace Ver 2.0-2.12 were written by David K. Buck & Aaron A. Collins.
+///
+/// @endparblock
+///
+//******************************************************************************
+// Unit header file must be the first file included within POV-Ray *.cpp files (pulls in config)
+#include "backend/scene/rendermetrics.h"
+
+// C++ variants of C standard header files
+//  (none at the moment)
+
+// C++ standard header files
+#include <iomanip>
+#include <sstream>
+
+// POV-Ray header files (base module)
+#include "base/fileinputoutput.h"
+#include "base/filesystem.h"
+#include "base/path.h"
+#include "base/platformbase.h"
+#include "base/stringutilities.h"
+#include "base/timer.h"
+
+// POV-Ray header files (core module)
+#include "core/support/statistics.h"
+
+// POV-Ray header files (POVMS module)
+#include "povms/povmsid.h"
+
+// POV-Ray header files (backend module)
+#include "backend/scene/view.h"
+#include "backend/scene/viewthreaddata.h"
+
+// this must be the last file included
+#include "base/povdebug.h"
+
+namespace pov
+{
+
+struct RenderMetricsCounter final
+{
+    const char*     name;   ///< Name of the counter; for rays, the ray type.
+    IntStatsIndex   stat;   ///< Statistic to report.
+    bool            ray;    ///< Whether the counter is one of the ray types.
+};
+
+static const RenderMetricsCounter kRenderMetricsCounters[] = {
+    { "all",                Number_Of_Rays,                 true  },
+    { "reflected",          Reflected_Rays_Traced,          true  },
+    { "refracted",          Refracted_Rays_Traced,          true  },
+    { "transmitted",        Transmitted_Rays_Traced,        true  },
+    { "internal_reflected", Internal_Reflected_Rays_Traced, true  },
+    { "shadow",             Shadow_Ray_Tests,               true  },
+    { "radiosity",          Radiosity_RayCount,             true  },
+    { "photon",             Number_Of_Photons_Shot,         true  },
+    { "pixels_traced",      Number_Of_Pixels,               false },
+    { "samples",            Number_Of_Samples,              false },
+    { "shadow_cache_hits",  Shadow_Cache_Hits,              false },
+    { "radiosity_gathers",  Radiosity_GatherCount,          false },
+    { "radiosity_reuses",   Radiosity_ReuseCount,           false },
+};
+
+static const size_t kRenderMetricsCounterCount = sizeof(kRenderMetricsCounters) / sizeof(kRenderMetricsCounters[0]);
+
+/// Shortest interval between samples, in milliseconds.
+static const POV_LONG kRenderMetricsMinInterval = 100;
+
+RenderMetrics::RenderMetrics(const UCS2String& filename, int format, POV_LONG interval,
+                             const ViewData& viewData, const std::vector<ViewThreadData*>& threads) :
+    mFileName(filename),
+    mFormat(format),
+    mInterval(std::chrono::milliseconds(std::max(interval, kRenderMetricsMinInterval))),
+    mViewData(viewData),
+    mThreads(threads),
+    mStart(Clock::now())
+{
+    // JSON lines accumulate in a single file,
+    // while the Prometheus text is rewritten from scratch with each sample
+    if (mFormat == kPOVList_MetricsFormat_JSONLines)
+    {
+        mpFile.reset(NewOStream(Path(mFileName), POV_File_Data_LOG, true));
+        if (mpFile == nullptr)
+            throw POV_EXCEPTION(kCannotOpenFileErr, "Cannot create metrics file '" + UCS2toSysString(mFileName) + "'");
+    }
+
+    TakeSnapshot(mPrevious);
+}
+
+RenderMetrics::~RenderMetrics()
+{
+}
+
+bool RenderMetrics::Update()
+{
+    if (Clock::now() - mPrevious.time < mInterval)
+        return true;
+    return WriteSample();
+}
+
+bool RenderMetrics::WriteSample()
+{
+    Snapshot current;
+    TakeSnapshot(current);
+
+    bool success;
+    if (mFormat == kPOVList_MetricsFormat_JSONLines)
+    {
+        std::string text(FormatJSON(current));
+        success = mpFile->write(text.data(), text.size());
+        mpFile->flush();
+    }
+    else
+    {
+        std::string text(FormatPrometheus(current));
+        UCS2String tempName(mFileName + ASCIItoUCS2String(".tmp"));
+        std::unique_ptr<OStream> file(NewOStream(Path(tempName), POV_File_Data_LOG, false));
+        success = (file != nullptr) && file->write(text.data(), text.size());
+        file.reset();
+        success = success && Filesystem::RenameFile(tempName, mFileName);
+    }
+
+    mPrevious = current;
+    return success;
+}
+
+void RenderMetrics::TakeSnapshot(Snapshot& snapshot) const
+{
+    RenderStatistics stats;
+    for (auto thread : mThreads)
+        stats += thread->Stats();
+
+    snapshot.time = Clock::now();
+    snapshot.counters.resize(kRenderMetricsCounterCount);
+    for (size_t i = 0; i < kRenderMetricsCounterCount; ++i)
+        snapshot.counters[i] = stats[kRenderMetricsCounters[i].stat];
+    snapshot.cpuTimes.resize(mThreads.size());
+    for (size_t i = 0; i < mThreads.size(); ++i)
+        snapshot.cpuTimes[i] = mThreads[i]->cpuTimeSample.load(std::memory_order_relaxed);
+
+    snapshot.memoryKnown = PlatformBase::GetInstance().GetProcessMemoryUsage(snapshot.memory);
+    if (!snapshot.memoryKnown)
+        snapshot.memory = 0;
+    snapshot.memoryPeak = std::max(mPrevious.memoryPeak, snapshot.memory);
+}
+
+std::string RenderMetrics::FormatJSON(const Snapshot& current) const
+{
+    double interval = std::chrono::duration<double>(current.time - mPrevious.time).count();
+    double elapsed = std::chrono::duration<double>(current.time - mStart).count();
+    double timestamp = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "{\"timestamp\":" << timestamp << ",\"elapsed\":" << elapsed << ",\"view\":" << mViewData.GetViewId();
+    out << ",\"pixels_completed\":" << mViewData.GetPixelsCompleted()
+        << ",\"pixels_total\":" << mViewData.GetRenderArea().GetArea();
+
+    out << ",\"rays\":{";
+    bool first = true;
+    for (size_t i = 0; i < kRenderMetricsCounterCount; ++i)
+    {
+        if (!kRenderMetricsCounters[i].ray)
+            continue;
+        out << (first ? "" : ",") << "\"" << kRenderMetricsCounters[i].name << "\":{\"total\":" << current.counters[i]
+            << ",\"per_second\":" << (interval > 0.0 ? (current.counters[i] - mPrevious.counters[i]) / interval : 0.0) << "}";
+        first = false;
+    }
+    out << "}";
+
+    for (size_t i = 0; i < kRenderMetricsCounterCount; ++i)
+    {
+        if (!kRenderMetricsCounters[i].ray)
+            out << ",\"" << kRenderMetricsCounters[i].name << "\":" << current.counters[i];
+    }
+
+    if (current.memoryKnown)
+        out << ",\"memory\":{\"current\":" << current.memory << ",\"peak\":" << current.memoryPeak << "}";
+
+    out << ",\"thread_utilisation\":[";
+    for (size_t i = 0; i < current.cpuTimes.size(); ++i)
+    {
+        out << (i == 0 ? "" : ",");
+        if ((current.cpuTimes[i] >= 0) && (mPrevious.cpuTimes[i] >= 0) && (interval > 0.0))
+            out << (current.cpuTimes[i] - mPrevious.cpuTimes[i]) / (interval * 1.0e6);
+        else
+            out << "null";
+    }
+    out << "]}\n";
+
+    return out.str();
+}
+
+std::string RenderMetrics::FormatPrometheus(const Snapshot& current) const
+{
+    double interval = std::chrono::duration<double>(current.time - mPrevious.time).count();
+    double elapsed = std::chrono::duration<double>(current.time - mStart).count();
+    std::string view("view=\"" + std::to_string(mViewData.GetViewId()) + "\"");
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+
+    out << "# HELP povray_elapsed_seconds Time since the render started.\n"
+        << "# TYPE povray_elapsed_seconds gauge\n"
+        << "povray_elapsed_seconds{" << view << "} " << elapsed << "\n";
+    out << "# HELP povray_pixels_completed Pixels completed in the current pass.\n"
+        << "# TYPE povray_pixels_completed gauge\n"
+        << "povray_pixels_completed{" << view << "} " << mViewData.GetPixelsCompleted() << "\n";
+    out << "# HELP povray_pixels Pixels in the area to render.\n"
+        << "# TYPE povray_pixels gauge\n"
+        << "povray_pixels{" << view << "} " << mViewData.GetRenderArea().GetArea() << "\n";
+
+    out << "# HELP povray_rays_total Rays traced, by type.\n"
+        << "# TYPE povray_rays_total counter\n";
+    for (size_t i = 0; i < kRenderMetricsCounterCount; ++i)
+    {
+        if (kRenderMetricsCounters[i].ray)
+            out << "povray_rays_total{" << view << ",type=\"" << kRenderMetricsCounters[i].name << "\"} " << current.counters[i] << "\n";
+    }
+    out << "# HELP povray_rays_per_second Rays traced per second since the previous sample, by type.\n"
+        << "# TYPE povray_rays_per_second gauge\n";
+    for (size_t i = 0; i < kRenderMetricsCounterCount; ++i)
+    {
+        if (kRenderMetricsCounters[i].ray)
+            out << "povray_rays_per_second{" << view << ",type=\"" << kRenderMetricsCounters[i].name << "\"} "
+                << (interval > 0.0 ? (current.counters[i] - mPrevious.counters[i]) / interval : 0.0) << "\n";
+    }
+
+    for (size_t i = 0; i < kRenderMetricsCounterCount; ++i)
+    {
+        if (!kRenderMetricsCounters[i].ray)
+            out << "# TYPE povray_" << kRenderMetricsCounters[i].name << "_total counter\n"
+                << "povray_" << kRenderMetricsCounters[i].name << "_total{" << view << "} " << current.counters[i] << "\n";
+    }
+
+    if (current.memoryKnown)
+        out << "# HELP povray_memory_bytes Memory used by the POV-Ray process.\n"
+            << "# TYPE povray_memory_bytes gauge\n"
+            << "povray_memory_bytes{" << view << ",kind=\"current\"} " << current.memory << "\n"
+            << "povray_memory_bytes{" << view << ",kind=\"peak\"} " << current.memoryPeak << "\n";
+
+    out << "# HELP povray_thread_utilisation Share of the time since the previous sample each render thread spent on the CPU.\n"
+        << "# TYPE povray_thread_utilisation gauge\n";
+    for (size_t i = 0; i < current.cpuTimes.size(); ++i)
+    {
+        if ((current.cpuTimes[i] >= 0) && (mPrevious.cpuTimes[i] >= 0) && (interval > 0.0))
+            out << "povray_thread_utilisation{" << view << ",thread=\"" << i << "\"} "
+                << (current.cpuTimes[i] - mPrevious.cpuTimes[i]) / (interval * 1.0e6) << "\n";
+    }
+
+    return out.str();
+}
+
+}
+// end of namespace pov
@@ -0,0 +1,146 @@
+//******************************************************************************
+///
+/// @file backend/scene/rendermetrics.h
+///
+/// Declarations related to live render metrics.
+///
+/// @copyright
+/// @parblock
+///
+/// Persistence of Vision Ray Tracer ('POV-Ray') version 3.8.
+/// Copyright 1991-2019 Persistence of Vision Raytracer Pty. Ltd.
+///
+/// POV-Ray is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU Affero General Public License as
+/// published by the Free Software Foundation, either version 3 of the
+/// License, or (at your option) any later version.
+///
+/// POV-Ray is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU Affero General Public License for more details.
+///
+/// You should have received a copy of the GNU Affero General Public License
+/// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+///
+/// ----------------------------------------------------------------------------
+///
+/// POV-Ray is based on the popular DKB raytracer version 2.12.
+/// DKBTrace was originally written by David K. Buck.
+/// DKBTrace Ver 2.0-2.12 were written by David K. Buck & Aaron A. Collins.
+///
+/// @endparblock
+///
+//******************************************************************************
+#ifndef POVRAY_BACKEND_RENDERMETRICS_H
+#define POVRAY_BACKEND_RENDERMETRICS_H
+
+// Module config header file must be the first file included within POV-Ray unit header files
+#include "backend/configbackend.h"
+#include "backend/scene/rendermetrics_fwd.h"
+
+// C++ variants of C standard header files
+//  (none at the moment)
+
+// C++ standard header files
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+// POV-Ray header files (base module)
+#include "base/fileinputoutput_fwd.h"
+#include "base/stringtypes.h"
+#include "base/types.h"
+
+// POV-Ray header files (backend module)
+#include "backend/control/renderbackend.h"
+#include "backend/scene/view_fwd.h"
+#include "backend/scene/viewthreaddata_fwd.h"
+
+namespace pov
+{
+
+using namespace pov_base;
+
+/// Periodic snapshots of the progress of a render, for monitoring purposes.
+///
+/// Each sample holds the running totals of the render statistics (rays by type,
+/// pixels, shadow cache hits, radiosity reuse and so forth), the rates at which
+/// they have grown since the previous sample, memory usage where available, and
+/// the utilisation of each render thread.
+///
+/// Samples are written either as JSON lines appended to the output file, or in
+/// the Prometheus text exposition format, replacing the output file atomically
+/// with each sample (suitable for the node exporter's textfile collector).
+///
+/// The memory usage reported is that of the whole process (its resident set size
+/// on Unix, or working set on Windows), as far as the platform can determine it;
+/// the peak is the highest value sampled.
+///
+/// The statistics are read from the render threads' own counters, which are
+/// relaxed atomics for this purpose; the only work left to the render threads is
+/// to sample their CPU time once per block. All methods are to be called from the
+/// same thread.
+///
+class RenderMetrics final
+{
+    public:
+
+        /// Start collecting metrics.
+        ///
+        /// @param  filename    Name of the file to write to.
+        /// @param  format      Output format, as one of the `kPOVList_MetricsFormat_*` values.
+        /// @param  interval    Time between samples, in milliseconds.
+        /// @param  viewData    View whose progress to report.
+        /// @param  threads     Render threads whose statistics to report.
+        ///
+        /// @throws pov_base::Exception if the file cannot be created.
+        ///
+        RenderMetrics(const UCS2String& filename, int format, POV_LONG interval,
+                      const ViewData& viewData, const std::vector<ViewThreadData*>& threads);
+        ~RenderMetrics();
+
+        RenderMetrics(const RenderMetrics&) = delete;
+        RenderMetrics& operator=(const RenderMetrics&) = delete;
+
+        /// Write a sample if the interval has elapsed since the previous one.
+        /// @return     `false` if the sample could not be written.
+        bool Update();
+
+        /// Write a sample regardless of the interval.
+        /// @return     `false` if the sample could not be written.
+        bool WriteSample();
+
+    private:
+
+        typedef std::chrono::steady_clock Clock;
+
+        struct Snapshot final
+        {
+            Clock::time_point       time;
+            std::vector<POV_ULONG>  counters;
+            std::vector<POV_LONG>   cpuTimes;
+            bool                    memoryKnown = false;    ///< Whether the process memory usage could be determined.
+            POV_ULONG               memory = 0;             ///< Process memory usage, in bytes.
+            POV_ULONG               memoryPeak = 0;         ///< Highest process memory usage of any snapshot so far, in bytes.
+        };
+
+        UCS2String                      mFileName;
+        std::unique_ptr<OStream>        mpFile;
+        int                             mFormat;
+        Clock::duration                 mInterval;
+        const ViewData&                 mViewData;
+        std::vector<ViewThreadData*>    mThreads;
+        Clock::time_point               mStart;
+        Snapshot                        mPrevious;
+
+        void TakeSnapshot(Snapshot& snapshot) const;
+        std::string FormatJSON(const Snapshot& current) const;
+        std::string FormatPrometheus(const Snapshot& current) const;
+};
+
+}
+// end of namespace pov
+
+#endif // POVRAY_BACKEND_RENDERMETRICS_H
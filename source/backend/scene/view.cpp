@@ -48,8 +48,10 @@
 #include <boost/math/common_factor.hpp>
 
 // POV-Ray header files (base module)
+#include "base/fileinputoutput.h"
 #include "base/path.h"
 #include "base/povassert.h"
+#include "base/stringutilities.h"
 #include "base/timer.h"
 #include "base/image/colourspace.h"
 
@@ -57,6 +59,7 @@
 #include "core/lighting/photons.h"
 #include "core/lighting/radiosity.h"
 #include "core/math/matrix.h"
+#include "core/support/objectprofile.h"
 #include "core/support/octree.h"
 
 // POV-Ray header files (POVMS module)
@@ -66,15 +69,19 @@
 // POV-Ray header files (backend module)
 #include "backend/control/messagefactory.h"
 #include "backend/control/renderbackend.h"
+#include "backend/control/rendernode.h"
 #include "backend/lighting/photonestimationtask.h"
 #include "backend/lighting/photonshootingstrategy.h"
 #include "backend/lighting/photonshootingtask.h"
 #include "backend/lighting/photonsortingtask.h"
 #include "backend/lighting/photonstrategytask.h"
 #include "backend/render/radiositytask.h"
+#include "backend/render/rendernodetask.h"
 #include "backend/render/tracetask.h"
 #include "backend/scene/backendscenedata.h"
+#include "backend/scene/rendermetrics.h"
 #include "backend/scene/viewthreaddata.h"
+#include "backend/support/timeline.h"
 
 // this must be the last file included
 #include "base/povdebug.h"
@@ -89,6 +96,9 @@ using std::max;
 using std::shared_ptr;
 using std::vector;
 
+/// Maximum number of objects to list in the object profile.
+static const size_t kMaxObjectProfileEntries = 20;
+
 /// Round up to a power of two.
 inline unsigned int MakePowerOfTwo(unsigned int i)
 {
@@ -101,6 +111,7 @@ inline unsigned int MakePowerOfTwo(unsigned int i)
 
 ViewData::ViewData(shared_ptr<BackendSceneData> sd) :
     nextBlock(0),
+    remoteBlocks(0),
     completedFirstPass(false),
     highestTraceLevel(0),
     width(160),
@@ -108,11 +119,16 @@ ViewData::ViewData(shared_ptr<BackendSceneData> sd) :
     blockWidth(10),
     blockHeight(8),
     blockSize(DEFAULT_BLOCK_SIZE),
-    realTimeRaytracing(false),
-    rtrData(nullptr),
+    maxBlockNoise(0.0f),
     renderArea(0, 0, 159, 119),
     radiosityCache(sd->radiositySettings),
     sceneData(sd),
+    realTimeRaytracing(false),
+    rtrData(nullptr),
+    auxiliaryData(false),
+    pixelCost(false),
+    objectProfiling(false),
+    cpuTimeSampling(false),
     qualityFlags(9)
 {
 }
@@ -235,25 +251,61 @@ void ViewData::getBlockXY(const unsigned int nb, unsigned int &x, unsigned int &
 
 bool ViewData::GetNextRectangle(POVRect& rect, unsigned int& serial)
 {
-    std::lock_guard<std::mutex> lock(nextBlockMutex);
+    // when running as a render node, the coordinator decides which blocks to render
+    if (sceneData->renderNodeJob != nullptr)
+    {
+        if (!sceneData->renderNodeJob->GetNextBlock(rect, serial))
+            return false;
+
+        std::lock_guard<std::mutex> lock(nextBlockMutex);
+        pixelsPending += rect.GetArea();
+        blockBusyList.insert(serial);
+        return true;
+    }
 
-    while(true)
+    std::unique_lock<std::mutex> lock(nextBlockMutex);
+
+    while (!DispatchNextBlock(rect, serial))
     {
-        if(nextBlock >= (blockWidth * blockHeight))
+        // blocks held by render nodes may still come back to be rendered here
+        if (remoteBlocks == 0)
             return false;
+        blockAvailable.wait(lock);
+    }
 
-        unsigned int tempNextBlock = nextBlock; // TODO FIXME - works around nasty gcc (found using 4.0.1) bug failing to honor casting away of volatile on pass by value on template argument lookup [trf]
+    return true;
+}
 
-        if((blockSkipList.empty() == true) || (blockSkipList.find((unsigned int)tempNextBlock) == blockSkipList.end()))
-            break;
+bool ViewData::DispatchNextBlock(POVRect& rect, unsigned int& serial)
+{
+    if (!blockRetryList.empty())
+    {
+        serial = *blockRetryList.begin();
+        blockRetryList.erase(blockRetryList.begin());
+    }
+    else
+    {
+        while(true)
+        {
+            if(nextBlock >= (blockWidth * blockHeight))
+                return false;
+
+            unsigned int tempNextBlock = nextBlock; // TODO FIXME - works around nasty gcc (found using 4.0.1) bug failing to honor casting away of volatile on pass by value on template argument lookup [trf]
+
+            if((blockSkipList.empty() == true) || (blockSkipList.find((unsigned int)tempNextBlock) == blockSkipList.end()))
+                break;
+
+            blockSkipList.erase((unsigned int)tempNextBlock);
+            nextBlock++;
+        }
 
-        blockSkipList.erase((unsigned int)tempNextBlock);
+        serial = nextBlock;
         nextBlock++;
     }
 
     unsigned int blockX;
     unsigned int blockY;
-    getBlockXY(nextBlock,blockX,blockY);
+    getBlockXY(serial,blockX,blockY);
 
     rect.left = renderArea.left + (blockX * blockSize);
     rect.right = min(renderArea.left + ((blockX + 1) * blockSize) - 1, renderArea.right);
@@ -262,14 +314,47 @@ bool ViewData::GetNextRectangle(POVRect& rect, unsigned int& serial)
 
     pixelsPending += rect.GetArea();
 
-    serial = nextBlock;
-    nextBlock++;
-
     blockBusyList.insert(serial);
 
     return true;
 }
 
+bool ViewData::GetNextRemoteRectangle(POVRect& rect, unsigned int& serial)
+{
+    std::lock_guard<std::mutex> lock(nextBlockMutex);
+
+    if (!DispatchNextBlock(rect, serial))
+        return false;
+
+    remoteBlocks++;
+    return true;
+}
+
+void ViewData::CompletedRemoteRectangle(const POVRect& rect, unsigned int serial, const vector<RGBTColour>& pixels, const vector<POVMSFloat>& auxiliary, const vector<POVMSFloat>& cost, unsigned int size, bool relevant, bool complete)
+{
+    CompletedRectangle(rect, serial, pixels, vector<POVMSFloat>(), auxiliary, cost, size, relevant, complete);
+
+    std::lock_guard<std::mutex> lock(nextBlockMutex);
+    remoteBlocks--;
+    blockAvailable.notify_all();
+}
+
+void ViewData::AbandonRemoteRectangle(const POVRect& rect, unsigned int serial)
+{
+    std::lock_guard<std::mutex> lock(nextBlockMutex);
+    blockBusyList.erase(serial);
+    blockRetryList.insert(serial);
+    pixelsPending -= rect.GetArea();
+    remoteBlocks--;
+    blockAvailable.notify_all();
+}
+
+bool ViewData::HasRemainingRectangles()
+{
+    std::lock_guard<std::mutex> lock(nextBlockMutex);
+    return !blockRetryList.empty() || (nextBlock < (blockWidth * blockHeight));
+}
+
 bool ViewData::GetNextRectangle(POVRect& rect, unsigned int& serial, BlockInfo*& blockInfo, unsigned int stride)
 {
     std::lock_guard<std::mutex> lock(nextBlockMutex);
@@ -403,6 +488,11 @@ bool ViewData::GetNextRectangle(POVRect& rect, unsigned int& serial, BlockInfo*&
 }
 
 void ViewData::CompletedRectangle(const POVRect& rect, unsigned int serial, const vector<RGBTColour>& pixels, unsigned int size, bool relevant, bool complete, float completion, BlockInfo* blockInfo)
+{
+    CompletedRectangle(rect, serial, pixels, vector<POVMSFloat>(), vector<POVMSFloat>(), vector<POVMSFloat>(), size, relevant, complete, completion, blockInfo);
+}
+
+void ViewData::CompletedRectangle(const POVRect& rect, unsigned int serial, const vector<RGBTColour>& pixels, const vector<POVMSFloat>& convergence, const vector<POVMSFloat>& auxiliary, const vector<POVMSFloat>& cost, unsigned int size, bool relevant, bool complete, float completion, BlockInfo* blockInfo)
 {
     if (realTimeRaytracing == true)
     {
@@ -427,22 +517,54 @@ void ViewData::CompletedRectangle(const POVRect& rect, unsigned int serial, cons
         try
         {
             POVMS_Message pixelblockmsg(kPOVObjectClass_PixelData, kPOVMsgClass_ViewImage, kPOVMsgIdent_PixelBlockSet);
-            vector<POVMSFloat> pixelvector;
 
-            pixelvector.reserve(pixels.size() * 5);
-
-            for(vector<RGBTColour>::const_iterator i(pixels.begin()); i != pixels.end(); i++)
+            // only the final pass of a block may go through the shared framebuffer: the frontend
+            // reads it whenever it gets to the message, by which time an earlier pass would
+            // already have been overwritten by a later one
+            if ((framebuffer != nullptr) && (size == 1) && (pixels.size() == rect.GetArea()) && relevant && complete && (blockInfo == nullptr))
             {
-                pixelvector.push_back(i->red());
-                pixelvector.push_back(i->green());
-                pixelvector.push_back(i->blue());
-                pixelvector.push_back(0.0); // unused component
-                pixelvector.push_back(i->transm());
+                // store the pixels where the frontend can pick them up directly;
+                // the message merely tells it where to look
+                for(unsigned int y = rect.top, i = 0; y <= rect.bottom; y++, i += rect.GetWidth())
+                    framebuffer->SetRGBTRow(rect.left, y, rect.GetWidth(), &pixels[i]);
             }
+            else
+            {
+                vector<POVMSFloat> pixelvector;
 
-            POVMS_Attribute pixelattr(pixelvector);
+                pixelvector.reserve(pixels.size() * 5);
 
-            pixelblockmsg.Set(kPOVAttrib_PixelBlock, pixelattr);
+                for(vector<RGBTColour>::const_iterator i(pixels.begin()); i != pixels.end(); i++)
+                {
+                    pixelvector.push_back(i->red());
+                    pixelvector.push_back(i->green());
+                    pixelvector.push_back(i->blue());
+                    pixelvector.push_back(0.0); // unused component
+                    pixelvector.push_back(i->transm());
+                }
+
+                POVMS_Attribute pixelattr(pixelvector);
+
+                pixelblockmsg.Set(kPOVAttrib_PixelBlock, pixelattr);
+            }
+            if (!convergence.empty())
+            {
+                vector<POVMSFloat> convergencevector(convergence);
+                POVMS_Attribute convergenceattr(convergencevector);
+                pixelblockmsg.Set(kPOVAttrib_PixelConvergence, convergenceattr);
+            }
+            if (!auxiliary.empty())
+            {
+                vector<POVMSFloat> auxiliaryvector(auxiliary);
+                POVMS_Attribute auxiliaryattr(auxiliaryvector);
+                pixelblockmsg.Set(kPOVAttrib_PixelAuxiliary, auxiliaryattr);
+            }
+            if (!cost.empty())
+            {
+                vector<POVMSFloat> costvector(cost);
+                POVMS_Attribute costattr(costvector);
+                pixelblockmsg.Set(kPOVAttrib_PixelCost, costattr);
+            }
             if (relevant)
                 pixelblockmsg.SetVoid(kPOVAttrib_PixelFinal);
             if (complete)
@@ -455,11 +577,17 @@ void ViewData::CompletedRectangle(const POVRect& rect, unsigned int serial, cons
             pixelblockmsg.SetInt(kPOVAttrib_Right, rect.right);
             pixelblockmsg.SetInt(kPOVAttrib_Bottom, rect.bottom);
 
-            pixelblockmsg.SetInt(kPOVAttrib_ViewId, viewId);
-            pixelblockmsg.SetSourceAddress(sceneData->backendAddress);
-            pixelblockmsg.SetDestinationAddress(sceneData->frontendAddress);
+            // when running as a render node, the pixels go to the coordinator instead
+            if (sceneData->renderNodeJob != nullptr)
+                sceneData->renderNodeJob->SendPixels(pixelblockmsg, serial);
+            else
+            {
+                pixelblockmsg.SetInt(kPOVAttrib_ViewId, viewId);
+                pixelblockmsg.SetSourceAddress(sceneData->backendAddress);
+                pixelblockmsg.SetDestinationAddress(sceneData->frontendAddress);
 
-            POVMS_SendMessage(pixelblockmsg);
+                POVMS_SendMessage(pixelblockmsg);
+            }
         }
         catch(pov_base::Exception&)
         {
@@ -472,7 +600,7 @@ void ViewData::CompletedRectangle(const POVRect& rect, unsigned int serial, cons
     CompletedRectangle(rect, serial, completion, blockInfo);
 }
 
-void ViewData::CompletedRectangle(const POVRect& rect, unsigned int serial, const vector<Vector2d>& positions, const vector<RGBTColour>& colors, unsigned int size, bool relevant, bool complete, float completion, BlockInfo* blockInfo)
+void ViewData::CompletedRectangle(const POVRect& rect, unsigned int serial, const vector<Vector2d>& positions, const vector<RGBTColour>& colors, const vector<POVMSFloat>& auxiliary, unsigned int size, bool relevant, bool complete, float completion, BlockInfo* blockInfo)
 {
     try
     {
@@ -506,6 +634,17 @@ void ViewData::CompletedRectangle(const POVRect& rect, unsigned int serial, cons
 
         pixelblockmsg.Set(kPOVAttrib_PixelPositions, pixelposattr);
         pixelblockmsg.Set(kPOVAttrib_PixelColors, pixelcolattr);
+        if (!auxiliary.empty())
+        {
+            // the auxiliary data covers the entire rectangle, so the frontend needs to know where that is
+            vector<POVMSFloat> auxiliaryvector(auxiliary);
+            POVMS_Attribute auxiliaryattr(auxiliaryvector);
+            pixelblockmsg.Set(kPOVAttrib_PixelAuxiliary, auxiliaryattr);
+            pixelblockmsg.SetInt(kPOVAttrib_Left, rect.left);
+            pixelblockmsg.SetInt(kPOVAttrib_Top, rect.top);
+            pixelblockmsg.SetInt(kPOVAttrib_Right, rect.right);
+            pixelblockmsg.SetInt(kPOVAttrib_Bottom, rect.bottom);
+        }
         if (relevant)
             pixelblockmsg.SetVoid(kPOVAttrib_PixelFinal);
         if (complete)
@@ -569,11 +708,33 @@ void ViewData::SetNextRectangle(const BlockIdSet& bsl, unsigned int fs)
     blockSkipList = bsl;
     blockBusyList.clear(); // safety catch; shouldn't be necessary
     blockPostponedList.clear(); // safety catch; shouldn't be necessary
+    blockRetryList.clear();
     nextBlock = fs;
     completedFirstPass = false; // TODO
     pixelsCompleted = 0; // TODO
 }
 
+void ViewData::SetBlockNoise(unsigned int serial, float noise)
+{
+    std::lock_guard<std::mutex> lock(setDataMutex);
+
+    float oldNoise = blockNoiseList[serial];
+    blockNoiseList[serial] = noise;
+
+    if (noise >= maxBlockNoise)
+        maxBlockNoise = noise;
+    else if (oldNoise >= maxBlockNoise)
+        // the block that used to be the noisiest has improved, so we need to search for the new maximum
+        maxBlockNoise = *std::max_element(blockNoiseList.begin(), blockNoiseList.end());
+}
+
+float ViewData::GetMaxBlockNoise()
+{
+    std::lock_guard<std::mutex> lock(setDataMutex);
+
+    return maxBlockNoise;
+}
+
 void ViewData::SetHighestTraceLevel(unsigned int htl)
 {
     std::lock_guard<std::mutex> lock(setDataMutex);
@@ -697,6 +858,8 @@ void View::StartRender(POVMS_Object& renderOptions)
     DBL aathreshold = 0.3;
     DBL aaconfidence = 0.9;
     unsigned int aadepth = 3;
+    POV_LONG aatimebudget = 0;
+    bool progressive = false;
     DBL aaGammaValue = 1.0;
     GammaCurvePtr aaGammaCurve;
     unsigned int previewstartsize = 0;
@@ -712,11 +875,12 @@ void View::StartRender(POVMS_Object& renderOptions)
     viewData.qualityFlags = QualityFlags(clip(renderOptions.TryGetInt(kPOVAttrib_Quality, 9), 0, 9));
 
     if(renderOptions.TryGetBool(kPOVAttrib_Antialias, false) == true)
-        tracingmethod = clip(renderOptions.TryGetInt(kPOVAttrib_SamplingMethod, 1), 0, 3); // TODO FIXME - magic number in clip
+        tracingmethod = clip(renderOptions.TryGetInt(kPOVAttrib_SamplingMethod, 1), 0, 4); // TODO FIXME - magic number in clip
 
     aadepth = clip((unsigned int)renderOptions.TryGetInt(kPOVAttrib_AntialiasDepth, 3), 1u, 9u);
     aathreshold = clip(renderOptions.TryGetFloat(kPOVAttrib_AntialiasThreshold, 0.3f), 0.0f, 1.0f);
     aaconfidence = clip(renderOptions.TryGetFloat(kPOVAttrib_AntialiasConfidence, 0.9f), 0.0f, 1.0f);
+    aatimebudget = POV_LONG(max(renderOptions.TryGetFloat(kPOVAttrib_AntialiasTimeBudget, 0.0f), 0.0f) * 1000.0); // seconds to milliseconds
     if(renderOptions.TryGetBool(kPOVAttrib_Jitter, true) == true)
         jitterscale = clip(renderOptions.TryGetFloat(kPOVAttrib_JitterAmount, 1.0f), 0.0f, 1.0f);
     else
@@ -729,6 +893,15 @@ void View::StartRender(POVMS_Object& renderOptions)
 
     previewstartsize = MakePowerOfTwo(clip((unsigned int)renderOptions.TryGetInt(kPOVAttrib_PreviewStartSize, 1), 1u, 64u));
     previewendsize = MakePowerOfTwo(clip((unsigned int)renderOptions.TryGetInt(kPOVAttrib_PreviewEndSize, 1), 1u, previewstartsize));
+
+    // Progressive refinement renders the whole frame at one sample per pixel before refining it in passes,
+    // so it uses the adaptive variance sampling method and supersedes the mosaic preview.
+    progressive = renderOptions.TryGetBool(kPOVAttrib_ProgressiveRefinement, false);
+    if (progressive)
+    {
+        tracingmethod = 4;
+        previewstartsize = previewendsize = 1;
+    }
     if((previewendsize == 2) && (tracingmethod == 0)) // optimisation to render all pixels only once
         previewendsize = 1;
 
@@ -753,7 +926,8 @@ void View::StartRender(POVMS_Object& renderOptions)
         if(loadRadiosityCache)
             loadRadiosityCache = viewData.radiosityCache.Load(radiosityFile);
         if(saveRadiosityCache)
-            viewData.radiosityCache.InitAutosave(radiosityFile, loadRadiosityCache); // if we loaded the file, add to existing data
+            viewData.radiosityCache.InitAutosave(radiosityFile, loadRadiosityCache, // if we loaded the file, add to existing data
+                                                 renderOptions.TryGetBool(kPOVAttrib_RadiosityBinaryFile, false));
     }
 
     viewData.GetSceneData()->radiositySettings.vainPretrace = renderOptions.TryGetBool(kPOVAttrib_RadiosityVainPretrace, true);
@@ -836,6 +1010,9 @@ void View::StartRender(POVMS_Object& renderOptions)
     }
 
     viewData.blockInfoList.resize(viewData.blockWidth * viewData.blockHeight);
+    viewData.blockNoiseList.assign(viewData.blockWidth * viewData.blockHeight, 0.0f);
+    viewData.maxBlockNoise = 0.0f;
+    viewData.frameTimer.Reset();
 
     viewData.pixelsPending = 0;
     viewData.pixelsCompleted = 0;
@@ -857,9 +1034,80 @@ void View::StartRender(POVMS_Object& renderOptions)
     int maxRenderThreads = renderOptions.TryGetInt(kPOVAttrib_MaxRenderThreads, 1);
 
     viewData.realTimeRaytracing = renderOptions.TryGetBool(kPOVAttrib_RealTimeRaytracing, false); // TODO - experimental code
+    viewData.auxiliaryData = renderOptions.TryGetBool(kPOVAttrib_Denoise, false);
+    viewData.pixelCost = renderOptions.TryGetBool(kPOVAttrib_CreateHistogram, false);
+    viewData.objectProfiling = renderOptions.TryGetBool(kPOVAttrib_ProfileObjects, false);
+    viewData.cpuTimeSampling = renderOptions.Exist(kPOVAttrib_MetricsFile);
+    {
+        std::lock_guard<std::mutex> lock(metricsMutex);
+        metrics.reset();
+    }
+
+    // the timeline picks up where the parser left off, unless the scene is being reused;
+    // render nodes leave the recording to the coordinator
+    if (renderOptions.Exist(kPOVAttrib_TimelineFile) && (viewData.sceneData->renderNodeJob == nullptr))
+    {
+        if (viewData.sceneData->timeline == nullptr)
+            viewData.sceneData->timeline = std::make_shared<Timeline>();
+    }
+    else
+        viewData.sceneData->timeline.reset();
     if (viewData.realTimeRaytracing)
         viewData.rtrData = new RTRData(viewData, maxRenderThreads);
 
+    // framebuffer shared with the frontend; render nodes send their pixels to the coordinator instead
+    viewData.framebuffer.reset();
+    if (renderOptions.Exist(kPOVAttrib_SharedFramebufferFile) && !viewData.realTimeRaytracing &&
+        (viewData.sceneData->renderNodeJob == nullptr))
+        viewData.framebuffer = SharedFramebuffer::Open(renderOptions.GetUCS2String(kPOVAttrib_SharedFramebufferFile),
+                                                       viewData.width, viewData.height);
+
+    // render nodes
+    vector<std::string> renderNodes;
+    if (viewData.sceneData->renderNodeJob != nullptr)
+    {
+        // rendering blocks for a coordinator, which only hands out blocks of the final pass
+        previewstartsize = previewendsize = 1;
+    }
+    else if (renderOptions.Exist(kPOVAttrib_RenderNodes))
+    {
+        std::string nodes(renderOptions.GetString(kPOVAttrib_RenderNodes));
+        for (size_t pos = nodes.find_first_not_of(", \t"); pos != std::string::npos; )
+        {
+            size_t end = nodes.find_first_of(", \t", pos);
+            renderNodes.push_back(nodes.substr(pos, end - pos));
+            pos = nodes.find_first_not_of(", \t", end);
+        }
+
+        if (!renderNodes.empty() && ((tracingmethod == 4) || viewData.realTimeRaytracing))
+        {
+            // these modes dispatch blocks repeatedly, which render nodes can't take part in
+            MessageFactory messageFactory(viewData.GetSceneData()->warningLevel, "Render",
+                                          viewData.sceneData->backendAddress, viewData.sceneData->frontendAddress,
+                                          viewData.sceneData->sceneId, viewData.viewId);
+            messageFactory.Warning(kWarningGeneral, "Render nodes cannot be used with progressive refinement, "
+                                   "sampling method 4 or real-time raytracing; rendering locally only.");
+            renderNodes.clear();
+        }
+        else if (!renderNodes.empty())
+        {
+            // render nodes only take part in the final pass
+            previewstartsize = previewendsize = 1;
+            // make sure the seed survives the trip to the nodes unchanged
+            seed = size_t(POVMSInt(seed));
+
+            if (viewData.GetSceneData()->radiositySettings.radiosityEnabled || viewData.GetSceneData()->photonSettings.photonsEnabled)
+            {
+                // each node runs its own radiosity pretrace and photon shooting, which is not reproducible across processes
+                MessageFactory messageFactory(viewData.GetSceneData()->warningLevel, "Render",
+                                              viewData.sceneData->backendAddress, viewData.sceneData->frontendAddress,
+                                              viewData.sceneData->sceneId, viewData.viewId);
+                messageFactory.Warning(kWarningGeneral, "Render nodes compute radiosity and photons independently; "
+                                       "blocks rendered by them may differ slightly from those rendered locally.");
+            }
+        }
+    }
+
     // camera changes without parsing
     if(renderOptions.Exist(kPOVAttrib_SceneCamera) == false)
         viewData.camera = viewData.GetSceneData()->parsedCamera;
@@ -999,7 +1247,9 @@ void View::StartRender(POVMS_Object& renderOptions)
         renderTasks.AppendSync();
     }
     */
-    if(viewData.GetSceneData()->photonSettings.photonsEnabled)
+    // photon maps only depend on the scene, so if the scene has been rendered before, we simply re-use them
+    if(viewData.GetSceneData()->photonSettings.photonsEnabled &&
+       (viewData.GetSceneData()->surfacePhotonMap.numPhotons + viewData.GetSceneData()->mediaPhotonMap.numPhotons == 0))
     {
         if (!viewData.GetSceneData()->photonSettings.fileName.empty() && viewData.GetSceneData()->photonSettings.loadFile)
         {
@@ -1139,7 +1389,7 @@ void View::StartRender(POVMS_Object& renderOptions)
         // do render with mosaic preview start size
         for(int i = 0; i < maxRenderThreads; i++)
             viewThreadData.push_back(dynamic_cast<ViewThreadData *>(renderTasks.AppendTask(new TraceTask(
-                &viewData, 0, jitterscale, aathreshold, aaconfidence, aadepth, aaGammaCurve,
+                &viewData, 0, jitterscale, aathreshold, aaconfidence, aadepth, aaGammaCurve, aatimebudget, progressive,
                 previewstartsize, false, previewIsFinalPass, highReproducibility, seed
                 ))));
 
@@ -1157,7 +1407,7 @@ void View::StartRender(POVMS_Object& renderOptions)
             // do render with current mosaic preview size
             for(int i = 0; i < maxRenderThreads; i++)
                 viewThreadData.push_back(dynamic_cast<ViewThreadData *>(renderTasks.AppendTask(new TraceTask(
-                    &viewData, 0, jitterscale, aathreshold, aaconfidence, aadepth, aaGammaCurve,
+                    &viewData, 0, jitterscale, aathreshold, aaconfidence, aadepth, aaGammaCurve, aatimebudget, progressive,
                     step, true, previewIsFinalPass, highReproducibility, seed
                     ))));
         }
@@ -1175,7 +1425,7 @@ void View::StartRender(POVMS_Object& renderOptions)
 
             for(int i = 0; i < maxRenderThreads; i++)
                 viewThreadData.push_back(dynamic_cast<ViewThreadData *>(renderTasks.AppendTask(new TraceTask(
-                    &viewData, tracingmethod, jitterscale, aathreshold, aaconfidence, aadepth, aaGammaCurve,
+                    &viewData, tracingmethod, jitterscale, aathreshold, aaconfidence, aadepth, aaGammaCurve, aatimebudget, progressive,
                     0, false, true, highReproducibility, seed
                     ))));
         }
@@ -1183,22 +1433,58 @@ void View::StartRender(POVMS_Object& renderOptions)
     // do render without mosaic preview
     else
     {
+        // tell the coordinator we're ready to take blocks
+        if (viewData.sceneData->renderNodeJob != nullptr)
+            renderTasks.AppendFunction(boost::bind(&RenderNodeJob::Ready, viewData.sceneData->renderNodeJob, (unsigned int)maxRenderThreads));
+
         for(int i = 0; i < maxRenderThreads; i++)
             viewThreadData.push_back(dynamic_cast<ViewThreadData *>(renderTasks.AppendTask(new TraceTask(
-                &viewData, tracingmethod, jitterscale, aathreshold, aaconfidence, aadepth, aaGammaCurve,
+                &viewData, tracingmethod, jitterscale, aathreshold, aaconfidence, aadepth, aaGammaCurve, aatimebudget, progressive,
                 0, false, true, highReproducibility, seed
                 ))));
+
+        for(vector<std::string>::const_iterator i(renderNodes.begin()); i != renderNodes.end(); i++)
+            viewThreadData.push_back(dynamic_cast<ViewThreadData *>(renderTasks.AppendTask(new RenderNodeTask(
+                &viewData, *i, renderOptions, seed
+                ))));
+    }
+
+    // collect live metrics from the threads created above
+    if (renderOptions.Exist(kPOVAttrib_MetricsFile))
+    {
+        try
+        {
+            std::lock_guard<std::mutex> lock(metricsMutex);
+            metrics.reset(new RenderMetrics(renderOptions.GetUCS2String(kPOVAttrib_MetricsFile),
+                                            renderOptions.TryGetInt(kPOVAttrib_MetricsFormat, kPOVList_MetricsFormat_JSONLines),
+                                            POV_LONG(renderOptions.TryGetFloat(kPOVAttrib_MetricsInterval, 5.0f) * 1000.0f),
+                                            viewData, viewThreadData));
+        }
+        catch (pov_base::Exception& e)
+        {
+            MessageFactory messageFactory(viewData.GetSceneData()->warningLevel, "Render",
+                                          viewData.sceneData->backendAddress, viewData.sceneData->frontendAddress,
+                                          viewData.sceneData->sceneId, viewData.viewId);
+            messageFactory.Warning(kWarningGeneral, "%s; no render metrics will be written.", e.what());
+        }
     }
 
     // wait for render to finish
     renderTasks.AppendSync();
 
+    // write final metrics
+    renderTasks.AppendFunction(boost::bind(&View::StopMetrics, this, _1));
+
     // send shutdown messages
     renderTasks.AppendFunction(boost::bind(&View::DispatchShutdownMessages, this, _1));
 
     // wait for shutdown messages to be sent
     renderTasks.AppendSync();
 
+    // write timeline
+    if (viewData.sceneData->timeline != nullptr)
+        renderTasks.AppendFunction(boost::bind(&View::WriteTimeline, this, _1, renderOptions.GetUCS2String(kPOVAttrib_TimelineFile)));
+
     // send statistics
     renderTasks.AppendFunction(boost::bind(&View::SendStatistics, this, _1));
 
@@ -1214,6 +1500,11 @@ void View::StopRender()
 {
     renderTasks.Stop();
 
+    {
+        std::lock_guard<std::mutex> lock(metricsMutex);
+        metrics.reset();
+    }
+
     RenderBackend::SendViewFailedResult(viewData.viewId, kUserAbortErr, viewData.sceneData->frontendAddress);
 }
 
@@ -1241,6 +1532,9 @@ void View::GetStatistics(POVMS_Object& renderStats)
 
     renderStats.Set(kPOVAttrib_ObjectIStats, isectStats);
 
+    if (viewData.GetObjectProfiling())
+        GetObjectProfile(renderStats);
+
     // general stats
     renderStats.SetInt(kPOVAttrib_Height, viewData.GetHeight());
     renderStats.SetInt(kPOVAttrib_Width, viewData.GetWidth());
@@ -1422,6 +1716,35 @@ void View::DispatchShutdownMessages(TaskQueue&)
         (*it)->DispatchShutdownMessages(messageFactory);
 }
 
+void View::WriteTimeline(TaskQueue&, const UCS2String& filename)
+{
+    // a reused scene starts a new timeline with the next render
+    std::shared_ptr<Timeline> timeline(viewData.sceneData->timeline);
+    viewData.sceneData->timeline.reset();
+    if (timeline == nullptr)
+        return;
+
+    std::unique_ptr<OStream> file(NewOStream(Path(filename), POV_File_Data_LOG, false));
+    if (file == nullptr)
+    {
+        MessageFactory messageFactory(viewData.GetSceneData()->warningLevel, "Render",
+                                      viewData.sceneData->backendAddress, viewData.sceneData->frontendAddress,
+                                      viewData.sceneData->sceneId, viewData.viewId);
+        messageFactory.Warning(kWarningGeneral, "Cannot create timeline file '%s'.", UCS2toSysString(filename).c_str());
+        return;
+    }
+
+    timeline->Write(*file);
+}
+
+void View::StopMetrics(TaskQueue&)
+{
+    std::lock_guard<std::mutex> lock(metricsMutex);
+    if (metrics != nullptr)
+        (void)metrics->WriteSample();
+    metrics.reset();
+}
+
 void View::SendStatistics(TaskQueue&)
 {
     POVMS_Message renderStats(kPOVObjectClass_RenderStatistics, kPOVMsgClass_ViewOutput, kPOVMsgIdent_RenderStatistics);
@@ -1439,6 +1762,62 @@ void View::SendStatistics(TaskQueue&)
     viewThreadData.clear();
 }
 
+void View::GetObjectProfile(POVMS_Object& renderStats)
+{
+    typedef std::pair<ConstObjectPtr, ObjectProfile::Entry> ProfileEntry;
+
+    ObjectProfile profile;
+    for (vector<ViewThreadData *>::iterator i(viewThreadData.begin()); i != viewThreadData.end(); i++)
+    {
+        if ((*i)->GetObjectProfile() != nullptr)
+            profile += *(*i)->GetObjectProfile();
+    }
+
+    vector<ProfileEntry> entries(profile.GetEntries().begin(), profile.GetEntries().end());
+    double totalTime = 0.0;
+    for (vector<ProfileEntry>::const_iterator i(entries.begin()); i != entries.end(); i++)
+        totalTime += i->second.GetEstimatedTime();
+
+    size_t count = min(entries.size(), kMaxObjectProfileEntries);
+    std::partial_sort(entries.begin(), entries.begin() + count, entries.end(),
+                      [](const ProfileEntry& a, const ProfileEntry& b)
+                      {
+                          if (a.second.GetEstimatedTime() != b.second.GetEstimatedTime())
+                              return a.second.GetEstimatedTime() > b.second.GetEstimatedTime();
+                          return (a.second.tests + a.second.shadowTests) > (b.second.tests + b.second.shadowTests);
+                      });
+
+    POVMS_List profileList;
+    for (size_t i = 0; i < count; i++)
+    {
+        const ObjectProfile::Entry& entry = entries[i].second;
+        POVMS_Object objectProfile(kPOVObjectClass_ObjectProfile);
+
+        SceneData::ObjectSourceMap::const_iterator source = viewData.sceneData->objectSources.find(entries[i].first);
+        if (source != viewData.sceneData->objectSources.end())
+        {
+            objectProfile.SetString(kPOVAttrib_ObjectName, source->second.keyword.c_str());
+            objectProfile.SetUCS2String(kPOVAttrib_FileName, viewData.sceneData->objectSourceFiles[source->second.file].c_str());
+            objectProfile.SetLong(kPOVAttrib_Line, source->second.line);
+            objectProfile.SetLong(kPOVAttrib_Column, source->second.column);
+        }
+        else
+            objectProfile.SetString(kPOVAttrib_ObjectName, "object");
+
+        objectProfile.SetLong(kPOVAttrib_ISectsTests, entry.tests);
+        objectProfile.SetLong(kPOVAttrib_ISectsSucceeded, entry.hits);
+        objectProfile.SetLong(kPOVAttrib_ShadowTest, entry.shadowTests);
+        objectProfile.SetLong(kPOVAttrib_ShadowTestSuc, entry.shadowHits);
+        objectProfile.SetFloat(kPOVAttrib_ObjectProfileTime, entry.GetEstimatedTime());
+
+        profileList.Append(objectProfile);
+    }
+
+    renderStats.Set(kPOVAttrib_ObjectProfile, profileList);
+    renderStats.SetInt(kPOVAttrib_ObjectProfileCount, int(entries.size()));
+    renderStats.SetFloat(kPOVAttrib_ObjectProfileTotal, totalTime);
+}
+
 void View::SetNextRectangle(TaskQueue&, shared_ptr<ViewData::BlockIdSet> bsl, unsigned int fs)
 {
     viewData.SetNextRectangle(*bsl, fs);
@@ -1452,6 +1831,13 @@ void View::RenderControlThread()
     {
         while((renderTasks.Process() == true) && (stopRequsted == false)) { }
 
+        {
+            std::lock_guard<std::mutex> lock(metricsMutex);
+            // a sample that cannot be written most likely means nobody is listening any longer
+            if ((metrics != nullptr) && !metrics->Update())
+                metrics.reset();
+        }
+
         if((renderTasks.IsDone() == true) && (renderTasks.Failed() == true) && (sentFailedResult == false))
         {
             RenderBackend::SendViewFailedResult(viewData.viewId, renderTasks.FailureCode(kUncategorizedError), viewData.sceneData->frontendAddress);
@@ -51,7 +51,9 @@
 #include <vector>
 
 // POV-Ray header files (base module)
+#include "base/timer.h"
 #include "base/types.h" // TODO - only appears to be pulled in for POVRect - can we avoid this?
+#include "base/image/sharedframebuffer.h"
 
 // POV-Ray header files (core module)
 #include "core/core_fwd.h"
@@ -61,6 +63,7 @@
 
 // POV-Ray header files (backend module)
 #include "backend/control/scene_fwd.h"
+#include "backend/scene/rendermetrics_fwd.h"
 #include "backend/scene/viewthreaddata_fwd.h"
 #include "backend/support/taskqueue.h"
 
@@ -151,6 +154,39 @@ class ViewData final
          */
         bool GetNextRectangle(POVRect& rect, unsigned int& serial, BlockInfo*& blockInfo, unsigned int stride);
 
+        /**
+         *  Get the next sub-rectangle of the view to be rendered by a render node (if any).
+         *  Unlike @ref GetNextRectangle(), this method does not wait for rectangles held by
+         *  other render nodes. The rectangle must eventually be passed to either
+         *  @ref CompletedRemoteRectangle() or @ref AbandonRemoteRectangle().
+         *  @param  rect            Rectangle to render.
+         *  @param  serial          Rectangle serial number.
+         *  @return                 True if there is another rectangle to be dispatched, false otherwise.
+         */
+        bool GetNextRemoteRectangle(POVRect& rect, unsigned int& serial);
+
+        /**
+         *  Called when a render node has completed a sub-rectangle of the view.
+         *  The parameters are the same as for @ref CompletedRectangle().
+         */
+        void CompletedRemoteRectangle(const POVRect& rect, unsigned int serial, const std::vector<RGBTColour>& pixels,
+                                      const std::vector<POVMSFloat>& auxiliary, const std::vector<POVMSFloat>& cost,
+                                      unsigned int size, bool relevant, bool complete);
+
+        /**
+         *  Called when a render node has failed to complete a sub-rectangle of the view.
+         *  The rectangle will be dispatched again.
+         *  @param  rect            Rectangle abandoned.
+         *  @param  serial          Serial number of rectangle abandoned.
+         */
+        void AbandonRemoteRectangle(const POVRect& rect, unsigned int serial);
+
+        /**
+         *  Determine whether any sub-rectangles of the view remain to be dispatched.
+         *  @return                 True if there are rectangles left to dispatch, false otherwise.
+         */
+        bool HasRemainingRectangles();
+
         /**
          *  Called to (fully or partially) complete rendering of a specific sub-rectangle of the view.
          *  The pixel data is sent to the frontend and pixel progress information
@@ -171,6 +207,34 @@ class ViewData final
                                 unsigned int size, bool relevant, bool complete, float completion = 1.0,
                                 BlockInfo* blockInfo = nullptr);
 
+        /**
+         *  Called to (fully or partially) complete rendering of a specific sub-rectangle of the view.
+         *  The pixel data and per-pixel convergence, auxiliary and cost information is sent to the frontend
+         *  and pixel progress information is updated and sent to the frontend.
+         *  @param  rect            Rectangle just completed.
+         *  @param  serial          Serial number of rectangle just completed.
+         *  @param  pixels          Pixels of completed rectangle.
+         *  @param  convergence     Convergence information of completed rectangle, as triplets of sample count,
+         *                          estimated noise level and convergence flag per pixel. May be empty.
+         *  @param  auxiliary       Auxiliary feature data of completed rectangle, as albedo (RGB), normal (XYZ)
+         *                          and depth per pixel. May be empty.
+         *  @param  cost            Render cost of completed rectangle, as triplets of render time (in microseconds),
+         *                          number of rays and number of samples per pixel. May be empty.
+         *  @param  size            Size of each pixel (width and height).
+         *  @param  relevant        Mark the block as relevant for the final image for continue-trace.
+         *  @param  complete        Mark the block as completely rendered for continue-trace.
+         *  @param  completion      Approximate contribution of current pass to completion of this rectangle.
+         *  @param  blockInfo       Pointer to additional information about the rectangle. If this value is non-`nullptr`,
+         *                          the rectangle will be scheduled to be re-dispatched for another pass, and the
+         *                          data passed to whichever rendering thread the rectangle will be re-dispatched to.
+         *                          If this value is `nullptr`, the rectangle will not be re-dispatched.
+         */
+        void CompletedRectangle(const POVRect& rect, unsigned int serial, const std::vector<RGBTColour>& pixels,
+                                const std::vector<POVMSFloat>& convergence, const std::vector<POVMSFloat>& auxiliary,
+                                const std::vector<POVMSFloat>& cost,
+                                unsigned int size, bool relevant, bool complete, float completion = 1.0,
+                                BlockInfo* blockInfo = nullptr);
+
         /**
          *  Called to (fully or partially) complete rendering of a specific sub-rectangle of the view.
          *  The pixel data is sent to the frontend and pixel progress information
@@ -179,6 +243,8 @@ class ViewData final
          *  @param  serial          Serial number of rectangle just completed.
          *  @param  positions       Pixel positions within rectangle.
          *  @param  colors          Pixel colors for each pixel position.
+         *  @param  auxiliary       Auxiliary feature data of the entire rectangle (rather than just the given
+         *                          pixel positions), in the same format as for @ref CompletedRectangle(). May be empty.
          *  @param  size            Size of each pixel (width and height).
          *  @param  relevant        Mark the block as relevant for the final image for continue-trace.
          *  @param  complete        Mark the block as completely rendered for continue-trace.
@@ -189,7 +255,8 @@ class ViewData final
          *                          If this value is `nullptr`, the rectangle will not be re-dispatched.
          */
         void CompletedRectangle(const POVRect& rect, unsigned int serial, const std::vector<Vector2d>& positions,
-                                const std::vector<RGBTColour>& colors, unsigned int size, bool relevant, bool complete,
+                                const std::vector<RGBTColour>& colors, const std::vector<POVMSFloat>& auxiliary,
+                                unsigned int size, bool relevant, bool complete,
                                 float completion = 1.0, BlockInfo* blockInfo = nullptr);
 
         /**
@@ -213,6 +280,29 @@ class ViewData final
          */
         void SetNextRectangle(const BlockIdSet& bsl, unsigned int fs);
 
+        /**
+         *  Report the current noise estimate of a block for frame-wide adaptive sampling.
+         *  This method is called by the render threads after each pass over a block,
+         *  so that additional samples can be allocated to the noisiest pixels of the
+         *  whole frame rather than of the current block only.
+         *  @param  serial          Serial number of the block.
+         *  @param  noise           Highest noise estimate of any pixel in the block.
+         */
+        void SetBlockNoise(unsigned int serial, float noise);
+
+        /**
+         *  Get the highest noise estimate currently reported for any block of the view.
+         *  @return                 Highest noise estimate.
+         */
+        float GetMaxBlockNoise();
+
+        /**
+         *  Get the wall-clock time elapsed since the view started rendering the frame.
+         *  This is the time the antialiasing time budget is measured against.
+         *  @return                 Elapsed time in milliseconds.
+         */
+        POV_LONG ElapsedFrameTime() const { return frameTimer.ElapsedRealTime(); }
+
         /**
          *  Get width of view in pixels.
          *  @return                 Width in pixels.
@@ -247,7 +337,7 @@ class ViewData final
          *  Get the view id for this view.
          *  @return                 View id.
          */
-        inline RenderBackend::ViewId GetViewId() { return viewId; } // TODO FIXME - more like a hack, need a better way to do this
+        inline RenderBackend::ViewId GetViewId() const { return viewId; } // TODO FIXME - more like a hack, need a better way to do this
 
         /**
          *  Get the highest trace level found when last rendering this view.
@@ -285,6 +375,40 @@ class ViewData final
          */
         RTRData *GetRTRData() { return rtrData; }
 
+        /**
+         *  Determine whether auxiliary feature data (albedo, normal and depth) is to be
+         *  computed and sent to the frontend along with the final pixels.
+         *  @return                 True if auxiliary data is required.
+         */
+        bool GetAuxiliaryData() const { return auxiliaryData; }
+
+        /**
+         *  Determine whether the render cost of each pixel is to be measured and sent
+         *  to the frontend along with the final pixels.
+         *  @return                 True if per-pixel cost data is required.
+         */
+        bool GetPixelCost() const { return pixelCost; }
+
+        /**
+         *  Determine whether the intersection costs of individual top-level objects
+         *  are to be recorded and reported along with the render statistics.
+         *  @return                 True if objects are to be profiled.
+         */
+        bool GetObjectProfiling() const { return objectProfiling; }
+
+        /**
+         *  Determine whether render threads are to sample their CPU time for the
+         *  live render metrics.
+         *  @return                 True if CPU time is to be sampled.
+         */
+        bool GetCPUTimeSampling() const { return cpuTimeSampling; }
+
+        /**
+         *  Get the number of pixels completed so far in the current pass.
+         *  @return                 Number of pixels.
+         */
+        unsigned int GetPixelsCompleted() const { return pixelsCompleted; }
+
     private:
 
         struct BlockPostponedEntry final
@@ -308,6 +432,10 @@ class ViewData final
         volatile unsigned int nextBlock;
         /// next block counter mutex
         std::mutex nextBlockMutex;
+        /// signalled when a block held by a render node has been completed or abandoned
+        std::condition_variable blockAvailable;
+        /// number of blocks currently held by render nodes
+        unsigned int remoteBlocks;
         /// set data mutex
         std::mutex setDataMutex;
         /// Whether all blocks have been dispatched at least once.
@@ -332,8 +460,16 @@ class ViewData final
         BlockIdSet blockBusyList;
         /// list of blocks postponed for some reason
         BlockIdSet blockPostponedList;
+        /// list of blocks abandoned by render nodes, to be dispatched again
+        BlockIdSet blockRetryList;
         /// list of additional block information
         std::vector<BlockInfo*> blockInfoList;
+        /// list of per-block noise estimates for adaptive sampling
+        std::vector<float> blockNoiseList;
+        /// highest noise estimate in @ref blockNoiseList
+        float maxBlockNoise;
+        /// timer started when the view starts rendering the frame
+        pov_base::Timer frameTimer;
         /// area of view to be rendered
         POVRect renderArea;
         /// camera of this view
@@ -350,9 +486,27 @@ class ViewData final
         /// data specifically associated with the RTR feature
         RTRData *rtrData;
 
+        /// whether to send auxiliary feature data along with the pixels
+        bool auxiliaryData;
+
+        /// whether to send per-pixel render cost along with the pixels
+        bool pixelCost;
+
+        /// whether to record per-object intersection costs
+        bool objectProfiling;
+
+        /// whether render threads are to sample their CPU time for the live render metrics
+        bool cpuTimeSampling;
+
+        /// framebuffer shared with the frontend, or `nullptr` if pixels are to be sent via POVMS
+        std::unique_ptr<pov_base::SharedFramebuffer> framebuffer;
+
         /// functions to compute the X & Y block
         void getBlockXY(const unsigned int nb, unsigned int &x, unsigned int &y);
 
+        /// Dispatch the next block not yet rendered; the caller must hold @ref nextBlockMutex.
+        bool DispatchNextBlock(POVRect& rect, unsigned int& serial);
+
         /// pattern number to use for rendering
         unsigned int renderPattern;
 
@@ -465,6 +619,10 @@ class View final
         std::thread *renderControlThread;
         /// BSP tree mailbox
         BSPTree::Mailbox mailbox;
+        /// live render metrics, or `nullptr` if not collecting any
+        std::unique_ptr<RenderMetrics> metrics;
+        /// protects @ref metrics, which are sampled by the render control thread
+        std::mutex metricsMutex;
 
         View() = delete;
         View(const View&) = delete;
@@ -493,6 +651,26 @@ class View final
          */
         void SendStatistics(TaskQueue& taskq);
 
+        /**
+         *  Get the intersection costs of the most expensive top-level objects,
+         *  as recorded by all threads.
+         *  @param[out] renderStats Statistics to add the object profile to.
+         */
+        void GetObjectProfile(POVMS_Object& renderStats);
+
+        /**
+         *  Write the timeline of parsing and rendering upon completion of a render.
+         *  @param  taskq           The task queue that executed this method.
+         *  @param  filename        Name of the Chrome trace event file to write.
+         */
+        void WriteTimeline(TaskQueue& taskq, const UCS2String& filename);
+
+        /**
+         *  Write the final sample of the live render metrics and stop collecting them.
+         *  @param  taskq           The task queue that executed this method.
+         */
+        void StopMetrics(TaskQueue& taskq);
+
         /**
          *  Set the blocks not to generate with GetNextRectangle because they have
          *  already been rendered.
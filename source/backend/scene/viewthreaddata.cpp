@@ -60,8 +60,11 @@ namespace pov
 
 ViewThreadData::ViewThreadData(ViewData *vd, size_t seed) :
     TraceThreadData(std::dynamic_pointer_cast<SceneData>(vd->GetSceneData()), seed),
+    cpuTimeSample(-1),
     viewData(vd)
 {
+    if (vd->GetObjectProfiling())
+        EnableObjectProfile();
 }
 
 ViewThreadData::~ViewThreadData()
@@ -41,9 +41,11 @@
 #include "backend/scene/viewthreaddata_fwd.h"
 
 // C++ variants of C standard header files
-// C++ standard header files
 //  (none at the moment)
 
+// C++ standard header files
+#include <atomic>
+
 // POV-Ray header files (base module)
 //  (none at the moment)
 
@@ -89,6 +91,10 @@ class ViewThreadData final : public TraceThreadData
          *  @return                 Area rectangle.
          */
         const POVRect& GetRenderArea();
+        /// CPU time consumed by the thread as of the start of its most recent block,
+        /// in microseconds, or -1 if unknown; only sampled for the live render metrics,
+        /// and accessed with relaxed memory ordering.
+        std::atomic<POV_LONG> cpuTimeSample;
     protected:
         /// view data
         ViewData *viewData;
@@ -57,6 +57,7 @@
 // POV-Ray header files (backend module)
 #include "backend/control/messagefactory.h"
 #include "backend/scene/backendscenedata.h"
+#include "backend/support/timeline.h"
 
 // this must be the last file included
 #include "base/povdebug.h"
@@ -77,7 +78,8 @@ Task::Task(ThreadData *td, const boost::function1<void, Exception&>& f) :
     realTime(-1),
     cpuTime(-1),
     taskThread(nullptr),
-    povmsContext(nullptr)
+    povmsContext(nullptr),
+    name("Task")
 {
     if (td == nullptr)
         throw POV_EXCEPTION_STRING("Internal error: TaskData is NULL in Task constructor");
@@ -170,6 +172,12 @@ POV_LONG Task::ElapsedThreadCPUTime() const
     return timer->ElapsedThreadCPUTime();
 }
 
+void Task::SetTimeline(const std::shared_ptr<Timeline>& t, const char* n)
+{
+    timeline = t;
+    name = n;
+}
+
 void Task::TaskThread(const boost::function0<void>& completion)
 {
     int result;
@@ -188,6 +196,10 @@ void Task::TaskThread(const boost::function0<void>& completion)
 
     timer = &tasktime;
 
+    if (timeline != nullptr)
+        timeline->NameThread(name);
+    std::unique_ptr<Timeline::Scope> timelineScope(new Timeline::Scope(timeline.get(), "task", name));
+
     try
     {
         Run();
@@ -242,6 +254,8 @@ void Task::TaskThread(const boost::function0<void>& completion)
         failed = kUncategorizedError;
     }
 
+    timelineScope.reset();
+
     realTime = tasktime.ElapsedRealTime();
     if(tasktime.HasValidThreadCPUTime() == true)
         cpuTime = tasktime.ElapsedThreadCPUTime();
@@ -298,7 +312,9 @@ void Task::Cleanup ()
 SceneTask::SceneTask(ThreadData *td, const boost::function1<void, Exception&>& f, const char* sn, std::shared_ptr<BackendSceneData> sd, RenderBackend::ViewId vid) :
     Task(td, f),
     mpMessageFactory(new MessageFactory(sd->warningLevel, sn, sd->backendAddress, sd->frontendAddress, sd->sceneId, vid))
-{}
+{
+    SetTimeline(sd->timeline, sn);
+}
 
 SceneTask::~SceneTask()
 {
@@ -58,6 +58,7 @@
 #include "backend/control/messagefactory_fwd.h"
 #include "backend/control/renderbackend.h"
 #include "backend/scene/backendscenedata_fwd.h"
+#include "backend/support/timeline_fwd.h"
 
 namespace pov
 {
@@ -92,6 +93,12 @@ class Task
 
         inline POVMSContext GetPOVMSContext() { return povmsContext; }
 
+        /// Get the timeline to record the task's activity to, or `nullptr` if not recording.
+        inline const std::shared_ptr<Timeline>& GetTimeline() const { return timeline; }
+
+        /// Get the name of the task, for display purposes.
+        inline const char* GetName() const { return name; }
+
     protected:
 
         struct StopThreadException final {}; // TODO - consider subclassing from std::exception hierarchy.
@@ -103,6 +110,10 @@ class Task
         POV_LONG ElapsedRealTime() const;
         POV_LONG ElapsedThreadCPUTime() const;
 
+        /// Set the timeline to record the task's activity to, and the name to record it under.
+        /// @note   The name must have static storage duration.
+        void SetTimeline(const std::shared_ptr<Timeline>& t, const char* n);
+
     private:
 
         /// task data pointer
@@ -127,6 +138,10 @@ class Task
         std::thread *taskThread;
         /// POVMS message receiving context
         POVMSContext povmsContext;
+        /// timeline to record to or `nullptr`
+        std::shared_ptr<Timeline> timeline;
+        /// task name
+        const char* name;
 
         inline void FatalErrorHandler(const Exception& e)
         {
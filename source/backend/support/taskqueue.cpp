@@ -59,7 +59,7 @@ namespace pov
 using std::list;
 using std::shared_ptr;
 
-TaskQueue::TaskQueue() : failed(kNoError)
+TaskQueue::TaskQueue() : failed(kNoError), phaseName(nullptr)
 {
 }
 
@@ -87,6 +87,8 @@ void TaskQueue::Stop()
     while(queuedTasks.empty() == false)
         queuedTasks.pop();
 
+    phaseTimeline.reset();
+
     Notify();
 }
 
@@ -230,6 +232,13 @@ bool TaskQueue::Process()
         {
             case TaskEntry::kTask:
             {
+                // a phase spans all tasks started between two syncs, and is named after the first of them
+                if((phaseTimeline == nullptr) && (queuedTasks.front().GetTask()->GetTimeline() != nullptr))
+                {
+                    phaseTimeline = queuedTasks.front().GetTask()->GetTimeline();
+                    phaseName = queuedTasks.front().GetTask()->GetName();
+                    phaseStart = Timeline::Clock::now();
+                }
                 activeTasks.push_back(queuedTasks.front());
                 queuedTasks.front().GetTask()->Start(boost::bind(&TaskQueue::Notify, this));
                 queuedTasks.pop();
@@ -238,7 +247,14 @@ bool TaskQueue::Process()
             case TaskEntry::kSync:
             {
                 if(activeTasks.empty() == true)
+                {
                     queuedTasks.pop();
+                    if(phaseTimeline != nullptr)
+                    {
+                        phaseTimeline->AddPhase(phaseName, phaseStart, Timeline::Clock::now());
+                        phaseTimeline.reset();
+                    }
+                }
                 else
                     return false;
                 break;
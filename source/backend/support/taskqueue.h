@@ -60,6 +60,7 @@
 
 // POV-Ray header files (backend module)
 #include "backend/support/task.h"
+#include "backend/support/timeline.h"
 
 namespace pov
 {
@@ -128,6 +129,12 @@ class TaskQueue final
         int failed;
         /// wait for data in queue or related operation to be processed
         std::condition_variable_any processCondition;
+        /// timeline to record the current phase to, or `nullptr` if none
+        std::shared_ptr<Timeline> phaseTimeline;
+        /// name of the current phase
+        const char* phaseName;
+        /// start of the current phase
+        Timeline::Clock::time_point phaseStart;
 
         TaskQueue(const TaskQueue&) = delete;
         TaskQueue& operator=(const TaskQueue&) = delete;
@@ -0,0 +1,184 @@
+//******************************************************************************
+///
+/// @file backend/support/timeline.cpp
+///
+/// Implementations related to the recording of render activity timelines.
+///
+/// @copyright
+/// @parblock
+///
+/// Persistence of Vision Ray Tracer ('POV-Ray') version 3.8.
+/// Copyright 1991-2019 Persistence of Vision Raytracer Pty. Ltd.
+///
+/// POV-Ray is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU Affero General Public License as
+/// published by the Free Software Foundation, either version 3 of the
+/// License, or (at your option) any later version.
+///
+/// POV-Ray is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU Affero General Public License for more details.
+///
+/// You should have received a copy of the GNU Affero General Public License
+/// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+///
+/// ----------------------------------------------------------------------------
+///
+/// POV-Ray is based on the popular DKB raytracer version 2.12.
+/// DKBTrace was originally written by David K. Buck.
+/// DKBTrace Ver 2.0-2.12 were written by David K. Buck & Aaron A. Collins.
+///
+/// @endparblock
+///
+//******************************************************************************
+
+// Unit header file must be the first file included within POV-Ray *.cpp files (pulls in config)
+#include "backend/support/timeline.h"
+
+// C++ variants of C standard header files
+//  (none at the moment)
+
+// C++ standard header files
+//  (none at the moment)
+
+// POV-Ray header files (base module)
+#include "base/fileinputoutput.h"
+#include "base/timer.h"
+
+// this must be the last file included
+#include "base/povdebug.h"
+
+namespace pov
+{
+
+/// Thread id used for spans not attributed to any particular thread.
+static const int kTimelinePhaseThread = 0;
+
+Timeline::Scope::Scope(Timeline* timeline, const char* category, const char* name, int block) :
+    mpTimeline(timeline),
+    mCategory(category),
+    mName(name),
+    mBlock(block)
+{
+    if (mpTimeline != nullptr)
+    {
+        mRealStart = Clock::now();
+        mCPUStart = ThreadCPUTimeMicroseconds();
+    }
+}
+
+Timeline::Scope::~Scope()
+{
+    if (mpTimeline != nullptr)
+    {
+        POV_LONG cpuEnd = ThreadCPUTimeMicroseconds();
+        mpTimeline->Add(mCategory, mName, mBlock, mRealStart, Clock::now(), mCPUStart, cpuEnd);
+    }
+}
+
+Timeline::Timeline() :
+    mStart(Clock::now())
+{
+    mThreadNames.push_back("Phases");
+}
+
+void Timeline::NameThread(const char* name)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    // the system may recycle the ids of threads that have ended, so a thread being
+    // named is always taken to be a new one
+    int id = int(mThreadNames.size());
+    mThreadIds[std::this_thread::get_id()] = id;
+    mThreadNames.push_back(std::string(name) + " " + std::to_string(++mThreadNameCount[name]));
+}
+
+void Timeline::AddPhase(const char* name, Clock::time_point begin, Clock::time_point end)
+{
+    Event event;
+    event.name        = name;
+    event.category    = "phase";
+    event.thread      = kTimelinePhaseThread;
+    event.block       = -1;
+    event.start       = Microseconds(begin);
+    event.duration    = Microseconds(end) - event.start;
+    event.cpuStart    = -1;
+    event.cpuDuration = -1;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mEvents.push_back(event);
+}
+
+void Timeline::Add(const char* category, const char* name, int block,
+                   Clock::time_point realStart, Clock::time_point realEnd, POV_LONG cpuStart, POV_LONG cpuEnd)
+{
+    Event event;
+    event.name        = name;
+    event.category    = category;
+    event.block       = block;
+    event.start       = Microseconds(realStart);
+    event.duration    = Microseconds(realEnd) - event.start;
+    if ((cpuStart >= 0) && (cpuEnd >= cpuStart))
+    {
+        event.cpuStart    = cpuStart;
+        event.cpuDuration = cpuEnd - cpuStart;
+    }
+    else
+    {
+        event.cpuStart    = -1;
+        event.cpuDuration = -1;
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    event.thread = GetThreadId();
+    mEvents.push_back(event);
+}
+
+int Timeline::GetThreadId()
+{
+    auto i = mThreadIds.find(std::this_thread::get_id());
+    if (i != mThreadIds.end())
+        return i->second;
+
+    int id = int(mThreadNames.size());
+    mThreadIds[std::this_thread::get_id()] = id;
+    mThreadNames.push_back("Thread " + std::to_string(id));
+    return id;
+}
+
+POV_LONG Timeline::Microseconds(Clock::time_point t) const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(t - mStart).count();
+}
+
+void Timeline::Write(OStream& file)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    file.printf("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    file.printf("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"POV-Ray\"}}");
+    for (size_t i = 0; i < mThreadNames.size(); ++i)
+    {
+        file.printf(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                    int(i), mThreadNames[i].c_str());
+        // keep the phases on top, and the threads in order of appearance
+        file.printf(",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"sort_index\":%d}}",
+                    int(i), int(i));
+    }
+
+    for (const auto& event : mEvents)
+    {
+        file.printf(",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%lld,\"dur\":%lld",
+                    event.name, event.category, event.thread, (long long)event.start, (long long)event.duration);
+        if (event.cpuStart >= 0)
+            file.printf(",\"tts\":%lld,\"tdur\":%lld", (long long)event.cpuStart, (long long)event.cpuDuration);
+        if (event.block >= 0)
+            file.printf(",\"args\":{\"block\":%d}", event.block);
+        file.printf("}");
+    }
+
+    file.printf("\n]}\n");
+}
+
+}
+// end of namespace pov
@@ -0,0 +1,166 @@
+//******************************************************************************
+///
+/// @file backend/support/timeline.h
+///
+/// Declarations related to the recording of render activity timelines.
+///
+/// @copyright
+/// @parblock
+///
+/// Persistence of Vision Ray Tracer ('POV-Ray') version 3.8.
+/// Copyright 1991-2019 Persistence of Vision Raytracer Pty. Ltd.
+///
+/// POV-Ray is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU Affero General Public License as
+/// published by the Free Software Foundation, either version 3 of the
+/// License, or (at your option) any later version.
+///
+/// POV-Ray is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU Affero General Public License for more details.
+///
+/// You should have received a copy of the GNU Affero General Public License
+/// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+///
+/// ----------------------------------------------------------------------------
+///
+/// POV-Ray is based on the popular DKB raytracer version 2.12.
+/// DKBTrace was originally written by David K. Buck.
+/// DKBTrace Ver 2.0-2.12 were written by David K. Buck & Aaron A. Collins.
+///
+/// @endparblock
+///
+//******************************************************************************
+
+#ifndef POVRAY_BACKEND_TIMELINE_H
+#define POVRAY_BACKEND_TIMELINE_H
+
+// Module config header file must be the first file included within POV-Ray unit header files
+#include "backend/configbackend.h"
+#include "backend/support/timeline_fwd.h"
+
+// C++ variants of C standard header files
+//  (none at the moment)
+
+// C++ standard header files
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// POV-Ray header files (base module)
+#include "base/fileinputoutput_fwd.h"
+#include "base/types.h"
+
+namespace pov
+{
+
+using namespace pov_base;
+
+/// Record of when and where the work of a render was done.
+///
+/// A timeline collects spans of work (tasks, the blocks processed by them, and
+/// the phases made up of one or more tasks running in parallel), together with
+/// the thread that did the work and the CPU time that thread consumed in doing
+/// so. It can then be written out in the Chrome trace event format, to be
+/// inspected with tools such as `chrome://tracing` or Perfetto, which makes
+/// idle threads, serial phases and uneven distribution of work easy to spot.
+///
+/// All methods are thread-safe.
+///
+/// @note
+///     Names and categories are stored by pointer, and must therefore refer to
+///     strings with static storage duration (e.g. string literals).
+///
+class Timeline final
+{
+    public:
+
+        typedef std::chrono::steady_clock Clock;
+
+        /// Span of work done by the current thread.
+        ///
+        /// The span starts when the object is created, and is added to the
+        /// timeline when the object is destroyed. If no timeline is given,
+        /// the object does nothing at all.
+        ///
+        class Scope final
+        {
+            public:
+
+                /// @param  timeline    Timeline to record to, or `nullptr` to not record anything.
+                /// @param  category    Kind of work, e.g. `task` or `block`.
+                /// @param  name        Name of the work.
+                /// @param  block       Serial number of the block worked on, or -1 if not applicable.
+                Scope(Timeline* timeline, const char* category, const char* name, int block = -1);
+                ~Scope();
+
+                Scope(const Scope&) = delete;
+                Scope& operator=(const Scope&) = delete;
+
+            private:
+
+                Timeline*           mpTimeline;
+                const char*         mCategory;
+                const char*         mName;
+                int                 mBlock;
+                Clock::time_point   mRealStart;
+                POV_LONG            mCPUStart;
+        };
+
+        Timeline();
+
+        Timeline(const Timeline&) = delete;
+        Timeline& operator=(const Timeline&) = delete;
+
+        /// Give the current thread a name.
+        ///
+        /// The thread is recorded as a new one from this point on. Threads of
+        /// the same name are numbered consecutively in order of naming.
+        ///
+        void NameThread(const char* name);
+
+        /// Add a span of work not attributed to any particular thread.
+        void AddPhase(const char* name, Clock::time_point begin, Clock::time_point end);
+
+        /// Write the timeline as a Chrome trace event JSON file.
+        void Write(OStream& file);
+
+    private:
+
+        struct Event final
+        {
+            const char* name;
+            const char* category;
+            int         thread;
+            int         block;
+            POV_LONG    start;      ///< Real time since creation of the timeline, in microseconds.
+            POV_LONG    duration;   ///< Real time, in microseconds.
+            POV_LONG    cpuStart;   ///< CPU time of the thread, in microseconds, or -1 if unknown.
+            POV_LONG    cpuDuration;///< CPU time of the thread, in microseconds, or -1 if unknown.
+        };
+
+        std::mutex                      mMutex;
+        Clock::time_point               mStart;
+        std::vector<Event>              mEvents;
+        std::map<std::thread::id, int>  mThreadIds;
+        std::vector<std::string>        mThreadNames;
+        std::map<std::string, int>      mThreadNameCount;
+
+        void Add(const char* category, const char* name, int block,
+                 Clock::time_point realStart, Clock::time_point realEnd, POV_LONG cpuStart, POV_LONG cpuEnd);
+
+        /// Get the id of the current thread, assigning a new one if necessary.
+        /// @pre    The mutex is locked by the caller.
+        int GetThreadId();
+
+        POV_LONG Microseconds(Clock::time_point t) const;
+};
+
+}
+// end of namespace pov
+
+#endif // POVRAY_BACKEND_TIMELINE_H
@@ -776,6 +776,48 @@
     #define POV_USE_DEFAULT_DELETEFILE 1
 #endif
 
+/// @def POV_USE_DEFAULT_RENAMEFILE
+/// Whether to use a default implementation to rename a file.
+///
+/// Define as non-zero to use a default implementation for the @ref pov_base::Filesystem::RenameFile() method,
+/// or zero if the platform provides its own implementation.
+///
+/// @note
+///     The default implementation relies on `std::rename`, which replaces an existing target atomically
+///     on POSIX systems but may fail on others.
+///
+#ifndef POV_USE_DEFAULT_RENAMEFILE
+    #define POV_USE_DEFAULT_RENAMEFILE 1
+#endif
+
+/// @def POV_USE_DEFAULT_SYNCFILE
+/// Whether to use a default implementation to commit a file to storage.
+///
+/// Define as non-zero to use a default implementation for the @ref pov_base::Filesystem::SyncFile() method,
+/// or zero if the platform provides its own implementation.
+///
+/// @note
+///     The default implementation does nothing. Wherever possible, implementations should provide their own
+///     implementation.
+///
+#ifndef POV_USE_DEFAULT_SYNCFILE
+    #define POV_USE_DEFAULT_SYNCFILE 1
+#endif
+
+/// @def POV_USE_DEFAULT_GETFILESTATUS
+/// Whether to use a default implementation to get the status of a file.
+///
+/// Define as non-zero to use a default implementation for the @ref pov_base::Filesystem::GetFileStatus() method,
+/// or zero if the platform provides its own implementation.
+///
+/// @note
+///     The default implementation always fails, causing callers to fall back to examining the file's content.
+///     Wherever possible, implementations should provide their own implementation.
+///
+#ifndef POV_USE_DEFAULT_GETFILESTATUS
+    #define POV_USE_DEFAULT_GETFILESTATUS 1
+#endif
+
 /// @def POV_USE_DEFAULT_LARGEFILE
 /// Whether to use a default implementation for large file handling.
 ///
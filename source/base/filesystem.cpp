@@ -41,24 +41,19 @@
 #include "base/filesystem.h"
 
 // C++ variants of C standard header files
-#if POV_USE_DEFAULT_DELETEFILE
 #include <cstdio>
-#endif
 
 // C++ standard header files
+#include <atomic>
+#include <random>
 #if POV_USE_DEFAULT_LARGEFILE
 #include <fstream>
 #include <ios>
 #include <limits>
 #endif
-#if POV_USE_DEFAULT_TEMPORARYFILE
-#include <atomic>
-#endif
 
 // POV-Ray header files (base module)
-#if POV_USE_DEFAULT_DELETEFILE || POV_USE_DEFAULT_LARGEFILE || POV_USE_DEFAULT_TEMPORARYFILE
 #include "base/stringutilities.h"
-#endif
 
 // this must be the last file included
 #include "base/povdebug.h"
@@ -85,6 +80,39 @@ bool DeleteFile(const UCS2String& fileName)
 
 //******************************************************************************
 
+#if POV_USE_DEFAULT_RENAMEFILE
+
+bool RenameFile(const UCS2String& oldName, const UCS2String& newName)
+{
+    return (std::rename(UCS2toSysString(oldName).c_str(), UCS2toSysString(newName).c_str()) == 0);
+}
+
+#endif // POV_USE_DEFAULT_RENAMEFILE
+
+//******************************************************************************
+
+#if POV_USE_DEFAULT_SYNCFILE
+
+bool SyncFile(const UCS2String& fileName)
+{
+    return true;
+}
+
+#endif // POV_USE_DEFAULT_SYNCFILE
+
+//******************************************************************************
+
+#if POV_USE_DEFAULT_GETFILESTATUS
+
+bool GetFileStatus(const UCS2String& fileName, FileStatus& status)
+{
+    return false;
+}
+
+#endif // POV_USE_DEFAULT_GETFILESTATUS
+
+//******************************************************************************
+
 #if POV_USE_DEFAULT_LARGEFILE
 
 using Offset = std::streamoff;
@@ -184,6 +212,15 @@ void TemporaryFile::Delete()
     }
 }
 
+UCS2String TemporaryFile::SuggestNameFor(const UCS2String& fileName)
+{
+    static const unsigned int seed = std::random_device()();
+    static std::atomic<unsigned int> index(0);
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), ".%08x%08x.tmp", seed, index++);
+    return fileName + ASCIItoUCS2String(suffix);
+}
+
 #if POV_USE_DEFAULT_TEMPORARYFILE
 
 UCS2String TemporaryFile::SuggestName()
@@ -86,6 +86,65 @@ namespace Filesystem
 ///
 bool DeleteFile(const UCS2String& fileName);
 
+/// Rename file.
+///
+/// This function shall try to rename the specified file, replacing any existing
+/// file of the new name. Where the platform supports it, the replacement
+/// should be atomic, so that other processes see either the old or the new
+/// file but never a missing or incomplete one.
+///
+/// @note
+///     Both names should refer to the same volume.
+///
+/// @param  oldName     Name of the file to rename.
+/// @param  newName     New name of the file.
+/// @return             `true` if the file was renamed, `false` otherwise.
+///
+bool RenameFile(const UCS2String& oldName, const UCS2String& newName);
+
+/// Commit file to storage.
+///
+/// This function shall try to make sure that the contents of the specified
+/// file have actually been written to the storage device, rather than just
+/// handed to the operating system; to be used before a file replaces another
+/// via @ref RenameFile(), so that a system crash cannot leave an incomplete
+/// file behind in place of the original one.
+///
+/// @note
+///     The default implementation does nothing, as standard C++ provides no
+///     means to do this.
+///
+/// @param  fileName    Name of the file to commit; it should have been closed
+///                     or flushed already.
+/// @return             `true` if the file was committed, `false` otherwise.
+///
+bool SyncFile(const UCS2String& fileName);
+
+/// File status information, as obtained via @ref GetFileStatus().
+struct FileStatus final
+{
+    std::uint_least64_t size;               ///< Size of the file in bytes.
+    std::int_least64_t  modificationTime;   ///< Time of last modification, in platform-specific units.
+};
+
+/// Get file status.
+///
+/// This function shall try to determine the size and time of last modification
+/// of the specified file, without opening it. Modification times are only
+/// meaningful when compared to other modification times obtained from the same
+/// platform; implementations should use the finest resolution available, so
+/// that modifications in quick succession can be told apart.
+///
+/// @note
+///     The default implementation always fails, as standard C++ provides no
+///     means to do this.
+///
+/// @param[in]  fileName    Name of the file to examine.
+/// @param[out] status      Status of the file.
+/// @return                 `true` if the status was determined, `false` otherwise.
+///
+bool GetFileStatus(const UCS2String& fileName, FileStatus& status);
+
 /// Large file handling.
 ///
 /// This class provides basic random access to large (>2 GiB) files.
@@ -185,6 +244,15 @@ public:
     ///
     void Delete();
 
+    /// Suggest name for a temporary file to replace a given file.
+    ///
+    /// This method suggests a file name in the same location as the given
+    /// file, unique among concurrent writers, so that the file can be written
+    /// under that name first, and then be renamed to the given file via
+    /// @ref RenameFile() once complete.
+    ///
+    static UCS2String SuggestNameFor(const UCS2String& fileName);
+
 private:
 
     /// Suggest name for temporary file.
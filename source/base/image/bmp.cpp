@@ -467,10 +467,7 @@ void Write (OStream *file, const Image *image, const ImageWriteOptions& options)
     int             height = image->GetHeight();
     int             pad = (4 - ((width * 3) % 4)) & 0x03 ;
     bool            alpha = image->HasTransparency() && options.AlphaIsEnabled();
-    unsigned int    r ;
-    unsigned int    g ;
-    unsigned int    b ;
-    unsigned int    a ;
+    unsigned int    channels = alpha ? 4 : 3;
     GammaCurvePtr   gamma;
     DitherStrategy& dither = *options.ditherStrategy;
 
@@ -502,19 +499,21 @@ void Write (OStream *file, const Image *image, const ImageWriteOptions& options)
     Write_Long (file, 0) ;
     Write_Long (file, 0) ;
 
+    std::vector<unsigned int> values(width * channels);
     for (int y = height - 1 ; y >= 0 ; y--)
     {
+        if (alpha)
+            GetEncodedRGBARow (image, y, gamma, 255, values.data(), dither, premul);
+        else
+            GetEncodedRGBRow (image, y, gamma, 255, values.data(), dither) ;
         for (int x = 0 ; x < width ; x++)
         {
+            const unsigned int *pixel = &values[x * channels];
+            file->Write_Byte((unsigned char) pixel[2]);
+            file->Write_Byte((unsigned char) pixel[1]);
+            file->Write_Byte((unsigned char) pixel[0]);
             if (alpha)
-                GetEncodedRGBAValue (image, x, y, gamma, 255, r, g, b, a, dither, premul);
-            else
-                GetEncodedRGBValue (image, x, y, gamma, 255, r, g, b, dither) ;
-            file->Write_Byte((unsigned char) b);
-            file->Write_Byte((unsigned char) g);
-            file->Write_Byte((unsigned char) r);
-            if (alpha)
-                file->Write_Byte((unsigned char) a);
+                file->Write_Byte((unsigned char) pixel[3]);
         }
         if (!alpha)
             for (int i = 0 ; i < pad; i++)
@@ -37,10 +37,12 @@
 #include "base/image/colourspace.h"
 
 // C++ variants of C standard header files
-//  (none at the moment)
+#include <cstdint>
+#include <cstring>
 
 // C++ standard header files
 #include <algorithm>
+#include <atomic>
 
 // POV-Ray header files (base module)
 #include "base/povassert.h"
@@ -73,24 +75,77 @@ float* GammaCurve::GetLookupTable(unsigned int max)
     POV_COLOURSPACE_ASSERT(max == 255 || max == 65535); // shouldn't happen, but it won't hurt to check in debug versions
 
     // Get a reference to the lookup table pointer we're dealing with, so we don't need to duplicate all the remaining code.
-    float*& lookupTable = (max == 255 ? lookupTable8 : lookupTable16);
+    std::atomic<float*>& lookupTable = (max == 255 ? lookupTable8 : lookupTable16);
+
+    // Once created, the table never changes, so there is no need to lock the mutex to query it.
+    float* table = lookupTable.load(std::memory_order_acquire);
+    if (table)
+        return table;
 
     // Make sure we're not racing any other thread that might currently be busy creating the LUT.
     std::lock_guard<std::mutex> lock(lutMutex);
 
     // Create the LUT if it doesn't exist yet.
-    if (!lookupTable)
+    table = lookupTable.load(std::memory_order_relaxed);
+    if (!table)
     {
-        float* tempTable = new float[max+1];
+        table = new float[max+1];
         for (unsigned int i = 0; i <= max; i ++)
-            tempTable[i] = Decode(IntDecode(i, max));
+            table[i] = Decode(IntDecode(i, max));
 
         // hook up the table only as soon as it is completed, so that querying the table does not need to
         // care about thread-safety.
-        lookupTable = tempTable;
+        lookupTable.store(table, std::memory_order_release);
+    }
+
+    return table;
+}
+
+const float* GammaCurve::GetEncodingTables(unsigned int max)
+{
+    POV_COLOURSPACE_ASSERT(max == 255 || max == 65535); // shouldn't happen, but it won't hurt to check in debug versions
+
+    // The thresholds are derived from the decoding lookup table; get that first, as it is guarded by the same mutex.
+    const float* decoded = GetLookupTable(max);
+
+    float*& encodingTables = (max == 255 ? encodingTables8 : encodingTables16);
+
+    std::lock_guard<std::mutex> lock(lutMutex);
+
+    if (!encodingTables)
+    {
+        float* tempTables = new float[max * 2];
+
+        // Find each boundary by bisection, on the bit patterns of the (non-negative) floating-point values,
+        // which are ordered the same as the values themselves. This way the boundaries match the results of
+        // Encode() exactly, rather than those of Decode() (which may differ in the last bit).
+        std::uint32_t lower = 0;
+        for (unsigned int i = 1; i <= max; i ++)
+        {
+            std::uint32_t low = lower;
+            std::uint32_t high = 0x3F800000u; // 1.0f
+            while (low < high)
+            {
+                std::uint32_t middle = low + (high - low) / 2;
+                float x;
+                std::memcpy(&x, &middle, sizeof(x));
+                if (IntEncodeDown(Encode(x), max) >= i)
+                    high = middle;
+                else
+                    low = middle + 1;
+            }
+            std::memcpy(&tempTables[i - 1], &low, sizeof(float));
+            lower = low;
+        }
+
+        // NB: This must match the threshold computation in IntEncode() exactly.
+        for (unsigned int i = 0; i < max; i ++)
+            tempTables[max + i] = 0.5 * decoded[i] + 0.5 * decoded[i + 1];
+
+        encodingTables = tempTables;
     }
 
-    return lookupTable;
+    return encodingTables;
 }
 
 GammaCurvePtr GammaCurve::GetMatching(const GammaCurvePtr& newInstance)
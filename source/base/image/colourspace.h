@@ -44,6 +44,7 @@
 //  (none at the moment)
 
 // C++ standard header files
+#include <atomic>
 #include <list>
 #include <memory>
 #include <mutex>
@@ -119,6 +120,21 @@ class GammaCurve
         ///
         float* GetLookupTable(unsigned int max);
 
+        /// Retrieves tables for faster encoding.
+        ///
+        /// This feature is intended to be used for encoding entire rows of pixels to 8 or 16 bit depth without
+        /// evaluating the transfer function for each value. Two tables of `max` entries each are returned back to
+        /// back: First the encoding boundaries, entry `i` of which is the smallest value that Encode() maps to
+        /// `i+1` or higher when rounding down; then the quantization thresholds, entry `i` of which is the midpoint
+        /// between the decoded values of `i` and `i+1`, as used to round to the nearest encoded value.
+        ///
+        /// @note           The same lifetime restrictions apply as for @ref GetLookupTable().
+        ///
+        /// @param[in]  max The maximum encoded value; must be either 255 for 8-bit depth, or 65535 for 16-bit depth.
+        /// @return         Pointer to the tables, each in ascending order.
+        ///
+        const float* GetEncodingTables(unsigned int max);
+
         /// Convenience function to test whether a gamma curve pointer refers to a neutral curve.
         ///
         /// @param[in]  p   The gamma curve pointer to test.
@@ -291,25 +307,38 @@ class GammaCurve
         /// This member variable caches the pointer returned by a first call to `GetLookupTable(255)` to avoid creating
         /// multiple copies of the table.
         ///
-        float* lookupTable8;
+        std::atomic<float*> lookupTable8;
 
         /// Cached lookup table for 16-bit lookup.
         ///
         /// This member variable caches the pointer returned by a first call to `GetLookupTable(65535)` to avoid creating
         /// multiple copies of the table.
         ///
-        float* lookupTable16;
+        std::atomic<float*> lookupTable16;
+
+        /// Cached encoding tables for 8-bit encoding, as returned by `GetEncodingTables(255)`.
+        float* encodingTables8;
+
+        /// Cached encoding tables for 16-bit encoding, as returned by `GetEncodingTables(65535)`.
+        float* encodingTables16;
 
 #if POV_MULTITHREADED
-        /// Mutex to guard access to @ref lookupTable8 and @ref lookupTable16.
+        /// Mutex to guard creation of @ref lookupTable8 and @ref lookupTable16, and access to @ref encodingTables8
+        /// and @ref encodingTables16.
         std::mutex lutMutex;
 #endif
 
         /// Constructor.
-        GammaCurve() : lookupTable8(nullptr), lookupTable16(nullptr) {}
+        GammaCurve() : lookupTable8(nullptr), lookupTable16(nullptr), encodingTables8(nullptr), encodingTables16(nullptr) {}
 
         /// Destructor.
-        virtual ~GammaCurve() { if (lookupTable8) delete[] lookupTable8; if (lookupTable16) delete[] lookupTable16; }
+        virtual ~GammaCurve()
+        {
+            delete[] lookupTable8.load();
+            delete[] lookupTable16.load();
+            if (encodingTables8) delete[] encodingTables8;
+            if (encodingTables16) delete[] encodingTables16;
+        }
 
         /// Function to test whether two gamma curves match.
         ///
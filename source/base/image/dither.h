@@ -129,6 +129,13 @@ class DitherStrategy
         /// @param[in]  err     Linear quantization error (may or may not be relevant to the algorithm).
         ///
         virtual void SetError(unsigned int x, unsigned int y, const ColourOffset& err) {}
+
+        /// Whether the algorithm is stateless.
+        ///
+        /// A stateless algorithm does not depend on the processing order, and may be used to
+        /// quantize different parts of an image concurrently.
+        ///
+        virtual bool IsStateless() const { return false; }
 };
 
 struct DitherStrategy::ColourOffset final
@@ -180,6 +187,7 @@ class NoDither final : public DitherStrategy
 {
 public:
     virtual void GetOffset(unsigned int x, unsigned int y, ColourOffset& offLin, ColourOffset& offQnt) override;
+    virtual bool IsStateless() const override { return true; }
 };
 
 //-------------------------------------------------------------------------------
@@ -195,6 +203,7 @@ public:
     class Pattern;
     OrderedDither(const Pattern& matrix, unsigned int width, bool invertRB = false);
     virtual void GetOffset(unsigned int x, unsigned int y, ColourOffset& offLin, ColourOffset& offQnt) override;
+    virtual bool IsStateless() const override { return true; }
 protected:
     const Pattern& mPattern;
     unsigned int mImageWidth;
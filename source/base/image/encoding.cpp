@@ -42,6 +42,7 @@
 
 // C++ standard header files
 #include <algorithm>
+#include <vector>
 
 // POV-Ray header files (base module)
 #include "base/image/colourspace.h"
@@ -69,15 +70,19 @@ unsigned int IntEncode(const GammaCurvePtr& g, float x, unsigned int max, float
     if (GammaCurve::IsNeutral(g))
         return IntEncode(x, max, qOff, err);
 
+    // For the common bit depths, take the decoded values from the gamma curve's lookup table, so that the results
+    // are exactly the same as those of the row-wise encoding functions.
+    const float* lut = ((max == 255) || (max == 65535) ? g->GetLookupTable(max) : nullptr);
+
     float xEff = clip(x, 0.0f, 1.0f) + err;
     unsigned int v = IntEncodeDown(GammaCurve::Encode(g, xEff), max);
-    float decoded = IntDecode(g, v, max);
+    float decoded = (lut ? lut[v] : IntDecode(g, v, max));
     if (v >= max)
     {
         err = xEff - decoded;
         return v;
     }
-    float decodedUp = IntDecode(g, v + 1, max);
+    float decodedUp = (lut ? lut[v + 1] : IntDecode(g, v + 1, max));
     float threshold = (0.5 - qOff) * decoded + (0.5 + qOff) * decodedUp;
     if (xEff > threshold)
     {
@@ -247,33 +252,16 @@ void SetEncodedRGBValue(Image* img, unsigned int x, unsigned int y, const GammaC
     img->SetRGBValue(x, y, GammaCurve::Decode(g,col.red()), GammaCurve::Decode(g,col.green()), GammaCurve::Decode(g,col.blue()));
 }
 
-unsigned int GetEncodedGrayValue(const Image* img, unsigned int x, unsigned int y, const GammaCurvePtr& g, unsigned int max, DitherStrategy& dh)
-{
-    float fGray;
-    if (!img->IsPremultiplied() && img->HasTransparency())
-    {
-        // data has transparency and is stored non-premultiplied; precompose against a black background
-        float fAlpha;
-        img->GetGrayAValue(x, y, fGray, fAlpha);
-        AlphaPremultiply(fGray, fAlpha);
-    }
-    else
-    {
-        // no need to worry about premultiplication
-        fGray = img->GetGrayValue(x, y);
-    }
-    DitherStrategy::ColourOffset linOff, encOff;
-    dh.GetOffset(x,y,linOff,encOff);
-    unsigned int iGray = IntEncode(g, fGray, max, encOff.gray, linOff.gray);
-    dh.SetError(x,y,linOff);
-    return iGray;
-}
-void GetEncodedGrayAValue(const Image* img, unsigned int x, unsigned int y, const GammaCurvePtr& g, unsigned int max, unsigned int& gray, unsigned int& alpha, DitherStrategy& dh, bool premul)
+/// Prepare gray and alpha values of a pixel for encoding.
+///
+/// @param[in,out]  fGray           Gray value.
+/// @param[in,out]  fAlpha          Alpha value.
+/// @param[in]      doPremultiply   Whether premultiplication needs to be applied.
+/// @param[in]      doUnPremultiply Whether premultiplication needs to be undone.
+/// @param[in]      premul          Whether the data is to be encoded premultiplied.
+///
+static inline void PrepareEncodedGrayAValue(float& fGray, float& fAlpha, bool doPremultiply, bool doUnPremultiply, bool premul)
 {
-    bool doPremultiply   = premul && !img->IsPremultiplied() && img->HasTransparency(); // need to apply premultiplication if encoded data should be premul'ed but container content isn't
-    bool doUnPremultiply = !premul && img->IsPremultiplied() && img->HasTransparency(); // need to undo premultiplication if other way round
-    float fGray, fAlpha;
-    img->GetGrayAValue(x, y, fGray, fAlpha);
     if (doPremultiply)
     {
         AlphaPremultiply(fGray, fAlpha);
@@ -307,40 +295,20 @@ void GetEncodedGrayAValue(const Image* img, unsigned int x, unsigned int y, cons
         // No need for converting between premultiplied and un-premultiplied encoding.
     }
     // else no need to worry about premultiplication
-    DitherStrategy::ColourOffset linOff, encOff;
-    dh.GetOffset(x,y,linOff,encOff);
-    gray  = IntEncode(g, fGray,  max, encOff.gray,  linOff.gray);
-    alpha = IntEncode(   fAlpha, max, encOff.alpha, linOff.alpha);
-    dh.SetError(x,y,linOff);
-}
-void GetEncodedRGBValue(const Image* img, unsigned int x, unsigned int y, const GammaCurvePtr& g, unsigned int max, unsigned int& red, unsigned int& green, unsigned int& blue, DitherStrategy& dh)
-{
-    float fRed, fGreen, fBlue;
-    if (!img->IsPremultiplied() && img->HasTransparency())
-    {
-        float fAlpha;
-        // data has transparency and is stored non-premultiplied; precompose against a black background
-        img->GetRGBAValue(x, y, fRed, fGreen, fBlue, fAlpha);
-        AlphaPremultiply(fRed, fGreen, fBlue, fAlpha);
-    }
-    else
-    {
-        // no need to worry about premultiplication
-        img->GetRGBValue(x, y, fRed, fGreen, fBlue);
-    }
-    DitherStrategy::ColourOffset linOff, encOff;
-    dh.GetOffset(x,y,linOff,encOff);
-    red   = IntEncode(g, fRed,   max, encOff.red,   linOff.red);
-    green = IntEncode(g, fGreen, max, encOff.green, linOff.green);
-    blue  = IntEncode(g, fBlue,  max, encOff.blue,  linOff.blue);
-    dh.SetError(x,y,linOff);
 }
-void GetEncodedRGBAValue(const Image* img, unsigned int x, unsigned int y, const GammaCurvePtr& g, unsigned int max, unsigned int& red, unsigned int& green, unsigned int& blue, unsigned int& alpha, DitherStrategy& dh, bool premul)
+
+/// Prepare colour and alpha values of a pixel for encoding.
+///
+/// @param[in,out]  fRed            Red value.
+/// @param[in,out]  fGreen          Green value.
+/// @param[in,out]  fBlue           Blue value.
+/// @param[in,out]  fAlpha          Alpha value.
+/// @param[in]      doPremultiply   Whether premultiplication needs to be applied.
+/// @param[in]      doUnPremultiply Whether premultiplication needs to be undone.
+/// @param[in]      premul          Whether the data is to be encoded premultiplied.
+///
+static inline void PrepareEncodedRGBAValue(float& fRed, float& fGreen, float& fBlue, float& fAlpha, bool doPremultiply, bool doUnPremultiply, bool premul)
 {
-    bool doPremultiply   = premul && !img->IsPremultiplied() && img->HasTransparency(); // need to apply premultiplication if encoded data should be premul'ed but container content isn't
-    bool doUnPremultiply = !premul && img->IsPremultiplied() && img->HasTransparency(); // need to undo premultiplication if other way round
-    float fRed, fGreen, fBlue, fAlpha;
-    img->GetRGBAValue(x, y, fRed, fGreen, fBlue, fAlpha);
     if (doPremultiply)
     {
         // Data has been stored premultiplied, but should be encoded non-premultiplied.
@@ -381,6 +349,71 @@ void GetEncodedRGBAValue(const Image* img, unsigned int x, unsigned int y, const
         // No need for converting between premultiplied and un-premultiplied encoding.
     }
     // else no need to worry about premultiplication
+}
+
+unsigned int GetEncodedGrayValue(const Image* img, unsigned int x, unsigned int y, const GammaCurvePtr& g, unsigned int max, DitherStrategy& dh)
+{
+    float fGray;
+    if (!img->IsPremultiplied() && img->HasTransparency())
+    {
+        // data has transparency and is stored non-premultiplied; precompose against a black background
+        float fAlpha;
+        img->GetGrayAValue(x, y, fGray, fAlpha);
+        AlphaPremultiply(fGray, fAlpha);
+    }
+    else
+    {
+        // no need to worry about premultiplication
+        fGray = img->GetGrayValue(x, y);
+    }
+    DitherStrategy::ColourOffset linOff, encOff;
+    dh.GetOffset(x,y,linOff,encOff);
+    unsigned int iGray = IntEncode(g, fGray, max, encOff.gray, linOff.gray);
+    dh.SetError(x,y,linOff);
+    return iGray;
+}
+void GetEncodedGrayAValue(const Image* img, unsigned int x, unsigned int y, const GammaCurvePtr& g, unsigned int max, unsigned int& gray, unsigned int& alpha, DitherStrategy& dh, bool premul)
+{
+    bool doPremultiply   = premul && !img->IsPremultiplied() && img->HasTransparency(); // need to apply premultiplication if encoded data should be premul'ed but container content isn't
+    bool doUnPremultiply = !premul && img->IsPremultiplied() && img->HasTransparency(); // need to undo premultiplication if other way round
+    float fGray, fAlpha;
+    img->GetGrayAValue(x, y, fGray, fAlpha);
+    PrepareEncodedGrayAValue(fGray, fAlpha, doPremultiply, doUnPremultiply, premul);
+    DitherStrategy::ColourOffset linOff, encOff;
+    dh.GetOffset(x,y,linOff,encOff);
+    gray  = IntEncode(g, fGray,  max, encOff.gray,  linOff.gray);
+    alpha = IntEncode(   fAlpha, max, encOff.alpha, linOff.alpha);
+    dh.SetError(x,y,linOff);
+}
+void GetEncodedRGBValue(const Image* img, unsigned int x, unsigned int y, const GammaCurvePtr& g, unsigned int max, unsigned int& red, unsigned int& green, unsigned int& blue, DitherStrategy& dh)
+{
+    float fRed, fGreen, fBlue;
+    if (!img->IsPremultiplied() && img->HasTransparency())
+    {
+        float fAlpha;
+        // data has transparency and is stored non-premultiplied; precompose against a black background
+        img->GetRGBAValue(x, y, fRed, fGreen, fBlue, fAlpha);
+        AlphaPremultiply(fRed, fGreen, fBlue, fAlpha);
+    }
+    else
+    {
+        // no need to worry about premultiplication
+        img->GetRGBValue(x, y, fRed, fGreen, fBlue);
+    }
+    DitherStrategy::ColourOffset linOff, encOff;
+    dh.GetOffset(x,y,linOff,encOff);
+    red   = IntEncode(g, fRed,   max, encOff.red,   linOff.red);
+    green = IntEncode(g, fGreen, max, encOff.green, linOff.green);
+    blue  = IntEncode(g, fBlue,  max, encOff.blue,  linOff.blue);
+    dh.SetError(x,y,linOff);
+}
+void GetEncodedRGBAValue(const Image* img, unsigned int x, unsigned int y, const GammaCurvePtr& g, unsigned int max, unsigned int& red, unsigned int& green, unsigned int& blue, unsigned int& alpha, DitherStrategy& dh, bool premul)
+{
+    bool doPremultiply   = premul && !img->IsPremultiplied() && img->HasTransparency(); // need to apply premultiplication if encoded data should be premul'ed but container content isn't
+    bool doUnPremultiply = !premul && img->IsPremultiplied() && img->HasTransparency(); // need to undo premultiplication if other way round
+    float fRed, fGreen, fBlue, fAlpha;
+    img->GetRGBAValue(x, y, fRed, fGreen, fBlue, fAlpha);
+    PrepareEncodedRGBAValue(fRed, fGreen, fBlue, fAlpha, doPremultiply, doUnPremultiply, premul);
     DitherStrategy::ColourOffset linOff, encOff;
     dh.GetOffset(x,y,linOff,encOff);
     red   = IntEncode(g, fRed,   max, encOff.red,   linOff.red);
@@ -390,6 +423,237 @@ void GetEncodedRGBAValue(const Image* img, unsigned int x, unsigned int y, const
     dh.SetError(x,y,linOff);
 }
 
+/*******************************************************************************/
+
+/// Quantizer for encoding entire rows of pixels.
+///
+/// For 8 and 16 bit depth, this class uses the transfer function's lookup table to determine the
+/// decoded values of the quantization interval, instead of evaluating the transfer function twice
+/// per channel, while giving exactly the same results as @ref IntEncode().
+///
+class RowQuantizer final
+{
+    public:
+
+        RowQuantizer(const GammaCurvePtr& g, unsigned int max) :
+            mGamma(g), mMax(max), mLUT(nullptr), mTables(nullptr)
+        {
+            if (!GammaCurve::IsNeutral(g) && ((max == 255) || (max == 65535)))
+                mLUT = mGamma->GetLookupTable(max);
+        }
+
+        unsigned int Encode(float x, float qOff, float& err) const
+        {
+            if (mLUT == nullptr)
+                return IntEncode(mGamma, x, mMax, qOff, err);
+
+            float xEff = clip(x, 0.0f, 1.0f) + err;
+            unsigned int v = IntEncodeDown(GammaCurve::Encode(mGamma, xEff), mMax);
+            float decoded = mLUT[v];
+            if (v >= mMax)
+            {
+                err = xEff - decoded;
+                return v;
+            }
+            float decodedUp = mLUT[v + 1];
+            float threshold = (0.5 - qOff) * decoded + (0.5 + qOff) * decodedUp;
+            if (xEff > threshold)
+            {
+                decoded = decodedUp;
+                ++v;
+            }
+            err = xEff - decoded;
+            return v;
+        }
+
+        /// Encode consecutive values without dithering.
+        ///
+        /// This gives the same results as calling @ref Encode() for each value with neither
+        /// quantization offset nor error, but does not evaluate the transfer function at all.
+        /// Instead, the value rounded down is found by a branch-free binary search of the
+        /// transfer function's encoding boundaries, and then compared against the quantization
+        /// threshold, for a block of values at a time so that the compiler can vectorise it.
+        ///
+        void EncodeUndithered(const float* values, unsigned int* data, unsigned int count)
+        {
+            if (GammaCurve::IsNeutral(mGamma))
+            {
+                for (unsigned int i = 0; i < count; ++i)
+                    data[i] = IntEncodeDown(clip(values[i], 0.0f, 1.0f), mMax, 0.5f);
+            }
+            else if (mLUT != nullptr)
+            {
+                if (mTables == nullptr)
+                    mTables = mGamma->GetEncodingTables(mMax);
+                const float* boundaries = mTables;
+                const float* thresholds = mTables + mMax;
+                const unsigned int kBlockSize = 16;
+                float x[kBlockSize];
+                unsigned int v[kBlockSize];
+                for (unsigned int start = 0; start < count; start += kBlockSize)
+                {
+                    unsigned int n = min(kBlockSize, count - start);
+                    for (unsigned int i = 0; i < kBlockSize; ++i)
+                    {
+                        x[i] = (i < n ? clip(values[start + i], 0.0f, 1.0f) : 0.0f);
+                        v[i] = 0;
+                    }
+                    for (unsigned int step = (mMax + 1) / 2; step > 0; step /= 2)
+                    {
+                        for (unsigned int i = 0; i < kBlockSize; ++i)
+                            v[i] += (x[i] >= boundaries[v[i] + step - 1]) ? step : 0;
+                    }
+                    for (unsigned int i = 0; i < kBlockSize; ++i)
+                        v[i] += ((v[i] < mMax) && (x[i] > thresholds[min(v[i], mMax - 1)])) ? 1 : 0;
+                    std::copy(v, v + n, data + start);
+                }
+            }
+            else
+            {
+                for (unsigned int i = 0; i < count; ++i)
+                {
+                    float err = 0.0f;
+                    data[i] = IntEncode(mGamma, values[i], mMax, 0.0f, err);
+                }
+            }
+        }
+
+    private:
+
+        const GammaCurvePtr&    mGamma;
+        unsigned int            mMax;
+        const float*            mLUT;
+        const float*            mTables;
+};
+
+/// Test whether a dithering strategy leaves all values unchanged.
+static inline bool IsUndithered(const DitherStrategy& dh)
+{
+    return (dynamic_cast<const NoDither*>(&dh) != nullptr);
+}
+
+void GetEncodedGrayRow(const Image* img, unsigned int y, const GammaCurvePtr& g, unsigned int max, unsigned int* data, DitherStrategy& dh)
+{
+    unsigned int width = img->GetWidth();
+    // data has transparency and is stored non-premultiplied; precompose against a black background
+    bool doPremultiply = !img->IsPremultiplied() && img->HasTransparency();
+    RowQuantizer quantizer(g, max);
+    std::vector<float> row(width * 2);
+    img->GetGrayARow(0, y, width, row.data());
+    std::vector<float> values(width);
+    for (unsigned int x = 0; x < width; ++x)
+    {
+        values[x] = row[x * 2];
+        if (doPremultiply)
+            AlphaPremultiply(values[x], row[x * 2 + 1]);
+    }
+    if (IsUndithered(dh))
+    {
+        quantizer.EncodeUndithered(values.data(), data, width);
+        return;
+    }
+    for (unsigned int x = 0; x < width; ++x)
+    {
+        DitherStrategy::ColourOffset linOff, encOff;
+        dh.GetOffset(x,y,linOff,encOff);
+        data[x] = quantizer.Encode(values[x], encOff.gray, linOff.gray);
+        dh.SetError(x,y,linOff);
+    }
+}
+void GetEncodedGrayARow(const Image* img, unsigned int y, const GammaCurvePtr& g, unsigned int max, unsigned int* data, DitherStrategy& dh, bool premul)
+{
+    unsigned int width = img->GetWidth();
+    bool doPremultiply   = premul && !img->IsPremultiplied() && img->HasTransparency(); // need to apply premultiplication if encoded data should be premul'ed but container content isn't
+    bool doUnPremultiply = !premul && img->IsPremultiplied() && img->HasTransparency(); // need to undo premultiplication if other way round
+    RowQuantizer quantizer(g, max);
+    std::vector<float> row(width * 2);
+    img->GetGrayARow(0, y, width, row.data());
+    for (float* pixel = row.data(); pixel < row.data() + width * 2; pixel += 2)
+        PrepareEncodedGrayAValue(pixel[0], pixel[1], doPremultiply, doUnPremultiply, premul);
+    if (IsUndithered(dh))
+    {
+        // encode all channels as gray first, then re-do alpha, which is always linear
+        quantizer.EncodeUndithered(row.data(), data, width * 2);
+        for (unsigned int x = 0; x < width; ++x)
+            data[x * 2 + 1] = IntEncode(row[x * 2 + 1], max);
+        return;
+    }
+    const float* pixel = row.data();
+    for (unsigned int x = 0; x < width; ++x, pixel += 2, data += 2)
+    {
+        DitherStrategy::ColourOffset linOff, encOff;
+        dh.GetOffset(x,y,linOff,encOff);
+        data[0] = quantizer.Encode(pixel[0], encOff.gray, linOff.gray);
+        data[1] = IntEncode(pixel[1], max, encOff.alpha, linOff.alpha);
+        dh.SetError(x,y,linOff);
+    }
+}
+void GetEncodedRGBRow(const Image* img, unsigned int y, const GammaCurvePtr& g, unsigned int max, unsigned int* data, DitherStrategy& dh)
+{
+    unsigned int width = img->GetWidth();
+    // data has transparency and is stored non-premultiplied; precompose against a black background
+    bool doPremultiply = !img->IsPremultiplied() && img->HasTransparency();
+    RowQuantizer quantizer(g, max);
+    std::vector<float> row(width * 4);
+    img->GetRGBARow(0, y, width, row.data());
+    std::vector<float> values(width * 3);
+    for (unsigned int x = 0; x < width; ++x)
+    {
+        float* value = &values[x * 3];
+        const float* pixel = &row[x * 4];
+        value[0] = pixel[0];
+        value[1] = pixel[1];
+        value[2] = pixel[2];
+        if (doPremultiply)
+            AlphaPremultiply(value[0], value[1], value[2], pixel[3]);
+    }
+    if (IsUndithered(dh))
+    {
+        quantizer.EncodeUndithered(values.data(), data, width * 3);
+        return;
+    }
+    const float* value = values.data();
+    for (unsigned int x = 0; x < width; ++x, value += 3, data += 3)
+    {
+        DitherStrategy::ColourOffset linOff, encOff;
+        dh.GetOffset(x,y,linOff,encOff);
+        data[0] = quantizer.Encode(value[0], encOff.red,   linOff.red);
+        data[1] = quantizer.Encode(value[1], encOff.green, linOff.green);
+        data[2] = quantizer.Encode(value[2], encOff.blue,  linOff.blue);
+        dh.SetError(x,y,linOff);
+    }
+}
+void GetEncodedRGBARow(const Image* img, unsigned int y, const GammaCurvePtr& g, unsigned int max, unsigned int* data, DitherStrategy& dh, bool premul)
+{
+    unsigned int width = img->GetWidth();
+    bool doPremultiply   = premul && !img->IsPremultiplied() && img->HasTransparency(); // need to apply premultiplication if encoded data should be premul'ed but container content isn't
+    bool doUnPremultiply = !premul && img->IsPremultiplied() && img->HasTransparency(); // need to undo premultiplication if other way round
+    RowQuantizer quantizer(g, max);
+    std::vector<float> row(width * 4);
+    img->GetRGBARow(0, y, width, row.data());
+    for (float* pixel = row.data(); pixel < row.data() + width * 4; pixel += 4)
+        PrepareEncodedRGBAValue(pixel[0], pixel[1], pixel[2], pixel[3], doPremultiply, doUnPremultiply, premul);
+    if (IsUndithered(dh))
+    {
+        // encode all channels as colour first, then re-do alpha, which is always linear
+        quantizer.EncodeUndithered(row.data(), data, width * 4);
+        for (unsigned int x = 0; x < width; ++x)
+            data[x * 4 + 3] = IntEncode(row[x * 4 + 3], max);
+        return;
+    }
+    const float* pixel = row.data();
+    for (unsigned int x = 0; x < width; ++x, pixel += 4, data += 4)
+    {
+        DitherStrategy::ColourOffset linOff, encOff;
+        dh.GetOffset(x,y,linOff,encOff);
+        data[0] = quantizer.Encode(pixel[0], encOff.red,   linOff.red);
+        data[1] = quantizer.Encode(pixel[1], encOff.green, linOff.green);
+        data[2] = quantizer.Encode(pixel[2], encOff.blue,  linOff.blue);
+        data[3] = IntEncode(pixel[3], max, encOff.alpha, linOff.alpha);
+        dh.SetError(x,y,linOff);
+    }
+}
+
 float GetEncodedGrayValue(const Image* img, unsigned int x, unsigned int y, const GammaCurvePtr& g)
 {
     float fGray;
@@ -294,6 +294,65 @@ void GetEncodedRGBValue(const Image* img, unsigned int x, unsigned int y, const
 void GetEncodedRGBAValue(const Image* img, unsigned int x, unsigned int y, const GammaCurvePtr&, float& red, float& green, float& blue, float& alpha, bool premul = false);
 void GetEncodedRGBValue(const Image* img, unsigned int x, unsigned int y, const GammaCurvePtr&, RGBColour& rgb);
 
+/// @}
+///
+//*****************************************************************************
+///
+/// @name Row-Wise Convenience Encoding (Quantization)
+///
+/// The following functions are provided as a convenience for image file encoding (quantization)
+/// of an entire row at a time. They give the same results as calling the corresponding per-pixel
+/// functions for each pixel of the row from left to right, but fetch the pixels from the image in
+/// bulk, and avoid evaluating the transfer function (gamma curve) more than once per channel.
+///
+/// @{
+
+/// Encode a row of an image as grayscale.
+///
+/// @param[in]      img     Image to encode.
+/// @param[in]      y       Row to encode.
+/// @param[in]      g       Transfer function (gamma curve) to use.
+/// @param[in]      max     Encoded value representing 1.0.
+/// @param[out]     data    Buffer to receive the encoded values (1 per pixel).
+/// @param[in,out]  dh      Dithering strategy to use.
+///
+void GetEncodedGrayRow(const Image* img, unsigned int y, const GammaCurvePtr& g, unsigned int max, unsigned int* data, DitherStrategy& dh);
+
+/// Encode a row of an image as grayscale with alpha.
+///
+/// @param[in]      img     Image to encode.
+/// @param[in]      y       Row to encode.
+/// @param[in]      g       Transfer function (gamma curve) to use.
+/// @param[in]      max     Encoded value representing 1.0.
+/// @param[out]     data    Buffer to receive the encoded values, interleaved (2 per pixel).
+/// @param[in,out]  dh      Dithering strategy to use.
+/// @param[in]      premul  Whether to encode with premultiplied alpha.
+///
+void GetEncodedGrayARow(const Image* img, unsigned int y, const GammaCurvePtr& g, unsigned int max, unsigned int* data, DitherStrategy& dh, bool premul = false);
+
+/// Encode a row of an image as colour.
+///
+/// @param[in]      img     Image to encode.
+/// @param[in]      y       Row to encode.
+/// @param[in]      g       Transfer function (gamma curve) to use.
+/// @param[in]      max     Encoded value representing 1.0.
+/// @param[out]     data    Buffer to receive the encoded values, interleaved (3 per pixel).
+/// @param[in,out]  dh      Dithering strategy to use.
+///
+void GetEncodedRGBRow(const Image* img, unsigned int y, const GammaCurvePtr& g, unsigned int max, unsigned int* data, DitherStrategy& dh);
+
+/// Encode a row of an image as colour with alpha.
+///
+/// @param[in]      img     Image to encode.
+/// @param[in]      y       Row to encode.
+/// @param[in]      g       Transfer function (gamma curve) to use.
+/// @param[in]      max     Encoded value representing 1.0.
+/// @param[out]     data    Buffer to receive the encoded values, interleaved (4 per pixel).
+/// @param[in,out]  dh      Dithering strategy to use.
+/// @param[in]      premul  Whether to encode with premultiplied alpha.
+///
+void GetEncodedRGBARow(const Image* img, unsigned int y, const GammaCurvePtr& g, unsigned int max, unsigned int* data, DitherStrategy& dh, bool premul = false);
+
 /// @}
 ///
 //*****************************************************************************
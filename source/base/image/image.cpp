@@ -40,7 +40,7 @@
 #include <cstdint>
 
 // C++ standard header files
-//  (none at the moment)
+#include <mutex>
 
 // POSIX standard header files
 // TODO FIXME - Any POSIX-specific stuff should be considered platform-specific.
@@ -97,7 +97,8 @@ ImageWriteOptions::ImageWriteOptions() :
     alphaMode(ImageAlphaMode::None),
     bitsPerChannel(8),
     compression(-1),
-    grayscale(false)
+    grayscale(false),
+    threads(1)
 {}
 
 GammaCurvePtr ImageWriteOptions::GetTranscodingGammaCurve(GammaCurvePtr defaultEncodingGamma) const
@@ -108,6 +109,31 @@ GammaCurvePtr ImageWriteOptions::GetTranscodingGammaCurve(GammaCurvePtr defaultE
         return TranscodingGammaCurve::Get(workingGamma, defaultEncodingGamma);
 }
 
+/// Get gray and alpha values of consecutive pixels in a row, one pixel at a time.
+///
+/// This implements @ref Image::GetGrayARow() for containers that have no faster way to access a row
+/// than pixel by pixel. As the containers are final classes, the per-pixel accessor is resolved
+/// statically rather than called virtually.
+///
+template<class IMAGE>
+static inline void GetGrayARowByPixel(const IMAGE& image, unsigned int x, unsigned int y, unsigned int count, float* data)
+{
+    for (unsigned int i = 0; i < count; ++i, data += 2)
+        image.GetGrayAValue(x + i, y, data[0], data[1]);
+}
+
+/// Get colour and alpha values of consecutive pixels in a row, one pixel at a time.
+///
+/// This implements @ref Image::GetRGBARow() for containers that have no faster way to access a row
+/// than pixel by pixel; see @ref GetGrayARowByPixel().
+///
+template<class IMAGE>
+static inline void GetRGBARowByPixel(const IMAGE& image, unsigned int x, unsigned int y, unsigned int count, float* data)
+{
+    for (unsigned int i = 0; i < count; ++i, data += 4)
+        image.GetRGBAValue(x + i, y, data[0], data[1], data[2], data[3]);
+}
+
 template<class Allocator = allocator<bool>>
 class BitMapImage final : public Image
 {
@@ -930,6 +956,15 @@ class GrayImage final : public Image
             return (unsigned char)(int(pixels[x + y * size_t(width)]) / ((TMAX + 1) >> 8));
         }
 
+        virtual void GetGrayARow(unsigned int x, unsigned int y, unsigned int count, float* data) const override
+        {
+            GetGrayARowByPixel(*this, x, y, count, data);
+        }
+        virtual void GetRGBARow(unsigned int x, unsigned int y, unsigned int count, float* data) const override
+        {
+            GetRGBARowByPixel(*this, x, y, count, data);
+        }
+
         virtual void SetBitValue(unsigned int x, unsigned int y, bool bit) override
         {
             if(bit == true)
@@ -1151,6 +1186,15 @@ class GrayAImage final : public Image
             RGBFTColour::AtoFT(alpha, filter, transm);
         }
 
+        virtual void GetGrayARow(unsigned int x, unsigned int y, unsigned int count, float* data) const override
+        {
+            GetGrayARowByPixel(*this, x, y, count, data);
+        }
+        virtual void GetRGBARow(unsigned int x, unsigned int y, unsigned int count, float* data) const override
+        {
+            GetRGBARowByPixel(*this, x, y, count, data);
+        }
+
         virtual void SetBitValue(unsigned int x, unsigned int y, bool bit) override
         {
             if(bit == true)
@@ -1379,6 +1423,15 @@ class RGBImage final : public Image
             filter = transm = FT_OPAQUE;
         }
 
+        virtual void GetGrayARow(unsigned int x, unsigned int y, unsigned int count, float* data) const override
+        {
+            GetGrayARowByPixel(*this, x, y, count, data);
+        }
+        virtual void GetRGBARow(unsigned int x, unsigned int y, unsigned int count, float* data) const override
+        {
+            GetRGBARowByPixel(*this, x, y, count, data);
+        }
+
         virtual void SetBitValue(unsigned int x, unsigned int y, bool bit) override
         {
             if(bit == true)
@@ -1631,6 +1684,15 @@ class RGBAImage final : public Image
             RGBFTColour::AtoFT(alpha, filter, transm);
         }
 
+        virtual void GetGrayARow(unsigned int x, unsigned int y, unsigned int count, float* data) const override
+        {
+            GetGrayARowByPixel(*this, x, y, count, data);
+        }
+        virtual void GetRGBARow(unsigned int x, unsigned int y, unsigned int count, float* data) const override
+        {
+            GetRGBARowByPixel(*this, x, y, count, data);
+        }
+
         virtual void SetBitValue(unsigned int x, unsigned int y, bool bit) override
         {
             if(bit == true)
@@ -1889,6 +1951,33 @@ class RGBFTImage final : public Image
             transm = pixels[(x + y * size_t(width)) * 5 + 4];
         }
 
+        virtual void GetGrayARow(unsigned int x, unsigned int y, unsigned int count, float* data) const override
+        {
+            if (count == 0)
+                return;
+            CHECK_BOUNDS(x + count - 1, y);
+            const float* pixel = &pixels[(x + y * size_t(width)) * 5];
+            for (unsigned int i = 0; i < count; ++i, pixel += 5, data += 2)
+            {
+                data[0] = RGB2Gray(pixel[0], pixel[1], pixel[2]);
+                data[1] = RGBFTColour::FTtoA(pixel[3], pixel[4]);
+            }
+        }
+        virtual void GetRGBARow(unsigned int x, unsigned int y, unsigned int count, float* data) const override
+        {
+            if (count == 0)
+                return;
+            CHECK_BOUNDS(x + count - 1, y);
+            const float* pixel = &pixels[(x + y * size_t(width)) * 5];
+            for (unsigned int i = 0; i < count; ++i, pixel += 5, data += 4)
+            {
+                data[0] = pixel[0];
+                data[1] = pixel[1];
+                data[2] = pixel[2];
+                data[3] = RGBFTColour::FTtoA(pixel[3], pixel[4]);
+            }
+        }
+
         virtual void SetBitValue(unsigned int x, unsigned int y, bool bit) override
         {
             if(bit == true)
@@ -1945,6 +2034,21 @@ class RGBFTImage final : public Image
         {
             SetRGBFTValue(x, y, col.red(), col.green(), col.blue(), FT_OPAQUE, col.transm());
         }
+        virtual void SetRGBTRow(unsigned int x, unsigned int y, unsigned int count, const RGBTColour* data) override
+        {
+            if (count == 0)
+                return;
+            CHECK_BOUNDS(x + count - 1, y);
+            float* pixel = &pixels[(x + y * size_t(width)) * 5];
+            for (unsigned int i = 0; i < count; ++i, pixel += 5)
+            {
+                pixel[0] = data[i].red();
+                pixel[1] = data[i].green();
+                pixel[2] = data[i].blue();
+                pixel[3] = FT_OPAQUE;
+                pixel[4] = data[i].transm();
+            }
+        }
         virtual void SetRGBFTValue(unsigned int x, unsigned int y, float red, float green, float blue, float filter, float transm) override
         {
             CHECK_BOUNDS(x, y);
@@ -2034,6 +2138,480 @@ class RGBFTImage final : public Image
 
 typedef RGBFTImage<> MemoryRGBFTImage;
 
+template<class Allocator = allocator<float>>
+class GrayFloatImage final : public Image
+{
+    public:
+        GrayFloatImage(unsigned int w, unsigned int h) :
+            Image(w, h, ImageDataType::Gray_Float) { pixels.resize(SafeUnsignedProduct<size_t>(w, h)); FillBitValue(false); }
+        GrayFloatImage(unsigned int w, unsigned int h, const vector<RGBMapEntry>& m) :
+            Image(w, h, ImageDataType::Gray_Float, m) { pixels.resize(SafeUnsignedProduct<size_t>(w, h)); FillBitValue(false); }
+        GrayFloatImage(unsigned int w, unsigned int h, const vector<RGBAMapEntry>& m) :
+            Image(w, h, ImageDataType::Gray_Float, m) { pixels.resize(SafeUnsignedProduct<size_t>(w, h)); FillBitValue(false); }
+        GrayFloatImage(unsigned int w, unsigned int h, const vector<RGBFTMapEntry>& m) :
+            Image(w, h, ImageDataType::Gray_Float, m) { pixels.resize(SafeUnsignedProduct<size_t>(w, h)); FillBitValue(false); }
+        virtual ~GrayFloatImage() override { }
+
+        virtual bool IsOpaque() const override
+        {
+            return true;
+        }
+        virtual bool IsGrayscale() const override
+        {
+            return true;
+        }
+        virtual bool IsColour() const override
+        {
+            return false;
+        }
+        virtual bool IsFloat() const override
+        {
+            return true;
+        }
+        virtual bool IsInt() const override
+        {
+            return false;
+        }
+        virtual bool IsIndexed() const override
+        {
+            return false;
+        }
+        virtual bool IsGammaEncoded() const override
+        {
+            return false;
+        }
+        virtual bool HasAlphaChannel() const override
+        {
+            return false;
+        }
+        virtual bool HasFilterTransmit() const override
+        {
+            return false;
+        }
+        virtual unsigned int GetMaxIntValue() const override
+        {
+            return 255;
+        }
+        virtual bool TryDeferDecoding(GammaCurvePtr&, unsigned int) override
+        {
+            return false;
+        }
+
+        virtual bool GetBitValue(unsigned int x, unsigned int y) const override
+        {
+            return IS_NONZERO_RGB(GetGrayValue(x, y), 0.0f, 0.0f);
+        }
+        virtual float GetGrayValue(unsigned int x, unsigned int y) const override
+        {
+            CHECK_BOUNDS(x, y);
+            return pixels[x + y * size_t(width)];
+        }
+        virtual void GetGrayAValue(unsigned int x, unsigned int y, float& gray, float& alpha) const override
+        {
+            gray = GetGrayValue(x, y);
+            alpha = ALPHA_OPAQUE;
+        }
+        virtual void GetRGBValue(unsigned int x, unsigned int y, float& red, float& green, float& blue) const override
+        {
+            red = green = blue = GetGrayValue(x, y);
+        }
+        virtual void GetRGBAValue(unsigned int x, unsigned int y, float& red, float& green, float& blue, float& alpha) const override
+        {
+            red = green = blue = GetGrayValue(x, y);
+            alpha = ALPHA_OPAQUE;
+        }
+        virtual void GetRGBTValue(unsigned int x, unsigned int y, float& red, float& green, float& blue, float& transm) const override
+        {
+            red = green = blue = GetGrayValue(x, y);
+            transm = FT_OPAQUE;
+        }
+        virtual void GetRGBFTValue(unsigned int x, unsigned int y, float& red, float& green, float& blue, float& filter, float& transm) const override
+        {
+            red = green = blue = GetGrayValue(x, y);
+            filter = transm = FT_OPAQUE;
+        }
+
+        virtual void GetGrayARow(unsigned int x, unsigned int y, unsigned int count, float* data) const override
+        {
+            if (count == 0)
+                return;
+            CHECK_BOUNDS(x + count - 1, y);
+            const float* pixel = &pixels[x + y * size_t(width)];
+            for (unsigned int i = 0; i < count; ++i, data += 2)
+            {
+                data[0] = pixel[i];
+                data[1] = ALPHA_OPAQUE;
+            }
+        }
+        virtual void GetRGBARow(unsigned int x, unsigned int y, unsigned int count, float* data) const override
+        {
+            if (count == 0)
+                return;
+            CHECK_BOUNDS(x + count - 1, y);
+            const float* pixel = &pixels[x + y * size_t(width)];
+            for (unsigned int i = 0; i < count; ++i, data += 4)
+            {
+                data[0] = data[1] = data[2] = pixel[i];
+                data[3] = ALPHA_OPAQUE;
+            }
+        }
+
+        virtual void SetBitValue(unsigned int x, unsigned int y, bool bit) override
+        {
+            SetGrayValue(x, y, bit ? 1.0f : 0.0f);
+        }
+        virtual void SetGrayValue(unsigned int x, unsigned int y, float gray) override
+        {
+            CHECK_BOUNDS(x, y);
+            pixels[x + y * size_t(width)] = gray;
+        }
+        virtual void SetGrayValue(unsigned int x, unsigned int y, unsigned int gray) override
+        {
+            SetGrayValue(x, y, float(gray) / 255.0f);
+        }
+        virtual void SetGrayAValue(unsigned int x, unsigned int y, float gray, float) override
+        {
+            SetGrayValue(x, y, gray);
+        }
+        virtual void SetGrayAValue(unsigned int x, unsigned int y, unsigned int gray, unsigned int) override
+        {
+            SetGrayValue(x, y, gray);
+        }
+        virtual void SetRGBValue(unsigned int x, unsigned int y, float red, float green, float blue) override
+        {
+            SetGrayValue(x, y, RGB2Gray(red, green, blue));
+        }
+        virtual void SetRGBValue(unsigned int x, unsigned int y, unsigned int red, unsigned int green, unsigned int blue) override
+        {
+            SetRGBValue(x, y, float(red) / 255.0f, float(green) / 255.0f, float(blue) / 255.0f);
+        }
+        virtual void SetRGBAValue(unsigned int x, unsigned int y, float red, float green, float blue, float) override
+        {
+            SetRGBValue(x, y, red, green, blue);
+        }
+        virtual void SetRGBAValue(unsigned int x, unsigned int y, unsigned int red, unsigned int green, unsigned int blue, unsigned int) override
+        {
+            SetRGBValue(x, y, red, green, blue);
+        }
+        virtual void SetRGBTValue(unsigned int x, unsigned int y, float red, float green, float blue, float) override
+        {
+            SetRGBValue(x, y, red, green, blue);
+        }
+        virtual void SetRGBTValue(unsigned int x, unsigned int y, const RGBTColour& col) override
+        {
+            SetRGBValue(x, y, col.red(), col.green(), col.blue());
+        }
+        virtual void SetRGBFTValue(unsigned int x, unsigned int y, float red, float green, float blue, float, float) override
+        {
+            SetRGBValue(x, y, red, green, blue);
+        }
+        virtual void SetRGBFTValue(unsigned int x, unsigned int y, const RGBFTColour& col) override
+        {
+            SetRGBValue(x, y, col.red(), col.green(), col.blue());
+        }
+
+        virtual void FillBitValue(bool bit) override
+        {
+            FillGrayValue(bit ? 1.0f : 0.0f);
+        }
+        virtual void FillGrayValue(float gray) override
+        {
+            std::fill(pixels.begin(), pixels.end(), gray);
+        }
+        virtual void FillGrayValue(unsigned int gray) override
+        {
+            FillGrayValue(float(gray) / 255.0f);
+        }
+        virtual void FillGrayAValue(float gray, float) override
+        {
+            FillGrayValue(gray);
+        }
+        virtual void FillGrayAValue(unsigned int gray, unsigned int) override
+        {
+            FillGrayValue(gray);
+        }
+        virtual void FillRGBValue(float red, float green, float blue) override
+        {
+            FillGrayValue(RGB2Gray(red, green, blue));
+        }
+        virtual void FillRGBValue(unsigned int red, unsigned int green, unsigned int blue) override
+        {
+            FillRGBValue(float(red) / 255.0f, float(green) / 255.0f, float(blue) / 255.0f);
+        }
+        virtual void FillRGBAValue(float red, float green, float blue, float) override
+        {
+            FillRGBValue(red, green, blue);
+        }
+        virtual void FillRGBAValue(unsigned int red, unsigned int green, unsigned int blue, unsigned int) override
+        {
+            FillRGBValue(red, green, blue);
+        }
+        virtual void FillRGBTValue(float red, float green, float blue, float) override
+        {
+            FillRGBValue(red, green, blue);
+        }
+        virtual void FillRGBFTValue(float red, float green, float blue, float, float) override
+        {
+            FillRGBValue(red, green, blue);
+        }
+    private:
+        vector<float, Allocator> pixels;
+};
+
+typedef GrayFloatImage<> MemoryGrayFloatImage;
+
+template<class Allocator = allocator<float>>
+class RGBFloatImage final : public Image
+{
+    public:
+        RGBFloatImage(unsigned int w, unsigned int h) :
+            Image(w, h, ImageDataType::RGB_Float) { pixels.resize(SafeUnsignedProduct<size_t>(w, h, 3u)); FillBitValue(false); }
+        RGBFloatImage(unsigned int w, unsigned int h, const vector<RGBMapEntry>& m) :
+            Image(w, h, ImageDataType::RGB_Float, m) { pixels.resize(SafeUnsignedProduct<size_t>(w, h, 3u)); FillBitValue(false); }
+        RGBFloatImage(unsigned int w, unsigned int h, const vector<RGBAMapEntry>& m) :
+            Image(w, h, ImageDataType::RGB_Float, m) { pixels.resize(SafeUnsignedProduct<size_t>(w, h, 3u)); FillBitValue(false); }
+        RGBFloatImage(unsigned int w, unsigned int h, const vector<RGBFTMapEntry>& m) :
+            Image(w, h, ImageDataType::RGB_Float, m) { pixels.resize(SafeUnsignedProduct<size_t>(w, h, 3u)); FillBitValue(false); }
+        virtual ~RGBFloatImage() override { }
+
+        virtual bool IsOpaque() const override
+        {
+            return true;
+        }
+        virtual bool IsGrayscale() const override
+        {
+            return false;
+        }
+        virtual bool IsColour() const override
+        {
+            return true;
+        }
+        virtual bool IsFloat() const override
+        {
+            return true;
+        }
+        virtual bool IsInt() const override
+        {
+            return false;
+        }
+        virtual bool IsIndexed() const override
+        {
+            return false;
+        }
+        virtual bool IsGammaEncoded() const override
+        {
+            return false;
+        }
+        virtual bool HasAlphaChannel() const override
+        {
+            return false;
+        }
+        virtual bool HasFilterTransmit() const override
+        {
+            return false;
+        }
+        virtual unsigned int GetMaxIntValue() const override
+        {
+            return 255;
+        }
+        virtual bool TryDeferDecoding(GammaCurvePtr&, unsigned int) override
+        {
+            return false;
+        }
+
+        virtual bool GetBitValue(unsigned int x, unsigned int y) const override
+        {
+            float red, green, blue;
+            GetRGBValue(x, y, red, green, blue);
+            return IS_NONZERO_RGB(red, green, blue);
+        }
+        virtual float GetGrayValue(unsigned int x, unsigned int y) const override
+        {
+            float red, green, blue;
+            GetRGBValue(x, y, red, green, blue);
+            return RGB2Gray(red, green, blue);
+        }
+        virtual void GetGrayAValue(unsigned int x, unsigned int y, float& gray, float& alpha) const override
+        {
+            gray = GetGrayValue(x, y);
+            alpha = ALPHA_OPAQUE;
+        }
+        virtual void GetRGBValue(unsigned int x, unsigned int y, float& red, float& green, float& blue) const override
+        {
+            CHECK_BOUNDS(x, y);
+            red   = pixels[(x + y * size_t(width)) * 3];
+            green = pixels[(x + y * size_t(width)) * 3 + 1];
+            blue  = pixels[(x + y * size_t(width)) * 3 + 2];
+        }
+        virtual void GetRGBAValue(unsigned int x, unsigned int y, float& red, float& green, float& blue, float& alpha) const override
+        {
+            GetRGBValue(x, y, red, green, blue);
+            alpha = ALPHA_OPAQUE;
+        }
+        virtual void GetRGBTValue(unsigned int x, unsigned int y, float& red, float& green, float& blue, float& transm) const override
+        {
+            GetRGBValue(x, y, red, green, blue);
+            transm = FT_OPAQUE;
+        }
+        virtual void GetRGBFTValue(unsigned int x, unsigned int y, float& red, float& green, float& blue, float& filter, float& transm) const override
+        {
+            GetRGBValue(x, y, red, green, blue);
+            filter = transm = FT_OPAQUE;
+        }
+
+        virtual void GetGrayARow(unsigned int x, unsigned int y, unsigned int count, float* data) const override
+        {
+            if (count == 0)
+                return;
+            CHECK_BOUNDS(x + count - 1, y);
+            const float* pixel = &pixels[(x + y * size_t(width)) * 3];
+            for (unsigned int i = 0; i < count; ++i, pixel += 3, data += 2)
+            {
+                data[0] = RGB2Gray(pixel[0], pixel[1], pixel[2]);
+                data[1] = ALPHA_OPAQUE;
+            }
+        }
+        virtual void GetRGBARow(unsigned int x, unsigned int y, unsigned int count, float* data) const override
+        {
+            if (count == 0)
+                return;
+            CHECK_BOUNDS(x + count - 1, y);
+            const float* pixel = &pixels[(x + y * size_t(width)) * 3];
+            for (unsigned int i = 0; i < count; ++i, pixel += 3, data += 4)
+            {
+                data[0] = pixel[0];
+                data[1] = pixel[1];
+                data[2] = pixel[2];
+                data[3] = ALPHA_OPAQUE;
+            }
+        }
+
+        virtual void SetBitValue(unsigned int x, unsigned int y, bool bit) override
+        {
+            SetGrayValue(x, y, bit ? 1.0f : 0.0f);
+        }
+        virtual void SetGrayValue(unsigned int x, unsigned int y, float gray) override
+        {
+            SetRGBValue(x, y, gray, gray, gray);
+        }
+        virtual void SetGrayValue(unsigned int x, unsigned int y, unsigned int gray) override
+        {
+            SetGrayValue(x, y, float(gray) / 255.0f);
+        }
+        virtual void SetGrayAValue(unsigned int x, unsigned int y, float gray, float) override
+        {
+            SetGrayValue(x, y, gray);
+        }
+        virtual void SetGrayAValue(unsigned int x, unsigned int y, unsigned int gray, unsigned int) override
+        {
+            SetGrayValue(x, y, gray);
+        }
+        virtual void SetRGBValue(unsigned int x, unsigned int y, float red, float green, float blue) override
+        {
+            CHECK_BOUNDS(x, y);
+            pixels[(x + y * size_t(width)) * 3]     = red;
+            pixels[(x + y * size_t(width)) * 3 + 1] = green;
+            pixels[(x + y * size_t(width)) * 3 + 2] = blue;
+        }
+        virtual void SetRGBValue(unsigned int x, unsigned int y, unsigned int red, unsigned int green, unsigned int blue) override
+        {
+            SetRGBValue(x, y, float(red) / 255.0f, float(green) / 255.0f, float(blue) / 255.0f);
+        }
+        virtual void SetRGBAValue(unsigned int x, unsigned int y, float red, float green, float blue, float) override
+        {
+            SetRGBValue(x, y, red, green, blue);
+        }
+        virtual void SetRGBAValue(unsigned int x, unsigned int y, unsigned int red, unsigned int green, unsigned int blue, unsigned int) override
+        {
+            SetRGBValue(x, y, red, green, blue);
+        }
+        virtual void SetRGBTValue(unsigned int x, unsigned int y, float red, float green, float blue, float) override
+        {
+            SetRGBValue(x, y, red, green, blue);
+        }
+        virtual void SetRGBTValue(unsigned int x, unsigned int y, const RGBTColour& col) override
+        {
+            SetRGBValue(x, y, col.red(), col.green(), col.blue());
+        }
+        virtual void SetRGBTRow(unsigned int x, unsigned int y, unsigned int count, const RGBTColour* data) override
+        {
+            if (count == 0)
+                return;
+            CHECK_BOUNDS(x + count - 1, y);
+            float* pixel = &pixels[(x + y * size_t(width)) * 3];
+            for (unsigned int i = 0; i < count; ++i, pixel += 3)
+            {
+                pixel[0] = data[i].red();
+                pixel[1] = data[i].green();
+                pixel[2] = data[i].blue();
+            }
+        }
+        virtual void SetRGBFTValue(unsigned int x, unsigned int y, float red, float green, float blue, float, float) override
+        {
+            SetRGBValue(x, y, red, green, blue);
+        }
+        virtual void SetRGBFTValue(unsigned int x, unsigned int y, const RGBFTColour& col) override
+        {
+            SetRGBValue(x, y, col.red(), col.green(), col.blue());
+        }
+
+        virtual void FillBitValue(bool bit) override
+        {
+            FillGrayValue(bit ? 1.0f : 0.0f);
+        }
+        virtual void FillGrayValue(float gray) override
+        {
+            FillRGBValue(gray, gray, gray);
+        }
+        virtual void FillGrayValue(unsigned int gray) override
+        {
+            FillGrayValue(float(gray) / 255.0f);
+        }
+        virtual void FillGrayAValue(float gray, float) override
+        {
+            FillGrayValue(gray);
+        }
+        virtual void FillGrayAValue(unsigned int gray, unsigned int) override
+        {
+            FillGrayValue(gray);
+        }
+        virtual void FillRGBValue(float red, float green, float blue) override
+        {
+            for(typename vector<float, Allocator>::iterator i(pixels.begin()); i != pixels.end(); i++)
+            {
+                *i = red;
+                i++;
+                *i = green;
+                i++;
+                *i = blue;
+            }
+        }
+        virtual void FillRGBValue(unsigned int red, unsigned int green, unsigned int blue) override
+        {
+            FillRGBValue(float(red) / 255.0f, float(green) / 255.0f, float(blue) / 255.0f);
+        }
+        virtual void FillRGBAValue(float red, float green, float blue, float) override
+        {
+            FillRGBValue(red, green, blue);
+        }
+        virtual void FillRGBAValue(unsigned int red, unsigned int green, unsigned int blue, unsigned int) override
+        {
+            FillRGBValue(red, green, blue);
+        }
+        virtual void FillRGBTValue(float red, float green, float blue, float) override
+        {
+            FillRGBValue(red, green, blue);
+        }
+        virtual void FillRGBFTValue(float red, float green, float blue, float, float) override
+        {
+            FillRGBValue(red, green, blue);
+        }
+    private:
+        vector<float, Allocator> pixels;
+};
+
+typedef RGBFloatImage<> MemoryRGBFloatImage;
+
 template<typename T, unsigned int TMAX, ImageDataType IDT, class Allocator = allocator<T>>
 class NonlinearGrayImage final : public Image
 {
@@ -2138,6 +2716,15 @@ class NonlinearGrayImage final : public Image
             return (unsigned char)(int(pixels[x + y * size_t(width)]) / ((TMAX + 1) >> 8));
         }
 
+        virtual void GetGrayARow(unsigned int x, unsigned int y, unsigned int count, float* data) const override
+        {
+            GetGrayARowByPixel(*this, x, y, count, data);
+        }
+        virtual void GetRGBARow(unsigned int x, unsigned int y, unsigned int count, float* data) const override
+        {
+            GetRGBARowByPixel(*this, x, y, count, data);
+        }
+
         virtual void SetBitValue(unsigned int x, unsigned int y, bool bit) override
         {
             if(bit == true)
@@ -2365,6 +2952,15 @@ class NonlinearGrayAImage final : public Image
             RGBFTColour::AtoFT(alpha, filter, transm);
         }
 
+        virtual void GetGrayARow(unsigned int x, unsigned int y, unsigned int count, float* data) const override
+        {
+            GetGrayARowByPixel(*this, x, y, count, data);
+        }
+        virtual void GetRGBARow(unsigned int x, unsigned int y, unsigned int count, float* data) const override
+        {
+            GetRGBARowByPixel(*this, x, y, count, data);
+        }
+
         virtual void SetBitValue(unsigned int x, unsigned int y, bool bit) override
         {
             if(bit == true)
@@ -2603,6 +3199,15 @@ class NonlinearRGBImage final : public Image
             filter = transm = FT_OPAQUE;
         }
 
+        virtual void GetGrayARow(unsigned int x, unsigned int y, unsigned int count, float* data) const override
+        {
+            GetGrayARowByPixel(*this, x, y, count, data);
+        }
+        virtual void GetRGBARow(unsigned int x, unsigned int y, unsigned int count, float* data) const override
+        {
+            GetRGBARowByPixel(*this, x, y, count, data);
+        }
+
         virtual void SetBitValue(unsigned int x, unsigned int y, bool bit) override
         {
             if(bit == true)
@@ -2861,6 +3466,15 @@ class NonlinearRGBAImage final : public Image
             RGBFTColour::AtoFT(alpha, filter, transm);
         }
 
+        virtual void GetGrayARow(unsigned int x, unsigned int y, unsigned int count, float* data) const override
+        {
+            GetGrayARowByPixel(*this, x, y, count, data);
+        }
+        virtual void GetRGBARow(unsigned int x, unsigned int y, unsigned int count, float* data) const override
+        {
+            GetRGBARowByPixel(*this, x, y, count, data);
+        }
+
         virtual void SetBitValue(unsigned int x, unsigned int y, bool bit) override
         {
             if(bit == true)
@@ -3021,6 +3635,8 @@ typedef NonlinearRGBAImage<unsigned short, 65535, ImageDataType::RGBA_Gamma16> M
 // Measurement about the small read cache (compared to the alternative) show no significant delta in performance
 // to read the contained data into a PNG.
 // (it's a linear read, the system is able to anticipate it, so we are fine!)
+// All access is serialized, as the seek position and block buffer are shared between reads and
+// writes, and the image may be encoded by other threads while the render is still writing to it.
 class FileBackedPixelContainer
 {
     public:
@@ -3130,17 +3746,20 @@ class FileBackedPixelContainer
 
         void Flush(void)
         {
+            std::lock_guard<std::recursive_mutex> lock(m_Mutex);
             WriteCurrentBlock();
         }
 
         void SetPixel(size_type x, size_type y, const pixel_type& pixel)
         {
+            std::lock_guard<std::recursive_mutex> lock(m_Mutex);
             WritePixel(x, y, pixel);
             NextPixel();
         }
 
         void SetPixel(size_type x, size_type y, float red, float green, float blue, float filter, float transm)
         {
+            std::lock_guard<std::recursive_mutex> lock(m_Mutex);
             pixel_type pixel;
 
             pixel[RED] = red;
@@ -3153,18 +3772,21 @@ class FileBackedPixelContainer
 
         void SetPixel(float red, float green, float blue, float filter, float transm)
         {
+            std::lock_guard<std::recursive_mutex> lock(m_Mutex);
             SetPixel(m_xPos, m_yPos, red, green, blue, filter, transm);
             NextPixel();
         }
 
         void GetPixel(pixel_type& pixel)
         {
+            std::lock_guard<std::recursive_mutex> lock(m_Mutex);
             ReadPixel(m_xPos, m_yPos, pixel);
             NextPixel();
         }
 
         void GetPixel(float& red, float& green, float& blue, float& filter, float& transm)
         {
+            std::lock_guard<std::recursive_mutex> lock(m_Mutex);
             pixel_type pixel;
 
             GetPixel(pixel);    // advances NextPixel
@@ -3177,12 +3799,14 @@ class FileBackedPixelContainer
 
         void GetPixel(size_type x, size_type y, pixel_type& pixel)
         {
+            std::lock_guard<std::recursive_mutex> lock(m_Mutex);
             SetPos(x, y);
             ReadPixel(x, y, pixel);
         }
 
         void GetPixel(size_type x, size_type y, float& red, float& green, float& blue, float& filter, float& transm)
         {
+            std::lock_guard<std::recursive_mutex> lock(m_Mutex);
             pixel_type pixel;
 
             GetPixel(x, y, pixel);  // sets Position
@@ -3193,6 +3817,21 @@ class FileBackedPixelContainer
             transm = pixel[TRANSM];
         }
 
+        void GetPixels(size_type x, size_type y, size_type count, pixel_type* data)
+        {
+            std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+            SetPos(x, y);
+            for (size_type i = 0; i < count; i++)
+                ReadPixel(x + i, y, data[i]);
+        }
+
+        void SetPixels(size_type x, size_type y, size_type count, const pixel_type* data)
+        {
+            std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+            for (size_type i = 0; i < count; i++)
+                WritePixel(x + i, y, data[i]);
+        }
+
         /* void ClearCache(const pixel_type& pixel = pixel_type())
         {
             for (int i = 0; i < m_Width; i++)
@@ -3201,6 +3840,7 @@ class FileBackedPixelContainer
 
         void FillLine(size_type y, const pixel_type& pixel)
         {
+            std::lock_guard<std::recursive_mutex> lock(m_Mutex);
             // bool notBlank(pixel != 0.0);
 
             for (size_type x = 0; x < m_Width; x++)
@@ -3210,12 +3850,14 @@ class FileBackedPixelContainer
 
         void Fill(const pixel_type& pixel)
         {
+            std::lock_guard<std::recursive_mutex> lock(m_Mutex);
             for (size_type y = 0; y < m_Height; y++)
                 FillLine(y, pixel);
         }
 
         void Fill(float red, float green, float blue, float filter, float transm)
         {
+            std::lock_guard<std::recursive_mutex> lock(m_Mutex);
             pixel_type pixel(red, green, blue, filter, transm);
             Fill(pixel);
         }
@@ -3232,6 +3874,7 @@ class FileBackedPixelContainer
         UCS2String          m_Path;
         //vector<bool>        m_Committed;
         vector<pixel_type>  m_Buffer;
+        std::recursive_mutex m_Mutex;
 
         void SetPos(size_type x, size_type y, bool cache = true)
         {
@@ -3384,6 +4027,35 @@ class FileRGBFTImage final : public Image
             pixels.GetPixel(x, y, red, green, blue, filter, transm);
         }
 
+        virtual void GetGrayARow(unsigned int x, unsigned int y, unsigned int count, float* data) const override
+        {
+            if (count == 0)
+                return;
+            CHECK_BOUNDS(x + count - 1, y);
+            vector<pixel_type> row(count);
+            pixels.GetPixels(x, y, count, row.data());
+            for (const pixel_type& pixel : row)
+            {
+                *data++ = RGB2Gray(pixel[FileBackedPixelContainer::RED], pixel[FileBackedPixelContainer::GREEN], pixel[FileBackedPixelContainer::BLUE]);
+                *data++ = RGBFTColour::FTtoA(pixel[FileBackedPixelContainer::FILTER], pixel[FileBackedPixelContainer::TRANSM]);
+            }
+        }
+        virtual void GetRGBARow(unsigned int x, unsigned int y, unsigned int count, float* data) const override
+        {
+            if (count == 0)
+                return;
+            CHECK_BOUNDS(x + count - 1, y);
+            vector<pixel_type> row(count);
+            pixels.GetPixels(x, y, count, row.data());
+            for (const pixel_type& pixel : row)
+            {
+                *data++ = pixel[FileBackedPixelContainer::RED];
+                *data++ = pixel[FileBackedPixelContainer::GREEN];
+                *data++ = pixel[FileBackedPixelContainer::BLUE];
+                *data++ = RGBFTColour::FTtoA(pixel[FileBackedPixelContainer::FILTER], pixel[FileBackedPixelContainer::TRANSM]);
+            }
+        }
+
         virtual void SetBitValue(unsigned int x, unsigned int y, bool bit) override
         {
             if(bit == true)
@@ -3444,6 +4116,14 @@ class FileRGBFTImage final : public Image
         {
             SetRGBFTValue(x, y, col.red(), col.green(), col.blue(), FT_OPAQUE, col.transm());
         }
+        virtual void SetRGBTRow(unsigned int x, unsigned int y, unsigned int count, const RGBTColour* data) override
+        {
+            if (count == 0)
+                return;
+            CHECK_BOUNDS(x + count - 1, y);
+            vector<pixel_type> row(data, data + count);
+            pixels.SetPixels(x, y, count, row.data());
+        }
         virtual void SetRGBFTValue(unsigned int x, unsigned int y, float red, float green, float blue, float filter, float transm) override
         {
             CHECK_BOUNDS(x, y);
@@ -3647,6 +4327,10 @@ Image *Image::Create(unsigned int w, unsigned int h, ImageDataType t, unsigned i
                     if (SafeUnsignedProduct<POV_ULONG>(w, h, sizeof(FileRGBFTImage::pixel_type)) / 1048576 > maxRAMmbHint)
                         return new FileRGBFTImage(w, h, pixelsPerBlockHint);
                 return new MemoryRGBFTImage(w, h);
+            case ImageDataType::Gray_Float:
+                return new MemoryGrayFloatImage(w, h);
+            case ImageDataType::RGB_Float:
+                return new MemoryRGBFloatImage(w, h);
             case ImageDataType::RGB_Gamma8:
                 return new MemoryNonlinearRGB8Image(w, h);
             case ImageDataType::RGB_Gamma16:
@@ -3703,6 +4387,10 @@ Image *Image::Create(unsigned int w, unsigned int h, ImageDataType t, bool allow
                     return new RGBFTImage<FILE_MAPPED_IMAGE_ALLOCATOR<float>>(w, h);
 #endif
                 return new MemoryRGBFTImage(w, h);
+            case ImageDataType::Gray_Float:
+                return new MemoryGrayFloatImage(w, h);
+            case ImageDataType::RGB_Float:
+                return new MemoryRGBFloatImage(w, h);
             case ImageDataType::RGB_Gamma8:
                 return new MemoryNonlinearRGB8Image(w, h);
             case ImageDataType::RGB_Gamma16:
@@ -3761,6 +4449,10 @@ Image *Image::Create(unsigned int w, unsigned int h, ImageDataType t, const vect
                     return new RGBFTImage<FILE_MAPPED_IMAGE_ALLOCATOR<float>>(w, h, m);
 #endif
                 return new MemoryRGBFTImage(w, h, m);
+            case ImageDataType::Gray_Float:
+                return new MemoryGrayFloatImage(w, h, m);
+            case ImageDataType::RGB_Float:
+                return new MemoryRGBFloatImage(w, h, m);
             case ImageDataType::RGB_Gamma8:
                 return new MemoryNonlinearRGB8Image(w, h, m);
             case ImageDataType::RGB_Gamma16:
@@ -3819,6 +4511,10 @@ Image *Image::Create(unsigned int w, unsigned int h, ImageDataType t, const vect
                     return new RGBFTImage<FILE_MAPPED_RGBFT_IMAGE_ALLOCATOR<float>>(w, h, m);
 #endif
                 return new MemoryRGBFTImage(w, h, m);
+            case ImageDataType::Gray_Float:
+                return new MemoryGrayFloatImage(w, h, m);
+            case ImageDataType::RGB_Float:
+                return new MemoryRGBFloatImage(w, h, m);
             case ImageDataType::RGB_Gamma8:
                 return new MemoryNonlinearRGB8Image(w, h, m);
             case ImageDataType::RGB_Gamma16:
@@ -3877,6 +4573,10 @@ Image *Image::Create(unsigned int w, unsigned int h, ImageDataType t, const vect
                     return new RGBFTImage<FILE_MAPPED_IMAGE_ALLOCATOR<float>>(w, h, m);
 #endif
                 return new MemoryRGBFTImage(w, h, m);
+            case ImageDataType::Gray_Float:
+                return new MemoryGrayFloatImage(w, h, m);
+            case ImageDataType::RGB_Float:
+                return new MemoryRGBFloatImage(w, h, m);
             case ImageDataType::RGB_Gamma8:
                 return new MemoryNonlinearRGB8Image(w, h, m);
             case ImageDataType::RGB_Gamma16:
@@ -4063,6 +4763,10 @@ following built-in formats: TGA, PPM, BMP.");
             Netpbm::Write(file, image, options);
             break;
 
+        case PFM:
+            Netpbm::WritePFM(file, image, options);
+            break;
+
         case BMP:
             Bmp::Write(file, image, options);
             break;
@@ -4365,6 +5069,24 @@ void Image::GetRGBFTValue(unsigned int x, unsigned int y, RGBFTColour& colour, b
     }
 }
 
+void Image::GetGrayARow(unsigned int x, unsigned int y, unsigned int count, float* data) const
+{
+    for (unsigned int i = 0; i < count; ++i, data += 2)
+        GetGrayAValue(x + i, y, data[0], data[1]);
+}
+
+void Image::GetRGBARow(unsigned int x, unsigned int y, unsigned int count, float* data) const
+{
+    for (unsigned int i = 0; i < count; ++i, data += 4)
+        GetRGBAValue(x + i, y, data[0], data[1], data[2], data[3]);
+}
+
+void Image::SetRGBTRow(unsigned int x, unsigned int y, unsigned int count, const RGBTColour* data)
+{
+    for (unsigned int i = 0; i < count; ++i)
+        SetRGBTValue(x + i, y, data[i]);
+}
+
 unsigned int Image::GetColourMapSize() const
 {
     return colormap.size();
@@ -87,6 +87,8 @@ enum class ImageDataType : int
     Gray_Gamma16,   ///< Single-channel (grayscale) image using 16-bit gamma encoding.
     GrayA_Gamma8,   ///< Dual-channel (grayscale and alpha) image using 8-bit gamma greyscale encoding and 8-bit linear alpha encoding.
     GrayA_Gamma16,  ///< Dual-channel (grayscale and alpha) image using 16-bit gamma greyscale encoding and 16-bit linear alpha encoding.
+    Gray_Float,     ///< Single-channel (grayscale) image using single-precision floating-point encoding.
+    RGB_Float,      ///< 3-channel (colour) image using single-precision floating-point encoding.
 };
 
 /// The mode to use for alpha handling.
@@ -188,6 +190,12 @@ struct ImageWriteOptions final
     ///     in POV-Ray.
     bool grayscale : 1;
 
+    /// Number of threads to encode with.
+    /// @note
+    ///     This setting is ignored with file formats for which POV-Ray does not implement
+    ///     multi-threaded encoding.
+    unsigned int threads;
+
     ImageWriteOptions();
 
     inline bool AlphaIsEnabled() const
@@ -279,7 +287,8 @@ class Image
             TIFF,
             BMP,
             EXR,
-            HDR
+            HDR,
+            PFM
         };
 
         virtual ~Image() { }
@@ -415,6 +424,42 @@ class Image
         void GetRGBTValue(unsigned int x, unsigned int y, RGBTColour& colour, bool premul = false) const;
         void GetRGBFTValue(unsigned int x, unsigned int y, RGBFTColour& colour, bool premul = false) const;
 
+        /// Get grayscale and alpha values of consecutive pixels in a row.
+        ///
+        /// This is equivalent to calling @ref GetGrayAValue() for each pixel, but avoids the overhead
+        /// of a virtual call per pixel in containers overriding it.
+        ///
+        /// @param[in]  x       Horizontal position of the first pixel.
+        /// @param[in]  y       Row.
+        /// @param[in]  count   Number of pixels.
+        /// @param[out] data    Buffer to receive the gray and alpha values, interleaved (2 per pixel).
+        ///
+        virtual void GetGrayARow(unsigned int x, unsigned int y, unsigned int count, float* data) const;
+
+        /// Get colour and alpha values of consecutive pixels in a row.
+        ///
+        /// This is equivalent to calling @ref GetRGBAValue() for each pixel, but avoids the overhead
+        /// of a virtual call per pixel in containers overriding it.
+        ///
+        /// @param[in]  x       Horizontal position of the first pixel.
+        /// @param[in]  y       Row.
+        /// @param[in]  count   Number of pixels.
+        /// @param[out] data    Buffer to receive the red, green, blue and alpha values, interleaved (4 per pixel).
+        ///
+        virtual void GetRGBARow(unsigned int x, unsigned int y, unsigned int count, float* data) const;
+
+        /// Set colour and transmit values of consecutive pixels in a row.
+        ///
+        /// This is equivalent to calling @ref SetRGBTValue() for each pixel, but avoids the overhead
+        /// of a virtual call per pixel in containers overriding it.
+        ///
+        /// @param[in]  x       Horizontal position of the first pixel.
+        /// @param[in]  y       Row.
+        /// @param[in]  count   Number of pixels.
+        /// @param[in]  data    Colours to set.
+        ///
+        virtual void SetRGBTRow(unsigned int x, unsigned int y, unsigned int count, const RGBTColour* data);
+
         virtual void FillBitValue(bool bit) = 0;
         virtual void FillGrayValue(float gray) = 0;
         virtual void FillGrayValue(unsigned int gray) = 0;
@@ -50,6 +50,7 @@
 // C++ standard header files
 #include <memory>
 #include <string>
+#include <vector>
 
 // Make sure we can later identify whether JPEGlib wants `TRUE` and `FALSE` to be macros.
 #undef TRUE
@@ -515,25 +516,16 @@ void Write (OStream *file, const Image *image, const ImageWriteOptions& options)
     jpeg_write_marker(&writebuf.cinfo, JPEG_COM, pcom,comment.length());
 
     // write image row by row
+    std::vector<unsigned int> values(width * writebuf.cinfo.input_components);
     for (int row = 0; row < height; row++)
     {
         JSAMPLE *sample = writebuf.row_pointer[0];
         if (writebuf.cinfo.input_components == 3) // 24-bit rgb image
-        {
-            for (int col = 0; col < width; col++)
-            {
-                unsigned int r, g, b;
-                GetEncodedRGBValue(image, col, row, gamma, MAXJSAMPLE, r, g, b, *dither);
-                *sample++ = (JSAMPLE) r;
-                *sample++ = (JSAMPLE) g;
-                *sample++ = (JSAMPLE) b;
-            }
-        }
+            GetEncodedRGBRow(image, row, gamma, MAXJSAMPLE, values.data(), *dither);
         else if (writebuf.cinfo.input_components == 1) // 8-bit grayscale image
-        {
-            for (int col = 0; col < width; col++)
-                *sample++ = (JSAMPLE) GetEncodedGrayValue(image, col, row, gamma, MAXJSAMPLE, *dither);
-        }
+            GetEncodedGrayRow(image, row, gamma, MAXJSAMPLE, values.data(), *dither);
+        for (unsigned int value : values)
+            *sample++ = (JSAMPLE) value;
         jpeg_write_scanlines(&writebuf.cinfo, writebuf.row_pointer, 1);
     }
 
@@ -42,11 +42,14 @@
 //  (none at the moment)
 
 // C++ standard header files
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <vector>
 
 // Other 3rd party header files
 #include <ImfRgbaFile.h>
+#include <ImfTiledRgbaFile.h>
 #include <ImfStringAttribute.h>
 #include <ImfMatrixAttribute.h>
 #include <ImfArray.h>
@@ -158,6 +161,42 @@ class POV_EXR_IStream final : public Imf::IStream
 * Implementation
 ******************************************************************************/
 
+static RgbaChannels GetChannels(const ImageWriteOptions& options, bool use_alpha)
+{
+    if (options.grayscale)
+        if (use_alpha)
+            return WRITE_YA; // only write luminance & alpha
+        else
+            return WRITE_Y; // only write luminance
+    else
+        if (use_alpha)
+            return WRITE_RGBA; // write RGB & alpha
+        else
+            return WRITE_RGB; // write RGB
+}
+
+static void SetMetadata(Header& hdr)
+{
+    Metadata meta;
+    std::string comments;
+    if (!meta.getComment1().empty())
+        comments += meta.getComment1() + "\n";
+    if (!meta.getComment2().empty())
+        comments += meta.getComment2() + "\n";
+    if (!meta.getComment3().empty())
+        comments += meta.getComment3() + "\n";
+    if (!meta.getComment4().empty())
+        comments += meta.getComment4() + "\n";
+
+    if (!comments.empty())
+        hdr.insert("comments",StringAttribute(comments));
+
+    std::string software= meta.getSoftware();
+    std::string datetime= meta.getDateTime();
+    hdr.insert("software",StringAttribute(software));
+    hdr.insert("creation",StringAttribute(datetime));
+}
+
 Image *Read(IStream *file, const ImageReadOptions& options)
 {
     unsigned int width;
@@ -249,38 +288,8 @@ void Write(OStream *file, const Image *image, const ImageWriteOptions& options)
     POV_EXR_OStream os(*file);
     try
     {
-        Imf::RgbaChannels channels;
-        if (options.grayscale)
-            if (use_alpha)
-                channels = WRITE_YA; // only write luminance & alpha
-            else
-                channels = WRITE_Y; // only write luminance
-        else
-            if (use_alpha)
-                channels = WRITE_RGBA; // write RGB & alpha
-            else
-                channels = WRITE_RGB; // write RGB
-
-        Metadata meta;
-        std::string comments;
-        if (!meta.getComment1().empty())
-            comments += meta.getComment1() + "\n";
-        if (!meta.getComment2().empty())
-            comments += meta.getComment2() + "\n";
-        if (!meta.getComment3().empty())
-            comments += meta.getComment3() + "\n";
-        if (!meta.getComment4().empty())
-            comments += meta.getComment4() + "\n";
-
-        if (!comments.empty())
-            hdr.insert("comments",StringAttribute(comments));
-
-        std::string software= meta.getSoftware();
-        std::string datetime= meta.getDateTime();
-        hdr.insert("software",StringAttribute(software));
-        hdr.insert("creation",StringAttribute(datetime));
-
-        RgbaOutputFile rof(os, hdr, channels);
+        SetMetadata(hdr);
+        RgbaOutputFile rof(os, hdr, GetChannels(options, use_alpha));
         rof.setFrameBuffer(pixels.get(), 1, width);
         rof.writePixels(height);
     }
@@ -290,6 +299,97 @@ void Write(OStream *file, const Image *image, const ImageWriteOptions& options)
     }
 }
 
+struct TiledWriter::Impl final
+{
+    Impl(pov_base::OStream& file) : stream(file) {}
+
+    POV_EXR_OStream                         stream;
+    std::unique_ptr<TiledRgbaOutputFile>    output;
+    std::vector<Rgba>                       pixels;
+    GammaCurvePtr                           gamma;
+    unsigned int                            width;
+    unsigned int                            height;
+    unsigned int                            tileSize;
+    bool                                    premul;
+    bool                                    alpha;
+};
+
+TiledWriter::TiledWriter(OStream *file, unsigned int width, unsigned int height, unsigned int tileSize, const ImageWriteOptions& options) :
+    mpImpl(new Impl(*file))
+{
+    mpImpl->width    = width;
+    mpImpl->height   = height;
+    mpImpl->tileSize = tileSize;
+    mpImpl->pixels.resize(tileSize * tileSize);
+    mpImpl->alpha    = options.AlphaIsEnabled();
+
+    // Same conventions as for non-tiled output.
+    mpImpl->gamma    = TranscodingGammaCurve::Get(options.workingGamma, NeutralGammaCurve::Get());
+    mpImpl->premul   = options.AlphaIsPremultiplied(true);
+
+    // Tiles are written to the file in whatever order they arrive; any other line order would
+    // have the library buffer them until they can be written in that order.
+    float pixelAspect = 1.0;
+    Header hdr(width, height, pixelAspect, Imath::V2f(0, 0), 1.0, RANDOM_Y, ZIP_COMPRESSION);
+    try
+    {
+        SetMetadata(hdr);
+        mpImpl->output.reset(new TiledRgbaOutputFile(mpImpl->stream, hdr, GetChannels(options, mpImpl->alpha),
+                                                     tileSize, tileSize, ONE_LEVEL));
+    }
+    catch(const std::exception& e)
+    {
+        throw POV_EXCEPTION(kFileDataErr, e.what());
+    }
+}
+
+TiledWriter::~TiledWriter()
+{
+    // the library writes the tile offset table when the file is closed
+}
+
+void TiledWriter::WriteTile(unsigned int tileX, unsigned int tileY, const RGBTColour *pixels)
+{
+    unsigned int tileSize = mpImpl->tileSize;
+    unsigned int left = tileX * tileSize;
+    unsigned int top  = tileY * tileSize;
+    if ((left >= mpImpl->width) || (top >= mpImpl->height))
+        throw POV_EXCEPTION(kParamErr, "Tile is outside of the EXR image");
+    unsigned int width  = std::min(tileSize, mpImpl->width  - left);
+    unsigned int height = std::min(tileSize, mpImpl->height - top);
+
+    for (unsigned int row = 0; row < height; row++)
+    {
+        for (unsigned int col = 0; col < width; col++)
+        {
+            RGBTColour colour(pixels[row * tileSize + col]);
+            // the render result always has premultiplied alpha
+            if (!mpImpl->premul)
+                AlphaUnPremultiply(colour);
+            mpImpl->pixels[row * tileSize + col] = Rgba(GammaCurve::Encode(mpImpl->gamma, colour.red()),
+                                                        GammaCurve::Encode(mpImpl->gamma, colour.green()),
+                                                        GammaCurve::Encode(mpImpl->gamma, colour.blue()),
+                                                        mpImpl->alpha ? colour.alpha() : 1.0f);
+        }
+    }
+
+    try
+    {
+        // the frame buffer is addressed in image coordinates
+        mpImpl->output->setFrameBuffer(mpImpl->pixels.data() - left - top * tileSize, 1, tileSize);
+        mpImpl->output->writeTile(tileX, tileY);
+    }
+    catch(const std::exception& e)
+    {
+        throw POV_EXCEPTION(kFileDataErr, e.what());
+    }
+}
+
+unsigned int TiledWriter::GetTileSize() const
+{
+    return mpImpl->tileSize;
+}
+
 }
 // end of namespace OpenEXR
 
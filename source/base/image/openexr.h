@@ -41,10 +41,13 @@
 #include "base/configbase.h"
 
 // C++ variants of C standard header files
-// C++ standard header files
 //  (none at the moment)
 
+// C++ standard header files
+#include <memory>
+
 // POV-Ray header files (base module)
+#include "base/colour.h"
 #include "base/fileinputoutput_fwd.h"
 #include "base/image/image_fwd.h"
 
@@ -63,6 +66,55 @@ namespace OpenEXR
 void Write(OStream *file, const Image *image, const ImageWriteOptions& options);
 Image *Read(IStream *file, const ImageReadOptions& options);
 
+/// Tiled OpenEXR writer, capable of writing an image piecemeal as it is being generated.
+///
+/// Tiles may be written in any order, and no more than one tile is held in memory at any time.
+/// The tile offset table is written last, so the file is not a valid OpenEXR file until the
+/// writer has been destroyed.
+///
+/// @note
+///     Whether the image has any transparency is not known in advance, so an alpha channel is
+///     written whenever alpha output is enabled.
+///
+class TiledWriter final
+{
+    public:
+
+        /// Start writing, writing the header to the file.
+        ///
+        /// @param  file        File to write to; must remain valid until the writer is destroyed.
+        /// @param  width       Image width.
+        /// @param  height      Image height.
+        /// @param  tileSize    Width and height of the tiles.
+        /// @param  options     Output options.
+        ///
+        TiledWriter(OStream *file, unsigned int width, unsigned int height, unsigned int tileSize, const ImageWriteOptions& options);
+
+        /// Complete the file.
+        ~TiledWriter();
+
+        TiledWriter(const TiledWriter&) = delete;
+        TiledWriter& operator=(const TiledWriter&) = delete;
+
+        /// Write a tile.
+        ///
+        /// @param  tileX       Horizontal index of the tile.
+        /// @param  tileY       Vertical index of the tile.
+        /// @param  pixels      Pixels of the tile, row by row, in working colour space and with
+        ///                     premultiplied alpha; rows are @ref GetTileSize() pixels apart even
+        ///                     for tiles clipped by the image border.
+        ///
+        void WriteTile(unsigned int tileX, unsigned int tileY, const RGBTColour *pixels);
+
+        unsigned int GetTileSize() const;
+
+    private:
+
+        struct Impl;
+
+        std::unique_ptr<Impl> mpImpl;
+};
+
 /// @}
 ///
 //##############################################################################
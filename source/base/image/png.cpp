@@ -44,20 +44,29 @@
 #ifndef LIBPNG_MISSING
 
 // C++ variants of C standard header files
-//  (none at the moment)
+#include <cstdlib>
 
 // C++ standard header files
-#include <string>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
 // other 3rd party library header files
 #include <png.h>
+#include <zlib.h>
 
 // POV-Ray header files (base module)
 #include "base/fileinputoutput.h"
+#include "base/mathutil.h"
 #include "base/types.h"
 #include "base/image/colourspace.h"
+#include "base/image/dither.h"
 #include "base/image/encoding.h"
 #include "base/image/image.h"
 #include "base/image/metadata.h"
@@ -85,6 +94,10 @@ const int FLUSH_DIST = 16; // Set to 16 and removed complicated math [trf]
 const int NTEXT = 15;      // Maximum number of tEXt comment blocks
 const int MAXTEXT = 1024;  // Maximum length of a tEXt message
 
+/// Approximate amount of raw image data deflated as a unit by the multi-threaded encoder.
+/// Bands are compressed independently, so making this much smaller will degrade compression.
+const size_t kStreamBandSize = 512 * 1024;
+
 
 /*****************************************************************************
 * Local typedefs
@@ -649,65 +662,90 @@ void SetChannelValue(png_bytep& p, unsigned int v, unsigned int bpcc)
     *(p++) = (v & 0xFF);
 }
 
-void Write (OStream *file, const Image *image, const ImageWriteOptions& options)
+/// Layout and encoding parameters of the pixel data.
+struct RowFormat final
 {
-    int             png_stride;
-    int             width = image->GetWidth() ;
-    int             height = image->GetHeight() ;
-    int             bpcc = options.bitsPerChannel;
-    bool            use_alpha = image->HasTransparency() && options.AlphaIsEnabled();
-    unsigned int    octetDepth = ((bpcc + 7) / 8);
-    unsigned int    bitDepth = 8 * octetDepth;
-    unsigned int    alpha;
-    unsigned int    r;
-    unsigned int    g;
-    unsigned int    b;
+    GammaCurvePtr   gamma;
+    unsigned int    bpcc;
+    unsigned int    bitDepth;
     unsigned int    maxValue;
     unsigned int    mult;
     unsigned int    shift;
-    png_info        *info_ptr = nullptr;
-    png_struct      *png_ptr  = nullptr;
-    Messages        messages;
-    GammaCurvePtr   gamma;
-    Metadata        meta;
-    DitherStrategy& dither = *options.ditherStrategy;
-
-    // PNG/W3C recommends to use sRGB color space
-    gamma = options.GetTranscodingGammaCurve(SRGBGammaCurve::Get());
-
-    // PNG is specified to use non-premultiplied alpha, so that's the way we do it unless the user overrides
-    // (e.g. to handle a non-compliant file).
-    bool premul = options.AlphaIsPremultiplied(false);
-
-    if (bpcc <= 0)
-        bpcc = image->GetMaxIntValue() == 65535 ? 16 : 8 ;
-    else if (bpcc > 16)
-        bpcc = 16 ;
-
-    maxValue = (1<<bpcc)-1;
-
-    if ((png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, (png_voidp)(&messages), png_pov_err, png_pov_warn)) == nullptr)
-        throw POV_EXCEPTION(kOutOfMemoryErr, "Cannot allocate PNG data structures");
-    if ((info_ptr = png_create_info_struct(png_ptr)) == nullptr)
-        throw POV_EXCEPTION(kOutOfMemoryErr, "Cannot allocate PNG data structures");
+    unsigned int    stride;     ///< Bytes per pixel.
+    bool            use_color;
+    bool            use_alpha;
+    bool            premul;
 
-    if (setjmp(png_jmpbuf(png_ptr)))
+    RowFormat(const Image *image, const ImageWriteOptions& options)
     {
-        // If we get here, we had a problem writing the file
-        png_destroy_write_struct(&png_ptr, &info_ptr);
-        throw POV_EXCEPTION(kFileDataErr, "Error writing PNG file") ;
+        unsigned int octetDepth;
+
+        bpcc = options.bitsPerChannel;
+        use_alpha = image->HasTransparency() && options.AlphaIsEnabled();
+        use_color = !(image->IsGrayscale() | options.grayscale);
+
+        // PNG/W3C recommends to use sRGB color space
+        gamma = options.GetTranscodingGammaCurve(SRGBGammaCurve::Get());
+
+        // PNG is specified to use non-premultiplied alpha, so that's the way we do it unless the user overrides
+        // (e.g. to handle a non-compliant file).
+        premul = options.AlphaIsPremultiplied(false);
+
+        if (bpcc <= 0)
+            bpcc = image->GetMaxIntValue() == 65535 ? 16 : 8 ;
+        else if (bpcc > 16)
+            bpcc = 16 ;
+
+        octetDepth = ((bpcc + 7) / 8);
+        bitDepth = 8 * octetDepth;
+        maxValue = (1<<bpcc)-1;
+
+        stride = use_color ? 3 : 1;
+        if (use_alpha)
+            stride++;
+        stride *= octetDepth;
+
+        int repeat = (bitDepth + bpcc - 1) / bpcc;
+        shift = (bpcc * repeat) - bitDepth;
+        mult = 0x01;
+        for (int i = 1; i < repeat; ++i)
+            mult = (mult << bpcc) | 0x01;
     }
+};
 
-    // Set up the compression structure
-    png_set_write_fn (png_ptr, file, png_pov_write_data, png_pov_flush_data);
+/// Encode a row of the image into raw PNG pixel data.
+void EncodeRow(const Image *image, int row, png_bytep p, const RowFormat& format, DitherStrategy& dither)
+{
+    unsigned int    channels = (format.use_color ? 3 : 1) + (format.use_alpha ? 1 : 0);
+    unsigned int    mult = format.mult;
+    unsigned int    shift = format.shift;
+    unsigned int    bpcc = format.bpcc;
+    std::vector<unsigned int> values(image->GetWidth() * channels);
+
+    if (format.use_color && format.use_alpha)
+        GetEncodedRGBARow(image, row, format.gamma, format.maxValue, values.data(), dither, format.premul);
+    else if (format.use_color)
+        GetEncodedRGBRow(image, row, format.gamma, format.maxValue, values.data(), dither);
+    else if (format.use_alpha)
+        GetEncodedGrayARow(image, row, format.gamma, format.maxValue, values.data(), dither, format.premul);
+    else
+        GetEncodedGrayRow(image, row, format.gamma, format.maxValue, values.data(), dither);
 
-    bool use_color = !(image->IsGrayscale() | options.grayscale);
+    // channels are interleaved in the same order in both the encoded values and the PNG pixel data
+    for (unsigned int value : values)
+        SetChannelValue(p, (value * mult) >> shift, bpcc);
+}
+
+/// Set up the header information, and write everything up to the image data.
+void WriteHeader(png_struct *png_ptr, png_info *info_ptr, const Image *image, const ImageWriteOptions& options, const RowFormat& format)
+{
+    Metadata meta;
 
     // Fill in the relevant image information
     png_set_IHDR(png_ptr, info_ptr,
-                 width, height,
-                 bitDepth,
-                 (use_color ? PNG_COLOR_MASK_COLOR : 0) | (use_alpha ? PNG_COLOR_MASK_ALPHA : 0), // color_type
+                 image->GetWidth(), image->GetHeight(),
+                 format.bitDepth,
+                 (format.use_color ? PNG_COLOR_MASK_COLOR : 0) | (format.use_alpha ? PNG_COLOR_MASK_ALPHA : 0), // color_type
                  PNG_INTERLACE_NONE,
                  PNG_COMPRESSION_TYPE_DEFAULT,
                  PNG_FILTER_TYPE_DEFAULT // interlace_method
@@ -715,17 +753,17 @@ void Write (OStream *file, const Image *image, const ImageWriteOptions& options)
 
 #if defined(PNG_WRITE_sBIT_SUPPORTED)
     png_color_8 sbit = {0,0,0,0,0};
-    if (use_color)
-        sbit.red = sbit.green = sbit.blue = bpcc;
+    if (format.use_color)
+        sbit.red = sbit.green = sbit.blue = format.bpcc;
     else
-        sbit.gray = bpcc;
-    if (use_alpha)
-        sbit.alpha = bpcc;
+        sbit.gray = format.bpcc;
+    if (format.use_alpha)
+        sbit.alpha = format.bpcc;
     png_set_sBIT(png_ptr, info_ptr, &sbit);
 #endif // PNG_WRITE_sBIT_SUPPORTED
 
 #if defined(PNG_WRITE_gAMA_SUPPORTED)
-    png_set_gAMA(png_ptr, info_ptr, 1.0f / (options.workingGamma->ApproximateDecodingGamma() * gamma->ApproximateDecodingGamma()));
+    png_set_gAMA(png_ptr, info_ptr, 1.0f / (options.workingGamma->ApproximateDecodingGamma() * format.gamma->ApproximateDecodingGamma()));
 #endif // PNG_WRITE_gAMA_SUPPORTED
 
 #if defined(PNG_WRITE_sRGB_SUPPORTED)
@@ -770,47 +808,48 @@ void Write (OStream *file, const Image *image, const ImageWriteOptions& options)
 #endif // PNG_WRITE_TEXT_SUPPORTED
 
     png_write_info(png_ptr, info_ptr);
-    png_stride = use_color ? 3 : 1;
-    if (use_alpha)
-        png_stride++;
-    png_stride *= octetDepth;
+}
+
+void Write (OStream *file, const Image *image, const ImageWriteOptions& options)
+{
+    int             height = image->GetHeight() ;
+    png_info        *info_ptr = nullptr;
+    png_struct      *png_ptr  = nullptr;
+    Messages        messages;
+    RowFormat       format(image, options);
+    DitherStrategy& dither = *options.ditherStrategy;
 
-    std::unique_ptr<png_byte[]> row_ptr(new png_byte[width*png_stride]);
+    // with multiple threads, and an image large enough to be split, use the multi-threaded encoder instead
+    if ((options.threads > 1) && StreamEncoder::IsSupported(options) &&
+        (size_t(image->GetWidth()) * format.stride * height >= 2 * kStreamBandSize))
+    {
+        StreamEncoder encoder(file, image, options, options.threads);
+        encoder.Finish();
+        return;
+    }
 
-    int repeat = (bitDepth + bpcc - 1) / bpcc;
-    shift = (bpcc * repeat) - bitDepth;
-    mult = 0x01;
-    for (int i = 1; i < repeat; ++i)
-        mult = (mult << bpcc) | 0x01;
+    if ((png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, (png_voidp)(&messages), png_pov_err, png_pov_warn)) == nullptr)
+        throw POV_EXCEPTION(kOutOfMemoryErr, "Cannot allocate PNG data structures");
+    if ((info_ptr = png_create_info_struct(png_ptr)) == nullptr)
+        throw POV_EXCEPTION(kOutOfMemoryErr, "Cannot allocate PNG data structures");
 
-    for (int row = 0 ; row < height ; row++)
+    if (setjmp(png_jmpbuf(png_ptr)))
     {
-        auto p = row_ptr.get();
-        for (int col = 0; col < width; ++col)
-        {
-            if (use_color && use_alpha)
-                GetEncodedRGBAValue(image, col, row, gamma, maxValue, r, g, b, alpha, dither, premul);
-            else if (use_color)
-                GetEncodedRGBValue(image, col, row, gamma, maxValue, r, g, b, dither);
-            else if (use_alpha)
-                GetEncodedGrayAValue(image, col, row, gamma, maxValue, g, alpha, dither, premul);
-            else
-                g = GetEncodedGrayValue(image, col, row, gamma, maxValue, dither);
+        // If we get here, we had a problem writing the file
+        png_destroy_write_struct(&png_ptr, &info_ptr);
+        throw POV_EXCEPTION(kFileDataErr, "Error writing PNG file") ;
+    }
 
-            if (use_color)
-            {
-                SetChannelValue(p, (r * mult) >> shift, bpcc);
-                SetChannelValue(p, (g * mult) >> shift, bpcc);
-                SetChannelValue(p, (b * mult) >> shift, bpcc);
-            }
-            else
-            {
-                SetChannelValue(p, (g * mult) >> shift, bpcc);
-            }
+    // Set up the compression structure
+    png_set_write_fn (png_ptr, file, png_pov_write_data, png_pov_flush_data);
 
-            if (use_alpha)
-                SetChannelValue(p, (alpha * mult) >> shift, bpcc);
-        }
+    WriteHeader(png_ptr, info_ptr, image, options, format);
+
+    std::unique_ptr<png_byte[]> row_ptr(new png_byte[image->GetWidth()*format.stride]);
+
+    for (int row = 0 ; row < height ; row++)
+    {
+        EncodeRow(image, row, row_ptr.get(), format, dither);
 
         if (setjmp(png_jmpbuf(png_ptr)))
         {
@@ -832,6 +871,303 @@ void Write (OStream *file, const Image *image, const ImageWriteOptions& options)
     png_destroy_write_struct(&png_ptr, &info_ptr);
 }
 
+//******************************************************************************
+
+/// Apply the PNG filter giving the best compression to a row of raw pixel data.
+///
+/// The filter is chosen by the same heuristic as used by libpng, i.e. minimum sum of absolute
+/// differences, with the filter type byte being prepended to the filtered data.
+///
+void FilterRow(const png_byte *cur, const png_byte *prev, size_t rowBytes, unsigned int bpp,
+               std::vector<png_byte>& scratch, std::vector<png_byte>& out)
+{
+    static const int kFilterCount = 5; // None, Sub, Up, Average, Paeth
+
+    scratch.resize(kFilterCount * (rowBytes + 1));
+    png_bytep filtered[kFilterCount];
+    unsigned long sum[kFilterCount] = { 0, 0, 0, 0, 0 };
+    for (int i = 0; i < kFilterCount; ++i)
+    {
+        filtered[i] = &scratch[i * (rowBytes + 1)];
+        filtered[i][0] = png_byte(i);
+    }
+
+    for (size_t i = 0; i < rowBytes; ++i)
+    {
+        int a = (i >= bpp ? cur[i - bpp] : 0);
+        int b = prev[i];
+        int c = (i >= bpp ? prev[i - bpp] : 0);
+
+        int p = a + b - c;
+        int pa = abs(p - a);
+        int pb = abs(p - b);
+        int pc = abs(p - c);
+        int paeth = ((pa <= pb) && (pa <= pc)) ? a : (pb <= pc) ? b : c;
+
+        png_byte v[kFilterCount] = {
+            cur[i],
+            png_byte(cur[i] - a),
+            png_byte(cur[i] - b),
+            png_byte(cur[i] - ((a + b) >> 1)),
+            png_byte(cur[i] - paeth)
+        };
+        for (int k = 0; k < kFilterCount; ++k)
+        {
+            filtered[k][i + 1] = v[k];
+            sum[k] += (v[k] < 128 ? v[k] : 256 - v[k]);
+        }
+    }
+
+    int best = 0;
+    for (int k = 1; k < kFilterCount; ++k)
+        if (sum[k] < sum[best])
+            best = k;
+
+    out.insert(out.end(), filtered[best], filtered[best] + rowBytes + 1);
+}
+
+struct StreamEncoder::Impl final
+{
+    /// Set of rows deflated as a unit.
+    struct Band final
+    {
+        unsigned int            firstRow;
+        unsigned int            rows;
+        std::vector<png_byte>   data;       ///< Deflated data.
+        uLong                   adler;      ///< Adler-32 checksum of the filtered data.
+        size_t                  size;       ///< Size of the filtered data.
+        bool                    done;
+    };
+
+    OStream*                    file;
+    const Image*                image;
+    RowFormat                   format;
+    DitherStrategySPtr          dither;
+    png_struct*                 png_ptr;
+    png_info*                   info_ptr;
+    Messages                    messages;
+    std::vector<Band>           bands;
+    unsigned int                bandsQueued;
+    unsigned int                bandsWritten;
+    uLong                       adler;
+    std::deque<unsigned int>    queue;
+    std::vector<std::thread>    workers;
+    std::mutex                  mutex;
+    std::condition_variable     workAvailable;
+    std::condition_variable     bandDone;
+    std::exception_ptr          error;
+    bool                        quit;
+
+    Impl(OStream *f, const Image *img, const ImageWriteOptions& options) :
+        file(f), image(img), format(img, options), dither(options.ditherStrategy),
+        png_ptr(nullptr), info_ptr(nullptr), bandsQueued(0), bandsWritten(0), adler(adler32(0, nullptr, 0)), quit(false)
+    {}
+
+    ~Impl()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.clear();
+            quit = true;
+        }
+        workAvailable.notify_all();
+        for (auto& worker : workers)
+            worker.join();
+        if (png_ptr != nullptr)
+            png_destroy_write_struct(&png_ptr, &info_ptr);
+    }
+
+    void Work();
+    void EncodeBand(Band& band);
+    void WriteBands(bool wait);
+};
+
+void StreamEncoder::Impl::Work()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;)
+    {
+        workAvailable.wait(lock, [this] { return quit || !queue.empty(); });
+        if (queue.empty())
+            return;
+        Band& band = bands[queue.front()];
+        queue.pop_front();
+        lock.unlock();
+
+        std::exception_ptr e;
+        try
+        {
+            EncodeBand(band);
+        }
+        catch (...)
+        {
+            e = std::current_exception();
+        }
+
+        lock.lock();
+        if (e && !error)
+            error = e;
+        band.done = true;
+        bandDone.notify_all();
+    }
+}
+
+void StreamEncoder::Impl::EncodeBand(Band& band)
+{
+    unsigned int width = image->GetWidth();
+    size_t rowBytes = size_t(width) * format.stride;
+    bool first = (band.firstRow == 0);
+    bool last = (band.firstRow + band.rows == image->GetHeight());
+    std::vector<png_byte> prev(rowBytes, 0);
+    std::vector<png_byte> cur(rowBytes);
+    std::vector<png_byte> scratch;
+    std::vector<png_byte> filtered;
+
+    // the filters refer to the previous row, which belongs to the previous band; as the dithering
+    // is stateless, we can simply encode that row again
+    if (!first)
+        EncodeRow(image, band.firstRow - 1, prev.data(), format, *dither);
+
+    filtered.reserve(band.rows * (rowBytes + 1));
+    for (unsigned int row = band.firstRow; row < band.firstRow + band.rows; ++row)
+    {
+        EncodeRow(image, row, cur.data(), format, *dither);
+        FilterRow(cur.data(), prev.data(), rowBytes, std::max(format.stride, 1u), scratch, filtered);
+        std::swap(prev, cur);
+    }
+
+    band.size = filtered.size();
+    band.adler = adler32(adler32(0, nullptr, 0), filtered.data(), uInt(filtered.size()));
+
+    // Deflate as a raw stream, ending with a sync flush to byte-align the output so that the
+    // next band can be appended; only the first band carries the zlib header, and the trailer
+    // is added once the checksums of all bands have been combined.
+    z_stream stream;
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_FILTERED) != Z_OK)
+        throw POV_EXCEPTION(kOutOfMemoryErr, "Cannot allocate PNG compression data structures");
+
+    size_t offset = 0;
+    if (first)
+    {
+        band.data.push_back(0x78); // deflate, 32k window
+        band.data.push_back(0x9C); // default compression level, header check bits
+        offset = 2;
+    }
+    band.data.resize(offset + deflateBound(&stream, uLong(filtered.size())) + 16);
+    stream.next_in = filtered.data();
+    stream.avail_in = uInt(filtered.size());
+    int status;
+    do
+    {
+        if (offset == band.data.size())
+            band.data.resize(band.data.size() * 2);
+        stream.next_out = band.data.data() + offset;
+        stream.avail_out = uInt(band.data.size() - offset);
+        status = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+        offset = band.data.size() - stream.avail_out;
+    }
+    while ((status == Z_OK) && ((stream.avail_out == 0) || (last && (status != Z_STREAM_END))));
+    deflateEnd(&stream);
+    if (last ? (status != Z_STREAM_END) : ((status != Z_OK) && (status != Z_BUF_ERROR)))
+        throw POV_EXCEPTION(kFileDataErr, "Cannot compress PNG output data");
+    band.data.resize(offset);
+}
+
+void StreamEncoder::Impl::WriteBands(bool wait)
+{
+    while (bandsWritten < bands.size())
+    {
+        Band& band = bands[bandsWritten];
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (wait)
+                bandDone.wait(lock, [this, &band] { return band.done || error; });
+            if (error)
+                std::rethrow_exception(error);
+            if (!band.done)
+                return;
+        }
+
+        adler = adler32_combine(adler, band.adler, z_off_t(band.size));
+        if (bandsWritten + 1 == bands.size())
+        {
+            band.data.push_back(png_byte(adler >> 24));
+            band.data.push_back(png_byte(adler >> 16));
+            band.data.push_back(png_byte(adler >> 8));
+            band.data.push_back(png_byte(adler));
+        }
+        png_write_chunk(png_ptr, reinterpret_cast<png_const_bytep>("IDAT"), band.data.data(), band.data.size());
+        std::vector<png_byte>().swap(band.data);
+        ++bandsWritten;
+    }
+}
+
+StreamEncoder::StreamEncoder(OStream *file, const Image *image, const ImageWriteOptions& options, unsigned int threads) :
+    mpImpl(new Impl(file, image, options))
+{
+    if (!IsSupported(options))
+        throw POV_EXCEPTION(kParamErr, "Dithering method not supported by multi-threaded PNG encoder");
+
+    if ((mpImpl->png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, (png_voidp)(&mpImpl->messages), png_pov_err, png_pov_warn)) == nullptr)
+        throw POV_EXCEPTION(kOutOfMemoryErr, "Cannot allocate PNG data structures");
+    if ((mpImpl->info_ptr = png_create_info_struct(mpImpl->png_ptr)) == nullptr)
+        throw POV_EXCEPTION(kOutOfMemoryErr, "Cannot allocate PNG data structures");
+
+    // NB: png_pov_err throws an exception rather than returning, so we don't need to worry about setjmp.
+    png_set_write_fn(mpImpl->png_ptr, file, png_pov_write_data, png_pov_flush_data);
+    WriteHeader(mpImpl->png_ptr, mpImpl->info_ptr, image, options, mpImpl->format);
+
+    size_t rowBytes = size_t(image->GetWidth()) * mpImpl->format.stride;
+    unsigned int height = image->GetHeight();
+    unsigned int rowsPerBand = std::max(1u, static_cast<unsigned int>((kStreamBandSize + rowBytes - 1) / rowBytes));
+    mpImpl->bands.resize((height + rowsPerBand - 1) / rowsPerBand);
+    for (unsigned int i = 0; i < mpImpl->bands.size(); ++i)
+    {
+        Impl::Band& band = mpImpl->bands[i];
+        band.firstRow = i * rowsPerBand;
+        band.rows = std::min(rowsPerBand, height - band.firstRow);
+        band.adler = 0;
+        band.size = 0;
+        band.done = false;
+    }
+
+    threads = clip<unsigned int>(threads, 1, mpImpl->bands.size());
+    for (unsigned int i = 0; i < threads; ++i)
+        mpImpl->workers.push_back(std::thread(&Impl::Work, mpImpl.get()));
+}
+
+StreamEncoder::~StreamEncoder()
+{
+}
+
+bool StreamEncoder::IsSupported(const ImageWriteOptions& options)
+{
+    return (options.ditherStrategy != nullptr) && options.ditherStrategy->IsStateless();
+}
+
+void StreamEncoder::SetRowsCompleted(unsigned int rows)
+{
+    {
+        std::lock_guard<std::mutex> lock(mpImpl->mutex);
+        while ((mpImpl->bandsQueued < mpImpl->bands.size()) &&
+               (mpImpl->bands[mpImpl->bandsQueued].firstRow + mpImpl->bands[mpImpl->bandsQueued].rows <= rows))
+            mpImpl->queue.push_back(mpImpl->bandsQueued++);
+    }
+    mpImpl->workAvailable.notify_all();
+    mpImpl->WriteBands(false);
+}
+
+void StreamEncoder::Finish()
+{
+    SetRowsCompleted(mpImpl->image->GetHeight());
+    mpImpl->WriteBands(true);
+    png_write_chunk(mpImpl->png_ptr, reinterpret_cast<png_const_bytep>("IEND"), nullptr, 0);
+    mpImpl->file->flush();
+}
+
 }
 // end of namespace Png
 
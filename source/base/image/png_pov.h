@@ -40,9 +40,11 @@
 #include "base/configbase.h"
 
 // C++ variants of C standard header files
-// C++ standard header files
 //  (none at the moment)
 
+// C++ standard header files
+#include <memory>
+
 // POV-Ray header files (base module)
 #include "base/fileinputoutput_fwd.h"
 #include "base/image/image_fwd.h"
@@ -62,6 +64,62 @@ namespace Png
 void Write(OStream *file, const Image *image, const ImageWriteOptions& options);
 Image *Read(IStream *file, const ImageReadOptions& options);
 
+/// Multi-threaded PNG encoder, capable of encoding an image while it is still being generated.
+///
+/// The image data is split into bands of rows, which are filtered and deflated independently on
+/// a number of worker threads, and concatenated into a single zlib stream. Bands are handed to the
+/// workers as soon as all of their rows have been reported complete, and written to the file in
+/// order as soon as they have been encoded; the caller must not modify any row once reported.
+///
+/// @note
+///     The encoder itself is not thread-safe, i.e. all calls must come from the same thread
+///     (or be synchronized by the caller).
+///
+class StreamEncoder final
+{
+    public:
+
+        /// Start encoding, writing the header to the file.
+        ///
+        /// @param  file        File to write to; must remain valid until the encoder is destroyed.
+        /// @param  image       Image to encode; must remain valid until the encoder is destroyed.
+        /// @param  options     Output options.
+        /// @param  threads     Number of worker threads.
+        ///
+        StreamEncoder(OStream *file, const Image *image, const ImageWriteOptions& options, unsigned int threads);
+
+        /// Abandon encoding, if not finished.
+        ~StreamEncoder();
+
+        StreamEncoder(const StreamEncoder&) = delete;
+        StreamEncoder& operator=(const StreamEncoder&) = delete;
+
+        /// Whether the encoder can be used with the given options.
+        ///
+        /// This requires a stateless dithering algorithm.
+        ///
+        static bool IsSupported(const ImageWriteOptions& options);
+
+        /// Report rows as complete.
+        ///
+        /// @param  rows    Number of rows, counting from the top of the image, that are complete.
+        ///
+        void SetRowsCompleted(unsigned int rows);
+
+        /// Encode any remaining rows, and complete the file.
+        ///
+        /// @note
+        ///     All rows of the image must be complete by now, whether reported or not.
+        ///
+        void Finish();
+
+    private:
+
+        struct Impl;
+
+        std::unique_ptr<Impl> mpImpl;
+};
+
 /// @}
 ///
 //##############################################################################
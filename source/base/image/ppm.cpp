@@ -50,9 +50,10 @@
 
 // C++ variants of C standard header files
 #include <cctype>
+#include <cstring>
 
 // C++ standard header files
-//  (none at the moment)
+#include <vector>
 
 // POV-Ray header files (base module)
 #include "base/fileinputoutput.h"
@@ -150,13 +151,19 @@ void Write (OStream *file, const Image *image, const ImageWriteOptions& options)
         file->printf("# %s\n", meta.getComment4().c_str());
     file->printf("%d %d\n%d\n", width, height, mask);
 
+    std::vector<unsigned int> values(width * (grayscale ? 1 : 3));
     for (int y = 0 ; y < height ; y++)
     {
+        if (grayscale)
+            GetEncodedGrayRow (image, y, gamma, mask, values.data(), dither) ;
+        else
+            GetEncodedRGBRow (image, y, gamma, mask, values.data(), dither) ;
+
         for (int x = 0; x < width; x++)
         {
             if (grayscale)
             {
-                gray = GetEncodedGrayValue (image, x, y, gamma, mask, dither) ;
+                gray = values[x];
 
                 if (plainFormat)
                 {
@@ -176,7 +183,9 @@ void Write (OStream *file, const Image *image, const ImageWriteOptions& options)
             }
             else
             {
-                GetEncodedRGBValue(image, x, y, gamma, mask, rval, gval, bval, dither);
+                rval = values[x * 3];
+                gval = values[x * 3 + 1];
+                bval = values[x * 3 + 2];
 
                 if (plainFormat)
                 {
@@ -210,6 +219,50 @@ void Write (OStream *file, const Image *image, const ImageWriteOptions& options)
 
 /*****************************************************************************/
 
+void WritePFM (OStream *file, const Image *image, const ImageWriteOptions& options)
+{
+    int                 width = image->GetWidth() ;
+    int                 height = image->GetHeight() ;
+    bool                grayscale = (image->IsGrayscale() || options.grayscale);
+    float               value[3];
+    POV_UINT32          data;
+
+    // A negative scale factor indicates little-endian data.
+    file->printf("%s\n%d %d\n-1.0\n", (grayscale ? "Pf" : "PF"), width, height);
+
+    // PFM stores rows bottom-to-top.
+    for (int y = height - 1; y >= 0; y--)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            int channels;
+            if (grayscale)
+            {
+                value[0] = image->GetGrayValue(x, y);
+                channels = 1;
+            }
+            else
+            {
+                image->GetRGBValue(x, y, value[0], value[1], value[2]);
+                channels = 3;
+            }
+
+            for (int i = 0; i < channels; i++)
+            {
+                std::memcpy(&data, &value[i], sizeof(data));
+                file->Write_Byte(data & 0xFF);
+                file->Write_Byte((data >> 8) & 0xFF);
+                file->Write_Byte((data >> 16) & 0xFF);
+                file->Write_Byte((data >> 24) & 0xFF);
+            }
+            if (!*file)
+                throw POV_EXCEPTION(kFileDataErr, "Cannot write PFM output data");
+        }
+    }
+}
+
+/*****************************************************************************/
+
 /// Read an individual character from a Netpbm file, potentially skipping comments.
 inline static int ReadNetpbmAsciiChar (IStream *file, bool allowComments)
 {
@@ -61,6 +61,14 @@ namespace Netpbm
 /// @{
 
 void Write(OStream *file, const Image *image, const ImageWriteOptions& options);
+
+/// Write an image in Portable Float Map format.
+///
+/// The data is written as linear little-endian 32-bit floats without any gamma encoding,
+/// dithering or clipping, making the format suitable for auxiliary (non-colour) data.
+///
+void WritePFM(OStream *file, const Image *image, const ImageWriteOptions& options);
+
 Image *Read(IStream *file, const ImageReadOptions& options);
 
 /// @}
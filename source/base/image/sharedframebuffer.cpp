@@ -0,0 +1,136 @@
+//******************************************************************************
+///
+/// @file base/image/sharedframebuffer.cpp
+///
+/// Implementations related to the framebuffer shared between backend and frontend.
+///
+/// @copyright
+/// @parblock
+///
+/// Persistence of Vision Ray Tracer ('POV-Ray') version 3.8.
+/// Copyright 1991-2019 Persistence of Vision Raytracer Pty. Ltd.
+///
+/// POV-Ray is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU Affero General Public License as
+/// published by the Free Software Foundation, either version 3 of the
+/// License, or (at your option) any later version.
+///
+/// POV-Ray is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU Affero General Public License for more details.
+///
+/// You should have received a copy of the GNU Affero General Public License
+/// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+///
+/// ----------------------------------------------------------------------------
+///
+/// POV-Ray is based on the popular DKB raytracer version 2.12.
+/// DKBTrace was originally written by David K. Buck.
+/// DKBTrace Ver 2.0-2.12 were written by David K. Buck & Aaron A. Collins.
+///
+/// @endparblock
+///
+//******************************************************************************
+
+// Unit header file must be the first file included within POV-Ray *.cpp files (pulls in config)
+#include "base/image/sharedframebuffer.h"
+
+// C++ variants of C standard header files
+//  (none at the moment)
+
+// C++ standard header files
+#include <fstream>
+
+// Boost header files
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+// POV-Ray header files (base module)
+#include "base/filesystem.h"
+#include "base/pov_err.h"
+#include "base/stringutilities.h"
+
+// this must be the last file included
+#include "base/povdebug.h"
+
+namespace pov_base
+{
+
+namespace bip = boost::interprocess;
+
+struct SharedFramebuffer::Impl final
+{
+    bip::file_mapping   mapping;
+    bip::mapped_region  region;
+};
+
+SharedFramebuffer::SharedFramebuffer(const UCS2String& filename, unsigned int width, unsigned int height) :
+    SharedFramebuffer(filename, width, height, true)
+{}
+
+SharedFramebuffer::SharedFramebuffer(const UCS2String& filename, unsigned int width, unsigned int height, bool create) :
+    mpImpl(new Impl),
+    mFileName(filename),
+    mWidth(width),
+    mHeight(height),
+    mpData(nullptr),
+    mOwner(false)
+{
+    const std::string sysFileName(UCS2toSysString(filename));
+    const std::streamoff size = std::streamoff(width) * height * sizeof(RGBTColour);
+
+    if ((width == 0) || (height == 0))
+        throw POV_EXCEPTION(kParamErr, "Shared framebuffer must not be empty");
+
+    if (create)
+    {
+        // extending the file leaves it filled with zeros, i.e. black
+        std::filebuf file;
+        if (!file.open(sysFileName, std::ios_base::in | std::ios_base::out | std::ios_base::trunc | std::ios_base::binary))
+            throw POV_EXCEPTION(kCannotOpenFileErr, "Cannot create shared framebuffer '" + sysFileName + "'");
+        mOwner = true;
+        if ((file.pubseekoff(size - 1, std::ios_base::beg) != size - 1) || (file.sputc(0) != 0) || (file.close() == nullptr))
+        {
+            Filesystem::DeleteFile(filename);
+            throw POV_EXCEPTION(kFileDataErr, "Cannot allocate shared framebuffer '" + sysFileName + "'");
+        }
+    }
+
+    try
+    {
+        mpImpl->mapping = bip::file_mapping(sysFileName.c_str(), bip::read_write);
+        mpImpl->region = bip::mapped_region(mpImpl->mapping, bip::read_write);
+    }
+    catch (bip::interprocess_exception&)
+    {
+        if (mOwner)
+            Filesystem::DeleteFile(filename);
+        throw POV_EXCEPTION(kCannotOpenFileErr, "Cannot map shared framebuffer '" + sysFileName + "'");
+    }
+
+    if (mpImpl->region.get_size() != size_t(size))
+    {
+        if (mOwner)
+            Filesystem::DeleteFile(filename);
+        throw POV_EXCEPTION(kInvalidDataSizeErr, "Shared framebuffer '" + sysFileName + "' does not match image size");
+    }
+
+    mpData = static_cast<RGBTColour*>(mpImpl->region.get_address());
+}
+
+std::unique_ptr<SharedFramebuffer> SharedFramebuffer::Open(const UCS2String& filename, unsigned int width, unsigned int height)
+{
+    return std::unique_ptr<SharedFramebuffer>(new SharedFramebuffer(filename, width, height, false));
+}
+
+SharedFramebuffer::~SharedFramebuffer()
+{
+    // unmap before deleting, as some platforms refuse to delete mapped files
+    mpImpl.reset();
+    if (mOwner)
+        Filesystem::DeleteFile(mFileName);
+}
+
+}
+// end of namespace pov_base
@@ -0,0 +1,140 @@
+//******************************************************************************
+///
+/// @file base/image/sharedframebuffer.h
+///
+/// Declarations related to the framebuffer shared between backend and frontend.
+///
+/// @copyright
+/// @parblock
+///
+/// Persistence of Vision Ray Tracer ('POV-Ray') version 3.8.
+/// Copyright 1991-2019 Persistence of Vision Raytracer Pty. Ltd.
+///
+/// POV-Ray is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU Affero General Public License as
+/// published by the Free Software Foundation, either version 3 of the
+/// License, or (at your option) any later version.
+///
+/// POV-Ray is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU Affero General Public License for more details.
+///
+/// You should have received a copy of the GNU Affero General Public License
+/// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+///
+/// ----------------------------------------------------------------------------
+///
+/// POV-Ray is based on the popular DKB raytracer version 2.12.
+/// DKBTrace was originally written by David K. Buck.
+/// DKBTrace Ver 2.0-2.12 were written by David K. Buck & Aaron A. Collins.
+///
+/// @endparblock
+///
+//******************************************************************************
+
+#ifndef POVRAY_BASE_SHAREDFRAMEBUFFER_H
+#define POVRAY_BASE_SHAREDFRAMEBUFFER_H
+
+// Module config header file must be the first file included within POV-Ray unit header files
+#include "base/configbase.h"
+
+// C++ variants of C standard header files
+//  (none at the moment)
+
+// C++ standard header files
+#include <algorithm>
+#include <memory>
+
+// POV-Ray header files (base module)
+#include "base/colour.h"
+#include "base/stringtypes.h"
+
+namespace pov_base
+{
+
+//##############################################################################
+///
+/// @addtogroup PovBaseImage
+///
+/// @{
+
+/// Framebuffer backed by a memory-mapped file.
+///
+/// The frontend creates the framebuffer and passes its file name to the backend,
+/// which maps the same file and has its render threads store the final pixels
+/// directly in it. This way, only the location of completed blocks needs to be
+/// sent via POVMS, rather than the pixel data itself.
+///
+/// Pixels are stored row by row as red, green, blue and transmit values in
+/// single precision. No synchronization is provided; it is up to the backend
+/// to complete a block before notifying the frontend about it, and to never
+/// write to that block again, as the frontend may read it at any later time.
+///
+class SharedFramebuffer final
+{
+    public:
+
+        /// Create a new framebuffer.
+        ///
+        /// The file is created (or truncated) and initialized to black;
+        /// it is deleted again when the framebuffer is destroyed.
+        ///
+        SharedFramebuffer(const UCS2String& filename, unsigned int width, unsigned int height);
+
+        /// Map an existing framebuffer.
+        ///
+        /// @throws pov_base::Exception if the file does not exist or does not
+        ///     match the specified dimensions.
+        ///
+        static std::unique_ptr<SharedFramebuffer> Open(const UCS2String& filename, unsigned int width, unsigned int height);
+
+        ~SharedFramebuffer();
+
+        SharedFramebuffer(const SharedFramebuffer&) = delete;
+        SharedFramebuffer& operator=(const SharedFramebuffer&) = delete;
+
+        const UCS2String& GetFileName() const { return mFileName; }
+        unsigned int GetWidth() const { return mWidth; }
+        unsigned int GetHeight() const { return mHeight; }
+
+        inline RGBTColour GetRGBTValue(unsigned int x, unsigned int y) const
+        {
+            return mpData[size_t(y) * mWidth + x];
+        }
+
+        /// Get direct access to the pixels of a row, starting at the given column.
+        inline const RGBTColour* GetRGBTRow(unsigned int x, unsigned int y) const
+        {
+            return mpData + size_t(y) * mWidth + x;
+        }
+
+        inline void SetRGBTRow(unsigned int x, unsigned int y, unsigned int count, const RGBTColour* data)
+        {
+            std::copy(data, data + count, mpData + size_t(y) * mWidth + x);
+        }
+
+    private:
+
+        static_assert(sizeof(RGBTColour) == 4 * sizeof(float), "RGBTColour must be packed to be mapped directly");
+
+        struct Impl;
+
+        std::unique_ptr<Impl>   mpImpl;
+        UCS2String              mFileName;
+        unsigned int            mWidth;
+        unsigned int            mHeight;
+        RGBTColour*             mpData;
+        bool                    mOwner;
+
+        SharedFramebuffer(const UCS2String& filename, unsigned int width, unsigned int height, bool create);
+};
+
+/// @}
+///
+//##############################################################################
+
+}
+// end of namespace pov_base
+
+#endif // POVRAY_BASE_SHAREDFRAMEBUFFER_H
@@ -116,9 +116,13 @@ typedef char Targa_extension[495];
 #define EXT_GAMMA_OFF 478
 #define EXT_PIXRATIO_OFF 474
 
-static Pixel *GetPix (const Image *image, int x, int y, Pixel *pixel, const GammaCurvePtr& gamma, DitherStrategy& dither, bool premul)
+static Pixel *GetPix (const vector<unsigned int>& values, int x, Pixel *pixel)
 {
-    GetEncodedRGBAValue (image, x, y, gamma, 255, pixel->r, pixel->g, pixel->b, pixel->a, dither, premul);
+    const unsigned int *encoded = &values[x * 4];
+    pixel->r = encoded[0];
+    pixel->g = encoded[1];
+    pixel->b = encoded[2];
+    pixel->a = encoded[3];
     return (pixel);
 }
 
@@ -139,6 +143,7 @@ void Write (OStream *file, const Image *image, const ImageWriteOptions& options)
     bool                    compress = (options.compression > 0);
     vector<unsigned char>   header;
     vector<unsigned char>   line;
+    vector<unsigned int>    values;
     GammaCurvePtr           gamma;
     Metadata                meta;
     DitherStrategy&         dither = *options.ditherStrategy;
@@ -191,6 +196,7 @@ void Write (OStream *file, const Image *image, const ImageWriteOptions& options)
         throw POV_EXCEPTION(kFileDataErr, "header write failed for targa file") ;
 
     line.reserve (w * 4);
+    values.resize (w * 4);
     if (compress)
     {
         // RLE compressed data
@@ -205,11 +211,12 @@ void Write (OStream *file, const Image *image, const ImageWriteOptions& options)
             int ptype = 0;
             bool writenow = false;
 
-            GetPix(image, 0, row, &current, gamma, dither, premul);
+            GetEncodedRGBARow (image, row, gamma, 255, values.data(), dither, premul);
+            GetPix(values, 0, &current);
             while (true)
             {
                 if (startx + cnt < llen)
-                    GetPix(image, startx + cnt, row, &next, gamma, dither, premul);
+                    GetPix(values, startx + cnt, &next);
                 else
                     next = current;
                 if (memcmp (&current, &next, sizeof (pix)) == 0)
@@ -256,7 +263,7 @@ void Write (OStream *file, const Image *image, const ImageWriteOptions& options)
                     {
                         line.push_back ((unsigned char) cnt - 1);
                         for (int x = 0; x < cnt; x++)
-                            PutPix(line, GetPix(image, startx + x, row, &pixel, gamma, dither, premul), opaque);
+                            PutPix(line, GetPix(values, startx + x, &pixel), opaque);
                     }
                     startx += cnt;
                     writenow = false;
@@ -279,8 +286,9 @@ void Write (OStream *file, const Image *image, const ImageWriteOptions& options)
         for (int row = 0; row < h; ++row)
         {
             line.clear ();
+            GetEncodedRGBARow (image, row, gamma, 255, values.data(), dither, premul);
             for (int col = 0; col < w; ++col)
-                PutPix(line, GetPix(image, col, row, &pixel, gamma, dither, premul), opaque);
+                PutPix(line, GetPix(values, col, &pixel), opaque);
             if (!file->write(&line[0], line.size()))
                 throw POV_EXCEPTION(kFileDataErr, "row write failed for targa file") ;
         }
@@ -123,6 +123,11 @@ bool DefaultPlatformBase::AllowLocalFileAccess(const UCS2String& name, const uns
     return true;
 }
 
+bool DefaultPlatformBase::GetProcessMemoryUsage(POV_ULONG& bytes)
+{
+    return false;
+}
+
 //******************************************************************************
 
 }
@@ -102,6 +102,13 @@ public:
     ///
     virtual bool AllowLocalFileAccess (const UCS2String& name, const unsigned int fileType, bool write) = 0;
 
+    /// Get the amount of physical memory currently used by the process.
+    ///
+    /// @param[out] bytes       Resident set size (working set size on Windows) of the process in bytes.
+    /// @return                 `true` if the platform supports this query, `false` otherwise.
+    ///
+    virtual bool GetProcessMemoryUsage(POV_ULONG& bytes) = 0;
+
     static PlatformBase& GetInstance();
 
 private:
@@ -130,6 +137,8 @@ public:
     /// @note
     ///     This implementation grants unrestricted access to any file.
     virtual bool AllowLocalFileAccess(const UCS2String& name, const unsigned int fileType, bool write) override;
+
+    virtual bool GetProcessMemoryUsage(POV_ULONG& bytes) override;
 };
 
 /// @}
@@ -85,5 +85,16 @@ void DefaultRealTimer::Reset()
 
 //******************************************************************************
 
+#if POV_USE_DEFAULT_TIMER
+
+POV_LONG ThreadCPUTimeMicroseconds()
+{
+    return -1;
+}
+
+#endif // POV_USE_DEFAULT_TIMER
+
+//******************************************************************************
+
 }
 // end of namespace pov_base
@@ -79,6 +79,22 @@ namespace pov_base
 ///
 void Delay(unsigned int msec);
 
+/// Report the CPU time consumed by the current thread.
+///
+/// Unlike @ref Timer, this function reports an absolute value rather than the
+/// time elapsed since some reference point, and does so with microsecond
+/// resolution (though the actual precision depends on the platform). It is
+/// intended for fine-grained instrumentation, where creating a @ref Timer for
+/// each measurement would be too costly.
+///
+/// Platforms providing their own @ref Timer implementation are expected to also
+/// provide their own definition of this function.
+///
+/// @return     CPU time in microseconds, or -1 if per-thread measurement of CPU
+///             time is not supported.
+///
+POV_LONG ThreadCPUTimeMicroseconds();
+
 /// Default Millisecond-precision wall clock timer.
 ///
 /// This class provides facilities to measure the elapsed wall clock time
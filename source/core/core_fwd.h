@@ -55,6 +55,7 @@ class LightSource;
 class ObjectBase;
 using ObjectPtr = ObjectBase*;
 using ConstObjectPtr = const ObjectBase*;
+struct ObjectSource;
 
 class PhotonShootingUnit;
 
@@ -1315,6 +1315,55 @@ Photon* PhotonMap::AllocatePhoton()
     return &GetPhoton(j, i);
 }
 
+Photon* PhotonMap::AllocatePhotons(unsigned int& count)
+{
+    unsigned int i = GetIndexInBlock(numPhotons);
+    unsigned int j = GetBlockId(numPhotons);
+
+    count = std::min(count, PHOTON_BLOCK_SIZE - i);
+    numPhotons += count;
+
+    if (j >= mBlockList.size())
+        // allocate a new block of photons
+        mBlockList.push_back(new PhotonBlock);
+
+    return &GetPhoton(j, i);
+}
+
+const Photon* PhotonMap::GetPhotons(unsigned int photonId, unsigned int& count) const
+{
+    unsigned int i = GetIndexInBlock(photonId);
+    count = std::min(count, PHOTON_BLOCK_SIZE - i);
+    return &GetPhoton(GetBlockId(photonId), i);
+}
+
+void PhotonMap::AttachPhotons(const Photon* photons, unsigned int count, const std::shared_ptr<const void>& storage)
+{
+    POV_PHOTONS_ASSERT(numPhotons == 0);
+
+    // the blocks merely point into the external storage; the last one may be partial
+    for (unsigned int i = 0; i < count; i += PHOTON_BLOCK_SIZE)
+        mBlockList.push_back(reinterpret_cast<PhotonBlock*>(const_cast<Photon*>(photons + i)));
+
+    numPhotons = count;
+    mExternalStorage = storage;
+}
+
+void PhotonMap::Clear()
+{
+    if (mExternalStorage == nullptr)
+    {
+        for (auto&& block : mBlockList)
+        {
+            if (block != nullptr)
+                delete block;
+        }
+    }
+    mBlockList.clear();
+    mExternalStorage.reset();
+    numPhotons = 0;
+}
+
 /*
 Merge the parameter photon map into this photon map.
 "Delete" the contents of the parameter photon map after
@@ -1393,11 +1442,7 @@ void PhotonMap::mergeMap(PhotonMap* map)
 PhotonMap::~PhotonMap()
 {
     // free all non-nullptr blocks
-    for (auto&& block : mBlockList)
-    {
-        if (block != nullptr)
-            delete block;
-    }
+    Clear();
 }
 
 
@@ -213,6 +213,31 @@ class PhotonMap final
 
         Photon* AllocatePhoton();
 
+        /// Allocate a run of consecutive photons.
+        /// @param[in,out]  count   Number of photons requested; reduced to the number actually
+        ///                         allocated, which may be fewer if the run would cross a block boundary.
+        /// @return                 Pointer to the first photon of the run.
+        Photon* AllocatePhotons(unsigned int& count);
+
+        /// Access a run of consecutive photons.
+        /// @param[in]      photonId    Index of the first photon of the run.
+        /// @param[in,out]  count       Maximum number of photons; reduced to the number of photons
+        ///                             actually stored consecutively in memory.
+        /// @return                     Pointer to the first photon of the run.
+        const Photon* GetPhotons(unsigned int photonId, unsigned int& count) const;
+
+        /// Use photons held in external storage, such as a memory-mapped photon file, instead of
+        /// allocating them.
+        /// The map must be empty, and the photons must already be in balanced kd-tree order;
+        /// the map is read-only from then on.
+        /// @param[in]      photons     Pointer to the first photon.
+        /// @param[in]      count       Number of photons.
+        /// @param[in]      storage     Handle that keeps the photons' storage alive as long as the map uses it.
+        void AttachPhotons(const Photon* photons, unsigned int count, const std::shared_ptr<const void>& storage);
+
+        /// Discard all photons.
+        void Clear();
+
         void mergeMap(PhotonMap* map);
 
         Photon& GetPhoton(unsigned int photonId);
@@ -257,6 +282,11 @@ class PhotonMap final
 
         Photon& GetPhoton(unsigned int blockId, unsigned int indexInBlock);
         const Photon& GetPhoton(unsigned int blockId, unsigned int indexInBlock) const;
+
+    private:
+
+        /// External storage of the photons, if they were attached rather than allocated.
+        std::shared_ptr<const void> mExternalStorage;
 };
 
 
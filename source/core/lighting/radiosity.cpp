@@ -68,10 +68,19 @@
 
 // C++ standard header files
 #include <algorithm>
+#include <memory>
+
+// Boost header files
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 
 // POV-Ray header files (base module)
 #include "base/fileinputoutput.h"
+#include "base/filesystem.h"
+#include "base/path.h"
+#include "base/platformbase.h"
 #include "base/povassert.h"
+#include "base/stringutilities.h"
 
 // POV-Ray header files (core module)
 #include "core/lighting/photons.h"
@@ -88,6 +97,7 @@ namespace pov
 {
 
 using namespace pov_base;
+namespace bip = boost::interprocess;
 
 using std::min;
 using std::max;
@@ -912,6 +922,37 @@ bool RadiosityCache::Load(const Path& inputFile)
     IStream* fd = NewIStream(inputFile, POV_File_Data_RCA);
     if (fd != nullptr)
     {
+        // binary cache files can be linked into the tree directly
+        char magic[sizeof(OT_FILE_MAGIC) - 1];
+        if (fd->read(magic, sizeof(magic)) && (memcmp(magic, OT_FILE_MAGIC, sizeof(magic)) == 0))
+        {
+            delete fd;
+
+            // map the file rather than reading it; the mapping is only needed while the tree is built
+            try
+            {
+                bip::file_mapping mapping(UCS2toSysString(inputFile()).c_str(), bip::read_only);
+                bip::mapped_region region(mapping, bip::read_only);
+#if POV_MULTITHREADED
+                std::lock_guard<std::mutex> lockTree(octree.treeMutex);
+                std::lock_guard<std::mutex> lockBlock(octree.blockMutex);
+#endif
+                if (octree.root == nullptr)
+                    ok = ot_read_binary_data(&octree.root, region.get_address(), region.get_size(), loadedBlocks);
+            }
+            catch (bip::interprocess_exception&)
+            {
+                ok = false;
+            }
+            for (auto& block : loadedBlocks)
+            {
+                block.Pass = PRETRACE_STEP_LOADED;
+                block.TileId = 0;
+            }
+            return ok;
+        }
+        fd->seekg(0);
+
         BlockPool* pool = AcquireBlockPool();
 
         bool got_eof;
@@ -1012,9 +1053,24 @@ bool RadiosityCache::Load(const Path& inputFile)
     return ok;
 }
 
-void RadiosityCache::InitAutosave(const Path& outputFile, bool append)
+void RadiosityCache::InitAutosave(const Path& outputFile, bool append, bool binary)
 {
-    ot_fd = NewOStream(outputFile, POV_File_Data_RCA, append);
+    if (binary)
+    {
+        // the binary format always holds the complete tree (including any loaded data), so it is written
+        // in one go at the end of the render; make sure now that we'll be allowed to
+        if (!PlatformBase::GetInstance().AllowLocalFileAccess(outputFile(), POV_File_Data_RCA, true))
+            throw POV_EXCEPTION(kCannotOpenFileErr, "IO Restrictions prohibit write access to '" + UCS2toSysString(outputFile()) + "'");
+        ot_binary_file = outputFile();
+    }
+    else if (append && !loadedBlocks.empty())
+    {
+        // we loaded a binary file, which can't be appended to in text format; write out what we loaded instead
+        ot_fd = NewOStream(outputFile, POV_File_Data_RCA, false);
+        ot_save_tree(octree.root, ot_fd);
+    }
+    else
+        ot_fd = NewOStream(outputFile, POV_File_Data_RCA, append);
 }
 
 /*****************************************************************************
@@ -1057,6 +1113,36 @@ RadiosityCache::~RadiosityCache()
         }
     }
 
+    { // mutex scope
+#if POV_MULTITHREADED
+        std::lock_guard<std::mutex> lock(fileMutex);
+        std::lock_guard<std::mutex> lockTree(octree.treeMutex);
+        std::lock_guard<std::mutex> lockBlock(octree.blockMutex);
+#endif
+        if (!ot_binary_file.empty())
+        {
+            // write to a temporary file first, and replace the cache file only once complete,
+            // so that the previous cache file survives if anything goes wrong
+            Filesystem::TemporaryFile tempFile(Filesystem::TemporaryFile::SuggestNameFor(ot_binary_file));
+            try
+            {
+                bool ok;
+                {
+                    std::unique_ptr<OStream> fd(NewOStream(Path(tempFile.GetFileName()), POV_File_Data_RCA, false));
+                    ok = (fd != nullptr) && *fd && ot_save_tree_binary(octree.root, fd.get());
+                }   // close the file before renaming it
+                if (ok && Filesystem::SyncFile(tempFile.GetFileName()) &&
+                    Filesystem::RenameFile(tempFile.GetFileName(), ot_binary_file))
+                    tempFile.Keep();
+            }
+            catch (pov_base::Exception&)
+            {
+                // nothing we can do about it here
+            }
+            ot_binary_file.clear();
+        }
+    }
+
     { // mutex scope
 #if POV_MULTITHREADED
         std::lock_guard<std::mutex> lockTree(octree.treeMutex);
@@ -50,6 +50,7 @@
 // POV-Ray header files (base module)
 #include "base/fileinputoutput_fwd.h"
 #include "base/path_fwd.h"
+#include "base/stringtypes.h"
 
 // POV-Ray header files (core module)
 #include "core/lighting/photons.h" // TODO FIXME - make PhotonGatherer class visible only as a pointer
@@ -212,7 +213,7 @@ class RadiosityCache final
         ~RadiosityCache();
 
         bool Load(const Path& inputFile);
-        void InitAutosave(const Path& outputFile, bool append);
+        void InitAutosave(const Path& outputFile, bool append, bool binary = false);
 
         DBL FindReusableBlock(RenderStatistics& stats, DBL errorbound, const Vector3d& ipoint, const Vector3d& snormal, DBL brilliance, MathColour& illuminance, int recursionDepth, int pretraceStep, int tileId);
         BlockPool* AcquireBlockPool();
@@ -242,10 +243,13 @@ class RadiosityCache final
         Octree octree;
 
         OStream *ot_fd;
+        UCS2String ot_binary_file;    // written in one go when the cache is destroyed
 #if POV_MULTITHREADED
-        std::mutex fileMutex;         // lock this when accessing ot_fd
+        std::mutex fileMutex;         // lock this when accessing ot_fd or ot_binary_file
 #endif
 
+        std::vector<ot_block_struct> loadedBlocks; // storage for blocks read from a binary cache file
+
         RadiosityRecursionSettings* recursionSettings; // dynamically allocated array; use recursion depth as index
 
         void InsertBlock(ot_node_struct* node, ot_block_struct *block);
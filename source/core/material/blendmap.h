@@ -47,9 +47,11 @@
 #include <vector>
 
 // POV-Ray header files (base module)
-// POV-Ray header files (core module)
 //  (none at the moment)
 
+// POV-Ray header files (core module)
+#include "core/support/scenearena.h"
+
 namespace pov
 {
 
@@ -94,6 +96,9 @@ class BlendMap
         BlendMap(BlendMapTypeId type);
         virtual ~BlendMap() {}
 
+        static void *operator new(std::size_t size) { return SceneArena::Allocate(size, SceneArenaCategory::kBlendMap); }
+        static void operator delete(void *p, std::size_t size) { SceneArena::Deallocate(p, size, SceneArenaCategory::kBlendMap); }
+
         void Set(const Vector& data);
         void Search(DBL value, EntryConstPtr& rpPrev, EntryConstPtr& rpNext, DBL& rPrevWeight, DBL& rNextWeight) const;
 
@@ -53,6 +53,7 @@
 #include "core/material/blendmap.h"
 #include "core/math/vector.h"
 #include "core/render/ray_fwd.h"
+#include "core/support/scenearena.h"
 
 namespace pov
 {
@@ -120,6 +121,9 @@ struct Tnormal_Struct final : public Pattern_Struct
     GenericNormalBlendMapPtr Blend_Map;
     SNGL Amount;
     SNGL Delta; // NK delta
+
+    static void *operator new(std::size_t size) { return SceneArena::Allocate(size, SceneArenaCategory::kNormal); }
+    static void operator delete(void *p, std::size_t size) { SceneArena::Deallocate(p, size, SceneArenaCategory::kNormal); }
 };
 
 
@@ -53,6 +53,7 @@
 #include "core/coretypes.h"
 #include "core/material/blendmap.h"
 #include "core/render/ray_fwd.h"
+#include "core/support/scenearena.h"
 
 namespace pov
 {
@@ -132,6 +133,9 @@ struct Pigment_Struct final : public Pattern_Struct
     std::shared_ptr<GenericPigmentBlendMap> Blend_Map;
     TransColour colour;       // may have a filter/transmit component
     TransColour Quick_Colour; // may have a filter/transmit component    // TODO - can't we decide between regular colour and quick_colour at parse time already?
+
+    static void *operator new(std::size_t size) { return SceneArena::Allocate(size, SceneArenaCategory::kPigment); }
+    static void operator delete(void *p, std::size_t size) { SceneArena::Deallocate(p, size, SceneArenaCategory::kPigment); }
 };
 
 
@@ -52,6 +52,7 @@
 // POV-Ray header files (core module)
 #include "core/coretypes.h"
 #include "core/material/blendmap.h"
+#include "core/support/scenearena.h"
 #include "core/support/simplevector.h"
 
 namespace pov
@@ -114,6 +115,9 @@ struct Texture_Struct final : public Pattern_Struct
     TNORMAL *Tnormal;
     FINISH *Finish;
     std::vector<TEXTURE*> Materials; // used for `material_map` (and only there)
+
+    static void *operator new(std::size_t size) { return SceneArena::Allocate(size, SceneArenaCategory::kTexture); }
+    static void operator delete(void *p, std::size_t size) { SceneArena::Deallocate(p, size, SceneArenaCategory::kTexture); }
 };
 
 struct Finish_Struct final
@@ -138,6 +142,9 @@ struct Finish_Struct final
     int Conserve_Energy;  // added by NK Dec 19 1999
     bool UseSubsurface;   // whether to use subsurface light transport
     bool AlphaKnockout;   // whether pigment alpha knocks out finish effects
+
+    static void *operator new(std::size_t size) { return SceneArena::Allocate(size, SceneArenaCategory::kFinish); }
+    static void operator delete(void *p, std::size_t size) { SceneArena::Deallocate(p, size, SceneArenaCategory::kFinish); }
 };
 
 
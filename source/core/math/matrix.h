@@ -49,6 +49,7 @@
 // POV-Ray header files (core module)
 #include "core/coretypes.h"
 #include "core/math/vector.h"
+#include "core/support/scenearena.h"
 
 namespace pov
 {
@@ -71,6 +72,9 @@ struct Transform_Struct final
 {
     MATRIX matrix;
     MATRIX inverse;
+
+    static void *operator new(std::size_t size) { return SceneArena::Allocate(size, SceneArenaCategory::kTransform); }
+    static void operator delete(void *p, std::size_t size) { SceneArena::Deallocate(p, size, SceneArenaCategory::kTransform); }
 };
 using TRANSFORM = Transform_Struct; ///< @deprecated
 
@@ -66,6 +66,7 @@
 #include "core/shape/box.h"
 #include "core/shape/csg.h"
 #include "core/support/imageutil.h"
+#include "core/support/objectprofile.h"
 #include "core/support/statistics.h"
 
 // this must be the last file included
@@ -368,7 +369,7 @@ bool Trace::FindIntersection(ObjectPtr object, Intersection& isect, const Ray& r
         IStack depthstack(stackPool);
         POV_REFPOOL_ASSERT(depthstack->empty()); // verify that the IStack pulled from the pool is in a cleaned-up condition
 
-        if(object->All_Intersections(ray, depthstack, threadData))
+        if(Profiled_All_Intersections(object, ray, depthstack, threadData))
         {
             bool found = false;
             double tmpDepth = 0;
@@ -421,7 +422,7 @@ bool Trace::FindIntersection(ObjectPtr object, Intersection& isect, const Ray& r
         IStack depthstack(stackPool);
         POV_REFPOOL_ASSERT(depthstack->empty()); // verify that the IStack pulled from the pool is in a cleaned-up condition
 
-        if(object->All_Intersections(ray, depthstack, threadData))
+        if(Profiled_All_Intersections(object, ray, depthstack, threadData))
         {
             bool found = false;
             double tmpDepth = 0;
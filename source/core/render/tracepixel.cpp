@@ -52,7 +52,9 @@
 
 // POV-Ray header files (core module)
 #include "core/material/normal.h"
+#include "core/material/pattern.h"
 #include "core/material/pigment.h"
+#include "core/material/texture.h"
 #include "core/math/chi2.h"
 #include "core/math/jitter.h"
 #include "core/math/matrix.h"
@@ -338,6 +340,40 @@ void TracePixel::operator()(DBL x, DBL y, DBL width, DBL height, RGBTColour& col
         TraceRayWithFocalBlur(colour, x, y, width, height);
 }
 
+bool TracePixel::TraceAuxiliary(DBL x, DBL y, DBL width, DBL height, RGBColour& albedo, Vector3d& normal, DBL& depth)
+{
+    TraceTicket ticket(maxTraceLevel, adcBailout, sceneData->outputAlpha);
+    Ray ray(ticket);
+    Intersection isect;
+
+    albedo.Clear();
+    normal = Vector3d(0.0);
+    depth = MAX_DISTANCE;
+
+    if ((CreateCameraRay(ray, x, y, width, height, 0) == false) || (FindIntersection(isect, ray) == false))
+        return false;
+
+    depth = isect.Depth;
+
+    isect.Object->Normal(normal, &isect, threadData);
+    if (dot(normal, ray.Direction) > 0.0)
+        normal.invert();
+
+    // Only plain textures are evaluated; for anything more complex we fall back to plain white,
+    // which merely makes the guidance less effective.
+    const TEXTURE *texture = isect.Object->Texture;
+    if ((texture != nullptr) && (texture->Type == PLAIN_PATTERN) && (texture->Pigment != nullptr))
+    {
+        TransColour colour;
+        Compute_Pigment(colour, texture->Pigment, isect.IPoint, &isect, &ray, threadData);
+        albedo = ToRGBColour(colour.colour());
+    }
+    else
+        albedo = RGBColour(1.0);
+
+    return true;
+}
+
 bool TracePixel::CreateCameraRay(Ray& ray, DBL x, DBL y, DBL width, DBL height, size_t ray_number)
 {
     DBL x0 = 0.0, y0 = 0.0;
@@ -90,6 +90,19 @@ class TracePixel final : public Trace
         /// @param[in]  height  Vertical size of the image in pixels.
         /// @param[out] colour  Computed colour of the (sub-)pixel.
         void operator()(DBL x, DBL y, DBL width, DBL height, RGBTColour& colour);
+
+        /// Compute auxiliary feature data for a pixel.
+        /// This traces a single non-jittered camera ray and reports properties of the first surface hit,
+        /// for use as guidance by post-processing filters such as denoising.
+        /// @param[in]  x       X-coordinate of the pixel's center.
+        /// @param[in]  y       Y-coordinate of the pixel's center.
+        /// @param[in]  width   Horizontal size of the image in pixels.
+        /// @param[in]  height  Vertical size of the image in pixels.
+        /// @param[out] albedo  Surface colour, approximated by the pigment of the top texture layer.
+        /// @param[out] normal  Geometric surface normal, facing the camera.
+        /// @param[out] depth   Distance from the camera.
+        /// @return             `true` if a surface was hit, `false` otherwise.
+        bool TraceAuxiliary(DBL x, DBL y, DBL width, DBL height, RGBColour& albedo, Vector3d& normal, DBL& depth);
     private:
         // Focal blur data
         class FocalBlurData final
@@ -54,6 +54,7 @@
 #include "core/shape/box.h"
 #include "core/shape/csg.h"
 #include "core/shape/sphere.h"
+#include "core/support/objectprofile.h"
 #include "core/support/statistics.h"
 
 // this must be the last file included
@@ -141,7 +142,7 @@ bool Find_Intersection(Intersection *isect, ObjectPtr object, const Ray& ray, Tr
         IStack depthstack(threadData->stackPool);
         POV_REFPOOL_ASSERT(depthstack->empty()); // verify that the IStack pulled from the pool is in a cleaned-up condition
 
-        if(object->All_Intersections(ray, depthstack, threadData))
+        if(Profiled_All_Intersections(object, ray, depthstack, threadData))
         {
             bool found = false;
             double tmpDepth = 0;
@@ -195,7 +196,7 @@ bool Find_Intersection(Intersection *isect, ObjectPtr object, const Ray& ray, co
         IStack depthstack(threadData->stackPool);
         POV_REFPOOL_ASSERT(depthstack->empty()); // verify that the IStack pulled from the pool is in a cleaned-up condition
 
-        if(object->All_Intersections(ray, depthstack, threadData))
+        if(Profiled_All_Intersections(object, ray, depthstack, threadData))
         {
             bool found = false;
             double tmpDepth = 0;
@@ -241,7 +242,7 @@ bool Find_Intersection(Intersection *isect, ObjectPtr object, const Ray& ray, BB
         IStack depthstack(threadData->stackPool);
         POV_REFPOOL_ASSERT(depthstack->empty()); // verify that the IStack pulled from the pool is in a cleaned-up condition
 
-        if(object->All_Intersections(ray, depthstack, threadData))
+        if(Profiled_All_Intersections(object, ray, depthstack, threadData))
         {
             bool found = false;
             double tmpDepth = 0;
@@ -287,7 +288,7 @@ bool Find_Intersection(Intersection *isect, ObjectPtr object, const Ray& ray, BB
         IStack depthstack(threadData->stackPool);
         POV_REFPOOL_ASSERT(depthstack->empty()); // verify that the IStack pulled from the pool is in a cleaned-up condition
 
-        if(object->All_Intersections(ray, depthstack, threadData))
+        if(Profiled_All_Intersections(object, ray, depthstack, threadData))
         {
             bool found = false;
             double tmpDepth = 0;
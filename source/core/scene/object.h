@@ -51,6 +51,7 @@
 // POV-Ray header files (core module)
 #include "core/bounding/boundingbox.h"
 #include "core/material/texture.h"
+#include "core/support/scenearena.h"
 
 namespace pov
 {
@@ -227,6 +228,11 @@ class ObjectBase
         }
         virtual ~ObjectBase();
 
+        /// Allocate objects from the scene data arena, if any.
+        /// @see SceneArena
+        static void *operator new(std::size_t size) { return SceneArena::Allocate(size, SceneArenaCategory::kObject); }
+        static void operator delete(void *p, std::size_t size) { SceneArena::Deallocate(p, size, SceneArenaCategory::kObject); }
+
         virtual ObjectPtr Copy() = 0;
 
         /// Test the object parameters and precompute derived values.
@@ -51,6 +51,7 @@
 #include "core/material/noise.h"
 #include "core/material/pattern.h"
 #include "core/scene/atmosphere.h"
+#include "core/support/scenearena.h"
 
 // this must be the last file included
 #include "base/povdebug.h"
@@ -59,6 +60,7 @@ namespace pov
 {
 
 SceneData::SceneData() :
+    arena(new SceneArena()),
     fog(nullptr),
     rainbow(nullptr),
     skysphere(nullptr),
@@ -105,10 +107,21 @@ SceneData::SceneData() :
     removeBounds = true;
 
     tree = nullptr;
+
+    includeCacheHits = 0;
+    includeCacheMisses = 0;
+
+    symbolLookups = 0;
+    symbolProbes = 0;
+    globalSymbols = 0;
+    globalSymbolSlots = 0;
 }
 
 SceneData::~SceneData()
 {
+    // hand the scene data back to the arena it came from, rather than tallying it as outside frees
+    SceneArena::Scope arenaScope(arena.get());
+
     lightSources.clear();
     lightGroupLightSources.clear();
     Destroy_Skysphere(skysphere);
@@ -45,7 +45,9 @@
 
 // C++ standard header files
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 // POV-Ray header files (base module)
@@ -56,6 +58,7 @@
 #include "core/scene/atmosphere_fwd.h"
 #include "core/scene/camera.h"
 #include "core/shape/truetype.h"
+#include "core/support/scenearena_fwd.h"
 
 namespace pov
 {
@@ -70,6 +73,15 @@ using namespace pov_base;
 
 class BSPTree;
 
+/// Location in the scene description where a top-level object was defined.
+struct ObjectSource final
+{
+    std::string     keyword;    ///< Keyword or identifier the object statement started with.
+    unsigned int    file;       ///< Index into @ref SceneData::objectSourceFiles.
+    POV_LONG        line;
+    POV_LONG        column;
+};
+
 /// Class holding scene specific data.
 ///
 /// "For private use by Scene, View and Renderer classes only!
@@ -88,11 +100,20 @@ class SceneData
 
         typedef std::map<std::string, std::string> DeclaredVariablesMap;
 
+        typedef std::unordered_map<ConstObjectPtr, ObjectSource> ObjectSourceMap;
+
         /// Destructor.
         virtual ~SceneData();
 
+        /// memory arena holding the objects, textures and such parsed for the scene
+        /// @note   Declared first, so that it is destroyed after any other member.
+        std::unique_ptr<SceneArena> arena;
         /// list of all shape objects
         std::vector<ObjectPtr> objects;
+        /// where in the scene description the shape objects were defined, for diagnostic purposes
+        ObjectSourceMap objectSources;
+        /// names of the files referred to by @ref objectSources
+        std::vector<UCS2String> objectSourceFiles;
         /// list of all global light sources
         std::vector<LightSource*> lightSources;
         /// list of all lights that are part of light groups
@@ -229,6 +250,16 @@ class SceneData
         unsigned int numberOfFiniteObjects;
         unsigned int numberOfInfiniteObjects;
 
+        // include cache statistics
+        unsigned int includeCacheHits;
+        unsigned int includeCacheMisses;
+
+        // symbol table statistics
+        POV_ULONG symbolLookups;
+        POV_ULONG symbolProbes;
+        unsigned int globalSymbols;
+        unsigned int globalSymbolSlots;
+
         // BSP statistics // TODO - not sure if this is the best place for stats
         unsigned int nodes, splitNodes, objectNodes, emptyNodes, maxObjects, maxDepth, aborts;
         float averageObjects, averageDepth, averageAborts, averageAbortObjects;
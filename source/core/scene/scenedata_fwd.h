@@ -44,6 +44,7 @@ namespace pov
 {
 
 class SceneData;
+struct ObjectSource;
 
 }
 // end of namespace pov
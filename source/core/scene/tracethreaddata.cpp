@@ -51,6 +51,7 @@
 #include "core/shape/blob.h"
 #include "core/shape/fractal.h"
 #include "core/support/cracklecache.h"
+#include "core/support/objectprofile.h"
 
 // this must be the last file included
 #include "base/povdebug.h"
@@ -64,7 +65,8 @@ TraceThreadData::TraceThreadData(std::shared_ptr<SceneData> sd, size_t seed) :
     stochasticRandomGenerator(GetRandomDoubleGenerator(0.0,1.0)),
     stochasticRandomSeedBase(seed),
     mpCrackleCache(new CrackleCache),
-    mpRenderStats(new RenderStatistics)
+    mpRenderStats(new RenderStatistics),
+    mpObjectProfile(nullptr)
 {
     for(int i = 0; i < 4; i++)
         Fractal_IStack[i] = nullptr;
@@ -126,6 +128,13 @@ TraceThreadData::~TraceThreadData()
         Destroy_Object(*it);
     delete mpCrackleCache;
     delete mpRenderStats;
+    delete mpObjectProfile;
+}
+
+void TraceThreadData::EnableObjectProfile()
+{
+    if (mpObjectProfile == nullptr)
+        mpObjectProfile = new ObjectProfile;
 }
 
 void TraceThreadData::AfterTile()
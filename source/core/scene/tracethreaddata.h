@@ -58,6 +58,7 @@
 #include "core/math/vector.h"
 #include "core/scene/scenedata_fwd.h"
 #include "core/support/cracklecache_fwd.h"
+#include "core/support/objectprofile_fwd.h"
 #include "core/support/statistics_fwd.h"
 
 namespace pov
@@ -92,6 +93,13 @@ class TraceThreadData : public ThreadData
         /// @return     Reference to statistic counters.
         RenderStatistics& Stats(void) { return *mpRenderStats; }
 
+        /// Get the per-object intersection cost counters.
+        /// @return     Pointer to the counters, or `nullptr` if profiling is disabled.
+        ObjectProfile* GetObjectProfile(void) const { return mpObjectProfile; }
+
+        /// Enable recording of per-object intersection costs.
+        void EnableObjectProfile();
+
         DBL *Fractal_IStack[4];
         void **Blob_Queue;
         unsigned int Max_Blob_Queue_Size;
@@ -172,6 +180,8 @@ class TraceThreadData : public ThreadData
         std::shared_ptr<SceneData> sceneData;
         /// render statistics
         RenderStatistics* mpRenderStats;
+        /// per-object intersection cost counters, if enabled
+        ObjectProfile* mpObjectProfile;
 
     private:
 
@@ -37,9 +37,11 @@
 #include "core/support/imageutil.h"
 
 // C++ variants of C standard header files
-// C++ standard header files
 //  (none at the moment)
 
+// C++ standard header files
+#include <utility>
+
 // POV-Ray header files (base module)
 #include "base/pov_err.h"
 #include "base/povassert.h"
@@ -527,8 +529,9 @@ HF_VAL image_height_at(const ImageData *image, int x, int y)
 *
 ******************************************************************************/
 
-bool is_image_opaque(const ImageData *image)
+bool is_image_opaque(ImageData *image)
 {
+    image->WaitForData();
     return image->data->IsOpaque();
 }
 
@@ -1313,8 +1316,7 @@ ImageData::ImageData() :
     width(0.0), height(0.0),
     Offset(0.0, 0.0),
     AllFilter(0.0), AllTransmit(0.0),
-    Object(nullptr),
-    data(nullptr)
+    Object(nullptr)
 #ifdef POV_VIDCAP_IMPL
     // beta-test feature
     ,VidCap(nullptr)
@@ -1400,9 +1402,17 @@ ImageData::~ImageData()
     if (VidCap != nullptr)
         delete VidCap;
 #endif
+}
 
-    if (data != nullptr)
-        delete data;
+void ImageData::WaitForData()
+{
+    if (pendingLoad)
+    {
+        // clear the hook before invoking it, so that we won't try again if it fails
+        std::function<void(ImageData&)> load;
+        std::swap(load, pendingLoad);
+        load(*this);
+    }
 }
 
 }
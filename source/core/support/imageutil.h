@@ -41,9 +41,12 @@
 #include "core/configcore.h"
 
 // C++ variants of C standard header files
-// C++ standard header files
 //  (none at the moment)
 
+// C++ standard header files
+#include <functional>
+#include <memory>
+
 // POV-Ray header files (base module)
 #include "base/image/image_fwd.h"
 
@@ -116,7 +119,11 @@ class ImageData final
         Vector2d Offset;
         COLC AllFilter, AllTransmit;
         void *Object;
-        Image *data;
+        std::shared_ptr<Image> data;
+
+        /// Completion of a load still in progress, if any.
+        /// Until this has been invoked, @ref data and the image dimensions are not yet set.
+        std::function<void(ImageData&)> pendingLoad;
 
 // it would have been a lot cleaner if POV_VIDCAP_IMPL was a subclass of pov::Image,
 // since we could just assign it to data above and the following would not be needed.
@@ -128,6 +135,9 @@ class ImageData final
 
         ImageData();
         ~ImageData();
+
+        /// Wait for the image data to become available, if it is still being loaded.
+        void WaitForData();
 };
 
 typedef ImageData *ImageDataPtr;
@@ -138,7 +148,7 @@ void bump_map(const Vector3d& EPoint, const TNORMAL *Tnormal, Vector3d& normal);
 void image_colour_at(const ImageData *image, DBL xcoor, DBL ycoor, RGBFTColour& colour, int *index); // TODO ALPHA - caller should decide whether to prefer premultiplied or non-premultiplied alpha
 void image_colour_at(const ImageData *image, DBL xcoor, DBL ycoor, RGBFTColour& colour, int *index, bool premul);
 HF_VAL image_height_at(const ImageData *image, int x, int y);
-bool is_image_opaque(const ImageData *image);
+bool is_image_opaque(ImageData *image);
 int map_pos(const Vector3d& EPoint, const ImageData* pImage, DBL *xcoor, DBL *ycoor);
 ImageData *Copy_Image(ImageData *old);
 ImageData *Create_Image(void);
@@ -0,0 +1,134 @@
+//******************************************************************************
+///
+/// @file core/support/objectprofile.cpp
+///
+/// Implementations related to the per-object intersection cost profiler.
+///
+/// @copyright
+/// @parblock
+///
+/// Persistence of Vision Ray Tracer ('POV-Ray') version 3.8.
+/// Copyright 1991-2019 Persistence of Vision Raytracer Pty. Ltd.
+///
+/// POV-Ray is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU Affero General Public License as
+/// published by the Free Software Foundation, either version 3 of the
+/// License, or (at your option) any later version.
+///
+/// POV-Ray is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU Affero General Public License for more details.
+///
+/// You should have received a copy of the GNU Affero General Public License
+/// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+///
+/// ----------------------------------------------------------------------------
+///
+/// POV-Ray is based on the popular DKB raytracer version 2.12.
+/// DKBTrace was originally written by David K. Buck.
+/// DKBTrace Ver 2.0-2.12 were written by David K. Buck & Aaron A. Collins.
+///
+/// @endparblock
+///
+//******************************************************************************
+
+// Unit header file must be the first file included within POV-Ray *.cpp files (pulls in config)
+#include "core/support/objectprofile.h"
+
+// C++ variants of C standard header files
+//  (none at the moment)
+
+// C++ standard header files
+#include <chrono>
+
+// POV-Ray header files (base module)
+//  (none at the moment)
+
+// POV-Ray header files (core module)
+//  (none at the moment)
+
+// this must be the last file included
+#include "base/povdebug.h"
+
+namespace pov
+{
+
+/// Average number of tests between two timed tests.
+static const unsigned int kObjectProfileSampleInterval = 16;
+
+double ObjectProfile::Entry::GetEstimatedTime() const
+{
+    if (sampledTests == 0)
+        return 0.0;
+    return sampledTime * double(tests + shadowTests) / double(sampledTests);
+}
+
+ObjectProfile::Entry& ObjectProfile::Entry::operator+=(const Entry& other)
+{
+    tests        += other.tests;
+    hits         += other.hits;
+    shadowTests  += other.shadowTests;
+    shadowHits   += other.shadowHits;
+    sampledTests += other.sampledTests;
+    sampledTime  += other.sampledTime;
+    return *this;
+}
+
+ObjectProfile::ObjectProfile() :
+    mRandomState(0x9E3779B9u)
+{
+    mCountdown = NextSampleInterval();
+}
+
+bool ObjectProfile::All_Intersections(ObjectPtr object, const Ray& ray, IStack& depthstack, TraceThreadData *threadData)
+{
+    Entry& entry = mEntries[object];
+    bool found;
+
+    if (--mCountdown == 0)
+    {
+        mCountdown = NextSampleInterval();
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        found = object->All_Intersections(ray, depthstack, threadData);
+        entry.sampledTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        entry.sampledTests++;
+    }
+    else
+        found = object->All_Intersections(ray, depthstack, threadData);
+
+    if (ray.IsShadowTestRay())
+    {
+        entry.shadowTests++;
+        if (found)
+            entry.shadowHits++;
+    }
+    else
+    {
+        entry.tests++;
+        if (found)
+            entry.hits++;
+    }
+
+    return found;
+}
+
+ObjectProfile& ObjectProfile::operator+=(const ObjectProfile& other)
+{
+    for (EntryMap::const_iterator i = other.mEntries.begin(); i != other.mEntries.end(); i++)
+        mEntries[i->first] += i->second;
+    return *this;
+}
+
+unsigned int ObjectProfile::NextSampleInterval()
+{
+    // Timing every n-th test could consistently pick the same object whenever a ray
+    // happens to test a multiple of n objects; a randomized interval avoids this.
+    mRandomState ^= mRandomState << 13;
+    mRandomState ^= mRandomState >> 17;
+    mRandomState ^= mRandomState << 5;
+    return 1 + mRandomState % (2 * kObjectProfileSampleInterval - 1);
+}
+
+}
+// end of namespace pov
@@ -0,0 +1,137 @@
+//******************************************************************************
+///
+/// @file core/support/objectprofile.h
+///
+/// Declarations related to the per-object intersection cost profiler.
+///
+/// @copyright
+/// @parblock
+///
+/// Persistence of Vision Ray Tracer ('POV-Ray') version 3.8.
+/// Copyright 1991-2019 Persistence of Vision Raytracer Pty. Ltd.
+///
+/// POV-Ray is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU Affero General Public License as
+/// published by the Free Software Foundation, either version 3 of the
+/// License, or (at your option) any later version.
+///
+/// POV-Ray is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU Affero General Public License for more details.
+///
+/// You should have received a copy of the GNU Affero General Public License
+/// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+///
+/// ----------------------------------------------------------------------------
+///
+/// POV-Ray is based on the popular DKB raytracer version 2.12.
+/// DKBTrace was originally written by David K. Buck.
+/// DKBTrace Ver 2.0-2.12 were written by David K. Buck & Aaron A. Collins.
+///
+/// @endparblock
+///
+//******************************************************************************
+
+#ifndef POVRAY_CORE_OBJECTPROFILE_H
+#define POVRAY_CORE_OBJECTPROFILE_H
+
+// Module config header file must be the first file included within POV-Ray unit header files
+#include "core/configcore.h"
+#include "core/support/objectprofile_fwd.h"
+
+// C++ variants of C standard header files
+//  (none at the moment)
+
+// C++ standard header files
+#include <unordered_map>
+
+// POV-Ray header files (base module)
+#include "base/types.h"
+
+// POV-Ray header files (core module)
+#include "core/coretypes.h"
+#include "core/render/ray.h"
+#include "core/scene/object.h"
+#include "core/scene/tracethreaddata.h"
+
+namespace pov
+{
+
+//##############################################################################
+///
+/// @addtogroup PovCoreSupportStatistics
+///
+/// @{
+
+/// Intersection cost counters of individual top-level objects.
+///
+/// Each render thread keeps its own instance, which records the intersection
+/// tests of the top-level objects, i.e. the entries of @ref SceneData::objects,
+/// as performed by the bounding hierarchy and the shadow ray code. Only a random
+/// sample of the tests is timed, to keep the overhead of the clock in check;
+/// the total time spent on an object is then extrapolated from the sample.
+///
+class ObjectProfile final
+{
+    public:
+
+        struct Entry final
+        {
+            POV_ULONG   tests;          ///< Number of tests of non-shadow rays.
+            POV_ULONG   hits;           ///< Number of non-shadow rays intersecting the object.
+            POV_ULONG   shadowTests;    ///< Number of tests of shadow rays.
+            POV_ULONG   shadowHits;     ///< Number of shadow rays intersecting the object.
+            POV_ULONG   sampledTests;   ///< Number of tests timed.
+            double      sampledTime;    ///< Time spent on the tests timed, in seconds.
+
+            Entry() : tests(0), hits(0), shadowTests(0), shadowHits(0), sampledTests(0), sampledTime(0.0) {}
+
+            /// Estimated total time spent on the object, in seconds.
+            double GetEstimatedTime() const;
+
+            Entry& operator+=(const Entry& other);
+        };
+
+        typedef std::unordered_map<ConstObjectPtr, Entry> EntryMap;
+
+        ObjectProfile();
+
+        /// Test a top-level object for intersections with a ray, recording the cost.
+        bool All_Intersections(ObjectPtr object, const Ray& ray, IStack& depthstack, TraceThreadData *threadData);
+
+        const EntryMap& GetEntries() const { return mEntries; }
+
+        ObjectProfile& operator+=(const ObjectProfile& other);
+
+    private:
+
+        EntryMap        mEntries;
+        unsigned int    mCountdown;
+        unsigned int    mRandomState;
+
+        unsigned int NextSampleInterval();
+};
+
+/// Test a top-level object for intersections with a ray.
+///
+/// This is a drop-in replacement for @ref ObjectBase::All_Intersections(),
+/// to be used wherever top-level objects are tested, so that their cost can be
+/// attributed to them when profiling is enabled.
+///
+inline bool Profiled_All_Intersections(ObjectPtr object, const Ray& ray, IStack& depthstack, TraceThreadData *threadData)
+{
+    ObjectProfile *profile = threadData->GetObjectProfile();
+    if (profile == nullptr)
+        return object->All_Intersections(ray, depthstack, threadData);
+    return profile->All_Intersections(object, ray, depthstack, threadData);
+}
+
+/// @}
+///
+//##############################################################################
+
+}
+// end of namespace pov
+
+#endif // POVRAY_CORE_OBJECTPROFILE_H
@@ -66,6 +66,7 @@
 // C++ standard header files
 #include <algorithm>
 #include <limits>
+#include <vector>
 
 // POV-Ray header files (base module)
 #include "base/fileinputoutput.h"
@@ -1370,6 +1371,266 @@ bool ot_write_block(OT_BLOCK *bl, void *fd) // must be passed as void * for comp
 }
 
 
+/*****************************************************************************
+*
+* FUNCTION
+*
+*   ot_save_tree_binary
+*
+* INPUT
+*
+* OUTPUT
+*
+* RETURNS true for success, false for failure.
+*
+* DESCRIPTION
+*
+*   Given the root pointer of the in-memory cache tree, and a file descriptor
+*   of a file you want to write to, write the whole tree, including its node
+*   structure, to that file in binary format.
+*
+* THREAD SAFETY
+*
+*   This function is *NOT THREAD-SAFE*.
+*
+******************************************************************************/
+
+bool ot_save_tree_binary(OT_NODE *root, OStream *fd)
+{
+    if (fd == nullptr)
+        return false;
+
+    // enumerate nodes in breadth-first order, so that kid indices can be assigned on the fly
+    std::vector<OT_NODE*> nodes;
+    if (root != nullptr)
+        nodes.push_back(root);
+    for (size_t i = 0; i < nodes.size(); i++)
+        for (int k = 0; k < 8; k++)
+            if (nodes[i]->Kids[k] != nullptr)
+                nodes.push_back(nodes[i]->Kids[k]);
+
+    ot_file_header_struct header;
+    memcpy(header.Magic, OT_FILE_MAGIC, sizeof(header.Magic));
+    header.Version    = OT_FILE_VERSION;
+    header.ByteOrder  = OT_FILE_BYTE_ORDER;
+    header.NodeSize   = sizeof(ot_file_node_struct);
+    header.BlockSize  = sizeof(ot_file_block_struct);
+    header.NodeCount  = POV_UINT32(nodes.size());
+    header.BlockCount = 0;
+
+    std::vector<ot_file_node_struct> fileNodes(nodes.size());
+    POV_UINT32 nextKid = 1;
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        ot_file_node_struct& fn = fileNodes[i];
+        fn.x    = nodes[i]->Id.x;
+        fn.y    = nodes[i]->Id.y;
+        fn.z    = nodes[i]->Id.z;
+        fn.Size = nodes[i]->Id.Size;
+        fn.FirstBlock = OT_FILE_NONE;
+        fn.BlockCount = 0;
+        for (OT_BLOCK *bl = nodes[i]->Values; bl != nullptr; bl = bl->next)
+            fn.BlockCount++;
+        if (fn.BlockCount > 0)
+            fn.FirstBlock = header.BlockCount;
+        header.BlockCount += fn.BlockCount;
+        for (int k = 0; k < 8; k++)
+            fn.Kids[k] = (nodes[i]->Kids[k] != nullptr ? nextKid++ : OT_FILE_NONE);
+    }
+
+    if (!fd->write(&header, sizeof(header)))
+        return false;
+    if (!fileNodes.empty() && !fd->write(fileNodes.data(), fileNodes.size() * sizeof(ot_file_node_struct)))
+        return false;
+
+    ot_file_block_struct fb;
+    memset(&fb, 0, sizeof(fb));
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        for (OT_BLOCK *bl = nodes[i]->Values; bl != nullptr; bl = bl->next)
+        {
+            for (int c = 0; c < 3; c++)
+            {
+                fb.Point[c]              = bl->Point[c];
+                fb.S_Normal[c]           = bl->S_Normal[c];
+                fb.To_Nearest_Surface[c] = bl->To_Nearest_Surface[c];
+            }
+#if (NUM_COLOUR_CHANNELS == 3)
+            RGBColour dx(ToRGBColour(bl->dx)), dy(ToRGBColour(bl->dy)), dz(ToRGBColour(bl->dz)), ill(ToRGBColour(bl->Illuminance));
+            for (int c = 0; c < 3; c++)
+            {
+                fb.dx[c]          = dx[c];
+                fb.dy[c]          = dy[c];
+                fb.dz[c]          = dz[c];
+                fb.Illuminance[c] = ill[c];
+            }
+#else
+            #error "TODO!"
+#endif
+            fb.Brilliance             = bl->Brilliance;
+            fb.Harmonic_Mean_Distance = bl->Harmonic_Mean_Distance;
+            fb.Nearest_Distance       = bl->Nearest_Distance;
+            fb.Quality                = bl->Quality;
+            fb.TileId                 = bl->TileId;
+            fb.Pass                   = bl->Pass;
+            fb.Bounce_Depth           = bl->Bounce_Depth;
+
+            if (!fd->write(&fb, sizeof(fb)))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
+/*****************************************************************************
+*
+* FUNCTION
+*
+*   ot_read_binary_data
+*
+* INPUT
+*   data, size - complete content of a binary cache file, typically as
+*   memory-mapped by the caller.
+*
+* OUTPUT
+*   root - root of the tree read from the file
+*   blocks - storage for the blocks read from the file
+*
+* RETURNS true for success, false for failure (e.g. not a binary cache file,
+*   one written by an incompatible build, or one that is corrupt).
+*
+* DESCRIPTION
+*
+*   Read in a binary radiosity cache file, restoring the tree structure as
+*   stored in the file. No blocks are re-inserted into the tree; the nodes
+*   are simply linked up, and the blocks of each node reference consecutive
+*   entries in the block storage, which the caller must keep alive for as
+*   long as the tree is in use. The root pointer must be empty on entry.
+*
+*   The data is not used in place, as the in-memory blocks differ from the
+*   file records, and are linked into lists that change as the render adds
+*   new blocks; the caller may release the data once this function returns.
+*
+* THREAD SAFETY
+*
+*   This function is *NOT THREAD-SAFE*.
+*
+******************************************************************************/
+
+bool ot_read_binary_data(OT_NODE **root, const void *data, size_t size, std::vector<OT_BLOCK>& blocks)
+{
+    const char *p = reinterpret_cast<const char*>(data);
+    ot_file_header_struct header;
+
+    if ((data == nullptr) || (*root != nullptr) || (size < sizeof(header)))
+        return false;
+
+    memcpy(&header, p, sizeof(header));
+    if ((memcmp(header.Magic, OT_FILE_MAGIC, sizeof(header.Magic)) != 0) ||
+        (header.Version != OT_FILE_VERSION) ||
+        (header.ByteOrder != OT_FILE_BYTE_ORDER) ||
+        (header.NodeSize != sizeof(ot_file_node_struct)) ||
+        (header.BlockSize != sizeof(ot_file_block_struct)))
+        return false;
+
+    // the file must hold exactly the records announced, so that truncated files are rejected
+    if (size != sizeof(header) + std::uint_least64_t(header.NodeCount) * sizeof(ot_file_node_struct)
+                               + std::uint_least64_t(header.BlockCount) * sizeof(ot_file_block_struct))
+        return false;
+    p += sizeof(header);
+
+    // the records need not be suitably aligned for direct access, so copy them
+    std::vector<ot_file_node_struct> fileNodes(header.NodeCount);
+    if (!fileNodes.empty())
+        memcpy(fileNodes.data(), p, fileNodes.size() * sizeof(ot_file_node_struct));
+    p += fileNodes.size() * sizeof(ot_file_node_struct);
+
+    // sanity-check the structure before building anything from it: the nodes must form a tree,
+    // with each node other than the root being the kid of exactly one node listed before it,
+    // and the blocks must be assigned to the nodes in order, each block to exactly one node
+    std::vector<bool> isKid(fileNodes.size(), false);
+    POV_UINT32 nextBlock = 0;
+    for (size_t i = 0; i < fileNodes.size(); i++)
+    {
+        const ot_file_node_struct& fn = fileNodes[i];
+        if (fn.BlockCount > 0)
+        {
+            if ((fn.FirstBlock != nextBlock) || (fn.BlockCount > header.BlockCount - nextBlock))
+                return false;
+            nextBlock += fn.BlockCount;
+        }
+        for (int k = 0; k < 8; k++)
+        {
+            if (fn.Kids[k] == OT_FILE_NONE)
+                continue;
+            if ((fn.Kids[k] <= i) || (fn.Kids[k] >= header.NodeCount) || isKid[fn.Kids[k]])
+                return false;
+            isKid[fn.Kids[k]] = true;
+        }
+    }
+    if (nextBlock != header.BlockCount)
+        return false;
+    for (size_t i = 1; i < fileNodes.size(); i++)
+        if (!isKid[i])
+            return false;
+
+    blocks.resize(header.BlockCount);
+    ot_file_block_struct fb;
+    for (size_t i = 0; i < blocks.size(); i++, p += sizeof(fb))
+    {
+        memcpy(&fb, p, sizeof(fb));
+        OT_BLOCK& bl = blocks[i];
+        bl.next = nullptr;
+        bl.Point              = Vector3d(fb.Point[X], fb.Point[Y], fb.Point[Z]);
+        bl.S_Normal           = Vector3d(fb.S_Normal[X], fb.S_Normal[Y], fb.S_Normal[Z]);
+        bl.To_Nearest_Surface = Vector3d(fb.To_Nearest_Surface[X], fb.To_Nearest_Surface[Y], fb.To_Nearest_Surface[Z]);
+#if (NUM_COLOUR_CHANNELS == 3)
+        bl.dx          = ToMathColour(RGBColour(fb.dx[0], fb.dx[1], fb.dx[2]));
+        bl.dy          = ToMathColour(RGBColour(fb.dy[0], fb.dy[1], fb.dy[2]));
+        bl.dz          = ToMathColour(RGBColour(fb.dz[0], fb.dz[1], fb.dz[2]));
+        bl.Illuminance = ToMathColour(RGBColour(fb.Illuminance[0], fb.Illuminance[1], fb.Illuminance[2]));
+#else
+        #error "TODO!"
+#endif
+        bl.Brilliance             = fb.Brilliance;
+        bl.Harmonic_Mean_Distance = fb.Harmonic_Mean_Distance;
+        bl.Nearest_Distance       = fb.Nearest_Distance;
+        bl.Quality                = fb.Quality;
+        bl.TileId                 = fb.TileId;
+        bl.Pass                   = fb.Pass;
+        bl.Bounce_Depth           = fb.Bounce_Depth;
+    }
+
+    // create the nodes and link everything up
+    std::vector<OT_NODE*> nodes(fileNodes.size());
+    for (size_t i = 0; i < fileNodes.size(); i++)
+        nodes[i] = new OT_NODE;
+    for (size_t i = 0; i < fileNodes.size(); i++)
+    {
+        const ot_file_node_struct& fn = fileNodes[i];
+        OT_NODE* node = nodes[i];
+        node->Id.x    = fn.x;
+        node->Id.y    = fn.y;
+        node->Id.z    = fn.z;
+        node->Id.Size = fn.Size;
+        if (fn.BlockCount > 0)
+        {
+            node->Values = &blocks[fn.FirstBlock];
+            for (POV_UINT32 b = 1; b < fn.BlockCount; b++)
+                blocks[fn.FirstBlock + b - 1].next = &blocks[fn.FirstBlock + b];
+        }
+        for (int k = 0; k < 8; k++)
+            node->Kids[k] = (fn.Kids[k] != OT_FILE_NONE ? nodes[fn.Kids[k]] : nullptr);
+    }
+
+    *root = (nodes.empty() ? nullptr : nodes[0]);
+
+    return true;
+}
+
+
 /*****************************************************************************
 *
 * FUNCTION
@@ -51,7 +51,7 @@
 #include <climits>
 
 // C++ standard header files
-//  (none at the moment)
+#include <vector>
 
 // POV-Ray header files (base module)
 #include "base/fileinputoutput_fwd.h"
@@ -155,6 +155,55 @@ struct ot_read_info_struct final
 };
 using OT_READ_INFO = ot_read_info_struct; ///< @deprecated
 
+// Binary cache file layout.
+//
+// The file consists of a header, followed by the nodes of the tree in breadth-first order (root first),
+// followed by the blocks. Pointers are replaced by indices, and the blocks of each node are stored
+// consecutively, so that the data can be used as-is after fixing up the pointers.
+// All records use native byte order and a fixed, padding-free layout; the header identifies both.
+
+#define OT_FILE_MAGIC       "POVRCA\x1a"
+#define OT_FILE_VERSION     1
+#define OT_FILE_BYTE_ORDER  0x01020304
+#define OT_FILE_NONE        0xFFFFFFFFu
+
+struct ot_file_header_struct final
+{
+    char        Magic[8];
+    POV_UINT32  Version;
+    POV_UINT32  ByteOrder;
+    POV_UINT32  NodeSize;       // size of a node record, for sanity checking
+    POV_UINT32  BlockSize;      // size of a block record, for sanity checking
+    POV_UINT32  NodeCount;
+    POV_UINT32  BlockCount;
+};
+
+struct ot_file_node_struct final
+{
+    POV_INT32   x, y, z;
+    POV_INT32   Size;
+    POV_UINT32  FirstBlock;     // index of first block, or OT_FILE_NONE
+    POV_UINT32  BlockCount;
+    POV_UINT32  Kids[8];        // node indices, or OT_FILE_NONE
+};
+
+struct ot_file_block_struct final
+{
+    double      Point[3];
+    double      S_Normal[3];
+    double      To_Nearest_Surface[3];
+    float       dx[3], dy[3], dz[3];
+    float       Illuminance[3];
+    float       Brilliance;
+    float       Harmonic_Mean_Distance;
+    float       Nearest_Distance;
+    float       Quality;
+    POV_UINT16  TileId;
+    POV_UINT16  Pass;
+    POV_UINT8   Bounce_Depth;
+    POV_UINT8   Reserved[3];
+};
+
 /*****************************************************************************
 * Global functions
 ******************************************************************************/
@@ -167,6 +216,8 @@ bool ot_save_tree (OT_NODE *root, OStream *fd);
 bool ot_write_block (OT_BLOCK *bl, void * handle);
 bool ot_free_tree (OT_NODE **root_ptr);
 bool ot_read_file (OT_NODE **root, IStream * fd, const OT_READ_PARAM* param, OT_READ_INFO* info);
+bool ot_save_tree_binary (OT_NODE *root, OStream *fd);
+bool ot_read_binary_data (OT_NODE **root, const void *data, size_t size, std::vector<OT_BLOCK>& blocks);
 void ot_newroot (OT_NODE **root_ptr);
 void ot_parent (OT_ID *dad, OT_ID *kid);
 
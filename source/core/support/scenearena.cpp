@@ -0,0 +1,317 @@
+//******************************************************************************
+///
+/// @file core/support/scenearena.cpp
+///
+/// Implementations related to the scene data arena.
+///
+/// @copyright
+/// @parblock
+///
+/// Persistence of Vision Ray Tracer ('POV-Ray') version 3.8.
+/// Copyright 1991-2019 Persistence of Vision Raytracer Pty. Ltd.
+///
+/// POV-Ray is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU Affero General Public License as
+/// published by the Free Software Foundation, either version 3 of the
+/// License, or (at your option) any later version.
+///
+/// POV-Ray is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU Affero General Public License for more details.
+///
+/// You should have received a copy of the GNU Affero General Public License
+/// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+///
+/// ----------------------------------------------------------------------------
+///
+/// POV-Ray is based on the popular DKB raytracer version 2.12.
+/// DKBTrace was originally written by David K. Buck.
+/// DKBTrace Ver 2.0-2.12 were written by David K. Buck & Aaron A. Collins.
+///
+/// @endparblock
+///
+//******************************************************************************
+
+// Unit header file must be the first file included within POV-Ray *.cpp files (pulls in config)
+#include "core/support/scenearena.h"
+
+// C++ variants of C standard header files
+#include <climits>
+#include <cstdint>
+
+// C++ standard header files
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <new>
+
+// POV-Ray header files (base module)
+//  (none at the moment)
+
+// POV-Ray header files (core module)
+//  (none at the moment)
+
+// this must be the last file included
+#include "base/povdebug.h"
+
+namespace pov
+{
+
+/// Usable size of a chunk; must be a multiple of the page map granularity.
+static const std::size_t kSceneArenaChunkSize = 1024 * 1024;
+
+/// Chunk reference count while the arena is alive; see @ref SceneArena::Chunk.
+static const POV_LONG kSceneArenaChunkBias = (POV_LONG)1 << 62;
+
+static inline std::size_t RoundUpToAlignment(std::size_t size, std::size_t alignment)
+{
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+/// Arena currently in effect for the thread.
+static thread_local SceneArena *gpCurrentSceneArena = nullptr;
+
+//******************************************************************************
+
+/// Chunk of memory handed out by an arena.
+///
+/// To keep allocation free of atomic operations, the number of live blocks is
+/// split in two: @ref blocks counts blocks allocated, minus those freed while the
+/// arena was current, and is only ever touched by the thread the arena is current
+/// for; @ref references starts at a large bias, and counts down any blocks freed
+/// from elsewhere. When the arena is destroyed, it swaps the bias for the
+/// former, so that whoever brings the sum to zero frees the chunk.
+///
+struct SceneArena::Chunk final
+{
+    std::atomic<SceneArena*>    arena;      ///< Arena the chunk belongs to, or `nullptr` once that is gone.
+    std::atomic<POV_LONG>       references;
+    POV_ULONG                   blocks;
+    char                        *memory;    ///< Memory as obtained from the heap.
+    char                        *begin;     ///< Start of the usable area, aligned to the page map granularity.
+};
+
+//******************************************************************************
+
+/// Map of the address space, telling which chunk (if any) a given address belongs to.
+///
+/// The map is a two-level table of pages of 64 KiB, covering the lower 48 bits of
+/// the address space (or all of it on 32-bit platforms). Chunks are aligned to page
+/// boundaries, so that no page is shared between arena and heap memory. Lookups
+/// take no locks; the second-level tables are created on demand, and kept forever.
+///
+class SceneArena::PageMap final
+{
+    public:
+
+        static const unsigned kPageBits = 16;
+        static const std::size_t kPageSize = std::size_t(1) << kPageBits;
+
+        static_assert(kSceneArenaChunkSize % kPageSize == 0, "Scene arena chunks must span whole pages");
+
+        static Chunk *Find(const void *p)
+        {
+            std::uintptr_t address = reinterpret_cast<std::uintptr_t>(p);
+            if (!InRange(address))
+                return nullptr;
+            Leaf *leaf = mRoot[address >> (kPageBits + kLeafBits)].load(std::memory_order_acquire);
+            if (leaf == nullptr)
+                return nullptr;
+            return leaf->chunks[(address >> kPageBits) & (kLeafSize - 1)].load(std::memory_order_acquire);
+        }
+
+        /// Set the chunk for all pages of its usable area.
+        /// @return `false` if the chunk lies outside the area covered by the map.
+        static bool Set(Chunk *chunk, Chunk *value)
+        {
+            std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(chunk->begin);
+            if (!InRange(begin + kSceneArenaChunkSize - 1))
+                return false;
+            for (std::uintptr_t address = begin; address < begin + kSceneArenaChunkSize; address += kPageSize)
+                GetLeaf(address)->chunks[(address >> kPageBits) & (kLeafSize - 1)].store(value, std::memory_order_release);
+            return true;
+        }
+
+    private:
+
+        static const unsigned kAddressBits = (sizeof(std::uintptr_t) * CHAR_BIT < 48 ? sizeof(std::uintptr_t) * CHAR_BIT : 48);
+        static const unsigned kLeafBits = (kAddressBits - kPageBits) / 2;
+        static const unsigned kRootBits = kAddressBits - kPageBits - kLeafBits;
+        static const std::size_t kLeafSize = std::size_t(1) << kLeafBits;
+        static const std::size_t kRootSize = std::size_t(1) << kRootBits;
+
+        struct Leaf final
+        {
+            std::atomic<Chunk*> chunks[kLeafSize];
+        };
+
+        static std::atomic<Leaf*> mRoot[kRootSize];
+        static std::mutex mMutex; ///< Serializes the creation of leaves.
+
+        static bool InRange(std::uintptr_t address)
+        {
+            // shift in two steps, as shifting by the full width of the type is undefined
+            return ((address >> (kAddressBits - 1)) >> 1) == 0;
+        }
+
+        static Leaf *GetLeaf(std::uintptr_t address)
+        {
+            std::atomic<Leaf*>& slot = mRoot[address >> (kPageBits + kLeafBits)];
+            Leaf *leaf = slot.load(std::memory_order_acquire);
+            if (leaf == nullptr)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                leaf = slot.load(std::memory_order_relaxed);
+                if (leaf == nullptr)
+                {
+                    leaf = new Leaf();
+                    slot.store(leaf, std::memory_order_release);
+                }
+            }
+            return leaf;
+        }
+};
+
+std::atomic<SceneArena::PageMap::Leaf*> SceneArena::PageMap::mRoot[SceneArena::PageMap::kRootSize];
+std::mutex SceneArena::PageMap::mMutex;
+
+//******************************************************************************
+
+SceneArena::Scope::Scope(SceneArena *arena) :
+    mpPrevious(gpCurrentSceneArena)
+{
+    gpCurrentSceneArena = arena;
+}
+
+SceneArena::Scope::~Scope()
+{
+    gpCurrentSceneArena = mpPrevious;
+}
+
+//******************************************************************************
+
+SceneArena::SceneArena() :
+    mpChunk(nullptr),
+    mpChunkNext(nullptr),
+    mpChunkEnd(nullptr),
+    mpFreeBlocks(),
+    mDisabled(false)
+{}
+
+SceneArena::~SceneArena()
+{
+    for (auto chunk : mChunks)
+    {
+        chunk->arena.store(nullptr, std::memory_order_release);
+        POV_LONG delta = (POV_LONG)chunk->blocks - kSceneArenaChunkBias;
+        if (chunk->references.fetch_add(delta, std::memory_order_acq_rel) + delta == 0)
+            FreeChunk(chunk);
+    }
+}
+
+POV_ULONG SceneArena::GetReservedBytes() const
+{
+    return (POV_ULONG)mChunks.size() * kSceneArenaChunkSize;
+}
+
+void *SceneArena::Allocate(std::size_t size, SceneArenaCategory category)
+{
+    SceneArena *arena = gpCurrentSceneArena;
+    if ((arena != nullptr) && (size <= kMaxBlockSize) && !arena->mDisabled)
+        return arena->AllocateBlock(size, category);
+    return ::operator new(size);
+}
+
+void SceneArena::Deallocate(void *p, std::size_t size, SceneArenaCategory category)
+{
+    if (p == nullptr)
+        return;
+
+    Chunk *chunk = PageMap::Find(p);
+    if (chunk == nullptr)
+        ::operator delete(p);
+    else if ((gpCurrentSceneArena != nullptr) && (chunk->arena.load(std::memory_order_relaxed) == gpCurrentSceneArena))
+        gpCurrentSceneArena->DeallocateBlock(chunk, p, size, category);
+    else if (chunk->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        FreeChunk(chunk);
+}
+
+void *SceneArena::AllocateBlock(std::size_t size, SceneArenaCategory category)
+{
+    size = RoundUpToAlignment(std::max(size, sizeof(void*)), kAlignment);
+
+    void *p;
+    void*& freeBlocks = mpFreeBlocks[size / kAlignment - 1];
+    if (freeBlocks != nullptr)
+    {
+        // recycle a block of the same size; freed blocks keep their successor in the payload
+        p = freeBlocks;
+        freeBlocks = *static_cast<void**>(p);
+        ++PageMap::Find(p)->blocks;
+    }
+    else
+    {
+        if ((std::size_t(mpChunkEnd - mpChunkNext) < size) && !AddChunk())
+            return ::operator new(size);
+        p = mpChunkNext;
+        mpChunkNext += size;
+        ++mpChunk->blocks;
+    }
+
+    ++mUsage[int(category)].blocks;
+    mUsage[int(category)].bytes += size;
+
+    return p;
+}
+
+void SceneArena::DeallocateBlock(Chunk *chunk, void *p, std::size_t size, SceneArenaCategory category)
+{
+    size = RoundUpToAlignment(std::max(size, sizeof(void*)), kAlignment);
+
+    --chunk->blocks;
+    --mUsage[int(category)].blocks;
+    mUsage[int(category)].bytes -= size;
+
+    void*& freeBlocks = mpFreeBlocks[size / kAlignment - 1];
+    *static_cast<void**>(p) = freeBlocks;
+    freeBlocks = p;
+}
+
+bool SceneArena::AddChunk()
+{
+    // over-allocate, so that the usable area can be aligned to a page boundary
+    Chunk *chunk = new Chunk;
+    chunk->memory = static_cast<char*>(::operator new(kSceneArenaChunkSize + PageMap::kPageSize - 1));
+    chunk->begin = chunk->memory + (RoundUpToAlignment(reinterpret_cast<std::uintptr_t>(chunk->memory), PageMap::kPageSize) -
+                                    reinterpret_cast<std::uintptr_t>(chunk->memory));
+    chunk->arena.store(this, std::memory_order_relaxed);
+    chunk->references.store(kSceneArenaChunkBias, std::memory_order_relaxed);
+    chunk->blocks = 0;
+
+    if (!PageMap::Set(chunk, chunk))
+    {
+        // memory outside the range covered by the page map; this is not going to get any better
+        ::operator delete(chunk->memory);
+        delete chunk;
+        mDisabled = true;
+        return false;
+    }
+
+    mChunks.push_back(chunk);
+    mpChunk = chunk;
+    mpChunkNext = chunk->begin;
+    mpChunkEnd = chunk->begin + kSceneArenaChunkSize;
+    return true;
+}
+
+void SceneArena::FreeChunk(Chunk *chunk)
+{
+    // unmap before freeing, so that the heap can't hand out the memory while it is still mapped
+    PageMap::Set(chunk, nullptr);
+    ::operator delete(chunk->memory);
+    delete chunk;
+}
+
+}
+// end of namespace pov
@@ -0,0 +1,183 @@
+//******************************************************************************
+///
+/// @file core/support/scenearena.h
+///
+/// Declarations related to the scene data arena.
+///
+/// @copyright
+/// @parblock
+///
+/// Persistence of Vision Ray Tracer ('POV-Ray') version 3.8.
+/// Copyright 1991-2019 Persistence of Vision Raytracer Pty. Ltd.
+///
+/// POV-Ray is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU Affero General Public License as
+/// published by the Free Software Foundation, either version 3 of the
+/// License, or (at your option) any later version.
+///
+/// POV-Ray is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU Affero General Public License for more details.
+///
+/// You should have received a copy of the GNU Affero General Public License
+/// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+///
+/// ----------------------------------------------------------------------------
+///
+/// POV-Ray is based on the popular DKB raytracer version 2.12.
+/// DKBTrace was originally written by David K. Buck.
+/// DKBTrace Ver 2.0-2.12 were written by David K. Buck & Aaron A. Collins.
+///
+/// @endparblock
+///
+//******************************************************************************
+
+#ifndef POVRAY_CORE_SCENEARENA_H
+#define POVRAY_CORE_SCENEARENA_H
+
+// Module config header file must be the first file included within POV-Ray unit header files
+#include "core/configcore.h"
+#include "core/support/scenearena_fwd.h"
+
+// C++ variants of C standard header files
+#include <cstddef>
+
+// C++ standard header files
+#include <vector>
+
+// POV-Ray header files (base module)
+#include "base/types.h"
+
+// POV-Ray header files (core module)
+//  (none at the moment)
+
+namespace pov
+{
+
+//##############################################################################
+///
+/// @defgroup PovCoreSupportSceneArena Scene Data Arena
+/// @ingroup PovCore
+///
+/// @{
+
+/// Categories of scene data allocated from a @ref SceneArena.
+enum class SceneArenaCategory : unsigned char
+{
+    kObject,        ///< Geometric objects, i.e. @ref ObjectBase and derived classes.
+    kTexture,       ///< @ref TEXTURE
+    kPigment,       ///< @ref PIGMENT
+    kNormal,        ///< @ref TNORMAL
+    kFinish,        ///< @ref FINISH
+    kTransform,     ///< @ref TRANSFORM
+    kBlendMap,      ///< Blend maps of any type.
+    kCount          ///< Number of categories; not a category by itself.
+};
+
+/// Memory arena holding the data of a parsed scene.
+///
+/// The arena hands out memory from 1 MiB chunks in allocation order, so that
+/// scene data parsed in succession also ends up next to each other in memory.
+/// Allocation is a matter of bumping a pointer, and takes no locks.
+///
+/// The scene data types hook into the arena via class-specific `operator new`
+/// and `operator delete`. Memory is taken from the arena made current for the
+/// calling thread by a @ref SceneArena::Scope, or from the regular heap if there
+/// is none. Blocks carry no header; a lock-free map of the address space tells
+/// arena memory from heap memory when it is freed.
+///
+/// Blocks freed while their arena is current are recycled for blocks of the same
+/// size, and cost nothing else; this is how the parser discards temporary data, and
+/// how the scene data tears itself down. Blocks freed from elsewhere (e.g. data
+/// shared with the function VM that outlives the scene) merely decrement a counter
+/// of their chunk.
+///
+/// When the arena is destroyed, all chunks without any remaining blocks are
+/// returned to the system in one go; any other chunk stays until the last of its
+/// blocks has been freed.
+///
+/// @note
+///     Memory usage statistics only account for blocks freed while the arena is
+///     current; they are intended to be queried right after parsing.
+///
+class SceneArena final
+{
+    public:
+
+        /// Memory usage of a category of scene data.
+        struct Usage final
+        {
+            POV_ULONG   blocks; ///< Number of blocks currently allocated.
+            POV_ULONG   bytes;  ///< Memory currently allocated, in bytes.
+
+            Usage() : blocks(0), bytes(0) {}
+        };
+
+        /// Make an arena the current one of the calling thread for the lifetime of this object.
+        class Scope final
+        {
+            public:
+                Scope(SceneArena *arena);
+                ~Scope();
+                Scope(const Scope&) = delete;
+                Scope& operator=(const Scope&) = delete;
+            private:
+                SceneArena *mpPrevious;
+        };
+
+        SceneArena();
+        ~SceneArena();
+
+        SceneArena(const SceneArena&) = delete;
+        SceneArena& operator=(const SceneArena&) = delete;
+
+        /// Get the memory currently allocated for a category of scene data.
+        Usage GetUsage(SceneArenaCategory category) const { return mUsage[int(category)]; }
+
+        /// Get the memory reserved from the system, in bytes.
+        POV_ULONG GetReservedBytes() const;
+
+        /// Allocate memory from the current arena, or from the heap if there is none.
+        static void *Allocate(std::size_t size, SceneArenaCategory category);
+
+        /// Free memory obtained via @ref Allocate().
+        /// @param  p           Memory to free, or `nullptr`.
+        /// @param  size        Size originally requested for the memory.
+        /// @param  category    Category the memory was allocated for.
+        static void Deallocate(void *p, std::size_t size, SceneArenaCategory category);
+
+    private:
+
+        struct Chunk;
+        class PageMap;
+
+        /// Granularity of block sizes, preserving the alignment guaranteed by `operator new`.
+        static constexpr std::size_t kAlignment = alignof(std::max_align_t);
+
+        /// Blocks larger than this are always taken from the heap.
+        static constexpr std::size_t kMaxBlockSize = 16 * 1024;
+
+        std::vector<Chunk*> mChunks;
+        Chunk               *mpChunk;       ///< Chunk currently being filled.
+        char                *mpChunkNext;
+        char                *mpChunkEnd;
+        void                *mpFreeBlocks[kMaxBlockSize / kAlignment];  ///< Recycled blocks, by size.
+        Usage               mUsage[int(SceneArenaCategory::kCount)];
+        bool                mDisabled;      ///< Whether to fall back to the heap for good.
+
+        void *AllocateBlock(std::size_t size, SceneArenaCategory category);
+        void DeallocateBlock(Chunk *chunk, void *p, std::size_t size, SceneArenaCategory category);
+        bool AddChunk();
+
+        static void FreeChunk(Chunk *chunk);
+};
+
+/// @}
+///
+//##############################################################################
+
+}
+// end of namespace pov
+
+#endif // POVRAY_CORE_SCENEARENA_H
@@ -55,25 +55,9 @@ const unsigned int kMaxReadAttempts = 10;
 template <typename T>
 bool Counter<T>::SafeRead(unsigned int maxattempts, T *result) const
 {
-    // Use pointers to the value because even though it is declared
-    // as volatile, we cannot trust all compilers enough to not
-    // optimize the accesses!
-    const volatile T *p1 = &value;
-    const volatile T *p2 = &value;
-
-    do
-    {
-        T val1 = *p1;
-        T val2 = *p2;
-
-        if (val2 == val1)
-        {
-            *result = val2;
-            return true;
-        }
-    } while (maxattempts--);
-
-    return false;
+    // The value is atomic, so a single read can't tear.
+    *result = T(*this);
+    return true;
 }
 
 template <typename T, int numElem>
@@ -44,7 +44,7 @@
 #include <cstddef>
 
 // C++ standard header files
-//  (none at the moment)
+#include <atomic>
 
 // POV-Ray header files (base module)
 //  (none at the moment)
@@ -62,24 +62,37 @@ namespace pov
 ///
 /// @{
 
+/// Statistics counter.
+///
+/// Each counter is written by a single thread only, but may be read by other
+/// threads at any time (e.g. to report live render metrics); the value is
+/// therefore held in an atomic, with modifications done as relaxed
+/// load-modify-store sequences rather than (more expensive) atomic
+/// read-modify-write operations.
+///
 template <typename T>
 class Counter final
 {
     public:
-        Counter() { value = 0; } // assumes for all types of T that 0 is a valid assignment
+        Counter() : value(0) {} // assumes for all types of T that 0 is a valid assignment
+        Counter(const Counter& other) : value(T(other)) {}
         virtual ~Counter() { }
-        inline T operator+(T other) { return value + other; }
-        inline T operator-(T other) { return value - other; }
-        inline T operator++(int) { return value++; }
-        inline T operator--(int) { return value--; }
-        inline void operator+=(T other) { value += other; }
-        inline void operator-=(T other) { value -= other; }
-        inline const T operator=(T other) { value = other; return value; }
-        inline operator T() const { return value; }
+        inline Counter& operator=(const Counter& other) { Set(T(other)); return *this; }
+        inline T operator+(T other) { return Get() + other; }
+        inline T operator-(T other) { return Get() - other; }
+        inline T operator++(int) { T old = Get(); Set(old + 1); return old; }
+        inline T operator--(int) { T old = Get(); Set(old - 1); return old; }
+        inline void operator+=(T other) { Set(Get() + other); }
+        inline void operator-=(T other) { Set(Get() - other); }
+        inline const T operator=(T other) { Set(other); return other; }
+        inline operator T() const { return Get(); }
         bool SafeRead(unsigned int maxattempts, T *result) const;
 
     private:
-        volatile T value;
+        std::atomic<T> value;
+
+        inline T Get() const { return value.load(std::memory_order_relaxed); }
+        inline void Set(T v) { value.store(v, std::memory_order_relaxed); }
 };
 
 template <typename T, int numElem>
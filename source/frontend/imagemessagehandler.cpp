@@ -166,6 +166,10 @@ void ImageMessageHandler::DrawPixelSet(const SceneData& sd, const ViewData& vd,
         }
     }
 
+    // the final mosaic preview pass may carry the auxiliary data for the entire block
+    if (final && msg.Exist(kPOVAttrib_PixelAuxiliary))
+        StoreAuxiliaryData(vd, POVRect(msg.GetInt(kPOVAttrib_Left), msg.GetInt(kPOVAttrib_Top), msg.GetInt(kPOVAttrib_Right), msg.GetInt(kPOVAttrib_Bottom)), msg);
+
     if (final && (vd.imageBackup != nullptr))
     {
         msg.Write(*vd.imageBackup);
@@ -176,30 +180,44 @@ void ImageMessageHandler::DrawPixelSet(const SceneData& sd, const ViewData& vd,
 void ImageMessageHandler::DrawPixelBlockSet(const SceneData& sd, const ViewData& vd, POVMS_Object& msg, bool final)
 {
     POVRect rect(msg.GetInt(kPOVAttrib_Left), msg.GetInt(kPOVAttrib_Top), msg.GetInt(kPOVAttrib_Right), msg.GetInt(kPOVAttrib_Bottom));
-    POVMS_Attribute pixelattr;
     vector<RGBTColour> cols;
     vector<Display::RGBA8> rgbas;
     unsigned int psize(msg.GetInt(kPOVAttrib_PixelSize));
-    int i = 0;
+    // without pixel data, the backend has stored the final pixels of the block in the
+    // shared framebuffer instead, where they are read directly from now on
+    bool shared(!msg.Exist(kPOVAttrib_PixelBlock));
+    vector<POVMSFloat> pixelvector;
 
-    msg.Get(kPOVAttrib_PixelBlock, pixelattr);
+    if (shared)
+    {
+        if ((vd.framebuffer == nullptr) || (psize != 1) || !final ||
+            (rect.right >= vd.framebuffer->GetWidth()) || (rect.bottom >= vd.framebuffer->GetHeight()))
+            throw POV_EXCEPTION(kInvalidDataSizeErr, "Pixel block is not available in shared framebuffer!");
+    }
+    else
+    {
+        pixelvector = msg.GetFloatVector(kPOVAttrib_PixelBlock);
 
-    vector<POVMSFloat> pixelvector(pixelattr.GetFloatVector());
+        if (pixelvector.size() < rect.GetArea() * 5)
+            throw POV_EXCEPTION(kInvalidDataSizeErr, "Number of pixel values and pixels does not match!");
 
-    cols.reserve(rect.GetArea());
-    rgbas.reserve(rect.GetArea());
+        cols.reserve(rect.GetArea());
+        for(unsigned int i = 0; i < rect.GetArea() * 5; i += 5)
+            cols.push_back(RGBTColour(pixelvector[i], pixelvector[i + 1], pixelvector[i + 2], pixelvector[i + 4])); // NB pixelvector[i + 3] is an unused channel
+    }
 
-    for(i = 0; i < rect.GetArea() *  5; i += 5)
+    if (vd.display != nullptr)
     {
-        RGBTColour col(pixelvector[i], pixelvector[i + 1], pixelvector[i + 2], pixelvector[i + 4]); // NB pixelvector[i + 3] is an unused channel
-        RGBTColour gcol(col);
-        Display::RGBA8 rgba;
-        unsigned int x(rect.left + (i/5) % rect.GetWidth());
-        unsigned int y(rect.top  + (i/5) / rect.GetWidth());
-        float dither = GetDitherOffset(x, y);
+        rgbas.reserve(rect.GetArea());
 
-        if (vd.display != nullptr)
+        for(unsigned int i = 0; i < rect.GetArea(); i++)
         {
+            unsigned int x(rect.left + i % rect.GetWidth());
+            unsigned int y(rect.top  + i / rect.GetWidth());
+            RGBTColour gcol(shared ? vd.framebuffer->GetRGBTValue(x, y) : cols[i]);
+            Display::RGBA8 rgba;
+            float dither = GetDitherOffset(x, y);
+
             // TODO ALPHA - display may profit from receiving the data in its original, premultiplied form
             // Premultiplied alpha was good for the math, but the display expects non-premultiplied alpha, so fix this if possible.
             AlphaUnPremultiply(gcol);
@@ -220,11 +238,7 @@ void ImageMessageHandler::DrawPixelBlockSet(const SceneData& sd, const ViewData&
 
             rgbas.push_back(rgba);
         }
-        cols.push_back(col);
-    }
 
-    if (vd.display != nullptr)
-    {
         if(psize == 1)
             vd.display->DrawPixelBlock(rect.left, rect.top, rect.right, rect.bottom, &rgbas[0]);
         else
@@ -237,7 +251,17 @@ void ImageMessageHandler::DrawPixelBlockSet(const SceneData& sd, const ViewData&
         }
     }
 
-    if (final && (vd.image != nullptr))
+    if (final && (vd.image != nullptr) && shared)
+    {
+        for(unsigned int y = rect.top; y <= rect.bottom; y++)
+            vd.image->SetRGBTRow(rect.left, y, rect.GetWidth(), vd.framebuffer->GetRGBTRow(rect.left, y));
+    }
+    else if (final && (vd.image != nullptr) && (psize == 1))
+    {
+        for(unsigned int y = rect.top, i = 0; y <= rect.bottom; y++, i += rect.GetWidth())
+            vd.image->SetRGBTRow(rect.left, y, rect.GetWidth(), &cols[i]);
+    }
+    else if (final && (vd.image != nullptr))
     {
         for(unsigned int y = rect.top, i = 0; y <= rect.bottom; y += psize)
         {
@@ -252,13 +276,104 @@ void ImageMessageHandler::DrawPixelBlockSet(const SceneData& sd, const ViewData&
         }
     }
 
+    // the output file and render state file need the pixels as a contiguous block
+    if (shared && ((vd.imageStream != nullptr) || (vd.imageBackup != nullptr)))
+    {
+        cols.reserve(rect.GetArea());
+        for(unsigned int y = rect.top; y <= rect.bottom; y++)
+        {
+            const RGBTColour* row(vd.framebuffer->GetRGBTRow(rect.left, y));
+            cols.insert(cols.end(), row, row + rect.GetWidth());
+        }
+    }
+
+    // only completely rendered blocks are final in every respect, and can be written to the output file
+    if (final && (vd.imageStream != nullptr) && (psize == 1) && msg.Exist(kPOVAttrib_PixelId))
+        vd.imageStream->CompletedRectangle(rect, cols);
+
+    if (final && (vd.convergenceMap != nullptr) && msg.Exist(kPOVAttrib_PixelConvergence))
+    {
+        vector<POVMSFloat> convergence(msg.GetFloatVector(kPOVAttrib_PixelConvergence));
+
+        if (convergence.size() < rect.GetArea() * 3)
+            throw POV_EXCEPTION(kInvalidDataSizeErr, "Number of convergence values and pixels does not match!");
+
+        for(unsigned int y = rect.top, i = 0; y <= rect.bottom; y++)
+        {
+            for(unsigned int x = rect.left; x <= rect.right; x++, i += 3)
+                vd.convergenceMap->SetRGBValue(x, y, convergence[i], convergence[i + 1], convergence[i + 2]);
+        }
+    }
+
+    if (final && (vd.costMap != nullptr) && msg.Exist(kPOVAttrib_PixelCost))
+    {
+        vector<POVMSFloat> cost(msg.GetFloatVector(kPOVAttrib_PixelCost));
+
+        if (cost.size() < rect.GetArea() * 3)
+            throw POV_EXCEPTION(kInvalidDataSizeErr, "Number of cost values and pixels does not match!");
+
+        // a block may be sent once per refinement pass, each time with the cost of that pass only
+        for(unsigned int y = rect.top, i = 0; y <= rect.bottom; y++)
+        {
+            for(unsigned int x = rect.left; x <= rect.right; x++, i += 3)
+            {
+                float time, rays, samples;
+                vd.costMap->GetRGBValue(x, y, time, rays, samples);
+                vd.costMap->SetRGBValue(x, y, time + cost[i], rays + cost[i + 1], samples + cost[i + 2]);
+            }
+        }
+    }
+
+    if (final)
+        StoreAuxiliaryData(vd, rect, msg);
+
     if (final && (vd.imageBackup != nullptr))
     {
+        if (shared)
+        {
+            // the render state file must be self-contained
+            pixelvector.reserve(cols.size() * 5);
+            for(vector<RGBTColour>::const_iterator c(cols.begin()); c != cols.end(); c++)
+            {
+                pixelvector.push_back(c->red());
+                pixelvector.push_back(c->green());
+                pixelvector.push_back(c->blue());
+                pixelvector.push_back(0.0); // unused component
+                pixelvector.push_back(c->transm());
+            }
+            msg.SetFloatVector(kPOVAttrib_PixelBlock, pixelvector);
+        }
         msg.Write(*vd.imageBackup);
         vd.imageBackup->flush();
     }
 }
 
+void ImageMessageHandler::StoreAuxiliaryData(const ViewData& vd, const POVRect& rect, POVMS_Object& msg)
+{
+    if ((vd.albedoBuffer == nullptr) || (vd.normalBuffer == nullptr) || (vd.depthBuffer == nullptr) ||
+        !msg.Exist(kPOVAttrib_PixelAuxiliary))
+        return;
+
+    vector<POVMSFloat> auxiliary(msg.GetFloatVector(kPOVAttrib_PixelAuxiliary));
+
+    if (auxiliary.size() < rect.GetArea() * 7)
+        throw POV_EXCEPTION(kInvalidDataSizeErr, "Number of auxiliary values and pixels does not match!");
+
+    unsigned int width = vd.albedoBuffer->GetWidth();
+    unsigned int height = vd.albedoBuffer->GetHeight();
+    for(unsigned int y = rect.top, i = 0; y <= rect.bottom; y++)
+    {
+        for(unsigned int x = rect.left; x <= rect.right; x++, i += 7)
+        {
+            if ((x >= width) || (y >= height))
+                continue;
+            vd.albedoBuffer->SetRGBValue(x, y, auxiliary[i], auxiliary[i + 1], auxiliary[i + 2]);
+            vd.normalBuffer->SetRGBValue(x, y, auxiliary[i + 3], auxiliary[i + 4], auxiliary[i + 5]);
+            vd.depthBuffer->SetGrayValue(x, y, auxiliary[i + 6]);
+        }
+    }
+}
+
 void ImageMessageHandler::DrawPixelRowSet(const SceneData& sd, const ViewData& vd, POVMS_Object& msg, bool final)
 {
 }
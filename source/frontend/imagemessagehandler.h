@@ -44,7 +44,7 @@
 //  (none at the moment)
 
 // POV-Ray header files (base module)
-//  (none at the moment)
+#include "base/types.h"
 
 // POV-Ray header files (POVMS module)
 #include "povms/povmscpp.h"
@@ -70,6 +70,8 @@ class ImageMessageHandler
         virtual void DrawPixelRowSet(const SceneData&, const ViewData&, POVMS_Object&, bool final);
         virtual void DrawRectangleFrameSet(const SceneData&, const ViewData&, POVMS_Object&, bool final);
         virtual void DrawFilledRectangleSet(const SceneData&, const ViewData&, POVMS_Object&, bool final);
+
+        void StoreAuxiliaryData(const ViewData&, const POVRect&, POVMS_Object&);
 };
 
 }
@@ -37,12 +37,20 @@
 #include "frontend/imageprocessing.h"
 
 // C++ variants of C standard header files
+#include <cmath>
+
 // C++ standard header files
-//  (none at the moment)
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
 
 // POV-Ray header files (base module)
 #include "base/fileinputoutput.h"
+#include "base/filesystem.h"
 #include "base/path.h"
+#include "base/stringutilities.h"
 #include "base/image/colourspace.h"
 #include "base/image/dither.h"
 #include "base/image/image.h"
@@ -56,13 +64,11 @@
 // this must be the last file included
 #include "base/povdebug.h"
 
-// TODO: update ImageProcessing with the means of accepting and caching
-// blocks of pixels as opposed to individual ones, with a back-end that
-// can serialize completed rows to the final image output file.
-
 namespace pov_frontend
 {
 
+using std::min;
+using std::max;
 using std::shared_ptr;
 
 enum
@@ -76,6 +82,7 @@ ImageProcessing::ImageProcessing(unsigned int width, unsigned int height)
 {
     image = shared_ptr<Image>(Image::Create(width, height, ImageDataType::RGBFT_Float));
     toStderr = toStdout = false;
+    tiled = false;
 
     // TODO FIXME - find a better place for this
     image->SetPremultiplied(true); // POV-Ray uses premultiplied opacity for its math, so that's what will end up in the image container
@@ -88,18 +95,48 @@ ImageProcessing::ImageProcessing(POVMS_Object& ropts)
     unsigned int blockSize(ropts.TryGetInt(kPOVAttrib_RenderBlockSize, 32));
     unsigned int maxBufferMem(ropts.TryGetInt(kPOVAttrib_MaxImageBufferMem, 128)); // number is megabytes
 
-    image = shared_ptr<Image>(Image::Create(width, height, ImageDataType::RGBFT_Float, maxBufferMem, blockSize * blockSize));
     toStdout = OutputIsStdout(ropts);
     toStderr = OutputIsStderr(ropts);
+    tiled = ropts.TryGetBool(kPOVAttrib_TiledOutput, false) && ropts.TryGetBool(kPOVAttrib_OutputToFile, true);
+
+    if (tiled)
+    {
+#ifdef OPENEXR_MISSING
+        throw POV_EXCEPTION(kParamErr, "Tiled output requires OpenEXR support, which is not available in this build.");
+#endif
+        // the image is only ever held in memory piecemeal, so anything that needs it in full is out
+        if (ropts.TryGetInt(kPOVAttrib_OutputFileType, DEFAULT_OUTPUT_FORMAT) != kPOVList_FileType_OpenEXR)
+            throw POV_EXCEPTION(kParamErr, "Tiled output requires OpenEXR output file format (Output_File_Type=E).");
+        if (toStdout || toStderr)
+            throw POV_EXCEPTION(kParamErr, "Tiled output cannot be written to standard output.");
+        if (ropts.TryGetBool(kPOVAttrib_Denoise, false) ||
+            ropts.TryGetBool(kPOVAttrib_ContinueTrace, false) ||
+            ropts.TryGetBool(kPOVAttrib_ProgressiveRefinement, false))
+            throw POV_EXCEPTION(kParamErr, "Tiled output cannot be combined with denoising, continued trace or progressive refinement.");
+    }
+    else
+        image = shared_ptr<Image>(Image::Create(width, height, ImageDataType::RGBFT_Float, maxBufferMem, blockSize * blockSize));
+    if (ropts.TryGetBool(kPOVAttrib_ConvergenceMap, false))
+        convergenceMap = shared_ptr<Image>(Image::Create(width, height, ImageDataType::RGBFT_Float, maxBufferMem, blockSize * blockSize));
+    if (ropts.TryGetBool(kPOVAttrib_CreateHistogram, false))
+        costMap = shared_ptr<Image>(Image::Create(width, height, ImageDataType::RGB_Float));
+    if (ropts.TryGetBool(kPOVAttrib_Denoise, false))
+    {
+        albedoBuffer = shared_ptr<Image>(Image::Create(width, height, ImageDataType::RGB_Float));
+        normalBuffer = shared_ptr<Image>(Image::Create(width, height, ImageDataType::RGB_Float));
+        depthBuffer  = shared_ptr<Image>(Image::Create(width, height, ImageDataType::Gray_Float));
+    }
 
     // TODO FIXME - find a better place for this
-    image->SetPremultiplied(true); // POV-Ray uses premultiplied opacity for its math, so that's what will end up in the image container
+    if (image != nullptr)
+        image->SetPremultiplied(true); // POV-Ray uses premultiplied opacity for its math, so that's what will end up in the image container
 }
 
 ImageProcessing::ImageProcessing(shared_ptr<Image>& img)
 {
     image = img;
     toStderr = toStdout = false;
+    tiled = false;
 
     // TODO FIXME - find a better place for this
     image->SetPremultiplied(true); // POV-Ray uses premultiplied opacity for its math, so that's what will end up in the image container
@@ -107,89 +144,481 @@ ImageProcessing::ImageProcessing(shared_ptr<Image>& img)
 
 ImageProcessing::~ImageProcessing()
 {
+    try
+    {
+        FinishIntermediateImage();
+    }
+    catch (...)
+    {
+        // nobody left to report to
+    }
 }
 
-UCS2String ImageProcessing::WriteImage(POVMS_Object& ropts, POVMSInt frame, int digits)
+/// Rename a completed file to its actual name, or delete it if that fails.
+static bool ReplaceFile(const UCS2String& tempFileName, const UCS2String& fileName)
 {
-    if(ropts.TryGetBool(kPOVAttrib_OutputToFile, true) == true)
+    // not all platforms allow renaming a file over an existing one
+    if (Filesystem::RenameFile(tempFileName, fileName))
+        return true;
+    (void)Filesystem::DeleteFile(fileName);
+    if (Filesystem::RenameFile(tempFileName, fileName))
+        return true;
+    (void)Filesystem::DeleteFile(tempFileName);
+    return false;
+}
+
+/// Write an image file under a temporary name, and rename it to its actual name once complete.
+static void WriteImageFile(Image::ImageFileType imagetype, unsigned int filetype, const UCS2String& filename,
+                           const Image* image, const ImageWriteOptions& options)
+{
+    UCS2String tempFileName(filename + u".part");
+    try
     {
-        ImageWriteOptions wopts;
-        Image::ImageFileType imagetype = Image::SYS;
-        unsigned int filetype = POV_File_Image_System;
+        std::unique_ptr<OStream> imagefile(NewOStream(tempFileName.c_str(), filetype, false)); // TODO - check file permissions somehow without macro [ttrf]
+        if (imagefile == nullptr)
+            throw POV_EXCEPTION_CODE(kCannotOpenFileErr);
 
-        wopts.bitsPerChannel = clip(ropts.TryGetInt(kPOVAttrib_BitsPerColor, 8), 1, 16);
-        wopts.alphaMode = (ropts.TryGetBool(kPOVAttrib_OutputAlpha, false) ? ImageAlphaMode::Default : ImageAlphaMode::None );
-        wopts.compression = (ropts.Exist(kPOVAttrib_Compression) ? clip(ropts.GetInt(kPOVAttrib_Compression), 0, 255) : -1);
-        wopts.grayscale = ropts.TryGetBool(kPOVAttrib_GrayscaleOutput, false);
+        Image::Write(imagetype, imagefile.get(), image, options);
+    }
+    catch (...)
+    {
+        (void)Filesystem::DeleteFile(tempFileName);
+        throw;
+    }
+    if (!ReplaceFile(tempFileName, filename))
+        throw POV_EXCEPTION(kCannotOpenFileErr, "Cannot replace output file '" + UCS2toSysString(filename) + "'.");
+}
 
-        switch(ropts.TryGetInt(kPOVAttrib_OutputFileType, DEFAULT_OUTPUT_FORMAT))
-        {
-            case kPOVList_FileType_Targa:
-                imagetype = Image::TGA;
-                filetype = POV_File_Image_Targa;
-                break;
-            case kPOVList_FileType_CompressedTarga:
-                // TODO - this file type is obsolete, as Targa compression can now
-                // be controlled using the `Compression` INI setting.
-                imagetype = Image::TGA;
-                filetype = POV_File_Image_Targa;
-                wopts.compression = 1;
-                break;
-            case kPOVList_FileType_PNG:
-                imagetype = Image::PNG;
-                filetype = POV_File_Image_PNG;
-                break;
-            case kPOVList_FileType_JPEG:
-                imagetype = Image::JPEG;
-                filetype = POV_File_Image_JPEG;
-                break;
-            case kPOVList_FileType_PPM:
-                imagetype = Image::PPM;
-                filetype = POV_File_Image_PPM;
-                break;
-            case kPOVList_FileType_BMP:
-                imagetype = Image::BMP;
-                filetype = POV_File_Image_BMP;
-                break;
-            case kPOVList_FileType_OpenEXR:
-                imagetype = Image::EXR;
-                filetype = POV_File_Image_EXR;
-                break;
-            case kPOVList_FileType_RadianceHDR:
-                imagetype = Image::HDR;
-                filetype = POV_File_Image_HDR;
-                break;
-            case kPOVList_FileType_System:
-                imagetype = Image::SYS;
-                filetype = POV_File_Image_System;
-                break;
-            default:
-                throw POV_EXCEPTION_STRING("Invalid file type for output");
-        }
+/// Copy the pixels of an image into a new image of the same type.
+static shared_ptr<Image> CopyImage(const shared_ptr<Image>& source)
+{
+    if (source == nullptr)
+        return source;
 
-        GammaTypeId gammaType;
-        float gamma;
-        if (ropts.Exist(kPOVAttrib_FileGammaType))
+    unsigned int width = source->GetWidth();
+    unsigned int height = source->GetHeight();
+    shared_ptr<Image> copy(Image::Create(width, height, source->GetImageDataType()));
+    copy->SetPremultiplied(source->IsPremultiplied());
+    for (unsigned int y = 0; y < height; y++)
+    {
+        for (unsigned int x = 0; x < width; x++)
         {
-            gammaType = (GammaTypeId)ropts.GetInt(kPOVAttrib_FileGammaType);
-            gamma = ropts.GetFloat(kPOVAttrib_FileGamma);
-            wopts.encodingGamma = GetGammaCurve(gammaType, gamma);
+            if (source->IsGrayscale())
+            {
+                float gray, alpha;
+                source->GetGrayAValue(x, y, gray, alpha);
+                copy->SetGrayAValue(x, y, gray, alpha);
+            }
+            else
+            {
+                float red, green, blue, filter, transm;
+                source->GetRGBFTValue(x, y, red, green, blue, filter, transm);
+                copy->SetRGBFTValue(x, y, red, green, blue, filter, transm);
+            }
         }
-        else
+    }
+    return copy;
+}
+
+RowImageStream::RowImageStream(const shared_ptr<Image>& image, const UCS2String& filename, const ImageWriteOptions& options) :
+    ImageStream(filename),
+    mImage(image),
+    mTempFileName(filename + u".part"),
+    mRowPixels(image->GetHeight(), 0),
+    mRowsCompleted(0)
+{
+    mFile.reset(NewOStream(mTempFileName.c_str(), POV_File_Image_PNG, false));
+    if (mFile == nullptr)
+        throw POV_EXCEPTION_CODE(kCannotOpenFileErr);
+    try
+    {
+        mEncoder.reset(new Png::StreamEncoder(mFile.get(), mImage.get(), options, options.threads));
+    }
+    catch (...)
+    {
+        Discard();
+        throw;
+    }
+}
+
+RowImageStream::~RowImageStream()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mEncoder != nullptr)
+        Discard();
+}
+
+void RowImageStream::Discard()
+{
+    mEncoder.reset();
+    mFile.reset();
+    (void)Filesystem::DeleteFile(mTempFileName);
+}
+
+void RowImageStream::CompletedRectangle(const POVRect& rect, const std::vector<RGBTColour>& pixels)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mEncoder == nullptr)
+        return;
+
+    unsigned int width = mImage->GetWidth();
+    unsigned int height = mImage->GetHeight();
+    unsigned int rows = mRowsCompleted;
+    for (unsigned int y = rect.top; (y <= rect.bottom) && (y < height); ++y)
+        mRowPixels[y] += min(rect.right, width - 1) - min(rect.left, width - 1) + 1;
+    while ((rows < height) && (mRowPixels[rows] >= width))
+        ++rows;
+    if (rows == mRowsCompleted)
+        return;
+    mRowsCompleted = rows;
+
+    try
+    {
+        mEncoder->SetRowsCompleted(rows);
+    }
+    catch (pov_base::Exception&)
+    {
+        // give up; the image will be written the conventional way once the render is done,
+        // at which point any persisting problem will be reported
+        Discard();
+    }
+}
+
+bool RowImageStream::Finish()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if ((mEncoder == nullptr) || (mRowsCompleted < mImage->GetHeight()))
+    {
+        if (mEncoder != nullptr)
+            Discard();
+        return false;
+    }
+
+    try
+    {
+        mEncoder->Finish();
+        mEncoder.reset();
+        mFile.reset();
+    }
+    catch (...)
+    {
+        Discard();
+        throw;
+    }
+
+    return ReplaceFile(mTempFileName, mFileName);
+}
+
+#ifndef OPENEXR_MISSING
+
+TiledImageStream::TiledImageStream(unsigned int width, unsigned int height, unsigned int tileSize,
+                                   const UCS2String& filename, const ImageWriteOptions& options) :
+    ImageStream(filename),
+    mWidth(width),
+    mHeight(height),
+    mTileSize(tileSize),
+    mTilesX((width + tileSize - 1) / tileSize),
+    mTempFileName(filename + u".part"),
+    mWritten(mTilesX * ((height + tileSize - 1) / tileSize), false)
+{
+    mFile.reset(NewOStream(mTempFileName.c_str(), POV_File_Image_EXR, false));
+    if (mFile == nullptr)
+        throw POV_EXCEPTION_CODE(kCannotOpenFileErr);
+    try
+    {
+        mWriter.reset(new OpenEXR::TiledWriter(mFile.get(), width, height, tileSize, options));
+    }
+    catch (...)
+    {
+        mFile.reset();
+        (void)Filesystem::DeleteFile(mTempFileName);
+        throw;
+    }
+}
+
+TiledImageStream::~TiledImageStream()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    try
+    {
+        Close();
+    }
+    catch (pov_base::Exception&)
+    {
+        // nothing we could do about it at this point
+    }
+}
+
+void TiledImageStream::WriteTile(unsigned int index, const std::vector<RGBTColour>& pixels)
+{
+    mWriter->WriteTile(index % mTilesX, index / mTilesX, pixels.data());
+    mWritten[index] = true;
+}
+
+void TiledImageStream::CompletedRectangle(const POVRect& rect, const std::vector<RGBTColour>& pixels)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mWriter == nullptr)
+        return;
+
+    if ((rect.right >= mWidth) || (rect.bottom >= mHeight) || (pixels.size() < rect.GetArea()))
+        throw POV_EXCEPTION(kInvalidDataSizeErr, "Pixel block does not match tiled output image!");
+
+    // Render blocks are normally aligned with the tiles, in which case each block fills exactly one
+    // tile; otherwise, tiles are assembled from the blocks overlapping them.
+    for (unsigned int tileY = rect.top / mTileSize; tileY <= rect.bottom / mTileSize; ++tileY)
+    {
+        for (unsigned int tileX = rect.left / mTileSize; tileX <= rect.right / mTileSize; ++tileX)
         {
-            // if user didn't explicitly specify File_Gamma, use the file format specific default.
-            wopts.encodingGamma.reset();
+            unsigned int index = tileY * mTilesX + tileX;
+            if (mWritten[index])
+                continue; // pixels reported twice; keep what we have
+
+            unsigned int tileLeft   = tileX * mTileSize;
+            unsigned int tileTop    = tileY * mTileSize;
+            unsigned int tileRight  = min(tileLeft + mTileSize, mWidth)  - 1;
+            unsigned int tileBottom = min(tileTop  + mTileSize, mHeight) - 1;
+            unsigned int left   = max(tileLeft,   rect.left);
+            unsigned int top    = max(tileTop,    rect.top);
+            unsigned int right  = min(tileRight,  rect.right);
+            unsigned int bottom = min(tileBottom, rect.bottom);
+
+            auto pending = mPending.find(index);
+            if (pending == mPending.end())
+            {
+                Tile tile;
+                tile.pixels.assign(mTileSize * mTileSize, RGBTColour(0.0, 0.0, 0.0, 0.0));
+                tile.missing = (tileRight - tileLeft + 1) * (tileBottom - tileTop + 1);
+                pending = mPending.insert(std::make_pair(index, std::move(tile))).first;
+            }
+            Tile& tile = pending->second;
+
+            for (unsigned int y = top; y <= bottom; ++y)
+            {
+                std::copy(pixels.begin() + (y - rect.top) * rect.GetWidth() + (left - rect.left),
+                          pixels.begin() + (y - rect.top) * rect.GetWidth() + (right - rect.left) + 1,
+                          tile.pixels.begin() + (y - tileTop) * mTileSize + (left - tileLeft));
+            }
+            tile.missing -= min(tile.missing, (right - left + 1) * (bottom - top + 1));
+
+            if (tile.missing == 0)
+            {
+                WriteTile(index, tile.pixels);
+                mPending.erase(pending);
+            }
         }
-        // NB: RenderFrontend<...>::CreateView should have dealt with kPOVAttrib_LegacyGammaMode already and updated kPOVAttrib_WorkingGammaType and kPOVAttrib_WorkingGamma to fit.
-        gammaType = (GammaTypeId)ropts.TryGetInt(kPOVAttrib_WorkingGammaType, DEFAULT_WORKING_GAMMA_TYPE);
-        gamma = ropts.TryGetFloat(kPOVAttrib_WorkingGamma, DEFAULT_WORKING_GAMMA);
-        wopts.workingGamma = GetGammaCurve(gammaType, gamma);
+    }
+}
+
+bool TiledImageStream::Finish()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return Close();
+}
+
+bool TiledImageStream::Close()
+{
+    if (mWriter == nullptr)
+        return false;
+
+    // Tiles must all be present for the file to be valid, so fill in whatever has not been
+    // rendered (e.g. due to a partial render area).
+    for (auto& pending : mPending)
+        WriteTile(pending.first, pending.second.pixels);
+    mPending.clear();
+    std::vector<RGBTColour> empty;
+    for (unsigned int index = 0; index < mWritten.size(); ++index)
+    {
+        if (mWritten[index])
+            continue;
+        if (empty.empty())
+            empty.assign(mTileSize * mTileSize, RGBTColour(0.0, 0.0, 0.0, 0.0));
+        WriteTile(index, empty);
+    }
+
+    // the tile offset table is only written now, so only now is the file valid
+    mWriter.reset();
+    mFile.reset();
+    return ReplaceFile(mTempFileName, mFileName);
+}
+
+#endif // OPENEXR_MISSING
+
+Image::ImageFileType ImageProcessing::GetWriteOptions(POVMS_Object& ropts, ImageWriteOptions& wopts, unsigned int& filetype)
+{
+    Image::ImageFileType imagetype = Image::SYS;
+    filetype = POV_File_Image_System;
+
+    wopts.bitsPerChannel = clip(ropts.TryGetInt(kPOVAttrib_BitsPerColor, 8), 1, 16);
+    wopts.alphaMode = (ropts.TryGetBool(kPOVAttrib_OutputAlpha, false) ? ImageAlphaMode::Default : ImageAlphaMode::None );
+    wopts.compression = (ropts.Exist(kPOVAttrib_Compression) ? clip(ropts.GetInt(kPOVAttrib_Compression), 0, 255) : -1);
+    wopts.grayscale = ropts.TryGetBool(kPOVAttrib_GrayscaleOutput, false);
+
+    switch(ropts.TryGetInt(kPOVAttrib_OutputFileType, DEFAULT_OUTPUT_FORMAT))
+    {
+        case kPOVList_FileType_Targa:
+            imagetype = Image::TGA;
+            filetype = POV_File_Image_Targa;
+            break;
+        case kPOVList_FileType_CompressedTarga:
+            // TODO - this file type is obsolete, as Targa compression can now
+            // be controlled using the `Compression` INI setting.
+            imagetype = Image::TGA;
+            filetype = POV_File_Image_Targa;
+            wopts.compression = 1;
+            break;
+        case kPOVList_FileType_PNG:
+            imagetype = Image::PNG;
+            filetype = POV_File_Image_PNG;
+            break;
+        case kPOVList_FileType_JPEG:
+            imagetype = Image::JPEG;
+            filetype = POV_File_Image_JPEG;
+            break;
+        case kPOVList_FileType_PPM:
+            imagetype = Image::PPM;
+            filetype = POV_File_Image_PPM;
+            break;
+        case kPOVList_FileType_BMP:
+            imagetype = Image::BMP;
+            filetype = POV_File_Image_BMP;
+            break;
+        case kPOVList_FileType_OpenEXR:
+            imagetype = Image::EXR;
+            filetype = POV_File_Image_EXR;
+            break;
+        case kPOVList_FileType_RadianceHDR:
+            imagetype = Image::HDR;
+            filetype = POV_File_Image_HDR;
+            break;
+        case kPOVList_FileType_System:
+            imagetype = Image::SYS;
+            filetype = POV_File_Image_System;
+            break;
+        default:
+            throw POV_EXCEPTION_STRING("Invalid file type for output");
+    }
+
+    GammaTypeId gammaType;
+    float gamma;
+    if (ropts.Exist(kPOVAttrib_FileGammaType))
+    {
+        gammaType = (GammaTypeId)ropts.GetInt(kPOVAttrib_FileGammaType);
+        gamma = ropts.GetFloat(kPOVAttrib_FileGamma);
+        wopts.encodingGamma = GetGammaCurve(gammaType, gamma);
+    }
+    else
+    {
+        // if user didn't explicitly specify File_Gamma, use the file format specific default.
+        wopts.encodingGamma.reset();
+    }
+    // NB: RenderFrontend<...>::CreateView should have dealt with kPOVAttrib_LegacyGammaMode already and updated kPOVAttrib_WorkingGammaType and kPOVAttrib_WorkingGamma to fit.
+    gammaType = (GammaTypeId)ropts.TryGetInt(kPOVAttrib_WorkingGammaType, DEFAULT_WORKING_GAMMA_TYPE);
+    gamma = ropts.TryGetFloat(kPOVAttrib_WorkingGamma, DEFAULT_WORKING_GAMMA);
+    wopts.workingGamma = GetGammaCurve(gammaType, gamma);
+
+    bool dither = ropts.TryGetBool(kPOVAttrib_Dither, false);
+    DitherMethodId ditherMethod = DitherMethodId::kNone;
+    if (dither)
+        ditherMethod = ropts.TryGetEnum(kPOVAttrib_DitherMethod, DitherMethodId::kBlueNoise);
+    wopts.ditherStrategy = GetDitherStrategy(ditherMethod, (image != nullptr) ? image->GetWidth() : ropts.TryGetInt(kPOVAttrib_Width, 160));
+
+    unsigned int threads = ropts.TryGetInt(kPOVAttrib_MaxRenderThreads, 0);
+    if (threads == 0)
+        threads = std::thread::hardware_concurrency();
+    wopts.threads = clip(threads, 1u, 64u);
+
+    return imagetype;
+}
+
+shared_ptr<ImageStream> ImageProcessing::StartStream(POVMS_Object& ropts)
+{
+    shared_ptr<ImageStream> result;
+    stream.reset();
+
+    if (tiled)
+    {
+        // the stream is the only place the image goes to, so it is not optional
+        UCS2String filename = ropts.TryGetUCS2String(kPOVAttrib_OutputFile, "");
+        if (filename.empty())
+            throw POV_EXCEPTION(kParamErr, "No output file name for tiled output.");
+
+        ImageWriteOptions wopts;
+        unsigned int filetype;
+        (void)GetWriteOptions(ropts, wopts, filetype);
+
+        // Use the render block size for the tiles, so that blocks and tiles coincide.
+        unsigned int width(ropts.TryGetInt(kPOVAttrib_Width, 160));
+        unsigned int height(ropts.TryGetInt(kPOVAttrib_Height, 120));
+        unsigned int tileSize(max(ropts.TryGetInt(kPOVAttrib_RenderBlockSize, 32), 4));
+        tileSize = min(tileSize, max(width, height));
+
+#ifndef OPENEXR_MISSING
+        result = std::make_shared<TiledImageStream>(width, height, tileSize, filename, wopts);
+        stream = result;
+#endif // OPENEXR_MISSING
+        return result;
+    }
+
+#ifndef LIBPNG_MISSING
+    // only worth the effort if the file is written exactly once, from the final pixels as rendered
+    if ((image == nullptr) || toStdout || toStderr ||
+        !ropts.TryGetBool(kPOVAttrib_OutputToFile, true) ||
+        ropts.TryGetBool(kPOVAttrib_Denoise, false) ||
+        ropts.TryGetBool(kPOVAttrib_ContinueTrace, false) ||
+        ropts.TryGetBool(kPOVAttrib_ProgressiveRefinement, false))
+        return result;
+
+    UCS2String filename = ropts.TryGetUCS2String(kPOVAttrib_OutputFile, "");
+    if (filename.empty())
+        return result;
+
+    ImageWriteOptions wopts;
+    unsigned int filetype;
+    Image::ImageFileType imagetype = GetWriteOptions(ropts, wopts, filetype);
+#ifdef POV_SYS_IMAGE_TYPE
+    if (imagetype == Image::SYS)
+        imagetype = Image::POV_SYS_IMAGE_TYPE;
+#endif
+    if ((imagetype != Image::PNG) || !Png::StreamEncoder::IsSupported(wopts))
+        return result;
+
+    try
+    {
+        result = std::make_shared<RowImageStream>(image, filename, wopts);
+        stream = result;
+    }
+    catch (pov_base::Exception&)
+    {
+        // not fatal; the image will be written the conventional way once the render is done,
+        // at which point any persisting problem will be reported
+    }
+#endif // LIBPNG_MISSING
+
+    return result;
+}
+
+UCS2String ImageProcessing::WriteImage(POVMS_Object& ropts, POVMSInt frame, int digits)
+{
+    // the stream, if any, is only good for this one image
+    shared_ptr<ImageStream> pending(stream.lock());
+    stream.reset();
+
+    // an intermediate image still being written must not replace this one; any error it ran into
+    // doesn't matter any more
+    try
+    {
+        FinishIntermediateImage();
+    }
+    catch (...)
+    {
+    }
 
-        bool dither = ropts.TryGetBool(kPOVAttrib_Dither, false);
-        DitherMethodId ditherMethod = DitherMethodId::kNone;
-        if (dither)
-            ditherMethod = ropts.TryGetEnum(kPOVAttrib_DitherMethod, DitherMethodId::kBlueNoise);
-        wopts.ditherStrategy = GetDitherStrategy(ditherMethod, image->GetWidth());
+    if(ropts.TryGetBool(kPOVAttrib_OutputToFile, true) == true)
+    {
+        ImageWriteOptions wopts;
+        unsigned int filetype;
+        Image::ImageFileType imagetype = GetWriteOptions(ropts, wopts, filetype);
 
         // in theory this should always return a filename since the frontend code
         // sets it via a call to GetOutputFilename() before the render starts.
@@ -197,11 +626,51 @@ UCS2String ImageProcessing::WriteImage(POVMS_Object& ropts, POVMSInt frame, int
         if(filename.empty() == true)
             filename = GetOutputFilename(ropts, frame, digits);
 
-        std::unique_ptr<OStream> imagefile(NewOStream(filename.c_str(), filetype, false)); // TODO - check file permissions somehow without macro [ttrf]
-        if (imagefile == nullptr)
-            throw POV_EXCEPTION_CODE(kCannotOpenFileErr);
+        // if the image has already been written while rendering, all that is left is to complete the file
+        if ((pending == nullptr) || (pending->GetFileName() != filename) || !pending->Finish())
+        {
+            pending.reset();
+
+            if (image == nullptr)
+                throw POV_EXCEPTION_STRING("Tiled output image has not been written during the render.");
+
+            shared_ptr<Image> output(image);
+            if (ropts.TryGetBool(kPOVAttrib_Denoise, false))
+                output = Denoise(max(ropts.TryGetFloat(kPOVAttrib_DenoiseStrength, 1.0f), 0.0f), wopts.threads);
+
+            if (toStdout || toStderr)
+            {
+                std::unique_ptr<OStream> imagefile(NewOStream(filename.c_str(), filetype, false)); // TODO - check file permissions somehow without macro [ttrf]
+                if (imagefile == nullptr)
+                    throw POV_EXCEPTION_CODE(kCannotOpenFileErr);
+
+                Image::Write(imagetype, imagefile.get(), output.get(), wopts);
+            }
+            else
+                // keep any previous file intact until the new one is complete
+                WriteImageFile(imagetype, filetype, filename, output.get(), wopts);
+        }
+
+        if ((convergenceMap != nullptr) && !toStdout && !toStderr)
+        {
+            // The convergence map holds sample count, noise estimate and convergence flag
+            // in the red, green and blue channel, respectively; write it as raw float data.
+            Path path(filename);
+            UCS2String mapname = path.GetFile();
+            UCS2String::size_type pos = mapname.find_last_of('.');
+            if (pos != UCS2String::npos)
+                mapname.erase(pos);
+            path.SetFile(mapname + u"_convergence.pfm");
+
+            std::unique_ptr<OStream> mapfile(NewOStream(path().c_str(), POV_File_Image_PPM, false));
+            if (mapfile == nullptr)
+                throw POV_EXCEPTION_CODE(kCannotOpenFileErr);
+
+            Image::Write(Image::PFM, mapfile.get(), convergenceMap.get(), ImageWriteOptions());
+        }
 
-        Image::Write(imagetype, imagefile.get(), image.get(), wopts);
+        if (costMap != nullptr)
+            WriteCostMap(ropts, filename);
 
         return filename;
     }
@@ -209,11 +678,313 @@ UCS2String ImageProcessing::WriteImage(POVMS_Object& ropts, POVMSInt frame, int
         return UCS2String();
 }
 
+bool ImageProcessing::StartIntermediateImage(POVMS_Object& ropts, POVMSInt frame, int digits)
+{
+    if (intermediateImage.valid())
+    {
+        if (intermediateImage.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return false;
+        intermediateImage.get();
+    }
+
+    // an image written to the console can't be replaced later
+    if ((image == nullptr) || toStdout || toStderr || !ropts.TryGetBool(kPOVAttrib_OutputToFile, true))
+        return true;
+
+    ImageWriteOptions wopts;
+    unsigned int filetype;
+    Image::ImageFileType imagetype = GetWriteOptions(ropts, wopts, filetype);
+
+    UCS2String filename = ropts.TryGetUCS2String(kPOVAttrib_OutputFile, "");
+    if (filename.empty())
+        filename = GetOutputFilename(ropts, frame, digits);
+
+    // Take a snapshot of the pixels, and of the auxiliary data for the denoising filter if needed,
+    // as the render keeps updating them.
+    shared_ptr<Image> pixels(CopyImage(image));
+    shared_ptr<ImageProcessing> snapshot(std::make_shared<ImageProcessing>(pixels));
+    float denoiseStrength = 0.0f;
+    if (ropts.TryGetBool(kPOVAttrib_Denoise, false))
+    {
+        denoiseStrength = max(ropts.TryGetFloat(kPOVAttrib_DenoiseStrength, 1.0f), 0.0f);
+        snapshot->albedoBuffer = CopyImage(albedoBuffer);
+        snapshot->normalBuffer = CopyImage(normalBuffer);
+        snapshot->depthBuffer  = CopyImage(depthBuffer);
+    }
+
+    intermediateImage = std::async(std::launch::async, [snapshot, denoiseStrength, imagetype, filetype, filename, wopts]()
+    {
+        shared_ptr<Image> output(snapshot->Denoise(denoiseStrength, wopts.threads));
+        WriteImageFile(imagetype, filetype, filename, output.get(), wopts);
+    });
+    return true;
+}
+
+void ImageProcessing::FinishIntermediateImage()
+{
+    if (intermediateImage.valid())
+        intermediateImage.get();
+}
+
 shared_ptr<Image>& ImageProcessing::GetImage()
 {
     return image;
 }
 
+shared_ptr<Image>& ImageProcessing::GetConvergenceMap()
+{
+    return convergenceMap;
+}
+
+shared_ptr<Image>& ImageProcessing::GetCostMap()
+{
+    return costMap;
+}
+
+void ImageProcessing::WriteCostMap(POVMS_Object& ropts, const UCS2String& imagename)
+{
+    bool exr = (ropts.TryGetInt(kPOVAttrib_HistogramFileType, kPOVList_FileType_PFM) == kPOVList_FileType_OpenEXR);
+
+    UCS2String filename = ropts.TryGetUCS2String(kPOVAttrib_HistogramFile, "");
+    if (filename.empty())
+    {
+        // nowhere to derive a file name from
+        if (toStdout || toStderr)
+            return;
+
+        Path path(imagename);
+        UCS2String mapname = path.GetFile();
+        UCS2String::size_type pos = mapname.find_last_of('.');
+        if (pos != UCS2String::npos)
+            mapname.erase(pos);
+        path.SetFile(mapname + (exr ? u"_cost.exr" : u"_cost.pfm"));
+        filename = path();
+    }
+
+    // The cost map holds render time (in microseconds), number of rays and number of samples
+    // in the red, green and blue channel, respectively. Optionally, the pixels are summed up
+    // into the cells of a coarser grid.
+    shared_ptr<Image> output(costMap);
+    unsigned int gridWidth  = ropts.TryGetInt(kPOVAttrib_HistogramGridSizeX, 0);
+    unsigned int gridHeight = ropts.TryGetInt(kPOVAttrib_HistogramGridSizeY, 0);
+    if ((gridWidth > 0) && (gridHeight > 0))
+    {
+        unsigned int width  = costMap->GetWidth();
+        unsigned int height = costMap->GetHeight();
+        gridWidth  = min(gridWidth,  width);
+        gridHeight = min(gridHeight, height);
+        output = shared_ptr<Image>(Image::Create(gridWidth, gridHeight, ImageDataType::RGB_Float));
+        std::vector<float> cells(size_t(gridWidth) * gridHeight * 3, 0.0f);
+        for (unsigned int y = 0; y < height; y++)
+        {
+            size_t row = size_t(y) * gridHeight / height * gridWidth;
+            for (unsigned int x = 0; x < width; x++)
+            {
+                float* cell = &cells[(row + size_t(x) * gridWidth / width) * 3];
+                float time, rays, samples;
+                costMap->GetRGBValue(x, y, time, rays, samples);
+                cell[0] += time;
+                cell[1] += rays;
+                cell[2] += samples;
+            }
+        }
+        for (unsigned int y = 0, i = 0; y < gridHeight; y++)
+        {
+            for (unsigned int x = 0; x < gridWidth; x++, i += 3)
+                output->SetRGBValue(x, y, cells[i], cells[i + 1], cells[i + 2]);
+        }
+    }
+
+    std::unique_ptr<OStream> mapfile(NewOStream(filename.c_str(), exr ? POV_File_Image_EXR : POV_File_Image_PPM, false));
+    if (mapfile == nullptr)
+        throw POV_EXCEPTION_CODE(kCannotOpenFileErr);
+
+    Image::Write(exr ? Image::EXR : Image::PFM, mapfile.get(), output.get(), ImageWriteOptions());
+}
+
+shared_ptr<Image>& ImageProcessing::GetAlbedoBuffer()
+{
+    return albedoBuffer;
+}
+
+shared_ptr<Image>& ImageProcessing::GetNormalBuffer()
+{
+    return normalBuffer;
+}
+
+shared_ptr<Image>& ImageProcessing::GetDepthBuffer()
+{
+    return depthBuffer;
+}
+
+/// Per-pixel guidance data for the denoising filter.
+struct DenoiseFeatures final
+{
+    float albedo[3];
+    float normal[3];
+    float depth;
+    float sigma;    ///< Colour tolerance, derived from local luminance deviation.
+};
+
+/// Factor by which a colour channel is demodulated before, and re-modulated after filtering.
+static inline float DenoiseModulation(float albedo)
+{
+    return (albedo > 0.01f ? albedo : 1.0f);
+}
+
+/// One iteration of the edge-avoiding à-trous wavelet filter, for rows `top` to `bottom-1`.
+static void DenoiseAtrousRows(const std::vector<RGBColour>& src, std::vector<RGBColour>& dst, const std::vector<DenoiseFeatures>& features,
+                              unsigned int width, unsigned int height, int step, unsigned int top, unsigned int bottom)
+{
+    static const float kKernel[3] = { 3.0f/8.0f, 1.0f/4.0f, 1.0f/16.0f };
+
+    for (unsigned int y = top; y < bottom; y++)
+    {
+        for (unsigned int x = 0; x < width; x++)
+        {
+            size_t p = y * width + x;
+            const DenoiseFeatures& fp = features[p];
+            float lp = src[p].Greyscale();
+            RGBColour sum;
+            float weightSum = 0.0f;
+
+            for (int dy = -2; dy <= 2; dy++)
+            {
+                int qy = int(y) + dy * step;
+                if ((qy < 0) || (qy >= int(height)))
+                    continue;
+                for (int dx = -2; dx <= 2; dx++)
+                {
+                    int qx = int(x) + dx * step;
+                    if ((qx < 0) || (qx >= int(width)))
+                        continue;
+
+                    size_t q = qy * width + qx;
+                    const DenoiseFeatures& fq = features[q];
+
+                    float ndot = fp.normal[X] * fq.normal[X] + fp.normal[Y] * fq.normal[Y] + fp.normal[Z] * fq.normal[Z];
+                    float nlen = (fp.normal[X] * fp.normal[X] + fp.normal[Y] * fp.normal[Y] + fp.normal[Z] * fp.normal[Z]) +
+                                 (fq.normal[X] * fq.normal[X] + fq.normal[Y] * fq.normal[Y] + fq.normal[Z] * fq.normal[Z]);
+                    // pixels without a surface (zero normal) only blend with each other
+                    float wNormal = (nlen == 0.0f ? 1.0f : pow(max(ndot, 0.0f), 32.0f));
+                    float wDepth = exp(-fabs(fp.depth - fq.depth) / (0.02f * max(fp.depth, 1.0e-3f) * step));
+                    float wAlbedo = exp(-(fabs(fp.albedo[0] - fq.albedo[0]) + fabs(fp.albedo[1] - fq.albedo[1]) + fabs(fp.albedo[2] - fq.albedo[2])) / 0.1f);
+                    float wColour = exp(-fabs(lp - src[q].Greyscale()) / (fp.sigma * sqrt(float(step)) + 1.0e-4f));
+                    float weight = kKernel[abs(dx)] * kKernel[abs(dy)] * wNormal * wDepth * wAlbedo * wColour;
+
+                    sum += src[q] * weight;
+                    weightSum += weight;
+                }
+            }
+
+            dst[p] = (weightSum > 0.0f ? sum / weightSum : src[p]);
+        }
+    }
+}
+
+shared_ptr<Image> ImageProcessing::Denoise(float strength, unsigned int threads)
+{
+    if ((albedoBuffer == nullptr) || (normalBuffer == nullptr) || (depthBuffer == nullptr) || (strength <= 0.0f))
+        return image;
+
+    unsigned int width = image->GetWidth();
+    unsigned int height = image->GetHeight();
+    size_t size = size_t(width) * height;
+    std::vector<RGBColour> colour(size);
+    std::vector<DenoiseFeatures> features(size);
+
+    // Gather the guidance data a row at a time, and demodulate the colour by the albedo so that
+    // texture detail is not smoothed out along with the noise.
+    {
+        std::vector<float> pixelRow(width * 4);
+        std::vector<float> albedoRow(width * 4);
+        std::vector<float> normalRow(width * 4);
+        std::vector<float> depthRow(width * 2);
+        for (unsigned int y = 0; y < height; y++)
+        {
+            // NB: we're operating on the raw (premultiplied) data here.
+            image->GetRGBARow(0, y, width, pixelRow.data());
+            albedoBuffer->GetRGBARow(0, y, width, albedoRow.data());
+            normalBuffer->GetRGBARow(0, y, width, normalRow.data());
+            depthBuffer->GetGrayARow(0, y, width, depthRow.data());
+            for (unsigned int x = 0; x < width; x++)
+            {
+                size_t p = size_t(y) * width + x;
+                DenoiseFeatures& f = features[p];
+                for (int i = 0; i < 3; i++)
+                {
+                    f.albedo[i] = albedoRow[x * 4 + i];
+                    f.normal[i] = normalRow[x * 4 + i];
+                    colour[p][i] = pixelRow[x * 4 + i] / DenoiseModulation(f.albedo[i]);
+                }
+                f.depth = depthRow[x * 2];
+            }
+        }
+    }
+
+    // Derive the colour tolerance of each pixel from the luminance deviation in its 3x3 neighbourhood.
+    for (unsigned int y = 0; y < height; y++)
+    {
+        for (unsigned int x = 0; x < width; x++)
+        {
+            float sum = 0.0f, sumSqr = 0.0f;
+            int n = 0;
+            for (unsigned int qy = (y > 0 ? y - 1 : 0); qy <= min(y + 1, height - 1); qy++)
+            {
+                for (unsigned int qx = (x > 0 ? x - 1 : 0); qx <= min(x + 1, width - 1); qx++)
+                {
+                    float l = colour[qy * width + qx].Greyscale();
+                    sum += l;
+                    sumSqr += l * l;
+                    n++;
+                }
+            }
+            float variance = max(sumSqr / n - (sum / n) * (sum / n), 0.0f);
+            features[y * width + x].sigma = strength * sqrt(variance);
+        }
+    }
+
+    // Run the filter iterations with exponentially growing step size, each one split across threads by rows.
+    {
+        std::vector<RGBColour> filtered(size);
+        threads = clip(threads, 1u, height);
+        for (int step = 1; step <= 16; step *= 2)
+        {
+            std::vector<std::thread> workers;
+            for (unsigned int i = 0; i < threads; i++)
+                workers.push_back(std::thread(DenoiseAtrousRows, std::cref(colour), std::ref(filtered), std::cref(features),
+                                              width, height, step, (height * i) / threads, (height * (i + 1)) / threads));
+            for (auto& worker : workers)
+                worker.join();
+            colour.swap(filtered);
+        }
+    }
+
+    // Re-modulate in place, then release the guidance data before allocating the output image.
+    for (size_t p = 0; p < size; p++)
+    {
+        for (int i = 0; i < 3; i++)
+            colour[p][i] *= DenoiseModulation(features[p].albedo[i]);
+    }
+    std::vector<DenoiseFeatures>().swap(features);
+
+    // Carry over the original filter and transmit channels.
+    shared_ptr<Image> output(Image::Create(width, height, ImageDataType::RGBFT_Float));
+    output->SetPremultiplied(image->IsPremultiplied());
+    for (unsigned int y = 0; y < height; y++)
+    {
+        for (unsigned int x = 0; x < width; x++)
+        {
+            const RGBColour& col = colour[size_t(y) * width + x];
+            float r, g, b, f, t;
+            image->GetRGBFTValue(x, y, r, g, b, f, t);
+            output->SetRGBFTValue(x, y, col.red(), col.green(), col.blue(), f, t);
+        }
+    }
+
+    return output;
+}
+
 bool ImageProcessing::OutputIsStdout(POVMS_Object& ropts)
 {
     UCS2String path(ropts.TryGetUCS2String(kPOVAttrib_OutputFile, ""));
@@ -43,11 +43,19 @@
 //  (none at the moment)
 
 // C++ standard header files
+#include <future>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 // POV-Ray header files (base module)
+#include "base/fileinputoutput_fwd.h"
 #include "base/stringtypes.h"
-#include "base/image/image_fwd.h"
+#include "base/types.h"
+#include "base/image/image.h"
+#include "base/image/openexr.h"
+#include "base/image/png_pov.h"
 
 // POV-Ray header files (POVMS module)
 #include "povms/povmscpp.h"
@@ -60,6 +68,143 @@ namespace pov_frontend
 
 using namespace pov_base;
 
+/// Output image file written while the render is still in progress.
+///
+class ImageStream
+{
+    public:
+
+        virtual ~ImageStream() {}
+
+        ImageStream(const ImageStream&) = delete;
+        ImageStream& operator=(const ImageStream&) = delete;
+
+        const UCS2String& GetFileName() const { return mFileName; }
+
+        /// Report the final pixels of a rectangle.
+        ///
+        /// @param  rect    Rectangle completed.
+        /// @param  pixels  Pixels of the rectangle, row by row, as rendered.
+        ///
+        virtual void CompletedRectangle(const POVRect& rect, const std::vector<RGBTColour>& pixels) = 0;
+
+        /// Complete the file.
+        ///
+        /// @return     `true` if the file has been completed, or `false` if the image still needs
+        ///             to be written the conventional way.
+        ///
+        virtual bool Finish() = 0;
+
+    protected:
+
+        ImageStream(const UCS2String& filename) : mFileName(filename) {}
+
+        UCS2String                          mFileName;
+        std::mutex                          mMutex;
+};
+
+/// Output image file written row by row while the render is still in progress.
+///
+/// Rows are handed to the encoder as soon as they, and all rows above them, have been completely
+/// rendered, so that by the end of the render only the last few rows remain to be encoded. The file
+/// is written under a temporary name, and only renamed to the actual output file name once complete.
+///
+/// @note
+///     Only PNG output is supported at present.
+///
+class RowImageStream final : public ImageStream
+{
+    public:
+
+        /// Start writing an image.
+        ///
+        /// @param  image       Image to write; rows must not be modified once completed.
+        /// @param  filename    Name of the output file.
+        /// @param  options     Output options.
+        ///
+        RowImageStream(const std::shared_ptr<Image>& image, const UCS2String& filename, const ImageWriteOptions& options);
+
+        /// Discard the file, unless completed.
+        virtual ~RowImageStream() override;
+
+        /// Report the final pixels of a rectangle; the pixels are taken from the image.
+        virtual void CompletedRectangle(const POVRect& rect, const std::vector<RGBTColour>& pixels) override;
+
+        /// @return     `true` if the file has been completed, or `false` if not all rows have
+        ///             been reported as complete, in which case the file is discarded.
+        virtual bool Finish() override;
+
+    private:
+
+        std::shared_ptr<Image>              mImage;
+        UCS2String                          mTempFileName;
+        std::unique_ptr<OStream>            mFile;
+        std::unique_ptr<Png::StreamEncoder> mEncoder;
+        std::vector<unsigned int>           mRowPixels;
+        unsigned int                        mRowsCompleted;
+
+        void Discard();
+};
+
+/// Output image file written tile by tile while the render is in progress, in place of an image.
+///
+/// Each tile is written as soon as all of its pixels have been rendered, and only the tiles in
+/// progress are held in memory. OpenEXR only writes the tile offset table when the file is
+/// closed, so the file is not readable before then; it is written under a temporary name, and
+/// only renamed to the actual output file name once complete. If the render is aborted, the file
+/// is still completed (see @ref ~TiledImageStream()), but if POV-Ray terminates abnormally only
+/// the unreadable temporary file remains.
+///
+/// @note
+///     Only OpenEXR output is supported at present.
+///
+class TiledImageStream final : public ImageStream
+{
+    public:
+
+        /// Start writing an image.
+        ///
+        /// @param  width       Image width.
+        /// @param  height      Image height.
+        /// @param  tileSize    Width and height of the tiles.
+        /// @param  filename    Name of the output file.
+        /// @param  options     Output options.
+        ///
+        TiledImageStream(unsigned int width, unsigned int height, unsigned int tileSize,
+                         const UCS2String& filename, const ImageWriteOptions& options);
+
+        /// Complete the file, unless already done, leaving any tiles not written yet black.
+        virtual ~TiledImageStream() override;
+
+        virtual void CompletedRectangle(const POVRect& rect, const std::vector<RGBTColour>& pixels) override;
+
+        /// @return     `true` if the file has been completed, or `false` if it could not be
+        ///             renamed; pixels never reported as complete are left black, same as in a
+        ///             conventionally written image.
+        virtual bool Finish() override;
+
+    private:
+
+        struct Tile
+        {
+            std::vector<RGBTColour> pixels;
+            unsigned int            missing;
+        };
+
+        unsigned int                            mWidth;
+        unsigned int                            mHeight;
+        unsigned int                            mTileSize;
+        unsigned int                            mTilesX;
+        UCS2String                              mTempFileName;
+        std::unique_ptr<OStream>                mFile;
+        std::unique_ptr<OpenEXR::TiledWriter>   mWriter;
+        std::map<unsigned int, Tile>            mPending;   ///< Tiles partially rendered, by index.
+        std::vector<bool>                       mWritten;   ///< Whether each tile has been written.
+
+        void WriteTile(unsigned int index, const std::vector<RGBTColour>& pixels);
+        bool Close();
+};
+
 class ImageProcessing
 {
     public:
@@ -70,21 +215,110 @@ class ImageProcessing
 
         UCS2String WriteImage(POVMS_Object& ropts, POVMSInt frame = 0, int digits = 0);
 
+        /// Start writing the image rendered so far to the output file, e.g. during a progressive render.
+        ///
+        /// The pixels are copied, and the copy is written in the background, so that the render may
+        /// continue meanwhile. Like any output image, the file is written under a temporary name, and
+        /// only replaces the output file once complete.
+        ///
+        /// @param  ropts   Render options, including the output file name.
+        /// @return         `false` if an image started earlier has not been completed yet, in which
+        ///                 case nothing is done.
+        /// @throw          Any error that occurred while writing the image started earlier.
+        ///
+        bool StartIntermediateImage(POVMS_Object& ropts, POVMSInt frame = 0, int digits = 0);
+
+        /// Wait for the image started by @ref StartIntermediateImage(), if any, to be completed.
+        ///
+        /// @throw          Any error that occurred while writing the image.
+        ///
+        void FinishIntermediateImage();
+
+        /// Start writing the output image while the render is still in progress, if possible.
+        ///
+        /// The image is then written to the file as the render progresses, and
+        /// @ref WriteImage() merely completes the file.
+        ///
+        /// @param  ropts   Render options, including the output file name.
+        /// @return         The stream to report completed pixels to, or an empty pointer if the
+        ///                 output cannot be written this way.
+        ///
+        /// @note
+        ///     With tiled output (see @ref OutputIsTiled()), failure to start the stream is fatal.
+        ///
+        std::shared_ptr<ImageStream> StartStream(POVMS_Object& ropts);
+
         std::shared_ptr<Image>& GetImage();
 
+        /// Get the per-pixel convergence map, or an empty pointer if none was requested.
+        std::shared_ptr<Image>& GetConvergenceMap();
+
+        /// Get the per-pixel render cost map, or an empty pointer if none was requested.
+        std::shared_ptr<Image>& GetCostMap();
+
+        /// Get the auxiliary albedo buffer, or an empty pointer if denoising was not requested.
+        std::shared_ptr<Image>& GetAlbedoBuffer();
+        /// Get the auxiliary normal buffer, or an empty pointer if denoising was not requested.
+        std::shared_ptr<Image>& GetNormalBuffer();
+        /// Get the auxiliary depth buffer, or an empty pointer if denoising was not requested.
+        std::shared_ptr<Image>& GetDepthBuffer();
+
+        /// Create a denoised copy of the image.
+        ///
+        /// This applies an edge-avoiding à-trous wavelet filter to the image, guided by the auxiliary
+        /// albedo, normal and depth buffers so that geometric and texture detail is preserved while
+        /// sampling noise is smoothed out.
+        ///
+        /// @param  strength    Scaling factor for the colour tolerance of the filter.
+        /// @param  threads     Number of threads to use.
+        /// @return             The denoised image, or the original image if no auxiliary buffers are available.
+        ///
+        std::shared_ptr<Image> Denoise(float strength, unsigned int threads);
+
         UCS2String GetOutputFilename(POVMS_Object& ropts, POVMSInt frame, int digits);
         bool OutputIsStdout(void) { return toStdout; }
         bool OutputIsStderr(void) { return toStderr; }
+
+        /// Whether the output image is written tile by tile, without holding the image in memory.
+        ///
+        /// In this case @ref GetImage() returns an empty pointer, and the pixels must be reported
+        /// to the stream obtained via @ref StartStream() instead.
+        ///
+        bool OutputIsTiled(void) { return tiled; }
         virtual bool OutputIsStdout(POVMS_Object& ropts);
         virtual bool OutputIsStderr(POVMS_Object& ropts);
 
     protected:
         std::shared_ptr<Image> image;
+        std::shared_ptr<Image> convergenceMap;
+        std::shared_ptr<Image> costMap;
+        std::shared_ptr<Image> albedoBuffer;
+        std::shared_ptr<Image> normalBuffer;
+        std::shared_ptr<Image> depthBuffer;
+        std::weak_ptr<ImageStream> stream; ///< Owned by the view, so as to be discarded along with it.
+        std::future<void> intermediateImage; ///< Intermediate image being written in the background.
         bool toStdout;
         bool toStderr;
+        bool tiled;
 
     private:
 
+        /// Get the output file format and options.
+        ///
+        /// @param[in]  ropts       Render options.
+        /// @param[out] wopts       Image output options.
+        /// @param[out] filetype    File type, as passed to @ref NewOStream().
+        /// @return                 Image file format.
+        ///
+        Image::ImageFileType GetWriteOptions(POVMS_Object& ropts, ImageWriteOptions& wopts, unsigned int& filetype);
+
+        /// Write the per-pixel render cost map.
+        ///
+        /// @param  ropts       Render options, determining file name, format and resolution of the map.
+        /// @param  imagename   File name of the main output image, to derive the default file name from.
+        ///
+        void WriteCostMap(POVMS_Object& ropts, const UCS2String& imagename);
+
         ImageProcessing() = delete;
         ImageProcessing(const ImageProcessing&) = delete;
         ImageProcessing& operator=(const ImageProcessing&) = delete;
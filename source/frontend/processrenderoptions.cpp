@@ -110,6 +110,7 @@ struct ProcessOptions::INI_Parser_Table RenderOptions_INI_Table[] =
     { "Antialias_Depth",     kPOVAttrib_AntialiasDepth,     kPOVMSType_Int },
     { "Antialias_Gamma",     kPOVAttrib_AntialiasGamma,     kPOVMSType_Float },
     { "Antialias_Threshold", kPOVAttrib_AntialiasThreshold, kPOVMSType_Float },
+    { "Antialias_Time_Budget",kPOVAttrib_AntialiasTimeBudget,kPOVMSType_Float },
     { "Append_File",         kPOVAttrib_AppendConsoleFiles, kPOVMSType_Bool },
 
     { "Bits_Per_Color",      kPOVAttrib_BitsPerColor,       kPOVMSType_Int,         kINIOptFlag_SuppressWrite },
@@ -129,14 +130,17 @@ struct ProcessOptions::INI_Parser_Table RenderOptions_INI_Table[] =
     { "Clockless_Animation", kPOVAttrib_ClocklessAnimation, kPOVMSType_Bool },
     { "Compression",         kPOVAttrib_Compression,        kPOVMSType_Int },
     { "Continue_Trace",      kPOVAttrib_ContinueTrace,      kPOVMSType_Bool },
+    { "Continue_Trace_Checkpoint", kPOVAttrib_BackupCheckpoint, kPOVMSType_Int },
     { "Create_Continue_Trace_Log", kPOVAttrib_BackupTrace,  kPOVMSType_Bool },
-    { "Create_Histogram",    0,                             0 },
+    { "Create_Histogram",    kPOVAttrib_CreateHistogram,    kPOVMSType_Bool },
     { "Create_Ini",          kPOVAttrib_CreateIni,          kPOVMSType_UCS2String },
     { "Cyclic_Animation",    kPOVAttrib_CyclicAnimation,    kPOVMSType_Bool },
 
     { "Debug_Console",       kPOVAttrib_DebugConsole,       kPOVMSType_Bool },
     { "Debug_File",          kPOVAttrib_DebugFile,          kPOVMSType_UCS2String },
     { "Declare",             kPOVAttrib_Declare,            kUseSpecialHandler },
+    { "Denoise",             kPOVAttrib_Denoise,            kPOVMSType_Bool },
+    { "Denoise_Strength",    kPOVAttrib_DenoiseStrength,    kPOVMSType_Float },
     { "Display",             kPOVAttrib_Display,            kPOVMSType_Bool },
     { "Display_Gamma",       kPOVAttrib_DisplayGamma,       kUseSpecialHandler },
     { "Dither",              kPOVAttrib_Dither,             kPOVMSType_Bool },
@@ -161,13 +165,14 @@ struct ProcessOptions::INI_Parser_Table RenderOptions_INI_Table[] =
 
     { "Height",              kPOVAttrib_Height,             kPOVMSType_Int },
     { "High_Reproducibility",kPOVAttrib_HighReproducibility,kPOVMSType_Bool },
-    { "Histogram_Name",      0,                             0 },
-    { "Histogram_Grid_Size", 0,                             0 },
-    { "Histogram_Type",      0,                             0 },
+    { "Histogram_Name",      kPOVAttrib_HistogramFile,      kPOVMSType_UCS2String },
+    { "Histogram_Grid_Size", kPOVAttrib_HistogramGridSizeX, kUseSpecialHandler },
+    { "Histogram_Type",      kPOVAttrib_HistogramFileType,  kUseSpecialHandler },
 
     { "Initial_Clock",       kPOVAttrib_InitialClock,       kPOVMSType_Float },
     { "Initial_Frame",       kPOVAttrib_InitialFrame,       kPOVMSType_Int },
     { "Input_File_Name",     kPOVAttrib_InputFile,          kPOVMSType_UCS2String },
+    { "Include_Cache_Path",  kPOVAttrib_IncludeCachePath,   kPOVMSType_UCS2String },
     { "Include_Header",      kPOVAttrib_IncludeHeader,      kPOVMSType_UCS2String },
     { "Include_Ini",         kPOVAttrib_IncludeIni,         kUseSpecialHandler },
 
@@ -178,15 +183,21 @@ struct ProcessOptions::INI_Parser_Table RenderOptions_INI_Table[] =
     { "Light_Buffer",        kPOVAttrib_LightBuffer,        kPOVMSType_Bool },
 
     { "Max_Image_Buffer_Memory", kPOVAttrib_MaxImageBufferMem, kPOVMSType_Int },
+    { "Metrics_File",        kPOVAttrib_MetricsFile,        kPOVMSType_UCS2String },
+    { "Metrics_Format",      kPOVAttrib_MetricsFormat,      kUseSpecialHandler },
+    { "Metrics_Interval",    kPOVAttrib_MetricsInterval,    kPOVMSType_Float },
 
     { "Odd_Field",           kPOVAttrib_OddField,           kPOVMSType_Bool },
     { "Output_Alpha",        kPOVAttrib_OutputAlpha,        kPOVMSType_Bool },
+    { "Output_Convergence_Map",kPOVAttrib_ConvergenceMap,   kPOVMSType_Bool },
     { "Output_File_Name",    kPOVAttrib_OutputFile,         kPOVMSType_UCS2String },
     { "Output_File_Type",    kPOVAttrib_OutputFileType,     kUseSpecialHandler },
     { "Output_To_File",      kPOVAttrib_OutputToFile,       kPOVMSType_Bool },
 
     { "Palette",             kPOVAttrib_Palette,            kUseSpecialHandler },
     { "Pause_When_Done",     kPOVAttrib_PauseWhenDone,      kPOVMSType_Bool },
+    { "Pipeline_Animation",  kPOVAttrib_PipelineAnimation,  kPOVMSType_Bool },
+    { "Pipeline_Memory_Limit",kPOVAttrib_PipelineMemoryLimit,kPOVMSType_Int },
     { "Post_Frame_Command",  kPOVAttrib_PostFrameCommand,   kUseSpecialHandler },
     { "Post_Frame_Return",   kPOVAttrib_PostFrameCommand,   kUseSpecialHandler },
     { "Post_Scene_Command",  kPOVAttrib_PostSceneCommand,   kUseSpecialHandler },
@@ -197,9 +208,13 @@ struct ProcessOptions::INI_Parser_Table RenderOptions_INI_Table[] =
     { "Pre_Frame_Return",    kPOVAttrib_PreFrameCommand,    kUseSpecialHandler },
     { "Pre_Scene_Command",   kPOVAttrib_PreSceneCommand,    kUseSpecialHandler },
     { "Pre_Scene_Return",    kPOVAttrib_PreSceneCommand,    kUseSpecialHandler },
+    { "Profile_Objects",     kPOVAttrib_ProfileObjects,     kPOVMSType_Bool },
+    { "Progressive_Output_Interval",kPOVAttrib_ProgressiveOutputInterval,kPOVMSType_Float },
+    { "Progressive_Refinement",kPOVAttrib_ProgressiveRefinement,kPOVMSType_Bool },
 
     { "Quality",             kPOVAttrib_Quality,            kPOVMSType_Int },
 
+    { "Radiosity_Binary_File", kPOVAttrib_RadiosityBinaryFile, kPOVMSType_Bool },
     { "Radiosity_File_Name", kPOVAttrib_RadiosityFileName,  kPOVMSType_UCS2String },
     { "Radiosity_From_File", kPOVAttrib_RadiosityFromFile,  kPOVMSType_Bool },
     { "Radiosity_To_File",   kPOVAttrib_RadiosityToFile,    kPOVMSType_Bool },
@@ -210,9 +225,15 @@ struct ProcessOptions::INI_Parser_Table RenderOptions_INI_Table[] =
     { "Render_Block_Step",   kPOVAttrib_RenderBlockStep,    kPOVMSType_Int },
     { "Render_Console",      kPOVAttrib_RenderConsole,      kPOVMSType_Bool },
     { "Render_File",         kPOVAttrib_RenderFile,         kPOVMSType_UCS2String },
+    { "Render_Node_Timeout", kPOVAttrib_RenderNodeTimeout,  kPOVMSType_Int },
+    { "Render_Node_Token",   kPOVAttrib_RenderNodeToken,    kPOVMSType_CString },
+    { "Render_Nodes",        kPOVAttrib_RenderNodes,        kPOVMSType_CString },
     { "Render_Pattern",      kPOVAttrib_RenderPattern,      kPOVMSType_Int },
+    { "Reuse_Scene",         kPOVAttrib_ReuseScene,         kPOVMSType_Bool },
+    { "Reuse_Scene_Count",   kPOVAttrib_ReuseSceneCount,    kPOVMSType_Int },
 
     { "Sampling_Method",     kPOVAttrib_SamplingMethod,     kPOVMSType_Int },
+    { "Shared_Framebuffer",  kPOVAttrib_SharedFramebuffer,  kPOVMSType_Bool },
     { "Split_Unions",        kPOVAttrib_SplitUnions,        kPOVMSType_Bool },
     { "Start_Column",        kPOVAttrib_Left,               kPOVMSType_Float },
     { "Start_Row",           kPOVAttrib_Top,                kPOVMSType_Float },
@@ -224,6 +245,8 @@ struct ProcessOptions::INI_Parser_Table RenderOptions_INI_Table[] =
 
     { "Test_Abort_Count",    kPOVAttrib_TestAbortCount,     kPOVMSType_Int },
     { "Test_Abort",          kPOVAttrib_TestAbort,          kPOVMSType_Bool },
+    { "Tiled_Output",        kPOVAttrib_TiledOutput,        kPOVMSType_Bool },
+    { "Timeline_File",       kPOVAttrib_TimelineFile,       kPOVMSType_UCS2String },
 
     { "User_Abort_Command",  kPOVAttrib_UserAbortCommand,   kUseSpecialHandler },
     { "User_Abort_Return",   kPOVAttrib_UserAbortCommand,   kUseSpecialHandler },
@@ -410,6 +433,72 @@ int ProcessRenderOptions::ReadSpecialOptionHandler(INI_Parser_Table *option, cha
                 err = POVMSUtil_SetInt(obj, option->key, intval);
             break;
 
+        case kPOVAttrib_HistogramFileType:
+
+            while(isspace(*param))
+                param++;
+            switch (toupper(*param))
+            {
+                case 'E':
+                    err = ParseFileType(*param, option->key, &intval);
+                    break;
+                case 'C': // legacy comma-separated values
+                case 'T': // legacy Targa
+                case 'N': // legacy PNG
+                case 'P': // legacy PPM
+                case 'S': // legacy system-specific format
+                    ParseError("Histogram_Type=%c is a legacy histogram format; the render cost map is written as PFM instead.", *param);
+                    intval = kPOVList_FileType_PFM;
+                    break;
+                default:
+                    ParseError("Unsupported histogram file format %c; use E (OpenEXR), or leave it unset for PFM.", *param);
+                    err = kParamErr;
+                    break;
+            }
+            if (err == kNoErr)
+                err = POVMSUtil_SetInt(obj, option->key, intval);
+            break;
+
+        case kPOVAttrib_MetricsFormat:
+
+            while(isspace(*param))
+                param++;
+            switch (toupper(*param))
+            {
+                case 'J': intval = kPOVList_MetricsFormat_JSONLines;  break;
+                case 'P': intval = kPOVList_MetricsFormat_Prometheus; break;
+                default:
+                    ParseError("Unsupported metrics format %c; use either J (JSON lines) or P (Prometheus text).", *param);
+                    err = kParamErr;
+                    break;
+            }
+            if (err == kNoErr)
+                err = POVMSUtil_SetInt(obj, option->key, intval);
+            break;
+
+        case kPOVAttrib_HistogramGridSizeX:
+
+            // legacy syntax `xx.yy`, with the fractional digits giving the vertical grid size;
+            // a plain `xx` gives a square grid
+            switch (sscanf(param, " %d.%d", &intval, &intval2))
+            {
+                case 1:  intval2 = intval; break;
+                case 2:  break;
+                default: intval = -1; break;
+            }
+            if ((intval >= 0) && (intval2 >= 0))
+            {
+                err = POVMSUtil_SetInt(obj, kPOVAttrib_HistogramGridSizeX, intval);
+                if (err == kNoErr)
+                    err = POVMSUtil_SetInt(obj, kPOVAttrib_HistogramGridSizeY, intval2);
+            }
+            else
+            {
+                ParseError("Histogram grid size must be specified as 'xx.yy', found '%s'.", param);
+                err = kParamErr;
+            }
+            break;
+
         case kPOVAttrib_IncludeIni:
         case kPOVAttrib_LibraryPath:
 
@@ -701,6 +790,7 @@ int ProcessRenderOptions::WriteSpecialOptionHandler(INI_Parser_Table *option, PO
             break;
 
         case kPOVAttrib_OutputFileType:
+        case kPOVAttrib_HistogramFileType:
 
             if(POVMSUtil_GetInt(obj, option->key, &intval) == 0)
             {
@@ -710,6 +800,22 @@ int ProcessRenderOptions::WriteSpecialOptionHandler(INI_Parser_Table *option, PO
             }
             break;
 
+        case kPOVAttrib_MetricsFormat:
+
+            if(POVMSUtil_GetInt(obj, option->key, &intval) == 0)
+                file->printf("%s=%c\n", option->keyword, (intval == kPOVList_MetricsFormat_Prometheus) ? 'P' : 'J');
+            break;
+
+        case kPOVAttrib_HistogramGridSizeX:
+
+            if(POVMSUtil_GetInt(obj, kPOVAttrib_HistogramGridSizeX, &intval) == 0)
+            {
+                POVMSInt intval2 = 0;
+                (void)POVMSUtil_GetInt(obj, kPOVAttrib_HistogramGridSizeY, &intval2);
+                file->printf("%s=%d.%d\n", option->keyword, intval, intval2);
+            }
+            break;
+
         case kPOVAttrib_IncludeIni:
 
             break;
@@ -37,10 +37,12 @@
 #include "frontend/renderfrontend.h"
 
 // C++ variants of C standard header files
-//  (none at the moment)
+#include <cstdint>
+#include <cstring>
 
 // C++ standard header files
 #include <algorithm>
+#include <string>
 
 // POV-Ray header files (base module)
 #include "base/fileinputoutput.h"
@@ -68,6 +70,7 @@ namespace pov_frontend
 
 using std::min;
 using std::max;
+using std::vector;
 
 const int gStreamTypeUtilDataCount = 6;
 
@@ -229,6 +232,7 @@ RenderFrontendBase::SceneId RenderFrontendBase::CreateScene(SceneData& shd, POVM
         // TODO FIXME END
 
         shd.verbose = obj.TryGetBool(kPOVAttrib_Verbose, true);
+        shd.inputFilesComplete = false;
 
         for(size_t i = 0; i < MAX_STREAMS; i++)
         {
@@ -613,9 +617,67 @@ void RenderFrontendBase::MakeBackupPath(POVMS_Object& ropts, ViewData& vd, const
     vd.imageBackupFile.SetFile(GetFileName(Path(vd.imageBackupFile.GetFile())) + u".pov-state");
 }
 
+/// Default interval between render state checkpoints, in seconds.
+/// Checkpoints are written synchronously, so they must be asked for explicitly.
+static const POVMSInt kDefaultCheckpointInterval = 0;
+
+/// Header of the checkpoint at the start of a version 0002 render state file.
+///
+/// The header is followed by a bitmap of completed blocks, one bit per block
+/// in order of their serial numbers, and the pixel data of each plane flagged
+/// in @ref planes, row by row in single precision. All values are stored in
+/// native byte order.
+///
+struct Checkpoint_Header final
+{
+    unsigned char sig[4];
+    std::uint32_t byteOrder;
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t planes;
+    std::uint32_t blocks;
+};
+
+#define RENDER_STATE_CHECKPOINT_SIG "CkPt"
+
+static const std::uint32_t kCheckpointByteOrder = 0x01020304;
+
+/// Image planes stored in a render state checkpoint.
+struct CheckpointPlane final
+{
+    std::uint32_t flag;
+    unsigned int channels;
+    std::shared_ptr<Image> ViewData::*image;
+};
+
+static const CheckpointPlane kCheckpointPlanes[] =
+{
+    { 0x01, 4, &ViewData::image },          // red, green, blue, transmit
+    { 0x02, 3, &ViewData::convergenceMap },
+    { 0x04, 3, &ViewData::albedoBuffer },
+    { 0x08, 3, &ViewData::normalBuffer },
+    { 0x10, 1, &ViewData::depthBuffer },
+    { 0x20, 3, &ViewData::costMap },
+};
+
+static void InitCheckpoints(POVMS_Object& ropts, ViewData& vd)
+{
+    vd.completedBlocks.clear();
+
+    // blocks are at least 4 pixels square, so this is an upper bound for the actual count
+    unsigned int blockSize = max(ropts.TryGetInt(kPOVAttrib_RenderBlockSize, 32), 4);
+    size_t blocksWide = (size_t(max(ropts.TryGetInt(kPOVAttrib_Width, 160), 1)) + blockSize - 1) / blockSize;
+    size_t blocksHigh = (size_t(max(ropts.TryGetInt(kPOVAttrib_Height, 120), 1)) + blockSize - 1) / blockSize;
+    vd.maxBlocks = blocksWide * blocksHigh;
+
+    vd.checkpointInterval = std::chrono::seconds(max(ropts.TryGetInt(kPOVAttrib_BackupCheckpoint, kDefaultCheckpointInterval), 0));
+    vd.lastCheckpoint = std::chrono::steady_clock::now();
+}
+
 void RenderFrontendBase::NewBackup(POVMS_Object& ropts, ViewData& vd, const Path& outputpath)
 {
     vd.imageBackup.reset();
+    InitCheckpoints(ropts, vd);
 
     MakeBackupPath(ropts, vd, outputpath);
     if (!pov_base::PlatformBase::GetInstance().AllowLocalFileAccess (vd.imageBackupFile(), POV_File_Data_Backup, true))
@@ -658,11 +720,13 @@ void RenderFrontendBase::ContinueBackup(POVMS_Object& ropts, ViewData& vd, ViewI
 
     serial = 0;
     vd.imageBackup.reset();
+    InitCheckpoints(ropts, vd);
     MakeBackupPath(ropts, vd, outputpath);
 
     std::unique_ptr<IStream> inbuffer(new IFileStream(vd.imageBackupFile().c_str()));
 
     size_t pos = sizeof(Backup_File_Header);
+    size_t logged = 0;
 
     if (inbuffer != nullptr)
     {
@@ -686,7 +750,13 @@ void RenderFrontendBase::ContinueBackup(POVMS_Object& ropts, ViewData& vd, ViewI
                 throw POV_EXCEPTION(kFileDataErr, "Cannot read header from render state file.");
             if (memcmp (hdr.sig, RENDER_STATE_SIG, sizeof (hdr.sig)) != 0)
                 throw POV_EXCEPTION(kFileDataErr, "Render state file header appears to be invalid.");
-            if (memcmp (hdr.ver, RENDER_STATE_VER, sizeof (hdr.ver)) != 0)
+            if (memcmp (hdr.ver, RENDER_STATE_CHECKPOINT_VER, sizeof (hdr.ver)) == 0)
+            {
+                // restore the checkpoint, then replay whatever was logged after it
+                ReadCheckpoint(*inbuffer, vd, vid);
+                pos = inbuffer->tellg();
+            }
+            else if (memcmp (hdr.ver, RENDER_STATE_VER, sizeof (hdr.ver)) != 0)
                 throw POV_EXCEPTION(kFileDataErr, "Render state file was written by another version of POV-Ray.");
 
             while(pos < end && inbuffer->eof() == false)
@@ -696,19 +766,8 @@ void RenderFrontendBase::ContinueBackup(POVMS_Object& ropts, ViewData& vd, ViewI
                 try
                 {
                     msg.Read(*(inbuffer.get()));
-
-                    // do not render complete blocks again
-                    if(msg.Exist(kPOVAttrib_PixelId) == true)
-                    {
-                        POVMSInt pid = msg.GetInt(kPOVAttrib_PixelId);
-
-                        if(pid > serial)
-                            skip.push_back(pid);
-                        else
-                            serial++;
-                    }
-
                     HandleImageMessage(vid, msg.GetIdentifier(), msg);
+                    logged++;
                 }
                 catch(pov_base::Exception&)
                 {
@@ -717,6 +776,15 @@ void RenderFrontendBase::ContinueBackup(POVMS_Object& ropts, ViewData& vd, ViewI
                 }
                 pos = inbuffer->tellg();
             }
+
+            // do not render complete blocks again
+            while((size_t(serial) < vd.completedBlocks.size()) && vd.completedBlocks[serial])
+                serial++;
+            for(size_t i = size_t(serial) + 1; i < vd.completedBlocks.size(); i++)
+            {
+                if(vd.completedBlocks[i])
+                    skip.push_back(POVMSInt(i));
+            }
         }
         else
         {
@@ -746,9 +814,246 @@ void RenderFrontendBase::ContinueBackup(POVMS_Object& ropts, ViewData& vd, ViewI
         }
         else
             throw POV_EXCEPTION(kCannotOpenFileErr, "Cannot create state output file stream.");
+
+        // spare the next continue the replay of the log
+        if((logged > 0) && (vd.checkpointInterval.count() > 0))
+            WriteCheckpoint(vd);
+    }
+}
+
+void RenderFrontendBase::UpdateBackup(ViewData& vd, POVMS_Object& msg)
+{
+    // only completely rendered blocks get a block id
+    if(msg.Exist(kPOVAttrib_PixelFinal) && msg.Exist(kPOVAttrib_PixelId))
+    {
+        POVMSInt id = msg.GetInt(kPOVAttrib_PixelId);
+        if((id >= 0) && (size_t(id) < vd.maxBlocks))
+        {
+            if(size_t(id) >= vd.completedBlocks.size())
+                vd.completedBlocks.resize(id + 1, false);
+            vd.completedBlocks[id] = true;
+        }
+    }
+
+    if((vd.imageBackup != nullptr) && (vd.checkpointInterval.count() > 0) &&
+       (std::chrono::steady_clock::now() - vd.lastCheckpoint >= vd.checkpointInterval))
+        WriteCheckpoint(vd);
+}
+
+void RenderFrontendBase::WriteCheckpoint(ViewData& vd)
+{
+    UCS2String stateFile(vd.imageBackupFile());
+    UCS2String tempFile(pov_base::Filesystem::TemporaryFile::SuggestNameFor(stateFile));
+
+    vd.lastCheckpoint = std::chrono::steady_clock::now();
+
+    if(vd.image == nullptr)
+        return;
+
+    // The checkpoint is written to a separate file which then replaces the
+    // render state file, so that an interruption at any time leaves a usable
+    // render state file behind.
+    try
+    {
+        {
+            OStream out(tempFile);
+            if(!out)
+                throw POV_EXCEPTION(kCannotOpenFileErr, "Cannot create render state checkpoint.");
+
+            unsigned int width = vd.image->GetWidth();
+            unsigned int height = vd.image->GetHeight();
+
+            Backup_File_Header hdr;
+            memset(&hdr, 0, sizeof(hdr));
+            memcpy(hdr.sig, RENDER_STATE_SIG, sizeof(hdr.sig));
+            memcpy(hdr.ver, RENDER_STATE_CHECKPOINT_VER, sizeof(hdr.ver));
+
+            Checkpoint_Header chdr;
+            memcpy(chdr.sig, RENDER_STATE_CHECKPOINT_SIG, sizeof(chdr.sig));
+            chdr.byteOrder = kCheckpointByteOrder;
+            chdr.width = width;
+            chdr.height = height;
+            chdr.planes = 0;
+            chdr.blocks = std::uint32_t(vd.completedBlocks.size());
+            for(const CheckpointPlane& plane : kCheckpointPlanes)
+            {
+                const Image *img = (vd.*plane.image).get();
+                if((img != nullptr) && (img->GetWidth() == width) && (img->GetHeight() == height))
+                    chdr.planes |= plane.flag;
+            }
+
+            vector<unsigned char> bitmap((vd.completedBlocks.size() + 7) / 8, 0);
+            for(size_t i = 0; i < vd.completedBlocks.size(); i++)
+            {
+                if(vd.completedBlocks[i])
+                    bitmap[i / 8] |= (1 << (i % 8));
+            }
+
+            if(!out.write(&hdr, sizeof(hdr)) || !out.write(&chdr, sizeof(chdr)) ||
+               (!bitmap.empty() && !out.write(bitmap.data(), bitmap.size())))
+                throw POV_EXCEPTION(kFileDataErr, "Cannot write render state checkpoint.");
+
+            vector<float> row;
+            for(const CheckpointPlane& plane : kCheckpointPlanes)
+            {
+                if((chdr.planes & plane.flag) == 0)
+                    continue;
+                const Image *img = (vd.*plane.image).get();
+                row.resize(width * plane.channels);
+                for(unsigned int y = 0; y < height; y++)
+                {
+                    float *p = row.data();
+                    for(unsigned int x = 0; x < width; x++)
+                    {
+                        if(plane.channels == 4)
+                            img->GetRGBTValue(x, y, p[0], p[1], p[2], p[3]);
+                        else if(plane.channels == 3)
+                            img->GetRGBValue(x, y, p[0], p[1], p[2]);
+                        else
+                            p[0] = img->GetGrayValue(x, y);
+                        p += plane.channels;
+                    }
+                    if(!out.write(row.data(), row.size() * sizeof(float)))
+                        throw POV_EXCEPTION(kFileDataErr, "Cannot write render state checkpoint.");
+                }
+            }
+
+            out.flush();
+            if(!out)
+                throw POV_EXCEPTION(kFileDataErr, "Cannot write render state checkpoint.");
+        }
+
+        // the checkpoint must be on disk before it replaces the log
+        if(!pov_base::Filesystem::SyncFile(tempFile))
+            throw POV_EXCEPTION(kFileDataErr, "Cannot write render state checkpoint.");
+
+        // some platforms refuse to replace a file that is still open
+        vd.imageBackup.reset();
+        if(!pov_base::Filesystem::RenameFile(tempFile, stateFile))
+            throw POV_EXCEPTION(kFileDataErr, "Cannot replace render state file with checkpoint.");
+    }
+    catch(pov_base::Exception&)
+    {
+        // keep logging to the existing render state file, but don't try again
+        pov_base::Filesystem::DeleteFile(tempFile);
+        vd.checkpointInterval = std::chrono::seconds(0);
+    }
+
+    if(vd.imageBackup == nullptr)
+    {
+        vd.imageBackup = std::shared_ptr<OStream>(new OStream(stateFile, IOBase::append));
+        if(!*vd.imageBackup)
+            vd.imageBackup.reset();
+        else
+            vd.imageBackup->seekg(0, IOBase::seek_end);
     }
 }
 
+void RenderFrontendBase::ReadCheckpoint(IStream& in, ViewData& vd, ViewId vid)
+{
+    Checkpoint_Header hdr;
+
+    if(!in.read(&hdr, sizeof(hdr)) || (memcmp(hdr.sig, RENDER_STATE_CHECKPOINT_SIG, sizeof(hdr.sig)) != 0))
+        throw POV_EXCEPTION(kFileDataErr, "Cannot read checkpoint from render state file.");
+    if(hdr.byteOrder != kCheckpointByteOrder)
+        throw POV_EXCEPTION(kFileDataErr, "Render state file was written on a platform with different byte order.");
+    if((vd.image == nullptr) || (hdr.width != vd.image->GetWidth()) || (hdr.height != vd.image->GetHeight()))
+        throw POV_EXCEPTION(kFileDataErr, "Render state file does not match image size.");
+    if(hdr.blocks > vd.maxBlocks)
+        throw POV_EXCEPTION(kFileDataErr, "Render state file does not match image block count.");
+
+    vector<unsigned char> bitmap((hdr.blocks + 7) / 8);
+    if(!bitmap.empty() && !in.read(bitmap.data(), bitmap.size()))
+        throw POV_EXCEPTION(kFileDataErr, "Cannot read checkpoint from render state file.");
+    vd.completedBlocks.assign(hdr.blocks, false);
+    for(size_t i = 0; i < hdr.blocks; i++)
+        vd.completedBlocks[i] = ((bitmap[i / 8] & (1 << (i % 8))) != 0);
+
+    vector<float> row;
+    for(const CheckpointPlane& plane : kCheckpointPlanes)
+    {
+        if((hdr.planes & plane.flag) == 0)
+            continue;
+        Image *img = (vd.*plane.image).get();
+        size_t rowSize = size_t(hdr.width) * plane.channels;
+        if((img == nullptr) || (img->GetWidth() != hdr.width) || (img->GetHeight() != hdr.height))
+        {
+            if(!in.ignore(POV_OFF_T(rowSize * sizeof(float)) * hdr.height))
+                throw POV_EXCEPTION(kFileDataErr, "Cannot read checkpoint from render state file.");
+            continue;
+        }
+        row.resize(rowSize);
+        for(unsigned int y = 0; y < hdr.height; y++)
+        {
+            if(!in.read(row.data(), row.size() * sizeof(float)))
+                throw POV_EXCEPTION(kFileDataErr, "Cannot read checkpoint from render state file.");
+            const float *p = row.data();
+            for(unsigned int x = 0; x < hdr.width; x++, p += plane.channels)
+            {
+                if(plane.channels == 4)
+                    img->SetRGBTValue(x, y, p[0], p[1], p[2], p[3]);
+                else if(plane.channels == 3)
+                    img->SetRGBValue(x, y, p[0], p[1], p[2]);
+                else
+                    img->SetGrayValue(x, y, p[0]);
+            }
+        }
+    }
+
+    // show the restored image, just as replaying the log would have done
+    if(vd.display != nullptr)
+    {
+        const unsigned int kBandHeight = 16;
+        for(unsigned int top = 0; top < hdr.height; top += kBandHeight)
+        {
+            unsigned int bottom = min(top + kBandHeight, hdr.height) - 1;
+            vector<POVMSFloat> pixels;
+            pixels.reserve(size_t(hdr.width) * (bottom - top + 1) * 5);
+            for(unsigned int y = top; y <= bottom; y++)
+            {
+                for(unsigned int x = 0; x < hdr.width; x++)
+                {
+                    float r, g, b, t;
+                    vd.image->GetRGBTValue(x, y, r, g, b, t);
+                    pixels.push_back(r);
+                    pixels.push_back(g);
+                    pixels.push_back(b);
+                    pixels.push_back(0.0); // unused component
+                    pixels.push_back(t);
+                }
+            }
+
+            // not flagged as final, so only the display picks it up
+            POVMS_Object msg(kPOVObjectClass_PixelData);
+            msg.SetFloatVector(kPOVAttrib_PixelBlock, pixels);
+            msg.SetInt(kPOVAttrib_PixelSize, 1);
+            msg.SetInt(kPOVAttrib_Left, 0);
+            msg.SetInt(kPOVAttrib_Top, top);
+            msg.SetInt(kPOVAttrib_Right, hdr.width - 1);
+            msg.SetInt(kPOVAttrib_Bottom, bottom);
+            HandleImageMessage(vid, kPOVMsgIdent_PixelBlockSet, msg);
+        }
+    }
+}
+
+void RenderFrontendBase::NewFramebuffer(POVMS_Object& ropts, ViewData& vd, ViewId vid)
+{
+    vd.framebuffer.reset();
+    if (ropts.Exist(kPOVAttrib_SharedFramebufferFile))
+        ropts.Remove(kPOVAttrib_SharedFramebufferFile);
+
+    if (!ropts.TryGetBool(kPOVAttrib_SharedFramebuffer, false) || ((vd.image == nullptr) && (vd.display == nullptr)))
+        return;
+
+    // The platform may hand out only one temporary file name per process,
+    // so derive a distinct name for each view from it.
+    UCS2String filename(pov_base::Filesystem::TemporaryFile().GetFileName() +
+                        ASCIItoUCS2String("-fb" + std::to_string(vid.GetIdentifier())));
+
+    vd.framebuffer = std::make_shared<SharedFramebuffer>(filename, ropts.TryGetInt(kPOVAttrib_Width, 160), ropts.TryGetInt(kPOVAttrib_Height, 120));
+    ropts.SetUCS2String(kPOVAttrib_SharedFramebufferFile, filename.c_str());
+}
+
 namespace Message2Console
 {
 
@@ -1028,11 +1333,18 @@ void RenderOptions(POVMS_Object& obj, TextStreamBuffer *tsb)
     tsb->printf("\n");
 */
 
+    if(obj.TryGetBool(kPOVAttrib_Denoise, false) == true)
+        tsb->printf("  Denoising............On  (Strength %.2f)\n", max(obj.TryGetFloat(kPOVAttrib_DenoiseStrength, 1.0f), 0.0f));
+
+    if(obj.TryGetBool(kPOVAttrib_ProgressiveRefinement, false) == true)
+        tsb->printf("  Progressive..........On  (Output Interval %.1f)\n",
+                    max(obj.TryGetFloat(kPOVAttrib_ProgressiveOutputInterval, 10.0f), 0.0f));
+
     if(obj.TryGetBool(kPOVAttrib_Antialias, false) == true)
     {
         int method = 0;
         if(obj.TryGetBool(kPOVAttrib_Antialias, false) == true)
-            method = clip(obj.TryGetInt(kPOVAttrib_SamplingMethod, 1), 0, 3); // TODO FIXME - magic number in clip
+            method = clip(obj.TryGetInt(kPOVAttrib_SamplingMethod, 1), 0, 4); // TODO FIXME - magic number in clip
         int depth = clip(obj.TryGetInt(kPOVAttrib_AntialiasDepth, 3), 1, 9); // TODO FIXME - magic number in clip
         float threshold = clip(obj.TryGetFloat(kPOVAttrib_AntialiasThreshold, 0.3f), 0.0f, 1.0f);
         float aagamma = obj.TryGetFloat(kPOVAttrib_AntialiasGamma, 2.5f);
@@ -1045,6 +1357,9 @@ void RenderOptions(POVMS_Object& obj, TextStreamBuffer *tsb)
         else
             tsb->printf("  Antialiasing.........On  (Method %d, Threshold %.3f, Depth %d, Jitter Off, Gamma %.2f)\n",
                            method, threshold, depth, aagamma);
+        float timebudget = obj.TryGetFloat(kPOVAttrib_AntialiasTimeBudget, 0.0f);
+        if((method == 4) && (timebudget > 0.0f))
+            tsb->printf("  Antialias time budget %.1f seconds\n", timebudget);
     }
     else
         tsb->printf("  Antialiasing.........Off\n");
@@ -1295,6 +1610,11 @@ void AnimationOptions(POVMS_Object& cppmsg, TextStreamBuffer *tsb)
                       GetOptionSwitchString(msg, kPOVAttrib_CyclicAnimation, false),
                       GetOptionSwitchString(msg, kPOVAttrib_FieldRender, false),
                       GetOptionSwitchString(msg, kPOVAttrib_OddField, false));
+        tsb->printf("\n  Pipelined Frames....%s", GetOptionSwitchString(msg, kPOVAttrib_PipelineAnimation, false));
+        i = 0;
+        (void)POVMSUtil_GetInt(msg, kPOVAttrib_PipelineMemoryLimit, &i);
+        if (i > 0)
+            tsb->printf("  (Memory Limit %d MB)", (int)i);
     }
     else
         tsb->printf("  Clock value: %8.3f  (Animation off)", (float)f);
@@ -1323,6 +1643,44 @@ void ParserStatistics(POVMS_Object& cppmsg, TextStreamBuffer *tsb)
     tsb->printf("Light Sources:    %10d\n", l);
     tsb->printf("Total:            %10d\n", s + i + l);
 
+    if(cppmsg.Exist(kPOVAttrib_IncludeCacheHits) == true)
+    {
+        tsb->printf("----------------------------------------------------------------------------\n");
+        tsb->printf("Include Cache Hits:   %6d          Misses:     %10d\n",
+                    cppmsg.TryGetInt(kPOVAttrib_IncludeCacheHits, 0), cppmsg.TryGetInt(kPOVAttrib_IncludeCacheMisses, 0));
+    }
+
+    if(cppmsg.Exist(kPOVAttrib_SymbolLookups) == true)
+    {
+        double lookups = POVMSLongToCDouble(cppmsg.TryGetLong(kPOVAttrib_SymbolLookups, 0));
+        double probes = POVMSLongToCDouble(cppmsg.TryGetLong(kPOVAttrib_SymbolProbes, 0));
+        int symbols = cppmsg.TryGetInt(kPOVAttrib_GlobalSymbols, 0);
+        int slots = cppmsg.TryGetInt(kPOVAttrib_GlobalSymbolSlots, 0);
+        tsb->printf("----------------------------------------------------------------------------\n");
+        tsb->printf("Symbol Lookups:   %10.0f          Probes/Lookup: %10.2f\n", lookups, (lookups > 0.0 ? probes / lookups : 0.0));
+        tsb->printf("Global Symbols:   %10d          Table Load:    %9.1f%%\n", symbols, (slots > 0 ? 100.0 * symbols / slots : 0.0));
+    }
+
+    if(cppmsg.Exist(kPOVAttrib_SceneMemoryBytes) == true)
+    {
+        // in the order of pov::SceneArenaCategory
+        static const char *const kCategoryNames[] = { "Objects:", "Textures:", "Pigments:", "Normals:", "Finishes:", "Transforms:", "Blend Maps:" };
+        vector<POVMSLong> blocks(cppmsg.GetLongVector(kPOVAttrib_SceneMemoryBlocks));
+        vector<POVMSLong> bytes(cppmsg.GetLongVector(kPOVAttrib_SceneMemoryBytes));
+        double totalBlocks = 0.0;
+        double totalBytes = 0.0;
+        tsb->printf("----------------------------------------------------------------------------\n");
+        tsb->printf("Scene Data Memory       Blocks          Bytes\n");
+        for (size_t n = 0; (n < blocks.size()) && (n < bytes.size()) && (n < sizeof(kCategoryNames) / sizeof(kCategoryNames[0])); n++)
+        {
+            tsb->printf("%-18s%10.0f %14.0f\n", kCategoryNames[n], POVMSLongToCDouble(blocks[n]), POVMSLongToCDouble(bytes[n]));
+            totalBlocks += POVMSLongToCDouble(blocks[n]);
+            totalBytes += POVMSLongToCDouble(bytes[n]);
+        }
+        tsb->printf("Total:            %10.0f %14.0f          Reserved: %12.0f\n",
+                    totalBlocks, totalBytes, POVMSLongToCDouble(cppmsg.TryGetLong(kPOVAttrib_SceneMemoryReserved, 0)));
+    }
+
     if(cppmsg.Exist(kPOVAttrib_BSPNodes) == true)
     {
         tsb->printf("----------------------------------------------------------------------------\n");
@@ -1423,6 +1781,69 @@ void RenderStatistics(POVMS_Object& cppmsg, TextStreamBuffer *tsb)
         (void)POVMSAttr_Delete(&attr);
     }
 
+    if(POVMSObject_Get(msg, &attr, kPOVAttrib_ObjectProfile) == kNoErr)
+    {
+        int cnt = 0;
+        POVMSFloat total = 0.0;
+
+        (void)POVMSUtil_GetInt(msg, kPOVAttrib_ObjectProfileCount, &i);
+        (void)POVMSUtil_GetFloat(msg, kPOVAttrib_ObjectProfileTotal, &total);
+
+        if((POVMSAttrList_Count(&attr, &cnt) == kNoErr) && (cnt > 0))
+        {
+            POVMSObject obj;
+            POVMSFloat t;
+            POVMSInt ucs2len;
+            UCS2 ucs2buf[1024];
+            int ii, len;
+            char str[40];
+
+            tsb->printf("----------------------------------------------------------------------------\n");
+            tsb->printf("Object Profile (top %d of %d objects by estimated intersection time)\n", cnt, i);
+            tsb->printf("----------------------------------------------------------------------------\n");
+            tsb->printf("  Time       Tests   Hits   Shadow Tests  Object\n");
+            tsb->printf("----------------------------------------------------------------------------\n");
+
+            for(ii = 1; ii <= cnt; ii++)
+            {
+                if(POVMSAttrList_GetNth(&attr, ii, &obj) == kNoErr)
+                {
+                    len = 40;
+                    str[0] = 0;
+                    ucs2len = 1024;
+                    ucs2buf[0] = 0;
+                    t = 0.0;
+                    i2 = 0;
+                    (void)POVMSUtil_GetString(&obj, kPOVAttrib_ObjectName, str, &len);
+                    (void)POVMSUtil_GetUCS2String(&obj, kPOVAttrib_FileName, ucs2buf, &ucs2len);
+                    (void)POVMSUtil_GetLong(&obj, kPOVAttrib_ISectsTests, &l);
+                    (void)POVMSUtil_GetLong(&obj, kPOVAttrib_ISectsSucceeded, &l2);
+                    (void)POVMSUtil_GetLong(&obj, kPOVAttrib_ShadowTest, &l3);
+                    (void)POVMSUtil_GetFloat(&obj, kPOVAttrib_ObjectProfileTime, &t);
+
+                    tsb->printf("%6.2f%%  %10.0f  %5.1f%%  %12.0f  %s", (total > 0.0) ? 100.0 * t / total : 0.0,
+                                POVMSLongToCDouble(l),
+                                (POVMSLongToCDouble(l) > 0.5) ? 100.0 * POVMSLongToCDouble(l2) / POVMSLongToCDouble(l) : 0.0,
+                                POVMSLongToCDouble(l3), str);
+
+                    if(ucs2buf[0] != 0)
+                    {
+                        POVMSLong line = 0, column = 0;
+                        (void)POVMSUtil_GetLong(&obj, kPOVAttrib_Line, &line);
+                        (void)POVMSUtil_GetLong(&obj, kPOVAttrib_Column, &column);
+                        tsb->printf(", %s:%.0f:%.0f", UCS2toSysString(ucs2buf).c_str(),
+                                    POVMSLongToCDouble(line), POVMSLongToCDouble(column));
+                    }
+                    tsb->printf("\n");
+
+                    (void)POVMSAttr_Delete(&obj);
+                }
+            }
+        }
+
+        (void)POVMSAttr_Delete(&attr);
+    }
+
     (void)POVMSUtil_GetLong(msg, kPOVAttrib_IsoFindRoot, &l);
     (void)POVMSUtil_GetLong(msg, kPOVAttrib_FunctionVMCalls, &l2);
     if((POVMSLongToCDouble(l) > 0.5) || (POVMSLongToCDouble(l2) > 0.5))
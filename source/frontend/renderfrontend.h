@@ -44,6 +44,7 @@
 //  (none at the moment)
 
 // C++ standard header files
+#include <chrono>
 #include <list>
 #include <map>
 #include <memory>
@@ -64,6 +65,7 @@
 #include "base/types.h"
 #include "base/image/colourspace.h"
 #include "base/image/image.h"
+#include "base/image/sharedframebuffer.h"
 
 // POV-Ray header files (POVMS module)
 #include "povms/povmscpp.h"
@@ -128,6 +130,11 @@ struct SceneData final
 
     bool verbose;
 
+    /// Local files read while parsing, and their status as of when they were opened.
+    std::map<UCS2String, Filesystem::FileStatus> inputFiles;
+    /// Whether @ref inputFiles is known to be complete.
+    bool inputFilesComplete;
+
     struct final
     {
         int legacyGammaMode;
@@ -155,12 +162,28 @@ struct ViewData final
     ViewState state;
 
     mutable std::shared_ptr<Image> image;
+    mutable std::shared_ptr<Image> convergenceMap;
+    mutable std::shared_ptr<Image> costMap;
+    mutable std::shared_ptr<Image> albedoBuffer;
+    mutable std::shared_ptr<Image> normalBuffer;
+    mutable std::shared_ptr<Image> depthBuffer;
     mutable std::shared_ptr<Display> display;
     mutable std::shared_ptr<OStream> imageBackup;
+    mutable std::shared_ptr<SharedFramebuffer> framebuffer;
+    /// Output image file being written during the render, if any.
+    mutable std::shared_ptr<ImageStream> imageStream;
     GammaCurvePtr displayGamma;
     bool greyscaleDisplay;
 
     Path imageBackupFile;
+    /// Blocks known to be completely rendered, indexed by block serial number.
+    std::vector<bool> completedBlocks;
+    /// Upper bound for the number of blocks in the image.
+    size_t maxBlocks = 0;
+    /// Interval at which to compact the render state file into a checkpoint, or zero to only log.
+    std::chrono::seconds checkpointInterval = std::chrono::seconds(0);
+    /// Time of the last checkpoint.
+    std::chrono::steady_clock::time_point lastCheckpoint;
 };
 
 namespace Message2Console
@@ -190,6 +213,8 @@ std::string GetProgressTime(POVMS_Object& obj, POVMSType key);
 
 #define RENDER_STATE_SIG "POV-Ray Render State File\0\0"
 #define RENDER_STATE_VER "0001"
+/// Version of render state files starting with a checkpoint, followed by a log as in version 0001.
+#define RENDER_STATE_CHECKPOINT_VER "0002"
 
 struct Backup_File_Header final
 {
@@ -269,6 +294,10 @@ class RenderFrontendBase : public POVMS_MessageReceiver
         void MakeBackupPath(POVMS_Object& ropts, ViewData& vd, const Path& outputpath);
         void NewBackup(POVMS_Object& ropts, ViewData& vd, const Path& outputpath);
         void ContinueBackup(POVMS_Object& ropts, ViewData& vd, ViewId vid, POVMSInt& serial, std::vector<POVMSInt>& skip, const Path& outputpath);
+        void NewFramebuffer(POVMS_Object& ropts, ViewData& vd, ViewId vid);
+        void UpdateBackup(ViewData& vd, POVMS_Object& msg);
+        void WriteCheckpoint(ViewData& vd);
+        void ReadCheckpoint(IStream& in, ViewData& vd, ViewId vid);
 };
 
 // TODO - Do we really need this to be a template?
@@ -300,6 +329,10 @@ class RenderFrontend : public RenderFrontendBase
 
         SceneData::SceneState GetSceneState(SceneId sid);
 
+        /// Whether none of the files read while parsing a scene have changed since.
+        /// @return `false` if the files have changed, or cannot be checked.
+        bool IsSceneUpToDate(SceneId sid);
+
         void StartParser(SceneId sid, POVMS_Object& obj);
         void PauseParser(SceneId sid);
         void ResumeParser(SceneId sid);
@@ -338,6 +371,7 @@ class RenderFrontend : public RenderFrontendBase
         View2SceneMap   view2scene;
 
         void GetBackwardCompatibilityData(SceneData& sd, POVMS_Object& msg);
+        void GetInputFiles(SceneData& sd, POVMS_Object& msg);
 };
 
 template<class PARSER_MH, class FILE_MH, class RENDER_MH, class IMAGE_MH>
@@ -418,6 +452,22 @@ SceneData::SceneState RenderFrontend<PARSER_MH, FILE_MH, RENDER_MH, IMAGE_MH>::G
         return SceneData::Scene_Unknown;
 }
 
+template<class PARSER_MH, class FILE_MH, class RENDER_MH, class IMAGE_MH>
+bool RenderFrontend<PARSER_MH, FILE_MH, RENDER_MH, IMAGE_MH>::IsSceneUpToDate(SceneId sid)
+{
+    typename SceneHandlerMap::iterator shi(scenehandler.find(sid));
+    if ((shi == scenehandler.end()) || !shi->second.data.inputFilesComplete || shi->second.data.inputFiles.empty())
+        return false;
+    for (const auto& file : shi->second.data.inputFiles)
+    {
+        Filesystem::FileStatus status;
+        if (!Filesystem::GetFileStatus(file.first, status) ||
+            (status.size != file.second.size) || (status.modificationTime != file.second.modificationTime))
+            return false;
+    }
+    return true;
+}
+
 template<class PARSER_MH, class FILE_MH, class RENDER_MH, class IMAGE_MH>
 void RenderFrontend<PARSER_MH, FILE_MH, RENDER_MH, IMAGE_MH>::StartParser(SceneId sid, POVMS_Object& obj)
 {
@@ -561,8 +611,16 @@ RenderFrontendBase::ViewId RenderFrontend<PARSER_MH, FILE_MH, RENDER_MH, IMAGE_M
 
                     vh.data.image = img;
                 }
-                else
+                else if (!imageProcessing->OutputIsTiled())
                     vh.data.image = std::shared_ptr<Image>(Image::Create(width, height, ImageDataType::RGBFT_Float));
+
+                vh.data.convergenceMap = imageProcessing->GetConvergenceMap();
+                vh.data.costMap = imageProcessing->GetCostMap();
+                vh.data.albedoBuffer = imageProcessing->GetAlbedoBuffer();
+                vh.data.normalBuffer = imageProcessing->GetNormalBuffer();
+                vh.data.depthBuffer = imageProcessing->GetDepthBuffer();
+                if ((img != nullptr) || imageProcessing->OutputIsTiled())
+                    vh.data.imageStream = imageProcessing->StartStream(obj);
             }
 
             if(obj.TryGetBool(kPOVAttrib_Display, true) == true)
@@ -710,6 +768,8 @@ void RenderFrontend<PARSER_MH, FILE_MH, RENDER_MH, IMAGE_MH>::StartRender(ViewId
             }
         }
 
+        NewFramebuffer(obj, vhi->second.data, vid);
+
         RenderFrontendBase::StartRender(vhi->second.data, vid, obj);
         HandleRenderMessage(vid, kPOVMsgIdent_RenderOptions, obj);
     }
@@ -778,6 +838,7 @@ void RenderFrontend<PARSER_MH, FILE_MH, RENDER_MH, IMAGE_MH>::HandleParserMessag
         if(ident == kPOVMsgIdent_Done)
         {
             GetBackwardCompatibilityData(shi->second.data, msg);
+            GetInputFiles(shi->second.data, msg);
             shi->second.data.state = SceneData::Scene_Ready;
         }
         else if(ident == kPOVMsgIdent_Failed)
@@ -840,7 +901,10 @@ void RenderFrontend<PARSER_MH, FILE_MH, RENDER_MH, IMAGE_MH>::HandleImageMessage
 {
     typename ViewHandlerMap::iterator vhi(viewhandler.find(vid));
     if(vhi != viewhandler.end())
+    {
         vhi->second.image.HandleMessage(scenehandler[view2scene[vid]].data, vhi->second.data, ident, msg);
+        UpdateBackup(vhi->second.data, msg);
+    }
 }
 
 template<class PARSER_MH, class FILE_MH, class RENDER_MH, class IMAGE_MH>
@@ -857,6 +921,31 @@ void RenderFrontend<PARSER_MH, FILE_MH, RENDER_MH, IMAGE_MH>::GetBackwardCompati
     sd.backwardCompatibilityData.workingGamma = msg.TryGetFloat(kPOVAttrib_WorkingGamma, DEFAULT_WORKING_GAMMA);
 }
 
+template<class PARSER_MH, class FILE_MH, class RENDER_MH, class IMAGE_MH>
+void RenderFrontend<PARSER_MH, FILE_MH, RENDER_MH, IMAGE_MH>::GetInputFiles(SceneData& sd, POVMS_Object& msg)
+{
+    sd.inputFiles.clear();
+    sd.inputFilesComplete = false;
+    if (!msg.Exist(kPOVAttrib_ReadFiles))
+        return;
+
+    POVMS_List files;
+    msg.Get(kPOVAttrib_ReadFiles, files);
+    std::vector<POVMSLong> sizes(msg.GetLongVector(kPOVAttrib_ReadFileSizes));
+    std::vector<POVMSLong> times(msg.GetLongVector(kPOVAttrib_ReadFileTimes));
+    if ((sizes.size() != size_t(files.GetListSize())) || (times.size() != sizes.size()))
+        return;
+    for (int i = 1; i <= files.GetListSize(); i++)
+    {
+        POVMS_Attribute file;
+        files.GetNth(i, file);
+        Filesystem::FileStatus& status = sd.inputFiles[file.GetUCS2String()];
+        status.size = sizes[i - 1];
+        status.modificationTime = times[i - 1];
+    }
+    sd.inputFilesComplete = true;
+}
+
 namespace Message2TSB
 {
     void InitInfo(TextStreamBuffer *, POVMSObjectPtr);
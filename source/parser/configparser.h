@@ -72,6 +72,24 @@
     #define POV_PARSER_MAX_CACHED_MACRO_SIZE 65536
 #endif
 
+/// @def POV_PARSER_MAX_COMPILED_FILE_SIZE
+/// Size limit for input files to be pre-scanned in memory when they contain loops or macros.
+///
+/// Files are pre-scanned once a loop jumps back for its second iteration, or a macro is
+/// invoked for the second time. Files exceeding this limit are only pre-scanned if a
+/// persistent include cache is in use.
+///
+#ifndef POV_PARSER_MAX_COMPILED_FILE_SIZE
+    #define POV_PARSER_MAX_COMPILED_FILE_SIZE 4194304
+#endif
+
+/// @def POV_PARSER_MAX_COMPILED_TOKENS
+/// Limit for the total number of pre-processed tokens retained for re-use by loops and macros.
+///
+#ifndef POV_PARSER_MAX_COMPILED_TOKENS
+    #define POV_PARSER_MAX_COMPILED_TOKENS 1048576
+#endif
+
 //******************************************************************************
 ///
 /// @name Debug Settings.
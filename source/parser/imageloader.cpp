@@ -0,0 +1,172 @@
+//******************************************************************************
+///
+/// @file parser/imageloader.cpp
+///
+/// Implementations for the asynchronous image file loader of the parser.
+///
+/// @copyright
+/// @parblock
+///
+/// Persistence of Vision Ray Tracer ('POV-Ray') version 3.8.
+/// Copyright 1991-2019 Persistence of Vision Raytracer Pty. Ltd.
+///
+/// POV-Ray is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU Affero General Public License as
+/// published by the Free Software Foundation, either version 3 of the
+/// License, or (at your option) any later version.
+///
+/// POV-Ray is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU Affero General Public License for more details.
+///
+/// You should have received a copy of the GNU Affero General Public License
+/// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+///
+/// ----------------------------------------------------------------------------
+///
+/// POV-Ray is based on the popular DKB raytracer version 2.12.
+/// DKBTrace was originally written by David K. Buck.
+/// DKBTrace Ver 2.0-2.12 were written by David K. Buck & Aaron A. Collins.
+///
+/// @endparblock
+///
+//******************************************************************************
+
+// Unit header file must be the first file included within POV-Ray *.cpp files (pulls in config)
+#include "parser/imageloader.h"
+
+// C++ variants of C standard header files
+//  (none at the moment)
+
+// C++ standard header files
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+// POV-Ray header files (base module)
+#include "base/fileinputoutput.h"
+#include "base/image/colourspace.h"
+
+// POV-Ray header files (core module)
+//  (none at the moment)
+
+// POV-Ray header files (parser module)
+//  (none at the moment)
+
+// this must be the last file included
+#include "base/povdebug.h"
+
+namespace pov_parser
+{
+
+//******************************************************************************
+
+ImageLoader::ImageLoader(unsigned int threads) :
+    mSharedCount(0),
+    mMaxQueued(4 * std::max(threads, 1u)),
+    mStop(false)
+{
+    for (unsigned int i = 0; i < std::max(threads, 1u); ++i)
+        mWorkers.emplace_back(&ImageLoader::Work, this);
+}
+
+ImageLoader::~ImageLoader()
+{
+    std::deque<Job> discarded;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+        discarded.swap(mQueue);
+    }
+    // anyone still holding on to a discarded request must not wait for it forever
+    for (auto& job : discarded)
+    {
+        Result result;
+        result.error = "Image loading was cancelled.";
+        job.promise.set_value(std::move(result));
+    }
+    mQueueChanged.notify_all();
+    for (auto& worker : mWorkers)
+        worker.join();
+}
+
+ImageLoader::PendingResult ImageLoader::Load(const UCS2String& fileName, Image::ImageFileType type,
+                                             const std::shared_ptr<IStream>& file, const ImageReadOptions& options)
+{
+    // gamma curves are shared instances, so identical curves can be told by their address
+    Key key(fileName, int(type), options.defaultGamma.get(), options.workingGamma.get(),
+            options.gammaOverride, options.gammacorrect, options.premultipliedOverride, options.premultiplied);
+
+    auto found = mResults.find(key);
+    if (found != mResults.end())
+    {
+        ++mSharedCount;
+        return found->second;
+    }
+
+    Job job;
+    job.type = type;
+    job.file = file;
+    job.options = options;
+    PendingResult result(job.promise.get_future().share());
+    mResults.emplace(key, result);
+
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mQueueChanged.wait(lock, [this]{ return mQueue.size() < mMaxQueued; });
+        mQueue.push_back(std::move(job));
+    }
+    mQueueChanged.notify_all();
+
+    return result;
+}
+
+bool ImageLoader::Owns(const std::shared_ptr<Image>& image) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return (mDecoded.find(image.get()) != mDecoded.end());
+}
+
+void ImageLoader::Work()
+{
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mQueueChanged.wait(lock, [this]{ return mStop || !mQueue.empty(); });
+            if (mStop)
+                return;
+            job = std::move(mQueue.front());
+            mQueue.pop_front();
+        }
+        mQueueChanged.notify_all();
+
+        Result result;
+        try
+        {
+            result.image.reset(Image::Read(job.type, job.file.get(), job.options));
+            if (result.image == nullptr)
+                result.error = "Cannot read image.";
+        }
+        catch (std::exception& e)
+        {
+            result.error = e.what();
+        }
+        result.warnings = job.options.warnings;
+
+        if (result.image != nullptr)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mDecoded.insert(result.image.get());
+        }
+
+        // close the file right away rather than when the next job is taken
+        job.file.reset();
+        job.promise.set_value(std::move(result));
+    }
+}
+
+}
+// end of namespace pov_parser
@@ -0,0 +1,166 @@
+//******************************************************************************
+///
+/// @file parser/imageloader.h
+///
+/// Declarations for the asynchronous image file loader of the parser.
+///
+/// @copyright
+/// @parblock
+///
+/// Persistence of Vision Ray Tracer ('POV-Ray') version 3.8.
+/// Copyright 1991-2019 Persistence of Vision Raytracer Pty. Ltd.
+///
+/// POV-Ray is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU Affero General Public License as
+/// published by the Free Software Foundation, either version 3 of the
+/// License, or (at your option) any later version.
+///
+/// POV-Ray is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU Affero General Public License for more details.
+///
+/// You should have received a copy of the GNU Affero General Public License
+/// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+///
+/// ----------------------------------------------------------------------------
+///
+/// POV-Ray is based on the popular DKB raytracer version 2.12.
+/// DKBTrace was originally written by David K. Buck.
+/// DKBTrace Ver 2.0-2.12 were written by David K. Buck & Aaron A. Collins.
+///
+/// @endparblock
+///
+//******************************************************************************
+
+#ifndef POVRAY_PARSER_IMAGELOADER_H
+#define POVRAY_PARSER_IMAGELOADER_H
+
+// Module config header file must be the first file included within POV-Ray unit header files
+#include "parser/configparser.h"
+
+// C++ variants of C standard header files
+//  (none at the moment)
+
+// C++ standard header files
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// POV-Ray header files (base module)
+#include "base/fileinputoutput_fwd.h"
+#include "base/stringtypes.h"
+#include "base/image/image.h"
+
+// POV-Ray header files (core module)
+//  (none at the moment)
+
+// POV-Ray header files (parser module)
+//  (none at the moment)
+
+namespace pov_parser
+{
+
+using namespace pov_base;
+
+//******************************************************************************
+
+/// Pool of threads decoding image files while the parser carries on.
+///
+/// The parser locates and opens each image file itself, and hands the stream
+/// over to be decoded by one of the worker threads; it only waits for the
+/// result once it actually needs the image's contents.
+///
+/// Requests for the same file with the same decoding options share a single
+/// decode, and thus a single image.
+///
+class ImageLoader final
+{
+public:
+
+    /// Outcome of loading an image file.
+    struct Result final
+    {
+        std::shared_ptr<Image>      image;      ///< Image loaded, or empty if loading failed.
+        std::string                 error;      ///< Reason for failure, if loading failed.
+        std::vector<std::string>    warnings;   ///< Warnings issued while decoding the file.
+    };
+
+    using PendingResult = std::shared_future<Result>;
+
+    /// Start the worker threads.
+    /// @param  threads Number of worker threads.
+    ImageLoader(unsigned int threads);
+
+    /// Stop the worker threads, failing any requests not yet started.
+    ~ImageLoader();
+
+    ImageLoader(const ImageLoader&) = delete;
+    ImageLoader& operator=(const ImageLoader&) = delete;
+
+    /// Request an image file to be loaded.
+    ///
+    /// If the same file has already been requested with the same options, the
+    /// previous request's result is returned instead, and the stream is ignored.
+    /// Otherwise this may block until the number of requests queued falls below
+    /// a limit, so that only a bounded number of files are held open.
+    ///
+    /// @param  fileName    Full name of the file as located, identifying it.
+    /// @param  type        Image file format.
+    /// @param  file        Stream to read the file from.
+    /// @param  options     Decoding options.
+    /// @return             Result of the request, available once decoded.
+    ///
+    PendingResult Load(const UCS2String& fileName, Image::ImageFileType type,
+                       const std::shared_ptr<IStream>& file, const ImageReadOptions& options);
+
+    /// Whether an image was decoded by this loader.
+    ///
+    /// The loader holds a reference of its own to each image it has decoded,
+    /// so that later requests for the same file can share it.
+    ///
+    bool Owns(const std::shared_ptr<Image>& image) const;
+
+    /// Number of requests that have actually been decoded.
+    unsigned int GetLoadCount() const { return (unsigned int)(mResults.size()); }
+
+    /// Number of requests that were served by a previous request for the same file.
+    unsigned int GetSharedCount() const { return mSharedCount; }
+
+private:
+
+    using Key = std::tuple<UCS2String, int, const GammaCurve*, const GammaCurve*, bool, bool, bool, bool>;
+
+    struct Job final
+    {
+        std::promise<Result>        promise;
+        Image::ImageFileType        type;
+        std::shared_ptr<IStream>    file;
+        ImageReadOptions            options;
+    };
+
+    std::map<Key, PendingResult>    mResults;
+    unsigned int                    mSharedCount;
+    std::set<const Image*>          mDecoded;       ///< Images decoded, and thus referenced by @ref mResults.
+    std::deque<Job>                 mQueue;
+    mutable std::mutex              mMutex;
+    std::condition_variable         mQueueChanged;
+    std::vector<std::thread>        mWorkers;
+    size_t                          mMaxQueued;
+    bool                            mStop;
+
+    void Work();
+};
+
+}
+// end of namespace pov_parser
+
+#endif // POVRAY_PARSER_IMAGELOADER_H
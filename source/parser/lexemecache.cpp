@@ -0,0 +1,491 @@
+//******************************************************************************
+///
+/// @file parser/lexemecache.cpp
+///
+/// Implementations for the persistent lexeme cache of the parser.
+///
+/// @copyright
+/// @parblock
+///
+/// Persistence of Vision Ray Tracer ('POV-Ray') version 3.8.
+/// Copyright 1991-2019 Persistence of Vision Raytracer Pty. Ltd.
+///
+/// POV-Ray is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU Affero General Public License as
+/// published by the Free Software Foundation, either version 3 of the
+/// License, or (at your option) any later version.
+///
+/// POV-Ray is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU Affero General Public License for more details.
+///
+/// You should have received a copy of the GNU Affero General Public License
+/// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+///
+/// ----------------------------------------------------------------------------
+///
+/// POV-Ray is based on the popular DKB raytracer version 2.12.
+/// DKBTrace was originally written by David K. Buck.
+/// DKBTrace Ver 2.0-2.12 were written by David K. Buck & Aaron A. Collins.
+///
+/// @endparblock
+///
+//******************************************************************************
+
+// Unit header file must be the first file included within POV-Ray *.cpp files (pulls in config)
+#include "parser/lexemecache.h"
+
+// C++ variants of C standard header files
+#include <cstdio>
+#include <cstring>
+
+// C++ standard header files
+#include <algorithm>
+#include <limits>
+
+// Boost header files
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+// POV-Ray header files (base module)
+#include "base/fileinputoutput.h"
+#include "base/filesystem.h"
+#include "base/platformbase.h"
+#include "base/pov_err.h"
+#include "base/stringutilities.h"
+
+// POV-Ray header files (core module)
+//  (none at the moment)
+
+// POV-Ray header files (parser module)
+//  (none at the moment)
+
+// this must be the last file included
+#include "base/povdebug.h"
+
+namespace pov_parser
+{
+
+namespace bip = boost::interprocess;
+
+//******************************************************************************
+
+namespace
+{
+
+#define LEXEME_CACHE_FILE_MAGIC         "POVLXC\x1a"
+#define LEXEME_CACHE_FILE_VERSION       2
+#define LEXEME_CACHE_FILE_BYTE_ORDER    0x01020304
+
+// The header is followed by the input file name (padded to a multiple of 8 bytes),
+// the lexeme records, and finally the lexeme text.
+struct LexemeCacheFileHeader final
+{
+    char        magic[8];
+    POV_UINT32  version;
+    POV_UINT32  byteOrder;
+    POV_UINT32  recordSize;         // size of a lexeme record, for sanity checking
+    POV_UINT32  flags;
+    POV_UINT64  sourceSize;
+    POV_INT64   sourceTime;
+    POV_UINT64  sourceHash;
+    POV_UINT32  nameLength;         // in UCS2 code units
+    POV_UINT32  recordCount;
+    POV_UINT32  textSize;
+    POV_UINT32  nominalEndOfLine;
+    POV_INT64   endOfLineOffset;
+    POV_INT64   endOffset;
+    POV_INT64   endLine;
+    POV_INT64   endColumn;
+};
+
+static_assert(sizeof(LexemeCacheFileHeader) % 8 == 0, "Lexeme cache file header breaks record alignment.");
+
+enum : POV_UINT32
+{
+    kLexemeCacheFlag_NestedBlockComments = 0x0001,
+};
+
+constexpr POV_UINT64 kHashOffsetBasis   = 0xCBF29CE484222325ull;
+constexpr POV_UINT64 kHashPrime         = 0x00000100000001B3ull;
+
+/// Compute a 64-bit FNV-1a hash of a block of data.
+POV_UINT64 HashData(const void* data, size_t size)
+{
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    POV_UINT64 hash = kHashOffsetBasis;
+    for (size_t i = 0; i < size; ++i)
+        hash = (hash ^ p[i]) * kHashPrime;
+    return hash;
+}
+
+/// Size of the input file name in a cache file, including padding.
+size_t PaddedNameSize(size_t nameLength)
+{
+    return (nameLength * sizeof(UCS2) + 7) & ~size_t(7);
+}
+
+/// Lexemes scanned from an input stream.
+struct ScannedLexemes final
+{
+    std::vector<LexemeCacheEntry::Record>   records;
+    UTF8String                              text;
+};
+
+/// Lexemes memory-mapped from a cache file.
+struct MappedLexemes final
+{
+    bip::file_mapping   mapping;
+    bip::mapped_region  region;
+};
+
+}
+// end of unnamed namespace
+
+//******************************************************************************
+
+size_t LexemeCacheEntry::Find(POV_OFF_T offset) const
+{
+    const Record* i = std::lower_bound(records, records + recordCount, offset,
+                                       [](const Record& r, POV_OFF_T o) { return r.offset < o; });
+    return i - records;
+}
+
+Scanner::Character LexemeCacheEntry::NominalEndOfLineAt(POV_OFF_T offset) const
+{
+    if ((endOfLineOffset < 0) || (offset <= endOfLineOffset))
+        return '\0';
+    return nominalEndOfLine;
+}
+
+void LexemeCacheEntry::GetLexeme(size_t index, Lexeme& lexeme) const
+{
+    const Record& record = records[index];
+    lexeme.text.assign(text + record.textOffset, record.textSize);
+    lexeme.position.offset  = record.offset;
+    lexeme.position.line    = record.line;
+    lexeme.position.column  = record.column;
+    lexeme.category         = Lexeme::Category(record.category);
+}
+
+//******************************************************************************
+
+LexemeCache::LexemeCache() :
+    mPersistent(false),
+    mHitCount(0),
+    mMissCount(0)
+{}
+
+LexemeCache::LexemeCache(const UCS2String& directory) :
+    mDirectory(directory),
+    mPersistent(true),
+    mHitCount(0),
+    mMissCount(0)
+{
+    // Treat the last path component as a folder, whether or not it has a trailing separator.
+    UCS2String lastFolder = mDirectory.GetFile();
+    if (!lastFolder.empty())
+    {
+        mDirectory.SetFile(UCS2String());
+        mDirectory.AppendFolder(lastFolder);
+    }
+}
+
+LexemeCacheEntryPtr LexemeCache::Get(const StreamPtr& pStream, bool allowNestedBlockComments)
+{
+    UCS2String streamName = pStream->Name();
+
+    auto known = mEntries.find(streamName);
+    if (known != mEntries.end())
+        return known->second;
+
+    LexemeCacheEntryPtr pEntry;
+    mEntries[streamName] = nullptr;
+
+    Path cacheFile;
+    SourceInfo cached;
+    Filesystem::FileStatus status;
+    bool haveStatus = false;
+    if (mPersistent)
+    {
+        cacheFile = GetCacheFileName(streamName);
+        pEntry = Load(cacheFile, streamName, allowNestedBlockComments, cached);
+        haveStatus = Filesystem::GetFileStatus(streamName, status);
+        if ((pEntry != nullptr) && haveStatus && (cached.size == status.size) && (cached.time == status.modificationTime))
+        {
+            // Input file unchanged; no need to even read it.
+            ++mHitCount;
+            mEntries[streamName] = pEntry;
+            return pEntry;
+        }
+    }
+
+    // Slurp in the entire file.
+    POV_OFF_T current = pStream->tellg();
+    std::vector<unsigned char> data;
+    bool readOk = pStream->seekg(0, IStream::seek_end);
+    POV_OFF_T end = pStream->tellg();
+    if (readOk && (end >= 0) && (mPersistent || (end <= POV_PARSER_MAX_COMPILED_FILE_SIZE)))
+    {
+        data.resize(size_t(end));
+        readOk = pStream->seekg(0) && (data.empty() || pStream->read(data.data(), data.size()));
+    }
+    else
+        readOk = false;
+    pStream->clearstate();
+    pStream->seekg(current);
+    if (!readOk)
+        return nullptr;
+
+    if (data.size() > std::numeric_limits<POV_UINT32>::max())
+        return nullptr;
+
+    // Only cache pure ASCII files, so that the lexemes do not depend on the character encoding.
+    for (auto octet : data)
+        if (octet >= 0x80)
+            return nullptr;
+
+    if (!mPersistent)
+    {
+        pEntry = Scan(streamName, data, allowNestedBlockComments);
+        mEntries[streamName] = pEntry;
+        return pEntry;
+    }
+
+    SourceInfo source;
+    source.size = data.size();
+    source.time = (haveStatus ? status.modificationTime : 0);
+    source.hash = HashData(data.data(), data.size());
+
+    if ((pEntry != nullptr) && (cached.size == source.size) && (cached.hash == source.hash))
+    {
+        ++mHitCount;
+        // Content unchanged despite a different modification time; record the new time,
+        // so that the file need not be read next time.
+        if (haveStatus)
+            Save(cacheFile, streamName, source, *pEntry);
+    }
+    else
+    {
+        pEntry = Scan(streamName, data, allowNestedBlockComments);
+        if (pEntry == nullptr)
+            return nullptr;
+        ++mMissCount;
+        Save(cacheFile, streamName, source, *pEntry);
+    }
+
+    mEntries[streamName] = pEntry;
+    return pEntry;
+}
+
+LexemeCacheEntryPtr LexemeCache::Find(const UCS2String& streamName) const
+{
+    auto known = mEntries.find(streamName);
+    if (known != mEntries.end())
+        return known->second;
+    return nullptr;
+}
+
+bool LexemeCache::IsKnown(const UCS2String& streamName) const
+{
+    return (mEntries.find(streamName) != mEntries.end());
+}
+
+void LexemeCache::Invalidate()
+{
+    mEntries.clear();
+}
+
+Path LexemeCache::GetCacheFileName(const UCS2String& streamName) const
+{
+    char fileName[32];
+    std::snprintf(fileName, sizeof(fileName), "%016llx.lxc",
+                  (unsigned long long)HashData(streamName.data(), streamName.size() * sizeof(UCS2)));
+    Path cacheFile(mDirectory);
+    cacheFile.SetFile(fileName);
+    return cacheFile;
+}
+
+LexemeCacheEntryPtr LexemeCache::Load(const Path& cacheFile, const UCS2String& streamName, bool allowNestedBlockComments, SourceInfo& source)
+{
+    std::string sysFileName(UCS2toSysString(cacheFile()));
+    if (!PlatformBase::GetInstance().AllowLocalFileAccess(cacheFile(), POV_File_Data_LexemeCache, false))
+        return nullptr;
+
+    std::shared_ptr<MappedLexemes> pMapped(std::make_shared<MappedLexemes>());
+    try
+    {
+        pMapped->mapping = bip::file_mapping(sysFileName.c_str(), bip::read_only);
+        pMapped->region = bip::mapped_region(pMapped->mapping, bip::read_only);
+    }
+    catch (bip::interprocess_exception&)
+    {
+        // The cache is merely an optimization; just re-scan the file.
+        return nullptr;
+    }
+
+    const char* data = static_cast<const char*>(pMapped->region.get_address());
+    size_t size = pMapped->region.get_size();
+
+    LexemeCacheFileHeader header;
+    if (size < sizeof(header))
+        return nullptr;
+    memcpy(&header, data, sizeof(header));
+    if ((memcmp(header.magic, LEXEME_CACHE_FILE_MAGIC, sizeof(header.magic)) != 0) ||
+        (header.version != LEXEME_CACHE_FILE_VERSION) ||
+        (header.byteOrder != LEXEME_CACHE_FILE_BYTE_ORDER) ||
+        (header.recordSize != sizeof(LexemeCacheEntry::Record)) ||
+        (header.nameLength != streamName.size()) ||
+        (((header.flags & kLexemeCacheFlag_NestedBlockComments) != 0) != allowNestedBlockComments))
+        return nullptr;
+
+    size_t nameOffset   = sizeof(header);
+    size_t recordOffset = nameOffset + PaddedNameSize(header.nameLength);
+    size_t textOffset   = recordOffset + POV_UINT64(header.recordCount) * sizeof(LexemeCacheEntry::Record);
+    if (POV_UINT64(textOffset) + header.textSize != size)
+        return nullptr;
+
+    if ((header.nameLength != 0) && (memcmp(data + nameOffset, streamName.data(), header.nameLength * sizeof(UCS2)) != 0))
+        return nullptr;
+
+    std::shared_ptr<LexemeCacheEntry> pEntry(std::make_shared<LexemeCacheEntry>());
+    pEntry->records     = reinterpret_cast<const LexemeCacheEntry::Record*>(data + recordOffset);
+    pEntry->recordCount = header.recordCount;
+    pEntry->text        = data + textOffset;
+    pEntry->textSize    = header.textSize;
+
+    for (size_t i = 0; i < pEntry->recordCount; ++i)
+    {
+        const LexemeCacheEntry::Record& record = pEntry->records[i];
+        if ((POV_UINT64(record.textOffset) + record.textSize > header.textSize) || (record.category > Lexeme::kUTF8SignatureBOM))
+            return nullptr;
+    }
+
+    pEntry->endOfStream.offset      = header.endOffset;
+    pEntry->endOfStream.line        = header.endLine;
+    pEntry->endOfStream.column      = header.endColumn;
+    pEntry->endOfLineOffset         = header.endOfLineOffset;
+    pEntry->nominalEndOfLine        = header.nominalEndOfLine;
+    pEntry->allowNestedBlockComments = allowNestedBlockComments;
+    pEntry->pStorage                = pMapped;
+
+    source.size = header.sourceSize;
+    source.time = header.sourceTime;
+    source.hash = header.sourceHash;
+    return pEntry;
+}
+
+LexemeCacheEntryPtr LexemeCache::Scan(const UCS2String& streamName, const std::vector<unsigned char>& data, bool allowNestedBlockComments)
+{
+    std::shared_ptr<ScannedLexemes> pScanned(std::make_shared<ScannedLexemes>());
+
+    // The scanner carries a sizeable buffer, so keep it off the stack.
+    std::unique_ptr<Scanner> pScanner(new Scanner);
+    pScanner->SetNestedBlockComments(allowNestedBlockComments);
+    pScanner->SetInputStream(std::make_shared<IMemStream>(data.data(), data.size(), streamName));
+
+    try
+    {
+        Lexeme lexeme;
+        while (pScanner->GetNextLexeme(lexeme))
+        {
+            if ((pScanned->text.size() + lexeme.text.size() > std::numeric_limits<POV_UINT32>::max()) ||
+                (lexeme.text.size() >= (0x01u << 24)))
+                return nullptr;
+            LexemeCacheEntry::Record record;
+            record.offset       = lexeme.position.offset;
+            record.line         = lexeme.position.line;
+            record.column       = lexeme.position.column;
+            record.endOffset    = pScanner->mCurrentPosition.offset;
+            record.endLine      = pScanner->mCurrentPosition.line;
+            record.endColumn    = pScanner->mCurrentPosition.column;
+            record.textOffset   = POV_UINT32(pScanned->text.size());
+            record.textSize     = POV_UINT32(lexeme.text.size());
+            record.category     = lexeme.category;
+            pScanned->records.push_back(record);
+            pScanned->text += lexeme.text;
+        }
+    }
+    catch (TokenizerException&)
+    {
+        // Leave it to the actual parse to report the error.
+        return nullptr;
+    }
+
+    std::shared_ptr<LexemeCacheEntry> pEntry(std::make_shared<LexemeCacheEntry>());
+    pEntry->records     = pScanned->records.data();
+    pEntry->recordCount = pScanned->records.size();
+    pEntry->text        = pScanned->text.data();
+    pEntry->textSize    = pScanned->text.size();
+    pEntry->pStorage    = pScanned;
+
+    pEntry->endOfStream = pScanner->mCurrentPosition;
+    pEntry->endOfLineOffset = -1;
+    pEntry->nominalEndOfLine = '\0';
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        if ((data[i] == 0x0A) || (data[i] == 0x0D))
+        {
+            pEntry->endOfLineOffset = i;
+            pEntry->nominalEndOfLine = data[i];
+            break;
+        }
+    }
+    pEntry->allowNestedBlockComments = allowNestedBlockComments;
+    return pEntry;
+}
+
+void LexemeCache::Save(const Path& cacheFile, const UCS2String& streamName, const SourceInfo& source, const LexemeCacheEntry& entry)
+{
+    LexemeCacheFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LEXEME_CACHE_FILE_MAGIC, sizeof(header.magic));
+    header.version          = LEXEME_CACHE_FILE_VERSION;
+    header.byteOrder        = LEXEME_CACHE_FILE_BYTE_ORDER;
+    header.recordSize       = sizeof(LexemeCacheEntry::Record);
+    header.flags            = (entry.allowNestedBlockComments ? kLexemeCacheFlag_NestedBlockComments : 0);
+    header.sourceSize       = source.size;
+    header.sourceTime       = source.time;
+    header.sourceHash       = source.hash;
+    header.nameLength       = POV_UINT32(streamName.size());
+    header.recordCount      = POV_UINT32(entry.recordCount);
+    header.textSize         = POV_UINT32(entry.textSize);
+    header.nominalEndOfLine = entry.nominalEndOfLine;
+    header.endOfLineOffset  = entry.endOfLineOffset;
+    header.endOffset        = entry.endOfStream.offset;
+    header.endLine          = entry.endOfStream.line;
+    header.endColumn        = entry.endOfStream.column;
+
+    static const char padding[8] = {};
+    size_t nameSize = streamName.size() * sizeof(UCS2);
+
+    // Write to a temporary file first, and replace the cache file only once complete,
+    // so that concurrent renders never see (or map) an incomplete cache file.
+    // NB: The content of a cache file depends only on its key, so it does not matter
+    // which of several concurrent renders gets to replace it last.
+    Filesystem::TemporaryFile tempFile(Filesystem::TemporaryFile::SuggestNameFor(cacheFile()));
+    try
+    {
+        bool ok;
+        {
+            std::unique_ptr<OStream> fd(NewOStream(tempFile.GetFileName(), POV_File_Data_LexemeCache, false));
+            if ((fd == nullptr) || !*fd)
+                return;
+            ok = fd->write(&header, sizeof(header)) &&
+                 fd->write(streamName.data(), nameSize) &&
+                 fd->write(padding, PaddedNameSize(streamName.size()) - nameSize) &&
+                 fd->write(entry.records, entry.recordCount * sizeof(LexemeCacheEntry::Record)) &&
+                 fd->write(entry.text, entry.textSize);
+        }   // close the file before renaming it
+        if (ok && Filesystem::RenameFile(tempFile.GetFileName(), cacheFile()))
+            tempFile.Keep();
+    }
+    catch (pov_base::Exception&)
+    {
+        // The cache is merely an optimization; failing to write it is no reason to fail the parse.
+    }
+}
+
+}
+// end of namespace pov_parser
@@ -0,0 +1,200 @@
+//******************************************************************************
+///
+/// @file parser/lexemecache.h
+///
+/// Declarations for the persistent lexeme cache of the parser.
+///
+/// @copyright
+/// @parblock
+///
+/// Persistence of Vision Ray Tracer ('POV-Ray') version 3.8.
+/// Copyright 1991-2019 Persistence of Vision Raytracer Pty. Ltd.
+///
+/// POV-Ray is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU Affero General Public License as
+/// published by the Free Software Foundation, either version 3 of the
+/// License, or (at your option) any later version.
+///
+/// POV-Ray is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU Affero General Public License for more details.
+///
+/// You should have received a copy of the GNU Affero General Public License
+/// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+///
+/// ----------------------------------------------------------------------------
+///
+/// POV-Ray is based on the popular DKB raytracer version 2.12.
+/// DKBTrace was originally written by David K. Buck.
+/// DKBTrace Ver 2.0-2.12 were written by David K. Buck & Aaron A. Collins.
+///
+/// @endparblock
+///
+//******************************************************************************
+
+#ifndef POVRAY_PARSER_LEXEMECACHE_H
+#define POVRAY_PARSER_LEXEMECACHE_H
+
+// Module config header file must be the first file included within POV-Ray unit header files
+#include "parser/configparser.h"
+
+// C++ variants of C standard header files
+//  (none at the moment)
+
+// C++ standard header files
+#include <map>
+#include <memory>
+#include <vector>
+
+// POV-Ray header files (base module)
+#include "base/path.h"
+#include "base/stringtypes.h"
+
+// POV-Ray header files (core module)
+//  (none at the moment)
+
+// POV-Ray header files (parser module)
+#include "parser/parsertypes.h"
+#include "parser/scanner.h"
+
+namespace pov_parser
+{
+
+using namespace pov_base;
+
+//******************************************************************************
+
+/// Lexemes of an entire input stream, as produced by the @ref Scanner.
+///
+/// Entries are only created for streams that consist entirely of ASCII
+/// characters, are smaller than 4 GiB, and can be scanned from start to end
+/// without error, so that the lexemes do not depend on the character encoding
+/// setting, and skipping to the next `#` lexeme is equivalent to
+/// @ref Scanner::GetNextDirective().
+///
+struct LexemeCacheEntry final
+{
+    /// Lexeme as stored in memory and in the cache file.
+    struct Record final
+    {
+        POV_UINT32  offset;             ///< Binary offset of the lexeme.
+        POV_UINT32  line;               ///< Line number of the lexeme.
+        POV_UINT32  column;             ///< Column of the lexeme.
+        POV_UINT32  endOffset;          ///< Binary offset immediately after the lexeme.
+        POV_UINT32  endLine;            ///< Line number immediately after the lexeme.
+        POV_UINT32  endColumn;          ///< Column immediately after the lexeme.
+        POV_UINT32  textOffset;         ///< Start of the lexeme's text in @ref LexemeCacheEntry::text.
+        POV_UINT32  textSize : 24;      ///< Length of the lexeme's text.
+        POV_UINT32  category : 8;       ///< @ref Lexeme::Category of the lexeme.
+    };
+
+    const Record*       records;                    ///< Lexemes in stream order.
+    size_t              recordCount;                ///< Number of lexemes.
+    const char*         text;                       ///< Concatenated text of all lexemes.
+    size_t              textSize;                   ///< Size of the concatenated text.
+    LexemePosition      endOfStream;                ///< Position reported after the last lexeme.
+    POV_OFF_T           endOfLineOffset;            ///< Offset of the first end-of-line character, or -1 if none.
+    Scanner::Character  nominalEndOfLine;           ///< Nominal end-of-line character of the stream.
+    bool                allowNestedBlockComments;   ///< Nested block comment setting the stream was scanned with.
+    std::shared_ptr<const void> pStorage;           ///< Memory (or memory-mapped cache file) holding the lexemes.
+
+    /// Find the first lexeme starting at or after a given binary offset.
+    /// @return Index of the lexeme, or the number of lexemes if there is none.
+    size_t Find(POV_OFF_T offset) const;
+
+    /// Nominal end-of-line character in effect at a given binary offset.
+    Scanner::Character NominalEndOfLineAt(POV_OFF_T offset) const;
+
+    /// Get a copy of a lexeme.
+    void GetLexeme(size_t index, Lexeme& lexeme) const;
+};
+
+//******************************************************************************
+
+/// Persistent on-disk cache of pre-scanned include files.
+///
+/// This class maintains a directory of cache files, each holding the lexemes of
+/// a single input file. Cache files are keyed by the input file's name, and
+/// validated against its size and modification time, so that modified files
+/// are transparently re-scanned and their cache file replaced; only if the
+/// modification time differs is the input file read, and its content compared
+/// against the cache file by hash. Cache files are memory-mapped rather than
+/// read, and replaced atomically, so that concurrent renders may share them.
+///
+/// Once an input file has been looked up, the result is retained for the
+/// remainder of the parse, so that re-opening the same file (e.g. to invoke a
+/// macro) does not require it to be validated again.
+///
+/// A cache constructed without a directory is held in memory only; it is used
+/// to pre-scan input files containing loops or macros, so that their bodies
+/// can be replayed without re-scanning the text on each iteration or invocation.
+///
+class LexemeCache final
+{
+public:
+
+    /// Construct an in-memory cache.
+    LexemeCache();
+
+    /// Construct a cache using the given directory.
+    LexemeCache(const UCS2String& directory);
+
+    /// Whether the cache is backed by a directory.
+    bool IsPersistent() const { return mPersistent; }
+
+    /// Get the lexemes of an input stream.
+    ///
+    /// If no valid cache file exists for the stream, the stream is scanned and
+    /// a new cache file is written.
+    ///
+    /// @post
+    ///     The stream position is unchanged.
+    ///
+    /// @return The lexemes, or `nullptr` if the stream cannot be cached.
+    ///
+    LexemeCacheEntryPtr Get(const StreamPtr& pStream, bool allowNestedBlockComments);
+
+    /// Get the lexemes of a stream previously looked up via @ref Get().
+    /// @return The lexemes, or `nullptr` if the stream is unknown or cannot be cached.
+    LexemeCacheEntryPtr Find(const UCS2String& streamName) const;
+
+    /// Whether a stream has previously been looked up via @ref Get().
+    bool IsKnown(const UCS2String& streamName) const;
+
+    /// Forget all streams looked up so far.
+    /// This must be called whenever a file may have been modified during the parse.
+    void Invalidate();
+
+    /// Number of input files served from the cache.
+    unsigned int GetHitCount() const { return mHitCount; }
+
+    /// Number of input files that had to be scanned and stored.
+    unsigned int GetMissCount() const { return mMissCount; }
+
+private:
+
+    Path                                        mDirectory;
+    bool                                        mPersistent;
+    std::map<UCS2String, LexemeCacheEntryPtr>   mEntries;
+    unsigned int                                mHitCount;
+    unsigned int                                mMissCount;
+
+    /// Identification of the input file a cache file was created from.
+    struct SourceInfo final
+    {
+        POV_UINT64  size;   ///< Size of the input file.
+        POV_INT64   time;   ///< Modification time of the input file, or 0 if unknown.
+        POV_UINT64  hash;   ///< Hash of the input file's content.
+    };
+
+    Path GetCacheFileName(const UCS2String& streamName) const;
+    LexemeCacheEntryPtr Load(const Path& cacheFile, const UCS2String& streamName, bool allowNestedBlockComments, SourceInfo& source);
+    LexemeCacheEntryPtr Scan(const UCS2String& streamName, const std::vector<unsigned char>& data, bool allowNestedBlockComments);
+    void Save(const Path& cacheFile, const UCS2String& streamName, const SourceInfo& source, const LexemeCacheEntry& entry);
+};
+
+}
+// end of namespace pov_parser
+
+#endif // POVRAY_PARSER_LEXEMECACHE_H
@@ -46,6 +46,7 @@
 
 // C++ standard header files
 #include <algorithm>
+#include <thread>
 
 // POV-Ray header files (base module)
 #include "base/fileinputoutput.h"
@@ -108,6 +109,7 @@
 #include "core/shape/truetype.h"
 #include "core/support/imageutil.h"
 #include "core/support/octree.h"
+#include "core/support/scenearena.h"
 
 // POV-Ray header files (VM module)
 #include "vm/fnpovfpu.h"
@@ -151,6 +153,8 @@ Parser::Parser(shared_ptr<SceneData> sd, const Options& opts,
     Debug_Message_Buffer(mf),
     mpFunctionVM(new FunctionVM),
     fnVMContext(new FPUContext(mpFunctionVM.get(), GetParserDataPtr())),
+    recordObjectSources(opts.recordObjectSources),
+    workThreads(opts.workThreads),
     Destroying_Frame(false),
     mTokenCount(0),
     mTokensSinceLastProgressReport(0),
@@ -169,6 +173,10 @@ Parser::Parser(shared_ptr<SceneData> sd, const Options& opts,
     mY2K = std::chrono::system_clock::from_time_t(std::mktime(&tmY2K));
 
     pre_init_tokenizer();
+    if (!opts.includeCachePath.empty())
+        mpLexemeCache.reset(new LexemeCache(opts.includeCachePath));
+    else
+        mpLexemeCache.reset(new LexemeCache());
     if (sceneData->realTimeRaytracing)
         mBetaFeatureFlags.realTimeRaytracing = true;
 
@@ -184,6 +192,9 @@ Parser::~Parser()
 /* Parse the file. */
 void Parser::Run()
 {
+    // place the scene data in the scene's arena as we parse it
+    SceneArena::Scope arenaScope(sceneData->arena.get());
+
     SourceInfo errorInfo(UCS2String(POV_FILENAME_BUFFER_CHARS, u'\0'), // Pre-claim some memory, so we can handle an out-of-memory error.
                          SourcePosition(-1,-1,-1));
 
@@ -241,6 +252,9 @@ void Parser::Run()
 
             Parse_Frame();
 
+            // any images not needed during parsing may still be loading
+            Wait_For_Image_Loads();
+
             // post process atmospheric media
             for (vector<Media>::iterator i(sceneData->atmosphere.begin()); i != sceneData->atmosphere.end(); i++)
                 i->PostProcess();
@@ -510,8 +524,30 @@ void Parser::Run()
 void Parser::Cleanup()
 {
     // TODO FIXME - cleanup [trf]
+    sceneData->symbolLookups = mSymbolStack.GetStatistics()->lookups;
+    sceneData->symbolProbes = mSymbolStack.GetStatistics()->probes;
+    if (mSymbolStack.GetLocalTableIndex() >= mSymbolStack.GetGlobalTableIndex())
+    {
+        sceneData->globalSymbols = mSymbolStack.GetGlobalTable()->GetSymbolCount();
+        sceneData->globalSymbolSlots = mSymbolStack.GetGlobalTable()->GetCapacity();
+    }
     Terminate_Tokenizer();
 
+    if (mpLexemeCache->IsPersistent())
+    {
+        sceneData->includeCacheHits = mpLexemeCache->GetHitCount();
+        sceneData->includeCacheMisses = mpLexemeCache->GetMissCount();
+    }
+
+    // abandon images still loading after a parse error
+    for (auto image : mPendingImages)
+    {
+        image->pendingLoad = nullptr;
+        Destroy_Image(image);
+    }
+    mPendingImages.clear();
+    mpImageLoader.reset();
+
     Destroy_Textures(Default_Texture);
     Default_Texture = nullptr;
 
@@ -661,6 +697,7 @@ void Parser::Destroy_Frame()
     {
         Destroy_Object(sceneData->objects);
         sceneData->objects.clear();
+        sceneData->objectSources.clear();
         sceneData->lightSources.clear();
     }
 
@@ -2377,6 +2414,7 @@ ObjectPtr Parser::Parse_HField ()
     Object = new HField();
 
     image = Parse_Image (HF_FILE);
+    image->WaitForData();
     image->Use = USE_NONE;
 
     Object->bounding_corner1 = Vector3d(0.0, 0.0, 0.0);
@@ -6682,11 +6720,24 @@ void Parser::Parse_Frame ()
 
         OTHERWISE
             UNGET
-            Object = Parse_Object();
-            if (Object == nullptr)
-                Expectation_Error ("object or directive");
-            Post_Process (Object, nullptr);
-            Link_To_Frame (Object);
+            {
+                // remember where the object was defined, for object profiling
+                ObjectSource source;
+                if (recordObjectSources)
+                    Record_Object_Source(source);
+                size_t firstObject = sceneData->objects.size();
+
+                Object = Parse_Object();
+                if (Object == nullptr)
+                    Expectation_Error ("object or directive");
+                Post_Process (Object, nullptr);
+                Link_To_Frame (Object);
+
+                // a union may have been split up into its children
+                if (recordObjectSources)
+                    for (size_t i = firstObject; i < sceneData->objects.size(); i++)
+                        sceneData->objectSources[sceneData->objects[i]] = source;
+            }
         END_CASE
     END_EXPECT
 }
@@ -8204,6 +8255,14 @@ void Parser::Parse_Declare(bool is_local, bool after_hash)
         lvalue.numberPtr = numberPtr;
         lvalue.dataPtr = dataPtr;
         lvalue.symEntry = Temp_Entry;
+        if ((dataPtr != nullptr) && (dataPtr == mToken.DataPtr) && (mToken.array != nullptr))
+        {
+            // Array elements may be stored densely, so we assign them via a stand-in.
+            lvalue.array = mToken.array;
+            lvalue.arrayIndex = mToken.arrayIndex;
+        }
+        else
+            lvalue.array = nullptr;
         lvalue.previous = Previous;
         lvalue.allowRedefine = allow_redefine;
         lvalue.optional = optional;
@@ -8232,6 +8291,17 @@ void Parser::Parse_Declare(bool is_local, bool after_hash)
 
     LValue_Ok = false;
 
+    for (vector<LValue>::iterator i = lvalues.begin(); i != lvalues.end(); ++i)
+    {
+        if (i->array != nullptr)
+        {
+            i->elementType = i->array->ElementType(i->arrayIndex);
+            i->elementData = nullptr;
+            i->numberPtr = &(i->elementType);
+            i->dataPtr = &(i->elementData);
+        }
+    }
+
     GET (EQUALS_TOKEN)
     SetOkToDeclare(true);
 
@@ -8253,6 +8323,7 @@ void Parser::Parse_Declare(bool is_local, bool after_hash)
             Test_Redefine(Previous, numberPtr, *dataPtr, allow_redefine);
             *dataPtr = reinterpret_cast<void *>(Create_Float());
             *(reinterpret_cast<DBL *>(*dataPtr)) = expr[i];
+            Commit_LValue(lvalues[i]);
         }
     }
     else if (larrayDeclare)
@@ -8266,7 +8337,7 @@ void Parser::Parse_Declare(bool is_local, bool after_hash)
             Error ("cannot bulk-assign from multi-dimensional array");
         if (lvalues.size() > a->Sizes[0])
             Error ("array size mismatch");
-        if (a->DataPtrs.empty())
+        if (!a->IsInitialized())
             Error ("cannot assign from uninitialized array");
 
         for (int i = 0; i < lvalues.size(); ++i)
@@ -8282,7 +8353,8 @@ void Parser::Parse_Declare(bool is_local, bool after_hash)
 
             *numberPtr = a->ElementType(i);
             Test_Redefine(Previous, numberPtr, *dataPtr, allow_redefine);
-            *dataPtr = SymbolTable::Copy_Identifier(a->DataPtrs[i], a->ElementType(i));
+            *dataPtr = SymbolTable::Copy_Identifier(a->ElementData(i), a->ElementType(i));
+            Commit_LValue(lvalues[i]);
         }
 
         SymbolTable::Destroy_Entry (rvalue);
@@ -8338,6 +8410,7 @@ void Parser::Parse_Declare(bool is_local, bool after_hash)
                     END_CASE
                 END_EXPECT
             }
+            Commit_LValue(lvalues[i]);
         }
         if (tupleDeclare)
         {
@@ -8362,6 +8435,15 @@ void Parser::Parse_Declare(bool is_local, bool after_hash)
     }
 }
 
+void Parser::Commit_LValue(LValue& lvalue)
+{
+    if ((lvalue.array == nullptr) || (lvalue.elementData == nullptr))
+        return;
+
+    lvalue.array->SetElement(lvalue.arrayIndex, lvalue.elementType, lvalue.elementData);
+    lvalue.elementData = nullptr;
+}
+
 bool Parser::PassParameterByReference (int callingContext)
 {
     if (mToken.is_dictionary_elem)
@@ -8417,6 +8499,8 @@ bool Parser::Parse_RValue (TokenId Previous, TokenId *NumberPtr, void **DataPtr,
                 New_Par            = reinterpret_cast<POV_PARAM *>(POV_MALLOC(sizeof(POV_PARAM),"parameter"));
                 New_Par->NumberPtr = mToken.NumberPtr;
                 New_Par->DataPtr   = mToken.DataPtr;
+                New_Par->Array     = mToken.array;
+                New_Par->Index     = mToken.arrayIndex;
                 *NumberPtr = PARAMETER_ID_TOKEN;
                 *DataPtr   = reinterpret_cast<void *>(New_Par);
             }
@@ -8554,6 +8638,8 @@ bool Parser::Parse_RValue (TokenId Previous, TokenId *NumberPtr, void **DataPtr,
                     New_Par            = reinterpret_cast<POV_PARAM *>(POV_MALLOC(sizeof(POV_PARAM),"parameter"));
                     New_Par->NumberPtr = mToken.NumberPtr;
                     New_Par->DataPtr   = mToken.DataPtr;
+                    New_Par->Array     = mToken.array;
+                    New_Par->Index     = mToken.arrayIndex;
 
                     *NumberPtr = PARAMETER_ID_TOKEN;
                     *DataPtr   = reinterpret_cast<void *>(New_Par);
@@ -9297,6 +9383,33 @@ void Parser::Post_Process (ObjectPtr Object, ObjectPtr Parent)
         Set_Flag(Object, OPAQUE_FLAG);
 }
 
+//******************************************************************************
+
+void Parser::Record_Object_Source(ObjectSource& source)
+{
+    UCS2String fileName(CurrentFileName());
+    vector<UCS2String>& files = sceneData->objectSourceFiles;
+
+    // objects tend to come in runs from the same file, so search backwards
+    source.file = files.size();
+    for (size_t i = files.size(); i-- > 0; )
+    {
+        if (files[i] == fileName)
+        {
+            source.file = i;
+            break;
+        }
+    }
+    if (source.file == files.size())
+        files.push_back(fileName);
+
+    source.keyword = mToken.raw.lexeme.text;
+    source.line    = CurrentFilePosition().line;
+    source.column  = CurrentFilePosition().column;
+}
+
+//******************************************************************************
+
 /*****************************************************************************
 *
 * FUNCTION
@@ -9971,11 +10084,11 @@ OStream *Parser::CreateFile(const UCS2String& filename, unsigned int stype, bool
 
 //******************************************************************************
 
-Image *Parser::Read_Image(int filetype, const UCS2 *filename, const ImageReadOptions& options)
+void Parser::Load_Image(ImageData *image, int filetype, const UCS2 *filename, const ImageReadOptions& options, const char *name)
 {
     unsigned int stype;
     Image::ImageFileType type;
-    UCS2String ign;
+    UCS2String foundFile;
 
     switch(filetype)
     {
@@ -10035,12 +10148,63 @@ Image *Parser::Read_Image(int filetype, const UCS2 *filename, const ImageReadOpt
             throw POV_EXCEPTION(kDataTypeErr, "Unknown file type.");
     }
 
-    shared_ptr<IStream> file = Locate_File(filename, stype, ign, true);
+    shared_ptr<IStream> file = Locate_File(filename, stype, foundFile, true);
 
     if (file == nullptr)
         throw POV_EXCEPTION(kCannotOpenFileErr, "Cannot find image file.");
 
-    return Image::Read(type, file.get(), options);
+    if (mpImageLoader == nullptr)
+        mpImageLoader.reset(new ImageLoader((workThreads != 0) ? workThreads : std::thread::hardware_concurrency()));
+
+    ImageLoader::PendingResult pending = mpImageLoader->Load(foundFile, type, file, options);
+    std::string fileName(name);
+    image->pendingLoad = [this, pending, fileName](ImageData& loaded) { Complete_Image_Load(loaded, pending, fileName); };
+    mPendingImages.push_back(Copy_Image(image));
+}
+
+void Parser::Complete_Image_Load(ImageData& image, const ImageLoader::PendingResult& pending, const std::string& name)
+{
+    const ImageLoader::Result& result = pending.get();
+
+    for (auto& warning : result.warnings)
+        Warning("%s: %s", name.c_str(), warning.c_str());
+
+    if (result.image == nullptr)
+        Error("Cannot read image file '%s': %s", name.c_str(), result.error.c_str());
+
+    image.data = result.image;
+    image.iwidth = image.data->GetWidth();
+    image.iheight = image.data->GetHeight();
+    image.width = (SNGL) image.iwidth;
+    image.height = (SNGL) image.iheight;
+}
+
+void Parser::Wait_For_Image_Loads()
+{
+    for (auto image : mPendingImages)
+        image->WaitForData();
+
+    for (auto image : mPendingImages)
+        Destroy_Image(image);
+    mPendingImages.clear();
+}
+
+void Parser::Wait_For_Image_Loads(const PIGMENT *pigment)
+{
+    if (pigment == nullptr)
+        return;
+
+    if (const ImagePatternImpl *pattern = dynamic_cast<const ImagePatternImpl*>(pigment->pattern.get()))
+    {
+        if (pattern->pImage != nullptr)
+            pattern->pImage->WaitForData();
+    }
+    else if (const PigmentPattern *pattern = dynamic_cast<const PigmentPattern*>(pigment->pattern.get()))
+        Wait_For_Image_Loads(pattern->pPigment);
+
+    if (const PigmentBlendMap *map = dynamic_cast<const PigmentBlendMap*>(pigment->Blend_Map.get()))
+        for (const auto& entry : map->Blend_Map_Entries)
+            Wait_For_Image_Loads(entry.Vals);
 }
 
 //******************************************************************************
@@ -10054,38 +10218,200 @@ RGBFTColour *Parser::Create_Colour ()
 
 bool Parser::POV_ARRAY::IsInitialized() const
 {
-    POV_PARSER_ASSERT(resizable || !DataPtrs.empty());
-    return !DataPtrs.empty();
+    POV_PARSER_ASSERT(resizable || (GetLinearSize() > 0));
+    return (GetLinearSize() > 0);
 }
 
 bool Parser::POV_ARRAY::HasElement(size_t i) const
 {
+    if (dense)
+        return ((i < DenseSet.size()) && DenseSet[i]);
     return ((i < DataPtrs.size()) && (DataPtrs[i] != nullptr));
 }
 
 const TokenId& Parser::POV_ARRAY::ElementType(size_t i) const
 {
-    POV_PARSER_ASSERT(resizable || (i < DataPtrs.size()));
+    POV_PARSER_ASSERT(resizable || (i < (dense ? DenseSet.size() : DataPtrs.size())));
     return (mixedType ? Types[i] : Type_);
 }
 
 TokenId& Parser::POV_ARRAY::ElementType(size_t i)
 {
-    POV_PARSER_ASSERT(resizable || (i < DataPtrs.size()));
+    POV_PARSER_ASSERT(resizable || (i < (dense ? DenseSet.size() : DataPtrs.size())));
     return (mixedType ? Types[i] : Type_);
 }
 
 size_t Parser::POV_ARRAY::GetLinearSize() const
 {
-    POV_PARSER_ASSERT(!resizable || ((maxDim == 0) && (Sizes[0] == DataPtrs.size())));
-    POV_PARSER_ASSERT(!mixedType || (Types.size() == DataPtrs.size()));
-    return DataPtrs.size();
+    size_t size = (dense ? DenseSet.size() : DataPtrs.size());
+    POV_PARSER_ASSERT(!resizable || ((maxDim == 0) && (size_t(Sizes[0]) == size)));
+    POV_PARSER_ASSERT(!mixedType || (Types.size() == size));
+    POV_PARSER_ASSERT(!dense || !mixedType);
+    return size;
+}
+
+void* Parser::POV_ARRAY::ElementData(size_t i)
+{
+    if (!dense)
+        return DataPtrs[i];
+
+    if (!DenseSet[i])
+        return nullptr;
+
+    switch (Type_)
+    {
+        case FLOAT_ID_TOKEN:    return &DenseFloats[i];
+        case VECTOR_ID_TOKEN:   return &DenseVectors[i];
+        case COLOUR_ID_TOKEN:   return &DenseColours[i];
+        default:                POV_PARSER_PANIC(); return nullptr;
+    }
+}
+
+void** Parser::POV_ARRAY::ElementSlot(size_t i)
+{
+    if (!dense)
+        return &DataPtrs[i];
+
+    CheckDenseAccess();
+    DenseAccess = ElementData(i);
+    DenseAccessIndex = i;
+    return &DenseAccess;
+}
+
+void Parser::POV_ARRAY::SetElement(size_t i, TokenId type, void* data)
+{
+    POV_PARSER_ASSERT(i < GetLinearSize());
+
+    if (dense)
+    {
+        CheckDenseAccess();
+        if (type == Type_)
+        {
+            switch (Type_)
+            {
+                case FLOAT_ID_TOKEN:    DenseFloats[i]  = *reinterpret_cast<DBL*>(data);          break;
+                case VECTOR_ID_TOKEN:   DenseVectors[i] = *reinterpret_cast<Vector3d*>(data);     break;
+                case COLOUR_ID_TOKEN:   DenseColours[i] = *reinterpret_cast<RGBFTColour*>(data);  break;
+                default:                POV_PARSER_PANIC();                                         break;
+            }
+            DenseSet[i] = true;
+            SymbolTable::Destroy_Ident_Data(data, type);
+            return;
+        }
+
+        // The element type is changed behind the array's back (e.g. via a macro parameter passed
+        // by reference), which dense storage cannot represent.
+        MakeSparse();
+    }
+
+    if (!mixedType && (Type_ != type) && (Type_ != EMPTY_ARRAY_TOKEN))
+    {
+        // Other elements are still of the old type, so from now on each element needs to
+        // carry its own type.
+        Types.resize(DataPtrs.size());
+        for (size_t j = 0; j < DataPtrs.size(); ++j)
+            Types[j] = ((DataPtrs[j] != nullptr) ? Type_ : IDENTIFIER_TOKEN);
+        mixedType = true;
+    }
+
+    TokenId& elementType = ElementType(i);
+    SymbolTable::Destroy_Ident_Data(DataPtrs[i], elementType);
+    DataPtrs[i] = data;
+    elementType = type;
+
+    MakeDense();
+}
+
+void Parser::POV_ARRAY::RemoveElement(size_t i)
+{
+    POV_PARSER_ASSERT(i < GetLinearSize());
+
+    if (dense)
+    {
+        CheckDenseAccess();
+        DenseSet[i] = false;
+        if (DenseAccessIndex == i)
+            DenseAccess = nullptr;
+        return;
+    }
+
+    SymbolTable::Destroy_Ident_Data(DataPtrs[i], ElementType(i));
+    DataPtrs[i] = nullptr;
+    if (mixedType)
+        Types[i] = IDENTIFIER_TOKEN;
+}
+
+void Parser::POV_ARRAY::MakeDense()
+{
+    if (dense || sparseOnly || mixedType)
+        return;
+
+    if ((Type_ != FLOAT_ID_TOKEN) && (Type_ != VECTOR_ID_TOKEN) && (Type_ != COLOUR_ID_TOKEN))
+        return;
+
+    std::vector<void*> elements;
+    elements.swap(DataPtrs);
+
+    dense = true;
+    ResizeDense(elements.size());
+    for (size_t i = 0; i < elements.size(); ++i)
+    {
+        if (elements[i] != nullptr)
+            SetElement(i, Type_, elements[i]);
+    }
+}
+
+void Parser::POV_ARRAY::MakeSparse()
+{
+    if (!dense)
+        return;
+
+    CheckDenseAccess();
+    std::vector<void*> elements(DenseSet.size(), nullptr);
+    for (size_t i = 0; i < elements.size(); ++i)
+        elements[i] = SymbolTable::Copy_Identifier(ElementData(i), Type_);
+
+    dense = false;
+    sparseOnly = true;
+    DenseAccess = nullptr;
+    std::vector<DBL>().swap(DenseFloats);
+    std::vector<Vector3d>().swap(DenseVectors);
+    std::vector<RGBFTColour>().swap(DenseColours);
+    std::vector<bool>().swap(DenseSet);
+    DataPtrs.swap(elements);
+}
+
+void Parser::POV_ARRAY::ResizeDense(size_t size)
+{
+    POV_PARSER_ASSERT(dense);
+    CheckDenseAccess();
+    DenseAccess = nullptr; // the elements may be moved
+    switch (Type_)
+    {
+        case FLOAT_ID_TOKEN:    DenseFloats.resize(size);   break;
+        case VECTOR_ID_TOKEN:   DenseVectors.resize(size);  break;
+        case COLOUR_ID_TOKEN:   DenseColours.resize(size);  break;
+        default:                POV_PARSER_PANIC();         break;
+    }
+    DenseSet.resize(size, false);
+}
+
+void Parser::POV_ARRAY::CheckDenseAccess()
+{
+    // The slot is shared by all elements, and must only be read from; to replace an element,
+    // SetElement() must be used instead.
+    POV_PARSER_ASSERT((DenseAccess == nullptr) || (dense && (DenseAccess == ElementData(DenseAccessIndex))));
 }
 
 void Parser::POV_ARRAY::Grow()
 {
     POV_PARSER_ASSERT(resizable && (maxDim == 0));
     ++Sizes[0];
+    if (dense)
+    {
+        ResizeDense(Sizes[0]);
+        return;
+    }
     DataPtrs.push_back(nullptr);
     POV_PARSER_ASSERT(DataPtrs.size() == Sizes[0]);
     if (mixedType)
@@ -10099,6 +10425,11 @@ void Parser::POV_ARRAY::GrowBy(size_t delta)
 {
     POV_PARSER_ASSERT(resizable && (maxDim == 0));
     Sizes[0] += delta;
+    if (dense)
+    {
+        ResizeDense(Sizes[0]);
+        return;
+    }
     DataPtrs.insert(DataPtrs.end(), delta, nullptr);
     if (mixedType)
     {
@@ -10119,6 +10450,12 @@ void Parser::POV_ARRAY::Shrink()
     POV_PARSER_ASSERT(resizable && (maxDim == 0));
     POV_PARSER_ASSERT(Sizes[0] > 0);
     --Sizes[0];
+    if (dense)
+    {
+        POV_PARSER_ASSERT(!DenseSet.back());
+        ResizeDense(Sizes[0]);
+        return;
+    }
     POV_PARSER_ASSERT(DataPtrs.back() == nullptr);
     DataPtrs.pop_back();
     POV_PARSER_ASSERT(DataPtrs.size() == Sizes[0]);
@@ -10130,12 +10467,20 @@ void Parser::POV_ARRAY::Shrink()
     }
 }
 
-Parser::POV_ARRAY::POV_ARRAY(const POV_ARRAY& obj)
+Parser::POV_ARRAY::POV_ARRAY(const POV_ARRAY& obj) :
+    DenseFloats(obj.DenseFloats),
+    DenseVectors(obj.DenseVectors),
+    DenseColours(obj.DenseColours),
+    DenseSet(obj.DenseSet),
+    DenseAccess(nullptr),
+    DenseAccessIndex(0)
 {
     maxDim = obj.maxDim;
     Type_ = obj.Type_;
     resizable = obj.resizable;
     mixedType = obj.mixedType;
+    dense = obj.dense;
+    sparseOnly = obj.sparseOnly;
     for (int i = 0; i < POV_ARRAY::kMaxDimensions; ++i)
     {
         Sizes[i] = obj.Sizes[i];
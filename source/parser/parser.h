@@ -76,6 +76,8 @@
 
 // POV-Ray header files (parser module)
 #include "parser/fncode.h"
+#include "parser/imageloader.h"
+#include "parser/lexemecache.h"
 #include "parser/parsertypes.h"
 #include "parser/reservedwords.h"
 #include "parser/rawtokenizer.h"
@@ -231,6 +233,8 @@ class Parser final
                 GenericMessenger& mMessenger;
         };
 
+        struct POV_ARRAY;
+
         // tokenize.h/tokenize.cpp
 
         /// Structure holding information about the current token
@@ -244,6 +248,8 @@ class Parser final
             TokenId *NumberPtr;
             void **DataPtr;
             SymbolTable* table;                 ///< Table or dictionary the token references an element of.
+            POV_ARRAY* array;                   ///< Array the token references an element of, if any.
+            size_t arrayIndex;                  ///< Linear index of the array element referenced by the token.
             bool Unget_Token            : 1;    ///< `true` if @ref Get_Token() must re-issue this token as-is.
             bool ungetRaw               : 1;    ///< `true` if @ref Get_Token() must re-evaluate this token from raw.
             bool End_Of_File            : 1;
@@ -277,6 +283,10 @@ class Parser final
             void**       dataPtr;
             TokenId      previous;
             SYM_ENTRY*   symEntry;
+            POV_ARRAY*   array;                 ///< Array the lvalue is an element of, if any.
+            size_t       arrayIndex;
+            TokenId      elementType;           ///< Type of the value to be assigned to the array element.
+            void*        elementData;           ///< Value to be assigned to the array element.
             bool         allowRedefine : 1;
             bool         optional      : 1;
         };
@@ -298,6 +308,7 @@ class Parser final
             std::vector<MacroParameter> parameters;
             unsigned char *Cache;
             size_t CacheSize;
+            unsigned int invocations;   ///< Number of times the macro has been invoked so far.
         };
 
         struct POV_ARRAY final : public Assignable
@@ -307,15 +318,53 @@ class Parser final
             TokenId Type_;
             int Sizes[kMaxDimensions];
             size_t Mags[kMaxDimensions];
-            std::vector<void*> DataPtrs;
+            std::vector<void*> DataPtrs;            ///< Elements, unless stored densely.
             std::vector<TokenId> Types;
+            std::vector<DBL> DenseFloats;           ///< Elements of a dense float array.
+            std::vector<Vector3d> DenseVectors;     ///< Elements of a dense vector array.
+            std::vector<RGBFTColour> DenseColours;  ///< Elements of a dense colour array.
+            std::vector<bool> DenseSet;             ///< Which elements of a dense array are initialized.
+            void* DenseAccess;                      ///< Element most recently accessed in a dense array.
+            size_t DenseAccessIndex;                ///< Index of the element referenced by @ref DenseAccess.
             bool resizable : 1;
             bool mixedType : 1;
+            bool dense : 1;                         ///< Whether elements are stored by value in one of the `DenseXxx` members.
+            bool sparseOnly : 1;                    ///< Whether the array must never be converted to dense storage.
             bool IsInitialized() const;
             bool HasElement(size_t i) const;
             const TokenId& ElementType(size_t i) const;
             TokenId& ElementType(size_t i);
             size_t GetLinearSize() const;
+
+            /// Get a pointer to an element's value.
+            /// @return The value, or `nullptr` if the element is uninitialized.
+            void* ElementData(size_t i);
+
+            /// Get a slot referencing an element's value, for use as @ref Token_Struct::DataPtr.
+            /// @note
+            ///     In a dense array, the slot is shared by all elements, and must only be used
+            ///     to read the element's value before the next call; to modify the element,
+            ///     use @ref SetElement() or @ref RemoveElement().
+            void** ElementSlot(size_t i);
+
+            /// Assign a value to an element, taking ownership of the value.
+            void SetElement(size_t i, TokenId type, void* data);
+
+            /// Reset an element to uninitialized.
+            void RemoveElement(size_t i);
+
+            /// Switch to dense storage, if all elements are of a suitable type.
+            void MakeDense();
+
+            /// Switch from dense storage to individually allocated elements.
+            void MakeSparse();
+
+            /// Resize dense storage to a given number of elements.
+            void ResizeDense(size_t size);
+
+            /// Verify that nothing has been stored in the slot handed out by @ref ElementSlot().
+            void CheckDenseAccess();
+
             void Grow();
             void GrowBy(size_t delta);
             void GrowTo(size_t delta);
@@ -330,6 +379,8 @@ class Parser final
         {
             TokenId *NumberPtr;
             void **DataPtr;
+            POV_ARRAY *Array;   ///< Array the parameter references an element of, if any.
+            size_t Index;       ///< Linear index of the array element referenced by the parameter.
         };
 
         struct DATA_FILE final : public Assignable
@@ -426,6 +477,7 @@ class Parser final
         void Parse_Bound_Clip (std::vector<ObjectPtr>& objects, bool notexture = true);
         void Parse_Default (void);
         void Parse_Declare (bool is_local, bool after_hash);
+        void Commit_LValue (LValue& lvalue);
         void Parse_Matrix (MATRIX Matrix);
         bool PassParameterByReference (int oldTableIndex);
         bool Parse_RValue (TokenId Previous, TokenId *NumberPtr, void **DataPtr, SYM_ENTRY *sym, bool ParFlag, bool SemiFlag, bool is_local, bool allow_redefine, bool allowUndefined, int old_table_index);
@@ -459,7 +511,13 @@ class Parser final
         std::shared_ptr<IStream> Locate_File(const UCS2String& formalFileName, unsigned int stype, UCS2String& actualFileName, bool err_flag = false);
 
         OStream *CreateFile(const UCS2String& filename, unsigned int stype, bool append);
-        Image *Read_Image(int filetype, const UCS2 *filename, const ImageReadOptions& options);
+
+        /// Start loading an image file in the background.
+        /// The image data and dimensions are filled in once @ref ImageData::WaitForData() is called.
+        void Load_Image(ImageData *image, int filetype, const UCS2 *filename, const ImageReadOptions& options, const char *name);
+        void Complete_Image_Load(ImageData& image, const ImageLoader::PendingResult& pending, const std::string& name);
+        void Wait_For_Image_Loads();
+        void Wait_For_Image_Loads(const PIGMENT *pigment);
 
         // tokenize.h/tokenize.cpp
         void Get_Token (void);
@@ -490,9 +548,10 @@ class Parser final
         const LexemePosition& CurrentFilePosition() const;
         bool HaveCurrentMessageContext() const;
         const MessageContext& CurrentMessageContext() const;
-        void SetInputStream(const std::shared_ptr<IStream>& stream);
+        void SetInputStream(const std::shared_ptr<IStream>& stream, bool useLexemeCache = false);
         RawTokenizer::HotBookmark GetHotBookmark();
         bool GoToBookmark(const RawTokenizer::HotBookmark& bookmark);
+        bool CompileBookmarkStream(RawTokenizer::HotBookmark& bookmark);
 
         bool IsEndOfInvokedMacro() const;
         void Parse_Directive();
@@ -524,6 +583,8 @@ class Parser final
         Rainbow_Struct *Parse_Rainbow (void);
         Skysphere_Struct *Parse_Skysphere(void);
         ImageData *Parse_Image (int LegalTypes, bool GammaCorrect = false);
+        /// Make sure an image's colour map can be modified without affecting other images.
+        void Unshare_Image_Data(ImageData *image);
         SimpleGammaCurvePtr Parse_Gamma (void);
         void Parse_Material(MATERIAL *);
         void Parse_PatternFunction(TPATTERN *);
@@ -642,6 +703,8 @@ class Parser final
 
         DBL clockValue;
         bool useClock;
+        bool recordObjectSources;
+        unsigned int workThreads;
 
         // parse.h/parse.cpp
         bool Not_In_Default;
@@ -715,6 +778,11 @@ class Parser final
         RawToken        mPendingRawToken;
         bool            mHavePendingRawToken;
 
+        std::unique_ptr<LexemeCache> mpLexemeCache; ///< Cache of pre-scanned input files; persistent if enabled.
+
+        std::unique_ptr<ImageLoader> mpImageLoader; ///< Background decoder of image files; created on first use.
+        std::vector<ImageData*> mPendingImages;     ///< Images whose loading may not have been completed yet.
+
         // parstxtr.h/parstxtr.cpp
         TEXTURE *Default_Texture;
 
@@ -796,6 +864,7 @@ class Parser final
 
         void Link(ObjectPtr New_Object, std::vector<ObjectPtr>& Object_List_Root);
         void Link_To_Frame(ObjectPtr Object);
+        void Record_Object_Source(ObjectSource& source);
         void Post_Process(ObjectPtr Object, ObjectPtr Parent);
 
         void Parse_Global_Settings();
@@ -832,6 +901,8 @@ class Parser final
         void Parse_Read(void);
         void Parse_Write(void);
         int Parse_Read_Value(DATA_FILE *User_File, TokenId Previous, TokenId *NumberPtr, void **DataPtr);
+        int Parse_Read_Element(DATA_FILE *User_File, POV_ARRAY *a, size_t i);
+        int Parse_Read_Array(DATA_FILE *User_File, POV_ARRAY *a);
         bool Parse_Read_Float_Value(DBL& val, DATA_FILE *User_File);
         void Check_Macro_Vers(void);
         DBL Parse_Cond_Param(void);
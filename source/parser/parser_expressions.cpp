@@ -1092,6 +1092,7 @@ void Parser::Parse_Num_Factor (EXPRESS& Express,int *Terms)
                             Pigment = CurrentTokenDataPtr<PIGMENT*>();
                             if (const ImagePatternImpl *pattern = dynamic_cast<ImagePatternImpl*>(Pigment->pattern.get()))
                             {
+                                pattern->pImage->WaitForData();
                                 Vect[X] = pattern->pImage->iwidth;
                                 Vect[Y] = pattern->pImage->iheight;
                                 Vect[Z] = 0;
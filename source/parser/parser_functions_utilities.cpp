@@ -300,6 +300,9 @@ FUNCTION_PTR Parser::Parse_DeclareFunction(TokenId *token_id, const char *fn_nam
         Parse_End();
         Post_Pigment(reinterpret_cast<PIGMENT *>(function.private_data));
 
+        // the function may be evaluated while parsing, so any images it uses must be ready
+        Wait_For_Image_Loads(reinterpret_cast<PIGMENT *>(function.private_data));
+
         function.return_size = 5; // returns a color!!!
 
         // function type is vector function
@@ -320,6 +323,9 @@ FUNCTION_PTR Parser::Parse_DeclareFunction(TokenId *token_id, const char *fn_nam
         Parse_PatternFunction(reinterpret_cast<PIGMENT *>(function.private_data));
         Parse_End();
         Post_Pigment(reinterpret_cast<PIGMENT *>(function.private_data));
+
+        // the function may be evaluated while parsing, so any images it uses must be ready
+        Wait_For_Image_Loads(reinterpret_cast<PIGMENT *>(function.private_data));
     }
     else if(CurrentTrueTokenId() == STRING_LITERAL_TOKEN)
     {
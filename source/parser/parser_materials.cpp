@@ -132,7 +132,7 @@ void Parser::Make_Pattern_Image(ImageData *image, FUNCTION_PTR fn, int token)
     image->iheight = image->height;
     if(token == FUNCT_ID_TOKEN)
     {
-        image->data =Image::Create(image->iwidth, image->iheight, ImageDataType::Gray_Int16);
+        image->data.reset(Image::Create(image->iwidth, image->iheight, ImageDataType::Gray_Int16));
 
         point[Z] = 0;
 
@@ -154,7 +154,7 @@ void Parser::Make_Pattern_Image(ImageData *image, FUNCTION_PTR fn, int token)
     }
     else if((token == VECTFUNCT_ID_TOKEN) && (f->return_size == 5))
     {
-        image->data = Image::Create(image->iwidth, image->iheight, ImageDataType::RGBA_Int16); // TODO - we should probably use an HDR format
+        image->data.reset(Image::Create(image->iwidth, image->iheight, ImageDataType::RGBA_Int16)); // TODO - we should probably use an HDR format
         image->data->SetPremultiplied(false); // We're storing the data in non-premultiplied alpha format, as this preserves all the data we're getting from the function.
 
         point[Z] = 0;
@@ -490,14 +490,19 @@ ImageData *Parser::Parse_Image(int Legal, bool GammaCorrect)
             image->VidCap = new POV_VIDCAP_IMPL();
             // note the second ':' gets passed since it's the option prefix
             // e.g. ":vidcap:source=/dev/video0:w=640:h=480:fps=5"
-            image->data = image->VidCap->Init(Name + 7, options, true);
+            image->data.reset(image->VidCap->Init(Name + 7, options, true));
             mBetaFeatureFlags.videoCapture = true;
 #else
             Error("Beta-test video capture feature not implemented on this platform.");
 #endif
         }
         else
-            image->data = Read_Image(filetype, filename.c_str(), options);
+        {
+            // the image data and dimensions are filled in once the file has been decoded
+            Load_Image(image, filetype, filename.c_str(), options, Name);
+            POV_FREE(Name);
+            return image;
+        }
 
         if (!options.warnings.empty())
             for (vector<std::string>::iterator it = options.warnings.begin(); it != options.warnings.end(); it++)
@@ -517,6 +522,33 @@ ImageData *Parser::Parse_Image(int Legal, bool GammaCorrect)
     return image;
 }
 
+void Parser::Unshare_Image_Data(ImageData *image)
+{
+    image->WaitForData();
+
+    // identical image files are loaded only once, so the data may be shared with other images;
+    // the reference held by the image loader itself doesn't count
+
+    if (!image->data->IsIndexed())
+        return;
+
+    long users = image->data.use_count();
+    if ((mpImageLoader != nullptr) && mpImageLoader->Owns(image->data))
+        --users;
+    if (users <= 1)
+        return;
+
+    const Image& source = *image->data;
+    vector<Image::RGBFTMapEntry> map;
+    source.GetColourMap(map);
+    std::shared_ptr<Image> copy(Image::Create(source.GetWidth(), source.GetHeight(), source.GetImageDataType(), map));
+    copy->SetPremultiplied(source.IsPremultiplied());
+    for (unsigned int y = 0; y < source.GetHeight(); ++y)
+        for (unsigned int x = 0; x < source.GetWidth(); ++x)
+            copy->SetIndexedValue(x, y, image->data->GetIndexedValue(x, y));
+    image->data = copy;
+}
+
 
 SimpleGammaCurvePtr Parser::Parse_Gamma (void)
 {
@@ -626,6 +658,7 @@ void Parser::Parse_Image_Map (PIGMENT *Pigment)
         END_CASE
 
         CASE (REPEAT_TOKEN)
+            image->WaitForData(); // need image dimensions
             Parse_UV_Vect (Repeat);
             if ((Repeat[0]<=0.0) || (Repeat[1]<=0.0))
                 Error("Zero or Negative Image Repeat Vector.");
@@ -634,6 +667,7 @@ void Parser::Parse_Image_Map (PIGMENT *Pigment)
         END_CASE
 
         CASE (OFFSET_TOKEN)
+            image->WaitForData(); // need image dimensions
             Parse_UV_Vect (image->Offset);
             image->Offset[U] *= (DBL)-image->iwidth;
             image->Offset[V] *= (DBL)-image->iheight;
@@ -650,6 +684,7 @@ void Parser::Parse_Image_Map (PIGMENT *Pigment)
                         DBL filter;
                         filter = Parse_Float();
                         image->AllFilter = filter;
+                        Unshare_Image_Data(image);
                         if (image->data->IsIndexed())
                         {
                             if (image->data->HasFilterTransmit() == false)
@@ -672,6 +707,7 @@ void Parser::Parse_Image_Map (PIGMENT *Pigment)
                 OTHERWISE
                     UNGET
                     reg = (int)(Parse_Float() + 0.01);
+                    Unshare_Image_Data(image);
                     if (image->data->IsIndexed() == false)
                         Not_With ("filter","non color-mapped image");
                     if ((reg < 0) || (reg >= image->data->GetColourMapSize()))
@@ -703,6 +739,7 @@ void Parser::Parse_Image_Map (PIGMENT *Pigment)
                         DBL transmit;
                         transmit = Parse_Float();
                         image->AllTransmit = transmit;
+                        Unshare_Image_Data(image);
                         if (image->data->IsIndexed())
                         {
                             if (image->data->HasFilterTransmit() == false)
@@ -725,6 +762,7 @@ void Parser::Parse_Image_Map (PIGMENT *Pigment)
                 OTHERWISE
                     UNGET
                     reg = (int)(Parse_Float() + 0.01);
+                    Unshare_Image_Data(image);
                     if (image->data->IsIndexed() == false)
                         Not_With ("transmit","non color-mapped image");
                     if ((reg < 0) || (reg >= image->data->GetColourMapSize()))
@@ -821,6 +859,7 @@ void Parser::Parse_Bump_Map (TNORMAL *Tnormal)
         END_CASE
 
         CASE (REPEAT_TOKEN)
+            image->WaitForData(); // need image dimensions
             Parse_UV_Vect (Repeat);
             if ((Repeat[0]<=0.0) || (Repeat[1]<=0.0))
                 Error("Zero or Negative Image Repeat Vector.");
@@ -829,6 +868,7 @@ void Parser::Parse_Bump_Map (TNORMAL *Tnormal)
         END_CASE
 
         CASE (OFFSET_TOKEN)
+            image->WaitForData(); // need image dimensions
             Parse_UV_Vect (image->Offset);
             image->Offset[U] *= (DBL)-image->iwidth;
             image->Offset[V] *= (DBL)-image->iheight;
@@ -925,6 +965,7 @@ PatternPtr Parser::ParseImagePattern()
         END_CASE
 
         CASE (REPEAT_TOKEN)
+            image->WaitForData(); // need image dimensions
             Parse_UV_Vect (Repeat);
             if ((Repeat[0]<=0.0) || (Repeat[1]<=0.0))
                 Error("Zero or Negative Image Repeat Vector.");
@@ -933,6 +974,7 @@ PatternPtr Parser::ParseImagePattern()
         END_CASE
 
         CASE (OFFSET_TOKEN)
+            image->WaitForData(); // need image dimensions
             Parse_UV_Vect (image->Offset);
             image->Offset[U] *= (DBL)-image->iwidth;
             image->Offset[V] *= (DBL)-image->iheight;
@@ -2889,6 +2931,7 @@ TEXTURE *Parser::Parse_Material_Map()
         END_CASE
 
         CASE (REPEAT_TOKEN)
+            pImage->WaitForData(); // need image dimensions
             Parse_UV_Vect (Repeat);
             if ((Repeat[0]<=0.0) || (Repeat[1]<=0.0))
                 Error("Zero or Negative Image Repeat Vector.");
@@ -2897,6 +2940,7 @@ TEXTURE *Parser::Parse_Material_Map()
         END_CASE
 
         CASE (OFFSET_TOKEN)
+            pImage->WaitForData(); // need image dimensions
             Parse_UV_Vect (pImage->Offset);
             pImage->Offset[U] *= -(DBL)pImage->iwidth;
             pImage->Offset[V] *= -(DBL)pImage->iheight;
@@ -405,6 +405,8 @@ void Parser::Read_Symbol(const RawToken& rawToken)
     RawToken nextRawToken;
     bool haveNextRawToken;
 
+    mToken.array = nullptr;
+
     if (rawToken.isReservedWord && !parseRawIdentifiers)
     {
         // Normally, this function shouldn't be called with reserved words.
@@ -444,7 +446,7 @@ void Parser::Read_Symbol(const RawToken& rawToken)
         else
         {
             /* See if it's a previously declared identifier. */
-            Temp_Entry = mSymbolStack.Find_Symbol(rawToken.lexeme.text.c_str(), &Local_Index);
+            Temp_Entry = mSymbolStack.Find_Symbol(rawToken.lexeme.text, rawToken.hash, &Local_Index);
             if (Temp_Entry != nullptr)
             {
                 if (Temp_Entry->deprecated && !Temp_Entry->deprecatedShown)
@@ -529,7 +531,7 @@ void Parser::Read_Symbol(const RawToken& rawToken)
                                     if (a->resizable)
                                     {
                                         POV_PARSER_ASSERT (a->maxDim == 0);
-                                        if (a->DataPtrs.size() <= k)
+                                        if (a->GetLinearSize() <= size_t(k))
                                             a->GrowTo(k + 1);
                                     }
                                     else
@@ -550,7 +552,9 @@ void Parser::Read_Symbol(const RawToken& rawToken)
                                     Error("Attempt to access uninitialized array element.");
                             }
 
-                            mToken.DataPtr = &(a->DataPtrs[j]);
+                            mToken.DataPtr = a->ElementSlot(j);
+                            mToken.array = a;
+                            mToken.arrayIndex = j;
                             mToken.is_mixed_array_elem = a->mixedType;
                             mToken.NumberPtr = &(a->ElementType(j));
                             mToken.SetTokenId(*mToken.NumberPtr);
@@ -607,7 +611,7 @@ void Parser::Read_Symbol(const RawToken& rawToken)
                                 if (mToken.GetTrueTokenId() != IDENTIFIER_TOKEN)
                                     Expectation_Error ("dictionary element identifier");
 
-                                Temp_Entry = table->Find_Symbol (CurrentTokenText().c_str());
+                                Temp_Entry = table->Find_Symbol (CurrentTokenText(), mToken.raw.hash);
                             }
                             else if (haveNextRawToken && (nextRawToken.lexeme.category == Lexeme::kOther) && (nextRawToken.lexeme.text == "["))
                             {
@@ -644,6 +648,7 @@ void Parser::Read_Symbol(const RawToken& rawToken)
                                 mToken.DataPtr      = nullptr;
                                 mToken.NumberPtr    = nullptr;
                             }
+                            mToken.array                = nullptr;
                             mToken.is_array_elem        = false;
                             mToken.is_mixed_array_elem  = false;
                             mToken.is_dictionary_elem   = true;
@@ -656,12 +661,24 @@ void Parser::Read_Symbol(const RawToken& rawToken)
                                 POV_FREE(dictIndex);
 
                             Par = reinterpret_cast<POV_PARAM *>(Temp_Entry->Data);
-                            mToken.SetTokenId(*(Par->NumberPtr));
+                            if (Par->Array != nullptr)
+                            {
+                                // Array elements are re-visited via the array, as their storage
+                                // may have moved in the meantime.
+                                mToken.NumberPtr        = &(Par->Array->ElementType(Par->Index));
+                                mToken.DataPtr          = Par->Array->ElementSlot(Par->Index);
+                            }
+                            else
+                            {
+                                mToken.NumberPtr        = Par->NumberPtr;
+                                mToken.DataPtr          = Par->DataPtr;
+                            }
+                            mToken.SetTokenId(*(mToken.NumberPtr));
+                            mToken.array                = Par->Array;
+                            mToken.arrayIndex           = Par->Index;
                             mToken.is_array_elem        = false;
                             mToken.is_mixed_array_elem  = false;
                             mToken.is_dictionary_elem   = false;
-                            mToken.NumberPtr            = Par->NumberPtr;
-                            mToken.DataPtr              = Par->DataPtr;
                         }
                         break;
 
@@ -677,7 +694,10 @@ void Parser::Read_Symbol(const RawToken& rawToken)
                 mToken.Data = *(mToken.DataPtr);
             mToken.context = Local_Index;
             if (dictIndex != nullptr)
+            {
                 mToken.raw.lexeme.text = dictIndex;
+                mToken.raw.hash = GetSymbolHash(mToken.raw.lexeme.text);
+            }
             return;
         }
     }
@@ -767,6 +787,7 @@ void Parser::InitCurrentToken()
     mToken.Unget_Token                  = false;
     mToken.End_Of_File                  = false;
     mToken.Data                         = nullptr;
+    mToken.array                        = nullptr;
 }
 
 void Parser::InvalidateCurrentToken()
@@ -852,9 +873,12 @@ const MessageContext& Parser::CurrentMessageContext() const
     return mToken;
 }
 
-void Parser::SetInputStream(const shared_ptr<IStream>& stream)
+void Parser::SetInputStream(const shared_ptr<IStream>& stream, bool useLexemeCache)
 {
-    mTokenizer.SetInputStream(stream);
+    if (useLexemeCache && mpLexemeCache->IsPersistent())
+        mTokenizer.SetInputStream(stream, mpLexemeCache->Get(stream, mTokenizer.GetNestedBlockComments()));
+    else
+        mTokenizer.SetInputStream(stream);
     mToken.sourceFile = mTokenizer.GetInputStream();
 }
 
@@ -872,6 +896,22 @@ bool Parser::GoToBookmark(const RawTokenizer::HotBookmark& bookmark)
     return true;
 }
 
+/// Pre-scan the stream of a bookmark, so that going to the bookmark replays the
+/// stream's lexemes, re-using pre-processed tokens wherever a lexeme is
+/// encountered repeatedly.
+/// @note
+///     Only the raw tokens are re-used; expressions and directives are still
+///     parsed and evaluated on each pass, as there is no bytecode representation
+///     of loop or macro bodies, nor any constant folding.
+/// @return `true` if the bookmark has been modified.
+bool Parser::CompileBookmarkStream(RawTokenizer::HotBookmark& bookmark)
+{
+    if (bookmark.pCachedLexemes != nullptr)
+        return false;
+    bookmark.pCachedLexemes = mpLexemeCache->Get(bookmark.pStream, bookmark.allowNestedBlockComments);
+    return (bookmark.pCachedLexemes != nullptr);
+}
+
 //******************************************************************************
 
 const char *Parser::Get_Token_String (TokenId Token_Id)
@@ -1319,6 +1359,7 @@ void Parser::Parse_Directive()
                     }
 
                     Got_EOF=false;
+                    (void)CompileBookmarkStream(Cond_Stack.back().returnToBookmark);
                     if (!GoToBookmark(Cond_Stack.back().returnToBookmark))
                     {
                         Error("Unable to seek in input file for #while directive.");
@@ -1340,6 +1381,7 @@ void Parser::Parse_Directive()
                     }
 
                     Got_EOF=false;
+                    (void)CompileBookmarkStream(Cond_Stack.back().returnToBookmark);
                     if (!GoToBookmark(Cond_Stack.back().returnToBookmark))
                     {
                         Error("Unable to seek in input file for #for directive.");
@@ -1583,9 +1625,10 @@ void Parser::Parse_Directive()
                     CASE4 (VECTOR_4D_ID_TOKEN, RAINBOW_ID_TOKEN, FOG_ID_TOKEN, SKYSPHERE_ID_TOKEN)
                     CASE3 (MATERIAL_ID_TOKEN, SPLINE_ID_TOKEN, DICTIONARY_ID_TOKEN)
                     CASE2 (VECTOR_ID_TOKEN, FLOAT_ID_TOKEN)
-                        mToken.table->Remove_Symbol (CurrentTokenText().c_str(), mToken.is_array_elem, mToken.DataPtr, CurrentTrueTokenId());
-                        if (mToken.is_mixed_array_elem)
-                            *mToken.NumberPtr = IDENTIFIER_TOKEN;
+                        if (mToken.is_array_elem)
+                            mToken.array->RemoveElement(mToken.arrayIndex);
+                        else
+                            mToken.table->Remove_Symbol (CurrentTokenText().c_str(), false, mToken.DataPtr, CurrentTrueTokenId());
                     END_CASE
 
                     OTHERWISE
@@ -2067,6 +2110,12 @@ void Parser::Invoke_Macro()
         POV_FREE(Table_Entries);
     }
 
+    // Like a loop body on its second iteration, a macro is pre-scanned on its second invocation
+    // (or right away if an include cache is in use, which retains the result across renders).
+    // Macros invoked only once are not worth the cost of scanning the entire file.
+    ++PMac->invocations;
+    bool preScan = mpLexemeCache->IsPersistent() || (PMac->invocations > 1);
+
     if ((PMac->Cache != nullptr) || (PMac->source.fileName != mTokenizer.GetInputStreamName()))
     {
         UCS2String ign;
@@ -2074,7 +2123,16 @@ void Parser::Invoke_Macro()
         Cond_Stack.back().Macro_Same_Flag = false;
         Got_EOF=false;
         shared_ptr<IStream> is;
-        if (PMac->Cache)
+        LexemeCacheEntryPtr pLexemes = mpLexemeCache->Find(PMac->source.fileName);
+        if ((pLexemes == nullptr) && preScan && !mpLexemeCache->IsKnown(PMac->source.fileName))
+        {
+            // Pre-scan the file, so that this and any further invocations can be replayed.
+            is = Locate_File (PMac->source.fileName, POV_File_Text_Macro, ign, true);
+            if (is == nullptr)
+                Error ("Cannot open macro file '%s'.", UCS2toSysString(PMac->source.fileName).c_str());
+            pLexemes = mpLexemeCache->Get(is, mTokenizer.GetNestedBlockComments());
+        }
+        else if (PMac->Cache)
         {
             is = std::make_shared<IMemStream>(Cond_Stack.back().PMac->Cache, PMac->CacheSize, PMac->source.fileName, PMac->source.offset);
         }
@@ -2084,11 +2142,14 @@ void Parser::Invoke_Macro()
             if (is == nullptr)
                 Error ("Cannot open macro file '%s'.", UCS2toSysString(PMac->source.fileName).c_str());
         }
-        mTokenizer.SetInputStream(is);
+        mTokenizer.SetInputStream(is, pLexemes);
     }
     else
     {
         Cond_Stack.back().Macro_Same_Flag=true;
+        // Replay the macro body, and whatever follows the invocation, from pre-scanned lexemes.
+        if (preScan && CompileBookmarkStream(Cond_Stack.back().returnToBookmark))
+            (void)mTokenizer.GoToBookmark(Cond_Stack.back().returnToBookmark);
     }
 
     Got_EOF=false;
@@ -2128,7 +2189,8 @@ void Parser::Return_From_Macro()
 
 Parser::Macro::Macro(const char *s) :
     Macro_Name(POV_STRDUP(s)),
-    Cache(nullptr)
+    Cache(nullptr),
+    invocations(0)
 {}
 
 Parser::Macro::~Macro()
@@ -2154,6 +2216,10 @@ Parser::POV_ARRAY *Parser::Parse_Array_Declare (void)
 
     New = new POV_ARRAY;
     New->resizable = false;
+    New->dense = false;
+    New->sparseOnly = false;
+    New->DenseAccess = nullptr;
+    New->DenseAccessIndex = 0;
     New->mixedType = AllowToken(MIXED_TOKEN);
 
     i=0;
@@ -2232,7 +2298,7 @@ SymbolTable* Parser::Parse_Dictionary_Declare()
     bool oldParseRawIdentifiers;
     UTF8String dictIndex;
 
-    newDictionary = new SymbolTable();
+    newDictionary = new SymbolTable(mSymbolStack.GetStatistics());
 
     // TODO REVIEW - maybe we need `SetOkToDeclare(false)`?
 
@@ -2309,8 +2375,14 @@ void Parser::Parse_Initalizer (int Sub, size_t Base, POV_ARRAY *a)
             else
                 finalParameter = (i == (a->Sizes[Sub]-1));
 
-            if (!Parse_RValue (a->ElementType(Base+i), &(a->ElementType(Base+i)), &(a->DataPtrs[Base+i]),
-                               nullptr, false, false, true, false, true, MAX_NUMBER_OF_TABLES))
+            // Elements may be stored densely, so we parse them into a stand-in.
+            TokenId elementType = a->ElementType(Base+i);
+            void* elementData = nullptr;
+            bool haveElement = Parse_RValue (elementType, &elementType, &elementData,
+                                             nullptr, false, false, true, false, true, MAX_NUMBER_OF_TABLES);
+            if (elementData != nullptr)
+                a->SetElement(Base+i, elementType, elementData);
+            if (!haveElement)
             {
                 EXPECT_ONE
                     CASE (IDENTIFIER_TOKEN)
@@ -2392,6 +2464,7 @@ void Parser::Parse_Fopen(void)
         END_CASE
 
         CASE(WRITE_TOKEN)
+            mpLexemeCache->Invalidate(); // The file may be included later on.
             wfile = CreateFile(fileName.c_str(), POV_File_Text_User, false);
             if (wfile != nullptr)
                 New->Out_File = std::make_shared<OTextStream>(fileName.c_str(), wfile);
@@ -2403,6 +2476,7 @@ void Parser::Parse_Fopen(void)
         END_CASE
 
         CASE(APPEND_TOKEN)
+            mpLexemeCache->Invalidate(); // The file may be included later on.
             wfile = CreateFile(fileName.c_str(), POV_File_Text_User, true);
             if (wfile != nullptr)
                 New->Out_File = std::make_shared<OTextStream>(fileName.c_str(), wfile);
@@ -2476,8 +2550,13 @@ void Parser::Parse_Read()
         CASE (IDENTIFIER_TOKEN)
             if (!End_File)
             {
-                Temp_Entry = mSymbolStack.GetGlobalTable()->Add_Symbol (CurrentTokenText(), IDENTIFIER_TOKEN);
-                End_File = Parse_Read_Value (User_File, CurrentTrueTokenId(), &(Temp_Entry->Token_Number), &(Temp_Entry->Data));
+                if (mToken.array != nullptr)
+                    End_File = Parse_Read_Element (User_File, mToken.array, mToken.arrayIndex);
+                else
+                {
+                    Temp_Entry = mSymbolStack.GetGlobalTable()->Add_Symbol (CurrentTokenText(), IDENTIFIER_TOKEN);
+                    End_File = Parse_Read_Value (User_File, CurrentTrueTokenId(), &(Temp_Entry->Token_Number), &(Temp_Entry->Data));
+                }
                 mToken.is_array_elem = false;
                 mToken.is_mixed_array_elem = false;
                 mToken.is_dictionary_elem = false;
@@ -2488,7 +2567,10 @@ void Parser::Parse_Read()
         CASE (STRING_ID_TOKEN)
             if (!End_File)
             {
-                End_File = Parse_Read_Value (User_File, CurrentTrueTokenId(), mToken.NumberPtr, mToken.DataPtr);
+                if (mToken.array != nullptr)
+                    End_File = Parse_Read_Element (User_File, mToken.array, mToken.arrayIndex);
+                else
+                    End_File = Parse_Read_Value (User_File, CurrentTrueTokenId(), mToken.NumberPtr, mToken.DataPtr);
                 // TODO - Why are we clearing the array/dictionary related flags in this case
                 //        but not in case of VECTOR_ID_TOKEN and FLOAT_ID_TOKEN?
                 mToken.is_array_elem = false;
@@ -2501,13 +2583,33 @@ void Parser::Parse_Read()
         CASE2 (VECTOR_ID_TOKEN, FLOAT_ID_TOKEN)
             if (!End_File)
             {
-                End_File = Parse_Read_Value (User_File, CurrentTrueTokenId(), mToken.NumberPtr, mToken.DataPtr);
+                if (mToken.array != nullptr)
+                    End_File = Parse_Read_Element (User_File, mToken.array, mToken.arrayIndex);
+                else
+                    End_File = Parse_Read_Value (User_File, CurrentTrueTokenId(), mToken.NumberPtr, mToken.DataPtr);
                 // TODO - Why are we not clearing the array/dictionary related flags in this case,
                 //        as we do in case of STRING_ID_TOKEN?
                 Parse_Comma(); /* Scene file comma between 2 idents */
             }
         END_CASE
 
+        CASE (EMPTY_ARRAY_TOKEN)
+            POV_PARSER_ASSERT(mToken.is_array_elem);
+            if (!End_File)
+            {
+                End_File = Parse_Read_Element (User_File, mToken.array, mToken.arrayIndex);
+                Parse_Comma(); /* Scene file comma between 2 idents */
+            }
+        END_CASE
+
+        CASE (ARRAY_ID_TOKEN)
+            if (!End_File)
+            {
+                End_File = Parse_Read_Array (User_File, CurrentTokenDataPtr<POV_ARRAY*>());
+                Parse_Comma(); /* Scene file comma between 2 idents */
+            }
+        END_CASE
+
         CASE(COMMA_TOKEN)
             if (!End_File)
             {
@@ -2638,6 +2740,44 @@ int Parser::Parse_Read_Value(DATA_FILE *User_File, TokenId Previous, TokenId *Nu
     return (User_File->inToken.id == END_OF_FILE_TOKEN);
 }
 
+int Parser::Parse_Read_Element(DATA_FILE *User_File, POV_ARRAY *a, size_t i)
+{
+    // Elements may be stored densely, so we read them into a stand-in.
+    TokenId elementType = a->ElementType(i);
+    void* elementData = nullptr;
+    int End_File = Parse_Read_Value (User_File, elementType, &elementType, &elementData);
+    if (elementData != nullptr)
+        a->SetElement(i, elementType, elementData);
+    return End_File;
+}
+
+int Parser::Parse_Read_Array(DATA_FILE *User_File, POV_ARRAY *a)
+{
+    int End_File = false;
+
+    // Fill the array in storage order, growing a resizable array as needed until the
+    // end of the file is reached.
+    for (size_t i = 0; !End_File; ++i)
+    {
+        bool grown = false;
+        if (i >= a->GetLinearSize())
+        {
+            if (!a->resizable)
+                break;
+            a->Grow();
+            grown = true;
+        }
+
+        End_File = Parse_Read_Element (User_File, a, i);
+
+        if (grown && !a->HasElement(i))
+            // We reserved one element too many.
+            a->Shrink();
+    }
+
+    return End_File;
+}
+
 bool Parser::Parse_Read_Float_Value(DBL& val, DATA_FILE* User_File)
 {
     DBL sign = 1.0;
@@ -2978,7 +3118,7 @@ void Parser::IncludeHeader(const UCS2String& formalFileName)
     if (is == nullptr)
         Error ("Cannot open include file %s.", UCS2toSysString(formalFileName).c_str());
 
-    SetInputStream(is);
+    SetInputStream(is, true);
 
     mSymbolStack.PushTable();
 
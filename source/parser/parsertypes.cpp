@@ -53,6 +53,17 @@
 namespace pov_parser
 {
 
+SymbolHash GetSymbolHash(const char* name, size_t length)
+{
+    // 32-bit FNV-1a hash.
+    SymbolHash hash = 0x811C9DC5u;
+    for (size_t i = 0; i < length; ++i)
+        hash = (hash ^ (unsigned char)(name[i])) * 0x01000193u;
+    return hash;
+}
+
+//******************************************************************************
+
 LexemePosition::LexemePosition() : SourcePosition(1, 1, 0)
 {}
 
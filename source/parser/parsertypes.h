@@ -70,6 +70,17 @@ using ConstStreamPtr = std::shared_ptr<const pov_base::IStream>;
 
 //------------------------------------------------------------------------------
 
+/// Hash value of an identifier, as used by the symbol tables.
+using SymbolHash = POV_UINT32;
+
+/// Compute the hash value of an identifier.
+SymbolHash GetSymbolHash(const char* name, size_t length);
+
+/// Compute the hash value of an identifier.
+inline SymbolHash GetSymbolHash(const UTF8String& name) { return GetSymbolHash(name.data(), name.size()); }
+
+//------------------------------------------------------------------------------
+
 struct LexemePosition : pov::SourcePosition
 {
     LexemePosition();
@@ -195,10 +206,15 @@ struct Assignable
 
 struct ParserOptions final
 {
-    bool    useClock;
-    DBL     clock;
-    size_t  randomSeed;
-    ParserOptions(bool uc, DBL c, size_t rs) : useClock(uc), clock(c), randomSeed(rs) {}
+    bool        useClock;
+    DBL         clock;
+    size_t      randomSeed;
+    UCS2String  includeCachePath;   ///< Directory for the persistent lexeme cache, or empty to disable.
+    bool        recordObjectSources; ///< Whether to remember where each object was defined, for object profiling.
+    unsigned int workThreads;       ///< Number of threads to decode image files with, or 0 for one per CPU.
+    ParserOptions(bool uc, DBL c, size_t rs, const UCS2String& icp = UCS2String(), bool ros = false, unsigned int wt = 0) :
+        useClock(uc), clock(c), randomSeed(rs), includeCachePath(icp), recordObjectSources(ros), workThreads(wt)
+    {}
 };
 
 //------------------------------------------------------------------------------
@@ -48,6 +48,7 @@
 //  (none at the moment)
 
 // POV-Ray header files (parser module)
+#include "parser/lexemecache.h"
 #include "parser/reservedwords.h"
 
 // this must be the last file included
@@ -93,6 +94,7 @@ TokenId RawToken::GetTokenId() const
 RawTokenizer::KnownWordInfo::KnownWordInfo() :
     id(int(NOT_A_TOKEN)),
     expressionId(NOT_A_TOKEN),
+    hash(0),
     isReservedWord(false),
     isPseudoIdentifier(false)
 {}
@@ -100,7 +102,10 @@ RawTokenizer::KnownWordInfo::KnownWordInfo() :
 //******************************************************************************
 
 RawTokenizer::RawTokenizer() :
-    mNextIdentifierId(TOKEN_COUNT+1)
+    mNextIdentifierId(TOKEN_COUNT+1),
+    mpCurrentLexemes(nullptr),
+    mpCurrentTokens(nullptr),
+    mCompiledTokenCount(0)
 {
     for (auto i = Reserved_Words; i->Token_Name != nullptr; ++i)
     {
@@ -111,6 +116,7 @@ RawTokenizer::RawTokenizer() :
         KnownWordInfo& knownWord        = mKnownWords[i->Token_Name];
         knownWord.id                    = i->Token_Number;
         knownWord.expressionId          = GetCategorizedTokenId(i->Token_Number);
+        knownWord.hash                  = GetSymbolHash(i->Token_Name, strlen(i->Token_Name));
         knownWord.isReservedWord        = true;
         knownWord.isPseudoIdentifier    = ((knownWord.id == GLOBAL_TOKEN) || (knownWord.id == LOCAL_TOKEN));
     }
@@ -121,6 +127,11 @@ void RawTokenizer::SetInputStream(StreamPtr pStream)
     mScanner.SetInputStream(pStream);
 }
 
+void RawTokenizer::SetInputStream(StreamPtr pStream, const LexemeCacheEntryPtr& pCachedLexemes)
+{
+    mScanner.SetInputStream(pStream, pCachedLexemes);
+}
+
 void RawTokenizer::SetStringEncoding(CharacterEncodingID encoding)
 {
     mScanner.SetCharacterEncoding(encoding);
@@ -131,26 +142,29 @@ void pov_parser::RawTokenizer::SetNestedBlockComments(bool allow)
     mScanner.SetNestedBlockComments(allow);
 }
 
+bool RawTokenizer::GetNestedBlockComments() const
+{
+    return mScanner.GetNestedBlockComments();
+}
+
 //------------------------------------------------------------------------------
 
 bool RawTokenizer::GetNextToken(RawToken& token)
 {
+    if (mScanner.GetReplayedLexemes() != nullptr)
+        return GetNextCompiledToken(token, false);
+
     if (!mScanner.GetNextLexeme(token.lexeme))
         return false;
 
-    switch (token.lexeme.category)
-    {
-        case Lexeme::kWord:             if (ProcessWordLexeme(token))           return true;
-        case Lexeme::kFloatLiteral:     if (ProcessFloatLiteralLexeme(token))   return true;
-        case Lexeme::kStringLiteral:    if (ProcessStringLiteralLexeme(token))  return true;
-        case Lexeme::kOther:            if (ProcessOtherLexeme(token))          return true;
-        case Lexeme::kUTF8SignatureBOM: if (ProcessSignatureLexeme(token))      return true;
-        default:                        POV_PARSER_PANIC();                     return true;
-    }
+    return ProcessLexeme(token);
 }
 
 bool RawTokenizer::GetNextDirective(RawToken& token)
 {
+    if (mScanner.GetReplayedLexemes() != nullptr)
+        return GetNextCompiledToken(token, true);
+
     if (!mScanner.GetNextDirective(token.lexeme))
         return false;
 
@@ -166,6 +180,59 @@ bool RawTokenizer::GetNextDirective(RawToken& token)
     return true;
 }
 
+bool RawTokenizer::GetNextCompiledToken(RawToken& token, bool directive)
+{
+    const LexemeCacheEntryPtr& pLexemes = mScanner.GetReplayedLexemes();
+    if (pLexemes.get() != mpCurrentLexemes)
+    {
+        mpCurrentTokens = &mCompiledTokens[pLexemes];
+        if (mpCurrentTokens->slots.empty())
+            mpCurrentTokens->slots.resize(pLexemes->recordCount, CompiledTokens::kNotSeen);
+        mpCurrentLexemes = pLexemes.get();
+    }
+
+    size_t index;
+    if (!mScanner.AdvanceCachedLexeme(index, directive))
+        return false;
+
+    POV_UINT32& slot = mpCurrentTokens->slots[index];
+    if (slot >= CompiledTokens::kFirstToken)
+    {
+        token = mpCurrentTokens->tokens[slot - CompiledTokens::kFirstToken];
+        return true;
+    }
+
+    pLexemes->GetLexeme(index, token.lexeme);
+    if (!ProcessLexeme(token))
+        return false;
+
+    // Only retain tokens we have seen before, to limit memory consumption to
+    // loop and macro bodies (and whatever else happens to be replayed).
+    if (slot == CompiledTokens::kNotSeen)
+        slot = CompiledTokens::kSeenOnce;
+    else if (mCompiledTokenCount < POV_PARSER_MAX_COMPILED_TOKENS)
+    {
+        slot = POV_UINT32(mpCurrentTokens->tokens.size() + CompiledTokens::kFirstToken);
+        mpCurrentTokens->tokens.push_back(token);
+        ++mCompiledTokenCount;
+    }
+
+    return true;
+}
+
+bool RawTokenizer::ProcessLexeme(RawToken& token)
+{
+    switch (token.lexeme.category)
+    {
+        case Lexeme::kWord:             if (ProcessWordLexeme(token))           return true;
+        case Lexeme::kFloatLiteral:     if (ProcessFloatLiteralLexeme(token))   return true;
+        case Lexeme::kStringLiteral:    if (ProcessStringLiteralLexeme(token))  return true;
+        case Lexeme::kOther:            if (ProcessOtherLexeme(token))          return true;
+        case Lexeme::kUTF8SignatureBOM: if (ProcessSignatureLexeme(token))      return true;
+        default:                        POV_PARSER_PANIC();                     return true;
+    }
+}
+
 bool RawTokenizer::ProcessWordLexeme(RawToken& token)
 {
     POV_PARSER_ASSERT(token.lexeme.category == Lexeme::kWord);
@@ -176,9 +243,11 @@ bool RawTokenizer::ProcessWordLexeme(RawToken& token)
     {
         i.id = ++mNextIdentifierId;
         i.expressionId = IDENTIFIER_TOKEN;
+        i.hash = GetSymbolHash(token.lexeme.text);
     }
     token.id = i.id;
     token.expressionId = i.expressionId;
+    token.hash = i.hash;
     token.value = nullptr;
     token.isReservedWord = i.isReservedWord;
     token.isPseudoIdentifier = i.isPseudoIdentifier;
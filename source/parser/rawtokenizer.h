@@ -43,8 +43,10 @@
 //  (none at the moment)
 
 // C++ standard header files
+#include <map>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 // POV-Ray header files (base module)
 #include "base/stringtypes.h"
@@ -144,6 +146,12 @@ struct RawToken final
     ///     their values here, rather than using the @ref value field.
     DBL floatValue;
 
+    /// Hash value of the word, as used by the symbol tables.
+    /// For word tokens (identifiers and reserved words) this is computed only
+    /// once per distinct word, and carried along with every occurrence. For
+    /// other tokens this is undefined.
+    SymbolHash hash;
+
     /// Associated non-numeric value.
     /// For string literal tokens, this value is set by the _raw tokenizer_ to
     /// hold the parsed string. For identifiers, this value may be set by the
@@ -185,6 +193,11 @@ struct RawToken final
 /// In addition, literal lexemes are evaluated, converting their textual
 /// representation into the corresponding internal value representation.
 ///
+/// When replaying cached lexemes, any lexeme encountered a second time (e.g.
+/// in the body of a loop or macro) has its raw token retained, so that
+/// subsequent iterations or invocations can re-use the pre-processed token
+/// rather than processing the lexeme again.
+///
 class RawTokenizer final
 {
 public:
@@ -199,12 +212,20 @@ public:
     ///     The input stream must already be opened.
     void SetInputStream(StreamPtr pStream);
 
+    /// Set or change the input stream, replaying previously cached lexemes.
+    /// @note
+    ///     The input stream must already be opened.
+    void SetInputStream(StreamPtr pStream, const LexemeCacheEntryPtr& pCachedLexemes);
+
     /// Change encoding setting.
     void SetStringEncoding(CharacterEncodingID encoding);
 
     /// Change the behaviour with regards to nested block comments.
     void SetNestedBlockComments(bool allow);
 
+    /// Get the current behaviour with regards to nested block comments.
+    bool GetNestedBlockComments() const;
+
     /// Get the next token from the input stream.
     bool GetNextToken(RawToken& token);
 
@@ -240,17 +261,38 @@ private:
 
     struct KnownWordInfo final
     {
-        int     id;
-        TokenId expressionId;
-        bool    isReservedWord     : 1;
-        bool    isPseudoIdentifier : 1;
+        int         id;
+        TokenId     expressionId;
+        SymbolHash  hash;
+        bool        isReservedWord     : 1;
+        bool        isPseudoIdentifier : 1;
         KnownWordInfo();
     };
 
+    /// Raw tokens pre-processed from the lexemes of a single cache entry.
+    struct CompiledTokens final
+    {
+        /// Per lexeme, either @ref kNotSeen, @ref kSeenOnce, or the index of
+        /// the pre-processed token plus @ref kFirstToken.
+        std::vector<POV_UINT32> slots;
+        std::vector<RawToken>   tokens;
+
+        static constexpr POV_UINT32 kNotSeen    = 0;
+        static constexpr POV_UINT32 kSeenOnce   = 1;
+        static constexpr POV_UINT32 kFirstToken = 2;
+    };
+
     Scanner                                         mScanner;
     std::unordered_map<UTF8String, KnownWordInfo>   mKnownWords;
     unsigned int                                    mNextIdentifierId;
+    std::map<LexemeCacheEntryPtr, CompiledTokens>   mCompiledTokens;
+    const LexemeCacheEntry*                         mpCurrentLexemes;       ///< Cache entry @ref mpCurrentTokens belongs to.
+    CompiledTokens*                                 mpCurrentTokens;
+    size_t                                          mCompiledTokenCount;    ///< Total number of pre-processed tokens retained.
+
+    bool GetNextCompiledToken(RawToken& token, bool directive);
 
+    bool ProcessLexeme(RawToken& token);
     bool ProcessWordLexeme(RawToken& token);
     bool ProcessOtherLexeme(RawToken& token);
     bool ProcessFloatLiteralLexeme(RawToken& token);
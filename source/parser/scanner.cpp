@@ -52,9 +52,11 @@
 #include "base/textstream.h"
 
 // POV-Ray header files (core module)
-// POV-Ray header files (parser module)
 //  (none at the moment)
 
+// POV-Ray header files (parser module)
+#include "parser/lexemecache.h"
+
 // this must be the last file included
 #include "base/povdebug.h"
 
@@ -696,6 +698,14 @@ bool Scanner::BufferedSource::SetInputStream(StreamPtr pStream, POV_OFF_T pos)
     }
 }
 
+void Scanner::BufferedSource::Detach()
+{
+    mpStream = nullptr;
+    mBase = 0;
+    mBuffer.Clear();
+    mExhausted = true;
+}
+
 StreamPtr Scanner::BufferedSource::GetInputStream()
 {
     return mpStream;
@@ -846,6 +856,8 @@ Scanner::Scanner() :
 
 void Scanner::SetInputStream(StreamPtr stream)
 {
+    (void)mReplay.Stop();
+
     mSource.SetInputStream(stream);
 
     mpCharacterEncoding = AutoDetectEncoding::Instance();
@@ -853,7 +865,23 @@ void Scanner::SetInputStream(StreamPtr stream)
     mNominalEndOfLine = '\0';
 }
 
-bool Scanner::SetInputStream(StreamPtr stream, const Bookmark& bookmark)
+void Scanner::SetInputStream(StreamPtr stream, const LexemeCacheEntryPtr& pCachedLexemes)
+{
+    if ((pCachedLexemes == nullptr) || (pCachedLexemes->allowNestedBlockComments != mAllowNestedBlockComments))
+    {
+        SetInputStream(stream);
+        return;
+    }
+
+    mSource.Detach();
+    mReplay.Start(stream, pCachedLexemes, 0);
+
+    mpCharacterEncoding = AutoDetectEncoding::Instance();
+    mCurrentPosition = LexemePosition();
+    mNominalEndOfLine = '\0';
+}
+
+bool Scanner::SetInputStream(StreamPtr stream, const Bookmark& bookmark, const LexemeCacheEntryPtr& pCachedLexemes)
 {
     // Set the scanner state back to when the bookmark was created.
     mpCharacterEncoding = bookmark.characterEncoding;
@@ -861,10 +889,36 @@ bool Scanner::SetInputStream(StreamPtr stream, const Bookmark& bookmark)
     mNominalEndOfLine = bookmark.nominalEndOfLine;
     mAllowNestedBlockComments = bookmark.allowNestedBlockComments;
 
+    if ((pCachedLexemes != nullptr) && (pCachedLexemes->allowNestedBlockComments == mAllowNestedBlockComments))
+    {
+        // Set replay back to when the bookmark was created.
+        mSource.Detach();
+        mReplay.Start(stream, pCachedLexemes, pCachedLexemes->Find(bookmark.offset));
+        return true;
+    }
+
+    (void)mReplay.Stop();
+
     // Set source back to when the bookmark was created.
     return mSource.SetInputStream(stream, bookmark.offset);
 }
 
+StreamPtr Scanner::GetCurrentStream() const
+{
+    if (mReplay.IsActive())
+        return mReplay.pStream;
+    return mSource.mpStream;
+}
+
+bool Scanner::StopReplay()
+{
+    POV_PARSER_ASSERT(mReplay.IsActive());
+
+    // The buffered source has been detached from the stream, so this will seek.
+    StreamPtr stream = mReplay.Stop();
+    return mSource.SetInputStream(stream, mCurrentPosition.offset);
+}
+
 void Scanner::SetCharacterEncoding(CharacterEncodingID encoding)
 {
     switch (encoding)
@@ -882,12 +936,23 @@ void Scanner::SetCharacterEncoding(CharacterEncodingID encoding)
 void Scanner::SetNestedBlockComments(bool allow)
 {
     mAllowNestedBlockComments = allow;
+    if (mReplay.IsActive() && (mReplay.pLexemes->allowNestedBlockComments != allow))
+        (void)StopReplay();
 }
 
 //------------------------------------------------------------------------------
 
 bool Scanner::GetNextLexeme(Lexeme& lexeme)
 {
+    if (mReplay.IsActive())
+    {
+        size_t index;
+        if (!AdvanceCachedLexeme(index, false))
+            return false;
+        mReplay.pLexemes->GetLexeme(index, lexeme);
+        return true;
+    }
+
     if (!mSource.IsValid())
         return false;
 
@@ -980,6 +1045,15 @@ bool Scanner::GetNextLexeme(Lexeme& lexeme)
 
 bool Scanner::GetNextDirective(Lexeme& lexeme)
 {
+    if (mReplay.IsActive())
+    {
+        size_t index;
+        if (!AdvanceCachedLexeme(index, true))
+            return false;
+        mReplay.pLexemes->GetLexeme(index, lexeme);
+        return true;
+    }
+
     if (!mSource.IsValid())
         return false;
 
@@ -1033,6 +1107,32 @@ bool Scanner::GetNextDirective(Lexeme& lexeme)
     return false;
 }
 
+bool Scanner::AdvanceCachedLexeme(size_t& index, bool directive)
+{
+    POV_PARSER_ASSERT(mReplay.IsActive());
+
+    const LexemeCacheEntry& lexemes = *mReplay.pLexemes;
+    while (mReplay.index < lexemes.recordCount)
+    {
+        index = mReplay.index++;
+        const LexemeCacheEntry::Record& record = lexemes.records[index];
+        // Skipping to the next directive is equivalent to skipping any lexemes other than `#`,
+        // as cached streams are guaranteed to be free of invalid characters.
+        if (directive && ((record.category != Lexeme::kOther) || (record.textSize != 1) ||
+                          (lexemes.text[record.textOffset] != '#')))
+            continue;
+        mCurrentPosition.offset     = record.endOffset;
+        mCurrentPosition.line       = record.endLine;
+        mCurrentPosition.column     = record.endColumn;
+        mNominalEndOfLine           = lexemes.NominalEndOfLineAt(record.endOffset);
+        return true;
+    }
+
+    mCurrentPosition = lexemes.endOfStream;
+    mNominalEndOfLine = lexemes.NominalEndOfLineAt(mCurrentPosition.offset);
+    return false;
+}
+
 //------------------------------------------------------------------------------
 
 bool Scanner::GetNextWordLexeme(Lexeme& lexeme)
@@ -1298,6 +1398,11 @@ bool Scanner::GetNextSignatureLexeme(Lexeme& lexeme, Lexeme::Category sigId, con
 
 bool Scanner::GetRaw(unsigned char* buffer, size_t size)
 {
+    if (mReplay.IsActive())
+    {
+        // Read directly from the stream, rather than stop replaying.
+        return mReplay.pStream->seekg(mCurrentPosition.offset) && mReplay.pStream->read(buffer, size);
+    }
     return mSource.GetRaw(buffer, size);
 }
 
@@ -1305,39 +1410,39 @@ bool Scanner::GetRaw(unsigned char* buffer, size_t size)
 
 ConstStreamPtr Scanner::GetInputStream() const
 {
-    return const_cast<Scanner*>(this)->mSource.GetInputStream();
+    return GetCurrentStream();
 }
 
 UCS2String Scanner::GetInputStreamName() const
 {
-    return mSource.GetInputStreamName();
+    return GetCurrentStream()->Name();
 }
 
 Scanner::HotBookmark Scanner::GetHotBookmark()
 {
-    return HotBookmark(mSource.GetInputStream(), mCurrentPosition, mpCharacterEncoding, mNominalEndOfLine, mAllowNestedBlockComments);
+    return HotBookmark(GetCurrentStream(), mCurrentPosition, mpCharacterEncoding, mNominalEndOfLine, mAllowNestedBlockComments, mReplay.pLexemes);
 }
 
 Scanner::ColdBookmark Scanner::GetColdBookmark() const
 {
-    return ColdBookmark(mSource.GetInputStreamName(), mCurrentPosition, mpCharacterEncoding, mNominalEndOfLine, mAllowNestedBlockComments);
+    return ColdBookmark(GetInputStreamName(), mCurrentPosition, mpCharacterEncoding, mNominalEndOfLine, mAllowNestedBlockComments);
 }
 
 bool Scanner::GoToBookmark(const Bookmark& bookmark)
 {
-    return SetInputStream(mSource.mpStream, bookmark);
+    return SetInputStream(GetCurrentStream(), bookmark, mReplay.pLexemes);
 }
 
 bool Scanner::GoToBookmark(const HotBookmark& bookmark)
 {
-    return SetInputStream(bookmark.pStream, bookmark);
+    return SetInputStream(bookmark.pStream, bookmark, bookmark.pCachedLexemes);
 }
 
 bool Scanner::GoToBookmark(const ColdBookmark& bookmark)
 {
     if (bookmark.fileName != GetInputStreamName())
         return false;
-    return SetInputStream(mSource.mpStream, bookmark);
+    return SetInputStream(GetCurrentStream(), bookmark, mReplay.pLexemes);
 }
 
 //------------------------------------------------------------------------------
@@ -65,6 +65,8 @@ using namespace pov_base;
 using Octet = unsigned char;
 
 struct CharacterEncoding;
+struct LexemeCacheEntry;
+using LexemeCacheEntryPtr = std::shared_ptr<const LexemeCacheEntry>;
 
 //******************************************************************************
 
@@ -121,6 +123,7 @@ class Scanner final
 public:
 
     friend struct CharacterEncoding;
+    friend class LexemeCache;
     using CharacterEncodingPtr = const CharacterEncoding*;
 
     using Octet             = unsigned char;
@@ -146,9 +149,11 @@ public:
     struct HotBookmark final : Bookmark
     {
         StreamPtr           pStream;
+        LexemeCacheEntryPtr pCachedLexemes;
         HotBookmark() = default;
-        HotBookmark(const StreamPtr& s, const LexemePosition& lp, CharacterEncodingPtr se, Character neol, bool anbc) :
-            Bookmark(lp, se, neol, anbc), pStream(s)
+        HotBookmark(const StreamPtr& s, const LexemePosition& lp, CharacterEncodingPtr se, Character neol, bool anbc,
+                    const LexemeCacheEntryPtr& cl = nullptr) :
+            Bookmark(lp, se, neol, anbc), pStream(s), pCachedLexemes(cl)
         {}
         virtual UCS2String GetFileName() const override;
     };
@@ -173,6 +178,19 @@ public:
     ///     to yet another stream.
     void SetInputStream(StreamPtr pStream);
 
+    /// Set or change the input stream, replaying previously cached lexemes.
+    ///
+    /// Instead of scanning the stream, the lexemes are taken from the cache
+    /// entry. The scanner reverts to scanning the stream itself (starting at
+    /// the current position) whenever the cached lexemes cannot be used, e.g.
+    /// when the nested block comment setting is changed.
+    ///
+    /// @note
+    ///     The input stream must already be opened, and will _not_ be closed
+    ///     upon reaching the end of the stream, closing the scanner or changing
+    ///     to yet another stream.
+    void SetInputStream(StreamPtr pStream, const LexemeCacheEntryPtr& pCachedLexemes);
+
     /// Change encoding setting.
     void SetCharacterEncoding(CharacterEncodingID encoding);
 
@@ -187,6 +205,9 @@ public:
     /// Windows editor, as well as most C-inspired programming languages).
     void SetNestedBlockComments(bool allow);
 
+    /// Get the current behaviour with regards to nested block comments.
+    bool GetNestedBlockComments() const { return mAllowNestedBlockComments; }
+
     /// Try to retrieve the next lexeme from the input stream.
     /// @return `true` if a lexeme could be successfully retrieved,
     ///         `false` if the end of the input stream was encountered instead.
@@ -197,6 +218,19 @@ public:
     ///         `false` if the end of the input stream was encountered instead.
     bool GetNextDirective(Lexeme& lexeme);
 
+    /// Get the cached lexemes currently being replayed.
+    /// @return The cached lexemes, or `nullptr` if the input stream is being scanned.
+    const LexemeCacheEntryPtr& GetReplayedLexemes() const { return mReplay.pLexemes; }
+
+    /// Advance to the next cached lexeme without retrieving it.
+    /// @pre
+    ///     The scanner shall be replaying cached lexemes.
+    /// @param[out] index       Index of the lexeme in the cache entry.
+    /// @param[in]  directive   Whether to skip ahead to the next `#` lexeme.
+    /// @return `true` if a lexeme could be successfully retrieved,
+    ///         `false` if the end of the input stream was encountered instead.
+    bool AdvanceCachedLexeme(size_t& index, bool directive);
+
     /// Read raw data.
     /// @deprecated
     ///     This method is only intended as a temporary measure to implement
@@ -350,6 +384,14 @@ private:
         /// @return `true` if enough octet were available.
         inline bool GetRaw(unsigned char* buffer, size_t size);
 
+        /// Disassociate from the input stream, discarding the buffer.
+        ///
+        /// This must be called whenever the input stream may be read from or
+        /// repositioned by other parties, so that the buffered source does not
+        /// subsequently rely on the stream position.
+        ///
+        void Detach();
+
         /// Fill buffer with new data from source.
         ///
         /// @pre
@@ -375,6 +417,32 @@ private:
 
     //------------------------------------------------------------------------------
 
+    /// Structure representing pre-scanned lexemes of an input stream to replay.
+    ///
+    /// While replaying, the input stream is only accessed directly (e.g. to
+    /// read raw data); the @ref BufferedSource is detached from it.
+    ///
+    struct ReplaySource final
+    {
+        LexemeCacheEntryPtr pLexemes;   ///< Cached lexemes being replayed, or `nullptr` if none.
+        StreamPtr           pStream;    ///< Input stream the cached lexemes belong to.
+        size_t              index;      ///< Index of the next cached lexeme to replay.
+
+        ReplaySource() : index(0) {}
+
+        /// Test whether lexemes are being replayed.
+        bool IsActive() const { return (pLexemes != nullptr); }
+
+        /// Start replaying lexemes.
+        void Start(StreamPtr s, const LexemeCacheEntryPtr& l, size_t i) { pLexemes = l; pStream = s; index = i; }
+
+        /// Stop replaying lexemes.
+        /// @return The input stream the lexemes belong to.
+        StreamPtr Stop() { StreamPtr s = pStream; pLexemes = nullptr; pStream = nullptr; index = 0; return s; }
+    };
+
+    //------------------------------------------------------------------------------
+
     BufferedSource          mSource;                    ///< Input data stream and associated buffer.
 
     CharacterEncodingPtr    mpCharacterEncoding;        ///< Character encoding expected in input stream.
@@ -387,6 +455,8 @@ private:
 
     bool                    mAllowNestedBlockComments;  ///< Whether block comments are allowed to nest.
 
+    ReplaySource            mReplay;                    ///< Cached lexemes being replayed, if any.
+
     /// Change the input stream and jump to a given bookmark.
     ///
     /// @note
@@ -394,7 +464,14 @@ private:
     ///     upon reaching the end of the stream, closing the scanner or changing
     ///     to yet another stream.
     ///
-    bool SetInputStream(StreamPtr pStream, const Bookmark& bookmark);
+    bool SetInputStream(StreamPtr pStream, const Bookmark& bookmark, const LexemeCacheEntryPtr& pCachedLexemes);
+
+    /// Get the current input stream.
+    StreamPtr GetCurrentStream() const;
+
+    /// Stop replaying cached lexemes, and resume scanning the input stream at
+    /// the current position instead.
+    bool StopReplay();
 
     /// Try to retrieve the next word-type lexeme.
     ///
@@ -40,7 +40,7 @@
 #include <cstring>
 
 // C++ standard header files
-//  (none at the moment)
+#include <algorithm>
 
 // POV-Ray header files (base module)
 #include "base/pov_mem.h"
@@ -73,32 +73,32 @@ using namespace pov;
 
 //******************************************************************************
 
-SymbolTable::SymbolTable()
-{
-    for (int i = 0; i < SYM_TABLE_SIZE; i++)
-        mapHashTable[i] = nullptr;
-}
+SymbolTable::SymbolTable(SymbolTableStatistics* pStatistics) :
+    mCount(0),
+    mpStatistics(pStatistics)
+{}
 
-SymbolTable::SymbolTable(const SymbolTable& obj)
+SymbolTable::SymbolTable(const SymbolTable& obj) :
+    maSlots(obj.maSlots.size(), nullptr),
+    mCount(obj.mCount),
+    mpStatistics(obj.mpStatistics)
 {
-    for (int i = SYM_TABLE_SIZE - 1; i >= 0; i--)
+    for (size_t i = 0; i < obj.maSlots.size(); ++i)
     {
-        SYM_ENTRY* oldEntry = obj.mapHashTable[i];
-        while (oldEntry)
+        // Copy the symbol along with any symbols it shadows, preserving their order.
+        SYM_ENTRY** newEntryPtr = &(maSlots[i]);
+        for (const SYM_ENTRY* oldEntry = obj.maSlots[i]; oldEntry != nullptr; oldEntry = oldEntry->next)
         {
-            SYM_ENTRY* newEntry = Copy_Entry(oldEntry);
-            newEntry->next = obj.mapHashTable[i];
-            mapHashTable[i] = newEntry;
-            oldEntry = oldEntry->next;
+            *newEntryPtr = Copy_Entry(oldEntry);
+            newEntryPtr = &((*newEntryPtr)->next);
         }
     }
 }
 
 SymbolTable::~SymbolTable()
 {
-    for (int i = SYM_TABLE_SIZE - 1; i >= 0; i--)
+    for (auto entry : maSlots)
     {
-        SYM_ENTRY *entry = mapHashTable[i];
         while (entry)
         {
             entry = Destroy_Entry(entry);
@@ -120,6 +120,8 @@ SYM_ENTRY* SymbolTable::Create_Entry(const UTF8String& Name, TokenId Number)
     New->Deprecation_Message = nullptr;
     New->ref_count = 1;
     New->name = Name;
+    New->hash = GetSymbolHash(Name);
+    New->next = nullptr;
 
     return New;
 }
@@ -138,6 +140,8 @@ SYM_ENTRY* SymbolTable::Copy_Entry(const SYM_ENTRY* oldEntry)
     newEntry->Deprecation_Message = nullptr;
     newEntry->ref_count = 1;
     newEntry->name = oldEntry->name;
+    newEntry->hash = oldEntry->hash;
+    newEntry->next = nullptr;
 
     return newEntry;
 }
@@ -407,10 +411,16 @@ void SymbolTable::Destroy_Ident_Data(void *Data, int Type)
 
 void SymbolTable::Add_Entry(SYM_ENTRY *Table_Entry)
 {
-    int i = get_hash_value(Table_Entry->name.c_str());
+    if ((mCount + 1) * 2 > maSlots.size())
+        Grow();
+
+    size_t i = FindSlot(Table_Entry->name.data(), Table_Entry->name.size(), Table_Entry->hash);
 
-    Table_Entry->next = mapHashTable[i];
-    mapHashTable[i] = Table_Entry;
+    // If the name is already taken, the new symbol shadows the existing one.
+    Table_Entry->next = maSlots[i];
+    if (maSlots[i] == nullptr)
+        ++mCount;
+    maSlots[i] = Table_Entry;
 }
 
 SYM_ENTRY *SymbolTable::Add_Symbol(const UTF8String& Name, TokenId Number)
@@ -425,7 +435,14 @@ SYM_ENTRY *SymbolTable::Add_Symbol(const UTF8String& Name, TokenId Number)
 
 SYM_ENTRY* SymbolTable::Find_Symbol(const char* name) const
 {
-    return Find_Symbol(name, get_hash_value(name));
+    size_t length = std::strlen(name);
+    return Find_Symbol(name, length, GetSymbolHash(name, length));
+}
+
+SYM_ENTRY* SymbolTable::Find_Symbol(const UTF8String& name, SymbolHash hash) const
+{
+    POV_PARSER_ASSERT(hash == GetSymbolHash(name));
+    return Find_Symbol(name.data(), name.size(), hash);
 }
 
 void SymbolTable::Remove_Symbol(const char *Name, bool is_array_elem, void **DataPtr, int ttype)
@@ -444,28 +461,45 @@ void SymbolTable::Remove_Symbol(const char *Name, bool is_array_elem, void **Dat
     }
     else
     {
-        SYM_ENTRY *Entry;
-        SYM_ENTRY **EntryPtr;
+        if (maSlots.empty())
+            POV_PARSER_PANIC();
 
-        int i = get_hash_value(Name);
+        size_t length = std::strlen(Name);
+        size_t i = FindSlot(Name, length, GetSymbolHash(Name, length));
+        SYM_ENTRY *Entry = maSlots[i];
 
-        EntryPtr = &(mapHashTable[i]);
-        Entry = *EntryPtr;
+        if (Entry == nullptr)
+            POV_PARSER_PANIC();
 
-        while (Entry)
+        if (Entry->next != nullptr)
+        {
+            // Un-shadow the previous symbol of the same name.
+            maSlots[i] = Entry->next;
+        }
+        else
         {
-            if (strcmp(Name, Entry->name.c_str()) == 0)
+            // Free the slot, moving any subsequent symbols of the same probe
+            // sequence into the gap so that they remain reachable.
+            size_t mask = maSlots.size() - 1;
+            size_t j = i;
+            for (;;)
             {
-                *EntryPtr = Entry->next;
-                Destroy_Entry(Entry);
-                return;
+                j = (j + 1) & mask;
+                SYM_ENTRY* other = maSlots[j];
+                if (other == nullptr)
+                    break;
+                size_t home = other->hash & mask;
+                bool homeInGap = (i <= j) ? ((i < home) && (home <= j)) : ((i < home) || (home <= j));
+                if (homeInGap)
+                    continue;
+                maSlots[i] = other;
+                i = j;
             }
-
-            EntryPtr = &(Entry->next);
-            Entry = *EntryPtr;
+            maSlots[i] = nullptr;
+            --mCount;
         }
 
-        POV_PARSER_PANIC();
+        Destroy_Entry(Entry);
     }
 }
 
@@ -515,31 +549,57 @@ template<typename T> void SymbolTable::DeleteData(void* data)
 
 //------------------------------------------------------------------------------
 
-SYM_ENTRY* SymbolTable::Find_Symbol(const char* Name, int hash) const
+SYM_ENTRY* SymbolTable::Find_Symbol(const char* name, size_t length, SymbolHash hash) const
 {
-    SYM_ENTRY* Entry = mapHashTable[hash];
-
-    while (Entry)
+    if (maSlots.empty())
     {
-        if (strcmp(Name, Entry->name.c_str()) == 0)
-            return Entry;
+        if (mpStatistics != nullptr)
+            ++mpStatistics->lookups;
+        return nullptr;
+    }
+    return maSlots[FindSlot(name, length, hash)];
+}
 
-        Entry = Entry->next;
+size_t SymbolTable::FindSlot(const char* name, size_t length, SymbolHash hash) const
+{
+    POV_PARSER_ASSERT(!maSlots.empty());
+
+    size_t mask = maSlots.size() - 1;
+    size_t i = hash & mask;
+    POV_ULONG probes = 1;
+    for (;;)
+    {
+        const SYM_ENTRY* entry = maSlots[i];
+        if ((entry == nullptr) ||
+            ((entry->hash == hash) && (entry->name.size() == length) && (std::memcmp(entry->name.data(), name, length) == 0)))
+            break;
+        i = (i + 1) & mask;
+        ++probes;
     }
 
-    return Entry;
+    if (mpStatistics != nullptr)
+    {
+        ++mpStatistics->lookups;
+        mpStatistics->probes += probes;
+    }
+    return i;
 }
 
-int SymbolTable::get_hash_value(const char *s)
+void SymbolTable::Grow()
 {
-    unsigned int i = 0;
+    std::vector<SYM_ENTRY*> oldSlots(std::max(size_t(16), maSlots.size() * 2), nullptr);
+    maSlots.swap(oldSlots);
 
-    while (*s)
+    size_t mask = maSlots.size() - 1;
+    for (auto entry : oldSlots)
     {
-        i = (i << 1) ^ *s++;
+        if (entry == nullptr)
+            continue;
+        size_t i = entry->hash & mask;
+        while (maSlots[i] != nullptr)
+            i = (i + 1) & mask;
+        maSlots[i] = entry;
     }
-
-    return((int)(i % SYM_TABLE_SIZE));
 }
 
 //******************************************************************************
@@ -593,16 +653,36 @@ SYM_ENTRY *SymbolStack::Add_Symbol(int Index, const UTF8String& Name, TokenId Nu
 
 SYM_ENTRY* SymbolStack::Find_Symbol(int index, const char* name)
 {
-    return Tables[index]->Find_Symbol(name, SymbolTable::get_hash_value(name));
+    return Tables[index]->Find_Symbol(name);
 }
 
 SYM_ENTRY* SymbolStack::Find_Symbol(const char* name, int* pIndex)
 {
+    size_t length = std::strlen(name);
+    SYM_ENTRY *entry;
+    SymbolHash hash = GetSymbolHash(name, length);
+    for (int index = Table_Index; index >= SYM_TABLE_GLOBAL; --index)
+    {
+        entry = Tables[index]->Find_Symbol(name, length, hash);
+        if (entry)
+        {
+            if (pIndex != nullptr)
+                *pIndex = index;
+            return entry;
+        }
+    }
+    if (pIndex != nullptr)
+        *pIndex = -1;
+    return nullptr;
+}
+
+SYM_ENTRY* SymbolStack::Find_Symbol(const UTF8String& name, SymbolHash hash, int* pIndex)
+{
+    POV_PARSER_ASSERT(hash == GetSymbolHash(name));
     SYM_ENTRY *entry;
-    int hash = SymbolTable::get_hash_value(name);
     for (int index = Table_Index; index >= SYM_TABLE_GLOBAL; --index)
     {
-        entry = Tables[index]->Find_Symbol(name, hash);
+        entry = Tables[index]->Find_Symbol(name.data(), name.size(), hash);
         if (entry)
         {
             if (pIndex != nullptr)
@@ -646,7 +726,7 @@ void SymbolStack::PushTable()
         throw POV_EXCEPTION_STRING("Too many nested symbol tables");
     }
 
-    Tables[Table_Index] = new SymbolTable();
+    Tables[Table_Index] = new SymbolTable(&mStatistics);
 }
 
 void SymbolStack::PopTable()
@@ -44,6 +44,7 @@
 
 // C++ standard header files
 #include <memory>
+#include <vector>
 
 // POV-Ray header files (base module)
 #include "base/stringtypes.h"
@@ -63,7 +64,6 @@ using namespace pov_base;
 //------------------------------------------------------------------------------
 
 const int MAX_NUMBER_OF_TABLES = 100;
-const int SYM_TABLE_SIZE = 257;
 
 typedef unsigned short SymTableEntryRefCount;
 
@@ -76,8 +76,9 @@ enum
 /// Structure holding information about a symbol
 struct Sym_Table_Entry final
 {
-    Sym_Table_Entry *next;      ///< Reference to next symbol with same hash
+    Sym_Table_Entry *next;      ///< Reference to next (shadowed) symbol with same name
     UTF8String name;            ///< Symbol name
+    SymbolHash hash;            ///< Hash value of the symbol name
     char *Deprecation_Message;  ///< Warning to print if the symbol is deprecated
     void *Data;                 ///< Reference to the symbol value
     TokenId Token_Number;       ///< Unique ID of this symbol
@@ -90,9 +91,26 @@ using SYM_ENTRY = Sym_Table_Entry; ///< @deprecated
 
 //------------------------------------------------------------------------------
 
+/// Structure holding symbol table usage statistics.
+struct SymbolTableStatistics final
+{
+    POV_ULONG lookups;  ///< Number of symbol lookups.
+    POV_ULONG probes;   ///< Number of table slots inspected during lookups.
+    SymbolTableStatistics() : lookups(0), probes(0) {}
+};
+
+//------------------------------------------------------------------------------
+
+/// Symbol table of a single scope (or dictionary).
+///
+/// Symbols are kept in an open-addressing hash table with linear probing,
+/// which grows as needed to keep the load factor at or below 1/2. Symbols
+/// added with the name of a symbol already in the table shadow the existing
+/// symbol until removed again.
+///
 struct SymbolTable final
 {
-    SymbolTable();
+    SymbolTable(SymbolTableStatistics* pStatistics = nullptr);
     SymbolTable(const SymbolTable& obj);
     ~SymbolTable();
 
@@ -112,8 +130,15 @@ struct SymbolTable final
     void Add_Entry(SYM_ENTRY *Table_Entry);
     SYM_ENTRY *Add_Symbol(const UTF8String& Name, TokenId Number);
     SYM_ENTRY* Find_Symbol(const char* s) const;
+    SYM_ENTRY* Find_Symbol(const UTF8String& name, SymbolHash hash) const;
     void Remove_Symbol(const char *Name, bool is_array_elem, void **DataPtr, int ttype);
 
+    /// Number of distinct symbol names in the table.
+    size_t GetSymbolCount() const { return mCount; }
+
+    /// Number of slots in the table.
+    size_t GetCapacity() const { return maSlots.size(); }
+
     static void Acquire_Entry_Reference(SYM_ENTRY *Entry);
     static void Release_Entry_Reference(SYM_ENTRY *Entry);
 
@@ -123,14 +148,18 @@ protected:
     template<typename T> static void* CloneData(const void*);
     template<typename T> static void DeleteData(void*);
 
-    SYM_ENTRY* Find_Symbol(const char* s, int hash) const;
-    static int get_hash_value(const char *s);
+    SYM_ENTRY* Find_Symbol(const char* s, size_t length, SymbolHash hash) const;
 
     friend class SymbolStack;
 
 private:
 
-    SYM_ENTRY* mapHashTable[SYM_TABLE_SIZE];
+    std::vector<SYM_ENTRY*> maSlots;        ///< Hash table slots; size is zero or a power of two.
+    size_t                  mCount;         ///< Number of occupied slots.
+    SymbolTableStatistics*  mpStatistics;   ///< Where to count lookups, if anywhere.
+
+    size_t FindSlot(const char* s, size_t length, SymbolHash hash) const;
+    void Grow();
 };
 
 using SymbolTablePtr = std::shared_ptr<SymbolTable>;
@@ -158,6 +187,7 @@ public:
     SYM_ENTRY *Add_Symbol(int Index, const UTF8String& Name, TokenId Number);
     SYM_ENTRY* Find_Symbol(int index, const char* s);
     SYM_ENTRY* Find_Symbol(const char* s, int* pIndex = nullptr);
+    SYM_ENTRY* Find_Symbol(const UTF8String& name, SymbolHash hash, int* pIndex = nullptr);
     void Remove_Symbol(int Index, const char *Name, bool is_array_elem, void **DataPtr, int ttype);
 
     //------------------------------------------------------------------------------
@@ -174,10 +204,14 @@ public:
     /// Remove the most local symbol table.
     void PopTable();
 
+    /// Get the usage statistics shared by the scope and dictionary symbol tables.
+    SymbolTableStatistics* GetStatistics() { return &mStatistics; }
+
 protected:
 
     SymbolTable* Tables[MAX_NUMBER_OF_TABLES];
     int Table_Index;
+    SymbolTableStatistics mStatistics;
 };
 
 }
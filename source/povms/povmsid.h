@@ -148,6 +148,7 @@ enum
     kPOVObjectClass_ElapsedTime         = 'ETim',
 
     kPOVObjectClass_IsectStat           = 'ISta',
+    kPOVObjectClass_ObjectProfile       = 'OPrf',
     kPOVObjectClass_SceneCamera         = 'SCam',
 
     kPOVObjectClass_ShellCommand        = 'SCmd',
@@ -184,6 +185,7 @@ enum
     kPOVMsgClass_ViewOutput          = 'VOut',
     kPOVMsgClass_ViewImage           = 'VImg',
     kPOVMsgClass_FileAccess          = 'FAcc',
+    kPOVMsgClass_RenderNode          = 'RNCt',
 };
 
 // POV-Ray Message Identifiers
@@ -236,6 +238,10 @@ enum
     kPOVMsgIdent_ReadFile            = 'ReaF',
     kPOVMsgIdent_CreatedFile         = 'CreF',
 
+    // RenderNode
+    kPOVMsgIdent_RenderJob           = 'RJob',
+    kPOVMsgIdent_RenderBlock         = 'RBlk',
+
     // all
     kPOVMsgIdent_Done                = 'Done',
     kPOVMsgIdent_Failed              = 'Fail',
@@ -294,6 +300,7 @@ enum
 
     kPOVAttrib_ContinueTrace         = 'ConT',
     kPOVAttrib_BackupTrace           = 'BacT',
+    kPOVAttrib_BackupCheckpoint      = 'BaCI', ///< (Int) Seconds between checkpoints of the render state file, or 0 to only log.
 
     kPOVAttrib_Verbose               = 'Verb',
     kPOVAttrib_DebugConsole          = 'DCon',
@@ -334,6 +341,8 @@ enum
     kPOVAttrib_FieldRender           = 'FldR', // currently not supported by code
     kPOVAttrib_OddField              = 'OddF', // currently not supported by code
     kPOVAttrib_FrameStep             = 'FStp',
+    kPOVAttrib_PipelineAnimation     = 'PiAn',
+    kPOVAttrib_PipelineMemoryLimit   = 'PiML',
 
     kPOVAttrib_OutputToFile          = 'OToF',
     kPOVAttrib_OutputFileType        = 'OFTy',
@@ -344,10 +353,10 @@ enum
     kPOVAttrib_OutputPath            = 'OPat',
     kPOVAttrib_Compression           = 'OFCo',
 
-    kPOVAttrib_HistogramFileType     = 'HFTy', // currently not supported by code
-    kPOVAttrib_HistogramFile         = 'HFNa', // currently not supported by code
-    kPOVAttrib_HistogramGridSizeX    = 'HGSX', // currently not supported by code
-    kPOVAttrib_HistogramGridSizeY    = 'HGSY', // currently not supported by code
+    kPOVAttrib_HistogramFileType     = 'HFTy',
+    kPOVAttrib_HistogramFile         = 'HFNa',
+    kPOVAttrib_HistogramGridSizeX    = 'HGSX',
+    kPOVAttrib_HistogramGridSizeY    = 'HGSY',
 
     kPOVAttrib_PreSceneCommand       = 'PrSC',
     kPOVAttrib_PreFrameCommand       = 'PrFC',
@@ -365,12 +374,15 @@ enum
     // options handled by scene/parser
     kPOVAttrib_InputFile             = 'IFNa',
     kPOVAttrib_IncludeHeader         = 'IncH',
+    kPOVAttrib_IncludeCachePath      = 'IncC', ///< (UCS2String) Directory of the persistent include cache; include files containing any non-ASCII byte are never cached.
 
     kPOVAttrib_WarningLevel          = 'WLev',
     kPOVAttrib_Declare               = 'Decl',
     kPOVAttrib_Clock                 = 'Clck',
     kPOVAttrib_ClocklessAnimation    = 'Ckla',
     kPOVAttrib_RealTimeRaytracing    = 'RTRa',
+    kPOVAttrib_ReuseScene            = 'ReuS',
+    kPOVAttrib_ReuseSceneCount       = 'ReuC',
     kPOVAttrib_Version               = 'Vers',
 
     // options handled by view/renderer
@@ -394,6 +406,17 @@ enum
     kPOVAttrib_Quality               = 'Qual',
     kPOVAttrib_HighReproducibility   = 'HRep',
     kPOVAttrib_StochasticSeed        = 'Seed',
+    kPOVAttrib_AntialiasTimeBudget   = 'AATB',
+    kPOVAttrib_ConvergenceMap        = 'CvgM',
+    kPOVAttrib_ProgressiveRefinement = 'PgRf',
+    kPOVAttrib_ProgressiveOutputInterval = 'PgOI',
+    kPOVAttrib_Denoise               = 'Dnoi',
+    kPOVAttrib_DenoiseStrength       = 'DnSt',
+    kPOVAttrib_ProfileObjects        = 'PrfO',
+    kPOVAttrib_TimelineFile          = 'TlFi',
+    kPOVAttrib_MetricsFile           = 'MtFi',
+    kPOVAttrib_MetricsFormat         = 'MtFo',
+    kPOVAttrib_MetricsInterval       = 'MtIv',
 
     kPOVAttrib_Bounding              = 'Boun',
     kPOVAttrib_BoundingMethod        = 'BdMe',
@@ -408,12 +431,13 @@ enum
     kPOVAttrib_RemoveBounds          = 'RmBd',
     kPOVAttrib_SplitUnions           = 'SplU',
 
-    kPOVAttrib_CreateHistogram       = 'CHis', // currently not supported by code
+    kPOVAttrib_CreateHistogram       = 'CHis',
     kPOVAttrib_DrawVistas            = 'DrVi', // currently not supported by code
 
     kPOVAttrib_PreviewStartSize      = 'PStS',
     kPOVAttrib_PreviewEndSize        = 'PEnS',
 
+    kPOVAttrib_RadiosityBinaryFile   = 'RaBF',
     kPOVAttrib_RadiosityFileName     = 'RaFN',
     kPOVAttrib_RadiosityFromFile     = 'RaFF',
     kPOVAttrib_RadiosityToFile       = 'RaTF',
@@ -421,6 +445,20 @@ enum
 
     kPOVAttrib_RenderBlockSize       = 'RBSi',
 
+    kPOVAttrib_RenderNodes           = 'RNod',
+    kPOVAttrib_RenderNodeJob         = 'RNoJ', ///< (Int) ID of the render node job a render belongs to; set by the node itself.
+    kPOVAttrib_RenderNodeOptions     = 'RNOp', ///< (Object) Render options of a render node job.
+    kPOVAttrib_RenderNodeFiles       = 'RNFi', ///< (List) Input files of a render node job.
+    kPOVAttrib_RenderNodeFileSize    = 'RNFS', ///< (Long) Size of a render node job input file.
+    kPOVAttrib_RenderNodeBlock       = 'RNBl', ///< (Int) Serial number of a block rendered by a render node.
+    kPOVAttrib_RenderNodeTimeout     = 'RNTo', ///< (Int) Seconds to wait for a render node to deliver a block.
+    kPOVAttrib_RenderNodeToken       = 'RNTk', ///< (CString) Token to present to render nodes.
+
+    kPOVAttrib_SharedFramebuffer     = 'ShFb',
+    kPOVAttrib_SharedFramebufferFile = 'ShFN', ///< (UCS2String) File backing the shared framebuffer; set by the frontend.
+
+    kPOVAttrib_TiledOutput           = 'TilO', ///< (Bool) Write the output image tile by tile as blocks complete.
+
     kPOVAttrib_MaxImageBufferMem     = 'MIBM', // [JG] for file backed image
 
     kPOVAttrib_CameraIndex           = 'CIdx',
@@ -450,6 +488,18 @@ enum
     kPOVAttrib_InfiniteObjects       = 'InOb',
     kPOVAttrib_LightSources          = 'LiSo',
     kPOVAttrib_Cameras               = 'Cama',
+    kPOVAttrib_IncludeCacheHits      = 'ICHi',
+    kPOVAttrib_IncludeCacheMisses    = 'ICMi',
+    kPOVAttrib_SymbolLookups         = 'SyLo',
+    kPOVAttrib_SymbolProbes          = 'SyPr',
+    kPOVAttrib_GlobalSymbols         = 'SyGl',
+    kPOVAttrib_GlobalSymbolSlots     = 'SyGS',
+    kPOVAttrib_ReadFiles             = 'RdFi', ///< (UCS2String List) Local files read while parsing.
+    kPOVAttrib_ReadFileSizes         = 'RdFS', ///< (Long Vector) Sizes of the @ref kPOVAttrib_ReadFiles when they were opened.
+    kPOVAttrib_ReadFileTimes         = 'RdFT', ///< (Long Vector) Modification times of the @ref kPOVAttrib_ReadFiles when they were opened.
+    kPOVAttrib_SceneMemoryBlocks     = 'SMBl', ///< (Long Vector) Number of blocks of scene data allocated, per category.
+    kPOVAttrib_SceneMemoryBytes      = 'SMBy', ///< (Long Vector) Bytes of scene data allocated, per category.
+    kPOVAttrib_SceneMemoryReserved   = 'SMRe', ///< (Long) Bytes reserved for the scene data arena.
 
     // statistics generated by scene/bounding
     kPOVAttrib_BSPNodes              = 'BNod',
@@ -582,6 +632,11 @@ enum
     kPOVAttrib_ISectsTests           = 'ITst',
     kPOVAttrib_ISectsSucceeded       = 'ISuc',
 
+    kPOVAttrib_ObjectProfile         = 'OPrf',
+    kPOVAttrib_ObjectProfileCount    = 'OPrC',
+    kPOVAttrib_ObjectProfileTime     = 'OPrT',
+    kPOVAttrib_ObjectProfileTotal    = 'OPrA',
+
     kPOVAttrib_MinAlloc              = 'MinA',
     kPOVAttrib_MaxAlloc              = 'MaxA',
     kPOVAttrib_CallsToAlloc          = 'CTAl',
@@ -622,6 +677,9 @@ enum
     kPOVAttrib_PixelPositions        = 'PPos',
     kPOVAttrib_PixelSkipList         = 'PSLi',
     kPOVAttrib_PixelFinal            = 'PFin',  ///< (Void) Set if pixel data is relevant for final image.
+    kPOVAttrib_PixelConvergence      = 'PCvg',  ///< (FloatVector) Samples, noise estimate and convergence flag per pixel.
+    kPOVAttrib_PixelAuxiliary        = 'PAux',  ///< (FloatVector) Albedo (RGB), normal (XYZ) and depth per pixel.
+    kPOVAttrib_PixelCost             = 'PCst',  ///< (FloatVector) Render time (in microseconds), rays and samples per pixel.
 
     // scene/view error reporting and TBD
     kPOVAttrib_CurrentLine           = 'CurL',
@@ -666,6 +724,13 @@ enum
     kPOVList_FileType_RadianceHDR,
     kPOVList_FileType_System,
     kPOVList_FileType_CSV, // used for histogram file
+    kPOVList_FileType_PFM, // used for histogram file
+};
+
+enum
+{
+    kPOVList_MetricsFormat_JSONLines,
+    kPOVList_MetricsFormat_Prometheus,
 };
 
 #endif // POVMSID_H
@@ -0,0 +1,20 @@
+// Persistence Of Vision Ray Tracer Scene Description File
+// Benchmark: bounding hierarchy traversal.
+//
+// Tens of thousands of small objects, most rays passing close to many of them.
+
+#version 3.8;
+
+#declare BenchCameraLocation = <0, 0, -22>;
+#declare BenchCameraLookAt   = <0, 0, 0>;
+#include "common.inc"
+
+#declare R = seed(1234);
+#declare I = 0;
+#while (I < 40000)
+    sphere {
+        <rand(R) - 0.5, rand(R) - 0.5, rand(R) - 0.5> * 20, 0.05 + 0.05*rand(R)
+        pigment { rgb <rand(R), rand(R), rand(R)> }
+    }
+    #declare I = I + 1;
+#end
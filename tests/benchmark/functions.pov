@@ -0,0 +1,32 @@
+// Persistence Of Vision Ray Tracer Scene Description File
+// Benchmark: function VM.
+//
+// Isosurfaces and function-based pigments, all evaluated by the function VM.
+
+#version 3.8;
+
+#include "common.inc"
+#include "functions.inc"
+
+#declare BenchBlobby = function(x, y, z) {
+    f_sphere(x, y, z, 1.6) - f_noise3d(x*3, y*3, z*3)*0.6 + 0.1*sin(x*8)*cos(z*8)
+}
+
+isosurface {
+    function { BenchBlobby(x, y, z) }
+    contained_by { box { -2.2, 2.2 } }
+    max_gradient 6
+    pigment { function { abs(sin(x*4) * cos(y*4) * sin(z*4)) } color_map { [0 rgb <0.9, 0.5, 0.2>] [1 rgb <0.2, 0.4, 0.9>] } }
+    translate <-3, 2.2, 0>
+}
+
+isosurface {
+    function { f_torus(x, y, z, 1.3, 0.5) + f_noise3d(x*5, y*5, z*5)*0.25 }
+    contained_by { box { <-2, -1, -2>, <2, 1, 2> } }
+    max_gradient 4
+    pigment { function { f_granite(x, y, z) } color_map { [0 rgb 0.2] [1 rgb 0.9] } }
+    rotate -30*x
+    translate <3, 1.8, 0>
+}
+
+plane { y, 0 pigment { function { f_ridged_mf(x/4, 0, z/4, 0.5, 2, 6, 1, 2, 1) } color_map { [0 rgb 0.3] [1 rgb 0.8] } } }
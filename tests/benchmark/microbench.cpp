@@ -0,0 +1,422 @@
+//******************************************************************************
+///
+/// @file tests/benchmark/microbench.cpp
+///
+/// Micro-benchmarks for individual hot subsystems of POV-Ray.
+///
+/// Each benchmark calls one low-level function (polynomial solver, noise,
+/// function VM and so forth) over a fixed set of pseudo-random inputs, and
+/// reports the time per call in nanoseconds. The results are written to
+/// standard output as JSON, for `povbench.py` to pick up via its `--micro`
+/// option.
+///
+/// @copyright
+/// @parblock
+///
+/// Persistence of Vision Ray Tracer ('POV-Ray') version 3.8.
+/// Copyright 1991-2019 Persistence of Vision Raytracer Pty. Ltd.
+///
+/// POV-Ray is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU Affero General Public License as
+/// published by the Free Software Foundation, either version 3 of the
+/// License, or (at your option) any later version.
+///
+/// POV-Ray is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU Affero General Public License for more details.
+///
+/// You should have received a copy of the GNU Affero General Public License
+/// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+///
+/// ----------------------------------------------------------------------------
+///
+/// POV-Ray is based on the popular DKB raytracer version 2.12.
+/// DKBTrace was originally written by David K. Buck.
+/// DKBTrace Ver 2.0-2.12 were written by David K. Buck & Aaron A. Collins.
+///
+/// @endparblock
+///
+//******************************************************************************
+
+// configvm.h must always be the first POV file included, and pulls in the core
+// configuration as well
+#include "vm/configvm.h"
+
+// C++ variants of C standard header files
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// C++ standard header files
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// POV-Ray header files (core module)
+#include "core/material/noise.h"
+#include "core/material/pigment.h"
+#include "core/material/texture.h"
+#include "core/material/warp.h"
+#include "core/math/matrix.h"
+#include "core/math/polynomialsolver.h"
+#include "core/scene/scenedata.h"
+#include "core/scene/tracethreaddata.h"
+#include "core/shape/sphere.h"
+#include "core/support/scenearena.h"
+#include "core/support/statistics.h"
+
+// POV-Ray header files (VM module)
+#include "vm/fnpovfpu.h"
+
+// this must be the last file included
+#include "base/povdebug.h"
+
+using namespace pov;
+
+namespace
+{
+
+/// Number of distinct inputs each benchmark cycles through.
+const size_t kInputCount = 1024;
+
+/// Sink for benchmark results, to keep the compiler from optimizing the calls away.
+volatile DBL gSink;
+
+std::vector<Vector3d> RandomPoints(DBL range, unsigned int seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<DBL> distribution(-range, range);
+    std::vector<Vector3d> points(kInputCount);
+    for (auto& p : points)
+        p = Vector3d(distribution(generator), distribution(generator), distribution(generator));
+    return points;
+}
+
+/// Get coefficients of polynomials of the given (even) order, each being a
+/// product of quadratic factors with either two real or two complex roots,
+/// as is typical of ray/surface intersections.
+std::vector<DBL> RandomPolynomials(int order, unsigned int seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<DBL> distribution(0.1, 10.0);
+    std::vector<DBL> coefficients(kInputCount * (order + 1));
+    for (size_t i = 0; i < kInputCount; ++i)
+    {
+        DBL* c = &coefficients[i * (order + 1)];
+        c[0] = 1.0;
+        for (int n = 1; n <= order; ++n)
+            c[n] = 0.0;
+        for (int n = 0; n < order; n += 2)
+        {
+            // x^2 + b x + a, with real roots half of the time
+            DBL p = distribution(generator);
+            DBL q = distribution(generator);
+            DBL b = (generator() & 1) ? -(p + q) : -p;
+            DBL a = (generator() & 1) ? p * q : (p * p + q * q) / 4.0;
+            for (int k = n + 2; k >= 2; --k)
+                c[k] += b * c[k - 1] + a * c[k - 2];
+            c[1] += b * c[0];
+        }
+    }
+    return coefficients;
+}
+
+class MicroBenchmark
+{
+    public:
+        MicroBenchmark(const char* name) : mName(name) {}
+        virtual ~MicroBenchmark() {}
+        const char* Name() const { return mName; }
+        /// Run the benchmarked function the given number of times.
+        virtual void Run(size_t iterations) = 0;
+    private:
+        const char* mName;
+};
+
+class PolynomialBenchmark final : public MicroBenchmark
+{
+    public:
+        PolynomialBenchmark(const char* name, int order, bool sturm) :
+            MicroBenchmark(name), mOrder(order), mSturm(sturm), mCoefficients(RandomPolynomials(order, 1))
+        {}
+        virtual void Run(size_t iterations) override
+        {
+            DBL roots[MAX_ORDER];
+            DBL sum = 0.0;
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                const DBL* c = &mCoefficients[(i % kInputCount) * (mOrder + 1)];
+                int count = Solve_Polynomial(mOrder, c, roots, mSturm, 1.0e-10, mStats);
+                if (count > 0)
+                    sum += roots[0];
+            }
+            gSink = sum;
+        }
+    private:
+        int mOrder;
+        bool mSturm;
+        std::vector<DBL> mCoefficients;
+        RenderStatistics mStats;
+};
+
+class NoiseBenchmark final : public MicroBenchmark
+{
+    public:
+        NoiseBenchmark(const char* name, int generator) :
+            MicroBenchmark(name), mGenerator(generator), mPoints(RandomPoints(100.0, 2))
+        {}
+        virtual void Run(size_t iterations) override
+        {
+            DBL sum = 0.0;
+            for (size_t i = 0; i < iterations; ++i)
+                sum += Noise(mPoints[i % kInputCount], mGenerator);
+            gSink = sum;
+        }
+    private:
+        int mGenerator;
+        std::vector<Vector3d> mPoints;
+};
+
+class DNoiseBenchmark final : public MicroBenchmark
+{
+    public:
+        DNoiseBenchmark(const char* name) :
+            MicroBenchmark(name), mPoints(RandomPoints(100.0, 3))
+        {}
+        virtual void Run(size_t iterations) override
+        {
+            Vector3d result;
+            DBL sum = 0.0;
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                DNoise(result, mPoints[i % kInputCount]);
+                sum += result.x();
+            }
+            gSink = sum;
+        }
+    private:
+        std::vector<Vector3d> mPoints;
+};
+
+class TurbulenceBenchmark final : public MicroBenchmark
+{
+    public:
+        TurbulenceBenchmark(const char* name) :
+            MicroBenchmark(name), mPoints(RandomPoints(100.0, 4))
+        {}
+        virtual void Run(size_t iterations) override
+        {
+            DBL sum = 0.0;
+            for (size_t i = 0; i < iterations; ++i)
+                sum += Turbulence(mPoints[i % kInputCount], &mWarp, kNoiseGen_RangeCorrected);
+            gSink = sum;
+        }
+    private:
+        std::vector<Vector3d> mPoints;
+        TurbulenceWarp mWarp;
+};
+
+/// Evaluates `sqrt(x*x + y*y + z*z) - 1 + 0.25*sin(8*x)`, hand-assembled the
+/// way the function compiler would translate it.
+class FunctionVMBenchmark final : public MicroBenchmark
+{
+    public:
+        FunctionVMBenchmark(const char* name) :
+            MicroBenchmark(name), mPoints(RandomPoints(2.0, 5)),
+            mpVm(new FunctionVM()), mpSceneData(new SceneData()), mThreadData(mpSceneData, 0)
+        {
+            const Instruction program[] = {
+                MAKE_INSTRUCTION(OPCODE_LOAD | (1 << 3) | 1, 0),                        // load  SP(0), R1
+                MAKE_INSTRUCTION(OPCODE_MOVE | (1 << 3) | 0, 0),                        // move  R1, R0
+                MAKE_INSTRUCTION(OPCODE_MUL  | (1 << 3) | 0, 0),                        // mul   R1, R0
+                MAKE_INSTRUCTION(OPCODE_LOAD | (1 << 3) | 2, 1),                        // load  SP(1), R2
+                MAKE_INSTRUCTION(OPCODE_MUL  | (2 << 3) | 2, 0),                        // mul   R2, R2
+                MAKE_INSTRUCTION(OPCODE_ADD  | (2 << 3) | 0, 0),                        // add   R2, R0
+                MAKE_INSTRUCTION(OPCODE_LOAD | (1 << 3) | 2, 2),                        // load  SP(2), R2
+                MAKE_INSTRUCTION(OPCODE_MUL  | (2 << 3) | 2, 0),                        // mul   R2, R2
+                MAKE_INSTRUCTION(OPCODE_ADD  | (2 << 3) | 0, 0),                        // add   R2, R0
+                MAKE_INSTRUCTION(OPCODE_SYS1, TRAP_SYS1_SQRT),                          // sys1  sqrt
+                MAKE_INSTRUCTION(OPCODE_MOVE | (0 << 3) | 3, 0),                        // move  R0, R3
+                MAKE_INSTRUCTION(OPCODE_MOVE | (1 << 3) | 0, 0),                        // move  R1, R0
+                MAKE_INSTRUCTION(OPCODE_MULI | 0, mpVm->AddConstant(8.0)),              // muli  8, R0
+                MAKE_INSTRUCTION(OPCODE_SYS1, TRAP_SYS1_SIN),                           // sys1  sin
+                MAKE_INSTRUCTION(OPCODE_MULI | 0, mpVm->AddConstant(0.25)),             // muli  0.25, R0
+                MAKE_INSTRUCTION(OPCODE_ADD  | (3 << 3) | 0, 0),                        // add   R3, R0
+                MAKE_INSTRUCTION(OPCODE_SUBI | 0, mpVm->AddConstant(1.0)),              // subi  1, R0
+                MAKE_INSTRUCTION(OPCODE_RTS, 0),                                        // rts
+            };
+
+            FunctionCode code = FunctionCode();
+            code.program_size = sizeof(program) / sizeof(program[0]);
+            code.program = reinterpret_cast<Instruction*>(POV_MALLOC(sizeof(program), "fn: program"));
+            std::memcpy(code.program, program, sizeof(program));
+            code.return_size = 1;
+            code.parameter_cnt = 3;
+            mFunction = mpVm->AddFunction(&code);
+            mpContext.reset(new FPUContext(mpVm.get(), &mThreadData));
+        }
+        virtual ~FunctionVMBenchmark() override
+        {
+            mpContext.reset();
+            mpVm->RemoveFunction(mFunction);
+        }
+        virtual void Run(size_t iterations) override
+        {
+            DBL sum = 0.0;
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                const Vector3d& p = mPoints[i % kInputCount];
+                mpContext->SetLocal(0, p.x());
+                mpContext->SetLocal(1, p.y());
+                mpContext->SetLocal(2, p.z());
+                sum += POVFPU_Run(mpContext.get(), mFunction);
+            }
+            gSink = sum;
+        }
+    private:
+        std::vector<Vector3d> mPoints;
+        boost::intrusive_ptr<FunctionVM> mpVm;
+        std::shared_ptr<SceneData> mpSceneData;
+        TraceThreadData mThreadData;
+        std::unique_ptr<FPUContext> mpContext;
+        FUNCTION mFunction;
+};
+
+/// Creates and destroys scene data the way a scene does, in batches of
+/// @ref kInputCount textured and transformed spheres: all are created first,
+/// then all are destroyed. One call comprises one sphere, its texture, pigment
+/// and finish, and a transformation.
+class SceneDataBenchmark final : public MicroBenchmark
+{
+    public:
+        SceneDataBenchmark(const char* name, bool arena) :
+            MicroBenchmark(name), mArena(arena), mObjects(kInputCount), mTransforms(kInputCount)
+        {}
+        virtual void Run(size_t iterations) override
+        {
+            for (size_t done = 0; done < iterations; done += kInputCount)
+            {
+                size_t count = std::min(kInputCount, iterations - done);
+                std::unique_ptr<SceneArena> arena(mArena ? new SceneArena() : nullptr);
+                SceneArena::Scope arenaScope(arena.get());
+                for (size_t i = 0; i < count; ++i)
+                {
+                    mObjects[i] = new Sphere();
+                    mObjects[i]->Texture = Create_Texture();
+                    mObjects[i]->Texture->Pigment = Create_Pigment();
+                    mObjects[i]->Texture->Finish = Create_Finish();
+                    mTransforms[i] = Create_Transform();
+                }
+                for (size_t i = 0; i < count; ++i)
+                {
+                    Destroy_Transform(mTransforms[i]);
+                    Destroy_Object(mObjects[i]);
+                }
+            }
+        }
+    private:
+        bool mArena;
+        std::vector<ObjectPtr> mObjects;
+        std::vector<TRANSFORM*> mTransforms;
+};
+
+/// Time the benchmark once, with enough iterations to take at least the given time.
+/// @return     Time per iteration, in nanoseconds.
+double Measure(MicroBenchmark& benchmark, double minSeconds)
+{
+    typedef std::chrono::steady_clock Clock;
+    size_t iterations = 1000;
+    while (true)
+    {
+        Clock::time_point start = Clock::now();
+        benchmark.Run(iterations);
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (seconds >= minSeconds)
+            return seconds * 1.0e9 / iterations;
+        // aim for a little more than the minimum, so that the next attempt is likely to be the last
+        iterations = (seconds > 0.0) ? size_t(iterations * std::min(100.0, 1.2 * minSeconds / seconds)) + 1 : iterations * 100;
+    }
+}
+
+void Usage(const char* program)
+{
+    std::fprintf(stderr,
+                 "Usage: %s [--repeat N] [--min-time SECONDS] [--benchmark NAME]... [--list]\n"
+                 "Run micro-benchmarks (all, or those named) and write the time per call,\n"
+                 "in nanoseconds, as JSON to standard output.\n",
+                 program);
+}
+
+}
+// end of anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    int repeat = 5;
+    double minTime = 0.2;
+    std::vector<std::string> selected;
+    bool list = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if ((std::strcmp(argv[i], "--repeat") == 0) && (i + 1 < argc))
+            repeat = std::atoi(argv[++i]);
+        else if ((std::strcmp(argv[i], "--min-time") == 0) && (i + 1 < argc))
+            minTime = std::atof(argv[++i]);
+        else if ((std::strcmp(argv[i], "--benchmark") == 0) && (i + 1 < argc))
+            selected.push_back(argv[++i]);
+        else if (std::strcmp(argv[i], "--list") == 0)
+            list = true;
+        else
+        {
+            Usage(argv[0]);
+            return 2;
+        }
+    }
+    if (repeat < 1)
+    {
+        Usage(argv[0]);
+        return 2;
+    }
+
+    // must precede the construction of the benchmarks, some of which depend on it
+    Initialize_Noise();
+
+    std::vector<std::unique_ptr<MicroBenchmark>> benchmarks;
+    benchmarks.emplace_back(new PolynomialBenchmark("polynomial_quartic", 4, false));
+    benchmarks.emplace_back(new PolynomialBenchmark("polynomial_quartic_sturm", 4, true));
+    benchmarks.emplace_back(new PolynomialBenchmark("polynomial_sextic_sturm", 6, true));
+    benchmarks.emplace_back(new NoiseBenchmark("noise", kNoiseGen_RangeCorrected));
+    benchmarks.emplace_back(new NoiseBenchmark("noise_perlin", kNoiseGen_Perlin));
+    benchmarks.emplace_back(new DNoiseBenchmark("dnoise"));
+    benchmarks.emplace_back(new TurbulenceBenchmark("turbulence"));
+    benchmarks.emplace_back(new FunctionVMBenchmark("function_vm"));
+    benchmarks.emplace_back(new SceneDataBenchmark("scene_data_heap", false));
+    benchmarks.emplace_back(new SceneDataBenchmark("scene_data_arena", true));
+
+    std::printf("{\"benchmarks\": {");
+    bool first = true;
+    for (auto& benchmark : benchmarks)
+    {
+        if (!selected.empty() && (std::find(selected.begin(), selected.end(), benchmark->Name()) == selected.end()))
+            continue;
+        std::printf("%s\n  \"%s\": {\"ns_per_op\": [", (first ? "" : ","), benchmark->Name());
+        first = false;
+        if (!list)
+        {
+            Measure(*benchmark, minTime / 4); // warm-up
+            for (int i = 0; i < repeat; ++i)
+                std::printf("%s%.3f", (i == 0 ? "" : ", "), Measure(*benchmark, minTime));
+        }
+        std::printf("]}");
+        std::fflush(stdout);
+    }
+    std::printf("\n}}\n");
+
+    Free_Noise_Tables();
+    return 0;
+}
@@ -0,0 +1,29 @@
+// Persistence Of Vision Ray Tracer Scene Description File
+// Benchmark: noise and turbulence.
+//
+// Every texture lookup evaluates several octaves of turbulence, both for the
+// pigments and the normals.
+
+#version 3.8;
+
+#include "common.inc"
+
+#declare BenchTexture = texture {
+    pigment {
+        bozo
+        turbulence 1.5 octaves 10 lambda 2.5 omega 0.6
+        color_map { [0 rgb <0.9, 0.6, 0.3>] [1 rgb <0.2, 0.3, 0.6>] }
+        scale 0.5
+    }
+    normal { wrinkles 0.6 turbulence 0.8 octaves 8 scale 0.3 }
+}
+
+#declare BenchTexture2 = texture {
+    pigment { granite color_map { [0 rgb 0.2] [1 rgb 0.9] } turbulence 0.5 scale 2 }
+    normal { bumps 0.4 turbulence 1 octaves 8 scale 0.2 }
+}
+
+sphere { <-3.5, 2, 0>, 2 texture { BenchTexture } }
+sphere { < 0.0, 2, 2>, 2 texture { BenchTexture2 } }
+sphere { < 3.5, 2, 0>, 2 texture { BenchTexture } rotate 30*y }
+plane  { y, 0 texture { BenchTexture2 scale 3 } }
@@ -0,0 +1,45 @@
+// Persistence Of Vision Ray Tracer Scene Description File
+// Benchmark: pattern evaluation.
+//
+// A grid of spheres, each textured with a different pattern, including the
+// costlier cell-based ones.
+
+#version 3.8;
+
+#declare BenchCameraLocation = <0, 9, -12>;
+#include "common.inc"
+
+#macro BenchPatternSphere(Pos, Index)
+    sphere {
+        Pos, 1
+        pigment {
+            #switch (Index)
+                #case (0)  agate #break
+                #case (1)  marble turbulence 0.5 #break
+                #case (2)  wood turbulence 0.2 #break
+                #case (3)  spiral1 5 #break
+                #case (4)  onion #break
+                #case (5)  crackle #break
+                #case (6)  crackle form <1, 1, 0> metric 1 #break
+                #case (7)  cells #break
+                #case (8)  leopard #break
+                #case (9)  granite #break
+                #case (10) spherical #break
+                #case (11) gradient <1, 1, 0> #break
+                #case (12) spotted #break
+                #case (13) ripples #break
+                #case (14) quilted #break
+            #end
+            color_map { [0 rgb <0.9, 0.8, 0.2>] [0.5 rgb <0.2, 0.5, 0.9>] [1 rgb <0.9, 0.2, 0.3>] }
+            scale 0.3
+        }
+    }
+#end
+
+#declare I = 0;
+#while (I < 15)
+    BenchPatternSphere(<mod(I, 5)*3 - 6, 1, div(I, 5)*3 - 2>, I)
+    #declare I = I + 1;
+#end
+
+plane { y, 0 pigment { checker rgb 0.4, rgb 0.7 } }
@@ -0,0 +1,37 @@
+// Persistence Of Vision Ray Tracer Scene Description File
+// Benchmark: photon shooting and gathering.
+//
+// Glass and mirror objects casting caustics onto a diffuse floor, sampled by
+// every camera ray hitting it.
+
+#version 3.8;
+
+#include "common.inc"
+
+global_settings {
+    photons {
+        spacing 0.02
+        autostop 0
+        jitter 0.4
+        gather 20, 100
+    }
+}
+
+light_source { <-10, 20, -5> rgb 1.2 photons { refraction on reflection on } }
+
+sphere {
+    <-2, 1.5, 0>, 1.5
+    pigment { rgbf <0.95, 1.0, 0.95, 0.9> }
+    finish { reflection 0.1 specular 0.6 }
+    interior { ior 1.5 }
+    photons { target refraction on reflection on collect off }
+}
+
+torus {
+    1.2, 0.3 rotate 60*x translate <2.5, 1.5, 0>
+    pigment { rgb 0.9 }
+    finish { reflection 0.9 }
+    photons { target reflection on collect off }
+}
+
+plane { y, 0 pigment { rgb 0.8 } }
@@ -0,0 +1,31 @@
+// Persistence Of Vision Ray Tracer Scene Description File
+// Benchmark: polynomial solver.
+//
+// Higher-order algebraic surfaces, each ray requiring a quartic or sextic to
+// be solved.
+
+#version 3.8;
+
+#include "common.inc"
+#include "shapes.inc"
+#include "shapesq.inc"
+
+#declare BenchMaterial = texture { pigment { rgb <0.8, 0.5, 0.4> } finish { specular 0.4 } }
+
+object { Piriform   sturm texture { BenchMaterial } scale 2 rotate -90*z translate <-5, 2, 0> }
+object { Bicorn     texture { BenchMaterial } scale 1.5 translate <-1.5, 1.5, 0> }
+object { Helix      texture { BenchMaterial } translate <1.5, 1.5, 0> }
+torus  { 1.2, 0.4 texture { BenchMaterial } rotate -60*x translate <5, 1.5, 0> }
+
+// sextic
+polynomial {
+    6,
+    xyz(6, 0, 0): 1, xyz(0, 6, 0): 1, xyz(0, 0, 6): 1,
+    xyz(2, 2, 0): -3, xyz(0, 0, 0): -1
+    sturm
+    clipped_by { box { -1.5, 1.5 } }
+    texture { BenchMaterial }
+    translate <0, 1.5, 4>
+}
+
+plane { y, 0 pigment { rgb 0.6 } }
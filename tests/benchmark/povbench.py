@@ -0,0 +1,563 @@
+#!/usr/bin/env python3
+#
+# Persistence of Vision Ray Tracer ('POV-Ray') version 3.8.
+# Copyright 1991-2019 Persistence of Vision Raytracer Pty. Ltd.
+#
+# POV-Ray is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# POV-Ray is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+"""Run the POV-Ray benchmark suite, and compare results between builds.
+
+    povbench.py run --povray path/to/povray --output results.json
+    povbench.py run --povray path/to/povray --micro path/to/microbench --output results.json
+    povbench.py reuse --povray path/to/povray --output reuse.json
+    povbench.py compare baseline.json results.json
+
+Each benchmark of the suite (see suite.txt) is rendered a number of times;
+wall-clock time, peak resident memory (where the platform reports it), the
+duration of each render phase (as recorded via Timeline_File) and the ray
+counts (as recorded via Metrics_File) are collected, and summarized as median,
+mean, standard deviation, minimum and maximum.
+
+With --micro, the micro-benchmarks of individual subsystems (polynomial
+solver, noise, function VM, scene data allocation; see microbench.cpp, built via `make microbench`
+on Unix) are run as well, and reported as benchmarks named `micro_*` with
+the time per call as metric `ns_per_op`.
+
+The reuse command measures what keeping a parsed scene in memory (the
+Reuse_Scene option) saves over parsing it for every render: it starts POV-Ray
+as a render server (Unix only), submits the same job repeatedly, first with
+Reuse_Scene=off and then with Reuse_Scene=on, and reports the time from
+submitting each job to its completion as benchmarks named `reparse_*` and
+`reuse_*`.
+
+The compare command flags any metric whose median has become worse by more
+than a given percentage, beyond the noise observed in either run.
+"""
+
+import argparse
+import json
+import os
+import platform
+import re
+import shlex
+import socket
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_SUITE = os.path.join(SCRIPT_DIR, "suite.txt")
+DEFAULT_INCLUDE = os.path.normpath(os.path.join(SCRIPT_DIR, "..", "..", "distribution", "include"))
+
+RESULT_FORMAT_VERSION = 1
+
+# Render phases, as named in the timeline, and the metric each is reported as.
+PHASES = {
+    "Parse": "parse_seconds",
+    "Bounding": "bounding_seconds",
+    "Photon": "photon_seconds",
+    "Radiosity": "radiosity_seconds",
+    "Trace": "trace_seconds",
+}
+
+# Metrics for which larger values are better; for all others, smaller is better.
+HIGHER_IS_BETTER = {"rays_per_second"}
+
+# Metrics compared by default; each benchmark has one or the other.
+DEFAULT_COMPARE_METRICS = ["wall_seconds", "ns_per_op"]
+
+# Prefix of the names under which micro-benchmarks are reported.
+MICRO_PREFIX = "micro_"
+
+# Benchmark run by the reuse command unless others are specified.
+DEFAULT_REUSE_BENCHMARK = "scene_benchmark"
+
+# Time to wait for a render server to start listening, in seconds.
+SERVER_STARTUP_TIMEOUT = 30.0
+
+
+class Benchmark(object):
+    def __init__(self, name, scene, options):
+        self.name = name
+        self.scene = scene
+        self.options = options
+
+
+def read_suite(path):
+    benchmarks = []
+    base = os.path.dirname(os.path.abspath(path))
+    with open(path) as f:
+        for lineno, line in enumerate(f, 1):
+            line = line.strip()
+            if not line or line.startswith("#"):
+                continue
+            fields = shlex.split(line)
+            if len(fields) < 2:
+                raise SystemExit("%s:%d: expected a name and a scene file" % (path, lineno))
+            if any(b.name == fields[0] for b in benchmarks):
+                raise SystemExit("%s:%d: duplicate benchmark name '%s'" % (path, lineno, fields[0]))
+            benchmarks.append(Benchmark(fields[0], os.path.normpath(os.path.join(base, fields[1])), fields[2:]))
+    return benchmarks
+
+
+def phase_metric(task_name):
+    for prefix, metric in PHASES.items():
+        if task_name.startswith(prefix):
+            return metric
+    return None
+
+
+def read_timeline(path):
+    """Sum up the duration of each render phase, in seconds."""
+    durations = {}
+    with open(path) as f:
+        timeline = json.load(f)
+    for event in timeline.get("traceEvents", []):
+        if event.get("ph") != "X" or event.get("cat") != "phase":
+            continue
+        metric = phase_metric(event["name"])
+        if metric is not None:
+            durations[metric] = durations.get(metric, 0.0) + event["dur"] / 1e6
+    return durations
+
+
+def read_metrics(path):
+    """Get the ray counts from the last sample written, i.e. the one at the end of the render."""
+    last = None
+    with open(path) as f:
+        for line in f:
+            if line.strip():
+                last = json.loads(line)
+    if last is None:
+        return {}
+    result = {"rays": last["rays"]["all"]["total"]}
+    for name in ("shadow", "radiosity", "photon"):
+        result["%s_rays" % name] = last["rays"][name]["total"]
+    if "memory" in last:
+        result["peak_memory_bytes"] = last["memory"]["peak"]
+    return result
+
+
+def run_process(command, cwd):
+    """Run a command to completion.
+
+    Returns its exit code, its output, and its peak resident set size in bytes,
+    or None if the platform cannot tell.
+    """
+    if not hasattr(os, "wait4"):
+        process = subprocess.run(command, cwd=cwd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+        return process.returncode, process.stdout, None
+    # wait for the process ourselves, to get at the resource usage of that particular child
+    process = subprocess.Popen(command, cwd=cwd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    output = process.stdout.read()
+    process.stdout.close()
+    _, status, usage = os.wait4(process.pid, 0)
+    process.returncode = os.WEXITSTATUS(status) if os.WIFEXITED(status) else -os.WTERMSIG(status)
+    # ru_maxrss is in bytes on macOS, but kilobytes elsewhere
+    rss = usage.ru_maxrss * (1 if sys.platform == "darwin" else 1024)
+    return process.returncode, output, rss
+
+
+def run_once(povray, benchmark, threads, include_dirs, workdir):
+    timeline = os.path.join(workdir, "timeline.json")
+    metrics = os.path.join(workdir, "metrics.jsonl")
+    for path in (timeline, metrics):
+        if os.path.exists(path):
+            os.remove(path)
+
+    command = [povray, benchmark.scene, "-D", "-F", "-GA", "+L" + os.path.dirname(benchmark.scene)]
+    command += ["+L" + d for d in include_dirs]
+    command += ["Work_Threads=%d" % threads,
+                "Timeline_File=" + timeline,
+                "Metrics_File=" + metrics,
+                "Metrics_Format=JSONLines",
+                "Metrics_Interval=3600"]
+    command += benchmark.options
+
+    start = time.perf_counter()
+    returncode, output, rss = run_process(command, workdir)
+    wall = time.perf_counter() - start
+    if returncode != 0:
+        output = output.decode(errors="replace")
+        raise RuntimeError("%s failed with exit code %d:\n%s" % (benchmark.name, returncode, output[-2000:]))
+
+    sample = {"wall_seconds": wall}
+    if os.path.exists(timeline):
+        sample.update(read_timeline(timeline))
+    if os.path.exists(metrics):
+        sample.update(read_metrics(metrics))
+    # the metrics file only has the peak of its samples, so prefer the exact figure where available
+    if rss is not None:
+        sample["peak_memory_bytes"] = rss
+    # rays are traced during the photon and radiosity pretrace phases as well as the actual trace
+    render = sum(sample.get(m, 0.0) for m in ("photon_seconds", "radiosity_seconds", "trace_seconds"))
+    if render > 0.0:
+        sample["render_seconds"] = render
+        if sample.get("rays"):
+            sample["rays_per_second"] = sample["rays"] / render
+    return sample
+
+
+def run_micro(microbench, names, repeat):
+    """Run the named micro-benchmarks, returning the samples of each."""
+    command = [microbench, "--repeat", str(repeat)]
+    for name in names:
+        command += ["--benchmark", name]
+    process = subprocess.run(command, stdout=subprocess.PIPE)
+    if process.returncode != 0:
+        raise RuntimeError("%s failed with exit code %d" % (microbench, process.returncode))
+    results = json.loads(process.stdout.decode())["benchmarks"]
+    return dict((name, [{"ns_per_op": value} for value in result["ns_per_op"]]) for name, result in results.items())
+
+
+def list_micro(microbench):
+    process = subprocess.run([microbench, "--list"], stdout=subprocess.PIPE)
+    if process.returncode != 0:
+        raise SystemExit("%s failed with exit code %d" % (microbench, process.returncode))
+    return sorted(json.loads(process.stdout.decode())["benchmarks"])
+
+
+def start_server(povray, workdir):
+    """Start POV-Ray as a render server, returning the process and its socket."""
+    path = os.path.join(workdir, "server.sock")
+    log = open(os.path.join(workdir, "server.log"), "wb")
+    process = subprocess.Popen([povray, "--render-server", path], cwd=workdir, stdout=log, stderr=subprocess.STDOUT)
+    log.close()
+    deadline = time.monotonic() + SERVER_STARTUP_TIMEOUT
+    while not os.path.exists(path):
+        if process.poll() is not None or time.monotonic() > deadline:
+            stop_server(process, None)
+            raise RuntimeError("render server did not start; see %s" % os.path.join(workdir, "server.log"))
+        time.sleep(0.1)
+    return process, path
+
+
+def stop_server(process, path):
+    if path is not None:
+        try:
+            submit(path, "SHUTDOWN", wait=False)
+        except OSError:
+            pass
+    try:
+        process.wait(timeout=60)
+    except subprocess.TimeoutExpired:
+        process.kill()
+        process.wait()
+
+
+def submit(path, line, wait=True):
+    """Send a line to a render server; unless told not to, wait for the reply and return it."""
+    with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as s:
+        s.connect(path)
+        s.sendall(line.encode() + b"\n")
+        if not wait:
+            return None
+        reply = b""
+        while not reply.endswith(b"\n"):
+            chunk = s.recv(4096)
+            if not chunk:
+                break
+            reply += chunk
+    return reply.decode(errors="replace").strip()
+
+
+def run_server_job(path, benchmark, threads, include_dirs, workdir, reuse, extra):
+    timeline = os.path.join(workdir, "timeline.json")
+    if os.path.exists(timeline):
+        os.remove(timeline)
+
+    options = [benchmark.scene, "-F", "-GA", "+L" + os.path.dirname(benchmark.scene)]
+    options += ["+L" + d for d in include_dirs]
+    options += ["Work_Threads=%d" % threads,
+                "Timeline_File=" + timeline,
+                "Reuse_Scene=%s" % ("on" if reuse else "off")]
+    options += benchmark.options + extra
+    if any(re.search(r"\s", o) for o in options):
+        raise RuntimeError("%s: render server jobs cannot have options containing spaces" % benchmark.name)
+
+    start = time.perf_counter()
+    reply = submit(path, " ".join(options))
+    wall = time.perf_counter() - start
+    if reply != "OK":
+        raise RuntimeError("%s failed: %s" % (benchmark.name, reply or "no reply from render server"))
+
+    sample = {"wall_seconds": wall}
+    if os.path.exists(timeline):
+        sample.update(read_timeline(timeline))
+    return sample
+
+
+def summarize(samples):
+    summary = {}
+    for metric in sorted(set(k for s in samples for k in s)):
+        values = [s[metric] for s in samples if metric in s]
+        summary[metric] = {
+            "median": statistics.median(values),
+            "mean": statistics.mean(values),
+            "stdev": statistics.stdev(values) if len(values) > 1 else 0.0,
+            "min": min(values),
+            "max": max(values),
+            "samples": values,
+        }
+    return summary
+
+
+def povray_version(povray):
+    try:
+        process = subprocess.run([povray, "--version"], stdout=subprocess.PIPE, stderr=subprocess.STDOUT, timeout=30)
+    except (OSError, subprocess.TimeoutExpired):
+        return None
+    match = re.search(r"POV-Ray\s+(\S+)", process.stdout.decode(errors="replace"))
+    return match.group(1) if match else None
+
+
+def command_run(args):
+    benchmarks = read_suite(args.suite)
+    microbench = None
+    micro = []
+    if args.micro:
+        microbench = os.path.abspath(args.micro)
+        micro = list_micro(microbench)
+    if args.filter:
+        pattern = re.compile(args.filter)
+        benchmarks = [b for b in benchmarks if pattern.search(b.name)]
+        micro = [m for m in micro if pattern.search(MICRO_PREFIX + m)]
+    if not benchmarks and not micro:
+        raise SystemExit("no benchmarks selected")
+
+    povray = os.path.abspath(args.povray) if os.path.sep in args.povray else args.povray
+    results = {
+        "format": RESULT_FORMAT_VERSION,
+        "povray": povray,
+        "version": povray_version(povray),
+        "host": platform.node(),
+        "platform": platform.platform(),
+        "threads": args.threads,
+        "repeat": args.repeat,
+        "warmup": args.warmup,
+        "timestamp": time.strftime("%Y-%m-%dT%H:%M:%S%z"),
+        "benchmarks": {},
+    }
+
+    failed = False
+    with tempfile.TemporaryDirectory(prefix="povbench-") as workdir:
+        for benchmark in benchmarks:
+            sys.stderr.write("%-24s" % benchmark.name)
+            sys.stderr.flush()
+            samples = []
+            try:
+                for i in range(args.warmup + args.repeat):
+                    sample = run_once(povray, benchmark, args.threads, args.library_path, workdir)
+                    if i >= args.warmup:
+                        samples.append(sample)
+                    sys.stderr.write(".")
+                    sys.stderr.flush()
+            except RuntimeError as e:
+                sys.stderr.write(" FAILED\n%s\n" % e)
+                failed = True
+                continue
+            summary = summarize(samples)
+            results["benchmarks"][benchmark.name] = {
+                "scene": os.path.relpath(benchmark.scene, SCRIPT_DIR),
+                "options": benchmark.options,
+                "metrics": summary,
+            }
+            sys.stderr.write(" %8.3f s\n" % summary["wall_seconds"]["median"])
+
+    if micro:
+        # the micro-benchmark program does its own warm-up
+        sys.stderr.write("%-24s" % "micro-benchmarks")
+        sys.stderr.flush()
+        try:
+            for name, samples in sorted(run_micro(microbench, micro, args.repeat).items()):
+                results["benchmarks"][MICRO_PREFIX + name] = {
+                    "program": os.path.basename(microbench),
+                    "metrics": summarize(samples),
+                }
+            sys.stderr.write(" done\n")
+        except (RuntimeError, ValueError, KeyError) as e:
+            sys.stderr.write(" FAILED\n%s\n" % e)
+            failed = True
+
+    text = json.dumps(results, indent=2, sort_keys=True) + "\n"
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+    return 1 if failed else 0
+
+
+def command_reuse(args):
+    if not hasattr(socket, "AF_UNIX"):
+        raise SystemExit("the reuse benchmark needs the Unix render server")
+    suite = dict((b.name, b) for b in read_suite(args.suite))
+    names = args.benchmark or [DEFAULT_REUSE_BENCHMARK]
+    for name in names:
+        if name not in suite:
+            raise SystemExit("no benchmark named '%s' in %s" % (name, args.suite))
+
+    povray = os.path.abspath(args.povray) if os.path.sep in args.povray else args.povray
+    results = {
+        "format": RESULT_FORMAT_VERSION,
+        "povray": povray,
+        "version": povray_version(povray),
+        "host": platform.node(),
+        "platform": platform.platform(),
+        "threads": args.threads,
+        "repeat": args.repeat,
+        "warmup": args.warmup,
+        "timestamp": time.strftime("%Y-%m-%dT%H:%M:%S%z"),
+        "benchmarks": {},
+    }
+
+    failed = False
+    with tempfile.TemporaryDirectory(prefix="povbench-") as workdir:
+        try:
+            process, path = start_server(povray, workdir)
+        except RuntimeError as e:
+            raise SystemExit(str(e))
+        try:
+            for name in names:
+                benchmark = suite[name]
+                medians = {}
+                # parse every time first, so that no retained scene is around yet
+                for prefix, reuse in (("reparse_", False), ("reuse_", True)):
+                    sys.stderr.write("%-24s" % (prefix + name))
+                    sys.stderr.flush()
+                    samples = []
+                    try:
+                        # the first job with Reuse_Scene=on still has to parse the scene
+                        for i in range(max(args.warmup, 1 if reuse else 0) + args.repeat):
+                            sample = run_server_job(path, benchmark, args.threads, args.library_path, workdir, reuse, args.option)
+                            if i >= max(args.warmup, 1 if reuse else 0):
+                                samples.append(sample)
+                            sys.stderr.write(".")
+                            sys.stderr.flush()
+                    except (RuntimeError, OSError) as e:
+                        sys.stderr.write(" FAILED\n%s\n" % e)
+                        failed = True
+                        break
+                    summary = summarize(samples)
+                    results["benchmarks"][prefix + name] = {
+                        "scene": os.path.relpath(benchmark.scene, SCRIPT_DIR),
+                        "options": benchmark.options + args.option + ["Reuse_Scene=%s" % ("on" if reuse else "off")],
+                        "metrics": summary,
+                    }
+                    medians[prefix] = summary["wall_seconds"]["median"]
+                    sys.stderr.write(" %8.3f s\n" % medians[prefix])
+                if len(medians) == 2 and medians["reuse_"] > 0:
+                    sys.stderr.write("%-24s %8.2fx\n" % ("speed-up", medians["reparse_"] / medians["reuse_"]))
+        finally:
+            stop_server(process, path)
+
+    text = json.dumps(results, indent=2, sort_keys=True) + "\n"
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+    return 1 if failed else 0
+
+
+def command_compare(args):
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    with open(args.current) as f:
+        current = json.load(f)
+    metrics = args.metric or DEFAULT_COMPARE_METRICS
+
+    regressions = 0
+    print("%-24s %-18s %12s %12s %8s" % ("benchmark", "metric", "baseline", "current", "change"))
+    for name in sorted(set(baseline["benchmarks"]) | set(current["benchmarks"])):
+        if name not in baseline["benchmarks"] or name not in current["benchmarks"]:
+            print("%-24s %s" % (name, "(only in %s)" % ("baseline" if name in baseline["benchmarks"] else "current")))
+            continue
+        for metric in metrics:
+            old = baseline["benchmarks"][name]["metrics"].get(metric)
+            new = current["benchmarks"][name]["metrics"].get(metric)
+            if old is None or new is None or old["median"] == 0:
+                continue
+            change = (new["median"] - old["median"]) / old["median"] * 100.0
+            worse = -change if metric in HIGHER_IS_BETTER else change
+            # a difference within the combined noise of both runs is not considered significant
+            noise = 2.0 * max(old["stdev"], new["stdev"])
+            significant = abs(new["median"] - old["median"]) > noise
+            if worse > args.threshold and significant:
+                verdict = "REGRESSION"
+                regressions += 1
+            elif worse < -args.threshold and significant:
+                verdict = "improvement"
+            else:
+                verdict = ""
+            print("%-24s %-18s %12.4g %12.4g %+7.1f%% %s" % (name, metric, old["median"], new["median"], change, verdict))
+
+    if regressions:
+        print("\n%d regression(s) beyond %.1f%%" % (regressions, args.threshold))
+    return 1 if regressions else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    commands = parser.add_subparsers(dest="command")
+    commands.required = True
+
+    run = commands.add_parser("run", help="run the benchmark suite")
+    run.add_argument("--povray", default="povray", help="POV-Ray executable to benchmark (default: %(default)s)")
+    run.add_argument("--suite", default=DEFAULT_SUITE, help="benchmark suite definition (default: suite.txt)")
+    run.add_argument("--repeat", type=int, default=5, help="measured runs per benchmark (default: %(default)s)")
+    run.add_argument("--warmup", type=int, default=1, help="unmeasured runs per benchmark (default: %(default)s)")
+    run.add_argument("--threads", type=int, default=1, help="render threads (default: %(default)s)")
+    run.add_argument("--filter", help="only run benchmarks whose name matches this regular expression")
+    run.add_argument("--micro", metavar="MICROBENCH",
+                     help="micro-benchmark program to run as well (built via `make microbench` on Unix)")
+    run.add_argument("--library-path", action="append", default=[DEFAULT_INCLUDE],
+                     help="additional include directory; may be given more than once")
+    run.add_argument("--output", "-o", help="file to write results to (default: standard output)")
+    run.set_defaults(function=command_run)
+
+    reuse = commands.add_parser("reuse", help="measure re-using parsed scenes against parsing them for every render")
+    reuse.add_argument("--povray", default="povray", help="POV-Ray executable to benchmark (default: %(default)s)")
+    reuse.add_argument("--suite", default=DEFAULT_SUITE, help="benchmark suite definition (default: suite.txt)")
+    reuse.add_argument("--benchmark", action="append",
+                       help="benchmark of the suite to run; may be given more than once (default: %s)" % DEFAULT_REUSE_BENCHMARK)
+    reuse.add_argument("--option", action="append", default=[],
+                       help="further option for each job, e.g. --option=+W64; may be given more than once")
+    reuse.add_argument("--repeat", type=int, default=5, help="measured jobs per benchmark and mode (default: %(default)s)")
+    reuse.add_argument("--warmup", type=int, default=1, help="unmeasured jobs per benchmark and mode (default: %(default)s)")
+    reuse.add_argument("--threads", type=int, default=1, help="render threads (default: %(default)s)")
+    reuse.add_argument("--library-path", action="append", default=[DEFAULT_INCLUDE],
+                       help="additional include directory; may be given more than once")
+    reuse.add_argument("--output", "-o", help="file to write results to (default: standard output)")
+    reuse.set_defaults(function=command_reuse)
+
+    compare = commands.add_parser("compare", help="compare two sets of results")
+    compare.add_argument("baseline", help="results of the reference build")
+    compare.add_argument("current", help="results of the build to check")
+    compare.add_argument("--threshold", type=float, default=5.0,
+                         help="percentage by which a metric may worsen before being flagged (default: %(default)s)")
+    compare.add_argument("--metric", action="append",
+                         help="metric to compare; may be given more than once (default: %s)" % ", ".join(DEFAULT_COMPARE_METRICS))
+    compare.set_defaults(function=command_compare)
+
+    args = parser.parse_args()
+    if getattr(args, "repeat", 1) < 1:
+        parser.error("--repeat must be at least 1")
+    return args.function(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
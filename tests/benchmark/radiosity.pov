@@ -0,0 +1,31 @@
+// Persistence Of Vision Ray Tracer Scene Description File
+// Benchmark: radiosity sampling and cache lookup.
+//
+// A closed room lit mostly indirectly, so that every camera ray triggers a
+// radiosity cache lookup.
+
+#version 3.8;
+
+#declare BenchCameraLocation = <0, 3, -7.5>;
+#declare BenchCameraLookAt   = <0, 2, 0>;
+#include "common.inc"
+
+global_settings {
+    radiosity {
+        pretrace_start 0.08
+        pretrace_end   0.01
+        count 200
+        nearest_count 10
+        error_bound 0.5
+        recursion_limit 2
+        low_error_factor 0.5
+        gray_threshold 0.0
+        minimum_reuse 0.015
+        brightness 1
+    }
+}
+
+box { <-5, 0, -8>, <5, 5, 5> inverse pigment { rgb 0.8 } finish { diffuse 0.8 emission 0 } }
+box { <-1, 4.9, -1>, <1, 5, 1> pigment { rgb 1 } finish { emission 3 } }
+sphere { <-2, 1, 1>, 1 pigment { rgb <0.9, 0.3, 0.2> } }
+box { <0.5, 0, 0>, <2.5, 2.5, 2> rotate 20*y pigment { rgb <0.3, 0.5, 0.9> } }
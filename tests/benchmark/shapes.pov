@@ -0,0 +1,99 @@
+// Persistence Of Vision Ray Tracer Scene Description File
+// Benchmark: ray intersection of a single shape type.
+//
+// A grid of instances of the shape selected by `Declare=Shape=n`:
+//   0 sphere, 1 box, 2 cylinder, 3 cone, 4 torus, 5 superellipsoid, 6 blob,
+//   7 lathe, 8 sor, 9 prism, 10 mesh, 11 height_field, 12 text, 13 julia_fractal
+
+#version 3.8;
+
+#include "common.inc"
+
+#ifndef (Shape) #declare Shape = 0; #end
+
+#declare BenchShape =
+#switch (Shape)
+    #case (0)  sphere { 0, 0.5 } #break
+    #case (1)  box { -0.4, 0.4 rotate <30, 40, 0> } #break
+    #case (2)  cylinder { -0.4*y, 0.4*y, 0.4 rotate <30, 0, 20> } #break
+    #case (3)  cone { -0.4*y, 0.45, 0.4*y, 0.1 rotate <30, 0, 20> } #break
+    #case (4)  torus { 0.35, 0.12 rotate <60, 20, 0> } #break
+    #case (5)  superellipsoid { <0.3, 0.3> scale 0.4 rotate <30, 40, 0> } #break
+    #case (6)
+        blob {
+            threshold 0.6
+            sphere { <-0.2, 0, 0>, 0.4, 1 }
+            sphere { < 0.2, 0, 0>, 0.4, 1 }
+            sphere { < 0, 0.25, 0>, 0.35, 1 }
+        }
+    #break
+    #case (7)
+        lathe {
+            cubic_spline 6,
+            <0, -0.5>, <0.3, -0.4>, <0.45, 0>, <0.2, 0.2>, <0.35, 0.45>, <0, 0.5>
+            rotate 20*x
+        }
+    #break
+    #case (8)
+        sor {
+            6, <0, -0.5>, <0.3, -0.4>, <0.45, 0>, <0.2, 0.2>, <0.35, 0.45>, <0, 0.5>
+            rotate 20*x
+        }
+    #break
+    #case (9)
+        prism {
+            linear_spline -0.3, 0.3, 11,
+            <0.4, 0>, <0.12, 0.09>, <0.12, 0.38>, <-0.05, 0.14>, <-0.32, 0.24>,
+            <-0.15, 0>, <-0.32, -0.24>, <-0.05, -0.14>, <0.12, -0.38>, <0.12, -0.09>, <0.4, 0>
+            rotate <-60, 20, 0>
+        }
+    #break
+    #case (10)
+        mesh {
+            #local N = 12;
+            #local I = 0;
+            #while (I < N)
+                #local A0 = 2*pi*I/N;
+                #local A1 = 2*pi*(I+1)/N;
+                triangle { <0, 0.5, 0>, <0.4*cos(A0), -0.3, 0.4*sin(A0)>, <0.4*cos(A1), -0.3, 0.4*sin(A1)> }
+                triangle { <0, -0.5, 0>, <0.4*cos(A0), -0.3, 0.4*sin(A0)>, <0.4*cos(A1), -0.3, 0.4*sin(A1)> }
+                #local I = I + 1;
+            #end
+            rotate 20*x
+        }
+    #break
+    #case (11)
+        height_field {
+            function 64, 64 { 0.5 + 0.25*sin(x*12)*cos(y*9) }
+            translate -0.5 scale <0.9, 0.5, 0.9> rotate <-30, 20, 0>
+        }
+    #break
+    #case (12)
+        text { ttf "timrom.ttf" "Ab" 0.2, 0 scale 0.6 translate <-0.35, -0.2, 0> }
+    #break
+    #case (13)
+        julia_fractal {
+            <-0.083, 0.0, -0.83, -0.025> quaternion sqr
+            max_iteration 8 precision 15
+            scale 0.35
+        }
+    #break
+    #else
+        #error "Unknown benchmark shape; see the comment at the top of shapes.pov.\n"
+#end
+
+#local X = -6;
+#while (X <= 6)
+    #local Z = -3;
+    #while (Z <= 6)
+        object {
+            BenchShape
+            texture { pigment { rgb <0.8, 0.7, 0.5> } finish { specular 0.3 } }
+            translate <X, 0.5, Z*1.4>
+        }
+        #local Z = Z + 1;
+    #end
+    #local X = X + 1;
+#end
+
+plane { y, 0 pigment { rgb 0.6 } }
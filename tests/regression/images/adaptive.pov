@@ -0,0 +1,40 @@
+// Persistence Of Vision Ray Tracer Scene Description File
+// Regression test: adaptive sampling (Sampling_Method=4).
+//
+// Flat areas that converge after the first pass, next to fine checkers, hard
+// edges and a soft shadow that need many samples per pixel, so that blocks
+// of the frame converge after very different numbers of passes.
+
+#version 3.8;
+
+global_settings { assumed_gamma 1.0 }
+
+camera {
+    location <0, 2, -5>
+    look_at  <0, 0.5, 0>
+    right    x*image_width/image_height
+}
+
+light_source {
+    <4, 6, -3> rgb 1
+    area_light x, z, 4, 4 adaptive 0 jitter
+}
+
+background { rgb <0.2, 0.3, 0.5> }
+
+plane {
+    y, 0
+    pigment { checker rgb 0.9, rgb 0.1 scale 0.15 }
+}
+
+sphere {
+    <-1, 0.8, 0>, 0.8
+    pigment { rgb <0.8, 0.3, 0.2> }
+    finish { specular 0.6 }
+}
+
+box {
+    <0.4, 0, -0.5>, <1.6, 1.2, 0.7>
+    pigment { rgb <0.2, 0.6, 0.3> }
+    rotate y*30
+}
@@ -0,0 +1,42 @@
+// Persistence Of Vision Ray Tracer Scene Description File
+// Regression test: saving and loading photon maps.
+//
+// Declare `PhotonMode` as 1 to save the photon maps to `photons.ph`, or as 2 to
+// load them from it; either way the output must be the same.
+
+#version 3.8;
+
+global_settings {
+    assumed_gamma 1.0
+    photons {
+        spacing 0.02
+        #ifndef (PhotonMode) #declare PhotonMode = 0; #end
+        #if (PhotonMode = 1) save_file "photons.ph" #end
+        #if (PhotonMode = 2) load_file "photons.ph" #end
+    }
+}
+
+camera {
+    location <0, 3, -5>
+    look_at  0
+    right    x*image_width/image_height
+}
+
+light_source { <3, 5, -3> rgb 1 photons { refraction on reflection on } }
+
+plane { y, -1 pigment { rgb 1 } }
+
+sphere {
+    0, 1
+    pigment { rgbf <1, 0.9, 0.8, 0.9> }
+    finish { reflection 0.2 }
+    interior { ior 1.5 }
+    photons { target refraction on reflection on }
+}
+
+box {
+    <-2.5, -1, 0.5>, <-1.5, 0.5, 1.5>
+    pigment { rgb <0.2, 0.6, 1> }
+    finish { reflection 0.8 }
+    photons { target reflection on }
+}
@@ -0,0 +1,44 @@
+// Persistence Of Vision Ray Tracer Scene Description File
+// Regression test: radiosity cache files.
+//
+// Diffuse interreflection in a closed box, so that the radiosity samples
+// dominate the output.
+
+#version 3.8;
+
+global_settings {
+    assumed_gamma 1.0
+    radiosity {
+        pretrace_start 0.08
+        pretrace_end   0.02
+        count 50
+        error_bound 0.5
+        recursion_limit 2
+    }
+}
+
+camera {
+    location <0, 1, -3.5>
+    look_at  <0, 1, 0>
+    right    x*image_width/image_height
+}
+
+light_source { <0, 1.9, 0> rgb 1 }
+
+box {
+    <-2, 0, -4>, <2, 2, 2>
+    hollow
+    pigment { rgb 0.8 }
+}
+
+box {
+    <-2, 0, -4>, <-1.95, 2, 2>
+    pigment { rgb <1, 0.2, 0.2> }
+}
+
+box {
+    <1.95, 0, -4>, <2, 2, 2>
+    pigment { rgb <0.2, 0.2, 1> }
+}
+
+sphere { <0, 0.5, 0.5>, 0.5 pigment { rgb 1 } }
@@ -0,0 +1,30 @@
+// Persistence Of Vision Ray Tracer Scene Description File
+// Regression test: reference scene for the image output tests.
+//
+// Smooth gradients and hard edges across the whole frame, so that any pixel
+// written to the wrong place, or not at all, changes the output.
+
+#version 3.8;
+
+global_settings { assumed_gamma 1.0 }
+
+camera {
+    location <0, 0, -5>
+    look_at  0
+    right    x*image_width/image_height
+}
+
+light_source { <5, 5, -5> rgb 1 }
+
+background { rgb <0.2, 0.3, 0.5> }
+
+sphere {
+    0, 1.5
+    pigment { checker rgb <1, 0, 0> rgb <0, 0, 1> scale 0.2 }
+    finish { specular 0.5 }
+}
+
+plane {
+    y, -1.5
+    pigment { gradient x color_map { [0 rgb 0] [1 rgb 1] } }
+}
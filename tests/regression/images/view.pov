@@ -0,0 +1,34 @@
+// Persistence Of Vision Ray Tracer Scene Description File
+// Regression test: re-render an image file pixel for pixel.
+//
+// Used to compare output files in formats the test harness cannot decode
+// itself; the harness copies the file to `view_input.<ext>`, and renders this
+// scene at the image's resolution with `Declare=ViewFormat=n`:
+//   0 exr
+
+#version 3.8;
+
+#ifndef (ViewFormat) #declare ViewFormat = 0; #end
+
+global_settings { assumed_gamma 1.0 }
+
+camera {
+    orthographic
+    location <0.5, 0.5, -1>
+    look_at  <0.5, 0.5, 0>
+    right    x
+    up       y
+}
+
+plane {
+    z, 0
+    pigment {
+        image_map {
+            #switch (ViewFormat)
+                #case (0) exr "view_input.exr" #break
+            #end
+            interpolate 0
+        }
+    }
+    finish { emission 1 diffuse 0 }
+}
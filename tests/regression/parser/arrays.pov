@@ -0,0 +1,140 @@
+// Persistence Of Vision Ray Tracer Scene Description File
+// Regression test: array storage.
+//
+// Arrays of floats, vectors or colours are stored densely; an array falls
+// back to individually allocated elements when an element's type changes
+// behind its back, i.e. via a macro parameter passed by reference. Neither
+// must be observable from the scene.
+
+#version 3.8;
+
+global_settings { assumed_gamma 1.0 }
+
+#macro Expect(Name, Value, Expected)
+    #if (Value != Expected)
+        #error concat(Name, " is ", str(Value, 0, -1), ", expected ", str(Expected, 0, -1))
+    #end
+#end
+
+#macro ExpectVector(Name, Value, Expected)
+    #if (vlength(Value - Expected) > 1e-9)
+        #error concat(Name, " is <", vstr(3, Value, ", ", 0, -1), ">, expected <", vstr(3, Expected, ", ", 0, -1), ">")
+    #end
+#end
+
+#macro ExpectString(Name, Value, Expected)
+    #if (strcmp(Value, Expected) != 0)
+        #error concat(Name, " is \"", Value, "\", expected \"", Expected, "\"")
+    #end
+#end
+
+#macro SetVector(X) #declare X = <1, 2, 3>; #end
+#macro SetString(X) #declare X = "text"; #end
+#macro Increment(X) #declare X = X + 1; #end
+
+//------------------------------------------------------------------------------
+// Dense arrays: initialization, assignment and removal of elements.
+
+#declare A = array[4] { 1, 2, 3, 4 };
+#declare A[1] = A[0] + A[2];
+#undef A[3]
+Expect("A[1]", A[1], 4)
+#ifdef (A[3]) #error "A[3] still defined after #undef" #end
+#declare A[3] = 8;
+Expect("A[3]", A[3], 8)
+
+#declare Sum = 0;
+#for (I, 0, 3)
+    #declare Sum = Sum + A[I];
+#end
+Expect("Sum", Sum, 16)
+
+// Tuple-style assignment, and passing elements by reference.
+#declare (A[0], A[2]) = (A[2], A[1] + 1);
+Expect("A[0]", A[0], 3)
+Expect("A[2]", A[2], 5)
+Increment(A[2])
+Expect("A[2]", A[2], 6)
+
+#declare V = array[2] { <1, 0, 0>, <0, 1, 0> };
+#declare V[1] = V[1] * 2 + V[0];
+ExpectVector("V[1]", V[1], <1, 2, 0>)
+
+//------------------------------------------------------------------------------
+// Element type changes, which switch the arrays to individually allocated
+// elements; all other elements must keep their values and types.
+
+#declare B = array[3] { 1, 2, 3 };
+SetVector(B[1])
+ExpectVector("B[1]", B[1], <1, 2, 3>)
+Expect("B[0]", B[0], 1)
+Expect("B[2]", B[2], 3)
+#declare B[2] = B[2] * 10;
+Expect("B[2]", B[2], 30)
+
+#declare C = array[3] { <1, 1, 1>, <2, 2, 2>, <3, 3, 3> };
+SetString(C[2])
+ExpectString("C[2]", C[2], "text")
+ExpectVector("C[0]", C[0], <1, 1, 1>)
+#declare C[2] = <4, 4, 4>;
+ExpectVector("C[2]", C[2], <4, 4, 4>)
+
+// Copies of an array are independent.
+#declare D = B;
+#declare D[0] = -1;
+Expect("B[0]", B[0], 1)
+Expect("D[0]", D[0], -1)
+ExpectVector("D[1]", D[1], <1, 2, 3>)
+
+//------------------------------------------------------------------------------
+// Resizable arrays, including a reference to an element while the array grows.
+
+#declare R = array;
+#for (I, 0, 99)
+    #declare R[I] = I * I;
+#end
+Expect("dimension_size(R, 1)", dimension_size(R, 1), 100)
+Expect("R[99]", R[99], 9801)
+
+#macro GrowWhileReferenced(X)
+    #for (I, 100, 999)
+        #declare R[I] = I;
+    #end
+    #declare X = X + 1;
+#end
+GrowWhileReferenced(R[3])
+Expect("R[3]", R[3], 10)
+Expect("R[999]", R[999], 999)
+
+//------------------------------------------------------------------------------
+// Nested arrays; the inner arrays are stored densely on their own.
+
+#declare N = array[2][2] { { 1, 2 }, { 3, 4 } };
+#declare N[1][0] = N[0][1] * 10;
+Expect("N[1][0]", N[1][0], 20)
+
+#declare M = array[3];
+#for (I, 0, 2)
+    #declare M[I] = array[I + 1];
+    #for (J, 0, I)
+        #declare M[I][J] = 10 * I + J;
+    #end
+#end
+SetVector(M[2][1])
+Expect("M[2][2]", M[2][2], 22)
+ExpectVector("M[2][1]", M[2][1], <1, 2, 3>)
+Increment(M[1][1])
+Expect("M[1][1]", M[1][1], 12)
+
+#declare Inner = M[1];
+#declare Inner[0] = -1;
+Expect("M[1][0]", M[1][0], 10)
+
+#declare G = array[2] { array { 1, 2 }, array { <1, 2, 3> } };
+#declare G[0][2] = 3;
+Expect("dimension_size(G[0], 1)", dimension_size(G[0], 1), 3)
+Expect("G[0][2]", G[0][2], 3)
+SetString(G[1][0])
+ExpectString("G[1][0]", G[1][0], "text")
+
+camera { location -z look_at 0 }
@@ -0,0 +1,34 @@
+// Persistence Of Vision Ray Tracer Scene Description File
+// Regression test: image files loaded more than once.
+//
+// Identical image files are decoded only once, and the image is shared. A
+// colour-mapped image must be copied before `filter all` or `transmit all`
+// modifies its palette, so that other uses of the same file see the original
+// colours. Pigment functions are evaluated while parsing, so the images they
+// use must have been loaded by then.
+//
+// palette.png is a 4x4 colour-mapped image, alternating red and blue.
+
+#version 3.8;
+
+global_settings { assumed_gamma 1.0 }
+
+#declare Plain    = function { pigment { image_map { png "palette.png" } } }
+#declare Filtered = function { pigment { image_map { png "palette.png" filter all 0.5 } } }
+#declare Nested   = function { pigment { checker pigment { image_map { png "palette.png" transmit all 0.25 } } pigment { rgb 0 } scale 2 } }
+#declare Again    = function { pigment { image_map { png "palette.png" } } }
+
+#macro Expect(Name, Value, Expected)
+    #local D = color Value - Expected;
+    #if (max(abs(D.red), abs(D.green), abs(D.blue), abs(D.filter), abs(D.transmit)) > 1e-6)
+        #error concat(Name, " is <", vstr(5, Value, ", ", 0, 3), ">, expected <", vstr(5, Expected, ", ", 0, 3), ">")
+    #end
+#end
+
+Expect("Plain",    Plain(0.1, 0.1, 0),    <0, 0, 1, 0,   0>)
+Expect("Plain",    Plain(0.4, 0.1, 0),    <1, 0, 0, 0,   0>)
+Expect("Filtered", Filtered(0.1, 0.1, 0), <0, 0, 1, 0.5, 0>)
+Expect("Nested",   Nested(0.1, 0.1, 0.5), <0, 0, 1, 0,   0.25>)
+Expect("Again",    Again(0.1, 0.1, 0),    <0, 0, 1, 0,   0>)
+
+camera { location -z look_at 0 }
@@ -0,0 +1,103 @@
+// Persistence Of Vision Ray Tracer Scene Description File
+// Regression test: `#read` into arrays.
+//
+// Values may be read into individual array elements, including still
+// uninitialized ones, or into an entire array at once, in which case a
+// resizable array grows until the end of the file.
+
+#version 3.8;
+
+global_settings { assumed_gamma 1.0 }
+
+#macro Expect(Name, Value, Expected)
+    #if (Value != Expected)
+        #error concat(Name, " is ", str(Value, 0, -1), ", expected ", str(Expected, 0, -1))
+    #end
+#end
+
+#macro ExpectVector(Name, Value, Expected)
+    #if (vlength(Value - Expected) > 1e-9)
+        #error concat(Name, " is <", vstr(3, Value, ", ", 0, -1), ">, expected <", vstr(3, Expected, ", ", 0, -1), ">")
+    #end
+#end
+
+#macro ExpectString(Name, Value, Expected)
+    #if (strcmp(Value, Expected) != 0)
+        #error concat(Name, " is \"", Value, "\", expected \"", Expected, "\"")
+    #end
+#end
+
+#macro WriteData(FileName, Text)
+    #fopen DataFile FileName write
+    #write (DataFile, Text)
+    #fclose DataFile
+#end
+
+//------------------------------------------------------------------------------
+// Individual elements.
+
+WriteData("elements.dat", "1, 2, <3, 4, 5>, \"six\", 7,\n")
+
+#declare A = array[4];
+#declare A[3] = 0;
+#declare V = array[1];
+#declare S = array[1];
+#fopen DataFile "elements.dat" read
+#read (DataFile, A[0], A[1], V[0], S[0], A[3])
+#fclose DataFile
+Expect("A[0]", A[0], 1)
+Expect("A[1]", A[1], 2)
+#ifdef (A[2]) #error "A[2] defined by #read" #end
+Expect("A[3]", A[3], 7)
+ExpectVector("V[0]", V[0], <3, 4, 5>)
+ExpectString("S[0]", S[0], "six")
+
+//------------------------------------------------------------------------------
+// Entire arrays.
+
+WriteData("floats.dat", "1, 2, 3, 4, 5, 6, 7,\n")
+
+// A fixed-size array takes as many values as it holds.
+#declare F = array[2][2];
+#fopen DataFile "floats.dat" read
+#read (DataFile, F)
+#read (DataFile, A[2])
+Expect("F[0][0]", F[0][0], 1)
+Expect("F[1][1]", F[1][1], 4)
+Expect("A[2]", A[2], 5)
+
+// A resizable array takes the rest of the file.
+#declare R = array;
+#read (DataFile, R)
+Expect("dimension_size(R, 1)", dimension_size(R, 1), 2)
+Expect("R[0]", R[0], 6)
+Expect("R[1]", R[1], 7)
+#ifdef (DataFile) #error "DataFile still defined at end of file" #end
+
+// An array of mixed types.
+WriteData("mixed.dat", "<1, 2, 3>, 4, \"five\",\n")
+#declare M = array mixed[3];
+#fopen DataFile "mixed.dat" read
+#read (DataFile, M)
+#fclose DataFile
+ExpectVector("M[0]", M[0], <1, 2, 3>)
+Expect("M[1]", M[1], 4)
+ExpectString("M[2]", M[2], "five")
+
+// A large resizable array.
+#fopen DataFile "large.dat" write
+#for (I, 0, 9999)
+    #write (DataFile, I, ",")
+#end
+#fclose DataFile
+#declare L = array;
+#fopen DataFile "large.dat" read
+#read (DataFile, L)
+Expect("dimension_size(L, 1)", dimension_size(L, 1), 10000)
+#declare Sum = 0;
+#for (I, 0, 9999)
+    #declare Sum = Sum + L[I];
+#end
+Expect("Sum", Sum, 49995000)
+
+camera { location -z look_at 0 }
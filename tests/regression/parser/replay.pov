@@ -0,0 +1,86 @@
+// Persistence Of Vision Ray Tracer Scene Description File
+// Regression test: replaying loop and macro bodies.
+//
+// Loop bodies and macros, in this file as well as in an include file, are
+// run many times, so that the parser replays them from pre-scanned tokens;
+// the results are checked here, and also shape the output image, which must
+// be the same whether or not the include cache is in use. Declare `Unrolled`
+// as 1 to take the objects from replay_unrolled.inc instead, where they are
+// written out one by one, so that the image is made without any replaying.
+
+#version 3.8;
+
+global_settings { assumed_gamma 1.0 }
+
+#include "replay.inc"
+
+#macro Expect(Name, Value, Expected)
+    #if (Value != Expected)
+        #error concat(Name, " is ", str(Value, 0, -1), ", expected ", str(Expected, 0, -1))
+    #end
+#end
+
+#macro ExpectString(Name, Value, Expected)
+    #if (strcmp(Value, Expected) != 0)
+        #error concat(Name, " is '", Value, "', expected '", Expected, "'")
+    #end
+#end
+
+#macro Square(X)
+    (X * X)
+#end
+
+//------------------------------------------------------------------------------
+// Loops and macros in this file.
+
+#declare Sum = 0;
+#declare I = 0;
+#while (I < 1000)
+    #declare Sum = Sum + Square(I);
+    #declare I = I + 1;
+#end
+Expect("Sum of squares", Sum, 332833500)
+
+#declare Count = 0;
+#for (J, 1, 20)
+    #for (K, J, 20, 3)
+        #declare Count = Count + 1;
+    #end
+#end
+Expect("Nested #for iterations", Count, 77)
+
+//------------------------------------------------------------------------------
+// Macros in the include file.
+
+Expect("Fib(15)", Fib(15), 610)
+
+#declare Text = "";
+#for (N, 1, 50)
+    #declare Text = Label(N);
+#end
+ExpectString("Label", Text, "item-50/25.00")
+
+//------------------------------------------------------------------------------
+// Image.
+
+camera {
+    location <0, 4, -6>
+    look_at  <0, 0.5, 0>
+    right    x*image_width/image_height
+}
+
+light_source { <5, 8, -5> rgb 1 }
+
+background { rgb <0.1, 0.1, 0.2> }
+
+#ifndef (Unrolled) #declare Unrolled = 0; #end
+
+#if (Unrolled)
+    #include "replay_unrolled.inc"
+#else
+    #for (Level, 0, 5)
+        Ring(8 + 4 * Level, 0.6 + 0.4 * Level, 0.3 * Level)
+    #end
+
+    plane { y, -0.2 pigment { rgb Hue(Fib(10)) } }
+#end
@@ -0,0 +1,114 @@
+// Persistence Of Vision Ray Tracer Scene Description File
+// Regression test: symbol tables.
+//
+// Local symbols shadow symbols of the same name until they are removed;
+// removing symbols must leave all others reachable, no matter how they
+// happen to be laid out in the table, which grows as symbols are added.
+
+#version 3.8;
+
+global_settings { assumed_gamma 1.0 }
+
+#macro Expect(Name, Value, Expected)
+    #if (Value != Expected)
+        #error concat(Name, " is ", str(Value, 0, -1), ", expected ", str(Expected, 0, -1))
+    #end
+#end
+
+//------------------------------------------------------------------------------
+// Shadowing.
+
+#declare X = 1;
+
+#macro Outer()
+    Expect("X in Outer before #local", X, 1)
+    #local X = 2;
+    Expect("X in Outer", X, 2)
+    Inner()
+    Expect("X in Outer after Inner", X, 2)
+    #undef X
+    Expect("X in Outer after #undef", X, 1)
+    #local X = 4;
+    Expect("X in Outer after second #local", X, 4)
+#end
+
+#macro Inner()
+    Expect("X in Inner before #local", X, 2)
+    #local X = 3;
+    Expect("X in Inner", X, 3)
+    #declare X = 5; // assigns the local symbol
+    Expect("X in Inner after #declare", X, 5)
+#end
+
+Outer()
+Expect("X", X, 1)
+
+// A macro parameter shadows a global symbol of the same name.
+#macro Parameter(X)
+    #undef X
+    #ifdef (X)
+        Expect("X after #undef of parameter", X, 1)
+    #else
+        #error "#undef of a parameter removed the global symbol as well"
+    #end
+#end
+Parameter(7)
+Expect("X", X, 1)
+
+#undef X
+#ifdef (X) #error "X still defined after #undef" #end
+#declare X = 6;
+Expect("X", X, 6)
+
+//------------------------------------------------------------------------------
+// Many symbols in one table, some removed again.
+
+#declare D = dictionary;
+#for (I, 0, 1999)
+    #declare D[concat("key", str(I, 0, 0))] = I;
+#end
+#for (I, 0, 1999, 3)
+    #undef D[concat("key", str(I, 0, 0))]
+#end
+#for (I, 0, 1999)
+    #if (mod(I, 3) = 0)
+        #ifdef (D[concat("key", str(I, 0, 0))]) #error concat("key", str(I, 0, 0), " still defined after #undef") #end
+    #else
+        Expect(concat("D.key", str(I, 0, 0)), D[concat("key", str(I, 0, 0))], I)
+    #end
+#end
+
+// Re-adding removed symbols.
+#for (I, 0, 1999, 3)
+    #declare D[concat("key", str(I, 0, 0))] = -I;
+#end
+#declare Sum = 0;
+#for (I, 0, 1999)
+    #declare Sum = Sum + D[concat("key", str(I, 0, 0))];
+#end
+Expect("Sum", Sum, 1999000 - 2 * 666333)
+
+// Copies of a dictionary are independent.
+#declare E = D;
+#declare E.key1 = 100;
+#undef E.key2
+Expect("D.key1", D.key1, 1)
+Expect("D.key2", D.key2, 2)
+Expect("E.key1", E.key1, 100)
+#ifdef (E.key2) #error "E.key2 still defined after #undef" #end
+
+// Many local symbols, which all vanish when the macro returns.
+#macro ManyLocals()
+    #local D = dictionary;
+    #local D.key1 = -1;
+    #for (I, 0, 499)
+        #local Y = I;
+    #end
+    Expect("Y", Y, 499)
+    Expect("local D.key1", D.key1, -1)
+#end
+ManyLocals()
+#ifdef (Y) #error "Y still defined after macro returned" #end
+Expect("D.key1", D.key1, 1)
+
+camera { location -z look_at 0 }
@@ -0,0 +1,259 @@
+#!/usr/bin/env python3
+#
+# Persistence of Vision Ray Tracer ('POV-Ray') version 3.8.
+# Copyright 1991-2019 Persistence of Vision Raytracer Pty. Ltd.
+#
+# POV-Ray is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# POV-Ray is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+"""Run the POV-Ray regression tests.
+
+    regress.py --povray path/to/povray
+
+Each test (see suite.txt) renders a scene, and fails if POV-Ray reports an
+error; scenes testing the parser check their expectations with `#error`.
+A test may additionally require its output image to be identical, pixel for
+pixel, to that of another test, and may be restricted to builds supporting a
+particular image file format. A test may also be interrupted part way through
+the render, and then continued from its render state file.
+"""
+
+import argparse
+import glob
+import os
+import re
+import shlex
+import shutil
+import signal
+import struct
+import subprocess
+import sys
+import tempfile
+import zlib
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_SUITE = os.path.join(SCRIPT_DIR, "suite.txt")
+VIEW_SCENE = os.path.join(SCRIPT_DIR, "images", "view.pov")
+
+# Image file formats the harness cannot decode itself, and the `ViewFormat` to re-render them with.
+VIEW_FORMATS = {".exr": 0}
+
+
+class Test(object):
+    def __init__(self, name, scene, options, same_image=None, requires=None, interrupt=None):
+        self.name = name
+        self.scene = scene
+        self.options = options
+        self.same_image = same_image
+        self.requires = requires
+        self.interrupt = interrupt
+
+
+def read_suite(path):
+    tests = []
+    base = os.path.dirname(os.path.abspath(path))
+    with open(path) as f:
+        for lineno, line in enumerate(f, 1):
+            line = line.strip()
+            if not line or line.startswith("#"):
+                continue
+            fields = shlex.split(line)
+            if len(fields) < 2:
+                raise SystemExit("%s:%d: expected a name and a scene file" % (path, lineno))
+            if any(t.name == fields[0] for t in tests):
+                raise SystemExit("%s:%d: duplicate test name '%s'" % (path, lineno, fields[0]))
+            test = Test(fields[0], os.path.normpath(os.path.join(base, fields[1])), [])
+            for field in fields[2:]:
+                if field.startswith("@same-image="):
+                    test.same_image = field.split("=", 1)[1]
+                    if not any(t.name == test.same_image for t in tests):
+                        raise SystemExit("%s:%d: unknown test '%s'" % (path, lineno, test.same_image))
+                elif field.startswith("@requires="):
+                    test.requires = field.split("=", 1)[1]
+                elif field.startswith("@interrupt="):
+                    test.interrupt = float(field.split("=", 1)[1])
+                else:
+                    test.options.append(field)
+            tests.append(test)
+    return tests
+
+
+def supported_formats(povray):
+    process = subprocess.run([povray, "--version"], stdout=subprocess.PIPE, stderr=subprocess.STDOUT, timeout=30)
+    match = re.search(r"^\s*Supported image formats:\s*(.*)$", process.stdout.decode(errors="replace"), re.MULTILINE)
+    return set(match.group(1).split()) if match else set()
+
+
+def interrupt_render(command, workdir, percent):
+    """Start a render, and interrupt it once the given percentage of pixels has been rendered."""
+    process = subprocess.Popen(command, cwd=workdir, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    text = b""
+    interrupted = False
+    while True:
+        chunk = os.read(process.stdout.fileno(), 4096)
+        if not chunk:
+            break
+        text = (text + chunk)[-4096:]
+        if not interrupted:
+            progress = re.findall(rb"Rendered (\d+) of (\d+) pixels", text)
+            if progress and int(progress[-1][0]) * 100 >= percent * int(progress[-1][1]):
+                process.send_signal(signal.SIGINT)
+                interrupted = True
+    process.wait()
+    if not interrupted:
+        raise RuntimeError("render finished before it could be interrupted:\n%s" % text.decode(errors="replace")[-2000:])
+
+
+def render(povray, scene, options, workdir, output, interrupt=None):
+    command = [povray, scene, "-D", "-GA", "+L" + os.path.dirname(scene), "+O" + output] + options
+    if interrupt is not None:
+        # continue the interrupted render from its render state file
+        interrupt_render(command, workdir, interrupt)
+        command.append("+C")
+    process = subprocess.run(command, cwd=workdir, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    if process.returncode != 0:
+        text = process.stdout.decode(errors="replace")
+        raise RuntimeError("render failed with exit code %d:\n%s" % (process.returncode, text[-2000:]))
+    written = [p for p in glob.glob(os.path.join(workdir, output + ".*")) if not p.endswith(".part")]
+    return written[0] if written else None
+
+
+def read_png(path):
+    """Decode a non-interlaced PNG file into its dimensions and raw sample data."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:8] != b"\x89PNG\r\n\x1a\n":
+        raise RuntimeError("%s: not a PNG file" % path)
+    pos, header, idat = 8, None, []
+    while pos < len(data):
+        length, kind = struct.unpack(">I4s", data[pos:pos + 8])
+        chunk = data[pos + 8:pos + 8 + length]
+        if kind == b"IHDR":
+            header = struct.unpack(">IIBBBBB", chunk)
+        elif kind == b"IDAT":
+            idat.append(chunk)
+        pos += 12 + length
+    width, height, depth, colour, _, _, interlace = header
+    if interlace:
+        raise RuntimeError("%s: interlaced PNG files are not supported" % path)
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[colour]
+    bpp = max(1, channels * depth // 8)
+    stride = (width * channels * depth + 7) // 8
+    raw = zlib.decompress(b"".join(idat))
+    pixels = bytearray()
+    previous = bytearray(stride)
+    for y in range(height):
+        kind = raw[y * (stride + 1)]
+        line = bytearray(raw[y * (stride + 1) + 1:(y + 1) * (stride + 1)])
+        for i in range(stride):
+            a = line[i - bpp] if i >= bpp else 0
+            b = previous[i]
+            c = previous[i - bpp] if i >= bpp else 0
+            if kind == 1:
+                line[i] = (line[i] + a) & 0xFF
+            elif kind == 2:
+                line[i] = (line[i] + b) & 0xFF
+            elif kind == 3:
+                line[i] = (line[i] + (a + b) // 2) & 0xFF
+            elif kind == 4:
+                p = a + b - c
+                pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+                line[i] = (line[i] + (a if pa <= pb and pa <= pc else b if pb <= pc else c)) & 0xFF
+        pixels += line
+        previous = line
+    return (width, height, channels, depth), bytes(pixels)
+
+
+def read_image(povray, path, workdir):
+    extension = os.path.splitext(path)[1].lower()
+    if extension in VIEW_FORMATS:
+        # have POV-Ray itself decode the file, by rendering it to a PNG file pixel for pixel
+        view_input = os.path.join(workdir, "view_input" + extension)
+        shutil.copyfile(path, view_input)
+        width, height = image_size(path)
+        output = render(povray, VIEW_SCENE,
+                        ["+W%d" % width, "+H%d" % height, "+FN16", "-A", "Declare=ViewFormat=%d" % VIEW_FORMATS[extension]],
+                        workdir, "view_output")
+        result = read_png(output)
+        os.remove(output)
+        os.remove(view_input)
+        return result
+    return read_png(path)
+
+
+def image_size(path):
+    """Get the dimensions of an OpenEXR file from its data window."""
+    with open(path, "rb") as f:
+        data = f.read(65536)
+    pos = data.find(b"dataWindow\0box2i\0")
+    if pos < 0:
+        raise RuntimeError("%s: no data window found" % path)
+    xmin, ymin, xmax, ymax = struct.unpack("<iiii", data[pos + 21:pos + 37])
+    return xmax - xmin + 1, ymax - ymin + 1
+
+
+def run_test(povray, test, formats, outputs, workdir):
+    if test.requires and test.requires not in formats:
+        return "skipped (no %s support)" % test.requires
+    output = render(povray, test.scene, test.options, workdir, test.name, test.interrupt)
+    outputs[test.name] = output
+    if test.same_image:
+        reference = outputs.get(test.same_image)
+        if reference is None or output is None:
+            raise RuntimeError("no output image to compare with '%s'" % test.same_image)
+        header, pixels = read_image(povray, output, workdir)
+        ref_header, ref_pixels = read_image(povray, reference, workdir)
+        if header != ref_header:
+            raise RuntimeError("image format %s differs from '%s' (%s)" % (header, test.same_image, ref_header))
+        if pixels != ref_pixels:
+            diff = sum(1 for a, b in zip(pixels, ref_pixels) if a != b)
+            raise RuntimeError("%d bytes of pixel data differ from '%s'" % (diff, test.same_image))
+    return "ok"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--povray", default="povray", help="POV-Ray executable to test (default: %(default)s)")
+    parser.add_argument("--suite", default=DEFAULT_SUITE, help="test suite definition (default: suite.txt)")
+    parser.add_argument("--filter", help="only run tests whose name matches this regular expression")
+    args = parser.parse_args()
+
+    tests = read_suite(args.suite)
+    povray = os.path.abspath(args.povray) if os.path.sep in args.povray else args.povray
+    formats = supported_formats(povray)
+    pattern = re.compile(args.filter) if args.filter else None
+
+    failed = 0
+    outputs = {}
+    with tempfile.TemporaryDirectory(prefix="povregress-") as workdir:
+        for test in tests:
+            # tests referenced by a selected test are run regardless
+            if pattern and not pattern.search(test.name) and \
+               not any(pattern.search(t.name) and t.same_image == test.name for t in tests):
+                continue
+            sys.stderr.write("%-28s" % test.name)
+            sys.stderr.flush()
+            try:
+                result = run_test(povray, test, formats, outputs, workdir)
+            except RuntimeError as e:
+                result = "FAILED\n%s" % e
+                failed += 1
+            sys.stderr.write(" %s\n" % result)
+
+    if failed:
+        sys.stderr.write("\n%d test(s) failed\n" % failed)
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
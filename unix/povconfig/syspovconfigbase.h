@@ -80,6 +80,12 @@
 // We want to implement a specialized Filesystem::DeleteFile.
 #define POV_USE_DEFAULT_DELETEFILE 0
 
+// We want to implement a specialized Filesystem::SyncFile.
+#define POV_USE_DEFAULT_SYNCFILE 0
+
+// We want to implement a specialized Filesystem::GetFileStatus.
+#define POV_USE_DEFAULT_GETFILESTATUS 0
+
 // We want to implement a specialized Filesystem::LargeFile.
 #define POV_USE_DEFAULT_LARGEFILE 0
 
@@ -428,12 +428,18 @@ case "$1" in
 # Programs to build.
 bin_PROGRAMS = povray
 
+# Programs to build on request only, via "make microbench".
+EXTRA_PROGRAMS = microbench
+
 # Source files.
 povray_SOURCES = \\
   disp.h \\
   disp_sdl.cpp disp_sdl.h \\
   disp_text.cpp disp_text.h
 
+microbench_SOURCES = \\
+  ../tests/benchmark/microbench.cpp
+
 cppflags_platformcpu =
 ldadd_platformcpu =
 if BUILD_x86
@@ -53,6 +53,7 @@
 
 // from directory "vfe"
 #include "vfe.h"
+#include "unixrenderserver.h"
 
 // from directory "unix"
 #include "disp.h"
@@ -62,6 +63,7 @@
 // from directory "source"
 #include "backend/povray.h"
 #include "backend/control/benchmark.h"
+#include "backend/control/rendernode.h"
 
 namespace pov_frontend
 {
@@ -427,6 +429,204 @@ static void CleanupBenchmark(vfeUnixSession *session, std::string& ini, std::str
     session->DeleteTemporaryFile(SysToUCS2String(pov.c_str()));
 }
 
+static bool KeepWaitingForRenderJob()
+{
+    ProcessSignal();
+    return !gCancelRender;
+}
+
+// Serve render jobs of coordinators on the given TCP port until interrupted; the jobs
+// are rendered with the given default options, plus any remaining command-line options.
+static ReturnValue RunRenderNode(vfeUnixSession *session, const vfeRenderOptions& defaults, int port, char **argv)
+{
+    UnixOptionsProcessor *options = session->GetUnixOptions().get();
+    std::string address(options->QueryOptionString("general", "rendernodebind"));
+    if (address.empty())
+        address = pov::kDefaultRenderNodeBindAddress;
+    std::string token(options->QueryOptionString("general", "rendernodetoken"));
+    int maxJobSize = options->QueryOptionInt("general", "rendernodemaxjob", pov::kDefaultRenderNodeMaxJobSize);
+
+    std::unique_ptr<pov::RenderNodeServer> server;
+    try
+    {
+        if ((port <= 0) || (port > 65535))
+            throw POV_EXCEPTION(kParamErr, "Invalid render node port " + std::to_string(port));
+        if (maxJobSize <= 0)
+            throw POV_EXCEPTION(kParamErr, "Invalid render node job size limit " + std::to_string(maxJobSize));
+        server.reset(new pov::RenderNodeServer(address, (unsigned short)port, token, (POV_ULONG)maxJobSize * 1024 * 1024));
+    }
+    catch (pov_base::Exception& e)
+    {
+        fprintf(stderr, "%s: %s\n", PACKAGE, e.what());
+        return RETURN_ERROR;
+    }
+
+    fprintf(stderr, "%s: waiting for render jobs on %s port %d%s\n", PACKAGE, address.c_str(), port,
+            (token.empty() ? ", accepting coordinators without a token" : ""));
+
+    while (!gCancelRender)
+    {
+        std::shared_ptr<pov::RenderNodeJob> job;
+        try
+        {
+            job = server->Accept(KeepWaitingForRenderJob);
+        }
+        catch (pov_base::Exception& e)
+        {
+            fprintf(stderr, "%s: %s\n", PACKAGE, e.what());
+            continue;
+        }
+        if (job == nullptr)
+            break;
+
+        fprintf(stderr, "%s: rendering job for %s\n", PACKAGE, job->GetCoordinatorName().c_str());
+
+        vfeRenderOptions opts(defaults);
+        opts.SetBaseOptions(job->GetRenderOptions());
+        for (char **arg = argv; *arg != nullptr; arg++)
+            opts.AddCommand(*arg);
+
+        if ((session->SetOptions(opts) != vfeNoError) || (session->StartRender() != vfeNoError))
+        {
+            PrintStatus(session);
+            job->Fail(session->GetErrorString());
+            continue;
+        }
+
+        vfeStatusFlags flags;
+        session->SetEventMask(stBackendStateChanged);  // immediately notify this event
+        while (((flags = session->GetStatus(true, 200)) & stRenderShutdown) == 0)
+        {
+            ProcessSignal();
+            if (gCancelRender)
+            {
+                // stop taking blocks from the coordinator, so the render threads wind down
+                job->Close();
+                CancelRender(session);
+                break;
+            }
+
+            if (flags & stAnyMessage)
+                PrintStatus(session);
+            if (flags & stBackendStateChanged)
+                PrintStatusChanged(session);
+        }
+        PrintStatus(session);
+
+        if (session->Failed())
+            job->Fail(session->GetErrorString());
+        job->Close();
+    }
+
+    return gCancelRender ? RETURN_USER_ABORT : RETURN_OK;
+}
+
+// Serve render jobs submitted via the given local socket until interrupted or asked to shut
+// down; each job is rendered with the given default options, plus the options of the job.
+// returns the most specific description of why the current render server job failed
+static std::string GetRenderServerError(vfeUnixSession *session, int err = vfeNoError)
+{
+    std::string str(session->GetLastErrorMessage());
+    if (!str.empty())
+        return str;
+    if (err != vfeNoError)
+        return session->GetErrorString(err);
+    return "Render failed";
+}
+
+// whether the options of the current render server job would have POV-Ray run
+// commands of its own; jobs arrive from other processes, which must not be able
+// to do so on behalf of the server.
+static bool HasShelloutCommands(vfeUnixSession *session)
+{
+    static const char *const kShelloutOptions[] =
+    {
+        "Pre_Scene_Command", "Pre_Frame_Command", "Post_Scene_Command",
+        "Post_Frame_Command", "User_Abort_Command", "Fatal_Error_Command"
+    };
+    for (const char *option : kShelloutOptions)
+        if (session->OptionPresent(option))
+            return true;
+    return false;
+}
+
+static ReturnValue RunRenderServer(vfeUnixSession *session, const vfeRenderOptions& defaults, const std::string& socketPath)
+{
+    std::unique_ptr<UnixRenderServer> server;
+    try
+    {
+        server.reset(new UnixRenderServer(socketPath));
+    }
+    catch (pov_base::Exception& e)
+    {
+        fprintf(stderr, "%s: %s\n", PACKAGE, e.what());
+        return RETURN_ERROR;
+    }
+
+    fprintf(stderr, "%s: waiting for render jobs on %s\n", PACKAGE, socketPath.c_str());
+
+    while (!gCancelRender)
+    {
+        std::shared_ptr<UnixRenderJob> job(server->NextJob(KeepWaitingForRenderJob));
+        if (job == nullptr)
+            break;
+
+        fprintf(stderr, "%s: rendering job for %s (%d more queued)\n", PACKAGE, job->GetClientName().c_str(), int(server->GetQueueLength()));
+
+        vfeRenderOptions opts(defaults);
+        opts.AddCommand(job->GetOptions());
+
+        int err;
+        session->Clear(false);
+        if ((err = session->SetOptions(opts)) != vfeNoError)
+        {
+            PrintStatus(session);
+            job->Reply(false, GetRenderServerError(session, err));
+            continue;
+        }
+        if (HasShelloutCommands(session))
+        {
+            fprintf(stderr, "%s: rejecting job for %s: shell-out commands are not permitted\n", PACKAGE, job->GetClientName().c_str());
+            job->Reply(false, "Shell-out commands are not permitted in render server jobs");
+            continue;
+        }
+        if ((err = session->StartRender()) != vfeNoError)
+        {
+            PrintStatus(session);
+            job->Reply(false, GetRenderServerError(session, err));
+            continue;
+        }
+
+        vfeStatusFlags flags;
+        session->SetEventMask(stBackendStateChanged);  // immediately notify this event
+        while (((flags = session->GetStatus(true, 200)) & stRenderShutdown) == 0)
+        {
+            // keep queueing jobs while we render
+            server->Poll();
+
+            ProcessSignal();
+            if (gCancelRender)
+            {
+                CancelRender(session);
+                break;
+            }
+
+            if (flags & stAnyMessage)
+                PrintStatus(session);
+            if (flags & stBackendStateChanged)
+                PrintStatusChanged(session);
+        }
+        PrintStatus(session);
+
+        if (session->Succeeded())
+            job->Reply(true);
+        else
+            job->Reply(false, gCancelRender ? std::string("Render cancelled") : GetRenderServerError(session));
+    }
+
+    return gCancelRender ? RETURN_USER_ABORT : RETURN_OK;
+}
+
 static void TerminateSignalHandler(std::thread* sigthread)
 {
     gTerminateSignalHandler = true;
@@ -560,6 +760,18 @@ int main (int argc, char **argv)
         }
     }
 
+    else if (session->GetUnixOptions()->QueryOptionString("general", "rendernode") != "")
+    {
+        // render nodes take their options from the coordinator, rather than povray.ini
+        retval = RunRenderNode(session, opts, session->GetUnixOptions()->QueryOptionInt("general", "rendernode", 0), argv + 1);
+        session->Shutdown();
+        PrintStatus(session);
+        TerminateSignalHandler(sigthread);
+        delete sigthread;
+        delete session;
+        return retval;
+    }
+
     // process INI settings
     if (running_benchmark)
     {
@@ -575,10 +787,30 @@ int main (int argc, char **argv)
         session->GetUnixOptions()->Process_povray_ini(opts);
         if (s != nullptr)
             opts.AddLibraryPath (s);
+        if (session->GetUnixOptions()->QueryOptionString("general", "renderserver") != "")
+        {
+            // the render server has no display, and keeps parsed scenes around for re-use by
+            // subsequent jobs; the command line may still override this
+            opts.AddCommand("-D");
+            opts.AddCommand("-P");
+            opts.AddCommand("Reuse_Scene=on");
+            opts.AddCommand("Reuse_Scene_Count=4");
+        }
         while (*++argv)
             opts.AddCommand (*argv);
     }
 
+    if (!running_benchmark && (session->GetUnixOptions()->QueryOptionString("general", "renderserver") != ""))
+    {
+        retval = RunRenderServer(session, opts, session->GetUnixOptions()->QueryOptionString("general", "renderserver"));
+        session->Shutdown();
+        PrintStatus(session);
+        TerminateSignalHandler(sigthread);
+        delete sigthread;
+        delete session;
+        return retval;
+    }
+
     // set all options and start rendering
     if (session->SetOptions(opts) != vfeNoError)
     {
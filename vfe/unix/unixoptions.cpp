@@ -70,6 +70,11 @@ namespace vfePlatform
         UnixOptionsProcessor::Option_Info("general", "version", "off", false, "--version|-version|--V", "", "display program version"),
         UnixOptionsProcessor::Option_Info("general", "generation", "off", false, "--generation", "", "display program generation (short version number)"),
         UnixOptionsProcessor::Option_Info("general", "benchmark", "off", false, "--benchmark|-benchmark", "", "run the standard POV-Ray benchmark"),
+        UnixOptionsProcessor::Option_Info("general", "rendernode", "", true, "--render-node|-render-node", "", "serve render jobs of a coordinator on the given TCP port"),
+        UnixOptionsProcessor::Option_Info("general", "rendernodebind", "", true, "--render-node-bind|-render-node-bind", "", "local address for a render node to listen on (default 127.0.0.1)"),
+        UnixOptionsProcessor::Option_Info("general", "rendernodetoken", "", true, "--render-node-token|-render-node-token", "POV_RENDER_NODE_TOKEN", "token coordinators have to present to a render node"),
+        UnixOptionsProcessor::Option_Info("general", "rendernodemaxjob", "", true, "--render-node-max-job|-render-node-max-job", "", "limit in MB for the files of a render node job (default 1024)"),
+        UnixOptionsProcessor::Option_Info("general", "renderserver", "", true, "--render-server|-render-server", "", "serve render jobs submitted via the given local socket"),
         UnixOptionsProcessor::Option_Info("", "", "", false, "", "", "") // has to be last
     };
 
@@ -0,0 +1,195 @@
+//******************************************************************************
+///
+/// @file vfe/unix/unixrenderserver.cpp
+///
+/// Local socket interface of the persistent render server.
+///
+/// @copyright
+/// @parblock
+///
+/// Persistence of Vision Ray Tracer ('POV-Ray') version 3.8.
+/// Copyright 1991-2019 Persistence of Vision Raytracer Pty. Ltd.
+///
+/// POV-Ray is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU Affero General Public License as
+/// published by the Free Software Foundation, either version 3 of the
+/// License, or (at your option) any later version.
+///
+/// POV-Ray is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU Affero General Public License for more details.
+///
+/// You should have received a copy of the GNU Affero General Public License
+/// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+///
+/// ----------------------------------------------------------------------------
+///
+/// POV-Ray is based on the popular DKB raytracer version 2.12.
+/// DKBTrace was originally written by David K. Buck.
+/// DKBTrace Ver 2.0-2.12 were written by David K. Buck & Aaron A. Collins.
+///
+/// @endparblock
+///
+//*******************************************************************************
+
+#include "unixrenderserver.h"
+
+#include <chrono>
+#include <istream>
+
+#include <boost/asio.hpp>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "base/pov_err.h"
+
+namespace vfePlatform
+{
+    using boost::asio::local::stream_protocol;
+
+    /// Interval at which to check back with the caller while waiting for a job.
+    static const std::chrono::milliseconds kRenderServerPollInterval(100);
+
+    struct UnixRenderJob::Client final
+    {
+        stream_protocol::socket socket;
+        boost::asio::streambuf buffer;
+        std::string name;
+
+        Client(boost::asio::io_context& context, int id) : socket(context), name("client " + std::to_string(id)) {}
+    };
+
+    UnixRenderJob::UnixRenderJob(const std::shared_ptr<Client>& client, const std::string& line) :
+        m_Client(client),
+        m_Options(line),
+        m_ClientName(client->name)
+    {
+    }
+
+    void UnixRenderJob::Reply(bool success, const std::string& text)
+    {
+        std::string line(success ? "OK" : "FAILED");
+        if (!text.empty())
+        {
+            line += ' ';
+            for (char c : text)
+                line += ((c == '\n') || (c == '\r')) ? ' ' : c;
+        }
+        line += '\n';
+
+        boost::system::error_code ec;
+        boost::asio::write(m_Client->socket, boost::asio::buffer(line), ec);
+    }
+
+    struct UnixRenderServer::Impl final
+    {
+        boost::asio::io_context     context;
+        stream_protocol::acceptor   acceptor;
+        int                         nextClientId;
+
+        Impl() : acceptor(context), nextClientId(1) {}
+    };
+
+    UnixRenderServer::UnixRenderServer(const std::string& socketPath) :
+        m_Impl(new Impl()),
+        m_SocketPath(socketPath),
+        m_Shutdown(false)
+    {
+        // a socket left behind by a previous server would prevent us from binding;
+        // anything else by that name we leave alone, and fail below
+        struct stat st;
+        if ((lstat(socketPath.c_str(), &st) == 0) && S_ISSOCK(st.st_mode))
+            unlink(socketPath.c_str());
+
+        boost::system::error_code ec;
+        stream_protocol::endpoint endpoint(socketPath);
+        m_Impl->acceptor.open(endpoint.protocol(), ec);
+        if (!ec)
+            m_Impl->acceptor.bind(endpoint, ec);
+        if (!ec)
+            m_Impl->acceptor.listen(boost::asio::socket_base::max_listen_connections, ec);
+        if (ec)
+            throw POV_EXCEPTION(pov_base::kNetworkConnectionErr, "Cannot listen on '" + socketPath + "': " + ec.message());
+
+        StartAccept();
+    }
+
+    UnixRenderServer::~UnixRenderServer()
+    {
+        // pending handlers (and the clients they refer to) go away along with the context
+        m_Jobs.clear();
+        boost::system::error_code ec;
+        m_Impl->acceptor.close(ec);
+        m_Impl.reset();
+        unlink(m_SocketPath.c_str());
+    }
+
+    std::shared_ptr<UnixRenderJob> UnixRenderServer::NextJob(const boost::function<bool()>& keepWaiting)
+    {
+        while (m_Jobs.empty() && !m_Shutdown)
+        {
+            m_Impl->context.restart();
+            m_Impl->context.run_for(kRenderServerPollInterval);
+            if (m_Jobs.empty() && !keepWaiting())
+                return nullptr;
+        }
+
+        if (m_Shutdown)
+        {
+            for (auto& job : m_Jobs)
+                job->Reply(false, "Render server shutting down");
+            m_Jobs.clear();
+            return nullptr;
+        }
+
+        std::shared_ptr<UnixRenderJob> job(m_Jobs.front());
+        m_Jobs.pop_front();
+        return job;
+    }
+
+    void UnixRenderServer::Poll()
+    {
+        m_Impl->context.restart();
+        m_Impl->context.poll();
+    }
+
+    void UnixRenderServer::StartAccept()
+    {
+        std::shared_ptr<UnixRenderJob::Client> client(new UnixRenderJob::Client(m_Impl->context, m_Impl->nextClientId++));
+        m_Impl->acceptor.async_accept(client->socket, [this, client](const boost::system::error_code& ec)
+        {
+            if (ec == boost::asio::error::operation_aborted)
+                return;
+            if (!ec)
+                StartRead(client);
+            StartAccept();
+        });
+    }
+
+    void UnixRenderServer::StartRead(const std::shared_ptr<UnixRenderJob::Client>& client)
+    {
+        boost::asio::async_read_until(client->socket, client->buffer, '\n', [this, client](const boost::system::error_code& ec, size_t)
+        {
+            // a client that has gone away simply stops submitting jobs; any of its jobs
+            // already queued are still processed
+            if (ec)
+                return;
+
+            std::istream stream(&client->buffer);
+            std::string line;
+            std::getline(stream, line);
+            if (!line.empty() && (line.back() == '\r'))
+                line.pop_back();
+
+            if (line == "SHUTDOWN")
+                m_Shutdown = true;
+            else if (line.find_first_not_of(" \t") != std::string::npos)
+                m_Jobs.push_back(std::shared_ptr<UnixRenderJob>(new UnixRenderJob(client, line)));
+
+            StartRead(client);
+        });
+    }
+}
+// end of namespace vfePlatform
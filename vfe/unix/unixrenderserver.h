@@ -0,0 +1,141 @@
+//******************************************************************************
+///
+/// @file vfe/unix/unixrenderserver.h
+///
+/// Local socket interface of the persistent render server.
+///
+/// @copyright
+/// @parblock
+///
+/// Persistence of Vision Ray Tracer ('POV-Ray') version 3.8.
+/// Copyright 1991-2019 Persistence of Vision Raytracer Pty. Ltd.
+///
+/// POV-Ray is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU Affero General Public License as
+/// published by the Free Software Foundation, either version 3 of the
+/// License, or (at your option) any later version.
+///
+/// POV-Ray is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU Affero General Public License for more details.
+///
+/// You should have received a copy of the GNU Affero General Public License
+/// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+///
+/// ----------------------------------------------------------------------------
+///
+/// POV-Ray is based on the popular DKB raytracer version 2.12.
+/// DKBTrace was originally written by David K. Buck.
+/// DKBTrace Ver 2.0-2.12 were written by David K. Buck & Aaron A. Collins.
+///
+/// @endparblock
+///
+//*******************************************************************************
+
+#ifndef POVRAY_VFE_UNIX_UNIXRENDERSERVER_H
+#define POVRAY_VFE_UNIX_UNIXRENDERSERVER_H
+
+#include <deque>
+#include <memory>
+#include <string>
+
+#include <boost/function.hpp>
+
+namespace vfePlatform
+{
+    class UnixRenderServer;
+
+    /**
+        @brief Render job submitted to the render server.
+
+        A job is a single line of text sent by a client, holding options in the
+        same form as given on the command line (e.g. `scene.pov +W640 +H480`),
+        and subject to the same quoting rules. Once the job has been processed,
+        a single line is sent back to the client, reading either `OK` or
+        `FAILED` followed by a description of the problem.
+    */
+    class UnixRenderJob final
+    {
+        public:
+            /// Options of the job, in command-line form.
+            const std::string& GetOptions() const { return m_Options; }
+
+            /// Name of the client, for display purposes.
+            const std::string& GetClientName() const { return m_ClientName; }
+
+            /// Send the outcome of the job to the client.
+            /// Any failure to do so (e.g. because the client has gone away) is silently ignored.
+            void Reply(bool success, const std::string& text = std::string());
+
+        private:
+            struct Client;
+
+            std::shared_ptr<Client> m_Client;
+            std::string m_Options;
+            std::string m_ClientName;
+
+            UnixRenderJob(const std::shared_ptr<Client>& client, const std::string& line);
+
+            friend class UnixRenderServer;
+    };
+
+    /**
+        @brief Persistent render server listening on a local (Unix domain) socket.
+
+        Any number of clients may connect to the server at any time, and each
+        may submit any number of jobs; the jobs are queued and handed out in
+        the order they have been received. The server does all its work from
+        within @ref NextJob() and @ref Poll(), and is therefore not thread-safe.
+
+        A line reading `SHUTDOWN` makes the server stop taking jobs.
+
+        Each job is answered with a line reading `OK`, or `FAILED` followed by
+        the text of the error that made the job fail.
+
+        @note
+            There is no authentication of any kind; access to the server is
+            controlled solely by the file permissions of the socket. Jobs that
+            specify shell-out commands are rejected.
+    */
+    class UnixRenderServer final
+    {
+        public:
+            /// Start listening on the given socket, replacing any stale socket file.
+            UnixRenderServer(const std::string& socketPath);
+            ~UnixRenderServer();
+
+            UnixRenderServer(const UnixRenderServer&) = delete;
+            UnixRenderServer& operator=(const UnixRenderServer&) = delete;
+
+            /// Wait for the next job.
+            /// @param  keepWaiting     Function to be called periodically while waiting;
+            ///                         waiting is abandoned as soon as it returns `false`.
+            /// @return The job, or `nullptr` if waiting was abandoned or the server shut down.
+            std::shared_ptr<UnixRenderJob> NextJob(const boost::function<bool()>& keepWaiting);
+
+            /// Accept new clients and queue their jobs, without waiting.
+            /// To be called periodically while a job is being processed.
+            void Poll();
+
+            /// Number of jobs waiting to be processed.
+            size_t GetQueueLength() const { return m_Jobs.size(); }
+
+            /// Whether a client has asked the server to shut down.
+            bool ShutdownRequested() const { return m_Shutdown; }
+
+        private:
+            struct Impl;
+
+            std::unique_ptr<Impl> m_Impl;
+            std::deque<std::shared_ptr<UnixRenderJob>> m_Jobs;
+            std::string m_SocketPath;
+            bool m_Shutdown;
+
+            void StartAccept();
+            void StartRead(const std::shared_ptr<UnixRenderJob::Client>& client);
+    };
+}
+// end of namespace vfePlatform
+
+#endif // POVRAY_VFE_UNIX_UNIXRENDERSERVER_H
@@ -61,6 +61,7 @@
 #ifdef HAVE_SYS_WAIT_H
 # include <sys/wait.h>
 #endif
+#include <unistd.h>
 
 // from directory "vfe"
 #include "vfe.h"
@@ -171,6 +172,28 @@ namespace vfePlatform
         pov_base::Filesystem::DeleteFile(filename);
     }
 
+    //////////////////////////////////////////////////////////////
+    // Process related support functions
+    //////////////////////////////////////////////////////////////
+
+    /////////////////////////////////////////////////////////////////////////
+    // the resident set size is only available where there is a Linux-style
+    // /proc file system; getrusage() only reports its peak.
+    bool vfeUnixSession::GetProcessMemoryUsage(POV_ULONG& bytes) const
+    {
+        FILE *f = fopen("/proc/self/statm", "r");
+        if (f == nullptr)
+            return false;
+        unsigned long size, resident;
+        bool ok = (fscanf(f, "%lu %lu", &size, &resident) == 2);
+        fclose(f);
+        long pageSize = sysconf(_SC_PAGESIZE);
+        if (!ok || (pageSize <= 0))
+            return false;
+        bytes = static_cast<POV_ULONG>(resident) * static_cast<POV_ULONG>(pageSize);
+        return true;
+    }
+
     //////////////////////////////////////////////////////////////
     // vfe or POVMS related support functions
     //////////////////////////////////////////////////////////////
@@ -96,6 +96,7 @@ namespace vfePlatform
             virtual UCS2String GetTemporaryPath(void) const override;
             virtual UCS2String CreateTemporaryFile(void) const override;
             virtual void DeleteTemporaryFile(const UCS2String& filename) const override;
+            virtual bool GetProcessMemoryUsage(POV_ULONG& bytes) const override;
             virtual POV_LONG GetTimestamp(void) const override;
             virtual void NotifyCriticalError(const char *message, const char *file, int line) override;
             virtual int RequestNewOutputPath(int CallCount, const std::string& Reason, const UCS2String& OldPath, UCS2String& NewPath) override;
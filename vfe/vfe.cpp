@@ -45,6 +45,8 @@
 #include <cstdarg>
 #include <cstdio>
 
+#include <algorithm>
+
 #include <boost/bind.hpp>
 #include <boost/format.hpp>
 
@@ -280,6 +282,11 @@ bool vfePlatformBase::AllowLocalFileAccess (const UCS2String& name, const unsign
         return Allow_File_Read (name.c_str(), fileType);
 }
 
+bool vfePlatformBase::GetProcessMemoryUsage(POV_ULONG& bytes)
+{
+  return m_Session->GetProcessMemoryUsage(bytes);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////
 //
 // class vfeParserMessageHandler
@@ -403,8 +410,18 @@ void vfeParserMessageHandler::Error(Console *Con, POVMS_Object& Obj, bool conout
 
 void vfeParserMessageHandler::FatalError(Console *Con, POVMS_Object& Obj, bool conout)
 {
+  ParseErrorDetails     d (Obj) ;
+
   m_Session->SetFailed();
   Error (Con, Obj, conout) ;
+
+  // make sure the error can be reported even if it went to the console only
+  if (!d.Message.empty() && !d.File.empty() && (d.Line > 0))
+    m_Session->SetLastErrorMessage ((format ("File '%s' line %d: %s") % d.File % d.Line % d.Message).str()) ;
+  else if (!d.Message.empty())
+    m_Session->SetLastErrorMessage (d.Message) ;
+  else
+    m_Session->SetLastErrorMessage ((format ("Parse error in file '%s' at line %d") % d.File % d.Line).str()) ;
 }
 
 void vfeParserMessageHandler::DebugInfo(Console *Con, POVMS_Object& Obj, bool conout)
@@ -506,6 +523,11 @@ void vfeRenderMessageHandler::FatalError(Console *Con, POVMS_Object& Obj, bool c
 {
   m_Session->SetFailed();
   RenderMessageHandler::FatalError (Con, Obj, conout) ;
+
+  // make sure the error can be reported even if it went to the console only
+  string str(Obj.TryGetString(kPOVAttrib_EnglishText, ""));
+  if (!str.empty())
+    m_Session->SetLastErrorMessage (str) ;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -600,6 +622,42 @@ void vfeProcessRenderOptions::WriteError(const char *format, ...)
 //
 ////////////////////////////////////////////////////////////////////////////////////////
 
+// collects all options that affect how a scene is parsed, in a form suitable for comparison.
+// (the content of the files read while parsing is checked separately, see RenderFrontend::IsSceneUpToDate().)
+static string GetParseOptionsKey(POVMS_Object& opts)
+{
+  struct KeyStream final
+  {
+    string data;
+    bool write(void *ptr, size_t cnt) { data.append(reinterpret_cast<const char *>(ptr), cnt); return true; }
+  };
+
+  static const POVMSType parseOptions[] =
+  {
+    kPOVAttrib_InputFile, kPOVAttrib_IncludeHeader, kPOVAttrib_LibraryPath, kPOVAttrib_Version,
+    kPOVAttrib_WarningLevel, kPOVAttrib_Declare, kPOVAttrib_Clock, kPOVAttrib_Width, kPOVAttrib_Height,
+    kPOVAttrib_OutputFileType, kPOVAttrib_OutputAlpha, kPOVAttrib_ClocklessAnimation, kPOVAttrib_RealTimeRaytracing,
+    kPOVAttrib_SplitUnions, kPOVAttrib_RemoveBounds, kPOVAttrib_Bounding, kPOVAttrib_BoundingMethod,
+    kPOVAttrib_BoundingThreshold, kPOVAttrib_BSP_MaxDepth, kPOVAttrib_BSP_ISectCost, kPOVAttrib_BSP_BaseAccessCost,
+    kPOVAttrib_BSP_ChildAccessCost, kPOVAttrib_BSP_MissChance, kPOVAttrib_ProfileObjects, kPOVAttrib_IncludeCachePath
+  };
+
+  POVMS_Object key(kPOVObjectClass_ParserOptions);
+  for (POVMSType attr : parseOptions)
+  {
+    if (opts.Exist(attr))
+    {
+      POVMS_Attribute value;
+      opts.Get(attr, value);
+      key.Set(attr, value);
+    }
+  }
+
+  KeyStream stream;
+  key.Write(stream);
+  return stream.data;
+}
+
 VirtualFrontEnd::VirtualFrontEnd(vfeSession& session, POVMSContext ctx, POVMSAddress addr, POVMS_Object& msg, POVMS_Object *result, shared_ptr<Console>& console) :
   m_Session(&session), m_PlatformBase(session), renderFrontend (ctx)
 {
@@ -609,6 +667,10 @@ VirtualFrontEnd::VirtualFrontEnd(vfeSession& session, POVMSContext ctx, POVMSAdd
   consoleResult = nullptr;
   displayResult = nullptr;
   m_PauseRequested = m_PausedAfterFrame = false;
+  m_IntermediateOutputInterval = 0;
+  m_NextScenePending = m_PipelineFrames = false;
+  m_ReuseScene = false;
+  m_RetainedSceneLimit = 0;
   renderFrontend.ConnectToBackend(backendAddress, msg, result, console);
 }
 
@@ -619,7 +681,10 @@ VirtualFrontEnd::~VirtualFrontEnd()
   // before the shared_ptr does its cleanup
   imageProcessing.reset();
   if (backendAddress != POVMSInvalidAddress)
+  {
+    CloseRetainedScenes(0);
     renderFrontend.DisconnectFromBackend(backendAddress);
+  }
   state = kUnknown;
 }
 
@@ -659,7 +724,8 @@ bool VirtualFrontEnd::Start(POVMS_Object& opts)
 
   int initialFrame = opts.TryGetInt (kPOVAttrib_InitialFrame, 0) ;
   int finalFrame = opts.TryGetInt (kPOVAttrib_FinalFrame, 0) ;
-  if ((initialFrame == 0 && finalFrame == 0) || (initialFrame == 1 && finalFrame == 1))
+  // a render node renders a single frame on behalf of a coordinator, which has already declared the clock values
+  if (((initialFrame == 0 && finalFrame == 0) || (initialFrame == 1 && finalFrame == 1)) && !opts.Exist(kPOVAttrib_RenderNodeJob))
   {
     POVMS_Object clock_delta(kPOVMSType_WildCard);
     clock_delta.SetString(kPOVAttrib_Identifier, "clock_delta");
@@ -739,6 +805,17 @@ bool VirtualFrontEnd::Start(POVMS_Object& opts)
     options = animationProcessing->GetFrameRenderOptions () ;
   }
 
+  // frame shellouts may create or modify files the next frame depends on, so we can't run ahead of them
+  m_PipelineFrames = (animationProcessing != nullptr) && opts.TryGetBool(kPOVAttrib_PipelineAnimation, false) &&
+                     !shelloutProcessing->IsSet(ShelloutProcessing::preFrame) &&
+                     !shelloutProcessing->IsSet(ShelloutProcessing::postFrame);
+  POV_ULONG memoryUsage;
+  if (m_PipelineFrames && (opts.TryGetInt(kPOVAttrib_PipelineMemoryLimit, 0) > 0) && !m_PlatformBase.GetProcessMemoryUsage(memoryUsage))
+    throw POV_EXCEPTION(kParamErr, "Pipeline_Memory_Limit is not supported on this platform, as the memory usage of the process can't be determined.");
+  m_NextScenePending = false;
+  m_ReuseScene = (animationProcessing == nullptr) && opts.TryGetBool(kPOVAttrib_ReuseScene, false);
+  m_RetainedSceneLimit = m_ReuseScene ? size_t(std::max(opts.TryGetInt(kPOVAttrib_ReuseSceneCount, 1), 1)) : 0;
+
   state = kStarting;
 
   return true;
@@ -800,6 +877,9 @@ bool VirtualFrontEnd::Stop()
         }
         else
         {
+          // in progressive mode, keep the most refined image we have got so far
+          if (m_IntermediateOutputInterval > 0)
+            WriteIntermediateImage(true);
           // the renderer could be already in a finished state, even if it accepted a pause earlier
           try { renderFrontend.StopRender(viewId); } catch (pov_base::Exception&) { }
           state = kStopping;
@@ -905,6 +985,126 @@ bool VirtualFrontEnd::Resume()
   return false;
 }
 
+// Write the image rendered so far to the output file, e.g. during a progressive render.
+// The image is written in the background; if it is still being written when the next one is due,
+// that one is skipped. If `wait` is set, the image is written in any case, and complete on return.
+// Failure to do so is reported, but not considered fatal to the render.
+void VirtualFrontEnd::WriteIntermediateImage(bool wait)
+{
+  if ((imageProcessing == nullptr) || !m_Session->OutputToFileSet())
+    return;
+
+  try
+  {
+    if (wait)
+      imageProcessing->FinishIntermediateImage();
+  }
+  catch (pov_base::Exception& e)
+  {
+    m_Session->AppendStatusMessage (e.what()) ;
+  }
+  try
+  {
+    if (animationProcessing != nullptr)
+      imageProcessing->StartIntermediateImage(options, animationProcessing->GetNominalFrameNumber(), animationProcessing->GetFrameNumberDigits());
+    else
+      imageProcessing->StartIntermediateImage(options);
+    if (wait)
+      imageProcessing->FinishIntermediateImage();
+  }
+  catch (pov_base::Exception& e)
+  {
+    m_Session->AppendStatusMessage (e.what()) ;
+  }
+  m_IntermediateOutputTimer.Reset();
+}
+
+// start parsing the next animation frame while the current one is rendering.
+// the scene is picked up by kPreFrameShellout once the current frame has been
+// written, so frames are still completed strictly in order.
+void VirtualFrontEnd::StartNextFrameParser()
+{
+  if (m_NextScenePending || (animationProcessing == nullptr) || !animationProcessing->MoreFrames())
+    return;
+
+  // we only run one frame ahead; if a memory limit is given, we also need to expect
+  // the next frame's scene (assumed to be about as large as the current one) to fit.
+  // Start() has made sure that the platform can tell us the memory usage of the process.
+  POV_ULONG limit = static_cast<POV_ULONG>(std::max(options.TryGetInt(kPOVAttrib_PipelineMemoryLimit, 0), 0)) * 1024 * 1024;
+  POV_ULONG current;
+  if ((limit > 0) && (!m_PlatformBase.GetProcessMemoryUsage(current) || (current * 2 > limit)))
+    return;
+
+  AnimationProcessing nextFrame(*animationProcessing);
+  nextFrame.ComputeNextFrame();
+  POVMS_Object opts(nextFrame.GetFrameRenderOptions());
+  if (m_Session->OutputToFileSet())
+  {
+    UCS2String filename = imageProcessing->GetOutputFilename (opts, nextFrame.GetNominalFrameNumber(), nextFrame.GetFrameNumberDigits());
+    opts.SetUCS2String (kPOVAttrib_OutputFile, filename.c_str());
+  }
+
+  try
+  {
+    m_NextSceneId = renderFrontend.CreateScene(backendAddress, opts, boost::bind(&vfe::VirtualFrontEnd::CreateConsole, this));
+  }
+  catch (pov_base::Exception&)
+  {
+    // not fatal; the frame will simply be parsed in the regular way
+    m_PipelineFrames = false;
+    return;
+  }
+  m_NextScenePending = true;
+
+  try
+  {
+    renderFrontend.StartParser(m_NextSceneId, opts);
+  }
+  catch (pov_base::Exception&)
+  {
+    m_PipelineFrames = false;
+    CloseNextFrameScene();
+  }
+}
+
+// closes the least recently used retained scenes until no more than the specified number remain.
+void VirtualFrontEnd::CloseRetainedScenes(size_t keep)
+{
+  while (m_RetainedScenes.size() > keep)
+  {
+    try { renderFrontend.CloseScene(m_RetainedScenes.back().second); }
+    catch (pov_base::Exception&) { /* Ignore any error here! */ }
+    m_RetainedScenes.pop_back();
+  }
+}
+
+// returns false if a look-ahead parse is still winding down.
+bool VirtualFrontEnd::CloseNextFrameScene()
+{
+  if (!m_NextScenePending)
+    return true;
+
+  switch (renderFrontend.GetSceneState(m_NextSceneId))
+  {
+    case SceneData::Scene_Parsing:
+    case SceneData::Scene_Paused:
+      try { renderFrontend.StopParser(m_NextSceneId); }
+      catch (pov_base::Exception&) { /* Ignore any error here! */ }
+      return false;
+
+    case SceneData::Scene_Stopping:
+      return false;
+
+    default:
+      break;
+  }
+
+  try { renderFrontend.CloseScene(m_NextSceneId); }
+  catch (pov_base::Exception&) { /* Ignore any error here! */ }
+  m_NextScenePending = false;
+  return true;
+}
+
 bool VirtualFrontEnd::HandleShelloutCancel()
 {
   if (!shelloutProcessing->RenderCancelled())
@@ -1051,6 +1251,49 @@ State VirtualFrontEnd::Process()
         }
       }
 
+      // if the scene has already been parsed (or is being parsed) while the previous frame rendered, pick it up
+      if (m_NextScenePending)
+      {
+        sceneId = m_NextSceneId;
+        m_NextScenePending = false;
+        if (m_PauseRequested)
+        {
+          m_PostPauseState = kParsing;
+          m_PauseRequested = false;
+          return state = kPostShelloutPause;
+        }
+        return state = kParsing;
+      }
+
+      // likewise if the scene has been kept from the previous render, provided it would have been parsed the same way
+      // (the key is taken now, as the options may change by the time the scene is retained.)
+      if (m_ReuseScene)
+      {
+        m_SceneKey = GetParseOptionsKey(options);
+        for (RetainedSceneList::iterator i = m_RetainedScenes.begin(); i != m_RetainedScenes.end(); i++)
+        {
+          if ((i->first == m_SceneKey) && (renderFrontend.GetSceneState(i->second) == SceneData::Scene_Ready))
+          {
+            if (!renderFrontend.IsSceneUpToDate(i->second))
+            {
+              // the scene file or one of the files it reads has changed; this scene is of no further use
+              try { renderFrontend.CloseScene(i->second); }
+              catch (pov_base::Exception&) { /* Ignore any error here! */ }
+              m_RetainedScenes.erase(i);
+              m_Session->AppendStreamMessage (vfeSession::mInformation, "Scene files changed since previous render; parsing again.") ;
+              break;
+            }
+            sceneId = i->second;
+            m_RetainedScenes.erase(i);
+            CloseRetainedScenes(m_RetainedSceneLimit - 1);
+            m_Session->AppendStreamMessage (vfeSession::mInformation, "Re-using scene parsed by previous render.") ;
+            return state = kParsing;
+          }
+        }
+      }
+      // make room for the scene about to be parsed
+      CloseRetainedScenes(m_RetainedSceneLimit > 0 ? m_RetainedSceneLimit - 1 : 0);
+
       // now set up the scene in preparation for parsing, then start the parser
       try { sceneId = renderFrontend.CreateScene(backendAddress, options, boost::bind(&vfe::VirtualFrontEnd::CreateConsole, this)); }
       catch(pov_base::Exception& e)
@@ -1157,6 +1400,11 @@ State VirtualFrontEnd::Process()
                 disp->Show () ;
             }
           }
+          if (options.TryGetBool(kPOVAttrib_ProgressiveRefinement, false))
+            m_IntermediateOutputInterval = POV_LONG(std::max(options.TryGetFloat(kPOVAttrib_ProgressiveOutputInterval, 10.0f), 0.0f) * 1000.0);
+          else
+            m_IntermediateOutputInterval = 0;
+          m_IntermediateOutputTimer.Reset();
           return state = kRendering;
 
         default:
@@ -1231,6 +1479,11 @@ State VirtualFrontEnd::Process()
         default:
           break;
       }
+      if ((state == kRendering) && (m_IntermediateOutputInterval > 0) &&
+          (m_IntermediateOutputTimer.ElapsedRealTime() >= m_IntermediateOutputInterval))
+        WriteIntermediateImage();
+      if ((state == kRendering) && m_PipelineFrames && !m_NextScenePending)
+        StartNextFrameParser();
       return kRendering;
 
     case kPostFrameShellout:
@@ -1307,10 +1560,23 @@ State VirtualFrontEnd::Process()
       return state = kStopped;
 
     case kStopped:
+      // a look-ahead parse has to wind down before its scene can be closed
+      if (!CloseNextFrameScene())
+        return state;
       try { renderFrontend.CloseView(viewId); }
       catch (pov_base::Exception&) { /* Ignore any error here! */ }
-      try { renderFrontend.CloseScene(sceneId); }
-      catch (pov_base::Exception&) { /* Ignore any error here! */ }
+      if (m_ReuseScene && !m_Session->Failed() && (renderFrontend.GetSceneState(sceneId) == SceneData::Scene_Ready))
+      {
+        // keep the scene around for the next render
+        m_RetainedScenes.push_front(std::make_pair(m_SceneKey, sceneId));
+        CloseRetainedScenes(m_RetainedSceneLimit);
+        sceneId = RenderFrontendBase::SceneId();
+      }
+      else
+      {
+        try { renderFrontend.CloseScene(sceneId); }
+        catch (pov_base::Exception&) { /* Ignore any error here! */ }
+      }
       animationProcessing.reset();
       imageProcessing.reset();
 
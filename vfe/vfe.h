@@ -38,7 +38,10 @@
 #ifndef POVRAY_VFE_VFE_H
 #define POVRAY_VFE_VFE_H
 
+#include <list>
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "base/platformbase.h"
@@ -129,6 +132,7 @@ namespace vfe
       virtual bool ReadFileFromURL(OStream *file, const UCS2String& url, const UCS2String& referrer = UCS2String()) override;
       virtual FILE* OpenLocalFile (const UCS2String& name, const char *mode) override;
       virtual bool AllowLocalFileAccess (const UCS2String& name, const unsigned int fileType, bool write) override;
+      virtual bool GetProcessMemoryUsage(POV_ULONG& bytes) override;
 
     protected:
       vfeSession* m_Session;
@@ -239,6 +243,10 @@ namespace vfe
       virtual Display *CreateDisplay(unsigned int width, unsigned int height)
         { return m_Session->CreateDisplay(width, height) ; }
       bool HandleShelloutCancel();
+      void WriteIntermediateImage(bool wait = false);
+      void StartNextFrameParser();
+      bool CloseNextFrameScene();
+      void CloseRetainedScenes(size_t keep);
 
       RenderFrontend<vfeParserMessageHandler,FileMessageHandler,vfeRenderMessageHandler,ImageMessageHandler> renderFrontend;
       POVMSAddress backendAddress;
@@ -256,6 +264,18 @@ namespace vfe
       bool m_PausedAfterFrame;
       bool m_PauseRequested;
       State m_PostPauseState;
+      pov_base::Timer m_IntermediateOutputTimer;
+      POV_LONG m_IntermediateOutputInterval;
+      RenderFrontendBase::SceneId m_NextSceneId;
+      bool m_NextScenePending;
+      bool m_PipelineFrames;
+      // scenes kept from previous renders along with their parse options key, most recently used first;
+      // they live in the backend's memory only, and do not outlive the session (there is no on-disk snapshot)
+      typedef std::list<std::pair<std::string, RenderFrontendBase::SceneId> > RetainedSceneList;
+      RetainedSceneList m_RetainedScenes;
+      std::string m_SceneKey;
+      size_t m_RetainedSceneLimit;
+      bool m_ReuseScene;
   };
 }
 // end of namespace vfe
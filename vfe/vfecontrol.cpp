@@ -226,7 +226,9 @@ int vfeSession::SetOptions (vfeRenderOptions& opts)
   m_RenderWidth = m_RenderHeight = 0;
   ClearOptions();
 
-  if ((err = POVMSObject_New (&obj, kPOVObjectClass_RenderOptions)) != kNoErr)
+  if (opts.m_HaveBaseOptions)
+    obj = opts.m_BaseOptions();
+  else if ((err = POVMSObject_New (&obj, kPOVObjectClass_RenderOptions)) != kNoErr)
     return (m_LastError = vfeFailedToInitObject) ;
 
   if ((err = POVMSUtil_SetInt (&obj, kPOVAttrib_MaxRenderThreads, opts.m_ThreadCount)) != kNoErr)
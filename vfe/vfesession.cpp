@@ -110,6 +110,7 @@ void vfeSession::Clear(bool Notify)
   m_Failed = false;
   m_Succeeded = false;
   m_HadErrorMessage = false;
+  m_LastErrorMessage.clear();
   m_RenderCancelled = false;
   m_RenderCancelRequested = false;
   m_PauseWhenDone = false;
@@ -235,7 +236,10 @@ void vfeSession::AppendErrorMessage (const string& Msg)
   // for the purpose of setting m_HadErrorMessage, we don't consider a
   // 'possible parse error' to be an error (i.e. we look for fatal errors).
   if (possibleError == false)
+  {
     m_HadErrorMessage = true;
+    m_LastErrorMessage = Msg;
+  }
   m_MessageQueue.push (GenericMessage (*this, possibleError ? mPossibleError : mError, Msg));
   if (m_MaxGenericMessages != -1)
     while (m_MessageQueue.size() > m_MaxGenericMessages)
@@ -251,7 +255,10 @@ void vfeSession::AppendErrorMessage (const string& Msg, const UCS2String& File,
   // for the purpose of setting m_HadErrorMessage, we don't consider a
   // 'possible parse error' to be an error (i.e. we look for fatal errors).
   if (possibleError == false)
+  {
     m_HadErrorMessage = true;
+    m_LastErrorMessage = Msg;
+  }
   m_MessageQueue.push (GenericMessage (*this, possibleError ? mPossibleError : mError, Msg, File, Line, Col));
   if (m_MaxGenericMessages != -1)
     while (m_MessageQueue.size() > m_MaxGenericMessages)
@@ -259,6 +266,18 @@ void vfeSession::AppendErrorMessage (const string& Msg, const UCS2String& File,
   NotifyEvent(stErrorMessage);
 }
 
+void vfeSession::SetLastErrorMessage (const string& Msg)
+{
+  std::lock_guard<std::mutex> lock(m_MessageMutex);
+  m_LastErrorMessage = Msg;
+}
+
+string vfeSession::GetLastErrorMessage()
+{
+  std::lock_guard<std::mutex> lock(m_MessageMutex);
+  return m_LastErrorMessage;
+}
+
 void vfeSession::AppendWarningMessage (const string& Msg)
 {
   std::lock_guard<std::mutex> lock(m_MessageMutex);
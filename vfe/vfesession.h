@@ -136,7 +136,7 @@ namespace vfe
     public:
       // Construct an instance of vfeRenderOptions. the thread count defaults
       // to 2.
-      vfeRenderOptions() : m_ThreadCount(2) {}
+      vfeRenderOptions() : m_ThreadCount(2), m_BaseOptions(kPOVObjectClass_RenderOptions), m_HaveBaseOptions(false) {}
       virtual ~vfeRenderOptions() {}
 
       // Clear the set options. This includes library paths, INI files,
@@ -149,6 +149,7 @@ namespace vfe
         ClearCommands();
         m_SourceFile.clear();
         m_ThreadCount = 2;
+        m_HaveBaseOptions = false;
         POVMSObject obj;
         POVMSObject_New (&obj, kPOVObjectClass_RenderOptions);
         m_Options = POVMS_Object(obj);
@@ -238,6 +239,12 @@ namespace vfe
       // instance.
       POVMS_Object& GetOptions() { return m_Options; }
 
+      // Sets the options that INI files and commands are applied to, in
+      // place of an empty set of options. This is used to render a job
+      // received as a render node, which comes with the options of the
+      // coordinator.
+      void SetBaseOptions(const POVMS_Object& Options) { m_BaseOptions = Options; m_HaveBaseOptions = true; }
+
     protected:
       int m_ThreadCount;
       UCS2StringVector m_IniFiles;
@@ -245,6 +252,8 @@ namespace vfe
       StringVector m_Commands;
       UCS2String m_SourceFile;
       POVMS_Object m_Options;
+      POVMS_Object m_BaseOptions;
+      bool m_HaveBaseOptions;
   } ;
 
   // The integer values which may be returned from any of the VFE methods
@@ -496,6 +505,12 @@ namespace vfe
       // only errors that will halt a render request are considered 'fatal'.
       virtual bool HadErrorMessage() const { return m_HadErrorMessage; }
 
+      // Returns the text of the most recent fatal error message received
+      // since the last call to vfeSession::Clear(), or an empty string if
+      // there was none. Unlike the message queues, this is also maintained
+      // when the session is optimized for console output.
+      virtual std::string GetLastErrorMessage();
+
       // Return true if the render is considered to have succeeded. In the
       // case of an animation, this relates to all requested frames being
       // processed, not each individual frame. The client is generally
@@ -736,6 +751,12 @@ namespace vfe
       // NB this method is pure virtual.
       virtual void DeleteTemporaryFile(const UCS2String& filename) const = 0;
 
+      ////////////////////////////////////////////////////////////////////////
+      // Return in `bytes` the amount of physical memory currently used by the
+      // process (e.g. its resident set size), and true; or false if there is
+      // no way to find out, which is what the default implementation returns.
+      virtual bool GetProcessMemoryUsage(POV_ULONG& bytes) const { return false; }
+
       ////////////////////////////////////////////////////////////////////////
       // Return a timestamp to be used internally for queue sorting etc. The
       // value returned must be 64-bit and in milliseconds; the origin of the
@@ -1111,6 +1132,7 @@ namespace vfe
       virtual POV_LONG GetElapsedTime() { return GetTimestamp() - m_StartTime; }
 
       virtual void AppendErrorMessage (const std::string& Msg);
+      virtual void SetLastErrorMessage (const std::string& Msg);
       virtual void AppendWarningMessage (const std::string& Msg);
       virtual void AppendStatusMessage (const std::string& Msg, int RecommendedPause = 0);
       virtual void AppendStatusMessage (const boost::format& fmt, int RecommendedPause = 0);
@@ -1242,6 +1264,7 @@ namespace vfe
       bool m_Failed;
       bool m_Succeeded;
       bool m_HadErrorMessage;
+      std::string m_LastErrorMessage;
       bool m_UsingAlpha;
       bool m_RenderingAnimation;
       bool m_RealTimeRaytracing;
@@ -40,6 +40,10 @@
 #include <direct.h>
 #include <windows.h>
 
+#define PSAPI_VERSION 1
+#pragma comment(lib, "psapi")
+#include <psapi.h>
+
 #include "vfe.h"
 #include "base/filesystem.h"
 #include "base/stringtypes.h"
@@ -171,6 +175,19 @@ namespace vfePlatform
     pov_base::Filesystem::DeleteFile(filename);
   }
 
+  //////////////////////////////////////////////////////////////
+  // Process related support functions
+  //////////////////////////////////////////////////////////////
+
+  bool vfeWinSession::GetProcessMemoryUsage(POV_ULONG& bytes) const
+  {
+    PROCESS_MEMORY_COUNTERS memInfo;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &memInfo, sizeof(memInfo)) == 0)
+      return false;
+    bytes = memInfo.WorkingSetSize;
+    return true;
+  }
+
   //////////////////////////////////////////////////////////////
   // vfe or POVMS related support functions
   //////////////////////////////////////////////////////////////
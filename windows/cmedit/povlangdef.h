@@ -108,6 +108,7 @@ CodemaxLanguage LangINI =
   "Initial_Clock\n"
   "Initial_Frame\n"
   "Input_File_Name\n"
+  "Include_Cache_Path\n"
   "Include_Header\n"
   "Include_Ini\n"
   "Jitter_Amount\n"
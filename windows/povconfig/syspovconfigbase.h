@@ -61,6 +61,15 @@
 // Windows requires a platform-specific function to delete a file.
 #define POV_USE_DEFAULT_DELETEFILE 0
 
+// Windows requires a platform-specific function to replace a file by renaming another.
+#define POV_USE_DEFAULT_RENAMEFILE 0
+
+// Windows requires a platform-specific function to commit a file to storage.
+#define POV_USE_DEFAULT_SYNCFILE 0
+
+// Windows requires a platform-specific function to get the modification time of a file.
+#define POV_USE_DEFAULT_GETFILESTATUS 0
+
 // Windows gets a platform-specific implementation of large file handling.
 #define POV_USE_DEFAULT_LARGEFILE 0
 